@@ -0,0 +1,430 @@
+/**
+ * @file runtime_bench.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-04-21
+ */
+
+#include <mirac/c_common.h>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+/**
+ * @brief Arithmetic heavy program, which is built without and with the
+ * optimizations (the loops of the kernel run iterations times).
+ */
+typedef struct
+{
+	const char_t* name;
+	const char_t* source;
+	uint64_t base_iterations_count;
+} kernel_s;
+
+/**
+ * @brief Fastest of the repeated runs of a kernel's program, and what it
+ * printed.
+ */
+typedef struct
+{
+	uint64_t wall_time;
+	char_t output[64];
+} measurement_s;
+
+static void usage(
+	const char_t* const program);
+
+static uint64_t now(
+	void);
+
+static bool_t run(
+	char_t* const * const arguments,
+	const char_t* const output_path);
+
+static bool_t build(
+	const char_t* const mirac_path,
+	const char_t* const format,
+	const char_t* const assembler,
+	const char_t* const linker,
+	const char_t* const work_directory,
+	const kernel_s* const kernel,
+	const uint64_t iterations_count,
+	const uint64_t level,
+	char_t* const executable_path,
+	const uint64_t executable_path_length);
+
+static bool_t measure(
+	const char_t* const executable_path,
+	const char_t* const work_directory,
+	const uint64_t repeats_count,
+	measurement_s* const measurement);
+
+// note: prints the top of the stack in decimal followed by a new line, with
+// nothing but the syscalls, so that the programs do not need the std library.
+static const char_t* const g_prelude =
+	"sec .bss mem print_buffer 32\n"
+	"sec .text fun print req u64 {\n"
+	"\tprint_buffer 31 + dup 10 swap st08\n"
+	"\tloop [ over 0 != ] { -- dup rot 10 /% rot swap 48 + swap st08 swap }\n"
+	"\tdup print_buffer 32 + swap - swap 1 1 sys3 drop drop\n"
+	"}\n";
+
+// note: the %lu of every source is the iterations count of its loops.
+static const kernel_s g_kernels[] =
+{
+	{
+		.name = "mix",
+		.source =
+			"sec .text fun _start {\n"
+			"\t0 0 loop [ dup %lu < ] {\n"
+			"\t\tswap over dup * over 3 >> ^ + over 7 & + swap ++\n"
+			"\t} drop\n"
+			"\tcall print 0 60 sys1 drop\n"
+			"}\n",
+		.base_iterations_count = 50000000
+	},
+	{
+		.name = "digits",
+		.source =
+			"sec .text fun digit_sum req u64 ret u64 {\n"
+			"\t0 swap loop [ dup 0 != ] { 10 /% rot + swap } drop\n"
+			"}\n"
+			"sec .text fun _start {\n"
+			"\t0 0 loop [ dup %lu < ] { dup call digit_sum rot + swap ++ } drop\n"
+			"\tcall print 0 60 sys1 drop\n"
+			"}\n",
+		.base_iterations_count = 5000000
+	},
+	{
+		.name = "collatz",
+		.source =
+			"sec .text fun _start {\n"
+			"\t0 1 loop [ dup %lu < ] {\n"
+			"\t\tdup loop [ dup 1 != ] {\n"
+			"\t\t\tif [ dup 1 & 0 == ] { 1 >> } else { 3 * 1 + }\n"
+			"\t\t\trot ++ rot rot\n"
+			"\t\t} drop ++\n"
+			"\t} drop\n"
+			"\tcall print 0 60 sys1 drop\n"
+			"}\n",
+		.base_iterations_count = 300000
+	},
+};
+#define g_kernels_count (sizeof(g_kernels) / sizeof(g_kernels[0]))
+
+int32_t main(
+	const int32_t argc,
+	const char_t** const argv)
+{
+	if (argc < 2)
+	{
+		usage(argv[0]);
+		return -1;
+	}
+
+	const char_t* const mirac_path = argv[1];
+	const char_t* work_directory = "/tmp";
+	const char_t* format = "nasm";
+	const char_t* assembler = "nasm";
+	const char_t* linker = "ld";
+	const char_t* only_kernel = mirac_null;
+	uint64_t repeats_count = 3;
+	uint64_t level = 1;
+	double base_factor = 1.0;
+	double min_speedup = 1.0;
+
+	for (int32_t index = 2; index < argc; ++index)
+	{
+		const char_t* const option = argv[index];
+
+		if ((index + 1) >= argc)
+		{
+			usage(argv[0]);
+			return -1;
+		}
+
+		const char_t* const value = argv[++index];
+
+		if (0 == strcmp(option, "--repeats"))
+		{
+			repeats_count = strtoull(value, mirac_null, 10);
+		}
+		else if (0 == strcmp(option, "--level"))
+		{
+			level = strtoull(value, mirac_null, 10);
+		}
+		else if (0 == strcmp(option, "--base"))
+		{
+			base_factor = strtod(value, mirac_null);
+		}
+		else if (0 == strcmp(option, "--min-speedup"))
+		{
+			min_speedup = strtod(value, mirac_null);
+		}
+		else if (0 == strcmp(option, "--kernel"))
+		{
+			only_kernel = value;
+		}
+		else if (0 == strcmp(option, "--format"))
+		{
+			format = value;
+		}
+		else if (0 == strcmp(option, "--assembler"))
+		{
+			assembler = value;
+		}
+		else if (0 == strcmp(option, "--linker"))
+		{
+			linker = value;
+		}
+		else if (0 == strcmp(option, "--work-dir"))
+		{
+			work_directory = value;
+		}
+		else
+		{
+			usage(argv[0]);
+			return -1;
+		}
+	}
+
+	if ((repeats_count < 1) || (level < 1) || (base_factor <= 0.0) ||
+		((strcmp(format, "nasm") != 0) && (strcmp(format, "elf64-exec") != 0)))
+	{
+		usage(argv[0]);
+		return -1;
+	}
+
+	printf("%-10s %12s %10s %10s %9s  %s\n", "kernel", "iterations", "-O0 ms", "-O* ms", "speedup", "output");
+	bool_t has_failed = false;
+
+	for (uint64_t kernel_index = 0; kernel_index < g_kernels_count; ++kernel_index)
+	{
+		const kernel_s* const kernel = &g_kernels[kernel_index];
+
+		if ((only_kernel != mirac_null) && (strcmp(only_kernel, kernel->name) != 0))
+		{
+			continue;
+		}
+
+		uint64_t iterations_count = (uint64_t)((double)kernel->base_iterations_count * base_factor);
+		iterations_count = iterations_count < 1 ? 1 : iterations_count;
+
+		char_t baseline_path[4096] = {0};
+		char_t optimized_path[4096] = {0};
+		measurement_s baseline = {0};
+		measurement_s optimized = {0};
+
+		if (!build(mirac_path, format, assembler, linker, work_directory, kernel, iterations_count, 0, baseline_path, sizeof(baseline_path)) ||
+			!build(mirac_path, format, assembler, linker, work_directory, kernel, iterations_count, level, optimized_path, sizeof(optimized_path)) ||
+			!measure(baseline_path, work_directory, repeats_count, &baseline) ||
+			!measure(optimized_path, work_directory, repeats_count, &optimized))
+		{
+			return -1;
+		}
+
+		(void)unlink(baseline_path);
+		(void)unlink(optimized_path);
+
+		// note: the optimizations must never change what the program computes.
+		const bool_t is_same = (0 == strcmp(baseline.output, optimized.output));
+		const double speedup = (double)baseline.wall_time / (double)optimized.wall_time;
+		has_failed = has_failed || !is_same || (speedup < min_speedup);
+
+		printf("%-10s %12lu %10.1f %10.1f %8.2fx  %s\n", kernel->name, iterations_count,
+			(double)baseline.wall_time / 1e6, (double)optimized.wall_time / 1e6, speedup,
+			is_same ? baseline.output : "mismatch");
+	}
+
+	return has_failed ? 1 : 0;
+}
+
+static void usage(
+	const char_t* const program)
+{
+	fprintf(stderr,
+		"usage: %s <mirac> [options]\n"
+		"\n"
+		"options:\n"
+		"    --repeats <n>       runs per program, the fastest one is reported (default 3)\n"
+		"    --level <n>         optimization level compared against -O0 (default 1)\n"
+		"    --base <x>          factor of the iterations count of every kernel (default 1)\n"
+		"    --min-speedup <x>   fail if a kernel does not get at least this much faster (default 1)\n"
+		"    --kernel <name>     only run the kernel (mix, digits, collatz)\n"
+		"    --format <name>     output format of the compiler (nasm or elf64-exec, default nasm)\n"
+		"    --assembler <cmd>   nasm compatible assembler (default nasm)\n"
+		"    --linker <cmd>      linker (default ld)\n"
+		"    --work-dir <dir>    directory of the generated programs (default /tmp)\n",
+		program);
+}
+
+static uint64_t now(
+	void)
+{
+	struct timespec time = {0};
+	(void)clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t)time.tv_sec * 1000000000ull + (uint64_t)time.tv_nsec;
+}
+
+static bool_t run(
+	char_t* const * const arguments,
+	const char_t* const output_path)
+{
+	const pid_t pid = fork();
+
+	if (pid < 0)
+	{
+		perror("fork");
+		return false;
+	}
+
+	if (0 == pid)
+	{
+		if (output_path != mirac_null)
+		{
+			const int32_t output = open(output_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+			if ((output < 0) || (dup2(output, STDOUT_FILENO) < 0))
+			{
+				perror("open");
+				_exit(127);
+			}
+		}
+
+		(void)execvp(arguments[0], arguments);
+		perror("execvp");
+		_exit(127);
+	}
+
+	int32_t status = 0;
+
+	if (waitpid(pid, &status, 0) != pid)
+	{
+		perror("waitpid");
+		return false;
+	}
+
+	if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0))
+	{
+		fprintf(stderr, "error: '%s' has failed.\n", arguments[0]);
+		return false;
+	}
+
+	return true;
+}
+
+static bool_t build(
+	const char_t* const mirac_path,
+	const char_t* const format,
+	const char_t* const assembler,
+	const char_t* const linker,
+	const char_t* const work_directory,
+	const kernel_s* const kernel,
+	const uint64_t iterations_count,
+	const uint64_t level,
+	char_t* const executable_path,
+	const uint64_t executable_path_length)
+{
+	char_t source_path[4096] = {0};
+	char_t asm_path[4096] = {0};
+	char_t object_path[4096] = {0};
+	char_t level_option[8] = {0};
+	(void)snprintf(source_path, sizeof(source_path), "%s/mirac_bench_%s.mira", work_directory, kernel->name);
+	(void)snprintf(asm_path, sizeof(asm_path), "%s/mirac_bench_%s_O%lu.asm", work_directory, kernel->name, level);
+	(void)snprintf(object_path, sizeof(object_path), "%s/mirac_bench_%s_O%lu.o", work_directory, kernel->name, level);
+	(void)snprintf(executable_path, executable_path_length, "%s/mirac_bench_%s_O%lu.out", work_directory, kernel->name, level);
+	(void)snprintf(level_option, sizeof(level_option), "-O%lu", level);
+
+	mirac_file_t* const file = fopen(source_path, "w");
+
+	if (mirac_null == file)
+	{
+		fprintf(stderr, "error: failed to create '%s'.\n", source_path);
+		return false;
+	}
+
+	(void)fputs(g_prelude, file);
+	(void)fprintf(file, kernel->source, iterations_count);
+	(void)fclose(file);
+
+	// note: the elf64-exec format builds the executable without the assembler and
+	//       the linker, from the same instructions as the nasm one.
+	const bool_t is_exec = (0 == strcmp(format, "elf64-exec"));
+
+	char_t* const mirac_arguments[] =
+	{
+		(char_t*)mirac_path, "-u", "-e", "_start", "-a", "x86_64", "-f", (char_t*)format, level_option,
+		source_path, is_exec ? executable_path : asm_path, mirac_null
+	};
+
+	char_t* const assembler_arguments[] =
+	{
+		(char_t*)assembler, "-f", "elf64", asm_path, "-o", object_path, mirac_null
+	};
+
+	char_t* const linker_arguments[] =
+	{
+		(char_t*)linker, object_path, "-o", executable_path, mirac_null
+	};
+
+	const bool_t is_built = run(mirac_arguments, mirac_null) && (is_exec ||
+		(run(assembler_arguments, mirac_null) && run(linker_arguments, mirac_null)));
+
+	(void)unlink(source_path);
+	(void)unlink(asm_path);
+	(void)unlink(object_path);
+	return is_built;
+}
+
+static bool_t measure(
+	const char_t* const executable_path,
+	const char_t* const work_directory,
+	const uint64_t repeats_count,
+	measurement_s* const measurement)
+{
+	char_t output_path[4096] = {0};
+	(void)snprintf(output_path, sizeof(output_path), "%s/mirac_bench_output.txt", work_directory);
+
+	char_t* const arguments[] = { (char_t*)executable_path, mirac_null };
+	measurement->wall_time = UINT64_MAX;
+
+	for (uint64_t repeat = 0; repeat < repeats_count; ++repeat)
+	{
+		const uint64_t begin_time = now();
+
+		if (!run(arguments, output_path))
+		{
+			return false;
+		}
+
+		const uint64_t wall_time = now() - begin_time;
+		measurement->wall_time = wall_time < measurement->wall_time ? wall_time : measurement->wall_time;
+	}
+
+	mirac_file_t* const file = fopen(output_path, "r");
+
+	if ((mirac_null == file) || (mirac_null == fgets(measurement->output, sizeof(measurement->output), file)))
+	{
+		fprintf(stderr, "error: '%s' has not printed anything.\n", executable_path);
+
+		if (file != mirac_null)
+		{
+			(void)fclose(file);
+		}
+
+		return false;
+	}
+
+	(void)fclose(file);
+	(void)unlink(output_path);
+	measurement->output[strcspn(measurement->output, "\n")] = '\0';
+	return true;
+}
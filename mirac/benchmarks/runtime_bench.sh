@@ -0,0 +1,62 @@
+# !/bin/sh
+
+SCRIPT_DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" &> /dev/null && pwd )"
+MIRAC_DIR="$SCRIPT_DIR/.."
+
+# --------------------------------------------------------------------------- #
+
+PROJECT_NAME="runtime_bench"
+
+INCLUDES="
+	-I$MIRAC_DIR/include
+"
+
+SOURCES="
+	$SCRIPT_DIR/$PROJECT_NAME.c
+"
+
+LIBRARIES="
+"
+
+# --------------------------------------------------------------------------- #
+
+# Build the release configuration of the compiler, which is what is measured
+bash "$MIRAC_DIR/scripts/build.sh" release
+
+if [ $? -ne 0 ]; then
+	echo "[error]: failed to build the compiler."
+	exit 1
+fi
+
+# Compilation command
+gcc -Wall \
+	-Wextra \
+	-Wpedantic \
+	-Werror \
+	-Wshadow \
+	-Wimplicit \
+	-Wreturn-type \
+	-Wunknown-pragmas \
+	-Wunused-variable \
+	-Wunused-function \
+	-Wmissing-prototypes \
+	-Wstrict-prototypes \
+	-Wconversion \
+	-Wsign-conversion \
+	-Wunreachable-code \
+	-std=gnu11 \
+	-O2 \
+	$INCLUDES \
+	$SOURCES \
+	-o "$SCRIPT_DIR/$PROJECT_NAME.out" \
+	$LIBRARIES
+
+# Check if compilation was successful, and forward the options to the benchmark
+if [ $? -eq 0 ]; then
+	echo "[info]: compilation successful - executable: $SCRIPT_DIR/$PROJECT_NAME.out"
+	"$SCRIPT_DIR/$PROJECT_NAME.out" "$MIRAC_DIR/build/mirac_release" "$@"
+	exit $?
+else
+	echo "[error]: compilation failed."
+	exit 1
+fi
@@ -0,0 +1,632 @@
+/**
+ * @file throughput_bench.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-03-30
+ */
+
+#include <mirac/c_common.h>
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+/**
+ * @brief Scales every shape is generated at (relative to the shape's base).
+ */
+static const uint64_t g_scales[] = { 1, 2, 4, 8 };
+#define g_scales_count (sizeof(g_scales) / sizeof(g_scales[0]))
+
+/**
+ * @brief Writer of a generated program, which counts what it writes.
+ */
+typedef struct
+{
+	mirac_file_t* file;
+	uint64_t tokens_count;
+	uint64_t defs_count;
+} generator_s;
+
+typedef void(*generate_t)(generator_s* const generator, const uint64_t units_count);
+
+/**
+ * @brief Shape of the generated programs, which stresses a single part of the
+ * compiler (the units of the shape are what is scaled).
+ */
+typedef struct
+{
+	const char_t* name;
+	generate_t generate;
+	uint64_t base_units_count;
+} shape_s;
+
+/**
+ * @brief Best of the repeated compilations of a single generated program.
+ */
+typedef struct
+{
+	uint64_t tokens_count;
+	uint64_t defs_count;
+	uint64_t output_size;
+	uint64_t wall_time;
+	uint64_t peak_rss;
+} measurement_s;
+
+static void usage(
+	const char_t* const program);
+
+static uint64_t now(
+	void);
+
+static void put(
+	generator_s* const generator,
+	const char_t* const format,
+	...) __attribute__((format(printf, 2, 3)));
+
+static void put_line(
+	generator_s* const generator);
+
+static void put_write_def(
+	generator_s* const generator);
+
+static void put_start_def(
+	generator_s* const generator,
+	const char_t* const callee);
+
+static void generate_functions(
+	generator_s* const generator,
+	const uint64_t units_count);
+
+static void generate_defs(
+	generator_s* const generator,
+	const uint64_t units_count);
+
+static void generate_nesting(
+	generator_s* const generator,
+	const uint64_t units_count);
+
+static void generate_strings(
+	generator_s* const generator,
+	const uint64_t units_count);
+
+static void generate_identifiers(
+	generator_s* const generator,
+	const uint64_t units_count);
+
+static bool_t run_mirac(
+	const char_t* const mirac_path,
+	const char_t* const source_path,
+	const char_t* const output_path,
+	uint64_t* const wall_time,
+	uint64_t* const peak_rss);
+
+static bool_t measure(
+	const char_t* const mirac_path,
+	const char_t* const work_directory,
+	const shape_s* const shape,
+	const uint64_t scale,
+	const uint64_t repeats_count,
+	measurement_s* const measurement);
+
+static void print_measurement(
+	const shape_s* const shape,
+	const uint64_t scale,
+	const measurement_s* const measurement);
+
+// note: a nesting depth well past what hand written programs reach, while staying
+// far from exhausting the stack of the recursive descent parser.
+#define nesting_depth 48
+
+// note: long enough for the lexer's string scanning to dominate the shape.
+#define string_length 4096
+
+// note: the number of defs every function of the identifiers shape refers to.
+#define referenced_defs_count 64
+
+static const shape_s g_shapes[] =
+{
+	{ .name = "functions",   .generate = generate_functions,   .base_units_count = 8000  },
+	{ .name = "defs",        .generate = generate_defs,        .base_units_count = 40000 },
+	{ .name = "nesting",     .generate = generate_nesting,     .base_units_count = 1000  },
+	{ .name = "strings",     .generate = generate_strings,     .base_units_count = 1000  },
+	{ .name = "identifiers", .generate = generate_identifiers, .base_units_count = 1000  },
+};
+#define g_shapes_count (sizeof(g_shapes) / sizeof(g_shapes[0]))
+
+int32_t main(
+	const int32_t argc,
+	const char_t** const argv)
+{
+	if (argc < 2)
+	{
+		usage(argv[0]);
+		return -1;
+	}
+
+	const char_t* const mirac_path = argv[1];
+	const char_t* work_directory = "/tmp";
+	const char_t* only_shape = mirac_null;
+	uint64_t repeats_count = 3;
+	double tolerance = 1.5;
+	double base_factor = 1.0;
+	uint64_t max_rss = 256;
+
+	for (int32_t index = 2; index < argc; ++index)
+	{
+		const char_t* const option = argv[index];
+
+		if ((index + 1) >= argc)
+		{
+			usage(argv[0]);
+			return -1;
+		}
+
+		const char_t* const value = argv[++index];
+
+		if (0 == strcmp(option, "--repeats"))
+		{
+			repeats_count = strtoull(value, mirac_null, 10);
+		}
+		else if (0 == strcmp(option, "--tolerance"))
+		{
+			tolerance = strtod(value, mirac_null);
+		}
+		else if (0 == strcmp(option, "--base"))
+		{
+			base_factor = strtod(value, mirac_null);
+		}
+		else if (0 == strcmp(option, "--max-rss"))
+		{
+			max_rss = strtoull(value, mirac_null, 10);
+		}
+		else if (0 == strcmp(option, "--shape"))
+		{
+			only_shape = value;
+		}
+		else if (0 == strcmp(option, "--work-dir"))
+		{
+			work_directory = value;
+		}
+		else
+		{
+			usage(argv[0]);
+			return -1;
+		}
+	}
+
+	if ((repeats_count < 1) || (tolerance < 1.0) || (base_factor <= 0.0) || (max_rss < 1))
+	{
+		usage(argv[0]);
+		return -1;
+	}
+
+	printf("%-12s %5s %10s %8s %11s %9s %12s %10s %12s %9s\n",
+		"shape", "scale", "tokens", "defs", "asm bytes", "time ms",
+		"tokens/s", "defs/s", "asm bytes/s", "rss kb");
+
+	bool_t has_failed = false;
+
+	for (uint64_t shape_index = 0; shape_index < g_shapes_count; ++shape_index)
+	{
+		shape_s shape = g_shapes[shape_index];
+
+		if ((only_shape != mirac_null) && (strcmp(only_shape, shape.name) != 0))
+		{
+			continue;
+		}
+
+		shape.base_units_count = (uint64_t)((double)shape.base_units_count * base_factor);
+		shape.base_units_count = shape.base_units_count < 1 ? 1 : shape.base_units_count;
+		measurement_s measurements[g_scales_count] = {0};
+
+		for (uint64_t scale_index = 0; scale_index < g_scales_count; ++scale_index)
+		{
+			if (!measure(mirac_path, work_directory, &shape, g_scales[scale_index], repeats_count, &measurements[scale_index]))
+			{
+				return -1;
+			}
+
+			print_measurement(&shape, g_scales[scale_index], &measurements[scale_index]);
+		}
+
+		// note: the time per token of the largest program over the time per token
+		// of the smallest one, which stays around 1 as long as the compile time
+		// grows linearly with the size of the program.
+		const measurement_s* const first = &measurements[0];
+		const measurement_s* const last = &measurements[g_scales_count - 1];
+		const double growth = ((double)last->wall_time / (double)first->wall_time) /
+			((double)last->tokens_count / (double)first->tokens_count);
+		const bool_t is_linear = (growth <= tolerance);
+		has_failed = has_failed || !is_linear;
+
+		printf("%-12s growth %.2f (tolerance %.2f) -- %s\n", shape.name, growth,
+			tolerance, is_linear ? "linear" : "superlinear");
+
+		// note: the peak memory grows linearly with the size of the program even
+		// when every def leaks what it was compiled with, so it is bounded as a
+		// whole instead of by its growth.
+		uint64_t peak_rss = 0;
+
+		for (uint64_t scale_index = 0; scale_index < g_scales_count; ++scale_index)
+		{
+			peak_rss = measurements[scale_index].peak_rss > peak_rss ? measurements[scale_index].peak_rss : peak_rss;
+		}
+
+		const bool_t is_bounded = (peak_rss <= (max_rss * 1024));
+		has_failed = has_failed || !is_bounded;
+
+		printf("%-12s rss %lu kb (limit %lu kb) -- %s\n\n", shape.name, peak_rss,
+			max_rss * 1024, is_bounded ? "bounded" : "unbounded");
+	}
+
+	return has_failed ? 1 : 0;
+}
+
+static void usage(
+	const char_t* const program)
+{
+	fprintf(stderr,
+		"usage: %s <mirac> [options]\n"
+		"\n"
+		"options:\n"
+		"    --repeats <n>      compilations per program, the fastest one is reported (default 3)\n"
+		"    --tolerance <x>    allowed growth of the time per token from the smallest to the largest program (default 1.5)\n"
+		"    --base <x>         factor of the base size of every shape (default 1)\n"
+		"    --max-rss <mb>     allowed peak memory of the compilation of any program (default 256)\n"
+		"    --shape <name>     only run the shape (functions, defs, nesting, strings, identifiers)\n"
+		"    --work-dir <dir>   directory of the generated programs (default /tmp)\n",
+		program);
+}
+
+static uint64_t now(
+	void)
+{
+	struct timespec time = {0};
+	(void)clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t)time.tv_sec * 1000000000ull + (uint64_t)time.tv_nsec;
+}
+
+static void put(
+	generator_s* const generator,
+	const char_t* const format,
+	...)
+{
+	va_list args;
+	va_start(args, format);
+	(void)vfprintf(generator->file, format, args);
+	va_end(args);
+
+	(void)fputc(' ', generator->file);
+	++generator->tokens_count;
+}
+
+static void put_line(
+	generator_s* const generator)
+{
+	(void)fputc('\n', generator->file);
+}
+
+static void put_write_def(
+	generator_s* const generator)
+{
+	put(generator, "sec"); put(generator, ".text"); put(generator, "fun"); put(generator, "write");
+	put(generator, "req"); put(generator, "u64"); put(generator, "ptr"); put(generator, "u32");
+	put(generator, "ret"); put(generator, "i32"); put(generator, "{"); put_line(generator);
+	put(generator, "1"); put(generator, "sys3"); put(generator, "as"); put(generator, "i32"); put_line(generator);
+	put(generator, "}"); put_line(generator);
+	++generator->defs_count;
+}
+
+static void put_start_def(
+	generator_s* const generator,
+	const char_t* const callee)
+{
+	put(generator, "sec"); put(generator, ".text"); put(generator, "fun"); put(generator, "_start");
+	put(generator, "{"); put_line(generator);
+	put(generator, "0"); put(generator, "call"); put(generator, "%s", callee); put(generator, "drop");
+	put(generator, "0"); put(generator, "60"); put(generator, "sys1"); put(generator, "drop"); put_line(generator);
+	put(generator, "}"); put_line(generator);
+	++generator->defs_count;
+}
+
+static void generate_functions(
+	generator_s* const generator,
+	const uint64_t units_count)
+{
+	put_write_def(generator);
+
+	for (uint64_t index = 0; index < units_count; ++index)
+	{
+		put(generator, "sec"); put(generator, ".text"); put(generator, "fun"); put(generator, "function_%lu", index);
+		put(generator, "req"); put(generator, "u64"); put(generator, "ret"); put(generator, "u64"); put(generator, "{"); put_line(generator);
+		put(generator, "dup"); put(generator, "3"); put(generator, "*"); put(generator, "7"); put(generator, "+"); put(generator, "swap"); put_line(generator);
+		put(generator, "if"); put(generator, "["); put(generator, "dup"); put(generator, "10"); put(generator, "<"); put(generator, "]");
+		put(generator, "{"); put(generator, "1"); put(generator, "+"); put(generator, "}");
+		put(generator, "else"); put(generator, "{"); put(generator, "3"); put(generator, "+"); put(generator, "}"); put_line(generator);
+		put(generator, "loop"); put(generator, "["); put(generator, "dup"); put(generator, "0"); put(generator, "!="); put(generator, "]");
+		put(generator, "{"); put(generator, "--"); put(generator, "over"); put(generator, "5"); put(generator, ">>");
+		put(generator, "rot"); put(generator, "rot"); put(generator, "drop"); put(generator, "}"); put_line(generator);
+		put(generator, "drop"); put_line(generator);
+		put(generator, "}"); put_line(generator);
+		++generator->defs_count;
+	}
+
+	put_start_def(generator, "function_0");
+}
+
+static void generate_defs(
+	generator_s* const generator,
+	const uint64_t units_count)
+{
+	put_write_def(generator);
+
+	for (uint64_t index = 0; index < units_count; ++index)
+	{
+		if (0 == (index % 2))
+		{
+			put(generator, "sec"); put(generator, ".data"); put(generator, "str");
+			put(generator, "string_%lu", index); put(generator, "\"string %lu\\n\"", index); put_line(generator);
+		}
+		else
+		{
+			put(generator, "sec"); put(generator, ".bss"); put(generator, "mem");
+			put(generator, "memory_%lu", index); put(generator, "%lu", 8 + (index % 64)); put_line(generator);
+		}
+
+		++generator->defs_count;
+	}
+
+	put(generator, "sec"); put(generator, ".text"); put(generator, "fun"); put(generator, "main");
+	put(generator, "req"); put(generator, "u64"); put(generator, "ret"); put(generator, "u64"); put(generator, "{"); put_line(generator);
+	put(generator, "10"); put(generator, "string_0"); put(generator, "1"); put(generator, "call"); put(generator, "write"); put(generator, "drop"); put_line(generator);
+	put(generator, "}"); put_line(generator);
+	++generator->defs_count;
+
+	put_start_def(generator, "main");
+}
+
+static void generate_nesting(
+	generator_s* const generator,
+	const uint64_t units_count)
+{
+	for (uint64_t index = 0; index < units_count; ++index)
+	{
+		put(generator, "sec"); put(generator, ".text"); put(generator, "fun"); put(generator, "nested_%lu", index);
+		put(generator, "req"); put(generator, "u64"); put(generator, "ret"); put(generator, "u64"); put(generator, "{"); put_line(generator);
+
+		for (uint64_t depth = 0; depth < nesting_depth; ++depth)
+		{
+			if (0 == (depth % 2))
+			{
+				put(generator, "if"); put(generator, "["); put(generator, "dup"); put(generator, "%lu", depth); put(generator, ">"); put(generator, "]");
+			}
+			else
+			{
+				put(generator, "loop"); put(generator, "["); put(generator, "dup"); put(generator, "%lu", depth); put(generator, "<"); put(generator, "]");
+			}
+
+			put(generator, "{"); put(generator, "1"); put(generator, "+"); put_line(generator);
+		}
+
+		for (uint64_t depth = 0; depth < nesting_depth; ++depth)
+		{
+			put(generator, "}");
+		}
+
+		put_line(generator);
+		put(generator, "}"); put_line(generator);
+		++generator->defs_count;
+	}
+
+	put_start_def(generator, "nested_0");
+}
+
+static void generate_strings(
+	generator_s* const generator,
+	const uint64_t units_count)
+{
+	static const char_t g_alphabet[] = "abcdefghijklmnopqrstuvwxyz0123456789 ,.;:-";
+	char_t* const literal = (char_t*)malloc(string_length + 1);
+
+	for (uint64_t index = 0; index < units_count; ++index)
+	{
+		for (uint64_t offset = 0; offset < string_length; ++offset)
+		{
+			literal[offset] = g_alphabet[(index + offset * 7) % (sizeof(g_alphabet) - 1)];
+		}
+
+		literal[string_length] = '\0';
+		put(generator, "sec"); put(generator, ".data"); put(generator, "str");
+		put(generator, "string_%lu", index); put(generator, "\"%s\\n\"", literal); put_line(generator);
+		++generator->defs_count;
+	}
+
+	free(literal);
+	put_write_def(generator);
+
+	put(generator, "sec"); put(generator, ".text"); put(generator, "fun"); put(generator, "main");
+	put(generator, "req"); put(generator, "u64"); put(generator, "ret"); put(generator, "u64"); put(generator, "{"); put_line(generator);
+	put(generator, "%d", string_length + 1); put(generator, "string_0"); put(generator, "1");
+	put(generator, "call"); put(generator, "write"); put(generator, "drop"); put_line(generator);
+	put(generator, "}"); put_line(generator);
+	++generator->defs_count;
+
+	put_start_def(generator, "main");
+}
+
+static void generate_identifiers(
+	generator_s* const generator,
+	const uint64_t units_count)
+{
+	put_write_def(generator);
+
+	for (uint64_t index = 0; index < referenced_defs_count; ++index)
+	{
+		put(generator, "sec"); put(generator, ".bss"); put(generator, "mem");
+		put(generator, "shared_identifier_with_a_long_common_prefix_%lu", index); put(generator, "8"); put_line(generator);
+		++generator->defs_count;
+	}
+
+	for (uint64_t index = 0; index < units_count; ++index)
+	{
+		put(generator, "sec"); put(generator, ".text"); put(generator, "fun"); put(generator, "user_%lu", index);
+		put(generator, "req"); put(generator, "u64"); put(generator, "ret"); put(generator, "u64"); put(generator, "{"); put_line(generator);
+
+		for (uint64_t reference = 0; reference < referenced_defs_count; ++reference)
+		{
+			const uint64_t referenced_index = (index * 31 + reference * 17) % referenced_defs_count;
+			put(generator, "shared_identifier_with_a_long_common_prefix_%lu", referenced_index);
+			put(generator, "ld64"); put(generator, "+");
+
+			if (7 == (reference % 8))
+			{
+				put_line(generator);
+			}
+		}
+
+		if (index > 0)
+		{
+			put(generator, "call"); put(generator, "user_%lu", index - 1);
+		}
+
+		put_line(generator);
+		put(generator, "}"); put_line(generator);
+		++generator->defs_count;
+	}
+
+	put_start_def(generator, "user_0");
+}
+
+static bool_t run_mirac(
+	const char_t* const mirac_path,
+	const char_t* const source_path,
+	const char_t* const output_path,
+	uint64_t* const wall_time,
+	uint64_t* const peak_rss)
+{
+	const uint64_t begin_time = now();
+	const pid_t pid = fork();
+
+	if (pid < 0)
+	{
+		perror("fork");
+		return false;
+	}
+
+	if (0 == pid)
+	{
+		char_t* const arguments[] =
+		{
+			(char_t*)mirac_path, "-e", "_start", "-a", "x86_64", "-f", "nasm",
+			(char_t*)source_path, (char_t*)output_path, mirac_null
+		};
+
+		(void)execv(mirac_path, arguments);
+		perror("execv");
+		_exit(127);
+	}
+
+	int32_t status = 0;
+	struct rusage usage = {0};
+
+	if (wait4(pid, &status, 0, &usage) != pid)
+	{
+		perror("wait4");
+		return false;
+	}
+
+	*wall_time = now() - begin_time;
+	*peak_rss = (uint64_t)usage.ru_maxrss;
+
+	if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0))
+	{
+		fprintf(stderr, "error: '%s' failed to compile '%s'.\n", mirac_path, source_path);
+		return false;
+	}
+
+	return true;
+}
+
+static bool_t measure(
+	const char_t* const mirac_path,
+	const char_t* const work_directory,
+	const shape_s* const shape,
+	const uint64_t scale,
+	const uint64_t repeats_count,
+	measurement_s* const measurement)
+{
+	char_t source_path[4096] = {0};
+	char_t output_path[4096] = {0};
+	(void)snprintf(source_path, sizeof(source_path), "%s/mirac_bench_%s_%lu.mira", work_directory, shape->name, scale);
+	(void)snprintf(output_path, sizeof(output_path), "%s/mirac_bench_%s_%lu.asm", work_directory, shape->name, scale);
+
+	generator_s generator = { .file = fopen(source_path, "w"), .tokens_count = 0, .defs_count = 0 };
+
+	if (mirac_null == generator.file)
+	{
+		fprintf(stderr, "error: failed to create '%s'.\n", source_path);
+		return false;
+	}
+
+	shape->generate(&generator, shape->base_units_count * scale);
+	(void)fclose(generator.file);
+
+	*measurement = (measurement_s)
+	{
+		.tokens_count = generator.tokens_count,
+		.defs_count   = generator.defs_count,
+		.output_size  = 0,
+		.wall_time    = UINT64_MAX,
+		.peak_rss     = 0
+	};
+
+	for (uint64_t repeat = 0; repeat < repeats_count; ++repeat)
+	{
+		uint64_t wall_time = 0;
+		uint64_t peak_rss = 0;
+
+		if (!run_mirac(mirac_path, source_path, output_path, &wall_time, &peak_rss))
+		{
+			return false;
+		}
+
+		measurement->wall_time = wall_time < measurement->wall_time ? wall_time : measurement->wall_time;
+		measurement->peak_rss = peak_rss > measurement->peak_rss ? peak_rss : measurement->peak_rss;
+	}
+
+	struct stat output_stat = {0};
+
+	if (0 == stat(output_path, &output_stat))
+	{
+		measurement->output_size = (uint64_t)output_stat.st_size;
+	}
+
+	(void)unlink(source_path);
+	(void)unlink(output_path);
+	return true;
+}
+
+static void print_measurement(
+	const shape_s* const shape,
+	const uint64_t scale,
+	const measurement_s* const measurement)
+{
+	const double seconds = (double)measurement->wall_time / 1e9;
+
+	printf("%-12s %5lu %10lu %8lu %11lu %9.1f %12.0f %10.0f %12.0f %9lu\n",
+		shape->name, scale, measurement->tokens_count, measurement->defs_count,
+		measurement->output_size, seconds * 1e3,
+		(double)measurement->tokens_count / seconds,
+		(double)measurement->defs_count / seconds,
+		(double)measurement->output_size / seconds,
+		measurement->peak_rss);
+}
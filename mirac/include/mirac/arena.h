@@ -1,4 +1,3 @@
-
 /**
  * @file arena.h
  * 
@@ -14,47 +13,124 @@
 #define __mirac__include__mirac__arena_h__
 
 #include <mirac/c_common.h>
+#include <mirac/string_view.h>
+
+/**
+ * @brief Capacity of the first chunk allocated by an arena.
+ */
+#define mirac_arena_min_chunk_capacity ((uint64_t)(64 * 1024))
+
+/**
+ * @brief Capacity limit for the geometric growth of arena chunks.
+ * 
+ * @note Allocations larger than this get a dedicated chunk of their own.
+ */
+#define mirac_arena_max_chunk_capacity ((uint64_t)(1024 * 1024))
+
+/**
+ * @brief Alignment used by @ref mirac_arena_malloc.
+ */
+#define mirac_arena_default_alignment ((uint64_t)_Alignof(max_align_t))
 
-typedef struct mirac_node_s mirac_node_s;
+typedef struct mirac_arena_chunk_s mirac_arena_chunk_s;
 
-struct mirac_node_s
+struct mirac_arena_chunk_s
 {
-	void* pointer;
-	uint64_t size;
-	mirac_node_s* next;
+	mirac_arena_chunk_s* next;
+	uint64_t capacity;
+	uint64_t used;
+	_Alignas(max_align_t) uint8_t data[];
 };
 
 // todo: write unit tests!
 /**
- * @brief Create arena node, allocate it's pointer with provided size.
+ * @brief Create arena chunk with provided capacity of its data region.
  * 
- * @param size size of to-be-allocated memory block
+ * @param capacity capacity of the chunk's data region
  * 
- * @return mirac_node_s*
+ * @return mirac_arena_chunk_s*
  */
-mirac_node_s* mirac_node_from_size(
-	const uint64_t size);
+mirac_arena_chunk_s* mirac_arena_chunk_from_capacity(
+	const uint64_t capacity);
 
 // todo: write unit tests!
 /**
- * @brief Destroy and deallocate the inner pointer and the node itself.
+ * @brief Destroy and deallocate the chunk along with its data region.
  * 
- * @param node node to destroy
+ * @param chunk chunk to destroy
  */
-void mirac_node_destroy(
-	mirac_node_s* const node);
+void mirac_arena_chunk_destroy(
+	mirac_arena_chunk_s* const chunk);
 
+/**
+ * @brief Allocation site, which the memory of an arena is accounted for.
+ */
+typedef enum
+{
+	mirac_arena_site_other = 0,
+	mirac_arena_site_lexer_text,
+	mirac_arena_site_tokens,
+	mirac_arena_site_ast_blocks,
+	mirac_arena_site_ast_defs,
+	mirac_arena_site_lists,
+	mirac_arena_site_tables,
+	mirac_arena_site_output,
+	mirac_arena_sites_count,
+
+	mirac_arena_site_none
+} mirac_arena_site_e;
+
+mirac_string_view_s mirac_arena_site_to_string_view(
+	const mirac_arena_site_e site);
+
+/**
+ * @brief Memory counters of a single allocation site.
+ * 
+ * @note The reserved size and the chunks count are the chunks that had to be
+ * allocated to serve the site's allocations.
+ */
 typedef struct
 {
-	mirac_node_s* begin;
-	mirac_node_s* end;
+	uint64_t requested_size;
+	uint64_t reserved_size;
+	uint64_t allocations_count;
+	uint64_t chunks_count;
+} mirac_arena_site_stats_s;
+
+/**
+ * @brief Memory counters of the arenas attached to them.
+ */
+typedef struct
+{
+	mirac_arena_site_stats_s sites[mirac_arena_sites_count];
+	uint64_t reserved_size;
+	uint64_t peak_reserved_size;
+} mirac_arena_stats_s;
+
+typedef struct
+{
+	mirac_arena_chunk_s* begin;
+	mirac_arena_chunk_s* end;
+	uint64_t next_chunk_capacity;
 	bool_t is_used;
+	mirac_arena_site_e site;     // note: site of the current scope (if any).
+	mirac_arena_stats_s* stats;  // note: mirac_null unless memory is accounted.
 } mirac_arena_s;
 
+/**
+ * @brief Site of the arena's current scope, or the provided one if the arena is
+ * not in a scope (used by the containers, so that the tokens list is accounted
+ * as tokens, while every other list is accounted as a list).
+ */
+#define mirac_arena_scoped_site(_arena, _site)                                 \
+	(mirac_arena_site_none != (_arena)->site ? (_arena)->site : (_site))
+
 // todo: write unit tests!
 /**
  * @brief Create arena object.
  * 
+ * @note No memory is allocated until the first call to the malloc functions.
+ * 
  * @return mirac_arena_s
  */
 mirac_arena_s mirac_arena_from_parts(
@@ -62,7 +138,7 @@ mirac_arena_s mirac_arena_from_parts(
 
 // todo: write unit tests!
 /**
- * @brief Destroy and deallocate the entire arena (and it's nodes).
+ * @brief Destroy and deallocate the entire arena (and it's chunks).
  * 
  * @param arena arena instance
  */
@@ -71,8 +147,64 @@ void mirac_arena_destroy(
 
 // todo: write unit tests!
 /**
- * @brief Allocate a region of memory with provided size and store the pointer
- * to it wihtin arena's node.
+ * @brief Release all the regions allocated from the arena at once, so that its
+ * memory can be reused.
+ * 
+ * @note Only the arena's current chunk is kept (it is the largest one, as the
+ * chunks grow geometrically), every other chunk is deallocated.
+ * 
+ * @param arena arena instance
+ */
+void mirac_arena_reset(
+	mirac_arena_s* const arena);
+
+// todo: write unit tests!
+/**
+ * @brief Account the memory of the arena in the provided stats from now on (or
+ * stop accounting it, if mirac_null is provided).
+ * 
+ * @note The chunks the arena already holds are added to the stats' reserved
+ * size, while detaching leaves the previous stats as they are.
+ * 
+ * @param arena arena instance
+ * @param stats stats to account into (may be mirac_null)
+ */
+void mirac_arena_set_stats(
+	mirac_arena_s* const arena,
+	mirac_arena_stats_s* const stats);
+
+// todo: write unit tests!
+/**
+ * @brief Print the counters of every allocation site of the stats.
+ * 
+ * @param stats stats to print
+ * @param name  name of what the stats were accounted for
+ */
+void mirac_arena_print_stats(
+	const mirac_arena_stats_s* const stats,
+	const mirac_string_view_s name);
+
+// todo: write unit tests!
+/**
+ * @brief Begin a scope, in which the allocations from the arena that do not
+ * name their site are accounted for the provided site.
+ * 
+ * @param arena arena instance
+ * @param site  site of the scope (mirac_arena_site_none ends the scope)
+ * 
+ * @return mirac_arena_site_e the site of the previous scope (to be restored)
+ */
+mirac_arena_site_e mirac_arena_set_site(
+	mirac_arena_s* const arena,
+	const mirac_arena_site_e site);
+
+// todo: write unit tests!
+/**
+ * @brief Allocate a region of memory with provided size from the arena.
+ * 
+ * The region is bumped from the current chunk, and a new chunk is allocated only
+ * when the current one is exhausted. The region is aligned to the
+ * @ref mirac_arena_default_alignment.
  * 
  * @param arena arena instance
  * @param size  size of to-be-allocated memory block
@@ -83,4 +215,97 @@ void* mirac_arena_malloc(
 	mirac_arena_s* const arena,
 	const uint64_t size);
 
+// todo: write unit tests!
+/**
+ * @brief Allocate a region of memory with provided size and alignment from the
+ * arena.
+ * 
+ * @param arena     arena instance
+ * @param size      size of to-be-allocated memory block
+ * @param alignment alignment of the memory block (must be a power of two)
+ * 
+ * @return void*
+ */
+void* mirac_arena_malloc_aligned(
+	mirac_arena_s* const arena,
+	const uint64_t size,
+	const uint64_t alignment);
+
+// todo: write unit tests!
+/**
+ * @brief Allocate a region of memory with provided size from the arena, and
+ * account it for the provided site.
+ * 
+ * @param arena arena instance
+ * @param size  size of to-be-allocated memory block
+ * @param site  site to account the region for
+ * 
+ * @return void*
+ */
+void* mirac_arena_malloc_as(
+	mirac_arena_s* const arena,
+	const uint64_t size,
+	const mirac_arena_site_e site);
+
+// todo: write unit tests!
+/**
+ * @brief Allocate a region of memory with provided size and alignment from the
+ * arena, and account it for the provided site.
+ * 
+ * @param arena     arena instance
+ * @param size      size of to-be-allocated memory block
+ * @param alignment alignment of the memory block (must be a power of two)
+ * @param site      site to account the region for
+ * 
+ * @return void*
+ */
+void* mirac_arena_malloc_aligned_as(
+	mirac_arena_s* const arena,
+	const uint64_t size,
+	const uint64_t alignment,
+	const mirac_arena_site_e site);
+
+// todo: write unit tests!
+/**
+ * @brief Grow a region of memory, previously allocated from the arena, to the
+ * provided size.
+ * 
+ * @note If the region is the last allocation of the arena's current chunk and the
+ * chunk has enough room, the region is extended in place. Otherwise a new region
+ * is allocated and the contents are copied over (the old one is abandoned until
+ * the arena is destroyed).
+ * 
+ * @param arena    arena instance
+ * @param pointer  pointer to the region to grow (may be mirac_null)
+ * @param old_size current size of the region
+ * @param new_size new size of the region
+ * 
+ * @return void*
+ */
+void* mirac_arena_realloc(
+	mirac_arena_s* const arena,
+	void* const pointer,
+	const uint64_t old_size,
+	const uint64_t new_size);
+
+// todo: write unit tests!
+/**
+ * @brief Grow a region of memory, previously allocated from the arena, to the
+ * provided size, and account the growth for the provided site.
+ * 
+ * @param arena    arena instance
+ * @param pointer  pointer to the region to grow (may be mirac_null)
+ * @param old_size current size of the region
+ * @param new_size new size of the region
+ * @param site     site to account the growth for
+ * 
+ * @return void*
+ */
+void* mirac_arena_realloc_as(
+	mirac_arena_s* const arena,
+	void* const pointer,
+	const uint64_t old_size,
+	const uint64_t new_size,
+	const mirac_arena_site_e site);
+
 #endif
@@ -18,6 +18,7 @@
 #include <stdint.h>
 #include <limits.h>
 #include <stdio.h>
+#include <setjmp.h>
 
 #define mirac_null NULL
 
@@ -68,11 +69,40 @@ void mirac_c_free(
 /**
  * @brief Wrapper for c's stdlib exit function.
  * 
+ * @note If the calling thread has an exit trap set, the trap is jumped to
+ * instead and the process keeps running.
+ * 
  * @param code code to exit with
  */
 void mirac_c_exit(
 	const int32_t code);
 
+/**
+ * @brief Exit trap structure.
+ * 
+ * Lets a thread survive the failure of a single task: once set, every call to
+ * mirac_c_exit on the thread stores its code in the trap and long jumps back to
+ * the setjmp of the trap's buffer.
+ */
+typedef struct
+{
+	jmp_buf buffer;
+	int32_t code;
+} mirac_c_exit_trap_s;
+
+// todo: write unit tests!
+/**
+ * @brief Set (or clear, if mirac_null is provided) the exit trap of the calling
+ * thread.
+ * 
+ * @note Anything allocated by the trapped task is not released by the jump, so
+ * the trap is meant for tasks whose failure ends the process shortly after.
+ * 
+ * @param trap exit trap, which buffer was already filled by setjmp
+ */
+void mirac_c_set_exit_trap(
+	mirac_c_exit_trap_s* const trap);
+
 // todo: write unit tests!
 /**
  * @brief Wrapper for c's stdlib memset function.
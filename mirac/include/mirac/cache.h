@@ -0,0 +1,162 @@
+/**
+ * @file cache.h
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-03-09
+ */
+
+#ifndef __mirac__include__mirac__cache_h__
+#define __mirac__include__mirac__cache_h__
+
+#include <mirac/c_common.h>
+#include <mirac/string_view.h>
+#include <mirac/config.h>
+#include <mirac/arena.h>
+#include <mirac/preprocessor.h>
+
+#include <pthread.h>
+
+/**
+ * @brief Default upper bound of the total size of the cache entries (in bytes).
+ */
+#define mirac_cache_default_max_size ((uint64_t)(256 * 1024 * 1024))
+
+/**
+ * @brief Key of a cache entry (128 bit hash of the unit's source and config).
+ */
+typedef struct
+{
+	uint64_t lanes[2];
+} mirac_cache_key_s;
+
+/**
+ * @brief On-disk compilation cache.
+ * 
+ * Each entry is a single file named after its key, holding the paths, sizes, and
+ * hashes of the files included by the unit, followed by the unit's assembly. An
+ * entry is a hit only if all of its included files are unchanged.
+ * 
+ * Entries are written into temporary files and renamed into place, so concurrent
+ * builds (and threads) never observe partially written entries. Once the total
+ * size of the entries exceeds the max size, the least recently used ones are
+ * removed.
+ */
+typedef struct
+{
+	mirac_string_view_s directory;
+	uint64_t max_size;
+	uint64_t size;
+	uint64_t hits_count;
+	uint64_t misses_count;
+	uint64_t stores_count;
+	uint64_t evictions_count;
+	pthread_mutex_t* mutex;
+} mirac_cache_s;
+
+// todo: write unit tests!
+/**
+ * @brief Create cache in the provided directory (created if it does not exist).
+ * 
+ * @param directory cache directory path
+ * @param max_size  upper bound of the total size of the entries (in bytes)
+ * 
+ * @return mirac_cache_s
+ */
+mirac_cache_s mirac_cache_from_parts(
+	const mirac_string_view_s directory,
+	const uint64_t max_size);
+
+// todo: write unit tests!
+/**
+ * @brief Destroy cache (the entries are kept on disk).
+ * 
+ * @param cache cache to destroy
+ */
+void mirac_cache_destroy(
+	mirac_cache_s* const cache);
+
+/**
+ * @brief Hash the bytes (xxh64).
+ * 
+ * @param data   bytes to hash
+ * @param length number of bytes to hash
+ * @param seed   seed of the hash
+ * 
+ * @return uint64_t
+ */
+uint64_t mirac_cache_hash(
+	const void* const data,
+	const uint64_t length,
+	const uint64_t seed);
+
+// todo: write unit tests!
+/**
+ * @brief Compute the key of a unit from its source, the mirac version, and every
+ * config field that affects the generated assembly.
+ * 
+ * @note The jobs count is not a part of the key, since the output does not
+ * depend on it. The directories the includes are resolved against (the one of
+ * the main file and the include paths) are a part of it, so that the same
+ * source in two directories never shares an entry.
+ * 
+ * @param arena            arena reference
+ * @param config           config reference
+ * @param source_file_path path of the unit's main file
+ * @param source           source of the unit's main file
+ * 
+ * @return mirac_cache_key_s
+ */
+mirac_cache_key_s mirac_cache_key_from_parts(
+	mirac_arena_s* const arena,
+	const mirac_config_s* const config,
+	const mirac_string_view_s source_file_path,
+	const mirac_string_view_s source);
+
+// todo: write unit tests!
+/**
+ * @brief Look up the entry of the key and copy its assembly into the output file
+ * on a hit.
+ * 
+ * @param cache       cache instance
+ * @param key         key of the unit
+ * @param output_file file to write the assembly into
+ * 
+ * @return bool_t
+ */
+bool_t mirac_cache_lookup(
+	mirac_cache_s* const cache,
+	const mirac_cache_key_s* const key,
+	mirac_file_t* const output_file);
+
+// todo: write unit tests!
+/**
+ * @brief Store the assembly of the unit (read back from the output file) along
+ * with the files it included.
+ * 
+ * @note Failures to store are reported as warnings and do not fail the build.
+ * 
+ * @param cache            cache instance
+ * @param key              key of the unit
+ * @param preprocessor     preprocessor of the unit
+ * @param output_file_path path of the written output file
+ */
+void mirac_cache_store(
+	mirac_cache_s* const cache,
+	const mirac_cache_key_s* const key,
+	const mirac_preprocessor_s* const preprocessor,
+	const mirac_string_view_s output_file_path);
+
+// todo: write unit tests!
+/**
+ * @brief Print the hit, miss, store, and eviction counts of the cache.
+ * 
+ * @param cache cache instance
+ */
+void mirac_cache_print_statistics(
+	const mirac_cache_s* const cache);
+
+#endif
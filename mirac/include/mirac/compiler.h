@@ -17,22 +17,52 @@
 #include <mirac/heap_array.h>
 #include <mirac/config.h>
 #include <mirac/arena.h>
+#include <mirac/emitter.h>
+#include <mirac/thread_pool.h>
 #include <mirac/lexer.h>
 #include <mirac/parser.h>
+#include <mirac/profiler.h>
+
+#define mirac_compiler_max_cached_slots_count 16
+
+/**
+ * @brief Top stack slots that the backend holds in registers instead of the
+ * memory, with the backend's index of the register of every one of them (from
+ * the deepest slot to the top one).
+ * 
+ * @note Several slots may share a register (after a dup or an over), so there
+ * can be more cached slots than registers.
+ */
+typedef struct
+{
+	uint64_t count;
+	uint8_t registers[mirac_compiler_max_cached_slots_count];
+} mirac_compiler_cache_s;
 
 typedef struct
 {
 	mirac_config_s* config;
 	mirac_arena_s* arena;
+	mirac_arena_s* scratch; // note: arena of the instruction list of the fun being compiled, which is reset after every fun.
 	mirac_ast_unit_s* unit;
-	mirac_file_t* file;
+	mirac_emitter_s emitter;
+	mirac_thread_pool_s* pool;
+	mirac_profiler_unit_s* profile;
+	mirac_compiler_cache_s cache;
+	mirac_compiler_cache_s else_cache; // note: cache that the if block has at its jump over the else block after it.
 } mirac_compiler_s;
 
+// note: if a thread pool with more than one worker is provided, the defs of the
+//       unit are compiled on it in parallel. If a profile is provided, the
+//       flushes of the output are timed as the write phase, and the defs are
+//       traced as spans.
 mirac_compiler_s mirac_compiler_from_parts(
 	mirac_config_s* const config,
 	mirac_arena_s* const arena,
 	mirac_ast_unit_s* const unit,
-	mirac_file_t* const file);
+	mirac_file_t* const file,
+	mirac_thread_pool_s* const pool,
+	mirac_profiler_unit_s* const profile);
 
 void mirac_compiler_compile_ast_unit(
 	mirac_compiler_s* const compiler);
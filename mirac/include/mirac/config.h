@@ -30,6 +30,8 @@ mirac_string_view_s mirac_config_arch_type_to_string_view(
 typedef enum
 {
 	mirac_config_format_type_nasm = 0,
+	mirac_config_format_type_elf64,
+	mirac_config_format_type_elf64_exec,
 	mirac_config_format_types_count,
 
 	mirac_config_format_type_none
@@ -38,6 +40,8 @@ typedef enum
 mirac_string_view_s mirac_config_format_type_to_string_view(
 	const mirac_config_format_type_e type);
 
+#define mirac_config_max_optimization_level 1
+
 typedef struct
 {
 	mirac_config_arch_type_e arch;
@@ -46,6 +50,18 @@ typedef struct
 	bool_t dump_ast;
 	bool_t unsafe;
 	bool_t strip;
+	uint64_t optimization;
+	uint64_t jobs;
+	mirac_string_view_s* include_paths;
+	uint64_t include_paths_count;
+	mirac_string_view_s cache_dir;
+	uint64_t cache_size;
+	mirac_string_view_s socket_path;
+	bool_t watch;
+	bool_t time_report;
+	mirac_string_view_s trace_path;
+	bool_t mem_report;
+	bool_t prelex;
 } mirac_config_s;
 
 // todo: write unit tests!
@@ -0,0 +1,129 @@
+/**
+ * @file emitter.h
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-01-24
+ */
+
+#ifndef __mirac__include__mirac__emitter_h__
+#define __mirac__include__mirac__emitter_h__
+
+#include <mirac/c_common.h>
+#include <mirac/string_view.h>
+#include <mirac/arena.h>
+#include <mirac/profiler.h>
+
+/**
+ * @brief Capacity of the buffer of an emitter that writes into a file.
+ * 
+ * @note The buffer is flushed into the file with a single write each time it
+ * fills up.
+ */
+#define mirac_emitter_capacity ((uint64_t)(256 * 1024))
+
+/**
+ * @brief Initial capacity of the buffer of an emitter that has no file.
+ */
+#define mirac_emitter_min_memory_capacity ((uint64_t)1024)
+
+/**
+ * @brief Emitter structure.
+ * 
+ * If the emitter has no file, all the emitted bytes are kept in its buffer,
+ * which grows as needed, and the flush does nothing.
+ */
+typedef struct
+{
+	mirac_arena_s* arena;
+	mirac_file_t* file;
+	char_t* data;
+	uint64_t length;
+	uint64_t capacity;
+	mirac_profiler_unit_s* profile; // note: if set, the flushes are timed as the write phase.
+} mirac_emitter_s;
+
+// todo: write unit tests!
+/**
+ * @brief Create emitter, which writes into the provided file (or keeps the
+ * emitted bytes in memory, if mirac_null is provided).
+ * 
+ * @note The buffer is allocated from the arena on the first emit.
+ * 
+ * @param arena arena reference
+ * @param file  file to flush the emitted bytes into (may be mirac_null)
+ * 
+ * @return mirac_emitter_s
+ */
+mirac_emitter_s mirac_emitter_from_parts(
+	mirac_arena_s* const arena,
+	mirac_file_t* const file);
+
+// todo: write unit tests!
+/**
+ * @brief Append bytes to the emitter's buffer.
+ * 
+ * @param emitter emitter instance
+ * @param data    bytes to append
+ * @param length  number of bytes to append
+ */
+void mirac_emitter_emit(
+	mirac_emitter_s* const emitter,
+	const char_t* const data,
+	const uint64_t length);
+
+/**
+ * @brief Append a string literal to the emitter's buffer (its length is
+ * computed at compile time).
+ */
+#define mirac_emitter_emit_static(_emitter, _string)                           \
+	mirac_emitter_emit((_emitter), (_string), sizeof(_string) - 1)
+
+// todo: write unit tests!
+/**
+ * @brief Append a string view to the emitter's buffer.
+ * 
+ * @param emitter     emitter instance
+ * @param string_view string view to append
+ */
+void mirac_emitter_emit_string_view(
+	mirac_emitter_s* const emitter,
+	const mirac_string_view_s string_view);
+
+// todo: write unit tests!
+/**
+ * @brief Append the decimal representation of an unsigned integer to the
+ * emitter's buffer.
+ * 
+ * @param emitter emitter instance
+ * @param value   value to append
+ */
+void mirac_emitter_emit_u64(
+	mirac_emitter_s* const emitter,
+	const uint64_t value);
+
+// todo: write unit tests!
+/**
+ * @brief Append the decimal representation of a signed integer to the emitter's
+ * buffer.
+ * 
+ * @param emitter emitter instance
+ * @param value   value to append
+ */
+void mirac_emitter_emit_i64(
+	mirac_emitter_s* const emitter,
+	const int64_t value);
+
+// todo: write unit tests!
+/**
+ * @brief Write the emitter's buffer into its file and empty the buffer.
+ * 
+ * @param emitter emitter instance
+ */
+void mirac_emitter_flush(
+	mirac_emitter_s* const emitter);
+
+#endif
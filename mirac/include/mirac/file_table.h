@@ -0,0 +1,127 @@
+/**
+ * @file file_table.h
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-04-06
+ */
+
+#ifndef __mirac__include__mirac__file_table_h__
+#define __mirac__include__mirac__file_table_h__
+
+#include <mirac/c_common.h>
+#include <mirac/string_view.h>
+
+typedef struct
+{
+	mirac_string_view_s file;
+	uint64_t line;
+	uint64_t column;
+} mirac_location_s;
+
+/**
+ * @brief Format string of the location (to be used with mirac_location_arg).
+ */
+#define mirac_location_fmt mirac_sv_fmt ":%lu:%lu"
+
+/**
+ * @brief Arguments of the location's format string.
+ */
+#define mirac_location_arg(_location) \
+	mirac_sv_arg((_location).file), (_location).line, (_location).column
+
+/**
+ * @brief Handle of a source file registered in the file table.
+ */
+typedef uint16_t mirac_file_id_t;
+
+/**
+ * @brief Handle that never refers to a registered file.
+ */
+#define mirac_file_id_none ((mirac_file_id_t)0)
+
+/**
+ * @brief Maximum size of a registered source (offsets into it are 32 bits).
+ */
+#define mirac_file_table_max_source_size ((uint64_t)UINT32_MAX)
+
+/**
+ * @brief Position in a registered source file.
+ * 
+ * It is all a token or an ast node keeps of its location, while the line and
+ * column are only computed (by @ref mirac_file_table_get_location) when a
+ * diagnostic needs them.
+ */
+typedef struct
+{
+	mirac_file_id_t file;
+	uint32_t offset;
+} mirac_position_s;
+
+// todo: write unit tests!
+/**
+ * @brief Register the source of the file in the process-wide file table.
+ * 
+ * @note Neither the path nor the source are copied, so both have to outlive the
+ * registration.
+ * 
+ * @param path   path of the file
+ * @param source source of the file
+ * 
+ * @return mirac_file_id_t
+ */
+mirac_file_id_t mirac_file_table_register(
+	const mirac_string_view_s path,
+	const mirac_string_view_s source);
+
+// todo: write unit tests!
+/**
+ * @brief Unregister the file, so that its handle can be reused.
+ * 
+ * @warning Positions in the file must not be used after it is unregistered.
+ * 
+ * @param file handle of the file
+ */
+void mirac_file_table_unregister(
+	const mirac_file_id_t file);
+
+// todo: write unit tests!
+/**
+ * @brief Get the path of the registered file (empty for mirac_file_id_none).
+ * 
+ * @param file handle of the file
+ * 
+ * @return mirac_string_view_s
+ */
+mirac_string_view_s mirac_file_table_get_path(
+	const mirac_file_id_t file);
+
+// todo: write unit tests!
+/**
+ * @brief Get the source of the registered file (empty for mirac_file_id_none).
+ * 
+ * @param file handle of the file
+ * 
+ * @return mirac_string_view_s
+ */
+mirac_string_view_s mirac_file_table_get_source(
+	const mirac_file_id_t file);
+
+// todo: write unit tests!
+/**
+ * @brief Compute the line and column of the position.
+ * 
+ * The offsets of the lines of a file are only indexed the first time one of its
+ * positions is located, after which every lookup is a binary search.
+ * 
+ * @param position position to locate
+ * 
+ * @return mirac_location_s
+ */
+mirac_location_s mirac_file_table_get_location(
+	const mirac_position_s position);
+
+#endif
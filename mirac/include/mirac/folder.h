@@ -0,0 +1,75 @@
+/**
+ * @file folder.h
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-04-23
+ */
+
+#ifndef __mirac__include__mirac__folder_h__
+#define __mirac__include__mirac__folder_h__
+
+#include <mirac/c_common.h>
+#include <mirac/heap_array.h>
+#include <mirac/arena.h>
+#include <mirac/parser.h>
+
+mirac_define_heap_array_type(mirac_folder_value_list, uint64_t);
+
+/**
+ * @brief Constant folder of the ast unit.
+ * 
+ * It walks the scopes of every fun, and evaluates the runs of literals and pure
+ * stack operations (arithmetic, bitwise, logical, comparison, and the drop, dup,
+ * over, rot, and swap ones) whose inputs are all pushed by the run itself. Each
+ * of the runs is then replaced by the literals it leaves on the stack (which is
+ * a single literal most of the time). The values are computed the way the code
+ * generated for the operations computes them, and the divisions by zero are
+ * left to happen at runtime.
+ */
+typedef struct
+{
+	mirac_arena_s* arena;
+	mirac_ast_unit_s* unit;
+	mirac_folder_value_list_s values; // note: values that the current run leaves on the stack.
+	uint64_t folds_count;             // note: number of the runs that were replaced.
+} mirac_folder_s;
+
+// todo: write unit tests!
+/**
+ * @brief Create folder from arena and ast unit.
+ * 
+ * @param arena arena reference
+ * @param unit  ast unit to fold
+ * 
+ * @return mirac_folder_s
+ */
+mirac_folder_s mirac_folder_from_parts(
+	mirac_arena_s* const arena,
+	mirac_ast_unit_s* const unit);
+
+// todo: write unit tests!
+/**
+ * @brief Destroy folder.
+ * 
+ * @param folder folder to destroy
+ */
+void mirac_folder_destroy(
+	mirac_folder_s* const folder);
+
+// todo: write unit tests!
+/**
+ * @brief Fold the constant runs of the ast unit in place.
+ * 
+ * @note The folded literals reuse the blocks of the runs (and the spans of the
+ * scopes shrink), so no blocks are added to the unit.
+ * 
+ * @param folder folder reference
+ */
+void mirac_folder_fold_ast_unit(
+	mirac_folder_s* const folder);
+
+#endif
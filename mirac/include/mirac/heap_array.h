@@ -17,6 +17,11 @@
 #include <mirac/debug.h>
 #include <mirac/arena.h>
 
+/**
+ * @brief Capacity of a heap array after its first growth.
+ */
+#define mirac_heap_array_min_capacity 8
+
 // todo: write unit tests!
 
 #define mirac_define_heap_array_type(_type_name, _element_type)                \
@@ -51,13 +56,17 @@
 		mirac_arena_s* const arena,                                            \
 		const uint64_t capacity)                                               \
 	{                                                                          \
-		mirac_debug_assert(capacity > 0);                                      \
+		mirac_debug_assert(arena != mirac_null);                               \
 		                                                                       \
 		_type_name ## _s heap_array = {0};                                     \
 		heap_array.arena = arena;                                              \
 		                                                                       \
-		heap_array.data = (_element_type*)mirac_arena_malloc(                  \
-			heap_array.arena, capacity * sizeof(_element_type));               \
+		if (capacity > 0)                                                      \
+		{                                                                      \
+			heap_array.data = (_element_type*)mirac_arena_malloc_as(           \
+				heap_array.arena, capacity * sizeof(_element_type),            \
+				mirac_arena_scoped_site(arena, mirac_arena_site_lists));       \
+		}                                                                      \
 		                                                                       \
 		heap_array.capacity = capacity;                                        \
 		heap_array.count = 0;                                                  \
@@ -69,26 +78,21 @@
 		_element_type element)                                                 \
 	{                                                                          \
 		mirac_debug_assert(heap_array != mirac_null);                          \
+		mirac_debug_assert(heap_array->arena != mirac_null);                   \
 		                                                                       \
-		if (heap_array->count + 1 >= heap_array->capacity)                     \
+		if (heap_array->count >= heap_array->capacity)                         \
 		{                                                                      \
-			const uint64_t new_capacity = (uint64_t)(                          \
-				heap_array->capacity + (heap_array->capacity / 2) + 1          \
-			);                                                                 \
-			                                                                   \
-			_element_type* new_data = mirac_arena_malloc(                      \
-				heap_array->arena, new_capacity * sizeof(_element_type));      \
+			const uint64_t new_capacity = heap_array->capacity > 0 ?           \
+				heap_array->capacity * 2 : mirac_heap_array_min_capacity;      \
 			                                                                   \
-			if (heap_array->count > 0)                                         \
-			{                                                                  \
-				mirac_c_memcpy(                                                \
-					new_data,                                                  \
-					heap_array->data,                                          \
-					heap_array->count * sizeof(_element_type)                  \
-				);                                                             \
-			}                                                                  \
+			/* note: grows in place if it is the last arena allocation. */     \
+			heap_array->data = (_element_type*)mirac_arena_realloc_as(         \
+				heap_array->arena, heap_array->data,                           \
+				heap_array->capacity * sizeof(_element_type),                  \
+				new_capacity * sizeof(_element_type),                          \
+				mirac_arena_scoped_site(heap_array->arena,                     \
+					mirac_arena_site_lists));                                  \
 			                                                                   \
-			heap_array->data = new_data;                                       \
 			heap_array->capacity = new_capacity;                               \
 		}                                                                      \
 		                                                                       \
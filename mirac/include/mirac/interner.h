@@ -0,0 +1,114 @@
+/**
+ * @file interner.h
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-01-22
+ */
+
+#ifndef __mirac__include__mirac__interner_h__
+#define __mirac__include__mirac__interner_h__
+
+#include <mirac/c_common.h>
+#include <mirac/heap_array.h>
+#include <mirac/string_view.h>
+#include <mirac/arena.h>
+
+/**
+ * @brief Handle of an interned string.
+ * 
+ * Two strings interned by the same interner are equal if and only if their
+ * handles are equal.
+ */
+typedef uint32_t mirac_symbol_t;
+
+/**
+ * @brief Handle that never refers to an interned string.
+ */
+#define mirac_symbol_none ((mirac_symbol_t)0)
+
+/**
+ * @brief Capacity of the interner's slot table after its first growth.
+ */
+#define mirac_interner_min_slots_capacity 64
+
+typedef struct
+{
+	mirac_string_view_s string;
+	uint64_t hash;
+} mirac_interner_entry_s;
+
+mirac_define_heap_array_type(mirac_interner_entry_list, mirac_interner_entry_s);
+
+/**
+ * @brief String interner structure.
+ * 
+ * Entries are stored in order of interning (entry at index i has handle i + 1),
+ * and looked up through an open addressing slot table of handles with linear
+ * probing. The table is kept at most half full.
+ */
+typedef struct
+{
+	mirac_arena_s* arena;
+	mirac_interner_entry_list_s entries;
+	mirac_symbol_t* slots;
+	uint64_t slots_capacity;
+} mirac_interner_s;
+
+// todo: write unit tests!
+/**
+ * @brief Create interner with provided arena.
+ * 
+ * @param arena arena reference
+ * 
+ * @return mirac_interner_s
+ */
+mirac_interner_s mirac_interner_from_parts(
+	mirac_arena_s* const arena);
+
+// todo: write unit tests!
+/**
+ * @brief Intern the string and return its handle.
+ * 
+ * @note The string is copied into the interner's arena only the first time it
+ * is interned, so the string view passed in is free to be reused afterwards.
+ * 
+ * @param interner interner instance
+ * @param string   string to intern
+ * 
+ * @return mirac_symbol_t
+ */
+mirac_symbol_t mirac_interner_intern(
+	mirac_interner_s* const interner,
+	const mirac_string_view_s string);
+
+// todo: write unit tests!
+/**
+ * @brief Get the interned string of the provided handle.
+ * 
+ * @param interner interner instance
+ * @param symbol   handle of an interned string
+ * 
+ * @return mirac_string_view_s
+ */
+mirac_string_view_s mirac_interner_get_string(
+	const mirac_interner_s* const interner,
+	const mirac_symbol_t symbol);
+
+// todo: write unit tests!
+/**
+ * @brief Get the cached hash of the interned string of the provided handle.
+ * 
+ * @param interner interner instance
+ * @param symbol   handle of an interned string
+ * 
+ * @return uint64_t
+ */
+uint64_t mirac_interner_get_hash(
+	const mirac_interner_s* const interner,
+	const mirac_symbol_t symbol);
+
+#endif
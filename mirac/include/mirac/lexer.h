@@ -14,27 +14,12 @@
 #define __mirac__include__mirac__lexer_h__
 
 #include <mirac/c_common.h>
+#include <mirac/heap_array.h>
 #include <mirac/string_view.h>
 #include <mirac/config.h>
 #include <mirac/arena.h>
-
-typedef struct
-{
-	mirac_string_view_s file;
-	uint64_t line;
-	uint64_t column;
-} mirac_location_s;
-
-/**
- * @brief Location formatting macro for printf-like functions.
- */
-#define mirac_location_fmt mirac_sv_fmt ":%lu:%lu"
-
-/**
- * @brief Location formatting argument macro for printf-like functions.
- */
-#define mirac_location_arg(_location) \
-	mirac_sv_arg((_location).file), (_location).line, (_location).column
+#include <mirac/interner.h>
+#include <mirac/file_table.h>
 
 typedef enum
 {
@@ -137,6 +122,17 @@ typedef enum
 
 	mirac_token_type_identifier,
 
+	// Preprocessor directives (a directive is a line that starts with '#', and its
+	// arguments are the tokens up to the directive end token at the line's end)
+	mirac_token_type_directive_include,
+	mirac_token_type_directive_define,
+	mirac_token_type_directive_undef,
+	mirac_token_type_directive_ifdef,
+	mirac_token_type_directive_ifndef,
+	mirac_token_type_directive_else,
+	mirac_token_type_directive_endif,
+	mirac_token_type_directive_end,
+
 	// Magic tokens
 	mirac_token_type_eof,
 	mirac_token_type_none
@@ -155,43 +151,54 @@ mirac_string_view_s mirac_token_type_to_string_view(
 
 typedef struct mirac_token_s mirac_token_s;
 
+/**
+ * @brief Token structure (24 bytes).
+ * 
+ * A token only keeps the position of its text in the registered source file, so
+ * its text and location are derived on demand (see @ref mirac_token_get_text
+ * and @ref mirac_token_get_location).
+ */
 struct mirac_token_s
 {
-	mirac_token_type_e type;
-	mirac_location_s location;
-	uint64_t index;
+	uint8_t type; // note: mirac_token_type_e.
+	mirac_file_id_t file;
+	uint32_t offset;
+	uint32_t length; // note: length of the text.
+
+	union
+	{
+		mirac_symbol_t symbol;  // note: identifiers.
+		uint32_t str_length;    // note: string literals.
+	};
 
 	union
 	{
 		int64_t ival;
 		uint64_t uval;
-		long double fval;
 		uintptr_t ptr;
-		mirac_string_view_s str;
-		mirac_string_view_s ident;
+		const char_t* str;      // note: value of string literals.
+		const char_t* ident;    // note: interned text of identifiers.
 	} as;
-
-	mirac_string_view_s text;
 };
 
+mirac_define_heap_array_type(mirac_token_list, mirac_token_s);
+
 // todo: write unit tests!
 /**
- * @brief Create token with provided token type and location.
+ * @brief Create token with provided token type and position of its text.
  * 
  * @note All the rest of the fields will be initialized to 0.
  * 
  * @param type     token type to assign to the new token
- * @param location location to set to the token
- * @param index    global index of the token
- * @param text     text representation from the file
+ * @param position position of the token's text
+ * @param length   length of the token's text
  * 
  * @return mirac_token_s
  */
 mirac_token_s mirac_token_from_parts(
 	const mirac_token_type_e type,
-	const mirac_location_s location,
-	const uint64_t index,
-	const mirac_string_view_s text);
+	const mirac_position_s position,
+	const uint64_t length);
 
 // todo: write unit tests!
 /**
@@ -223,6 +230,9 @@ void mirac_token_destroy(
 /**
  * @brief Stringify token and return the string view.
  * 
+ * @note The view points into a per-thread buffer, which is overwritten by the
+ * next call on the same thread.
+ * 
  * @param token token type to stringify
  * 
  * @return mirac_string_view_s
@@ -230,6 +240,64 @@ void mirac_token_destroy(
 mirac_string_view_s mirac_token_to_string_view(
 	const mirac_token_s* const token);
 
+// todo: write unit tests!
+/**
+ * @brief Get the position of the token's text.
+ * 
+ * @param token token to get the position of
+ * 
+ * @return mirac_position_s
+ */
+mirac_position_s mirac_token_get_position(
+	const mirac_token_s* const token);
+
+// todo: write unit tests!
+/**
+ * @brief Compute the location of the token (for diagnostics).
+ * 
+ * @param token token to locate
+ * 
+ * @return mirac_location_s
+ */
+mirac_location_s mirac_token_get_location(
+	const mirac_token_s* const token);
+
+// todo: write unit tests!
+/**
+ * @brief Get the text of the token.
+ * 
+ * Reserved tokens are spelled by their type, identifiers by their interned text,
+ * and every other token by its source file.
+ * 
+ * @param token token to get the text of
+ * 
+ * @return mirac_string_view_s
+ */
+mirac_string_view_s mirac_token_get_text(
+	const mirac_token_s* const token);
+
+// todo: write unit tests!
+/**
+ * @brief Get the interned text of the identifier token.
+ * 
+ * @param token identifier token
+ * 
+ * @return mirac_string_view_s
+ */
+mirac_string_view_s mirac_token_get_ident(
+	const mirac_token_s* const token);
+
+// todo: write unit tests!
+/**
+ * @brief Get the value of the string literal token.
+ * 
+ * @param token string literal token
+ * 
+ * @return mirac_string_view_s
+ */
+mirac_string_view_s mirac_token_get_string(
+	const mirac_token_s* const token);
+
 // todo: write unit tests!
 /**
  * @brief Check if a token is unsigned numeric literal.
@@ -256,20 +324,29 @@ typedef struct
 {
 	mirac_config_s* config;
 	mirac_arena_s* arena;
+	mirac_interner_s* interner;
 	mirac_string_view_s file_path;
-	mirac_location_s locations[2];
-	uint64_t tokens_count;
+	mirac_file_id_t file;
 	mirac_token_s token;
+	mirac_string_view_s source;
+	bool_t is_source_mapped;
 	mirac_string_view_s buffer;
 	mirac_string_view_s line;
+	bool_t is_at_line_start;
+	bool_t is_in_directive;
+	bool_t is_directive_name;
 } mirac_lexer_s;
 
 // todo: write unit tests!
 /**
  * @brief Create a lexer with provided source string.
  * 
+ * The source is memory mapped (read-only) when the file is a regular file, and
+ * read into memory otherwise (pipes, for example).
+ * 
  * @param config    config instance
  * @param arena     arena instance for memory management
+ * @param interner  interner instance for identifiers
  * @param file_path file path
  * @param file      file for lexing
  * 
@@ -278,6 +355,7 @@ typedef struct
 mirac_lexer_s mirac_lexer_from_parts(
 	mirac_config_s* const config,
 	mirac_arena_s* const arena,
+	mirac_interner_s* const interner,
 	const mirac_string_view_s file_path,
 	mirac_file_t* const file);
 
@@ -285,12 +363,16 @@ mirac_lexer_s mirac_lexer_from_parts(
 /**
  * @brief Destroy the lexer.
  * 
- * This function deallocates the internal lexer's buffer and resets all its fields
- * to zero.
+ * This function unmaps (or deallocates) the internal lexer's source and resets all
+ * its fields to zero.
  * 
  * @warning This function does not close the file, used by lexer! It is left for the
  * user of the lexer to close the file after finishing with the lexer.
  * 
+ * @warning The lexer's file is unregistered from the file table, and texts of
+ * tokens and escape-free string literals are views into the lexer's source, so
+ * its tokens must not be used after the lexer is destroyed.
+ * 
  * @param lexer lexer instance
  */
 void mirac_lexer_destroy(
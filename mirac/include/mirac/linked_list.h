@@ -60,9 +60,13 @@
 		_element_type data)                                                    \
 	{                                                                          \
 		mirac_debug_assert(linked_list != mirac_null);                         \
+		mirac_debug_assert(linked_list->arena != mirac_null);                  \
 		                                                                       \
-		_type_name ## _node_s* node = (_type_name ## _node_s*)mirac_c_malloc(  \
-			sizeof(_type_name ## _node_s));                                    \
+		_type_name ## _node_s* node = (_type_name ## _node_s*)                 \
+			mirac_arena_malloc_as(                                             \
+				linked_list->arena, sizeof(_type_name ## _node_s),             \
+				mirac_arena_scoped_site(linked_list->arena,                    \
+					mirac_arena_site_lists));                                  \
 		mirac_debug_assert(node != mirac_null);                                \
 		                                                                       \
 		node->data = data;                                                     \
@@ -78,11 +82,6 @@
 		}                                                                      \
 		else                                                                   \
 		{                                                                      \
-			while (linked_list->end->next != mirac_null)                       \
-			{                                                                  \
-				linked_list->end = linked_list->end->next;                     \
-			}                                                                  \
-			                                                                   \
 			node->prev = linked_list->end;                                     \
 			linked_list->end->next = node;                                     \
 			mirac_debug_assert(linked_list->end->next != mirac_null);          \
@@ -16,6 +16,58 @@
 #include <mirac/debug.h>
 #include <mirac/c_common.h>
 
+/**
+ * @brief Logger capture structure.
+ * 
+ * Holds the logs of a thread, which would otherwise go into stdout or stderr,
+ * so that they can be printed later as a whole. Every log is stored as the
+ * stream it was meant for, its length and its bytes.
+ */
+typedef struct
+{
+	char_t* data;
+	uint64_t length;
+	uint64_t capacity;
+} mirac_logger_capture_s;
+
+// todo: write unit tests!
+/**
+ * @brief Create empty logger capture.
+ * 
+ * @return mirac_logger_capture_s
+ */
+mirac_logger_capture_s mirac_logger_capture_from_parts(
+	void);
+
+// todo: write unit tests!
+/**
+ * @brief Destroy logger capture.
+ * 
+ * @param capture capture to destroy
+ */
+void mirac_logger_capture_destroy(
+	mirac_logger_capture_s* const capture);
+
+// todo: write unit tests!
+/**
+ * @brief Redirect all the logs of the calling thread into the capture (or back
+ * into their streams, if mirac_null is provided).
+ * 
+ * @param capture capture to redirect the logs into
+ */
+void mirac_logger_set_capture(
+	mirac_logger_capture_s* const capture);
+
+// todo: write unit tests!
+/**
+ * @brief Print the captured logs into their streams in the order they were
+ * logged.
+ * 
+ * @param capture capture to print
+ */
+void mirac_logger_capture_print(
+	const mirac_logger_capture_s* const capture);
+
 /**
  * @brief Log tagless level formattable messages.
  * 
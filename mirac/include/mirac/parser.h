@@ -14,37 +14,65 @@
 #define __mirac__include__mirac__parser_h__
 
 #include <mirac/c_common.h>
-#include <mirac/linked_list.h>
+#include <mirac/heap_array.h>
+#include <mirac/symbol_table.h>
 #include <mirac/config.h>
 #include <mirac/arena.h>
 #include <mirac/lexer.h>
+#include <mirac/preprocessor.h>
+#include <mirac/profiler.h>
 
-typedef struct mirac_ast_block_s mirac_ast_block_s;
 typedef struct mirac_ast_def_s mirac_ast_def_s;
 
-mirac_define_linked_list_type(mirac_token_list, mirac_token_s);
-mirac_define_linked_list_type(mirac_ast_block_list, mirac_ast_block_s*);
-mirac_define_linked_list_type(mirac_ast_def_list, mirac_ast_def_s*);
+/**
+ * @brief Handle of a block, which is its index in the block arrays of its unit.
+ */
+typedef uint32_t mirac_ast_block_t;
+
+/**
+ * @brief Handle that never refers to a block.
+ */
+#define mirac_ast_block_none ((mirac_ast_block_t)UINT32_MAX)
 
+/**
+ * @brief Span of elements in one of the shared arrays of a unit.
+ */
 typedef struct
 {
-	mirac_token_s token;
+	uint32_t begin;
+	uint32_t count;
+} mirac_ast_range_s;
+
+mirac_define_heap_array_type(mirac_ast_block_list, mirac_ast_block_t);
+mirac_define_heap_array_type(mirac_ast_def_list, mirac_ast_def_s*);
+mirac_define_symbol_table_type(mirac_ast_def_table, mirac_ast_def_s*);
+
+typedef struct
+{
+	uint8_t token_type;
+	uint32_t length; // note: length of the token's text.
+
+	union
+	{
+		int64_t ival;
+		uint64_t uval;
+		uintptr_t ptr;
+	} as;
 } mirac_ast_block_expr_s;
 
 typedef struct
 {
-	mirac_token_s token;
 	mirac_ast_def_s* def;
 } mirac_ast_block_ident_s;
 
 typedef struct
 {
-	mirac_ast_block_s* ident; // note: must be ident block.
+	mirac_ast_block_t ident; // note: must be ident block.
 } mirac_ast_block_call_s;
 
 typedef struct
 {
-	mirac_token_list_s type_tokens;
+	mirac_ast_range_s type_tokens; // note: span of the unit's type tokens.
 } mirac_ast_block_as_s;
 
 typedef enum
@@ -68,33 +96,35 @@ mirac_string_view_s mirac_ast_block_scope_type_to_string_view(
 typedef struct
 {
 	mirac_ast_block_scope_type_e type;
-	mirac_ast_block_list_s blocks;
+	mirac_ast_range_s blocks; // note: span of the unit's children.
 } mirac_ast_block_scope_s;
 
 typedef struct
 {
-	mirac_ast_block_s* cond; // note: must be scope block.
-	mirac_ast_block_s* body; // note: must be scope block.
-	mirac_ast_block_s* next;
-	uint64_t index;
+	mirac_ast_block_t cond; // note: must be scope block.
+	mirac_ast_block_t body; // note: must be scope block.
+	mirac_ast_block_t next; // note: else block or mirac_ast_block_none.
+	uint32_t index;
 } mirac_ast_block_if_s;
 
 typedef struct
 {
-	mirac_ast_block_s* body; // note: must be scope block.
-	uint64_t index;
+	mirac_ast_block_t body; // note: must be scope block.
+	uint32_t index;
 } mirac_ast_block_else_s;
 
 typedef struct
 {
-	mirac_ast_block_s* cond; // note: must be scope block.
-	mirac_ast_block_s* body; // note: must be scope block.
-	uint64_t index;
+	mirac_ast_block_t cond; // note: must be scope block.
+	mirac_ast_block_t body; // note: must be scope block.
+	uint32_t index;
 } mirac_ast_block_loop_s;
 
 typedef struct
 {
-	mirac_token_s inst;
+	const char_t* inst;
+	uint32_t inst_length;
+	uint32_t length; // note: length of the literal's text.
 } mirac_ast_block_asm_s;
 
 typedef enum
@@ -124,11 +154,11 @@ typedef enum
 mirac_string_view_s mirac_ast_block_type_to_string_view(
 	const mirac_ast_block_type_e type);
 
-struct mirac_ast_block_s
+/**
+ * @brief Payload of a block, which is interpreted by the block's type.
+ */
+typedef struct
 {
-	mirac_location_s location;
-	mirac_ast_block_type_e type;
-
 	union
 	{
 		mirac_ast_block_expr_s  expr_block;
@@ -141,14 +171,18 @@ struct mirac_ast_block_s
 		mirac_ast_block_loop_s  loop_block;
 		mirac_ast_block_asm_s   asm_block;
 	} as;
-};
+} mirac_ast_block_payload_s;
+
+mirac_define_heap_array_type(mirac_ast_block_type_list, uint8_t);
+mirac_define_heap_array_type(mirac_ast_block_position_list, mirac_position_s);
+mirac_define_heap_array_type(mirac_ast_block_payload_list, mirac_ast_block_payload_s);
 
 typedef struct
 {
 	mirac_token_s identifier;
 	mirac_token_list_s req_tokens;
 	mirac_token_list_s ret_tokens;
-	mirac_ast_block_s* body; // note: must be scope block.
+	mirac_ast_block_t body; // note: must be scope block.
 	bool_t is_entry;
 	uint64_t index;
 } mirac_ast_def_fun_s;
@@ -188,7 +222,7 @@ mirac_string_view_s mirac_ast_def_type_to_string_view(
 
 struct mirac_ast_def_s
 {
-	mirac_location_s location;
+	mirac_position_s position;
 	mirac_token_s section;
 	mirac_ast_def_type_e type;
 	bool_t is_used;
@@ -212,9 +246,23 @@ struct mirac_ast_def_s
 mirac_token_s mirac_ast_def_get_identifier_token(
 	const mirac_ast_def_s* const def);
 
+/**
+ * @brief Unit of defs, whose blocks are stored in flat arrays.
+ * 
+ * The type, position, and payload of a block are at its handle's index in the
+ * parallel arrays, and the blocks of a scope are a span of the shared children
+ * array (like the type tokens of an as block are a span of the type tokens).
+ * A def's body is laid out in pre-order, so a walk over it reads the arrays
+ * mostly front to back.
+ */
 typedef struct
 {
 	mirac_ast_def_list_s defs;
+	mirac_ast_block_type_list_s block_types;
+	mirac_ast_block_position_list_s block_positions;
+	mirac_ast_block_payload_list_s block_payloads;
+	mirac_ast_block_list_s children;
+	mirac_token_list_s type_tokens;
 } mirac_ast_unit_s;
 
 // todo: write unit tests!
@@ -228,6 +276,60 @@ typedef struct
 mirac_ast_unit_s mirac_ast_unit_from_parts(
 	mirac_arena_s* const arena);
 
+// todo: write unit tests!
+/**
+ * @brief Get the type of the unit's block.
+ * 
+ * @param unit  ast unit reference
+ * @param block handle of the block
+ * 
+ * @return mirac_ast_block_type_e
+ */
+mirac_ast_block_type_e mirac_ast_unit_get_block_type(
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block);
+
+// todo: write unit tests!
+/**
+ * @brief Get the position of the unit's block (of its first token).
+ * 
+ * @param unit  ast unit reference
+ * @param block handle of the block
+ * 
+ * @return mirac_position_s
+ */
+mirac_position_s mirac_ast_unit_get_block_position(
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block);
+
+// todo: write unit tests!
+/**
+ * @brief Get the payload of the unit's block.
+ * 
+ * @warning The reference is invalidated by adding blocks to the unit.
+ * 
+ * @param unit  ast unit reference
+ * @param block handle of the block
+ * 
+ * @return const mirac_ast_block_payload_s*
+ */
+const mirac_ast_block_payload_s* mirac_ast_unit_get_block_payload(
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block);
+
+// todo: write unit tests!
+/**
+ * @brief Rebuild the token of the unit's expr, ident, or asm block.
+ * 
+ * @param unit  ast unit reference
+ * @param block handle of the block
+ * 
+ * @return mirac_token_s
+ */
+mirac_token_s mirac_ast_unit_get_block_token(
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block);
+
 /**
  * @brief Print ast unit.
  * 
@@ -255,25 +357,34 @@ typedef struct
 {
 	mirac_config_s* config;
 	mirac_arena_s* arena;
-	mirac_lexer_s* lexer;
+	mirac_preprocessor_s* preprocessor;
 	mirac_ast_statistics_s stats;
 	mirac_ast_unit_s unit;
+	mirac_ast_def_table_s def_table;
+	mirac_ast_block_list_s pending_children; // note: children of the scopes being parsed.
+	mirac_token_list_s tokens;               // note: all the unit's tokens, if they are pre-lexed.
+	uint64_t token_index;                    // note: index of the next pre-lexed token.
+	bool_t is_prelexed;
+	mirac_symbol_t entry_symbol;
+	mirac_profiler_unit_s* profile; // note: mirac_null unless the unit is profiled.
 } mirac_parser_s;
 
 // todo: write unit tests!
 /**
- * @brief Create parser from config, arena, and lexer.
+ * @brief Create parser from config, arena, and preprocessor.
  * 
- * @param config config reference
- * @param arena  arena reference
- * @param lexer  lexer reference
+ * @param config       config reference
+ * @param arena        arena reference
+ * @param preprocessor preprocessor reference
+ * @param profile      timeline of the unit (may be mirac_null)
  * 
  * @return mirac_parser_s
  */
 mirac_parser_s mirac_parser_from_parts(
 	mirac_config_s* const config,
 	mirac_arena_s* const arena,
-	mirac_lexer_s* const lexer);
+	mirac_preprocessor_s* const preprocessor,
+	mirac_profiler_unit_s* const profile);
 
 // todo: write unit tests!
 /**
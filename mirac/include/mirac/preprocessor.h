@@ -0,0 +1,259 @@
+/**
+ * @file preprocessor.h
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-03-02
+ */
+
+#ifndef __mirac__include__mirac__preprocessor_h__
+#define __mirac__include__mirac__preprocessor_h__
+
+#include <mirac/c_common.h>
+#include <mirac/heap_array.h>
+#include <mirac/symbol_table.h>
+#include <mirac/string_view.h>
+#include <mirac/config.h>
+#include <mirac/arena.h>
+#include <mirac/interner.h>
+#include <mirac/lexer.h>
+
+#include <pthread.h>
+
+/**
+ * @brief Maximum number of nested includes.
+ */
+#define mirac_preprocessor_max_include_depth 200
+
+/**
+ * @brief Stamp of a file, which changes whenever the file is modified.
+ */
+typedef struct
+{
+	uint64_t size;
+	uint64_t modification_time; // note: in nanoseconds since the epoch.
+} mirac_preprocessor_file_stamp_s;
+
+// todo: write unit tests!
+/**
+ * @brief Get the current stamp of the file at the path.
+ * 
+ * @param path  path of the file
+ * @param stamp stamp to fill
+ * 
+ * @return bool_t
+ */
+bool_t mirac_preprocessor_file_stamp_from_path(
+	const char_t* const path,
+	mirac_preprocessor_file_stamp_s* const stamp);
+
+/**
+ * @brief Check if two stamps are equal.
+ * 
+ * @param left  left stamp
+ * @param right right stamp
+ * 
+ * @return bool_t
+ */
+bool_t mirac_preprocessor_file_stamp_equal(
+	const mirac_preprocessor_file_stamp_s left,
+	const mirac_preprocessor_file_stamp_s right);
+
+/**
+ * @brief Lexed included file, shared by all the preprocessors of the process.
+ * 
+ * The tokens include the directive tokens and exclude the end of file token. Their
+ * identifiers are interned by a private interner, so every preprocessor interns
+ * them again with its own interner when replaying the file.
+ */
+typedef struct
+{
+	mirac_string_view_s path; // note: null terminated.
+	mirac_string_view_s directory;
+	mirac_string_view_s guard; // note: empty if the file has no include guard.
+	mirac_preprocessor_file_stamp_s stamp; // note: taken right before lexing.
+	mirac_token_list_s tokens;
+	mirac_arena_s arena;
+	mirac_lexer_s lexer;
+} mirac_preprocessor_file_s;
+
+mirac_define_symbol_table_type(mirac_preprocessor_file_table, mirac_preprocessor_file_s*);
+mirac_define_heap_array_type(mirac_preprocessor_file_list, const mirac_preprocessor_file_s*);
+
+/**
+ * @brief Process-wide cache of lexed included files.
+ * 
+ * Every included file is lexed at most once per process, no matter how many units
+ * (or threads) include it. Lookups and insertions are guarded by the mutex, while
+ * the lexing itself is done outside of it.
+ */
+typedef struct
+{
+	mirac_arena_s* arena;
+	mirac_interner_s* interner;
+	mirac_preprocessor_file_table_s files;
+	pthread_mutex_t* mutex;
+	uint64_t lexed_files_count;
+	uint64_t reused_files_count;
+} mirac_preprocessor_cache_s;
+
+// todo: write unit tests!
+/**
+ * @brief Create preprocessor cache with provided arena.
+ * 
+ * @param arena arena reference (must outlive the cache)
+ * 
+ * @return mirac_preprocessor_cache_s
+ */
+mirac_preprocessor_cache_s mirac_preprocessor_cache_from_parts(
+	mirac_arena_s* const arena);
+
+// todo: write unit tests!
+/**
+ * @brief Destroy preprocessor cache and all of its cached files.
+ * 
+ * @warning Tokens produced from the cached files must not be used after the cache
+ * is destroyed.
+ * 
+ * @param cache cache to destroy
+ */
+void mirac_preprocessor_cache_destroy(
+	mirac_preprocessor_cache_s* const cache);
+
+// todo: write unit tests!
+/**
+ * @brief Lex the file into the cache ahead of its first include (if it is not
+ * cached yet).
+ * 
+ * @note Lexing errors are reported the same way as for an included file.
+ * 
+ * @param cache  cache instance
+ * @param config config reference
+ * @param path   canonical path of the file
+ */
+void mirac_preprocessor_cache_preload(
+	mirac_preprocessor_cache_s* const cache,
+	mirac_config_s* const config,
+	const char_t* const path);
+
+// todo: write unit tests!
+/**
+ * @brief Drop the cached files that were modified since they were lexed.
+ * 
+ * @warning Must not be called while any preprocessor uses the cache.
+ * 
+ * @param cache cache instance
+ * 
+ * @return uint64_t
+ */
+uint64_t mirac_preprocessor_cache_drop_changed_files(
+	mirac_preprocessor_cache_s* const cache);
+
+typedef struct
+{
+	mirac_token_list_s tokens;
+	bool_t is_defined;
+	bool_t is_expanding;
+} mirac_preprocessor_macro_s;
+
+mirac_define_symbol_table_type(mirac_preprocessor_macro_table, mirac_preprocessor_macro_s*);
+
+typedef struct
+{
+	mirac_lexer_s* lexer;                      // note: set only for the main file.
+	const mirac_preprocessor_file_s* file;     // note: set only for included files.
+	mirac_preprocessor_macro_s* macro;         // note: set only for macro expansions.
+	const mirac_token_s* tokens;
+	uint64_t tokens_count;
+	uint64_t index;
+	mirac_token_s invocation;                  // note: set only for macro expansions.
+	uint64_t conditions_count;
+} mirac_preprocessor_frame_s;
+
+mirac_define_heap_array_type(mirac_preprocessor_frame_list, mirac_preprocessor_frame_s);
+
+typedef struct
+{
+	mirac_position_s position;
+	bool_t is_parent_active;
+	bool_t is_active;
+	bool_t is_taken;
+	bool_t has_else;
+} mirac_preprocessor_condition_s;
+
+mirac_define_heap_array_type(mirac_preprocessor_condition_list, mirac_preprocessor_condition_s);
+
+/**
+ * @brief Token level preprocessor.
+ * 
+ * Supports the '#include', '#define', '#undef', '#ifdef', '#ifndef', '#else', and
+ * '#endif' directives. Macros are object-like: a defined identifier is replaced by
+ * the tokens of its definition, located at the identifier.
+ * 
+ * Every file included by the unit is recorded once in the included files, in the
+ * order it was first included.
+ */
+typedef struct
+{
+	mirac_config_s* config;
+	mirac_arena_s* arena;
+	mirac_interner_s* interner;
+	mirac_preprocessor_cache_s* cache;
+	mirac_string_view_s directory;
+	mirac_preprocessor_macro_table_s macros;
+	mirac_preprocessor_frame_list_s frames;
+	mirac_preprocessor_condition_list_s conditions;
+	mirac_preprocessor_file_list_s included_files;
+	mirac_token_s token;
+	mirac_token_s eof_token;
+} mirac_preprocessor_s;
+
+// todo: write unit tests!
+/**
+ * @brief Create preprocessor over the main file's lexer.
+ * 
+ * @param config config reference
+ * @param arena  arena reference
+ * @param cache  cache reference for included files
+ * @param lexer  lexer of the main file
+ * 
+ * @return mirac_preprocessor_s
+ */
+mirac_preprocessor_s mirac_preprocessor_from_parts(
+	mirac_config_s* const config,
+	mirac_arena_s* const arena,
+	mirac_preprocessor_cache_s* const cache,
+	mirac_lexer_s* const lexer);
+
+// todo: write unit tests!
+/**
+ * @brief Preprocess next token.
+ * 
+ * Same contract as @ref mirac_lexer_lex_next(), except that directive tokens are
+ * never returned and that the tokens' identifiers are interned by the main file's
+ * lexer's interner.
+ * 
+ * @param preprocessor preprocessor instance
+ * @param token        token to be preprocessed
+ * 
+ * @return mirac_token_type_e
+ */
+mirac_token_type_e mirac_preprocessor_lex_next(
+	mirac_preprocessor_s* const preprocessor,
+	mirac_token_s* const token);
+
+// todo: write unit tests!
+/**
+ * @brief Cache a token in the preprocessor.
+ * 
+ * @param preprocessor preprocessor instance
+ * @param token        token to cache
+ */
+void mirac_preprocessor_unlex(
+	mirac_preprocessor_s* const preprocessor,
+	mirac_token_s* const token);
+
+#endif
@@ -0,0 +1,205 @@
+/**
+ * @file profiler.h
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-03-23
+ */
+
+#ifndef __mirac__include__mirac__profiler_h__
+#define __mirac__include__mirac__profiler_h__
+
+#include <mirac/c_common.h>
+#include <mirac/heap_array.h>
+#include <mirac/string_view.h>
+#include <mirac/arena.h>
+
+#include <pthread.h>
+#include <time.h>
+
+typedef enum
+{
+	mirac_profiler_phase_lex = 0,
+	mirac_profiler_phase_parse,
+	mirac_profiler_phase_resolve,
+	mirac_profiler_phase_codegen,
+	mirac_profiler_phase_write,
+	mirac_profiler_phases_count,
+
+	mirac_profiler_phase_none
+} mirac_profiler_phase_e;
+
+mirac_string_view_s mirac_profiler_phase_to_string_view(
+	const mirac_profiler_phase_e phase);
+
+/**
+ * @brief Complete event ('X' phase) of the trace.
+ */
+typedef struct
+{
+	mirac_string_view_s name;
+	const char_t* category;
+	uint64_t begin_time;
+	uint64_t end_time;
+	uint64_t thread_id;
+} mirac_profiler_span_s;
+
+mirac_define_heap_array_type(mirac_profiler_span_list, mirac_profiler_span_s);
+
+/**
+ * @brief Profiler of a compilation (shared by all of its units and threads).
+ * 
+ * Collects the wall and cpu times of the phases of all the units, and the spans
+ * of the trace (if one was requested), which are only written out once the
+ * compilation is done.
+ */
+typedef struct
+{
+	mirac_arena_s* arena;
+	clockid_t cpu_clock;
+	pthread_mutex_t* mutex;
+	bool_t is_tracing;
+	mirac_profiler_span_list_s spans;
+	uint64_t begin_time;
+	uint64_t begin_cpu_time;
+	uint64_t wall_times[mirac_profiler_phases_count];
+	uint64_t cpu_times[mirac_profiler_phases_count];
+	uint64_t units_count;
+} mirac_profiler_s;
+
+/**
+ * @brief Phase timeline of a single unit.
+ * 
+ * The lex, parse, and resolve phases are interleaved (the parser pulls the
+ * tokens and resolves identifiers as it goes), so switching in between them
+ * only reads the monotonic clock, and the cpu time spent in them is split by
+ * their wall times once the unit leaves them.
+ */
+typedef struct
+{
+	mirac_profiler_s* profiler;
+	mirac_string_view_s name;
+	mirac_profiler_phase_e phase;
+	uint64_t begin_time;
+	uint64_t phase_time;
+	uint64_t cpu_time;
+	uint64_t segment_wall_times[mirac_profiler_phases_count];
+	uint64_t wall_times[mirac_profiler_phases_count];
+	uint64_t cpu_times[mirac_profiler_phases_count];
+} mirac_profiler_unit_s;
+
+// todo: write unit tests!
+/**
+ * @brief Create profiler with provided arena.
+ * 
+ * @note If the units are compiled in parallel, each unit's cpu time is the time
+ * of the thread compiling it, otherwise it is the time of the whole process (so
+ * that it covers the parallel code generation of the unit's defs).
+ * 
+ * @param arena              arena reference (used under the profiler's lock)
+ * @param is_tracing         whether the spans of the trace are recorded
+ * @param are_units_parallel whether the units are compiled in parallel
+ * 
+ * @return mirac_profiler_s
+ */
+mirac_profiler_s mirac_profiler_from_parts(
+	mirac_arena_s* const arena,
+	const bool_t is_tracing,
+	const bool_t are_units_parallel);
+
+// todo: write unit tests!
+/**
+ * @brief Destroy profiler.
+ * 
+ * @param profiler profiler to destroy
+ */
+void mirac_profiler_destroy(
+	mirac_profiler_s* const profiler);
+
+/**
+ * @brief Read the monotonic clock (in nanoseconds).
+ * 
+ * @return uint64_t
+ */
+uint64_t mirac_profiler_now(
+	void);
+
+// todo: write unit tests!
+/**
+ * @brief Record a span of the trace, which began at the provided time and ends
+ * now, on the calling thread (does nothing if the profiler is not tracing).
+ * 
+ * @param profiler   profiler instance
+ * @param category   category of the span
+ * @param name       name of the span (copied)
+ * @param begin_time monotonic time the span began at
+ */
+void mirac_profiler_record_span(
+	mirac_profiler_s* const profiler,
+	const char_t* const category,
+	const mirac_string_view_s name,
+	const uint64_t begin_time);
+
+// todo: write unit tests!
+/**
+ * @brief Print the wall and cpu times of the phases of all the units.
+ * 
+ * @param profiler profiler instance
+ */
+void mirac_profiler_print_report(
+	mirac_profiler_s* const profiler);
+
+// todo: write unit tests!
+/**
+ * @brief Write the recorded spans into the file as chrome trace event json.
+ * 
+ * @param profiler profiler instance
+ * @param path     path of the trace file
+ * 
+ * @return bool_t
+ */
+bool_t mirac_profiler_write_trace(
+	mirac_profiler_s* const profiler,
+	const mirac_string_view_s path);
+
+// todo: write unit tests!
+/**
+ * @brief Begin the timeline of a unit in the lex phase.
+ * 
+ * @param profiler profiler instance
+ * @param name     name of the unit (must outlive the timeline)
+ * 
+ * @return mirac_profiler_unit_s
+ */
+mirac_profiler_unit_s mirac_profiler_unit_begin(
+	mirac_profiler_s* const profiler,
+	const mirac_string_view_s name);
+
+// todo: write unit tests!
+/**
+ * @brief Switch the unit into the phase (mirac_profiler_phase_none stops the
+ * clock until the next switch).
+ * 
+ * @param unit  unit timeline
+ * @param phase phase to switch into
+ * 
+ * @return mirac_profiler_phase_e the phase the unit was in
+ */
+mirac_profiler_phase_e mirac_profiler_unit_switch_phase(
+	mirac_profiler_unit_s* const unit,
+	const mirac_profiler_phase_e phase);
+
+// todo: write unit tests!
+/**
+ * @brief End the timeline of a unit, and add its times (and span) to the
+ * profiler.
+ * 
+ * @param unit unit timeline
+ */
+void mirac_profiler_unit_end(
+	mirac_profiler_unit_s* const unit);
+
+#endif
@@ -0,0 +1,222 @@
+/**
+ * @file server.h
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-03-16
+ */
+
+#ifndef __mirac__include__mirac__server_h__
+#define __mirac__include__mirac__server_h__
+
+#include <mirac/c_common.h>
+#include <mirac/symbol_table.h>
+#include <mirac/string_view.h>
+#include <mirac/config.h>
+#include <mirac/arena.h>
+#include <mirac/interner.h>
+#include <mirac/preprocessor.h>
+#include <mirac/cache.h>
+
+#include <pthread.h>
+
+/**
+ * @brief Environment variable with the socket path of the server to forward the
+ * compilations to.
+ */
+#define mirac_server_socket_environment_variable "MIRAC_SERVER"
+
+/**
+ * @brief Interval in between two checks of the watched files (in milliseconds).
+ */
+#define mirac_server_watch_interval 200
+
+typedef struct mirac_server_s mirac_server_s;
+
+/**
+ * @brief Compile function of a server.
+ * 
+ * Runs in the process of a request, with the request's config and src+out file
+ * paths, and returns the exit code of the request.
+ * 
+ * @param server             server instance
+ * @param config             config of the request
+ * @param source_files       src+out file paths of the request
+ * @param source_files_count number of src+out file paths
+ */
+typedef int32_t (*mirac_server_compile_t)(
+	mirac_server_s* const server,
+	mirac_config_s* const config,
+	const char_t** const source_files,
+	const uint64_t source_files_count);
+
+/**
+ * @brief Included file of a compiled unit along with its stamp at the time it
+ * was lexed.
+ */
+typedef struct
+{
+	mirac_symbol_t path;
+	mirac_preprocessor_file_stamp_s stamp;
+} mirac_server_input_s;
+
+/**
+ * @brief Record of the last successful compilation of a unit.
+ */
+typedef struct
+{
+	mirac_cache_key_s key;
+	mirac_preprocessor_file_stamp_s output_stamp;
+	const mirac_server_input_s* inputs;
+	uint64_t inputs_count;
+} mirac_server_unit_s;
+
+mirac_define_symbol_table_type(mirac_server_unit_table, mirac_server_unit_s*);
+
+/**
+ * @brief Compile server.
+ * 
+ * Every request runs in a child process forked off the server, so it starts with
+ * the server's lexed included files and unit records without copying them, and
+ * its failure (or crash) never takes the server down. Once a request is done,
+ * the server takes over the records of the units it compiled and lexes their
+ * included files, so later requests start warm.
+ * 
+ * A unit is recompiled only if its source, its options, any of its included files,
+ * or its output changed since it was last compiled by the server.
+ */
+struct mirac_server_s
+{
+	mirac_config_s* config;
+	mirac_arena_s* arena;
+	mirac_interner_s* interner;
+	mirac_preprocessor_cache_s* preprocessor_cache;
+	mirac_server_compile_t compile;
+	mirac_server_unit_table_s units;
+	pthread_mutex_t* mutex;
+	int32_t report_descriptor; // note: set only in the process of a request.
+	uint64_t requests_count;
+	uint64_t compiled_units_count;
+};
+
+// todo: write unit tests!
+/**
+ * @brief Create server with provided arena.
+ * 
+ * @param config             config of the server process
+ * @param arena              arena reference (must outlive the server)
+ * @param preprocessor_cache preprocessor cache reference
+ * @param compile            compile function of the requests
+ * 
+ * @return mirac_server_s
+ */
+mirac_server_s mirac_server_from_parts(
+	mirac_config_s* const config,
+	mirac_arena_s* const arena,
+	mirac_preprocessor_cache_s* const preprocessor_cache,
+	const mirac_server_compile_t compile);
+
+// todo: write unit tests!
+/**
+ * @brief Destroy server.
+ * 
+ * @param server server to destroy
+ */
+void mirac_server_destroy(
+	mirac_server_s* const server);
+
+// todo: write unit tests!
+/**
+ * @brief Serve the compile requests of the clients on the unix socket until the
+ * server is interrupted or terminated.
+ * 
+ * @note Up to the config's jobs count requests are compiled at once.
+ * 
+ * @param server      server instance
+ * @param socket_path path of the unix socket to listen on
+ * 
+ * @return int32_t
+ */
+int32_t mirac_server_serve(
+	mirac_server_s* const server,
+	const mirac_string_view_s socket_path);
+
+// todo: write unit tests!
+/**
+ * @brief Compile the command line and compile it again whenever any input or
+ * output of its src+out pairs changes, until the server is interrupted or
+ * terminated.
+ * 
+ * @param server             server instance
+ * @param argc               command line arguments count
+ * @param argv               command line arguments pointer
+ * @param source_files       src+out file paths of the command line
+ * @param source_files_count number of src+out file paths
+ * 
+ * @return int32_t
+ */
+int32_t mirac_server_watch(
+	mirac_server_s* const server,
+	const int32_t argc,
+	const char_t** const argv,
+	const char_t** const source_files,
+	const uint64_t source_files_count);
+
+// todo: write unit tests!
+/**
+ * @brief Forward the command line to the server on the unix socket, which then
+ * writes its diagnostics into this process's stdout and stderr.
+ * 
+ * @note Returns false (without printing anything) if no server is listening on
+ * the socket, so that the caller can compile by itself instead.
+ * 
+ * @param socket_path path of the unix socket of the server
+ * @param argc        command line arguments count
+ * @param argv        command line arguments pointer
+ * @param exit_code   exit code of the request
+ * 
+ * @return bool_t
+ */
+bool_t mirac_server_forward(
+	const mirac_string_view_s socket_path,
+	const int32_t argc,
+	const char_t** const argv,
+	int32_t* const exit_code);
+
+// todo: write unit tests!
+/**
+ * @brief Check if the unit was compiled by the server and nothing it depends on
+ * changed since.
+ * 
+ * @param server           server instance
+ * @param key              key of the unit
+ * @param output_file_path path of the unit's output file
+ * 
+ * @return bool_t
+ */
+bool_t mirac_server_is_unit_up_to_date(
+	mirac_server_s* const server,
+	const mirac_cache_key_s* const key,
+	const mirac_string_view_s output_file_path);
+
+// todo: write unit tests!
+/**
+ * @brief Report the successful compilation of the unit to the server.
+ * 
+ * @note Must be called after the output file was closed.
+ * 
+ * @param server           server instance
+ * @param key              key of the unit
+ * @param output_file_path path of the unit's output file
+ * @param preprocessor     preprocessor of the unit
+ */
+void mirac_server_record_unit(
+	mirac_server_s* const server,
+	const mirac_cache_key_s* const key,
+	const mirac_string_view_s output_file_path,
+	const mirac_preprocessor_s* const preprocessor);
+
+#endif
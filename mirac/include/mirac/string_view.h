@@ -89,6 +89,16 @@ bool_t mirac_string_view_equal(
 	const mirac_string_view_s left,
 	const mirac_string_view_s right);
 
+/**
+ * @brief Compute 64 bit FNV-1a hash of the string view's characters.
+ * 
+ * @param string_view string view to hash
+ * 
+ * @return uint64_t
+ */
+uint64_t mirac_string_view_hash(
+	const mirac_string_view_s string_view);
+
 /**
  * @brief Trim left side of the string view of provided char.
  * 
@@ -173,4 +183,69 @@ mirac_string_view_s mirac_string_view_split_left_white_space(
 	mirac_string_view_s* const string_view,
 	uint64_t* const white_space_length);
 
+/**
+ * @brief Implementations of the string view scanning primitives.
+ * 
+ * The best one supported by the cpu is selected at startup, and the rest are
+ * kept for testing and comparison purposes.
+ */
+typedef enum
+{
+	mirac_string_view_scanner_scalar = 0,
+	mirac_string_view_scanner_sse2,
+	mirac_string_view_scanner_avx2,
+	mirac_string_view_scanner_count
+} mirac_string_view_scanner_e;
+
+/**
+ * @brief Select the implementation of the string view scanning primitives.
+ * 
+ * @param scanner scanner to select
+ * 
+ * @return bool_t (false if the scanner is not supported by the cpu)
+ */
+bool_t mirac_string_view_use_scanner(
+	const mirac_string_view_scanner_e scanner);
+
+/**
+ * @brief Get the currently selected implementation of the string view scanning
+ * primitives.
+ * 
+ * @return mirac_string_view_scanner_e
+ */
+mirac_string_view_scanner_e mirac_string_view_get_scanner(
+	void);
+
+/**
+ * @brief Find the index of the first occurrence of the provided char.
+ * 
+ * @param string_view  string view to search in
+ * @param char_to_find  char to find
+ * 
+ * @return uint64_t (length of the string view if the char is not found)
+ */
+uint64_t mirac_string_view_find_char(
+	const mirac_string_view_s string_view,
+	const char_t char_to_find);
+
+/**
+ * @brief Find the index of the first white space char.
+ * 
+ * @param string_view string view to search in
+ * 
+ * @return uint64_t (length of the string view if there is no white space)
+ */
+uint64_t mirac_string_view_find_white_space(
+	const mirac_string_view_s string_view);
+
+/**
+ * @brief Find the index of the first non white space char.
+ * 
+ * @param string_view string view to search in
+ * 
+ * @return uint64_t (length of the string view if there is only white space)
+ */
+uint64_t mirac_string_view_find_non_white_space(
+	const mirac_string_view_s string_view);
+
 #endif
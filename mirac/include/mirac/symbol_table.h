@@ -0,0 +1,181 @@
+/**
+ * @file symbol_table.h
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-01-22
+ */
+
+#ifndef __mirac__include__mirac__symbol_table_h__
+#define __mirac__include__mirac__symbol_table_h__
+
+#include <mirac/c_common.h>
+#include <mirac/debug.h>
+#include <mirac/arena.h>
+#include <mirac/interner.h>
+
+/**
+ * @brief Capacity of a symbol table after its first growth.
+ */
+#define mirac_symbol_table_min_capacity 64
+
+// todo: write unit tests!
+
+// note: symbol tables are open addressing hash tables with linear probing, keyed
+//       by interned string handles and hashed with the hashes cached by the
+//       interner. The slots are kept at most half full.
+
+#define mirac_define_symbol_table_type(_type_name, _value_type)                \
+	typedef struct                                                             \
+	{                                                                          \
+		mirac_symbol_t symbol;                                                 \
+		_value_type value;                                                     \
+	} _type_name ## _slot_s;                                                   \
+	                                                                           \
+	typedef struct                                                             \
+	{                                                                          \
+		mirac_arena_s* arena;                                                  \
+		const mirac_interner_s* interner;                                      \
+		_type_name ## _slot_s* slots;                                          \
+		uint64_t capacity;                                                     \
+		uint64_t count;                                                        \
+	} _type_name ## _s;                                                        \
+	                                                                           \
+	_type_name ## _s _type_name ## _from_parts(                                \
+		mirac_arena_s* const arena,                                            \
+		const mirac_interner_s* const interner);                               \
+	                                                                           \
+	bool_t _type_name ## _insert(                                              \
+		_type_name ## _s* const symbol_table,                                  \
+		const mirac_symbol_t symbol,                                           \
+		_value_type value);                                                    \
+	                                                                           \
+	bool_t _type_name ## _find(                                                \
+		const _type_name ## _s* const symbol_table,                            \
+		const mirac_symbol_t symbol,                                           \
+		_value_type* const value);                                             \
+	                                                                           \
+	_Static_assert(1, "") // note: left for ';' support after calling the macro.
+
+#define mirac_implement_symbol_table_type(_type_name, _value_type)             \
+	static void _type_name ## _grow(                                           \
+		_type_name ## _s* const symbol_table)                                  \
+	{                                                                          \
+		mirac_debug_assert(symbol_table != mirac_null);                        \
+		                                                                       \
+		const uint64_t capacity = symbol_table->capacity > 0 ?                 \
+			symbol_table->capacity * 2 : mirac_symbol_table_min_capacity;      \
+		const uint64_t mask = capacity - 1;                                    \
+		                                                                       \
+		_type_name ## _slot_s* const slots = (_type_name ## _slot_s*)          \
+			mirac_arena_malloc_as(symbol_table->arena,                         \
+				capacity * sizeof(_type_name ## _slot_s),                      \
+				mirac_arena_site_tables);                                      \
+		mirac_c_memset(slots, 0, capacity * sizeof(_type_name ## _slot_s));    \
+		                                                                       \
+		for (uint64_t index = 0; index < symbol_table->capacity; ++index)      \
+		{                                                                      \
+			const _type_name ## _slot_s slot = symbol_table->slots[index];     \
+			                                                                   \
+			if (mirac_symbol_none == slot.symbol)                              \
+			{                                                                  \
+				continue;                                                      \
+			}                                                                  \
+			                                                                   \
+			uint64_t slot_index = mirac_interner_get_hash(                     \
+				symbol_table->interner, slot.symbol) & mask;                   \
+			                                                                   \
+			while (slots[slot_index].symbol != mirac_symbol_none)              \
+			{                                                                  \
+				slot_index = (slot_index + 1) & mask;                          \
+			}                                                                  \
+			                                                                   \
+			slots[slot_index] = slot;                                          \
+		}                                                                      \
+		                                                                       \
+		symbol_table->slots = slots;                                           \
+		symbol_table->capacity = capacity;                                     \
+	}                                                                          \
+	                                                                           \
+	_type_name ## _s _type_name ## _from_parts(                                \
+		mirac_arena_s* const arena,                                            \
+		const mirac_interner_s* const interner)                                \
+	{                                                                          \
+		mirac_debug_assert(arena != mirac_null);                               \
+		mirac_debug_assert(interner != mirac_null);                            \
+		                                                                       \
+		_type_name ## _s symbol_table = {0};                                   \
+		symbol_table.arena = arena;                                            \
+		symbol_table.interner = interner;                                      \
+		return symbol_table;                                                   \
+	}                                                                          \
+	                                                                           \
+	bool_t _type_name ## _insert(                                              \
+		_type_name ## _s* const symbol_table,                                  \
+		const mirac_symbol_t symbol,                                           \
+		_value_type value)                                                     \
+	{                                                                          \
+		mirac_debug_assert(symbol_table != mirac_null);                        \
+		mirac_debug_assert(symbol != mirac_symbol_none);                       \
+		                                                                       \
+		if (((symbol_table->count + 1) * 2) > symbol_table->capacity)          \
+		{                                                                      \
+			_type_name ## _grow(symbol_table);                                 \
+		}                                                                      \
+		                                                                       \
+		const uint64_t mask = symbol_table->capacity - 1;                      \
+		uint64_t slot_index = mirac_interner_get_hash(                         \
+			symbol_table->interner, symbol) & mask;                            \
+		                                                                       \
+		while (symbol_table->slots[slot_index].symbol != mirac_symbol_none)    \
+		{                                                                      \
+			if (symbol == symbol_table->slots[slot_index].symbol)              \
+			{                                                                  \
+				return false;                                                  \
+			}                                                                  \
+			                                                                   \
+			slot_index = (slot_index + 1) & mask;                              \
+		}                                                                      \
+		                                                                       \
+		symbol_table->slots[slot_index].symbol = symbol;                       \
+		symbol_table->slots[slot_index].value = value;                         \
+		++symbol_table->count;                                                 \
+		return true;                                                           \
+	}                                                                          \
+	                                                                           \
+	bool_t _type_name ## _find(                                                \
+		const _type_name ## _s* const symbol_table,                            \
+		const mirac_symbol_t symbol,                                           \
+		_value_type* const value)                                              \
+	{                                                                          \
+		mirac_debug_assert(symbol_table != mirac_null);                        \
+		                                                                       \
+		if ((symbol_table->count <= 0) || (mirac_symbol_none == symbol))       \
+		{                                                                      \
+			return false;                                                      \
+		}                                                                      \
+		                                                                       \
+		const uint64_t mask = symbol_table->capacity - 1;                      \
+		uint64_t slot_index = mirac_interner_get_hash(                         \
+			symbol_table->interner, symbol) & mask;                            \
+		                                                                       \
+		while (symbol_table->slots[slot_index].symbol != mirac_symbol_none)    \
+		{                                                                      \
+			if (symbol == symbol_table->slots[slot_index].symbol)              \
+			{                                                                  \
+				*value = symbol_table->slots[slot_index].value;                \
+				return true;                                                   \
+			}                                                                  \
+			                                                                   \
+			slot_index = (slot_index + 1) & mask;                              \
+		}                                                                      \
+		                                                                       \
+		return false;                                                          \
+	}                                                                          \
+	                                                                           \
+	_Static_assert(1, "") // note: left for ';' support after calling the macro.
+
+#endif
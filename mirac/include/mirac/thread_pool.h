@@ -0,0 +1,96 @@
+/**
+ * @file thread_pool.h
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-01-25
+ */
+
+#ifndef __mirac__include__mirac__thread_pool_h__
+#define __mirac__include__mirac__thread_pool_h__
+
+#include <mirac/c_common.h>
+
+#include <pthread.h>
+
+/**
+ * @brief Upper limit of the workers count of a thread pool.
+ */
+#define mirac_thread_pool_max_workers_count 256
+
+/**
+ * @brief Job function of a thread pool.
+ * 
+ * @param context      context provided to the run
+ * @param job_index    index of the job to run (in range [0, jobs count))
+ * @param worker_index index of the worker running the job (in range
+ *                     [0, workers count)), which can be used to address
+ *                     per-worker state without any locking
+ */
+typedef void (*mirac_thread_pool_job_t)(
+	void* const context,
+	const uint64_t job_index,
+	const uint64_t worker_index);
+
+typedef struct mirac_thread_pool_shared_s mirac_thread_pool_shared_s;
+
+/**
+ * @brief Work-stealing thread pool structure.
+ * 
+ * Worker 0 is the thread calling the run, the other workers are threads that
+ * are started once and sleep in between runs.
+ */
+typedef struct
+{
+	uint64_t workers_count;
+	pthread_t* threads;
+	mirac_thread_pool_shared_s* shared;
+} mirac_thread_pool_s;
+
+// todo: write unit tests!
+/**
+ * @brief Create thread pool with the provided number of workers.
+ * 
+ * @param workers_count number of workers (including the calling thread)
+ * 
+ * @return mirac_thread_pool_s
+ */
+mirac_thread_pool_s mirac_thread_pool_from_parts(
+	const uint64_t workers_count);
+
+// todo: write unit tests!
+/**
+ * @brief Stop the workers and destroy the thread pool.
+ * 
+ * @param pool thread pool to destroy
+ */
+void mirac_thread_pool_destroy(
+	mirac_thread_pool_s* const pool);
+
+// todo: write unit tests!
+/**
+ * @brief Run the job for every index in range [0, jobs count) on the workers
+ * and wait until all of them are done.
+ * 
+ * @note Every worker starts with its own contiguous range of the jobs and runs
+ * them in increasing order. Once its range runs out, the worker steals the
+ * upper half of what is left of another worker's range.
+ * 
+ * @warning The jobs count must not exceed UINT32_MAX, and a job must not start
+ * another run on the same pool.
+ * 
+ * @param pool       thread pool instance
+ * @param jobs_count number of jobs to run
+ * @param job        job function
+ * @param context    context to provide to the job function
+ */
+void mirac_thread_pool_run(
+	mirac_thread_pool_s* const pool,
+	const uint64_t jobs_count,
+	const mirac_thread_pool_job_t job,
+	void* const context);
+
+#endif
@@ -17,16 +17,32 @@ SOURCES="
 	$PROJECT_DIR/source/mirac/logger.c
 	$PROJECT_DIR/source/mirac/c_common.c
 	$PROJECT_DIR/source/mirac/string_view.c
+	$PROJECT_DIR/source/mirac/file_table.c
 	$PROJECT_DIR/source/mirac/arena.c
+	$PROJECT_DIR/source/mirac/thread_pool.c
+	$PROJECT_DIR/source/mirac/profiler.c
+	$PROJECT_DIR/source/mirac/interner.c
 	$PROJECT_DIR/source/mirac/config.c
 	$PROJECT_DIR/source/mirac/lexer.c
+	$PROJECT_DIR/source/mirac/preprocessor.c
+	$PROJECT_DIR/source/mirac/cache.c
+	$PROJECT_DIR/source/mirac/server.c
 	$PROJECT_DIR/source/mirac/parser.c
+	$PROJECT_DIR/source/mirac/folder.c
+	$PROJECT_DIR/source/mirac/emitter.c
 	$PROJECT_DIR/source/mirac/compiler.c
 	$PROJECT_DIR/source/mirac/archs/nasm_x86_64_linux.c
+	$PROJECT_DIR/source/mirac/archs/x86_64_encoder.c
+	$PROJECT_DIR/source/mirac/archs/x86_64_instruction.c
+	$PROJECT_DIR/source/mirac/archs/x86_64_peephole.c
+	$PROJECT_DIR/source/mirac/archs/x86_64_linux_lowering.c
+	$PROJECT_DIR/source/mirac/archs/elf64_object.c
+	$PROJECT_DIR/source/mirac/archs/elf_x86_64_linux.c
 	$PROJECT_DIR/source/main.c
 "
 
 LIBRARIES="
+	-lpthread
 "
 
 # --------------------------------------------------------------------------- #
@@ -16,11 +16,19 @@
 #include <mirac/logger.h>
 #include <mirac/config.h>
 #include <mirac/arena.h>
+#include <mirac/interner.h>
 #include <mirac/lexer.h>
+#include <mirac/preprocessor.h>
 #include <mirac/parser.h>
+#include <mirac/folder.h>
+#include <mirac/cache.h>
+#include <mirac/server.h>
 #include <mirac/compiler.h>
+#include <mirac/thread_pool.h>
+#include <mirac/profiler.h>
 
 #include <sys/stat.h>
+#include <stdlib.h>
 #include <errno.h>
 
 /**
@@ -43,12 +51,130 @@ static mirac_file_t* validate_and_open_file_for_reading(
 static mirac_file_t* validate_and_open_file_for_writing(
 	const mirac_string_view_s file_path);
 
+/**
+ * @brief Check that the src+out file paths form pairs, and print the usage if
+ * they do not.
+ * 
+ * @param source_files       src+out file paths
+ * @param source_files_count number of src+out file paths
+ * 
+ * @return bool_t
+ */
+static bool_t validate_source_files(
+	const char_t** const source_files,
+	const uint64_t source_files_count);
+
+/**
+ * @brief Compile the src+out pairs (the compile function of the server as well).
+ * 
+ * @param server             server of the request (mirac_null outside of one)
+ * @param config             config reference
+ * @param source_files       src+out file paths
+ * @param source_files_count number of src+out file paths
+ * 
+ * @return int32_t
+ */
+static int32_t compile_source_files(
+	mirac_server_s* const server,
+	mirac_config_s* const config,
+	const char_t** const source_files,
+	const uint64_t source_files_count);
+
+/**
+ * @brief Switch the unit's timeline into the phase (if the unit is profiled).
+ * 
+ * @param profile timeline of the unit (may be mirac_null)
+ * @param phase   phase to switch into
+ */
+static void switch_phase(
+	mirac_profiler_unit_s* const profile,
+	const mirac_profiler_phase_e phase);
+
+/**
+ * @brief End the timeline of the unit (if the unit is profiled) and print the
+ * memory of the unit (if it is accounted).
+ * 
+ * @param source_file_path path of the unit's source file
+ * @param arena            arena of the unit
+ * @param profile          timeline of the unit (may be mirac_null)
+ * @param memory_stats     memory stats of the unit (may be mirac_null)
+ */
+static void finish_unit(
+	const mirac_string_view_s source_file_path,
+	mirac_arena_s* const arena,
+	mirac_profiler_unit_s* const profile,
+	const mirac_arena_stats_s* const memory_stats);
+
 // todo: document!
 // todo: write unit tests!
 static void process_source_file_into_output_file(
 	const mirac_string_view_s source_file_path,
 	const mirac_string_view_s output_file_path,
-	mirac_config_s* const config);
+	mirac_config_s* const config,
+	mirac_arena_s* const arena,
+	mirac_preprocessor_cache_s* const preprocessor_cache,
+	mirac_cache_s* const cache,
+	mirac_server_s* const server,
+	mirac_profiler_s* const profiler,
+	mirac_thread_pool_s* const pool);
+
+/**
+ * @brief State shared by the compile jobs of a parallel compilation.
+ * 
+ * @note The config is only read by the jobs and the caches guard themselves,
+ * every other array has a slot per worker (arenas) or per src+out pair
+ * (captures, has_failed), so that the jobs never write into the same memory.
+ */
+typedef struct
+{
+	mirac_config_s* config;
+	mirac_preprocessor_cache_s* preprocessor_cache;
+	mirac_cache_s* cache;
+	mirac_server_s* server;
+	mirac_profiler_s* profiler;
+	const char_t** source_files;
+	mirac_arena_s* arenas;
+	mirac_logger_capture_s* captures;
+	bool_t* has_failed;
+} compile_context_s;
+
+/**
+ * @brief Compile one src+out pair on a worker of the thread pool.
+ * 
+ * The diagnostics of the pair are captured instead of being printed, and a
+ * failure only ends the pair instead of the whole process.
+ * 
+ * @param context      compile context (compile_context_s*)
+ * @param job_index    index of the src+out pair
+ * @param worker_index index of the worker
+ */
+static void compile_job(
+	void* const context,
+	const uint64_t job_index,
+	const uint64_t worker_index);
+
+/**
+ * @brief Compile the src+out pairs on a thread pool and print their diagnostics
+ * afterwards, pair by pair, in the order the pairs were provided.
+ * 
+ * @param config             config reference
+ * @param preprocessor_cache preprocessor cache reference
+ * @param cache              compilation cache reference (may be mirac_null)
+ * @param server             server of the request (may be mirac_null)
+ * @param profiler           profiler of the compilation (may be mirac_null)
+ * @param source_files       src+out file paths
+ * @param pairs_count        number of src+out pairs
+ * 
+ * @return int32_t
+ */
+static int32_t compile_in_parallel(
+	mirac_config_s* const config,
+	mirac_preprocessor_cache_s* const preprocessor_cache,
+	mirac_cache_s* const cache,
+	mirac_server_s* const server,
+	mirac_profiler_s* const profiler,
+	const char_t** const source_files,
+	const uint64_t pairs_count);
 
 int32_t main(
 	const int32_t argc,
@@ -64,35 +190,176 @@ int32_t main(
 	mirac_debug_assert(source_files != mirac_null);
 	const uint64_t source_files_count = (uint64_t)argc - options_index;
 
+	const bool_t is_serving = config.socket_path.length > 0;
+
+	if (!is_serving && !validate_source_files(source_files, source_files_count))
+	{
+		return -1;
+	}
+
+	if (!is_serving && !config.watch)
+	{
+		// note: without a server listening on the socket, the compilation falls back
+		//       to this process.
+		const char_t* const server_socket_path = getenv(mirac_server_socket_environment_variable);
+		int32_t exit_code = 0;
+
+		if ((server_socket_path != mirac_null) && (server_socket_path[0] != '\0') &&
+			mirac_server_forward(mirac_string_view_from_cstring(server_socket_path), argc, argv, &exit_code))
+		{
+			return exit_code;
+		}
+
+		return compile_source_files(mirac_null, &config, source_files, source_files_count);
+	}
+
+	// note: the server's lexed files and unit records live as long as it does and
+	//       are shared by all of its requests.
+	mirac_arena_s server_arena = mirac_arena_from_parts();
+	mirac_preprocessor_cache_s preprocessor_cache = mirac_preprocessor_cache_from_parts(&server_arena);
+	mirac_server_s server = mirac_server_from_parts(&config, &server_arena, &preprocessor_cache, compile_source_files);
+
+	const int32_t exit_code = is_serving ?
+		mirac_server_serve(&server, config.socket_path) :
+		mirac_server_watch(&server, argc, argv, source_files, source_files_count);
+
+	mirac_server_destroy(&server);
+	mirac_preprocessor_cache_destroy(&preprocessor_cache);
+	mirac_arena_destroy(&server_arena);
+	return exit_code;
+}
+
+static bool_t validate_source_files(
+	const char_t** const source_files,
+	const uint64_t source_files_count)
+{
+	mirac_debug_assert(source_files != mirac_null);
+
 	if (source_files_count <= 0)
 	{
 		mirac_logger_error("no source files were provided.");
 		mirac_config_usage();
-		return -1;
+		return false;
 	}
 
 	if (source_files_count % 2 != 0)
 	{
 		mirac_logger_error("missing output file path for source file '%s'.", source_files[source_files_count - 1]);
 		mirac_config_usage();
+		return false;
+	}
+
+	return true;
+}
+
+static int32_t compile_source_files(
+	mirac_server_s* const server,
+	mirac_config_s* const config,
+	const char_t** const source_files,
+	const uint64_t source_files_count)
+{
+	mirac_debug_assert(config != mirac_null);
+	mirac_debug_assert(source_files != mirac_null);
+
+	if (!validate_source_files(source_files, source_files_count))
+	{
 		return -1;
 	}
 
-	for (uint64_t source_file_index = 0; source_file_index < source_files_count; source_file_index += 2)
+	const uint64_t pairs_count = source_files_count / 2;
+
+	// note: included files are lexed once per process and shared by all the pairs,
+	//       while the server's requests start with the files lexed by the server.
+	mirac_arena_s preprocessor_cache_arena = mirac_arena_from_parts();
+	mirac_preprocessor_cache_s local_preprocessor_cache = {0};
+	mirac_preprocessor_cache_s* preprocessor_cache = mirac_null;
+
+	if (server != mirac_null)
 	{
-		const char_t* const source_file_pointer = source_files[source_file_index + 0];
-		mirac_debug_assert(source_file_pointer != mirac_null);
+		preprocessor_cache = server->preprocessor_cache;
+	}
+	else
+	{
+		local_preprocessor_cache = mirac_preprocessor_cache_from_parts(&preprocessor_cache_arena);
+		preprocessor_cache = &local_preprocessor_cache;
+	}
+
+	const bool_t is_cache_enabled = config->cache_dir.length > 0;
+	mirac_cache_s cache = is_cache_enabled ?
+		mirac_cache_from_parts(config->cache_dir, config->cache_size) : (mirac_cache_s) {0};
+
+	// note: without the time report and the trace, nothing is timed at all.
+	const bool_t are_units_parallel = (config->jobs > 1) && (pairs_count > 1);
+	const bool_t is_tracing = config->trace_path.length > 0;
+	const bool_t is_profiling = config->time_report || is_tracing;
+	mirac_arena_s profiler_arena = mirac_arena_from_parts();
+	mirac_profiler_s profiler = is_profiling ?
+		mirac_profiler_from_parts(&profiler_arena, is_tracing, are_units_parallel) : (mirac_profiler_s) {0};
+	int32_t exit_code = 0;
+
+	if (are_units_parallel)
+	{
+		exit_code = compile_in_parallel(config, preprocessor_cache, is_cache_enabled ? &cache : mirac_null,
+			server, is_profiling ? &profiler : mirac_null, source_files, pairs_count);
+	}
+	else
+	{
+		// note: with a single src+out pair, the jobs are spent on the code
+		//       generation of its defs instead.
+		mirac_arena_s arena = mirac_arena_from_parts();
+		mirac_thread_pool_s pool = mirac_thread_pool_from_parts(config->jobs);
+
+		for (uint64_t source_file_index = 0; source_file_index < source_files_count; source_file_index += 2)
+		{
+			const char_t* const source_file_pointer = source_files[source_file_index + 0];
+			mirac_debug_assert(source_file_pointer != mirac_null);
+
+			const char_t* const output_file_pointer = source_files[source_file_index + 1];
+			mirac_debug_assert(output_file_pointer != mirac_null);
+
+			const mirac_string_view_s source_file_path = mirac_string_view_from_cstring(source_file_pointer);
+			const mirac_string_view_s output_file_path = mirac_string_view_from_cstring(output_file_pointer);
+
+			process_source_file_into_output_file(source_file_path, output_file_path, config, &arena,
+				preprocessor_cache, is_cache_enabled ? &cache : mirac_null, server,
+				is_profiling ? &profiler : mirac_null, &pool);
+			mirac_arena_reset(&arena);
+		}
+
+		mirac_thread_pool_destroy(&pool);
+		mirac_arena_destroy(&arena);
+	}
+
+	if (is_cache_enabled)
+	{
+		mirac_cache_print_statistics(&cache);
+		mirac_cache_destroy(&cache);
+	}
+
+	if (is_profiling)
+	{
+		if (config->time_report)
+		{
+			mirac_profiler_print_report(&profiler);
+		}
+
+		if (is_tracing && !mirac_profiler_write_trace(&profiler, config->trace_path))
+		{
+			exit_code = -1;
+		}
 
-		const char_t* const output_file_pointer = source_files[source_file_index + 1];
-		mirac_debug_assert(output_file_pointer != mirac_null);
+		mirac_profiler_destroy(&profiler);
+	}
 
-		const mirac_string_view_s source_file_path = mirac_string_view_from_cstring(source_file_pointer);
-		const mirac_string_view_s output_file_path = mirac_string_view_from_cstring(output_file_pointer);
+	mirac_arena_destroy(&profiler_arena);
 
-		process_source_file_into_output_file(source_file_path, output_file_path, &config);
+	if (mirac_null == server)
+	{
+		mirac_preprocessor_cache_destroy(&local_preprocessor_cache);
 	}
 
-	return 0;
+	mirac_arena_destroy(&preprocessor_cache_arena);
+	return exit_code;
 }
 
 static mirac_file_t* validate_and_open_file_for_reading(
@@ -196,23 +463,109 @@ static mirac_file_t* validate_and_open_file_for_writing(
 static void process_source_file_into_output_file(
 	const mirac_string_view_s source_file_path,
 	const mirac_string_view_s output_file_path,
-	mirac_config_s* const config)
+	mirac_config_s* const config,
+	mirac_arena_s* const arena,
+	mirac_preprocessor_cache_s* const preprocessor_cache,
+	mirac_cache_s* const cache,
+	mirac_server_s* const server,
+	mirac_profiler_s* const profiler,
+	mirac_thread_pool_s* const pool)
 {
 	mirac_debug_assert(config != mirac_null);
+	mirac_debug_assert(arena != mirac_null);
+	mirac_debug_assert(preprocessor_cache != mirac_null);
+
+	// note: the unit is timed from the moment its source is read until its output
+	//       is closed, while the bookkeeping in between the phases is not.
+	mirac_profiler_unit_s unit_profile = {0};
+	mirac_profiler_unit_s* profile = mirac_null;
+
+	if (profiler != mirac_null)
+	{
+		unit_profile = mirac_profiler_unit_begin(profiler, source_file_path);
+		profile = &unit_profile;
+	}
+
+	// note: the included files lexed by the unit are accounted along with its arena.
+	mirac_arena_stats_s unit_memory_stats = {0};
+	mirac_arena_stats_s* memory_stats = mirac_null;
+
+	if (config->mem_report)
+	{
+		memory_stats = &unit_memory_stats;
+		mirac_arena_set_stats(arena, memory_stats);
+	}
 
 	mirac_file_t* const source_file = validate_and_open_file_for_reading(source_file_path);
 	mirac_debug_assert(source_file != mirac_null);
 
+	mirac_interner_s interner = mirac_interner_from_parts(arena);
+	mirac_lexer_s lexer = mirac_lexer_from_parts(config, arena, &interner, source_file_path, source_file);
+	switch_phase(profile, mirac_profiler_phase_none);
+
+	// note: the ast dump needs the parsed unit, so it always bypasses the caches.
+	const bool_t is_cached = (cache != mirac_null) && !config->dump_ast;
+	const bool_t is_served = (server != mirac_null) && !config->dump_ast;
+	mirac_cache_key_s key = {0};
+
+	if (is_cached || is_served)
+	{
+		key = mirac_cache_key_from_parts(arena, config, source_file_path, lexer.source);
+	}
+
+	// note: the output of an up to date unit is kept as is, so it is checked
+	//       before the output file is opened (and truncated).
+	if (is_served && mirac_server_is_unit_up_to_date(server, &key, output_file_path))
+	{
+		mirac_lexer_destroy(&lexer);
+		(void)fclose(source_file);
+
+		finish_unit(source_file_path, arena, profile, memory_stats);
+		return;
+	}
+
+	switch_phase(profile, mirac_profiler_phase_write);
 	mirac_file_t* const output_file = validate_and_open_file_for_writing(output_file_path);
 	mirac_debug_assert(output_file != mirac_null);
 
-	mirac_arena_s arena = mirac_arena_from_parts();
-	mirac_lexer_s lexer = mirac_lexer_from_parts(config, &arena, source_file_path, source_file);
-	mirac_parser_s parser = mirac_parser_from_parts(config, &arena, &lexer);
+	if (mirac_config_format_type_elf64_exec == config->format)
+	{
+		// note: the executables are made executable for everyone the umask lets
+		//       (the way ld creates them).
+		const mode_t mask = umask(0);
+		(void)umask(mask);
+		(void)fchmod(fileno(output_file), (mode_t)(0777 & ~mask));
+	}
+
+	if (is_cached)
+	{
+		if (mirac_cache_lookup(cache, &key, output_file))
+		{
+			mirac_lexer_destroy(&lexer);
+			(void)fclose(source_file);
+			(void)fclose(output_file);
+
+			finish_unit(source_file_path, arena, profile, memory_stats);
+			return;
+		}
+	}
+
+	switch_phase(profile, mirac_profiler_phase_parse);
+	mirac_preprocessor_s preprocessor = mirac_preprocessor_from_parts(config, arena, preprocessor_cache, &lexer);
+	mirac_parser_s parser = mirac_parser_from_parts(config, arena, &preprocessor, profile);
 	mirac_ast_unit_s unit = mirac_parser_parse_ast_unit(&parser);
 
+	if (config->optimization >= 1)
+	{
+		mirac_folder_s folder = mirac_folder_from_parts(arena, &unit);
+		mirac_folder_fold_ast_unit(&folder);
+		mirac_folder_destroy(&folder);
+	}
+
 	if (config->dump_ast)
 	{
+		switch_phase(profile, mirac_profiler_phase_write);
+
 		// todo: rework this to be safe:
 		// [
 		char_t ast_dump_file_path[256] = {0};
@@ -238,10 +591,154 @@ static void process_source_file_into_output_file(
 		// todo: implement checker and use it here!
 	}
 
-	mirac_compiler_s compiler = mirac_compiler_from_parts(config, &arena, &unit, output_file);
+	switch_phase(profile, mirac_profiler_phase_codegen);
+	mirac_compiler_s compiler = mirac_compiler_from_parts(config, arena, &unit, output_file, pool, profile);
 	mirac_compiler_compile_ast_unit(&compiler);
+	switch_phase(profile, mirac_profiler_phase_write);
 
-	mirac_arena_destroy(&arena);
+	if (is_cached)
+	{
+		mirac_cache_store(cache, &key, &preprocessor, output_file_path);
+	}
+
+	mirac_lexer_destroy(&lexer);
 	(void)fclose(source_file);
 	(void)fclose(output_file);
+	finish_unit(source_file_path, arena, profile, memory_stats);
+
+	if (is_served)
+	{
+		mirac_server_record_unit(server, &key, output_file_path, &preprocessor);
+	}
+}
+
+static void switch_phase(
+	mirac_profiler_unit_s* const profile,
+	const mirac_profiler_phase_e phase)
+{
+	if (profile != mirac_null)
+	{
+		(void)mirac_profiler_unit_switch_phase(profile, phase);
+	}
+}
+
+static void finish_unit(
+	const mirac_string_view_s source_file_path,
+	mirac_arena_s* const arena,
+	mirac_profiler_unit_s* const profile,
+	const mirac_arena_stats_s* const memory_stats)
+{
+	mirac_debug_assert(arena != mirac_null);
+
+	if (profile != mirac_null)
+	{
+		mirac_profiler_unit_end(profile);
+	}
+
+	if (memory_stats != mirac_null)
+	{
+		mirac_arena_set_stats(arena, mirac_null);
+		mirac_arena_print_stats(memory_stats, source_file_path);
+	}
+}
+
+static void compile_job(
+	void* const context,
+	const uint64_t job_index,
+	const uint64_t worker_index)
+{
+	mirac_debug_assert(context != mirac_null);
+	compile_context_s* const compile_context = (compile_context_s*)context;
+
+	const mirac_string_view_s source_file_path = mirac_string_view_from_cstring(
+		compile_context->source_files[(job_index * 2) + 0]);
+	const mirac_string_view_s output_file_path = mirac_string_view_from_cstring(
+		compile_context->source_files[(job_index * 2) + 1]);
+	mirac_arena_s* const arena = &compile_context->arenas[worker_index];
+
+	mirac_logger_set_capture(&compile_context->captures[job_index]);
+	mirac_c_exit_trap_s trap = {0};
+
+	if (0 == setjmp(trap.buffer))
+	{
+		mirac_c_set_exit_trap(&trap);
+		process_source_file_into_output_file(source_file_path, output_file_path, compile_context->config, arena,
+			compile_context->preprocessor_cache, compile_context->cache, compile_context->server,
+			compile_context->profiler, mirac_null);
+	}
+
+	mirac_c_set_exit_trap(mirac_null);
+	mirac_logger_set_capture(mirac_null);
+	compile_context->has_failed[job_index] = (trap.code != 0);
+
+	// note: a failed unit unwinds without detaching its memory stats.
+	mirac_arena_set_stats(arena, mirac_null);
+	mirac_arena_reset(arena);
+}
+
+static int32_t compile_in_parallel(
+	mirac_config_s* const config,
+	mirac_preprocessor_cache_s* const preprocessor_cache,
+	mirac_cache_s* const cache,
+	mirac_server_s* const server,
+	mirac_profiler_s* const profiler,
+	const char_t** const source_files,
+	const uint64_t pairs_count)
+{
+	mirac_debug_assert(config != mirac_null);
+	mirac_debug_assert(preprocessor_cache != mirac_null);
+	mirac_debug_assert(source_files != mirac_null);
+
+	const uint64_t workers_count = config->jobs < pairs_count ? config->jobs : pairs_count;
+
+	compile_context_s context = (compile_context_s)
+	{
+		.config             = config,
+		.preprocessor_cache = preprocessor_cache,
+		.cache              = cache,
+		.server             = server,
+		.profiler           = profiler,
+		.source_files       = source_files,
+		.arenas             = (mirac_arena_s*)mirac_c_malloc(workers_count * sizeof(mirac_arena_s)),
+		.captures           = (mirac_logger_capture_s*)mirac_c_malloc(pairs_count * sizeof(mirac_logger_capture_s)),
+		.has_failed         = (bool_t*)mirac_c_malloc(pairs_count * sizeof(bool_t))
+	};
+
+	for (uint64_t worker_index = 0; worker_index < workers_count; ++worker_index)
+	{
+		context.arenas[worker_index] = mirac_arena_from_parts();
+	}
+
+	for (uint64_t pair_index = 0; pair_index < pairs_count; ++pair_index)
+	{
+		context.captures[pair_index] = mirac_logger_capture_from_parts();
+		context.has_failed[pair_index] = false;
+	}
+
+	mirac_thread_pool_s pool = mirac_thread_pool_from_parts(workers_count);
+	mirac_thread_pool_run(&pool, pairs_count, compile_job, &context);
+	mirac_thread_pool_destroy(&pool);
+
+	int32_t exit_code = 0;
+
+	for (uint64_t pair_index = 0; pair_index < pairs_count; ++pair_index)
+	{
+		mirac_logger_capture_print(&context.captures[pair_index]);
+		mirac_logger_capture_destroy(&context.captures[pair_index]);
+
+		if (context.has_failed[pair_index])
+		{
+			exit_code = -1;
+		}
+	}
+
+	for (uint64_t worker_index = 0; worker_index < workers_count; ++worker_index)
+	{
+		mirac_arena_destroy(&context.arenas[worker_index]);
+	}
+
+	mirac_c_free(context.arenas);
+	mirac_c_free(context.captures);
+	mirac_c_free(context.has_failed);
+	return exit_code;
 }
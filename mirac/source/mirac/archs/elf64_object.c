@@ -0,0 +1,991 @@
+/**
+ * @file elf64_object.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-04-20
+ */
+
+#include "./elf64_object.h"
+
+#include <mirac/debug.h>
+#include <mirac/logger.h>
+
+mirac_implement_heap_array_type(elf64_section_list, elf64_section_s);
+mirac_implement_heap_array_type(elf64_symbol_list, elf64_symbol_s);
+mirac_implement_heap_array_type(elf64_relocation_list, elf64_relocation_s);
+
+/**
+ * @brief Attributes nasm gives to the sections of the standard names (any other
+ * section is progbits, alloc, noexec, nowrite and aligned at 1).
+ */
+static const struct
+{
+	mirac_string_view_s name;
+	uint32_t type;
+	uint64_t flags;
+	uint64_t alignment;
+} g_standard_sections[] =
+{
+	{ mirac_string_view_static(".text"),   SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR, 16 },
+	{ mirac_string_view_static(".rodata"), SHT_PROGBITS, SHF_ALLOC,                 4  },
+	{ mirac_string_view_static(".data"),   SHT_PROGBITS, SHF_ALLOC | SHF_WRITE,     4  },
+	{ mirac_string_view_static(".bss"),    SHT_NOBITS,   SHF_ALLOC | SHF_WRITE,     4  },
+};
+
+static const char_t g_zeros[64] = {0};
+
+// note: the executables are linked at the address and the segments are aligned to
+//       the page size ld uses by default.
+#define elf64_base_address 0x400000
+#define elf64_page_size 0x1000
+
+/**
+ * @brief Kinds of the segments of executables (in the order of their placement).
+ */
+typedef enum
+{
+	elf64_segment_kind_executable = 0,
+	elf64_segment_kind_read_only,
+	elf64_segment_kind_writable,
+	elf64_segment_kinds_count
+} elf64_segment_kind_e;
+
+/**
+ * @brief Get the kind of the segment the section is placed into.
+ * 
+ * @param section section to get the segment kind of
+ * 
+ * @return elf64_segment_kind_e
+ */
+static elf64_segment_kind_e get_segment_kind(
+	const elf64_section_s* const section);
+
+/**
+ * @brief Check if the symbol has to be bound globally (undefined symbols are,
+ * so that the linker resolves or reports them).
+ * 
+ * @param symbol symbol to check
+ * 
+ * @return bool_t
+ */
+static bool_t is_bound_globally(
+	const elf64_symbol_s* const symbol);
+
+/**
+ * @brief Give the symbols their indices in the symbol table, where the local
+ * ones come before the global ones.
+ * 
+ * @param object      elf64 object instance
+ * @param first_index index of the first symbol (after the null symbol and the
+ * section symbols, if there are any)
+ * @param indices     indices of the symbols (one per symbol)
+ * 
+ * @return uint32_t index of the first global symbol
+ */
+static uint32_t order_symbols(
+	const elf64_object_s* const object,
+	const uint32_t first_index,
+	uint32_t* const indices);
+
+/**
+ * @brief Build the string table of the names of the symbols.
+ * 
+ * @param object       elf64 object instance
+ * @param name_offsets offsets of the names in the table (one per symbol)
+ * 
+ * @return mirac_emitter_s string table (without a file)
+ */
+static mirac_emitter_s build_symbol_names(
+	const elf64_object_s* const object,
+	uint32_t* const name_offsets);
+
+/**
+ * @brief Emit the symbols in the order of their indices (so the local ones and
+ * then the global ones).
+ * 
+ * @param object       elf64 object instance
+ * @param name_offsets offsets of the names in the string table
+ * @param addresses    addresses of the sections, which are added to the values
+ * of the symbols (mirac_null in relocatable objects)
+ * @param emitter      emitter to emit into
+ * @param position     position to advance
+ */
+static void emit_symbols(
+	const elf64_object_s* const object,
+	const uint32_t* const name_offsets,
+	const uint64_t* const addresses,
+	mirac_emitter_s* const emitter,
+	uint64_t* const position);
+
+/**
+ * @brief Apply the relocations to the bytes of the sections laid out at the
+ * addresses, reporting the references to undefined symbols.
+ * 
+ * @param object    elf64 object instance
+ * @param addresses addresses of the sections
+ */
+static void apply_relocations(
+	elf64_object_s* const object,
+	const uint64_t* const addresses);
+
+/**
+ * @brief Emit zeros to pad the position up to the alignment.
+ * 
+ * @param emitter   emitter to emit into
+ * @param position  position to pad (it is advanced past the padding)
+ * @param alignment alignment to pad to
+ */
+static void emit_padding(
+	mirac_emitter_s* const emitter,
+	uint64_t* const position,
+	const uint64_t alignment);
+
+/**
+ * @brief Emit the number of zeros and advance the position past them.
+ * 
+ * @param emitter  emitter to emit into
+ * @param position position to advance
+ * @param length   number of zeros to emit
+ */
+static void emit_zeros(
+	mirac_emitter_s* const emitter,
+	uint64_t* const position,
+	const uint64_t length);
+
+/**
+ * @brief Emit the bytes and advance the position past them.
+ * 
+ * @param emitter  emitter to emit into
+ * @param position position to advance
+ * @param data     bytes to emit
+ * @param length   number of bytes to emit
+ */
+static void emit_bytes(
+	mirac_emitter_s* const emitter,
+	uint64_t* const position,
+	const void* const data,
+	const uint64_t length);
+
+/**
+ * @brief Append the name with its terminating zero to the string table.
+ * 
+ * @param table string table to append to
+ * @param name  name to append
+ * 
+ * @return uint32_t offset of the name in the string table
+ */
+static uint32_t append_name(
+	mirac_emitter_s* const table,
+	const mirac_string_view_s name);
+
+elf64_object_s elf64_object_from_parts(
+	mirac_arena_s* const arena)
+{
+	mirac_debug_assert(arena != mirac_null);
+
+	return (elf64_object_s)
+	{
+		.arena       = arena,
+		.sections    = elf64_section_list_from_parts(arena, 0),
+		.symbols     = elf64_symbol_list_from_parts(arena, 0),
+		.relocations = elf64_relocation_list_from_parts(arena, 0)
+	};
+}
+
+elf64_section_t elf64_object_get_section(
+	elf64_object_s* const object,
+	const mirac_string_view_s name)
+{
+	mirac_debug_assert(object != mirac_null);
+
+	for (uint64_t section_index = 0; section_index < object->sections.count; ++section_index)
+	{
+		if (mirac_string_view_equal(object->sections.data[section_index].name, name))
+		{
+			return (elf64_section_t)section_index;
+		}
+	}
+
+	elf64_section_s section = (elf64_section_s)
+	{
+		.name        = name,
+		.type        = SHT_PROGBITS,
+		.flags       = SHF_ALLOC,
+		.alignment   = 1,
+		.data        = mirac_emitter_from_parts(object->arena, mirac_null),
+		.nobits_size = 0
+	};
+
+	for (uint64_t standard_index = 0; standard_index < (sizeof(g_standard_sections) / sizeof(g_standard_sections[0])); ++standard_index)
+	{
+		if (mirac_string_view_equal(g_standard_sections[standard_index].name, name))
+		{
+			section.type = g_standard_sections[standard_index].type;
+			section.flags = g_standard_sections[standard_index].flags;
+			section.alignment = g_standard_sections[standard_index].alignment;
+			break;
+		}
+	}
+
+	elf64_section_list_push(&object->sections, section);
+	return (elf64_section_t)(object->sections.count - 1);
+}
+
+uint64_t elf64_object_get_section_size(
+	const elf64_object_s* const object,
+	const elf64_section_t section)
+{
+	mirac_debug_assert(object != mirac_null);
+	mirac_debug_assert(section < object->sections.count);
+
+	const elf64_section_s* const entry = &object->sections.data[section];
+	return SHT_NOBITS == entry->type ? entry->nobits_size : entry->data.length;
+}
+
+uint64_t elf64_object_append(
+	elf64_object_s* const object,
+	const elf64_section_t section,
+	const char_t* const data,
+	const uint64_t length)
+{
+	mirac_debug_assert(object != mirac_null);
+	mirac_debug_assert(section < object->sections.count);
+
+	elf64_section_s* const entry = &object->sections.data[section];
+	const uint64_t offset = elf64_object_get_section_size(object, section);
+
+	if (SHT_NOBITS == entry->type)
+	{
+		entry->nobits_size += length;
+	}
+	else if (data != mirac_null)
+	{
+		mirac_emitter_emit(&entry->data, data, length);
+	}
+	else
+	{
+		for (uint64_t zeros_length = length; zeros_length > 0;)
+		{
+			const uint64_t chunk_length = zeros_length < sizeof(g_zeros) ? zeros_length : sizeof(g_zeros);
+			mirac_emitter_emit(&entry->data, g_zeros, chunk_length);
+			zeros_length -= chunk_length;
+		}
+	}
+
+	return offset;
+}
+
+elf64_symbol_t elf64_object_add_symbol(
+	elf64_object_s* const object,
+	const mirac_string_view_s name,
+	const uint8_t type,
+	const bool_t is_global)
+{
+	mirac_debug_assert(object != mirac_null);
+
+	if (object->symbols.count >= elf64_symbol_none)
+	{
+		mirac_logger_error("internal failure -- exceeded the maximum of %u symbols in an object.", UINT32_MAX);
+		mirac_c_exit(-1);
+	}
+
+	elf64_symbol_list_push(&object->symbols, (elf64_symbol_s)
+	{
+		.name      = name,
+		.section   = elf64_section_none,
+		.value     = 0,
+		.size      = 0,
+		.type      = type,
+		.is_global = is_global
+	});
+
+	return (elf64_symbol_t)(object->symbols.count - 1);
+}
+
+void elf64_object_define_symbol(
+	elf64_object_s* const object,
+	const elf64_symbol_t symbol,
+	const elf64_section_t section,
+	const uint64_t value,
+	const uint64_t size)
+{
+	mirac_debug_assert(object != mirac_null);
+	mirac_debug_assert(symbol < object->symbols.count);
+	mirac_debug_assert(section < object->sections.count);
+
+	elf64_symbol_s* const entry = &object->symbols.data[symbol];
+	entry->section = section;
+	entry->value = value;
+	entry->size = size;
+}
+
+void elf64_object_add_relocation(
+	elf64_object_s* const object,
+	const elf64_section_t section,
+	const uint64_t offset,
+	const uint32_t type,
+	const elf64_symbol_t symbol,
+	const int64_t addend)
+{
+	mirac_debug_assert(object != mirac_null);
+	mirac_debug_assert(section < object->sections.count);
+	mirac_debug_assert(symbol < object->symbols.count);
+
+	elf64_relocation_list_push(&object->relocations, (elf64_relocation_s)
+	{
+		.section = section,
+		.offset  = offset,
+		.type    = type,
+		.symbol  = symbol,
+		.addend  = addend
+	});
+}
+
+void elf64_object_write_relocatable(
+	elf64_object_s* const object,
+	mirac_emitter_s* const emitter)
+{
+	mirac_debug_assert(object != mirac_null);
+	mirac_debug_assert(emitter != mirac_null);
+
+	const uint64_t sections_count = object->sections.count;
+	const uint64_t symbols_count = object->symbols.count;
+	const mirac_arena_site_e site = mirac_arena_set_site(object->arena, mirac_arena_site_output);
+
+	// note: the symbol table starts with the null symbol and a symbol for every
+	//       section, which are followed by the local symbols and then the global
+	//       ones.
+	uint32_t* const symbol_indices = (uint32_t*)mirac_arena_malloc(object->arena, (symbols_count + 1) * sizeof(uint32_t));
+	uint32_t* const name_offsets = (uint32_t*)mirac_arena_malloc(object->arena, (symbols_count + 1) * sizeof(uint32_t));
+	const uint32_t first_global_index = order_symbols(object, (uint32_t)(1 + sections_count), symbol_indices);
+	mirac_emitter_s strtab = build_symbol_names(object, name_offsets);
+
+	// note: the section headers are the null one, one per section, one per rela
+	//       section of a section with relocations, and the symtab, strtab and
+	//       shstrtab ones.
+	uint64_t* const relocations_counts = (uint64_t*)mirac_arena_malloc(object->arena, (sections_count + 1) * sizeof(uint64_t));
+	mirac_c_memset(relocations_counts, 0, (sections_count + 1) * sizeof(uint64_t));
+	uint64_t rela_sections_count = 0;
+
+	for (uint64_t relocation_index = 0; relocation_index < object->relocations.count; ++relocation_index)
+	{
+		rela_sections_count += 0 == relocations_counts[object->relocations.data[relocation_index].section]++;
+	}
+
+	const uint64_t headers_count = 1 + sections_count + rela_sections_count + 3;
+	const uint64_t symtab_header_index = headers_count - 3;
+	Elf64_Shdr* const headers = (Elf64_Shdr*)mirac_arena_malloc(object->arena, headers_count * sizeof(Elf64_Shdr));
+	mirac_c_memset(headers, 0, headers_count * sizeof(Elf64_Shdr));
+
+	mirac_emitter_s shstrtab = mirac_emitter_from_parts(object->arena, mirac_null);
+	mirac_emitter_emit(&shstrtab, g_zeros, 1);
+	uint64_t position = sizeof(Elf64_Ehdr);
+
+	for (uint64_t section_index = 0; section_index < sections_count; ++section_index)
+	{
+		const elf64_section_s* const section = &object->sections.data[section_index];
+		Elf64_Shdr* const header = &headers[1 + section_index];
+		position = (position + section->alignment - 1) & ~(section->alignment - 1);
+
+		header->sh_name = append_name(&shstrtab, section->name);
+		header->sh_type = section->type;
+		header->sh_flags = section->flags;
+		header->sh_offset = position;
+		header->sh_size = elf64_object_get_section_size(object, (elf64_section_t)section_index);
+		header->sh_addralign = section->alignment;
+		position += SHT_NOBITS == section->type ? 0 : header->sh_size;
+	}
+
+	uint64_t header_index = 1 + sections_count;
+
+	for (uint64_t section_index = 0; section_index < sections_count; ++section_index)
+	{
+		if (relocations_counts[section_index] <= 0)
+		{
+			continue;
+		}
+
+		Elf64_Shdr* const header = &headers[header_index++];
+		position = (position + 7) & ~(uint64_t)7;
+		header->sh_name = (uint32_t)shstrtab.length;
+		mirac_emitter_emit_static(&shstrtab, ".rela");
+		(void)append_name(&shstrtab, object->sections.data[section_index].name);
+
+		header->sh_type = SHT_RELA;
+		header->sh_flags = SHF_INFO_LINK;
+		header->sh_offset = position;
+		header->sh_size = relocations_counts[section_index] * sizeof(Elf64_Rela);
+		header->sh_link = (uint32_t)symtab_header_index;
+		header->sh_info = (uint32_t)(1 + section_index);
+		header->sh_addralign = 8;
+		header->sh_entsize = sizeof(Elf64_Rela);
+		position += header->sh_size;
+	}
+
+	Elf64_Shdr* const symtab_header = &headers[symtab_header_index];
+	position = (position + 7) & ~(uint64_t)7;
+	symtab_header->sh_name = append_name(&shstrtab, mirac_string_view_from_cstring(".symtab"));
+	symtab_header->sh_type = SHT_SYMTAB;
+	symtab_header->sh_offset = position;
+	symtab_header->sh_size = (1 + sections_count + symbols_count) * sizeof(Elf64_Sym);
+	symtab_header->sh_link = (uint32_t)(symtab_header_index + 1);
+	symtab_header->sh_info = first_global_index;
+	symtab_header->sh_addralign = 8;
+	symtab_header->sh_entsize = sizeof(Elf64_Sym);
+	position += symtab_header->sh_size;
+
+	Elf64_Shdr* const strtab_header = &headers[symtab_header_index + 1];
+	strtab_header->sh_name = append_name(&shstrtab, mirac_string_view_from_cstring(".strtab"));
+	strtab_header->sh_type = SHT_STRTAB;
+	strtab_header->sh_offset = position;
+	strtab_header->sh_size = strtab.length;
+	strtab_header->sh_addralign = 1;
+	position += strtab_header->sh_size;
+
+	Elf64_Shdr* const shstrtab_header = &headers[symtab_header_index + 2];
+	shstrtab_header->sh_name = append_name(&shstrtab, mirac_string_view_from_cstring(".shstrtab"));
+	shstrtab_header->sh_type = SHT_STRTAB;
+	shstrtab_header->sh_offset = position;
+	shstrtab_header->sh_size = shstrtab.length;
+	shstrtab_header->sh_addralign = 1;
+	position += shstrtab_header->sh_size;
+
+	const uint64_t headers_offset = (position + 7) & ~(uint64_t)7;
+
+	Elf64_Ehdr elf_header = {0};
+	mirac_c_memcpy(elf_header.e_ident, ELFMAG, SELFMAG);
+	elf_header.e_ident[EI_CLASS] = ELFCLASS64;
+	elf_header.e_ident[EI_DATA] = ELFDATA2LSB;
+	elf_header.e_ident[EI_VERSION] = EV_CURRENT;
+	elf_header.e_ident[EI_OSABI] = ELFOSABI_SYSV;
+	elf_header.e_type = ET_REL;
+	elf_header.e_machine = EM_X86_64;
+	elf_header.e_version = EV_CURRENT;
+	elf_header.e_shoff = headers_offset;
+	elf_header.e_ehsize = sizeof(Elf64_Ehdr);
+	elf_header.e_shentsize = sizeof(Elf64_Shdr);
+	elf_header.e_shnum = (Elf64_Half)headers_count;
+	elf_header.e_shstrndx = (Elf64_Half)(symtab_header_index + 2);
+
+	if (headers_count >= SHN_LORESERVE)
+	{
+		mirac_logger_error("internal failure -- exceeded the maximum of %d sections in an object.", SHN_LORESERVE - 1);
+		mirac_c_exit(-1);
+	}
+
+	position = 0;
+	emit_bytes(emitter, &position, &elf_header, sizeof(elf_header));
+
+	for (uint64_t section_index = 0; section_index < sections_count; ++section_index)
+	{
+		const elf64_section_s* const section = &object->sections.data[section_index];
+
+		if (section->type != SHT_NOBITS)
+		{
+			emit_padding(emitter, &position, section->alignment);
+			emit_bytes(emitter, &position, section->data.data, section->data.length);
+		}
+	}
+
+	for (uint64_t section_index = 0; section_index < sections_count; ++section_index)
+	{
+		if (relocations_counts[section_index] <= 0)
+		{
+			continue;
+		}
+
+		emit_padding(emitter, &position, 8);
+
+		for (uint64_t relocation_index = 0; relocation_index < object->relocations.count; ++relocation_index)
+		{
+			const elf64_relocation_s* const relocation = &object->relocations.data[relocation_index];
+
+			if (relocation->section == section_index)
+			{
+				const Elf64_Rela rela = (Elf64_Rela)
+				{
+					.r_offset = relocation->offset,
+					.r_info   = ELF64_R_INFO(symbol_indices[relocation->symbol], relocation->type),
+					.r_addend = relocation->addend
+				};
+
+				emit_bytes(emitter, &position, &rela, sizeof(rela));
+			}
+		}
+	}
+
+	emit_padding(emitter, &position, 8);
+	const Elf64_Sym null_symbol = {0};
+	emit_bytes(emitter, &position, &null_symbol, sizeof(null_symbol));
+
+	for (uint64_t section_index = 0; section_index < sections_count; ++section_index)
+	{
+		const Elf64_Sym section_symbol = (Elf64_Sym)
+		{
+			.st_info  = ELF64_ST_INFO(STB_LOCAL, STT_SECTION),
+			.st_shndx = (Elf64_Section)(1 + section_index)
+		};
+
+		emit_bytes(emitter, &position, &section_symbol, sizeof(section_symbol));
+	}
+
+	emit_symbols(object, name_offsets, mirac_null, emitter, &position);
+
+	emit_bytes(emitter, &position, strtab.data, strtab.length);
+	emit_bytes(emitter, &position, shstrtab.data, shstrtab.length);
+	emit_padding(emitter, &position, 8);
+	mirac_debug_assert(headers_offset == position);
+	emit_bytes(emitter, &position, headers, headers_count * sizeof(Elf64_Shdr));
+
+	(void)mirac_arena_set_site(object->arena, site);
+}
+
+void elf64_object_write_executable(
+	elf64_object_s* const object,
+	const mirac_string_view_s entry,
+	mirac_emitter_s* const emitter)
+{
+	mirac_debug_assert(object != mirac_null);
+	mirac_debug_assert(emitter != mirac_null);
+
+	const uint64_t sections_count = object->sections.count;
+	const uint64_t symbols_count = object->symbols.count;
+	const mirac_arena_site_e site = mirac_arena_set_site(object->arena, mirac_arena_site_output);
+
+	elf64_symbol_t entry_symbol = elf64_symbol_none;
+
+	for (uint64_t symbol = 0; symbol < symbols_count; ++symbol)
+	{
+		const elf64_symbol_s* const candidate = &object->symbols.data[symbol];
+
+		if ((candidate->section != elf64_section_none) && mirac_string_view_equal(candidate->name, entry))
+		{
+			entry_symbol = (elf64_symbol_t)symbol;
+			break;
+		}
+	}
+
+	if (elf64_symbol_none == entry_symbol)
+	{
+		mirac_logger_error("undefined entry '" mirac_sv_fmt "' -- it has to be a fun def that is not stripped.", mirac_sv_arg(entry));
+		mirac_c_exit(-1);
+	}
+
+	// note: the sections are laid out like ld lays them out by default: the
+	//       executable ones, then the read only ones, and then the writable ones
+	//       (with the nobits ones last), each kind in a segment of its own, which
+	//       starts at a new page. The first segment also maps the headers.
+	uint64_t* const offsets = (uint64_t*)mirac_arena_malloc(object->arena, (sections_count + 1) * sizeof(uint64_t));
+	uint64_t* const addresses = (uint64_t*)mirac_arena_malloc(object->arena, (sections_count + 1) * sizeof(uint64_t));
+	Elf64_Phdr segments[elf64_segment_kinds_count] = {0};
+	uint64_t memory_sizes[elf64_segment_kinds_count] = {0};
+	uint64_t segments_count = 0;
+
+	for (uint64_t section_index = 0; section_index < sections_count; ++section_index)
+	{
+		memory_sizes[get_segment_kind(&object->sections.data[section_index])] +=
+			elf64_object_get_section_size(object, (elf64_section_t)section_index);
+	}
+
+	for (uint64_t kind = 0; kind < elf64_segment_kinds_count; ++kind)
+	{
+		segments_count += memory_sizes[kind] > 0;
+	}
+
+	const uint64_t headers_size = sizeof(Elf64_Ehdr) + (segments_count * sizeof(Elf64_Phdr));
+	uint64_t position = headers_size;
+	uint64_t segment_index = 0;
+
+	for (uint64_t kind = 0; kind < elf64_segment_kinds_count; ++kind)
+	{
+		const bool_t has_segment = memory_sizes[kind] > 0;
+		const uint64_t segment_offset = (has_segment && (segment_index > 0)) ?
+			((position + elf64_page_size - 1) & ~(uint64_t)(elf64_page_size - 1)) : 0;
+		position = segment_offset > 0 ? segment_offset : position;
+		uint64_t file_end = position;
+
+		// note: the progbits sections occupy the file, while the nobits ones only
+		//       occupy the memory past them.
+		for (uint8_t pass = 0; pass < 2; ++pass)
+		{
+			for (uint64_t section_index = 0; section_index < sections_count; ++section_index)
+			{
+				const elf64_section_s* const section = &object->sections.data[section_index];
+
+				if ((get_segment_kind(section) != kind) || ((SHT_NOBITS == section->type) != (1 == pass)))
+				{
+					continue;
+				}
+
+				position = (position + section->alignment - 1) & ~(section->alignment - 1);
+				offsets[section_index] = position;
+				addresses[section_index] = elf64_base_address + position;
+				position += elf64_object_get_section_size(object, (elf64_section_t)section_index);
+			}
+
+			file_end = 0 == pass ? position : file_end;
+		}
+
+		if (has_segment)
+		{
+			Elf64_Phdr* const segment = &segments[segment_index++];
+			segment->p_type = PT_LOAD;
+			segment->p_flags = elf64_segment_kind_executable == kind ? (PF_R | PF_X) :
+				(elf64_segment_kind_writable == kind ? (PF_R | PF_W) : PF_R);
+			segment->p_offset = segment_offset;
+			segment->p_vaddr = elf64_base_address + segment_offset;
+			segment->p_paddr = segment->p_vaddr;
+			segment->p_filesz = file_end - segment_offset;
+			segment->p_memsz = position - segment_offset;
+			segment->p_align = elf64_page_size;
+		}
+
+		position = file_end;
+	}
+
+	mirac_debug_assert(segment_index == segments_count);
+	const uint64_t sections_end = position;
+	apply_relocations(object, addresses);
+
+	uint32_t* const symbol_indices = (uint32_t*)mirac_arena_malloc(object->arena, (symbols_count + 1) * sizeof(uint32_t));
+	uint32_t* const name_offsets = (uint32_t*)mirac_arena_malloc(object->arena, (symbols_count + 1) * sizeof(uint32_t));
+	const uint32_t first_global_index = order_symbols(object, 1, symbol_indices);
+	mirac_emitter_s strtab = build_symbol_names(object, name_offsets);
+
+	// note: the section headers are the null one, one per section, and the
+	//       symtab, strtab and shstrtab ones (so that the executable can still be
+	//       disassembled and debugged by the names of the defs).
+	const uint64_t headers_count = 1 + sections_count + 3;
+	const uint64_t symtab_header_index = headers_count - 3;
+	Elf64_Shdr* const headers = (Elf64_Shdr*)mirac_arena_malloc(object->arena, headers_count * sizeof(Elf64_Shdr));
+	mirac_c_memset(headers, 0, headers_count * sizeof(Elf64_Shdr));
+
+	if (headers_count >= SHN_LORESERVE)
+	{
+		mirac_logger_error("internal failure -- exceeded the maximum of %d sections in an object.", SHN_LORESERVE - 1);
+		mirac_c_exit(-1);
+	}
+
+	mirac_emitter_s shstrtab = mirac_emitter_from_parts(object->arena, mirac_null);
+	mirac_emitter_emit(&shstrtab, g_zeros, 1);
+
+	for (uint64_t section_index = 0; section_index < sections_count; ++section_index)
+	{
+		const elf64_section_s* const section = &object->sections.data[section_index];
+		Elf64_Shdr* const header = &headers[1 + section_index];
+
+		header->sh_name = append_name(&shstrtab, section->name);
+		header->sh_type = section->type;
+		header->sh_flags = section->flags;
+		header->sh_addr = addresses[section_index];
+		header->sh_offset = offsets[section_index];
+		header->sh_size = elf64_object_get_section_size(object, (elf64_section_t)section_index);
+		header->sh_addralign = section->alignment;
+	}
+
+	Elf64_Shdr* const symtab_header = &headers[symtab_header_index];
+	position = (position + 7) & ~(uint64_t)7;
+	symtab_header->sh_name = append_name(&shstrtab, mirac_string_view_from_cstring(".symtab"));
+	symtab_header->sh_type = SHT_SYMTAB;
+	symtab_header->sh_offset = position;
+	symtab_header->sh_size = (1 + symbols_count) * sizeof(Elf64_Sym);
+	symtab_header->sh_link = (uint32_t)(symtab_header_index + 1);
+	symtab_header->sh_info = first_global_index;
+	symtab_header->sh_addralign = 8;
+	symtab_header->sh_entsize = sizeof(Elf64_Sym);
+	position += symtab_header->sh_size;
+
+	Elf64_Shdr* const strtab_header = &headers[symtab_header_index + 1];
+	strtab_header->sh_name = append_name(&shstrtab, mirac_string_view_from_cstring(".strtab"));
+	strtab_header->sh_type = SHT_STRTAB;
+	strtab_header->sh_offset = position;
+	strtab_header->sh_size = strtab.length;
+	strtab_header->sh_addralign = 1;
+	position += strtab_header->sh_size;
+
+	Elf64_Shdr* const shstrtab_header = &headers[symtab_header_index + 2];
+	shstrtab_header->sh_name = append_name(&shstrtab, mirac_string_view_from_cstring(".shstrtab"));
+	shstrtab_header->sh_type = SHT_STRTAB;
+	shstrtab_header->sh_offset = position;
+	shstrtab_header->sh_size = shstrtab.length;
+	shstrtab_header->sh_addralign = 1;
+	position += shstrtab_header->sh_size;
+
+	const uint64_t headers_offset = (position + 7) & ~(uint64_t)7;
+	const elf64_symbol_s* const entry_definition = &object->symbols.data[entry_symbol];
+
+	Elf64_Ehdr elf_header = {0};
+	mirac_c_memcpy(elf_header.e_ident, ELFMAG, SELFMAG);
+	elf_header.e_ident[EI_CLASS] = ELFCLASS64;
+	elf_header.e_ident[EI_DATA] = ELFDATA2LSB;
+	elf_header.e_ident[EI_VERSION] = EV_CURRENT;
+	elf_header.e_ident[EI_OSABI] = ELFOSABI_SYSV;
+	elf_header.e_type = ET_EXEC;
+	elf_header.e_machine = EM_X86_64;
+	elf_header.e_version = EV_CURRENT;
+	elf_header.e_entry = addresses[entry_definition->section] + entry_definition->value;
+	elf_header.e_phoff = sizeof(Elf64_Ehdr);
+	elf_header.e_shoff = headers_offset;
+	elf_header.e_ehsize = sizeof(Elf64_Ehdr);
+	elf_header.e_phentsize = sizeof(Elf64_Phdr);
+	elf_header.e_phnum = (Elf64_Half)segments_count;
+	elf_header.e_shentsize = sizeof(Elf64_Shdr);
+	elf_header.e_shnum = (Elf64_Half)headers_count;
+	elf_header.e_shstrndx = (Elf64_Half)(symtab_header_index + 2);
+
+	position = 0;
+	emit_bytes(emitter, &position, &elf_header, sizeof(elf_header));
+	emit_bytes(emitter, &position, segments, segments_count * sizeof(Elf64_Phdr));
+
+	for (uint64_t kind = 0; kind < elf64_segment_kinds_count; ++kind)
+	{
+		for (uint64_t section_index = 0; section_index < sections_count; ++section_index)
+		{
+			const elf64_section_s* const section = &object->sections.data[section_index];
+
+			if ((get_segment_kind(section) == kind) && (section->type != SHT_NOBITS))
+			{
+				mirac_debug_assert(position <= offsets[section_index]);
+				emit_zeros(emitter, &position, offsets[section_index] - position);
+				emit_bytes(emitter, &position, section->data.data, section->data.length);
+			}
+		}
+	}
+
+	// note: a segment of only nobits sections still starts at a new page in the
+	//       file, even though it occupies none of it.
+	emit_zeros(emitter, &position, sections_end - position);
+	emit_padding(emitter, &position, 8);
+	mirac_debug_assert(symtab_header->sh_offset == position);
+	const Elf64_Sym null_symbol = {0};
+	emit_bytes(emitter, &position, &null_symbol, sizeof(null_symbol));
+	emit_symbols(object, name_offsets, addresses, emitter, &position);
+	emit_bytes(emitter, &position, strtab.data, strtab.length);
+	emit_bytes(emitter, &position, shstrtab.data, shstrtab.length);
+	emit_padding(emitter, &position, 8);
+	mirac_debug_assert(headers_offset == position);
+	emit_bytes(emitter, &position, headers, headers_count * sizeof(Elf64_Shdr));
+
+	(void)mirac_arena_set_site(object->arena, site);
+}
+
+static elf64_segment_kind_e get_segment_kind(
+	const elf64_section_s* const section)
+{
+	mirac_debug_assert(section != mirac_null);
+
+	if (section->flags & SHF_EXECINSTR)
+	{
+		return elf64_segment_kind_executable;
+	}
+
+	return (section->flags & SHF_WRITE) ? elf64_segment_kind_writable : elf64_segment_kind_read_only;
+}
+
+static uint32_t order_symbols(
+	const elf64_object_s* const object,
+	const uint32_t first_index,
+	uint32_t* const indices)
+{
+	mirac_debug_assert(object != mirac_null);
+	mirac_debug_assert(indices != mirac_null);
+
+	uint32_t symbol_index = first_index;
+
+	for (uint64_t symbol = 0; symbol < object->symbols.count; ++symbol)
+	{
+		if (!is_bound_globally(&object->symbols.data[symbol]))
+		{
+			indices[symbol] = symbol_index++;
+		}
+	}
+
+	const uint32_t first_global_index = symbol_index;
+
+	for (uint64_t symbol = 0; symbol < object->symbols.count; ++symbol)
+	{
+		if (is_bound_globally(&object->symbols.data[symbol]))
+		{
+			indices[symbol] = symbol_index++;
+		}
+	}
+
+	return first_global_index;
+}
+
+static mirac_emitter_s build_symbol_names(
+	const elf64_object_s* const object,
+	uint32_t* const name_offsets)
+{
+	mirac_debug_assert(object != mirac_null);
+	mirac_debug_assert(name_offsets != mirac_null);
+
+	mirac_emitter_s strtab = mirac_emitter_from_parts(object->arena, mirac_null);
+	mirac_emitter_emit(&strtab, g_zeros, 1);
+
+	for (uint64_t symbol = 0; symbol < object->symbols.count; ++symbol)
+	{
+		name_offsets[symbol] = append_name(&strtab, object->symbols.data[symbol].name);
+	}
+
+	return strtab;
+}
+
+static void emit_symbols(
+	const elf64_object_s* const object,
+	const uint32_t* const name_offsets,
+	const uint64_t* const addresses,
+	mirac_emitter_s* const emitter,
+	uint64_t* const position)
+{
+	mirac_debug_assert(object != mirac_null);
+	mirac_debug_assert(name_offsets != mirac_null);
+
+	for (uint8_t pass = 0; pass < 2; ++pass)
+	{
+		for (uint64_t symbol = 0; symbol < object->symbols.count; ++symbol)
+		{
+			const elf64_symbol_s* const entry = &object->symbols.data[symbol];
+			const bool_t is_global = is_bound_globally(entry);
+			const bool_t is_defined = entry->section != elf64_section_none;
+
+			if (is_global != (1 == pass))
+			{
+				continue;
+			}
+
+			const Elf64_Sym elf_symbol = (Elf64_Sym)
+			{
+				.st_name  = name_offsets[symbol],
+				.st_info  = (uint8_t)ELF64_ST_INFO(is_global ? STB_GLOBAL : STB_LOCAL, entry->type),
+				.st_shndx = (Elf64_Section)(is_defined ? (1 + entry->section) : SHN_UNDEF),
+				.st_value = entry->value + (((addresses != mirac_null) && is_defined) ? addresses[entry->section] : 0),
+				.st_size  = entry->size
+			};
+
+			emit_bytes(emitter, position, &elf_symbol, sizeof(elf_symbol));
+		}
+	}
+}
+
+static void apply_relocations(
+	elf64_object_s* const object,
+	const uint64_t* const addresses)
+{
+	mirac_debug_assert(object != mirac_null);
+	mirac_debug_assert(addresses != mirac_null);
+
+	for (uint64_t relocation_index = 0; relocation_index < object->relocations.count; ++relocation_index)
+	{
+		const elf64_relocation_s* const relocation = &object->relocations.data[relocation_index];
+		const elf64_symbol_s* const symbol = &object->symbols.data[relocation->symbol];
+
+		if (elf64_section_none == symbol->section)
+		{
+			mirac_logger_error("undefined reference to '" mirac_sv_fmt "'.", mirac_sv_arg(symbol->name));
+			mirac_c_exit(-1);
+		}
+
+		mirac_emitter_s* const data = &object->sections.data[relocation->section].data;
+		const int64_t target = (int64_t)(addresses[symbol->section] + symbol->value) + relocation->addend;
+		const int64_t place = (int64_t)(addresses[relocation->section] + relocation->offset);
+		int64_t value = target;
+		uint8_t width = 4;
+
+		switch (relocation->type)
+		{
+			case R_X86_64_64:   { width = 8; } break;
+			case R_X86_64_32S:  { } break;
+			case R_X86_64_PC32: { value = target - place; } break;
+
+			default:
+			{
+				mirac_logger_error("internal failure -- unsupported relocation type %u.", relocation->type);
+				mirac_c_exit(-1);
+			} break;
+		}
+
+		if ((4 == width) && ((value < INT32_MIN) || (value > INT32_MAX)))
+		{
+			mirac_logger_error("relocation against '" mirac_sv_fmt "' does not fit into 32 bits.", mirac_sv_arg(symbol->name));
+			mirac_c_exit(-1);
+		}
+
+		mirac_debug_assert((relocation->offset + width) <= data->length);
+
+		for (uint8_t byte_index = 0; byte_index < width; ++byte_index)
+		{
+			data->data[relocation->offset + byte_index] = (char_t)(((uint64_t)value >> (byte_index * 8)) & 0xff);
+		}
+	}
+}
+
+static bool_t is_bound_globally(
+	const elf64_symbol_s* const symbol)
+{
+	mirac_debug_assert(symbol != mirac_null);
+	return symbol->is_global || (elf64_section_none == symbol->section);
+}
+
+static void emit_padding(
+	mirac_emitter_s* const emitter,
+	uint64_t* const position,
+	const uint64_t alignment)
+{
+	mirac_debug_assert(position != mirac_null);
+	mirac_debug_assert(alignment > 0);
+
+	const uint64_t aligned_position = (*position + alignment - 1) & ~(alignment - 1);
+	emit_zeros(emitter, position, aligned_position - *position);
+}
+
+static void emit_zeros(
+	mirac_emitter_s* const emitter,
+	uint64_t* const position,
+	const uint64_t length)
+{
+	mirac_debug_assert(position != mirac_null);
+
+	for (uint64_t zeros_length = length; zeros_length > 0;)
+	{
+		const uint64_t chunk_length = zeros_length < sizeof(g_zeros) ? zeros_length : sizeof(g_zeros);
+		emit_bytes(emitter, position, g_zeros, chunk_length);
+		zeros_length -= chunk_length;
+	}
+}
+
+static void emit_bytes(
+	mirac_emitter_s* const emitter,
+	uint64_t* const position,
+	const void* const data,
+	const uint64_t length)
+{
+	mirac_debug_assert(position != mirac_null);
+
+	if (length > 0)
+	{
+		mirac_emitter_emit(emitter, (const char_t*)data, length);
+		*position += length;
+	}
+}
+
+static uint32_t append_name(
+	mirac_emitter_s* const table,
+	const mirac_string_view_s name)
+{
+	mirac_debug_assert(table != mirac_null);
+
+	const uint32_t offset = (uint32_t)table->length;
+
+	if (name.length > 0)
+	{
+		mirac_emitter_emit_string_view(table, name);
+	}
+
+	mirac_emitter_emit(table, g_zeros, 1);
+	return offset;
+}
@@ -0,0 +1,231 @@
+/**
+ * @file elf64_object.h
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-04-20
+ */
+
+#ifndef __mirac__source__mirac__archs__elf64_object_h__
+#define __mirac__source__mirac__archs__elf64_object_h__
+
+#include <mirac/c_common.h>
+#include <mirac/heap_array.h>
+#include <mirac/string_view.h>
+#include <mirac/arena.h>
+#include <mirac/emitter.h>
+
+#include <elf.h>
+
+/**
+ * @brief Handle of a section of an elf64 object (its index in the sections).
+ */
+typedef uint32_t elf64_section_t;
+
+/**
+ * @brief Handle that never refers to a section (the section of undefined
+ * symbols).
+ */
+#define elf64_section_none ((elf64_section_t)UINT32_MAX)
+
+/**
+ * @brief Handle of a symbol of an elf64 object (its index in the symbols, which
+ * is not its index in the written symbol table).
+ */
+typedef uint32_t elf64_symbol_t;
+
+/**
+ * @brief Handle that never refers to a symbol.
+ */
+#define elf64_symbol_none ((elf64_symbol_t)UINT32_MAX)
+
+typedef struct
+{
+	mirac_string_view_s name;
+	uint32_t type;         // note: SHT_PROGBITS or SHT_NOBITS.
+	uint64_t flags;        // note: SHF_* flags.
+	uint64_t alignment;
+	mirac_emitter_s data;  // note: bytes of a progbits section (without a file).
+	uint64_t nobits_size;  // note: size of a nobits section.
+} elf64_section_s;
+
+typedef struct
+{
+	mirac_string_view_s name;
+	elf64_section_t section; // note: elf64_section_none while it is undefined.
+	uint64_t value;
+	uint64_t size;
+	uint8_t type;            // note: STT_* type.
+	bool_t is_global;
+} elf64_symbol_s;
+
+typedef struct
+{
+	elf64_section_t section;
+	uint64_t offset;
+	uint32_t type;           // note: R_X86_64_* type.
+	elf64_symbol_t symbol;
+	int64_t addend;
+} elf64_relocation_s;
+
+mirac_define_heap_array_type(elf64_section_list, elf64_section_s);
+mirac_define_heap_array_type(elf64_symbol_list, elf64_symbol_s);
+mirac_define_heap_array_type(elf64_relocation_list, elf64_relocation_s);
+
+/**
+ * @brief Relocatable elf64 object, which is built up section by section and
+ * written out at once.
+ */
+typedef struct
+{
+	mirac_arena_s* arena;
+	elf64_section_list_s sections;
+	elf64_symbol_list_s symbols;
+	elf64_relocation_list_s relocations;
+} elf64_object_s;
+
+// todo: write unit tests!
+/**
+ * @brief Create elf64 object with provided arena.
+ * 
+ * @param arena arena reference
+ * 
+ * @return elf64_object_s
+ */
+elf64_object_s elf64_object_from_parts(
+	mirac_arena_s* const arena);
+
+// todo: write unit tests!
+/**
+ * @brief Get the section of the name, or add it (with the same attributes nasm
+ * gives the section of the name) if there is none yet.
+ * 
+ * @param object elf64 object instance
+ * @param name   name of the section
+ * 
+ * @return elf64_section_t
+ */
+elf64_section_t elf64_object_get_section(
+	elf64_object_s* const object,
+	const mirac_string_view_s name);
+
+// todo: write unit tests!
+/**
+ * @brief Get the current size of the section.
+ * 
+ * @param object  elf64 object instance
+ * @param section section handle
+ * 
+ * @return uint64_t
+ */
+uint64_t elf64_object_get_section_size(
+	const elf64_object_s* const object,
+	const elf64_section_t section);
+
+// todo: write unit tests!
+/**
+ * @brief Append the bytes to the section (or just grow a nobits section by
+ * their count).
+ * 
+ * @param object  elf64 object instance
+ * @param section section handle
+ * @param data    bytes to append (zeros, if mirac_null)
+ * @param length  number of bytes to append
+ * 
+ * @return uint64_t offset of the bytes in the section
+ */
+uint64_t elf64_object_append(
+	elf64_object_s* const object,
+	const elf64_section_t section,
+	const char_t* const data,
+	const uint64_t length);
+
+// todo: write unit tests!
+/**
+ * @brief Add an undefined symbol.
+ * 
+ * @param object    elf64 object instance
+ * @param name      name of the symbol
+ * @param type      STT_* type of the symbol
+ * @param is_global whether the symbol is global (or else local)
+ * 
+ * @return elf64_symbol_t
+ */
+elf64_symbol_t elf64_object_add_symbol(
+	elf64_object_s* const object,
+	const mirac_string_view_s name,
+	const uint8_t type,
+	const bool_t is_global);
+
+// todo: write unit tests!
+/**
+ * @brief Define the symbol at the offset in the section.
+ * 
+ * @param object  elf64 object instance
+ * @param symbol  symbol handle
+ * @param section section handle
+ * @param value   offset of the symbol in the section
+ * @param size    size of the symbol
+ */
+void elf64_object_define_symbol(
+	elf64_object_s* const object,
+	const elf64_symbol_t symbol,
+	const elf64_section_t section,
+	const uint64_t value,
+	const uint64_t size);
+
+// todo: write unit tests!
+/**
+ * @brief Add a relocation of the symbol at the offset in the section.
+ * 
+ * @param object  elf64 object instance
+ * @param section section handle
+ * @param offset  offset of the relocated field in the section
+ * @param type    R_X86_64_* type of the relocation
+ * @param symbol  symbol handle
+ * @param addend  addend of the relocation
+ */
+void elf64_object_add_relocation(
+	elf64_object_s* const object,
+	const elf64_section_t section,
+	const uint64_t offset,
+	const uint32_t type,
+	const elf64_symbol_t symbol,
+	const int64_t addend);
+
+// todo: write unit tests!
+/**
+ * @brief Write the object as an elf64 relocatable file.
+ * 
+ * @note The local symbols are written before the global ones (as elf requires),
+ * and the symbols that were never defined are written as global undefined ones,
+ * so that the linker reports them.
+ * 
+ * @param object  elf64 object instance
+ * @param emitter emitter to write into
+ */
+void elf64_object_write_relocatable(
+	elf64_object_s* const object,
+	mirac_emitter_s* const emitter);
+
+// todo: write unit tests!
+/**
+ * @brief Link the object into a static elf64 executable and write it.
+ * 
+ * @note The sections are laid out into the segments the way ld lays them out
+ * by default, the relocations are applied in place (so the object is not to be
+ * written again), and the references to undefined symbols are reported.
+ * 
+ * @param object  elf64 object instance
+ * @param entry   name of the symbol to start the execution at
+ * @param emitter emitter to write into
+ */
+void elf64_object_write_executable(
+	elf64_object_s* const object,
+	const mirac_string_view_s entry,
+	mirac_emitter_s* const emitter);
+
+#endif
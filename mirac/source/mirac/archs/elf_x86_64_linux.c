@@ -0,0 +1,871 @@
+/**
+ * @file elf_x86_64_linux.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-04-20
+ */
+
+#include "./elf_x86_64_linux.h"
+#include "./elf64_object.h"
+#include "./x86_64_encoder.h"
+#include "./x86_64_linux_lowering.h"
+
+#include <mirac/debug.h>
+#include <mirac/logger.h>
+
+/**
+ * @brief State of the compilation of a unit into an elf64 object.
+ */
+typedef struct
+{
+	mirac_compiler_s* compiler;
+	elf64_object_s object;
+	elf64_section_t section;    // note: section of the def being compiled.
+	mirac_emitter_s* code;      // note: bytes of the section of the def being compiled.
+	elf64_symbol_t* fun_symbols; // note: indexed by the indices of the defs.
+	elf64_symbol_t* mem_symbols;
+	elf64_symbol_t* str_symbols;
+	elf64_symbol_t ret_stack_rsp_symbol;
+	elf64_symbol_t ret_stack_symbol;
+	elf64_symbol_t ret_stack_end_symbol;
+} elf_x86_64_linux_context_s;
+
+// todo: write unit tests!
+// todo: document!
+static void elf_x86_64_linux_compile_ast_def_fun(
+	elf_x86_64_linux_context_s* const context,
+	const mirac_ast_def_s* const def);
+
+// todo: write unit tests!
+// todo: document!
+static void elf_x86_64_linux_compile_ast_def_mem(
+	elf_x86_64_linux_context_s* const context,
+	const mirac_ast_def_s* const def);
+
+// todo: write unit tests!
+// todo: document!
+static void elf_x86_64_linux_compile_ast_def_str(
+	elf_x86_64_linux_context_s* const context,
+	const mirac_ast_def_s* const def);
+
+// todo: write unit tests!
+// todo: document!
+static void elf_x86_64_linux_compile_ast_def(
+	elf_x86_64_linux_context_s* const context,
+	const mirac_ast_def_s* const def);
+
+/**
+ * @brief Get the symbol of the def, adding it on the first use.
+ * 
+ * @param context compilation context
+ * @param def     def to get the symbol of
+ * 
+ * @return elf64_symbol_t
+ */
+static elf64_symbol_t get_def_symbol(
+	elf_x86_64_linux_context_s* const context,
+	const mirac_ast_def_s* const def);
+
+/**
+ * @brief Get the symbol of the symbol operand, or of the address of the
+ * absolute memory operand.
+ * 
+ * @param context compilation context
+ * @param operand operand to get the symbol of
+ * 
+ * @return elf64_symbol_t
+ */
+static elf64_symbol_t get_operand_symbol(
+	elf_x86_64_linux_context_s* const context,
+	const x86_64_operand_s* const operand);
+
+/**
+ * @brief Encode the lowered instruction into the section of the def being
+ * compiled (comments and removed instructions encode to nothing).
+ * 
+ * @param context     compilation context
+ * @param instruction instruction to encode
+ * 
+ * @return uint64_t offset of the label, or of the displacement of the jump (0
+ * for the other instructions)
+ */
+static uint64_t encode_instruction(
+	elf_x86_64_linux_context_s* const context,
+	const x86_64_instruction_s* const instruction);
+
+/**
+ * @brief Encode the lowered operation, relocating its symbol operands.
+ * 
+ * @param context     compilation context
+ * @param instruction operation to encode
+ * 
+ * @return uint64_t offset of the displacement of the jump (0 for the other
+ * operations)
+ */
+static uint64_t encode_operation(
+	elf_x86_64_linux_context_s* const context,
+	const x86_64_instruction_s* const instruction);
+
+/**
+ * @brief Encode the instruction of an asm block.
+ * 
+ * @param code        emitter to encode into
+ * @param instruction text of the instruction
+ * 
+ * @return bool_t false, if the instruction is not supported
+ */
+static bool_t encode_asm_instruction(
+	mirac_emitter_s* const code,
+	mirac_string_view_s instruction);
+
+/**
+ * @brief Parse an operand of an asm instruction, which is either a 64 bit
+ * register or an integer.
+ * 
+ * @param operand   text of the operand
+ * @param reg       parsed register (x86_64_register_none, if it is an integer)
+ * @param immediate parsed integer
+ * 
+ * @return bool_t false, if the operand is neither
+ */
+static bool_t parse_asm_operand(
+	mirac_string_view_s operand,
+	x86_64_register_e* const reg,
+	int64_t* const immediate);
+
+void elf_x86_64_linux_compile_ast_unit(
+	mirac_compiler_s* const compiler)
+{
+	mirac_debug_assert(compiler != mirac_null);
+	mirac_debug_assert(compiler->config != mirac_null);
+	mirac_debug_assert(compiler->arena != mirac_null);
+	mirac_debug_assert(compiler->unit != mirac_null);
+	mirac_debug_assert(compiler->emitter.arena != mirac_null);
+
+	elf_x86_64_linux_context_s context = (elf_x86_64_linux_context_s)
+	{
+		.compiler = compiler,
+		.object   = elf64_object_from_parts(compiler->arena),
+		.section  = elf64_section_none,
+		.code     = mirac_null
+	};
+
+	// note: the symbols of the defs are looked up by the indices the parser gave
+	//       them among the defs of their type.
+	uint64_t counts[mirac_ast_def_type_none] = {0};
+
+	for (uint64_t def_index = 0; def_index < compiler->unit->defs.count; ++def_index)
+	{
+		const mirac_ast_def_s* const def = compiler->unit->defs.data[def_index];
+		mirac_debug_assert(def != mirac_null);
+		mirac_debug_assert(def->type < mirac_ast_def_type_none);
+
+		const uint64_t index = mirac_ast_def_type_fun == def->type ? def->as.fun_def.index :
+			(mirac_ast_def_type_mem == def->type ? def->as.mem_def.index : def->as.str_def.index);
+		counts[def->type] = index >= counts[def->type] ? (index + 1) : counts[def->type];
+	}
+
+	elf64_symbol_t** const symbols[mirac_ast_def_type_none] = { &context.fun_symbols, &context.mem_symbols, &context.str_symbols };
+
+	for (uint64_t type = 0; type < mirac_ast_def_type_none; ++type)
+	{
+		*symbols[type] = (elf64_symbol_t*)mirac_arena_malloc_as(compiler->arena,
+			(counts[type] + 1) * sizeof(elf64_symbol_t), mirac_arena_site_tables);
+		mirac_c_memset(*symbols[type], 0xff, (counts[type] + 1) * sizeof(elf64_symbol_t));
+	}
+
+	// todo(#001): this should be reworked to be more dynamic in regard to specific functions.
+	//             In other words - it should NOT be pre-hard-coded!
+	context.ret_stack_rsp_symbol = elf64_object_add_symbol(&context.object, mirac_string_view_from_cstring("__ret_stack_rsp"), STT_NOTYPE, false);
+	context.ret_stack_symbol = elf64_object_add_symbol(&context.object, mirac_string_view_from_cstring("__ret_stack"), STT_NOTYPE, false);
+	context.ret_stack_end_symbol = elf64_object_add_symbol(&context.object, mirac_string_view_from_cstring("__ret_stack_end"), STT_NOTYPE, false);
+
+	for (uint64_t def_index = 0; def_index < compiler->unit->defs.count; ++def_index)
+	{
+		mirac_debug_assert(compiler->unit->defs.data[def_index] != mirac_null);
+		elf_x86_64_linux_compile_ast_def(&context, compiler->unit->defs.data[def_index]);
+	}
+
+	const elf64_section_t bss = elf64_object_get_section(&context.object, mirac_string_view_from_cstring(".bss"));
+	elf64_object_define_symbol(&context.object, context.ret_stack_rsp_symbol, bss, elf64_object_append(&context.object, bss, mirac_null, 8), 0);
+	elf64_object_define_symbol(&context.object, context.ret_stack_symbol, bss, elf64_object_append(&context.object, bss, mirac_null, 4096), 0);
+	elf64_object_define_symbol(&context.object, context.ret_stack_end_symbol, bss, elf64_object_get_section_size(&context.object, bss), 0);
+
+	if (mirac_config_format_type_elf64_exec == compiler->config->format)
+	{
+		elf64_object_write_executable(&context.object, compiler->config->entry, &compiler->emitter);
+	}
+	else
+	{
+		elf64_object_write_relocatable(&context.object, &compiler->emitter);
+	}
+}
+
+static void elf_x86_64_linux_compile_ast_def_fun(
+	elf_x86_64_linux_context_s* const context,
+	const mirac_ast_def_s* const def)
+{
+	mirac_debug_assert(context != mirac_null);
+	mirac_debug_assert(context->code != mirac_null);
+	mirac_debug_assert(context->compiler->scratch != mirac_null);
+	mirac_debug_assert(def != mirac_null);
+	mirac_debug_assert(mirac_ast_def_type_fun == def->type);
+
+	mirac_compiler_s* const compiler = context->compiler;
+	mirac_emitter_s* const code = context->code;
+	const uint64_t begin = code->length;
+
+	x86_64_instruction_list_s instructions = x86_64_instruction_list_from_parts(compiler->scratch, 0);
+	x86_64_linux_lower_ast_def_fun(compiler, def, &instructions);
+	x86_64_instruction_list_resolve_labels(&instructions);
+
+	// note: the offsets of the labels and of the displacements of the jumps are
+	//       kept by the indices of their instructions, so that the jumps can be
+	//       patched once all the labels are encoded.
+	uint64_t* const offsets = (uint64_t*)mirac_arena_malloc(compiler->scratch, (instructions.count + 1) * sizeof(uint64_t));
+
+	for (uint64_t index = 0; index < instructions.count; ++index)
+	{
+		offsets[index] = encode_instruction(context, &instructions.data[index]);
+	}
+
+	for (uint64_t index = 0; index < instructions.count; ++index)
+	{
+		const x86_64_instruction_s* const instruction = &instructions.data[index];
+
+		if ((x86_64_instruction_type_operation == instruction->type) &&
+			((x86_64_mnemonic_jmp == instruction->mnemonic) || (x86_64_mnemonic_jcc == instruction->mnemonic)))
+		{
+			mirac_debug_assert(instruction->target < instructions.count);
+			x86_64_patch_displacement(code, offsets[index], offsets[instruction->target]);
+		}
+	}
+
+	// note: the code of the fun is all in the section now, so its instructions
+	//       are released right away instead of when the object is written.
+	mirac_arena_reset(compiler->scratch);
+
+	elf64_object_define_symbol(&context->object, get_def_symbol(context, def), context->section, begin, code->length - begin);
+}
+
+static void elf_x86_64_linux_compile_ast_def_mem(
+	elf_x86_64_linux_context_s* const context,
+	const mirac_ast_def_s* const def)
+{
+	mirac_debug_assert(context != mirac_null);
+	mirac_debug_assert(def != mirac_null);
+	mirac_debug_assert(mirac_ast_def_type_mem == def->type);
+
+	const mirac_ast_def_mem_s* const mem_def = &def->as.mem_def;
+	mirac_debug_assert(mem_def != mirac_null);
+
+	// note: outside of nobits sections the memory is zeroed (like nasm does).
+	const uint64_t offset = elf64_object_append(&context->object, context->section, mirac_null, mem_def->capacity.as.uval);
+	elf64_object_define_symbol(&context->object, get_def_symbol(context, def), context->section, offset, mem_def->capacity.as.uval);
+}
+
+static void elf_x86_64_linux_compile_ast_def_str(
+	elf_x86_64_linux_context_s* const context,
+	const mirac_ast_def_s* const def)
+{
+	mirac_debug_assert(context != mirac_null);
+	mirac_debug_assert(def != mirac_null);
+	mirac_debug_assert(mirac_ast_def_type_str == def->type);
+
+	const mirac_ast_def_str_s* const str_def = &def->as.str_def;
+	mirac_debug_assert(str_def != mirac_null);
+
+	const mirac_string_view_s literal = mirac_token_get_string(&str_def->literal);
+	const uint64_t offset = elf64_object_append(&context->object, context->section, literal.data, literal.length);
+	elf64_object_define_symbol(&context->object, get_def_symbol(context, def), context->section, offset, literal.length);
+}
+
+static void elf_x86_64_linux_compile_ast_def(
+	elf_x86_64_linux_context_s* const context,
+	const mirac_ast_def_s* const def)
+{
+	mirac_debug_assert(context != mirac_null);
+	mirac_debug_assert(def != mirac_null);
+
+	const mirac_compiler_s* const compiler = context->compiler;
+
+	if (compiler->config->strip && !def->is_used)
+	{
+		return;
+	}
+
+	const bool_t is_traced = (compiler->profile != mirac_null) && compiler->profile->profiler->is_tracing;
+	const uint64_t begin_time = is_traced ? mirac_profiler_now() : 0;
+
+	context->section = elf64_object_get_section(&context->object, mirac_token_get_ident(&def->section));
+	elf64_section_s* const section = &context->object.sections.data[context->section];
+	context->code = &section->data;
+
+	if ((SHT_NOBITS == section->type) && (def->type != mirac_ast_def_type_mem))
+	{
+		const mirac_token_s identifier = mirac_ast_def_get_identifier_token(def);
+		const mirac_location_s location = mirac_file_table_get_location(def->position);
+		mirac_logger_error(mirac_location_fmt ": " mirac_sv_fmt " def '" mirac_sv_fmt "' cannot be placed into the nobits section '"
+			mirac_sv_fmt "'.", mirac_location_arg(location), mirac_sv_arg(mirac_ast_def_type_to_string_view(def->type)),
+			mirac_sv_arg(mirac_token_get_ident(&identifier)), mirac_sv_arg(section->name));
+		mirac_c_exit(-1);
+	}
+
+	switch (def->type)
+	{
+		case mirac_ast_def_type_fun: { elf_x86_64_linux_compile_ast_def_fun(context, def); } break;
+		case mirac_ast_def_type_mem: { elf_x86_64_linux_compile_ast_def_mem(context, def); } break;
+		case mirac_ast_def_type_str: { elf_x86_64_linux_compile_ast_def_str(context, def); } break;
+
+		default:
+		{
+			mirac_debug_assert(0); // note: should never reach this block.
+		} break;
+	}
+
+	if (is_traced)
+	{
+		const mirac_token_s identifier = mirac_ast_def_get_identifier_token(def);
+		mirac_profiler_record_span(compiler->profile->profiler, "codegen",
+			mirac_token_get_ident(&identifier), begin_time);
+	}
+}
+
+static elf64_symbol_t get_def_symbol(
+	elf_x86_64_linux_context_s* const context,
+	const mirac_ast_def_s* const def)
+{
+	mirac_debug_assert(context != mirac_null);
+	mirac_debug_assert(def != mirac_null);
+
+	elf64_symbol_t* symbol = mirac_null;
+	uint8_t type = STT_OBJECT;
+	bool_t is_global = false;
+
+	switch (def->type)
+	{
+		case mirac_ast_def_type_fun:
+		{
+			symbol = &context->fun_symbols[def->as.fun_def.index];
+			type = STT_FUNC;
+			is_global = def->as.fun_def.is_entry;
+		} break;
+
+		case mirac_ast_def_type_mem: { symbol = &context->mem_symbols[def->as.mem_def.index]; } break;
+		case mirac_ast_def_type_str: { symbol = &context->str_symbols[def->as.str_def.index]; } break;
+
+		default:
+		{
+			mirac_debug_assert(0); // note: should never reach this block.
+		} break;
+	}
+
+	if (elf64_symbol_none == *symbol)
+	{
+		const mirac_token_s identifier = mirac_ast_def_get_identifier_token(def);
+		*symbol = elf64_object_add_symbol(&context->object, mirac_token_get_ident(&identifier), type, is_global);
+	}
+
+	return *symbol;
+}
+
+static elf64_symbol_t get_operand_symbol(
+	elf_x86_64_linux_context_s* const context,
+	const x86_64_operand_s* const operand)
+{
+	mirac_debug_assert(context != mirac_null);
+	mirac_debug_assert(operand != mirac_null);
+
+	if (operand->def != mirac_null)
+	{
+		return get_def_symbol(context, operand->def);
+	}
+
+	// todo(#001): this should be reworked as well, since it is part of #001 todo.
+	if (mirac_string_view_equal(operand->symbol, mirac_string_view_from_cstring("__ret_stack_rsp")))
+	{
+		return context->ret_stack_rsp_symbol;
+	}
+
+	if (mirac_string_view_equal(operand->symbol, mirac_string_view_from_cstring("__ret_stack_end")))
+	{
+		return context->ret_stack_end_symbol;
+	}
+
+	mirac_debug_assert(mirac_string_view_equal(operand->symbol, mirac_string_view_from_cstring("__ret_stack")));
+	return context->ret_stack_symbol;
+}
+
+static uint64_t encode_instruction(
+	elf_x86_64_linux_context_s* const context,
+	const x86_64_instruction_s* const instruction)
+{
+	mirac_debug_assert(context != mirac_null);
+	mirac_debug_assert(context->code != mirac_null);
+	mirac_debug_assert(instruction != mirac_null);
+
+	switch (instruction->type)
+	{
+		case x86_64_instruction_type_operation:
+		{
+			return encode_operation(context, instruction);
+		} break;
+
+		case x86_64_instruction_type_label:
+		{
+			return context->code->length;
+		} break;
+
+		case x86_64_instruction_type_opaque:
+		{
+			if (!encode_asm_instruction(context->code, instruction->text))
+			{
+				const mirac_location_s location = mirac_file_table_get_location(instruction->position);
+				mirac_logger_error(mirac_location_fmt ": instruction '" mirac_sv_fmt "' of the asm block is not supported by the '"
+					mirac_sv_fmt "' format (use the '" mirac_sv_fmt "' format for it).", mirac_location_arg(location), mirac_sv_arg(instruction->text),
+					mirac_sv_arg(mirac_config_format_type_to_string_view(mirac_config_format_type_elf64)),
+					mirac_sv_arg(mirac_config_format_type_to_string_view(mirac_config_format_type_nasm)));
+				mirac_c_exit(-1);
+			}
+		} break;
+
+		case x86_64_instruction_type_comment:
+		case x86_64_instruction_type_removed:
+		{
+		} break;
+
+		default:
+		{
+			mirac_debug_assert(0); // note: should never reach this block.
+		} break;
+	}
+
+	return 0;
+}
+
+static uint64_t encode_operation(
+	elf_x86_64_linux_context_s* const context,
+	const x86_64_instruction_s* const instruction)
+{
+	mirac_debug_assert(context != mirac_null);
+	mirac_debug_assert(context->code != mirac_null);
+	mirac_debug_assert(instruction != mirac_null);
+	mirac_debug_assert(x86_64_instruction_type_operation == instruction->type);
+
+	mirac_emitter_s* const code = context->code;
+	const x86_64_operand_s* const first = &instruction->operands[0];
+	const x86_64_operand_s* const second = &instruction->operands[1];
+
+	switch (instruction->mnemonic)
+	{
+		case x86_64_mnemonic_mov:
+		{
+			if ((x86_64_operand_type_memory == first->type) && (x86_64_register_none == first->reg))
+			{
+				mirac_debug_assert(x86_64_size_64 == first->size);
+				elf64_object_add_relocation(&context->object, context->section, x86_64_encode_store_absolute(code, 0, second->reg),
+					R_X86_64_32S, get_operand_symbol(context, first), 0);
+			}
+			else if (x86_64_operand_type_memory == first->type)
+			{
+				x86_64_encode_store(code, first->size, first->reg, second->reg);
+			}
+			else if ((x86_64_operand_type_memory == second->type) && (x86_64_register_none == second->reg))
+			{
+				mirac_debug_assert(x86_64_size_64 == second->size);
+				elf64_object_add_relocation(&context->object, context->section, x86_64_encode_load_absolute(code, first->reg, 0),
+					R_X86_64_32S, get_operand_symbol(context, second), 0);
+			}
+			else if (x86_64_operand_type_memory == second->type)
+			{
+				x86_64_encode_load(code, second->size, first->reg, second->reg);
+			}
+			else if (x86_64_operand_type_symbol == second->type)
+			{
+				elf64_object_add_relocation(&context->object, context->section, x86_64_encode_mov_register_immediate64(code, first->reg, 0),
+					R_X86_64_64, get_operand_symbol(context, second), 0);
+			}
+			else if (x86_64_operand_type_immediate == second->type)
+			{
+				x86_64_encode_mov_register_immediate(code, first->reg, (uint64_t)second->immediate);
+			}
+			else
+			{
+				mirac_debug_assert((x86_64_size_64 == first->size) && (x86_64_size_64 == second->size));
+				x86_64_encode_mov_register_register(code, first->reg, second->reg);
+			}
+		} break;
+
+		case x86_64_mnemonic_movzx:
+		{
+			if (x86_64_operand_type_memory == second->type)
+			{
+				x86_64_encode_load_zero_extended(code, second->size, first->reg, second->reg);
+			}
+			else
+			{
+				mirac_debug_assert(x86_64_size_08 == second->size);
+				x86_64_encode_zero_extend_byte(code, first->reg, second->reg);
+			}
+		} break;
+
+		case x86_64_mnemonic_push:
+		{
+			if (x86_64_operand_type_symbol == first->type)
+			{
+				// note: 'push imm32' of the address, which is sign extended (like nasm
+				//       does with 'push <ident>').
+				elf64_object_add_relocation(&context->object, context->section, x86_64_encode_push_immediate(code, 0),
+					R_X86_64_32S, get_operand_symbol(context, first), 0);
+			}
+			else if (x86_64_operand_type_immediate == first->type)
+			{
+				mirac_debug_assert((first->immediate >= INT32_MIN) && (first->immediate <= INT32_MAX));
+				(void)x86_64_encode_push_immediate(code, (int32_t)first->immediate);
+			}
+			else
+			{
+				x86_64_encode_push_register(code, first->reg);
+			}
+		} break;
+
+		case x86_64_mnemonic_pop:
+		{
+			x86_64_encode_pop_register(code, first->reg);
+		} break;
+
+		case x86_64_mnemonic_add:
+		case x86_64_mnemonic_sub:
+		case x86_64_mnemonic_and:
+		case x86_64_mnemonic_or:
+		case x86_64_mnemonic_xor:
+		case x86_64_mnemonic_cmp:
+		case x86_64_mnemonic_test:
+		{
+			const x86_64_binary_e binary =
+				x86_64_mnemonic_add == instruction->mnemonic ? x86_64_binary_add :
+				x86_64_mnemonic_sub == instruction->mnemonic ? x86_64_binary_sub :
+				x86_64_mnemonic_and == instruction->mnemonic ? x86_64_binary_and :
+				x86_64_mnemonic_or  == instruction->mnemonic ? x86_64_binary_or  :
+				x86_64_mnemonic_xor == instruction->mnemonic ? x86_64_binary_xor :
+				x86_64_mnemonic_cmp == instruction->mnemonic ? x86_64_binary_cmp : x86_64_binary_test;
+
+			if (x86_64_operand_type_immediate == second->type)
+			{
+				mirac_debug_assert((second->immediate >= INT32_MIN) && (second->immediate <= INT32_MAX));
+				x86_64_encode_binary_register_immediate(code, binary, first->reg, (int32_t)second->immediate);
+			}
+			else if (x86_64_size_32 == first->size)
+			{
+				// note: the only 32 bit one is the zeroing 'xor r32, r32'.
+				mirac_debug_assert((x86_64_binary_xor == binary) && (first->reg == second->reg));
+				x86_64_encode_clear_register(code, first->reg);
+			}
+			else
+			{
+				x86_64_encode_binary_register_register(code, binary, first->reg, second->reg);
+			}
+		} break;
+
+		case x86_64_mnemonic_imul:
+		{
+			x86_64_encode_imul_register_register(code, first->reg, second->reg);
+		} break;
+
+		case x86_64_mnemonic_mul:
+		case x86_64_mnemonic_div:
+		case x86_64_mnemonic_not:
+		case x86_64_mnemonic_inc:
+		case x86_64_mnemonic_dec:
+		case x86_64_mnemonic_shl:
+		case x86_64_mnemonic_shr:
+		{
+			const x86_64_unary_e unary =
+				x86_64_mnemonic_mul == instruction->mnemonic ? x86_64_unary_mul :
+				x86_64_mnemonic_div == instruction->mnemonic ? x86_64_unary_div :
+				x86_64_mnemonic_not == instruction->mnemonic ? x86_64_unary_not :
+				x86_64_mnemonic_inc == instruction->mnemonic ? x86_64_unary_inc :
+				x86_64_mnemonic_dec == instruction->mnemonic ? x86_64_unary_dec :
+				x86_64_mnemonic_shl == instruction->mnemonic ? x86_64_unary_shl : x86_64_unary_shr;
+
+			// note: the shifts are only ever by cl.
+			mirac_debug_assert(((unary != x86_64_unary_shl) && (unary != x86_64_unary_shr)) || (x86_64_register_rcx == second->reg));
+			x86_64_encode_unary(code, unary, first->reg);
+		} break;
+
+		case x86_64_mnemonic_cmovcc:
+		{
+			x86_64_encode_cmov(code, instruction->condition, first->reg, second->reg);
+		} break;
+
+		case x86_64_mnemonic_setcc:
+		{
+			x86_64_encode_set(code, instruction->condition, first->reg);
+		} break;
+
+		case x86_64_mnemonic_jmp:
+		{
+			return x86_64_encode_jmp(code, 0);
+		} break;
+
+		case x86_64_mnemonic_jcc:
+		{
+			return x86_64_encode_jcc(code, instruction->condition, 0);
+		} break;
+
+		case x86_64_mnemonic_call:
+		{
+			elf64_object_add_relocation(&context->object, context->section, x86_64_encode_call(code, 0),
+				R_X86_64_PC32, get_operand_symbol(context, first), -4);
+		} break;
+
+		case x86_64_mnemonic_ret:
+		{
+			static const uint8_t ret[] = { 0xc3 };
+			x86_64_encode_opcode(code, ret, sizeof(ret));
+		} break;
+
+		case x86_64_mnemonic_syscall:
+		{
+			static const uint8_t syscall[] = { 0x0f, 0x05 };
+			x86_64_encode_opcode(code, syscall, sizeof(syscall));
+		} break;
+
+		default:
+		{
+			mirac_debug_assert(0); // note: should never reach this block.
+		} break;
+	}
+
+	return 0;
+}
+
+static bool_t encode_asm_instruction(
+	mirac_emitter_s* const code,
+	mirac_string_view_s instruction)
+{
+	static const struct
+	{
+		mirac_string_view_s mnemonic;
+		uint8_t opcode[2];
+		uint8_t length;
+	} nullary[] =
+	{
+		{ mirac_string_view_static("nop"),     { 0x90 },       1 },
+		{ mirac_string_view_static("ret"),     { 0xc3 },       1 },
+		{ mirac_string_view_static("syscall"), { 0x0f, 0x05 }, 2 },
+	};
+
+	static const struct
+	{
+		mirac_string_view_s mnemonic;
+		x86_64_unary_e unary;
+	} unary[] =
+	{
+		{ mirac_string_view_static("inc"), x86_64_unary_inc },
+		{ mirac_string_view_static("dec"), x86_64_unary_dec },
+		{ mirac_string_view_static("not"), x86_64_unary_not },
+		{ mirac_string_view_static("neg"), x86_64_unary_neg },
+		{ mirac_string_view_static("mul"), x86_64_unary_mul },
+		{ mirac_string_view_static("div"), x86_64_unary_div },
+	};
+
+	static const struct
+	{
+		mirac_string_view_s mnemonic;
+		x86_64_binary_e binary;
+	} binary[] =
+	{
+		{ mirac_string_view_static("add"),  x86_64_binary_add  },
+		{ mirac_string_view_static("or"),   x86_64_binary_or   },
+		{ mirac_string_view_static("and"),  x86_64_binary_and  },
+		{ mirac_string_view_static("sub"),  x86_64_binary_sub  },
+		{ mirac_string_view_static("xor"),  x86_64_binary_xor  },
+		{ mirac_string_view_static("cmp"),  x86_64_binary_cmp  },
+		{ mirac_string_view_static("test"), x86_64_binary_test },
+	};
+
+	instruction = mirac_string_view_trim_left_white_space(instruction, mirac_null);
+	const mirac_string_view_s mnemonic = mirac_string_view_split_left_white_space(&instruction, mirac_null);
+
+	x86_64_register_e registers[2] = { x86_64_register_none, x86_64_register_none };
+	int64_t immediates[2] = {0};
+	uint64_t operands_count = 0;
+
+	while (mirac_string_view_trim_left_white_space(instruction, mirac_null).length > 0)
+	{
+		// note: the last operand is not followed by a comma, in which case the
+		//       split would return an empty string view, so it is taken as is.
+		uint64_t comma_index = 0;
+		while ((comma_index < instruction.length) && (instruction.data[comma_index] != ',')) { ++comma_index; }
+		const mirac_string_view_s operand = mirac_string_view_from_parts(instruction.data, comma_index);
+		instruction = comma_index < instruction.length ?
+			mirac_string_view_from_parts(instruction.data + comma_index + 1, instruction.length - comma_index - 1) :
+			mirac_string_view_from_parts(instruction.data + comma_index, 0);
+
+		if ((operands_count >= 2) || !parse_asm_operand(operand, &registers[operands_count], &immediates[operands_count]))
+		{
+			return false;
+		}
+
+		++operands_count;
+	}
+
+	if (0 == operands_count)
+	{
+		for (uint64_t index = 0; index < (sizeof(nullary) / sizeof(nullary[0])); ++index)
+		{
+			if (mirac_string_view_equal(mnemonic, nullary[index].mnemonic))
+			{
+				x86_64_encode_opcode(code, nullary[index].opcode, nullary[index].length);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	if (1 == operands_count)
+	{
+		if (mirac_string_view_equal(mnemonic, mirac_string_view_from_cstring("push")))
+		{
+			if (x86_64_register_none == registers[0])
+			{
+				if ((immediates[0] < INT32_MIN) || (immediates[0] > INT32_MAX)) { return false; }
+				(void)x86_64_encode_push_immediate(code, (int32_t)immediates[0]);
+			}
+			else
+			{
+				x86_64_encode_push_register(code, registers[0]);
+			}
+
+			return true;
+		}
+
+		if (x86_64_register_none == registers[0])
+		{
+			return false;
+		}
+
+		if (mirac_string_view_equal(mnemonic, mirac_string_view_from_cstring("pop")))
+		{
+			x86_64_encode_pop_register(code, registers[0]);
+			return true;
+		}
+
+		for (uint64_t index = 0; index < (sizeof(unary) / sizeof(unary[0])); ++index)
+		{
+			if (mirac_string_view_equal(mnemonic, unary[index].mnemonic))
+			{
+				x86_64_encode_unary(code, unary[index].unary, registers[0]);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	if (x86_64_register_none == registers[0])
+	{
+		return false;
+	}
+
+	if (mirac_string_view_equal(mnemonic, mirac_string_view_from_cstring("mov")))
+	{
+		if (x86_64_register_none == registers[1])
+		{
+			x86_64_encode_mov_register_immediate(code, registers[0], (uint64_t)immediates[1]);
+		}
+		else
+		{
+			x86_64_encode_mov_register_register(code, registers[0], registers[1]);
+		}
+
+		return true;
+	}
+
+	for (uint64_t index = 0; index < (sizeof(binary) / sizeof(binary[0])); ++index)
+	{
+		if (mirac_string_view_equal(mnemonic, binary[index].mnemonic))
+		{
+			if (x86_64_register_none == registers[1])
+			{
+				if ((immediates[1] < INT32_MIN) || (immediates[1] > INT32_MAX)) { return false; }
+				x86_64_encode_binary_register_immediate(code, binary[index].binary, registers[0], (int32_t)immediates[1]);
+			}
+			else
+			{
+				x86_64_encode_binary_register_register(code, binary[index].binary, registers[0], registers[1]);
+			}
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static bool_t parse_asm_operand(
+	mirac_string_view_s operand,
+	x86_64_register_e* const reg,
+	int64_t* const immediate)
+{
+	mirac_debug_assert(reg != mirac_null);
+	mirac_debug_assert(immediate != mirac_null);
+
+	operand = mirac_string_view_trim_left_white_space(operand, mirac_null);
+
+	while ((operand.length > 0) && ((' ' == operand.data[operand.length - 1]) || ('\t' == operand.data[operand.length - 1])))
+	{
+		--operand.length;
+	}
+
+	*reg = x86_64_register_from_string_view(operand);
+
+	if (*reg != x86_64_register_none)
+	{
+		return true;
+	}
+
+	const bool_t is_negative = (operand.length > 0) && ('-' == operand.data[0]);
+	uint64_t index = is_negative ? 1 : 0;
+	uint64_t base = 10;
+
+	if (((index + 2) < operand.length) && ('0' == operand.data[index]) && (('x' == operand.data[index + 1]) || ('X' == operand.data[index + 1])))
+	{
+		base = 16;
+		index += 2;
+	}
+
+	if (index >= operand.length)
+	{
+		return false;
+	}
+
+	uint64_t value = 0;
+
+	for (; index < operand.length; ++index)
+	{
+		const char_t digit = operand.data[index];
+		uint64_t digit_value = 0;
+
+		if ((digit >= '0') && (digit <= '9'))                    { digit_value = (uint64_t)(digit - '0'); }
+		else if ((16 == base) && (digit >= 'a') && (digit <= 'f')) { digit_value = (uint64_t)(digit - 'a') + 10; }
+		else if ((16 == base) && (digit >= 'A') && (digit <= 'F')) { digit_value = (uint64_t)(digit - 'A') + 10; }
+		else                                                       { return false; }
+
+		if (digit_value >= base)
+		{
+			return false;
+		}
+
+		value = (value * base) + digit_value;
+	}
+
+	*immediate = is_negative ? -(int64_t)value : (int64_t)value;
+	return true;
+}
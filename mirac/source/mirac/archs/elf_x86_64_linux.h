@@ -0,0 +1,32 @@
+/**
+ * @file elf_x86_64_linux.h
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-04-20
+ */
+
+#ifndef __mirac__source__mirac__archs__elf_x86_64_linux_h__
+#define __mirac__source__mirac__archs__elf_x86_64_linux_h__
+
+#include <mirac/compiler.h>
+
+// todo: write unit tests!
+/**
+ * @brief Compile the unit straight into an elf64 relocatable object, with the
+ * same instructions, sections, and symbols the nasm backend writes as text (or
+ * link it right away into a static elf64 executable, for the elf64-exec format).
+ * 
+ * @note The instructions of asm blocks are encoded by a small built-in
+ * assembler, which only knows the register and immediate forms of the most
+ * common instructions.
+ * 
+ * @param compiler compiler instance
+ */
+void elf_x86_64_linux_compile_ast_unit(
+	mirac_compiler_s* const compiler);
+
+#endif
@@ -0,0 +1,611 @@
+/**
+ * @file x86_64_encoder.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-04-20
+ */
+
+#include "./x86_64_encoder.h"
+
+#include <mirac/debug.h>
+#include <mirac/logger.h>
+
+static mirac_string_view_s g_register_names[x86_64_registers_count] =
+{
+	[x86_64_register_rax] = mirac_string_view_static("rax"),
+	[x86_64_register_rcx] = mirac_string_view_static("rcx"),
+	[x86_64_register_rdx] = mirac_string_view_static("rdx"),
+	[x86_64_register_rbx] = mirac_string_view_static("rbx"),
+	[x86_64_register_rsp] = mirac_string_view_static("rsp"),
+	[x86_64_register_rbp] = mirac_string_view_static("rbp"),
+	[x86_64_register_rsi] = mirac_string_view_static("rsi"),
+	[x86_64_register_rdi] = mirac_string_view_static("rdi"),
+	[x86_64_register_r8]  = mirac_string_view_static("r8"),
+	[x86_64_register_r9]  = mirac_string_view_static("r9"),
+	[x86_64_register_r10] = mirac_string_view_static("r10"),
+	[x86_64_register_r11] = mirac_string_view_static("r11"),
+	[x86_64_register_r12] = mirac_string_view_static("r12"),
+	[x86_64_register_r13] = mirac_string_view_static("r13"),
+	[x86_64_register_r14] = mirac_string_view_static("r14"),
+	[x86_64_register_r15] = mirac_string_view_static("r15"),
+};
+
+/**
+ * @brief Bytes of an instruction being encoded (the longest one is 'mov reg,
+ * imm64' at 10 bytes).
+ */
+typedef struct
+{
+	uint8_t bytes[16];
+	uint8_t length;
+} instruction_s;
+
+/**
+ * @brief Append a byte to the instruction.
+ * 
+ * @param instruction instruction to append to
+ * @param byte        byte to append
+ */
+static void push_byte(
+	instruction_s* const instruction,
+	const uint8_t byte);
+
+/**
+ * @brief Append a little endian value of the size to the instruction.
+ * 
+ * @param instruction instruction to append to
+ * @param value       value to append
+ * @param size        number of bytes of the value to append
+ */
+static void push_value(
+	instruction_s* const instruction,
+	const uint64_t value,
+	const uint8_t size);
+
+/**
+ * @brief Append the rex prefix, if the instruction needs one.
+ * 
+ * @param instruction instruction to append to
+ * @param is_wide     whether the operands are 64 bits wide (rex.w)
+ * @param reg         register in the reg field of modrm (or 0)
+ * @param rm          register in the rm field of modrm or in the opcode (or 0)
+ * @param is_forced   whether to append the prefix even if it is empty (which
+ *                    selects spl, bpl, sil and dil over ah, ch, dh and bh)
+ */
+static void push_rex(
+	instruction_s* const instruction,
+	const bool_t is_wide,
+	const uint8_t reg,
+	const uint8_t rm,
+	const bool_t is_forced);
+
+/**
+ * @brief Append modrm of a register operand.
+ * 
+ * @param instruction instruction to append to
+ * @param reg         register or opcode extension in the reg field
+ * @param rm          register in the rm field
+ */
+static void push_modrm_register(
+	instruction_s* const instruction,
+	const uint8_t reg,
+	const uint8_t rm);
+
+/**
+ * @brief Append modrm (and sib or displacement, if needed) of a '[base]'
+ * memory operand.
+ * 
+ * @param instruction instruction to append to
+ * @param reg         register or opcode extension in the reg field
+ * @param base        register with the address
+ */
+static void push_modrm_memory(
+	instruction_s* const instruction,
+	const uint8_t reg,
+	const uint8_t base);
+
+/**
+ * @brief Encode an instruction with the 'r/m64, r64' operands of two registers.
+ * 
+ * @param emitter     emitter to encode into
+ * @param opcode      opcode of the instruction
+ * @param destination destination register (in the rm field)
+ * @param source      source register (in the reg field)
+ */
+static void encode_register_register(
+	mirac_emitter_s* const emitter,
+	const uint8_t opcode,
+	const x86_64_register_e destination,
+	const x86_64_register_e source);
+
+/**
+ * @brief Append the instruction to the emitter.
+ * 
+ * @param emitter     emitter to append to
+ * @param instruction instruction to append
+ * 
+ * @return uint64_t offset of the instruction in the emitter
+ */
+static uint64_t emit_instruction(
+	mirac_emitter_s* const emitter,
+	const instruction_s* const instruction);
+
+x86_64_register_e x86_64_register_from_string_view(
+	const mirac_string_view_s name)
+{
+	for (uint64_t register_index = 0; register_index < x86_64_registers_count; ++register_index)
+	{
+		if (mirac_string_view_equal(name, g_register_names[register_index]))
+		{
+			return (x86_64_register_e)register_index;
+		}
+	}
+
+	return x86_64_register_none;
+}
+
+void x86_64_encode_opcode(
+	mirac_emitter_s* const emitter,
+	const uint8_t* const opcode,
+	const uint8_t length)
+{
+	mirac_debug_assert(emitter != mirac_null);
+	mirac_debug_assert(opcode != mirac_null);
+	mirac_emitter_emit(emitter, (const char_t*)opcode, length);
+}
+
+void x86_64_encode_push_register(
+	mirac_emitter_s* const emitter,
+	const x86_64_register_e source)
+{
+	mirac_debug_assert(source < x86_64_registers_count);
+	instruction_s instruction = {0};
+	push_rex(&instruction, false, 0, (uint8_t)source, false);
+	push_byte(&instruction, (uint8_t)(0x50 + (source & 7)));
+	(void)emit_instruction(emitter, &instruction);
+}
+
+uint64_t x86_64_encode_push_immediate(
+	mirac_emitter_s* const emitter,
+	const int32_t immediate)
+{
+	instruction_s instruction = {0};
+	push_byte(&instruction, 0x68);
+	push_value(&instruction, (uint64_t)(uint32_t)immediate, 4);
+	return emit_instruction(emitter, &instruction) + 1;
+}
+
+void x86_64_encode_pop_register(
+	mirac_emitter_s* const emitter,
+	const x86_64_register_e destination)
+{
+	mirac_debug_assert(destination < x86_64_registers_count);
+	instruction_s instruction = {0};
+	push_rex(&instruction, false, 0, (uint8_t)destination, false);
+	push_byte(&instruction, (uint8_t)(0x58 + (destination & 7)));
+	(void)emit_instruction(emitter, &instruction);
+}
+
+void x86_64_encode_mov_register_register(
+	mirac_emitter_s* const emitter,
+	const x86_64_register_e destination,
+	const x86_64_register_e source)
+{
+	encode_register_register(emitter, 0x89, destination, source);
+}
+
+void x86_64_encode_mov_register_immediate(
+	mirac_emitter_s* const emitter,
+	const x86_64_register_e destination,
+	const uint64_t immediate)
+{
+	mirac_debug_assert(destination < x86_64_registers_count);
+	instruction_s instruction = {0};
+
+	if (immediate <= UINT32_MAX)
+	{
+		// note: 'mov r32, imm32' zero extends into the whole register.
+		push_rex(&instruction, false, 0, (uint8_t)destination, false);
+		push_byte(&instruction, (uint8_t)(0xb8 + (destination & 7)));
+		push_value(&instruction, immediate, 4);
+	}
+	else if (((int64_t)immediate >= INT32_MIN) && ((int64_t)immediate < 0))
+	{
+		// note: 'mov r/m64, imm32' sign extends into the whole register.
+		push_rex(&instruction, true, 0, (uint8_t)destination, false);
+		push_byte(&instruction, 0xc7);
+		push_modrm_register(&instruction, 0, (uint8_t)destination);
+		push_value(&instruction, immediate, 4);
+	}
+	else
+	{
+		push_rex(&instruction, true, 0, (uint8_t)destination, false);
+		push_byte(&instruction, (uint8_t)(0xb8 + (destination & 7)));
+		push_value(&instruction, immediate, 8);
+	}
+
+	(void)emit_instruction(emitter, &instruction);
+}
+
+uint64_t x86_64_encode_mov_register_immediate64(
+	mirac_emitter_s* const emitter,
+	const x86_64_register_e destination,
+	const uint64_t immediate)
+{
+	mirac_debug_assert(destination < x86_64_registers_count);
+	instruction_s instruction = {0};
+	push_rex(&instruction, true, 0, (uint8_t)destination, false);
+	push_byte(&instruction, (uint8_t)(0xb8 + (destination & 7)));
+	push_value(&instruction, immediate, 8);
+	return emit_instruction(emitter, &instruction) + 2;
+}
+
+void x86_64_encode_load(
+	mirac_emitter_s* const emitter,
+	const x86_64_size_e size,
+	const x86_64_register_e destination,
+	const x86_64_register_e base)
+{
+	mirac_debug_assert(destination < x86_64_registers_count);
+	mirac_debug_assert(base < x86_64_registers_count);
+	instruction_s instruction = {0};
+
+	if (x86_64_size_16 == size)
+	{
+		push_byte(&instruction, 0x66);
+	}
+
+	const bool_t is_byte_register = (x86_64_size_08 == size) && (destination >= x86_64_register_rsp) && (destination <= x86_64_register_rdi);
+	push_rex(&instruction, x86_64_size_64 == size, (uint8_t)destination, (uint8_t)base, is_byte_register);
+	push_byte(&instruction, x86_64_size_08 == size ? 0x8a : 0x8b);
+	push_modrm_memory(&instruction, (uint8_t)destination, (uint8_t)base);
+	(void)emit_instruction(emitter, &instruction);
+}
+
+void x86_64_encode_store(
+	mirac_emitter_s* const emitter,
+	const x86_64_size_e size,
+	const x86_64_register_e base,
+	const x86_64_register_e source)
+{
+	mirac_debug_assert(base < x86_64_registers_count);
+	mirac_debug_assert(source < x86_64_registers_count);
+	instruction_s instruction = {0};
+
+	if (x86_64_size_16 == size)
+	{
+		push_byte(&instruction, 0x66);
+	}
+
+	const bool_t is_byte_register = (x86_64_size_08 == size) && (source >= x86_64_register_rsp) && (source <= x86_64_register_rdi);
+	push_rex(&instruction, x86_64_size_64 == size, (uint8_t)source, (uint8_t)base, is_byte_register);
+	push_byte(&instruction, x86_64_size_08 == size ? 0x88 : 0x89);
+	push_modrm_memory(&instruction, (uint8_t)source, (uint8_t)base);
+	(void)emit_instruction(emitter, &instruction);
+}
+
+void x86_64_encode_load_zero_extended(
+	mirac_emitter_s* const emitter,
+	const x86_64_size_e size,
+	const x86_64_register_e destination,
+	const x86_64_register_e base)
+{
+	mirac_debug_assert((x86_64_size_08 == size) || (x86_64_size_16 == size));
+	mirac_debug_assert(destination < x86_64_registers_count);
+	mirac_debug_assert(base < x86_64_registers_count);
+	instruction_s instruction = {0};
+	push_rex(&instruction, true, (uint8_t)destination, (uint8_t)base, false);
+	push_byte(&instruction, 0x0f);
+	push_byte(&instruction, x86_64_size_08 == size ? 0xb6 : 0xb7);
+	push_modrm_memory(&instruction, (uint8_t)destination, (uint8_t)base);
+	(void)emit_instruction(emitter, &instruction);
+}
+
+uint64_t x86_64_encode_load_absolute(
+	mirac_emitter_s* const emitter,
+	const x86_64_register_e destination,
+	const int32_t address)
+{
+	mirac_debug_assert(destination < x86_64_registers_count);
+	instruction_s instruction = {0};
+	push_rex(&instruction, true, (uint8_t)destination, 0, false);
+	push_byte(&instruction, 0x8b);
+	push_byte(&instruction, (uint8_t)(((destination & 7) << 3) | 0x04));
+	push_byte(&instruction, 0x25); // note: sib without base and index, so disp32 is absolute.
+	push_value(&instruction, (uint64_t)(uint32_t)address, 4);
+	return emit_instruction(emitter, &instruction) + 4;
+}
+
+uint64_t x86_64_encode_store_absolute(
+	mirac_emitter_s* const emitter,
+	const int32_t address,
+	const x86_64_register_e source)
+{
+	mirac_debug_assert(source < x86_64_registers_count);
+	instruction_s instruction = {0};
+	push_rex(&instruction, true, (uint8_t)source, 0, false);
+	push_byte(&instruction, 0x89);
+	push_byte(&instruction, (uint8_t)(((source & 7) << 3) | 0x04));
+	push_byte(&instruction, 0x25); // note: sib without base and index, so disp32 is absolute.
+	push_value(&instruction, (uint64_t)(uint32_t)address, 4);
+	return emit_instruction(emitter, &instruction) + 4;
+}
+
+void x86_64_encode_binary_register_register(
+	mirac_emitter_s* const emitter,
+	const x86_64_binary_e binary,
+	const x86_64_register_e destination,
+	const x86_64_register_e source)
+{
+	encode_register_register(emitter, (uint8_t)binary, destination, source);
+}
+
+void x86_64_encode_binary_register_immediate(
+	mirac_emitter_s* const emitter,
+	const x86_64_binary_e binary,
+	const x86_64_register_e destination,
+	const int32_t immediate)
+{
+	mirac_debug_assert(destination < x86_64_registers_count);
+	instruction_s instruction = {0};
+	push_rex(&instruction, true, 0, (uint8_t)destination, false);
+
+	if (x86_64_binary_test == binary)
+	{
+		push_byte(&instruction, 0xf7);
+		push_modrm_register(&instruction, 0, (uint8_t)destination);
+		push_value(&instruction, (uint64_t)(uint32_t)immediate, 4);
+	}
+	else if ((immediate >= INT8_MIN) && (immediate <= INT8_MAX))
+	{
+		push_byte(&instruction, 0x83);
+		push_modrm_register(&instruction, (uint8_t)(binary >> 3), (uint8_t)destination);
+		push_value(&instruction, (uint64_t)(uint32_t)immediate, 1);
+	}
+	else
+	{
+		push_byte(&instruction, 0x81);
+		push_modrm_register(&instruction, (uint8_t)(binary >> 3), (uint8_t)destination);
+		push_value(&instruction, (uint64_t)(uint32_t)immediate, 4);
+	}
+
+	(void)emit_instruction(emitter, &instruction);
+}
+
+void x86_64_encode_clear_register(
+	mirac_emitter_s* const emitter,
+	const x86_64_register_e destination)
+{
+	mirac_debug_assert(destination < x86_64_registers_count);
+	instruction_s instruction = {0};
+	push_rex(&instruction, false, (uint8_t)destination, (uint8_t)destination, false);
+	push_byte(&instruction, (uint8_t)x86_64_binary_xor);
+	push_modrm_register(&instruction, (uint8_t)destination, (uint8_t)destination);
+	(void)emit_instruction(emitter, &instruction);
+}
+
+void x86_64_encode_imul_register_register(
+	mirac_emitter_s* const emitter,
+	const x86_64_register_e destination,
+	const x86_64_register_e source)
+{
+	mirac_debug_assert(destination < x86_64_registers_count);
+	mirac_debug_assert(source < x86_64_registers_count);
+	instruction_s instruction = {0};
+	push_rex(&instruction, true, (uint8_t)destination, (uint8_t)source, false);
+	push_byte(&instruction, 0x0f);
+	push_byte(&instruction, 0xaf);
+	push_modrm_register(&instruction, (uint8_t)destination, (uint8_t)source);
+	(void)emit_instruction(emitter, &instruction);
+}
+
+void x86_64_encode_unary(
+	mirac_emitter_s* const emitter,
+	const x86_64_unary_e unary,
+	const x86_64_register_e operand)
+{
+	mirac_debug_assert(operand < x86_64_registers_count);
+	instruction_s instruction = {0};
+	push_rex(&instruction, true, 0, (uint8_t)operand, false);
+	push_byte(&instruction, (uint8_t)(unary >> 8));
+	push_modrm_register(&instruction, (uint8_t)(unary & 7), (uint8_t)operand);
+	(void)emit_instruction(emitter, &instruction);
+}
+
+void x86_64_encode_cmov(
+	mirac_emitter_s* const emitter,
+	const x86_64_condition_e condition,
+	const x86_64_register_e destination,
+	const x86_64_register_e source)
+{
+	mirac_debug_assert(destination < x86_64_registers_count);
+	mirac_debug_assert(source < x86_64_registers_count);
+	instruction_s instruction = {0};
+	push_rex(&instruction, true, (uint8_t)destination, (uint8_t)source, false);
+	push_byte(&instruction, 0x0f);
+	push_byte(&instruction, (uint8_t)(0x40 + condition));
+	push_modrm_register(&instruction, (uint8_t)destination, (uint8_t)source);
+	(void)emit_instruction(emitter, &instruction);
+}
+
+void x86_64_encode_set(
+	mirac_emitter_s* const emitter,
+	const x86_64_condition_e condition,
+	const x86_64_register_e destination)
+{
+	mirac_debug_assert(destination < x86_64_registers_count);
+	instruction_s instruction = {0};
+	push_rex(&instruction, false, 0, (uint8_t)destination, (destination >= x86_64_register_rsp) && (destination <= x86_64_register_rdi));
+	push_byte(&instruction, 0x0f);
+	push_byte(&instruction, (uint8_t)(0x90 + condition));
+	push_modrm_register(&instruction, 0, (uint8_t)destination);
+	(void)emit_instruction(emitter, &instruction);
+}
+
+void x86_64_encode_zero_extend_byte(
+	mirac_emitter_s* const emitter,
+	const x86_64_register_e destination,
+	const x86_64_register_e source)
+{
+	mirac_debug_assert(destination < x86_64_registers_count);
+	mirac_debug_assert(source < x86_64_registers_count);
+	instruction_s instruction = {0};
+	push_rex(&instruction, false, (uint8_t)destination, (uint8_t)source, (source >= x86_64_register_rsp) && (source <= x86_64_register_rdi));
+	push_byte(&instruction, 0x0f);
+	push_byte(&instruction, 0xb6);
+	push_modrm_register(&instruction, (uint8_t)destination, (uint8_t)source);
+	(void)emit_instruction(emitter, &instruction);
+}
+
+uint64_t x86_64_encode_jmp(
+	mirac_emitter_s* const emitter,
+	const int32_t displacement)
+{
+	instruction_s instruction = {0};
+	push_byte(&instruction, 0xe9);
+	push_value(&instruction, (uint64_t)(uint32_t)displacement, 4);
+	return emit_instruction(emitter, &instruction) + 1;
+}
+
+uint64_t x86_64_encode_jcc(
+	mirac_emitter_s* const emitter,
+	const x86_64_condition_e condition,
+	const int32_t displacement)
+{
+	instruction_s instruction = {0};
+	push_byte(&instruction, 0x0f);
+	push_byte(&instruction, (uint8_t)(0x80 + condition));
+	push_value(&instruction, (uint64_t)(uint32_t)displacement, 4);
+	return emit_instruction(emitter, &instruction) + 2;
+}
+
+uint64_t x86_64_encode_call(
+	mirac_emitter_s* const emitter,
+	const int32_t displacement)
+{
+	instruction_s instruction = {0};
+	push_byte(&instruction, 0xe8);
+	push_value(&instruction, (uint64_t)(uint32_t)displacement, 4);
+	return emit_instruction(emitter, &instruction) + 1;
+}
+
+void x86_64_patch_displacement(
+	mirac_emitter_s* const emitter,
+	const uint64_t offset,
+	const uint64_t target)
+{
+	mirac_debug_assert(emitter != mirac_null);
+	mirac_debug_assert((offset + 4) <= emitter->length);
+
+	const int64_t displacement = (int64_t)target - (int64_t)(offset + 4);
+
+	if ((displacement < INT32_MIN) || (displacement > INT32_MAX))
+	{
+		mirac_logger_error("internal failure -- jump displacement of %ld bytes does not fit into 32 bits.", displacement);
+		mirac_c_exit(-1);
+	}
+
+	const uint32_t value = (uint32_t)(int32_t)displacement;
+
+	for (uint8_t byte_index = 0; byte_index < 4; ++byte_index)
+	{
+		emitter->data[offset + byte_index] = (char_t)(uint8_t)(value >> (byte_index * 8));
+	}
+}
+
+static void push_byte(
+	instruction_s* const instruction,
+	const uint8_t byte)
+{
+	mirac_debug_assert(instruction != mirac_null);
+	mirac_debug_assert(instruction->length < sizeof(instruction->bytes));
+	instruction->bytes[instruction->length++] = byte;
+}
+
+static void push_value(
+	instruction_s* const instruction,
+	const uint64_t value,
+	const uint8_t size)
+{
+	for (uint8_t byte_index = 0; byte_index < size; ++byte_index)
+	{
+		push_byte(instruction, (uint8_t)(value >> (byte_index * 8)));
+	}
+}
+
+static void push_rex(
+	instruction_s* const instruction,
+	const bool_t is_wide,
+	const uint8_t reg,
+	const uint8_t rm,
+	const bool_t is_forced)
+{
+	const uint8_t rex = (uint8_t)(0x40 | (is_wide ? 0x08 : 0) | ((reg & 8) >> 1) | ((rm & 8) >> 3));
+
+	if ((rex != 0x40) || is_forced)
+	{
+		push_byte(instruction, rex);
+	}
+}
+
+static void push_modrm_register(
+	instruction_s* const instruction,
+	const uint8_t reg,
+	const uint8_t rm)
+{
+	push_byte(instruction, (uint8_t)(0xc0 | ((reg & 7) << 3) | (rm & 7)));
+}
+
+static void push_modrm_memory(
+	instruction_s* const instruction,
+	const uint8_t reg,
+	const uint8_t base)
+{
+	if (4 == (base & 7))
+	{
+		// note: rsp and r12 as a base can only be encoded with sib.
+		push_byte(instruction, (uint8_t)(((reg & 7) << 3) | 0x04));
+		push_byte(instruction, 0x24);
+	}
+	else if (5 == (base & 7))
+	{
+		// note: rbp and r13 as a base can only be encoded with a displacement.
+		push_byte(instruction, (uint8_t)(0x40 | ((reg & 7) << 3) | 0x05));
+		push_byte(instruction, 0x00);
+	}
+	else
+	{
+		push_byte(instruction, (uint8_t)(((reg & 7) << 3) | (base & 7)));
+	}
+}
+
+static void encode_register_register(
+	mirac_emitter_s* const emitter,
+	const uint8_t opcode,
+	const x86_64_register_e destination,
+	const x86_64_register_e source)
+{
+	mirac_debug_assert(destination < x86_64_registers_count);
+	mirac_debug_assert(source < x86_64_registers_count);
+	instruction_s instruction = {0};
+	push_rex(&instruction, true, (uint8_t)source, (uint8_t)destination, false);
+	push_byte(&instruction, opcode);
+	push_modrm_register(&instruction, (uint8_t)source, (uint8_t)destination);
+	(void)emit_instruction(emitter, &instruction);
+}
+
+static uint64_t emit_instruction(
+	mirac_emitter_s* const emitter,
+	const instruction_s* const instruction)
+{
+	mirac_debug_assert(emitter != mirac_null);
+	mirac_debug_assert(instruction != mirac_null);
+
+	const uint64_t offset = emitter->length;
+	mirac_emitter_emit(emitter, (const char_t*)instruction->bytes, instruction->length);
+	return offset;
+}
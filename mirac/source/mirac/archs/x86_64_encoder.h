@@ -0,0 +1,448 @@
+/**
+ * @file x86_64_encoder.h
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-04-20
+ */
+
+#ifndef __mirac__source__mirac__archs__x86_64_encoder_h__
+#define __mirac__source__mirac__archs__x86_64_encoder_h__
+
+#include <mirac/c_common.h>
+#include <mirac/emitter.h>
+
+// note: the instructions are encoded into emitters without a file, which keep
+//       all the emitted bytes, so that the returned offsets of the immediates and
+//       displacements can be patched or relocated later.
+
+/**
+ * @brief General purpose registers (in the order of their encodings).
+ */
+typedef enum
+{
+	x86_64_register_rax = 0,
+	x86_64_register_rcx,
+	x86_64_register_rdx,
+	x86_64_register_rbx,
+	x86_64_register_rsp,
+	x86_64_register_rbp,
+	x86_64_register_rsi,
+	x86_64_register_rdi,
+	x86_64_register_r8,
+	x86_64_register_r9,
+	x86_64_register_r10,
+	x86_64_register_r11,
+	x86_64_register_r12,
+	x86_64_register_r13,
+	x86_64_register_r14,
+	x86_64_register_r15,
+	x86_64_registers_count,
+
+	x86_64_register_none
+} x86_64_register_e;
+
+// todo: write unit tests!
+/**
+ * @brief Parse the name of a 64 bit register.
+ * 
+ * @param name name of the register
+ * 
+ * @return x86_64_register_e (x86_64_register_none if it is not a register)
+ */
+x86_64_register_e x86_64_register_from_string_view(
+	const mirac_string_view_s name);
+
+/**
+ * @brief Condition codes of the cmovcc, setcc and jcc instructions.
+ */
+typedef enum
+{
+	x86_64_condition_equal         = 0x4,
+	x86_64_condition_not_equal     = 0x5,
+	x86_64_condition_less          = 0xc,
+	x86_64_condition_greater_equal = 0xd,
+	x86_64_condition_less_equal    = 0xe,
+	x86_64_condition_greater       = 0xf
+} x86_64_condition_e;
+
+/**
+ * @brief Sizes of the memory operands of the loads and stores.
+ */
+typedef enum
+{
+	x86_64_size_08 = 1,
+	x86_64_size_16 = 2,
+	x86_64_size_32 = 4,
+	x86_64_size_64 = 8
+} x86_64_size_e;
+
+/**
+ * @brief Binary instructions (their values are the opcodes of the 'r/m64, r64'
+ * forms, which also hold the opcode extensions of the immediate forms).
+ */
+typedef enum
+{
+	x86_64_binary_add  = 0x01,
+	x86_64_binary_or   = 0x09,
+	x86_64_binary_and  = 0x21,
+	x86_64_binary_sub  = 0x29,
+	x86_64_binary_xor  = 0x31,
+	x86_64_binary_cmp  = 0x39,
+	x86_64_binary_test = 0x85
+} x86_64_binary_e;
+
+/**
+ * @brief Unary instructions (their values are the opcodes in the high byte and
+ * the opcode extensions in the low byte).
+ */
+typedef enum
+{
+	x86_64_unary_inc = 0xff00,
+	x86_64_unary_dec = 0xff01,
+	x86_64_unary_not = 0xf702,
+	x86_64_unary_neg = 0xf703,
+	x86_64_unary_mul = 0xf704,
+	x86_64_unary_div = 0xf706,
+	x86_64_unary_shl = 0xd304, // note: shifts by cl.
+	x86_64_unary_shr = 0xd305  // note: shifts by cl.
+} x86_64_unary_e;
+
+// todo: write unit tests!
+/**
+ * @brief Encode an instruction without operands (like nop, ret or syscall),
+ * given its opcode bytes.
+ * 
+ * @param emitter emitter to encode into
+ * @param opcode  opcode bytes
+ * @param length  number of opcode bytes
+ */
+void x86_64_encode_opcode(
+	mirac_emitter_s* const emitter,
+	const uint8_t* const opcode,
+	const uint8_t length);
+
+// todo: write unit tests!
+/**
+ * @brief Encode 'push reg'.
+ * 
+ * @param emitter emitter to encode into
+ * @param source  register to push
+ */
+void x86_64_encode_push_register(
+	mirac_emitter_s* const emitter,
+	const x86_64_register_e source);
+
+// todo: write unit tests!
+/**
+ * @brief Encode 'push imm32' (sign extended to 64 bits).
+ * 
+ * @param emitter   emitter to encode into
+ * @param immediate immediate to push
+ * 
+ * @return uint64_t offset of the immediate in the emitter
+ */
+uint64_t x86_64_encode_push_immediate(
+	mirac_emitter_s* const emitter,
+	const int32_t immediate);
+
+// todo: write unit tests!
+/**
+ * @brief Encode 'pop reg'.
+ * 
+ * @param emitter     emitter to encode into
+ * @param destination register to pop into
+ */
+void x86_64_encode_pop_register(
+	mirac_emitter_s* const emitter,
+	const x86_64_register_e destination);
+
+// todo: write unit tests!
+/**
+ * @brief Encode 'mov reg, reg'.
+ * 
+ * @param emitter     emitter to encode into
+ * @param destination destination register
+ * @param source      source register
+ */
+void x86_64_encode_mov_register_register(
+	mirac_emitter_s* const emitter,
+	const x86_64_register_e destination,
+	const x86_64_register_e source);
+
+// todo: write unit tests!
+/**
+ * @brief Encode 'mov reg, imm' in its shortest form (like nasm does).
+ * 
+ * @param emitter     emitter to encode into
+ * @param destination destination register
+ * @param immediate   immediate to move
+ */
+void x86_64_encode_mov_register_immediate(
+	mirac_emitter_s* const emitter,
+	const x86_64_register_e destination,
+	const uint64_t immediate);
+
+// todo: write unit tests!
+/**
+ * @brief Encode 'mov reg, imm64' (always with the full 64 bit immediate, so
+ * that it can be relocated).
+ * 
+ * @param emitter     emitter to encode into
+ * @param destination destination register
+ * @param immediate   immediate to move
+ * 
+ * @return uint64_t offset of the immediate in the emitter
+ */
+uint64_t x86_64_encode_mov_register_immediate64(
+	mirac_emitter_s* const emitter,
+	const x86_64_register_e destination,
+	const uint64_t immediate);
+
+// todo: write unit tests!
+/**
+ * @brief Encode 'mov reg, [base]' of the size (zero extending is left to the
+ * caller, as it is with the mov instruction).
+ * 
+ * @param emitter     emitter to encode into
+ * @param size        size of the memory operand
+ * @param destination destination register
+ * @param base        register with the address
+ */
+void x86_64_encode_load(
+	mirac_emitter_s* const emitter,
+	const x86_64_size_e size,
+	const x86_64_register_e destination,
+	const x86_64_register_e base);
+
+// todo: write unit tests!
+/**
+ * @brief Encode 'mov [base], reg' of the size.
+ * 
+ * @param emitter emitter to encode into
+ * @param size    size of the memory operand
+ * @param base    register with the address
+ * @param source  source register
+ */
+void x86_64_encode_store(
+	mirac_emitter_s* const emitter,
+	const x86_64_size_e size,
+	const x86_64_register_e base,
+	const x86_64_register_e source);
+
+// todo: write unit tests!
+/**
+ * @brief Encode 'movzx reg, [base]' of the size (8 or 16 bits, zero extended
+ * into the whole register).
+ * 
+ * @param emitter     emitter to encode into
+ * @param size        size of the memory operand
+ * @param destination destination register
+ * @param base        register with the address
+ */
+void x86_64_encode_load_zero_extended(
+	mirac_emitter_s* const emitter,
+	const x86_64_size_e size,
+	const x86_64_register_e destination,
+	const x86_64_register_e base);
+
+// todo: write unit tests!
+/**
+ * @brief Encode 'mov reg, [disp32]' (a 64 bit load from an absolute address).
+ * 
+ * @param emitter     emitter to encode into
+ * @param destination destination register
+ * @param address     absolute address
+ * 
+ * @return uint64_t offset of the address in the emitter
+ */
+uint64_t x86_64_encode_load_absolute(
+	mirac_emitter_s* const emitter,
+	const x86_64_register_e destination,
+	const int32_t address);
+
+// todo: write unit tests!
+/**
+ * @brief Encode 'mov [disp32], reg' (a 64 bit store to an absolute address).
+ * 
+ * @param emitter emitter to encode into
+ * @param address absolute address
+ * @param source  source register
+ * 
+ * @return uint64_t offset of the address in the emitter
+ */
+uint64_t x86_64_encode_store_absolute(
+	mirac_emitter_s* const emitter,
+	const int32_t address,
+	const x86_64_register_e source);
+
+// todo: write unit tests!
+/**
+ * @brief Encode a binary instruction on two registers ('op reg, reg').
+ * 
+ * @param emitter     emitter to encode into
+ * @param binary      binary instruction
+ * @param destination destination register
+ * @param source      source register
+ */
+void x86_64_encode_binary_register_register(
+	mirac_emitter_s* const emitter,
+	const x86_64_binary_e binary,
+	const x86_64_register_e destination,
+	const x86_64_register_e source);
+
+// todo: write unit tests!
+/**
+ * @brief Encode a binary instruction on a register and an immediate ('op reg,
+ * imm32', where the immediate is sign extended to 64 bits).
+ * 
+ * @param emitter     emitter to encode into
+ * @param binary      binary instruction
+ * @param destination destination register
+ * @param immediate   immediate operand
+ */
+void x86_64_encode_binary_register_immediate(
+	mirac_emitter_s* const emitter,
+	const x86_64_binary_e binary,
+	const x86_64_register_e destination,
+	const int32_t immediate);
+
+// todo: write unit tests!
+/**
+ * @brief Encode 'xor r32, r32' of the register with itself, which zeroes the
+ * whole register in its shortest form.
+ * 
+ * @param emitter     emitter to encode into
+ * @param destination register to zero
+ */
+void x86_64_encode_clear_register(
+	mirac_emitter_s* const emitter,
+	const x86_64_register_e destination);
+
+// todo: write unit tests!
+/**
+ * @brief Encode 'imul reg, reg'.
+ * 
+ * @param emitter     emitter to encode into
+ * @param destination destination register
+ * @param source      source register
+ */
+void x86_64_encode_imul_register_register(
+	mirac_emitter_s* const emitter,
+	const x86_64_register_e destination,
+	const x86_64_register_e source);
+
+// todo: write unit tests!
+/**
+ * @brief Encode a unary instruction on a register ('op reg').
+ * 
+ * @param emitter emitter to encode into
+ * @param unary   unary instruction
+ * @param operand operand register
+ */
+void x86_64_encode_unary(
+	mirac_emitter_s* const emitter,
+	const x86_64_unary_e unary,
+	const x86_64_register_e operand);
+
+// todo: write unit tests!
+/**
+ * @brief Encode 'cmovcc reg, reg'.
+ * 
+ * @param emitter     emitter to encode into
+ * @param condition   condition of the move
+ * @param destination destination register
+ * @param source      source register
+ */
+void x86_64_encode_cmov(
+	mirac_emitter_s* const emitter,
+	const x86_64_condition_e condition,
+	const x86_64_register_e destination,
+	const x86_64_register_e source);
+
+// todo: write unit tests!
+/**
+ * @brief Encode 'setcc reg8' (of the low byte of the register).
+ * 
+ * @param emitter     emitter to encode into
+ * @param condition   condition of the set
+ * @param destination destination register
+ */
+void x86_64_encode_set(
+	mirac_emitter_s* const emitter,
+	const x86_64_condition_e condition,
+	const x86_64_register_e destination);
+
+// todo: write unit tests!
+/**
+ * @brief Encode 'movzx r32, reg8' (of the low bytes of the registers), which
+ * zero extends the low byte of the source into the whole destination register.
+ * 
+ * @param emitter     emitter to encode into
+ * @param destination destination register
+ * @param source      source register
+ */
+void x86_64_encode_zero_extend_byte(
+	mirac_emitter_s* const emitter,
+	const x86_64_register_e destination,
+	const x86_64_register_e source);
+
+// todo: write unit tests!
+/**
+ * @brief Encode 'jmp rel32'.
+ * 
+ * @param emitter      emitter to encode into
+ * @param displacement displacement from the end of the instruction
+ * 
+ * @return uint64_t offset of the displacement in the emitter
+ */
+uint64_t x86_64_encode_jmp(
+	mirac_emitter_s* const emitter,
+	const int32_t displacement);
+
+// todo: write unit tests!
+/**
+ * @brief Encode 'jcc rel32'.
+ * 
+ * @param emitter      emitter to encode into
+ * @param condition    condition of the jump
+ * @param displacement displacement from the end of the instruction
+ * 
+ * @return uint64_t offset of the displacement in the emitter
+ */
+uint64_t x86_64_encode_jcc(
+	mirac_emitter_s* const emitter,
+	const x86_64_condition_e condition,
+	const int32_t displacement);
+
+// todo: write unit tests!
+/**
+ * @brief Encode 'call rel32'.
+ * 
+ * @param emitter      emitter to encode into
+ * @param displacement displacement from the end of the instruction
+ * 
+ * @return uint64_t offset of the displacement in the emitter
+ */
+uint64_t x86_64_encode_call(
+	mirac_emitter_s* const emitter,
+	const int32_t displacement);
+
+// todo: write unit tests!
+/**
+ * @brief Point the rel32 displacement at the offset to the target offset (both
+ * being offsets in the same emitter).
+ * 
+ * @param emitter emitter with the displacement
+ * @param offset  offset of the displacement
+ * @param target  offset of the target
+ */
+void x86_64_patch_displacement(
+	mirac_emitter_s* const emitter,
+	const uint64_t offset,
+	const uint64_t target);
+
+#endif
@@ -0,0 +1,863 @@
+/**
+ * @file x86_64_instruction.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-04-26
+ */
+
+#include "./x86_64_instruction.h"
+
+#include <mirac/debug.h>
+#include <mirac/logger.h>
+
+mirac_implement_heap_array_type(x86_64_instruction_list, x86_64_instruction_s);
+
+// note: the names of the registers by their sizes (64, 32, 16, and 8 bits).
+static const mirac_string_view_s g_register_names[x86_64_registers_count][4] =
+{
+	[x86_64_register_rax] = { mirac_string_view_static("rax"), mirac_string_view_static("eax"),  mirac_string_view_static("ax"),   mirac_string_view_static("al")   },
+	[x86_64_register_rcx] = { mirac_string_view_static("rcx"), mirac_string_view_static("ecx"),  mirac_string_view_static("cx"),   mirac_string_view_static("cl")   },
+	[x86_64_register_rdx] = { mirac_string_view_static("rdx"), mirac_string_view_static("edx"),  mirac_string_view_static("dx"),   mirac_string_view_static("dl")   },
+	[x86_64_register_rbx] = { mirac_string_view_static("rbx"), mirac_string_view_static("ebx"),  mirac_string_view_static("bx"),   mirac_string_view_static("bl")   },
+	[x86_64_register_rsp] = { mirac_string_view_static("rsp"), mirac_string_view_static("esp"),  mirac_string_view_static("sp"),   mirac_string_view_static("spl")  },
+	[x86_64_register_rbp] = { mirac_string_view_static("rbp"), mirac_string_view_static("ebp"),  mirac_string_view_static("bp"),   mirac_string_view_static("bpl")  },
+	[x86_64_register_rsi] = { mirac_string_view_static("rsi"), mirac_string_view_static("esi"),  mirac_string_view_static("si"),   mirac_string_view_static("sil")  },
+	[x86_64_register_rdi] = { mirac_string_view_static("rdi"), mirac_string_view_static("edi"),  mirac_string_view_static("di"),   mirac_string_view_static("dil")  },
+	[x86_64_register_r8]  = { mirac_string_view_static("r8"),  mirac_string_view_static("r8d"),  mirac_string_view_static("r8w"),  mirac_string_view_static("r8b")  },
+	[x86_64_register_r9]  = { mirac_string_view_static("r9"),  mirac_string_view_static("r9d"),  mirac_string_view_static("r9w"),  mirac_string_view_static("r9b")  },
+	[x86_64_register_r10] = { mirac_string_view_static("r10"), mirac_string_view_static("r10d"), mirac_string_view_static("r10w"), mirac_string_view_static("r10b") },
+	[x86_64_register_r11] = { mirac_string_view_static("r11"), mirac_string_view_static("r11d"), mirac_string_view_static("r11w"), mirac_string_view_static("r11b") },
+	[x86_64_register_r12] = { mirac_string_view_static("r12"), mirac_string_view_static("r12d"), mirac_string_view_static("r12w"), mirac_string_view_static("r12b") },
+	[x86_64_register_r13] = { mirac_string_view_static("r13"), mirac_string_view_static("r13d"), mirac_string_view_static("r13w"), mirac_string_view_static("r13b") },
+	[x86_64_register_r14] = { mirac_string_view_static("r14"), mirac_string_view_static("r14d"), mirac_string_view_static("r14w"), mirac_string_view_static("r14b") },
+	[x86_64_register_r15] = { mirac_string_view_static("r15"), mirac_string_view_static("r15d"), mirac_string_view_static("r15w"), mirac_string_view_static("r15b") },
+};
+
+static const mirac_string_view_s g_mnemonic_names[x86_64_mnemonics_count] =
+{
+	[x86_64_mnemonic_mov]     = mirac_string_view_static("mov"),
+	[x86_64_mnemonic_movzx]   = mirac_string_view_static("movzx"),
+	[x86_64_mnemonic_push]    = mirac_string_view_static("push"),
+	[x86_64_mnemonic_pop]     = mirac_string_view_static("pop"),
+	[x86_64_mnemonic_add]     = mirac_string_view_static("add"),
+	[x86_64_mnemonic_sub]     = mirac_string_view_static("sub"),
+	[x86_64_mnemonic_and]     = mirac_string_view_static("and"),
+	[x86_64_mnemonic_or]      = mirac_string_view_static("or"),
+	[x86_64_mnemonic_xor]     = mirac_string_view_static("xor"),
+	[x86_64_mnemonic_cmp]     = mirac_string_view_static("cmp"),
+	[x86_64_mnemonic_test]    = mirac_string_view_static("test"),
+	[x86_64_mnemonic_imul]    = mirac_string_view_static("imul"),
+	[x86_64_mnemonic_mul]     = mirac_string_view_static("mul"),
+	[x86_64_mnemonic_div]     = mirac_string_view_static("div"),
+	[x86_64_mnemonic_not]     = mirac_string_view_static("not"),
+	[x86_64_mnemonic_inc]     = mirac_string_view_static("inc"),
+	[x86_64_mnemonic_dec]     = mirac_string_view_static("dec"),
+	[x86_64_mnemonic_shl]     = mirac_string_view_static("shl"),
+	[x86_64_mnemonic_shr]     = mirac_string_view_static("shr"),
+	[x86_64_mnemonic_cmovcc]  = mirac_string_view_static("cmov"),
+	[x86_64_mnemonic_setcc]   = mirac_string_view_static("set"),
+	[x86_64_mnemonic_jmp]     = mirac_string_view_static("jmp"),
+	[x86_64_mnemonic_jcc]     = mirac_string_view_static("j"),
+	[x86_64_mnemonic_call]    = mirac_string_view_static("call"),
+	[x86_64_mnemonic_ret]     = mirac_string_view_static("ret"),
+	[x86_64_mnemonic_syscall] = mirac_string_view_static("syscall"),
+};
+
+/**
+ * @brief Buffer that the instructions are written into before they are emitted,
+ * so that the emitter is called once for a whole batch of lines instead of once
+ * for every word of them.
+ */
+typedef struct
+{
+	mirac_emitter_s* emitter;
+	uint64_t length;
+	char_t data[4096];
+} x86_64_printer_s;
+
+/**
+ * @brief Append the text to the printer's buffer (emitting the buffer first, if
+ * the text does not fit into what is left of it).
+ * 
+ * @param printer printer to append to
+ * @param data    text to append
+ * @param length  length of the text
+ */
+static void print_text(
+	x86_64_printer_s* const printer,
+	const char_t* const data,
+	const uint64_t length);
+
+/**
+ * @brief Append the string literal to the printer's buffer.
+ */
+#define print_static(_printer, _string)                                       \
+	print_text((_printer), (_string), sizeof(_string) - 1)
+
+/**
+ * @brief Append the string view to the printer's buffer.
+ */
+#define print_string_view(_printer, _string_view)                             \
+	print_text((_printer), (_string_view).data, (_string_view).length)
+
+/**
+ * @brief Append the digits of the unsigned integer to the printer's buffer.
+ * 
+ * @param printer printer to append to
+ * @param value   integer to append
+ */
+static void print_u64(
+	x86_64_printer_s* const printer,
+	const uint64_t value);
+
+/**
+ * @brief Emit what is in the printer's buffer.
+ * 
+ * @param printer printer to flush
+ */
+static void print_flush(
+	x86_64_printer_s* const printer);
+
+/**
+ * @brief Get the index of the size in the rows of the register names.
+ * 
+ * @param size size of the register
+ * 
+ * @return uint64_t
+ */
+static uint64_t get_size_index(
+	const x86_64_size_e size);
+
+/**
+ * @brief Get the suffix that the condition is written with after the mnemonic
+ * (the jumps on equality are written as the jumps on zero).
+ * 
+ * @param mnemonic  mnemonic of the operation
+ * @param condition condition of the operation
+ * 
+ * @return mirac_string_view_s
+ */
+static mirac_string_view_s get_condition_suffix(
+	const x86_64_mnemonic_e mnemonic,
+	const x86_64_condition_e condition);
+
+/**
+ * @brief Write the digits of the integer into the buffer.
+ * 
+ * @param value  integer to write
+ * @param digits buffer to write the digits into
+ * 
+ * @return uint64_t
+ */
+static uint64_t get_digits(
+	const uint64_t value,
+	char_t digits[20]);
+
+/**
+ * @brief Write the digits of the index of a label into the buffer (nothing for
+ * x86_64_label_no_index).
+ * 
+ * @param index  index of the label
+ * @param digits buffer to write the digits into
+ * 
+ * @return uint64_t
+ */
+static uint64_t get_index_digits(
+	const uint64_t index,
+	char_t digits[20]);
+
+/**
+ * @brief Hash the name of a label, or of a label symbol (the same hash as the
+ * one of the whole name, so that the words of the opaque instructions can be
+ * looked up as well).
+ * 
+ * @param name  name of the label, or the prefix of it
+ * @param index index that follows the name
+ * 
+ * @return uint64_t
+ */
+static uint64_t hash_label_name(
+	const mirac_string_view_s name,
+	const uint64_t index);
+
+/**
+ * @brief Check if the two names of labels, or label symbols, are the same once
+ * they are put together.
+ * 
+ * @param left_name   name of the left label, or the prefix of it
+ * @param left_index  index that follows the left name
+ * @param right_name  name of the right label, or the prefix of it
+ * @param right_index index that follows the right name
+ * 
+ * @return bool_t
+ */
+static bool_t label_names_equal(
+	const mirac_string_view_s left_name,
+	const uint64_t left_index,
+	const mirac_string_view_s right_name,
+	const uint64_t right_index);
+
+/**
+ * @brief Look up the labels of the name in the table, mark them as jumped to,
+ * and make them the target of the instruction if it is a jump.
+ * 
+ * @param instructions instruction list
+ * @param table        table of the indices of the labels
+ * @param capacity     capacity of the table
+ * @param instruction  instruction that names the label
+ * @param name         name of the label, or the prefix of it
+ * @param index        index that follows the name
+ */
+static void resolve_label_name(
+	x86_64_instruction_list_s* const instructions,
+	const uint64_t* const table,
+	const uint64_t capacity,
+	x86_64_instruction_s* const instruction,
+	const mirac_string_view_s name,
+	const uint64_t index);
+
+/**
+ * @brief Write the operand of the instruction in the nasm syntax.
+ * 
+ * @param instruction   instruction of the operand
+ * @param operand_index index of the operand
+ * @param printer       printer to write into
+ */
+static void print_operand(
+	const x86_64_instruction_s* const instruction,
+	const uint8_t operand_index,
+	x86_64_printer_s* const printer);
+
+x86_64_operand_s x86_64_operand_from_register(
+	const x86_64_register_e reg,
+	const x86_64_size_e size)
+{
+	mirac_debug_assert(reg < x86_64_registers_count);
+
+	return (x86_64_operand_s)
+	{
+		.type = x86_64_operand_type_register,
+		.reg  = reg,
+		.size = size
+	};
+}
+
+x86_64_operand_s x86_64_operand_from_immediate(
+	const int64_t immediate)
+{
+	return (x86_64_operand_s)
+	{
+		.type      = x86_64_operand_type_immediate,
+		.reg       = x86_64_register_none,
+		.immediate = immediate
+	};
+}
+
+x86_64_operand_s x86_64_operand_from_symbol(
+	const mirac_string_view_s symbol,
+	const mirac_ast_def_s* const def)
+{
+	mirac_debug_assert(symbol.length > 0);
+
+	return (x86_64_operand_s)
+	{
+		.type   = x86_64_operand_type_symbol,
+		.reg    = x86_64_register_none,
+		.symbol = symbol,
+		.index  = x86_64_label_no_index,
+		.def    = def
+	};
+}
+
+x86_64_operand_s x86_64_operand_from_label(
+	const mirac_string_view_s prefix,
+	const uint64_t index)
+{
+	x86_64_operand_s operand = x86_64_operand_from_symbol(prefix, mirac_null);
+	operand.index = index;
+	return operand;
+}
+
+x86_64_operand_s x86_64_operand_from_memory(
+	const x86_64_size_e size,
+	const x86_64_register_e base)
+{
+	mirac_debug_assert(base < x86_64_registers_count);
+
+	return (x86_64_operand_s)
+	{
+		.type = x86_64_operand_type_memory,
+		.reg  = base,
+		.size = size
+	};
+}
+
+x86_64_operand_s x86_64_operand_from_absolute(
+	const x86_64_size_e size,
+	const mirac_string_view_s symbol)
+{
+	mirac_debug_assert(symbol.length > 0);
+
+	return (x86_64_operand_s)
+	{
+		.type   = x86_64_operand_type_memory,
+		.reg    = x86_64_register_none,
+		.size   = size,
+		.symbol = symbol,
+		.index  = x86_64_label_no_index
+	};
+}
+
+x86_64_instruction_s x86_64_instruction_from_operation(
+	const x86_64_mnemonic_e mnemonic,
+	const x86_64_operand_s first,
+	const x86_64_operand_s second)
+{
+	mirac_debug_assert(mnemonic < x86_64_mnemonics_count);
+	mirac_debug_assert((first.type != x86_64_operand_type_none) || (x86_64_operand_type_none == second.type));
+
+	return (x86_64_instruction_s)
+	{
+		.type           = x86_64_instruction_type_operation,
+		.mnemonic       = mnemonic,
+		.operands_count = (uint8_t)((first.type != x86_64_operand_type_none) + (second.type != x86_64_operand_type_none)),
+		.operands       = { first, second },
+		.target         = UINT64_MAX
+	};
+}
+
+x86_64_instruction_s x86_64_instruction_from_condition(
+	const x86_64_mnemonic_e mnemonic,
+	const x86_64_condition_e condition,
+	const x86_64_operand_s first,
+	const x86_64_operand_s second)
+{
+	mirac_debug_assert((x86_64_mnemonic_cmovcc == mnemonic) || (x86_64_mnemonic_setcc == mnemonic) || (x86_64_mnemonic_jcc == mnemonic));
+
+	x86_64_instruction_s instruction = x86_64_instruction_from_operation(mnemonic, first, second);
+	instruction.condition = condition;
+	return instruction;
+}
+
+x86_64_instruction_s x86_64_instruction_from_label(
+	const mirac_string_view_s name,
+	const uint64_t index)
+{
+	mirac_debug_assert(name.length > 0);
+
+	return (x86_64_instruction_s)
+	{
+		.type   = x86_64_instruction_type_label,
+		.text   = name,
+		.index  = index,
+		.target = UINT64_MAX
+	};
+}
+
+x86_64_instruction_s x86_64_instruction_from_comment(
+	const mirac_string_view_s name,
+	const bool_t is_indented)
+{
+	return (x86_64_instruction_s)
+	{
+		.type        = x86_64_instruction_type_comment,
+		.text        = name,
+		.index       = x86_64_label_no_index,
+		.is_indented = is_indented,
+		.target      = UINT64_MAX
+	};
+}
+
+x86_64_instruction_s x86_64_instruction_from_opaque(
+	const mirac_string_view_s text,
+	const mirac_position_s position)
+{
+	return (x86_64_instruction_s)
+	{
+		.type     = x86_64_instruction_type_opaque,
+		.text     = text,
+		.position = position,
+		.target   = UINT64_MAX
+	};
+}
+
+mirac_string_view_s x86_64_mnemonic_to_string_view(
+	const x86_64_mnemonic_e mnemonic)
+{
+	mirac_debug_assert(mnemonic < x86_64_mnemonics_count);
+	return g_mnemonic_names[mnemonic];
+}
+
+void x86_64_instruction_list_resolve_labels(
+	x86_64_instruction_list_s* const instructions)
+{
+	mirac_debug_assert(instructions != mirac_null);
+
+	uint64_t labels_count = 0;
+
+	for (uint64_t index = 0; index < instructions->count; ++index)
+	{
+		instructions->data[index].target = UINT64_MAX;
+
+		if (x86_64_instruction_type_label == instructions->data[index].type)
+		{
+			++labels_count;
+		}
+	}
+
+	if (0 == labels_count)
+	{
+		return;
+	}
+
+	// note: the labels are looked up by name in an open addressing table, so
+	//       that resolving them stays linear in the size of the fun.
+	const uint64_t capacity = labels_count * 2;
+	uint64_t* const table = (uint64_t*)mirac_arena_malloc(instructions->arena, capacity * sizeof(uint64_t));
+
+	for (uint64_t slot_index = 0; slot_index < capacity; ++slot_index)
+	{
+		table[slot_index] = UINT64_MAX;
+	}
+
+	bool_t is_first_label = true;
+
+	for (uint64_t index = 0; index < instructions->count; ++index)
+	{
+		x86_64_instruction_s* const instruction = &instructions->data[index];
+
+		if (x86_64_instruction_type_label == instruction->type)
+		{
+			// note: the first label of the list is where the fun is called.
+			instruction->is_target = is_first_label;
+			is_first_label = false;
+
+			uint64_t slot_index = hash_label_name(instruction->text, instruction->index) % capacity;
+			while (table[slot_index] != UINT64_MAX) { slot_index = (slot_index + 1) % capacity; }
+			table[slot_index] = index;
+		}
+	}
+
+	for (uint64_t index = 0; index < instructions->count; ++index)
+	{
+		x86_64_instruction_s* const instruction = &instructions->data[index];
+
+		if (x86_64_instruction_type_operation == instruction->type)
+		{
+			for (uint8_t operand_index = 0; operand_index < instruction->operands_count; ++operand_index)
+			{
+				const x86_64_operand_s* const operand = &instruction->operands[operand_index];
+
+				if (x86_64_operand_type_symbol == operand->type)
+				{
+					resolve_label_name(instructions, table, capacity, instruction, operand->symbol, operand->index);
+				}
+			}
+		}
+		else if (x86_64_instruction_type_opaque == instruction->type)
+		{
+			// note: every word of the opaque instructions is looked up, as they
+			//       might name the labels as well.
+			const mirac_string_view_s text = instruction->text;
+			uint64_t word_begin = 0;
+
+			for (uint64_t char_index = 0; char_index <= text.length; ++char_index)
+			{
+				const char_t character = (char_index < text.length) ? text.data[char_index] : ' ';
+				const bool_t is_word = ((character >= 'a') && (character <= 'z')) || ((character >= 'A') && (character <= 'Z')) ||
+					((character >= '0') && (character <= '9')) || ('_' == character) || ('.' == character);
+
+				if (is_word)
+				{
+					continue;
+				}
+
+				if (char_index > word_begin)
+				{
+					resolve_label_name(instructions, table, capacity, instruction,
+						mirac_string_view_from_parts(text.data + word_begin, char_index - word_begin), x86_64_label_no_index);
+				}
+
+				word_begin = char_index + 1;
+			}
+		}
+	}
+}
+
+void x86_64_instruction_list_print(
+	const x86_64_instruction_list_s* const instructions,
+	mirac_emitter_s* const emitter)
+{
+	mirac_debug_assert(instructions != mirac_null);
+	mirac_debug_assert(emitter != mirac_null);
+
+	x86_64_printer_s printer = { .emitter = emitter, .length = 0 };
+
+	for (uint64_t index = 0; index < instructions->count; ++index)
+	{
+		const x86_64_instruction_s* const instruction = &instructions->data[index];
+
+		switch (instruction->type)
+		{
+			case x86_64_instruction_type_operation:
+			{
+				print_static(&printer, "\t");
+				print_string_view(&printer, g_mnemonic_names[instruction->mnemonic]);
+
+				if ((x86_64_mnemonic_cmovcc == instruction->mnemonic) || (x86_64_mnemonic_setcc == instruction->mnemonic) ||
+					(x86_64_mnemonic_jcc == instruction->mnemonic))
+				{
+					print_string_view(&printer, get_condition_suffix(instruction->mnemonic, instruction->condition));
+				}
+
+				for (uint8_t operand_index = 0; operand_index < instruction->operands_count; ++operand_index)
+				{
+					if (0 == operand_index)
+					{
+						print_static(&printer, " ");
+					}
+					else
+					{
+						print_static(&printer, ", ");
+					}
+
+					print_operand(instruction, operand_index, &printer);
+				}
+
+				print_static(&printer, "\n");
+			} break;
+
+			case x86_64_instruction_type_label:
+			{
+				print_string_view(&printer, instruction->text);
+
+				if (instruction->index != x86_64_label_no_index)
+				{
+					print_u64(&printer, instruction->index);
+				}
+
+				print_static(&printer, ":\n");
+			} break;
+
+			case x86_64_instruction_type_comment:
+			{
+				if (instruction->is_indented)
+				{
+					print_static(&printer, "\t");
+				}
+
+				print_static(&printer, ";; --- ");
+				print_string_view(&printer, instruction->text);
+				print_static(&printer, " --- \n");
+			} break;
+
+			case x86_64_instruction_type_opaque:
+			{
+				print_static(&printer, "\t");
+				print_string_view(&printer, instruction->text);
+				print_static(&printer, "\n");
+			} break;
+
+			case x86_64_instruction_type_removed:
+			{
+			} break;
+
+			default:
+			{
+				mirac_debug_assert(0); // note: should never reach this block.
+			} break;
+		}
+	}
+	print_flush(&printer);
+}
+
+static void print_text(
+	x86_64_printer_s* const printer,
+	const char_t* const data,
+	const uint64_t length)
+{
+	mirac_debug_assert(printer != mirac_null);
+	mirac_debug_assert(data != mirac_null);
+
+	if ((printer->length + length) > sizeof(printer->data))
+	{
+		print_flush(printer);
+
+		if (length > sizeof(printer->data))
+		{
+			mirac_emitter_emit(printer->emitter, data, length);
+			return;
+		}
+	}
+
+	for (uint64_t char_index = 0; char_index < length; ++char_index)
+	{
+		printer->data[printer->length + char_index] = data[char_index];
+	}
+
+	printer->length += length;
+}
+
+static void print_u64(
+	x86_64_printer_s* const printer,
+	const uint64_t value)
+{
+	char_t digits[20] = {0};
+	const uint64_t digits_count = get_digits(value, digits);
+	print_text(printer, digits, digits_count);
+}
+
+static void print_flush(
+	x86_64_printer_s* const printer)
+{
+	mirac_debug_assert(printer != mirac_null);
+
+	if (printer->length > 0)
+	{
+		mirac_emitter_emit(printer->emitter, printer->data, printer->length);
+		printer->length = 0;
+	}
+}
+
+static uint64_t get_size_index(
+	const x86_64_size_e size)
+{
+	switch (size)
+	{
+		case x86_64_size_64: { return 0; } break;
+		case x86_64_size_32: { return 1; } break;
+		case x86_64_size_16: { return 2; } break;
+		case x86_64_size_08: { return 3; } break;
+
+		default:
+		{
+			mirac_debug_assert(0); // note: should never reach this block.
+			return 0;
+		} break;
+	}
+}
+
+static mirac_string_view_s get_condition_suffix(
+	const x86_64_mnemonic_e mnemonic,
+	const x86_64_condition_e condition)
+{
+	switch (condition)
+	{
+		case x86_64_condition_equal:         { return x86_64_mnemonic_jcc == mnemonic ? mirac_string_view_from_cstring("z") : mirac_string_view_from_cstring("e");   } break;
+		case x86_64_condition_not_equal:     { return x86_64_mnemonic_jcc == mnemonic ? mirac_string_view_from_cstring("nz") : mirac_string_view_from_cstring("ne"); } break;
+		case x86_64_condition_less:          { return mirac_string_view_from_cstring("l");  } break;
+		case x86_64_condition_greater_equal: { return mirac_string_view_from_cstring("ge"); } break;
+		case x86_64_condition_less_equal:    { return mirac_string_view_from_cstring("le"); } break;
+		case x86_64_condition_greater:       { return mirac_string_view_from_cstring("g");  } break;
+
+		default:
+		{
+			mirac_debug_assert(0); // note: should never reach this block.
+			return mirac_string_view_from_parts("", 0);
+		} break;
+	}
+}
+
+static uint64_t get_digits(
+	const uint64_t value,
+	char_t digits[20])
+{
+	char_t reversed[20] = {0};
+	uint64_t digits_count = 0;
+	uint64_t remaining = value;
+
+	do
+	{
+		reversed[digits_count++] = (char_t)('0' + (remaining % 10));
+		remaining /= 10;
+	} while (remaining > 0);
+
+	for (uint64_t digit_index = 0; digit_index < digits_count; ++digit_index)
+	{
+		digits[digit_index] = reversed[digits_count - 1 - digit_index];
+	}
+
+	return digits_count;
+}
+
+static uint64_t get_index_digits(
+	const uint64_t index,
+	char_t digits[20])
+{
+	return x86_64_label_no_index == index ? 0 : get_digits(index, digits);
+}
+
+static uint64_t hash_label_name(
+	const mirac_string_view_s name,
+	const uint64_t index)
+{
+	char_t digits[20] = {0};
+	const uint64_t digits_count = get_index_digits(index, digits);
+	uint64_t hash = mirac_string_view_hash(name);
+
+	// note: the digits are hashed on from where the name left off, just like
+	//       mirac_string_view_hash would do for the whole name.
+	for (uint64_t digit_index = 0; digit_index < digits_count; ++digit_index)
+	{
+		hash ^= (uint8_t)digits[digit_index];
+		hash *= 0x00000100000001b3;
+	}
+
+	return hash;
+}
+
+static bool_t label_names_equal(
+	const mirac_string_view_s left_name,
+	const uint64_t left_index,
+	const mirac_string_view_s right_name,
+	const uint64_t right_index)
+{
+	if ((left_index == right_index) && mirac_string_view_equal(left_name, right_name))
+	{
+		return true;
+	}
+
+	char_t left_digits[20] = {0};
+	char_t right_digits[20] = {0};
+	const uint64_t left_length = left_name.length + get_index_digits(left_index, left_digits);
+	const uint64_t right_length = right_name.length + get_index_digits(right_index, right_digits);
+
+	if (left_length != right_length)
+	{
+		return false;
+	}
+
+	for (uint64_t char_index = 0; char_index < left_length; ++char_index)
+	{
+		const char_t left = (char_index < left_name.length) ? left_name.data[char_index] : left_digits[char_index - left_name.length];
+		const char_t right = (char_index < right_name.length) ? right_name.data[char_index] : right_digits[char_index - right_name.length];
+
+		if (left != right)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void resolve_label_name(
+	x86_64_instruction_list_s* const instructions,
+	const uint64_t* const table,
+	const uint64_t capacity,
+	x86_64_instruction_s* const instruction,
+	const mirac_string_view_s name,
+	const uint64_t index)
+{
+	mirac_debug_assert(instructions != mirac_null);
+	mirac_debug_assert(table != mirac_null);
+	mirac_debug_assert(instruction != mirac_null);
+
+	uint64_t slot_index = hash_label_name(name, index) % capacity;
+
+	while (table[slot_index] != UINT64_MAX)
+	{
+		x86_64_instruction_s* const label = &instructions->data[table[slot_index]];
+
+		if (label_names_equal(name, index, label->text, label->index))
+		{
+			label->is_target = true;
+
+			if ((x86_64_instruction_type_operation == instruction->type) &&
+				((x86_64_mnemonic_jmp == instruction->mnemonic) || (x86_64_mnemonic_jcc == instruction->mnemonic)))
+			{
+				instruction->target = table[slot_index];
+			}
+		}
+
+		slot_index = (slot_index + 1) % capacity;
+	}
+}
+
+static void print_operand(
+	const x86_64_instruction_s* const instruction,
+	const uint8_t operand_index,
+	x86_64_printer_s* const printer)
+{
+	mirac_debug_assert(instruction != mirac_null);
+	mirac_debug_assert(operand_index < instruction->operands_count);
+	mirac_debug_assert(printer != mirac_null);
+
+	const x86_64_operand_s* const operand = &instruction->operands[operand_index];
+
+	switch (operand->type)
+	{
+		case x86_64_operand_type_register:
+		{
+			print_string_view(printer, g_register_names[operand->reg][get_size_index(operand->size)]);
+		} break;
+
+		case x86_64_operand_type_immediate:
+		{
+			if (operand->immediate < 0)
+			{
+				print_static(printer, "-");
+				print_u64(printer, (uint64_t)0 - (uint64_t)operand->immediate);
+			}
+			else
+			{
+				print_u64(printer, (uint64_t)operand->immediate);
+			}
+		} break;
+
+		case x86_64_operand_type_symbol:
+		{
+			print_string_view(printer, operand->symbol);
+
+			if (operand->index != x86_64_label_no_index)
+			{
+				print_u64(printer, operand->index);
+			}
+		} break;
+
+		case x86_64_operand_type_memory:
+		{
+			// note: the size of the access is only written if the other operand
+			//       is not a register of the same size, which already tells it.
+			const x86_64_operand_s* const other = &instruction->operands[1 - operand_index];
+
+			if ((other->type != x86_64_operand_type_register) || (other->size != operand->size))
+			{
+				switch (operand->size)
+				{
+					case x86_64_size_08: { print_static(printer, "byte ");  } break;
+					case x86_64_size_16: { print_static(printer, "word ");  } break;
+					case x86_64_size_32: { print_static(printer, "dword "); } break;
+					case x86_64_size_64: { print_static(printer, "qword "); } break;
+
+					default:
+					{
+						mirac_debug_assert(0); // note: should never reach this block.
+					} break;
+				}
+			}
+
+			print_static(printer, "[");
+
+			if (operand->reg != x86_64_register_none)
+			{
+				print_string_view(printer, g_register_names[operand->reg][0]);
+			}
+			else
+			{
+				print_string_view(printer, operand->symbol);
+			}
+
+			print_static(printer, "]");
+		} break;
+
+		default:
+		{
+			mirac_debug_assert(0); // note: should never reach this block.
+		} break;
+	}
+}
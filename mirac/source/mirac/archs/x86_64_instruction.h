@@ -0,0 +1,307 @@
+/**
+ * @file x86_64_instruction.h
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-04-26
+ */
+
+#ifndef __mirac__source__mirac__archs__x86_64_instruction_h__
+#define __mirac__source__mirac__archs__x86_64_instruction_h__
+
+#include <mirac/c_common.h>
+#include <mirac/heap_array.h>
+#include <mirac/string_view.h>
+#include <mirac/arena.h>
+#include <mirac/emitter.h>
+#include <mirac/file_table.h>
+#include <mirac/parser.h>
+
+#include "./x86_64_encoder.h"
+
+// note: the instructions of a fun are selected once into an instruction list,
+//       which the peephole pass rewrites, and which is then either written as
+//       nasm code or encoded into machine code. The instructions of the asm
+//       blocks are kept as their text, and nothing is moved across them.
+//       The labels of the blocks and the comments are kept as the parts of
+//       their names, which are only put together when the list is written.
+
+/**
+ * @brief Index of the labels and the label symbols that are named by their
+ * name alone.
+ */
+#define x86_64_label_no_index UINT64_MAX
+
+/**
+ * @brief Mnemonics of the selected instructions (the cmovcc, setcc and jcc ones
+ * keep their condition next to the mnemonic).
+ */
+typedef enum
+{
+	x86_64_mnemonic_mov = 0,
+	x86_64_mnemonic_movzx,
+	x86_64_mnemonic_push,
+	x86_64_mnemonic_pop,
+	x86_64_mnemonic_add,
+	x86_64_mnemonic_sub,
+	x86_64_mnemonic_and,
+	x86_64_mnemonic_or,
+	x86_64_mnemonic_xor,
+	x86_64_mnemonic_cmp,
+	x86_64_mnemonic_test,
+	x86_64_mnemonic_imul,
+	x86_64_mnemonic_mul,
+	x86_64_mnemonic_div,
+	x86_64_mnemonic_not,
+	x86_64_mnemonic_inc,
+	x86_64_mnemonic_dec,
+	x86_64_mnemonic_shl,
+	x86_64_mnemonic_shr,
+	x86_64_mnemonic_cmovcc,
+	x86_64_mnemonic_setcc,
+	x86_64_mnemonic_jmp,
+	x86_64_mnemonic_jcc,
+	x86_64_mnemonic_call,
+	x86_64_mnemonic_ret,
+	x86_64_mnemonic_syscall,
+	x86_64_mnemonics_count
+} x86_64_mnemonic_e;
+
+typedef enum
+{
+	x86_64_operand_type_none = 0,
+	x86_64_operand_type_register,
+	x86_64_operand_type_immediate,
+	x86_64_operand_type_memory,
+	x86_64_operand_type_symbol
+} x86_64_operand_type_e;
+
+typedef struct
+{
+	x86_64_operand_type_e type;
+	x86_64_register_e reg;       // note: the register, or the base of a memory operand (x86_64_register_none if it is an absolute one).
+	x86_64_size_e size;          // note: size of a register operand, or of the access of a memory operand.
+	int64_t immediate;
+	mirac_string_view_s symbol;  // note: name of a symbol operand (a def or a label), or the address of an absolute memory operand.
+	uint64_t index;              // note: index that follows the name of a label symbol (x86_64_label_no_index if there is none).
+	const mirac_ast_def_s* def;  // note: def that the symbol names (null for the labels and the symbols of the backend).
+} x86_64_operand_s;
+
+/**
+ * @brief Operand of the instructions that take fewer than two of them.
+ */
+#define x86_64_operand_none ((x86_64_operand_s) { .type = x86_64_operand_type_none, .reg = x86_64_register_none })
+
+typedef enum
+{
+	x86_64_instruction_type_operation = 0,
+	x86_64_instruction_type_label,
+	x86_64_instruction_type_comment,
+	x86_64_instruction_type_opaque,  // note: instruction of an asm block.
+	x86_64_instruction_type_removed
+} x86_64_instruction_type_e;
+
+typedef struct
+{
+	x86_64_instruction_type_e type;
+	x86_64_mnemonic_e mnemonic;
+	x86_64_condition_e condition;
+	uint8_t operands_count;
+	x86_64_operand_s operands[2];
+	mirac_string_view_s text;   // note: name of a label (or the prefix of it), name of what a comment is about, or the instruction of an opaque one.
+	uint64_t index;             // note: index that follows the name of a label (x86_64_label_no_index if there is none).
+	mirac_position_s position;  // note: position of the asm block of an opaque instruction.
+	bool_t is_indented;         // note: whether a comment is indented like the instructions.
+	bool_t is_target;           // note: whether a label might be jumped to (it is set by resolving the labels).
+	uint64_t target;            // note: index of the label that a jump goes to, or UINT64_MAX if it is not in the list (it is set by resolving the labels).
+} x86_64_instruction_s;
+
+mirac_define_heap_array_type(x86_64_instruction_list, x86_64_instruction_s);
+
+// todo: write unit tests!
+/**
+ * @brief Create a register operand.
+ * 
+ * @param reg  register
+ * @param size size of the register
+ * 
+ * @return x86_64_operand_s
+ */
+x86_64_operand_s x86_64_operand_from_register(
+	const x86_64_register_e reg,
+	const x86_64_size_e size);
+
+// todo: write unit tests!
+/**
+ * @brief Create an immediate operand.
+ * 
+ * @param immediate immediate value
+ * 
+ * @return x86_64_operand_s
+ */
+x86_64_operand_s x86_64_operand_from_immediate(
+	const int64_t immediate);
+
+// todo: write unit tests!
+/**
+ * @brief Create a symbol operand, which stands for the address of a def or a
+ * label.
+ * 
+ * @param symbol name of the symbol
+ * @param def    def that the symbol names (or null)
+ * 
+ * @return x86_64_operand_s
+ */
+x86_64_operand_s x86_64_operand_from_symbol(
+	const mirac_string_view_s symbol,
+	const mirac_ast_def_s* const def);
+
+// todo: write unit tests!
+/**
+ * @brief Create a symbol operand, which stands for the address of a label of a
+ * block ('prefix' followed by the index).
+ * 
+ * @param prefix prefix of the name of the label
+ * @param index  index of the block
+ * 
+ * @return x86_64_operand_s
+ */
+x86_64_operand_s x86_64_operand_from_label(
+	const mirac_string_view_s prefix,
+	const uint64_t index);
+
+// todo: write unit tests!
+/**
+ * @brief Create a memory operand at the address in the base register ('[base]').
+ * 
+ * @param size size of the access
+ * @param base register with the address
+ * 
+ * @return x86_64_operand_s
+ */
+x86_64_operand_s x86_64_operand_from_memory(
+	const x86_64_size_e size,
+	const x86_64_register_e base);
+
+// todo: write unit tests!
+/**
+ * @brief Create a memory operand at the address of the symbol ('[symbol]').
+ * 
+ * @param size   size of the access
+ * @param symbol name of the symbol
+ * 
+ * @return x86_64_operand_s
+ */
+x86_64_operand_s x86_64_operand_from_absolute(
+	const x86_64_size_e size,
+	const mirac_string_view_s symbol);
+
+// todo: write unit tests!
+/**
+ * @brief Create an operation with up to two operands (x86_64_operand_none for
+ * the ones it does not take).
+ * 
+ * @param mnemonic mnemonic of the operation
+ * @param first    first operand
+ * @param second   second operand
+ * 
+ * @return x86_64_instruction_s
+ */
+x86_64_instruction_s x86_64_instruction_from_operation(
+	const x86_64_mnemonic_e mnemonic,
+	const x86_64_operand_s first,
+	const x86_64_operand_s second);
+
+// todo: write unit tests!
+/**
+ * @brief Create a cmovcc, setcc, or jcc operation.
+ * 
+ * @param mnemonic  mnemonic of the operation
+ * @param condition condition of the operation
+ * @param first     first operand
+ * @param second    second operand
+ * 
+ * @return x86_64_instruction_s
+ */
+x86_64_instruction_s x86_64_instruction_from_condition(
+	const x86_64_mnemonic_e mnemonic,
+	const x86_64_condition_e condition,
+	const x86_64_operand_s first,
+	const x86_64_operand_s second);
+
+// todo: write unit tests!
+/**
+ * @brief Create a label (named 'name' followed by the index, if it has one).
+ * 
+ * @param name  name of the label, or the prefix of it
+ * @param index index that follows the name (or x86_64_label_no_index)
+ * 
+ * @return x86_64_instruction_s
+ */
+x86_64_instruction_s x86_64_instruction_from_label(
+	const mirac_string_view_s name,
+	const uint64_t index);
+
+// todo: write unit tests!
+/**
+ * @brief Create a ';; --- name --- ' comment, which is only ever written out.
+ * 
+ * @param name        name of what the comment is about
+ * @param is_indented whether the comment is indented like the instructions
+ * 
+ * @return x86_64_instruction_s
+ */
+x86_64_instruction_s x86_64_instruction_from_comment(
+	const mirac_string_view_s name,
+	const bool_t is_indented);
+
+// todo: write unit tests!
+/**
+ * @brief Create an opaque instruction from the text of an asm block.
+ * 
+ * @param text     text of the instruction
+ * @param position position of the asm block
+ * 
+ * @return x86_64_instruction_s
+ */
+x86_64_instruction_s x86_64_instruction_from_opaque(
+	const mirac_string_view_s text,
+	const mirac_position_s position);
+
+// todo: write unit tests!
+/**
+ * @brief Get the name of the mnemonic (without the condition).
+ * 
+ * @param mnemonic mnemonic to get the name of
+ * 
+ * @return mirac_string_view_s
+ */
+mirac_string_view_s x86_64_mnemonic_to_string_view(
+	const x86_64_mnemonic_e mnemonic);
+
+// todo: write unit tests!
+/**
+ * @brief Mark the labels that might be jumped to (the rest are there only to be
+ * read, just like the comments), and find the labels that the jumps go to.
+ * 
+ * @param instructions instruction list
+ */
+void x86_64_instruction_list_resolve_labels(
+	x86_64_instruction_list_s* const instructions);
+
+// todo: write unit tests!
+/**
+ * @brief Write the instruction list as nasm code (one line per instruction, and
+ * nothing for the removed ones).
+ * 
+ * @param instructions instruction list to write
+ * @param emitter      emitter to write into
+ */
+void x86_64_instruction_list_print(
+	const x86_64_instruction_list_s* const instructions,
+	mirac_emitter_s* const emitter);
+
+#endif
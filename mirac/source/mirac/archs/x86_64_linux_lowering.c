@@ -0,0 +1,2164 @@
+/**
+ * @file x86_64_linux_lowering.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-04-26
+ */
+
+#include "./x86_64_linux_lowering.h"
+#include "./x86_64_peephole.h"
+
+#include <mirac/debug.h>
+#include <mirac/logger.h>
+
+/**
+ * @brief State of the lowering of a fun def.
+ */
+typedef struct
+{
+	mirac_compiler_s* compiler;
+	x86_64_instruction_list_s* instructions;
+} x86_64_linux_lowering_s;
+
+/**
+ * @brief Sized register operands that the lowering is written with.
+ */
+#define x86_64_linux_qword(_reg) x86_64_operand_from_register((_reg), x86_64_size_64)
+#define x86_64_linux_dword(_reg) x86_64_operand_from_register((_reg), x86_64_size_32)
+#define x86_64_linux_word(_reg)  x86_64_operand_from_register((_reg), x86_64_size_16)
+#define x86_64_linux_byte(_reg)  x86_64_operand_from_register((_reg), x86_64_size_08)
+
+// todo: write unit tests!
+// todo: document!
+static void x86_64_linux_lower_ast_block_expr(
+	x86_64_linux_lowering_s* const lowering,
+	const mirac_ast_block_t block);
+
+// todo: write unit tests!
+// todo: document!
+static void x86_64_linux_lower_ast_block_ident(
+	x86_64_linux_lowering_s* const lowering,
+	const mirac_ast_block_t block);
+
+// todo: write unit tests!
+// todo: document!
+static void x86_64_linux_lower_ast_block_call(
+	x86_64_linux_lowering_s* const lowering,
+	const mirac_ast_block_t block);
+
+// todo: write unit tests!
+// todo: document!
+static void x86_64_linux_lower_ast_block_scope(
+	x86_64_linux_lowering_s* const lowering,
+	const mirac_ast_block_t block);
+
+// todo: write unit tests!
+// todo: document!
+static void x86_64_linux_lower_ast_block_if(
+	x86_64_linux_lowering_s* const lowering,
+	const mirac_ast_block_t block);
+
+// todo: write unit tests!
+// todo: document!
+static void x86_64_linux_lower_ast_block_else(
+	x86_64_linux_lowering_s* const lowering,
+	const mirac_ast_block_t block);
+
+// todo: write unit tests!
+// todo: document!
+static void x86_64_linux_lower_ast_block_loop(
+	x86_64_linux_lowering_s* const lowering,
+	const mirac_ast_block_t block);
+
+// todo: write unit tests!
+// todo: document!
+static void x86_64_linux_lower_ast_block_asm(
+	x86_64_linux_lowering_s* const lowering,
+	const mirac_ast_block_t block);
+
+// todo: write unit tests!
+// todo: document!
+static void x86_64_linux_lower_ast_block(
+	x86_64_linux_lowering_s* const lowering,
+	const mirac_ast_block_t block);
+
+/**
+ * @brief Number of the cache registers, which is how many distinct values of
+ * the top stack slots the optimized code can keep out of the hardware stack.
+ */
+#define x86_64_linux_cache_registers_count 8
+
+// note: the cached expr blocks only use rax, rcx, and rdx as scratch registers,
+//       and the cache is spilled before the uncached ones (the syscalls, which
+//       take their arguments in some of the cache registers).
+static const x86_64_register_e g_cache_registers[x86_64_linux_cache_registers_count] =
+{
+	x86_64_register_rbx,
+	x86_64_register_r12,
+	x86_64_register_r13,
+	x86_64_register_r14,
+	x86_64_register_r15,
+	x86_64_register_r8,
+	x86_64_register_r9,
+	x86_64_register_r10,
+};
+
+/**
+ * @brief Effect of blocks on the depth of the stack, relative to the depth at
+ * which they start.
+ */
+typedef struct
+{
+	int64_t height;  // note: depth after the blocks.
+	int64_t lowest;  // note: lowest depth that the blocks read the stack at.
+	int64_t highest; // note: highest depth that the blocks grow the stack to.
+} x86_64_linux_stack_effect_s;
+
+/**
+ * @brief Push an operation with up to two operands to the instruction list.
+ * 
+ * @param lowering lowering state
+ * @param mnemonic mnemonic of the operation
+ * @param first    first operand (or x86_64_operand_none)
+ * @param second   second operand (or x86_64_operand_none)
+ */
+static void x86_64_linux_lower_operation(
+	x86_64_linux_lowering_s* const lowering,
+	const x86_64_mnemonic_e mnemonic,
+	const x86_64_operand_s first,
+	const x86_64_operand_s second);
+
+/**
+ * @brief Push a cmovcc, setcc, or jcc operation to the instruction list.
+ * 
+ * @param lowering  lowering state
+ * @param mnemonic  mnemonic of the operation
+ * @param condition condition of the operation
+ * @param first     first operand
+ * @param second    second operand (or x86_64_operand_none)
+ */
+static void x86_64_linux_lower_condition(
+	x86_64_linux_lowering_s* const lowering,
+	const x86_64_mnemonic_e mnemonic,
+	const x86_64_condition_e condition,
+	const x86_64_operand_s first,
+	const x86_64_operand_s second);
+
+/**
+ * @brief Push 'push reg' of the 64 bit register to the instruction list.
+ * 
+ * @param lowering lowering state
+ * @param reg      register to push
+ */
+static void x86_64_linux_lower_push(
+	x86_64_linux_lowering_s* const lowering,
+	const x86_64_register_e reg);
+
+/**
+ * @brief Push 'pop reg' of the 64 bit register to the instruction list.
+ * 
+ * @param lowering lowering state
+ * @param reg      register to pop
+ */
+static void x86_64_linux_lower_pop(
+	x86_64_linux_lowering_s* const lowering,
+	const x86_64_register_e reg);
+
+/**
+ * @brief Push a ';; --- name --- ' comment to the instruction list, unless the
+ * output is stripped.
+ * 
+ * @param lowering    lowering state
+ * @param is_indented whether the comment is indented like the instructions
+ * @param name        name of what the comment is about
+ */
+static void x86_64_linux_lower_comment(
+	x86_64_linux_lowering_s* const lowering,
+	const bool_t is_indented,
+	const mirac_string_view_s name);
+
+/**
+ * @brief Push a label of a block to the instruction list.
+ * 
+ * @param lowering lowering state
+ * @param prefix   prefix of the name of the label
+ * @param index    index of the block
+ */
+static void x86_64_linux_lower_label(
+	x86_64_linux_lowering_s* const lowering,
+	const mirac_string_view_s prefix,
+	const uint64_t index);
+
+/**
+ * @brief Push a jump to a label of a block to the instruction list.
+ * 
+ * @param lowering lowering state
+ * @param mnemonic jmp, or jcc (which jumps if the tested slot is zero)
+ * @param prefix   prefix of the name of the label
+ * @param index    index of the block
+ */
+static void x86_64_linux_lower_jump(
+	x86_64_linux_lowering_s* const lowering,
+	const x86_64_mnemonic_e mnemonic,
+	const mirac_string_view_s prefix,
+	const uint64_t index);
+
+/**
+ * @brief Get the cache register that holds the cached stack slot at the depth
+ * (0 for the top slot).
+ * 
+ * @param lowering lowering state
+ * @param depth    depth of the slot
+ * 
+ * @return x86_64_register_e
+ */
+static x86_64_register_e x86_64_linux_cache_get(
+	const x86_64_linux_lowering_s* const lowering,
+	const uint64_t depth);
+
+/**
+ * @brief Find a cache register that none of the cached slots in the range of
+ * the map holds.
+ * 
+ * @param lowering lowering state
+ * @param begin    first slot of the range (from the deepest one)
+ * @param end      end of the range
+ * 
+ * @return uint8_t (x86_64_linux_cache_registers_count if all of them are taken)
+ */
+static uint8_t x86_64_linux_cache_find_free(
+	const x86_64_linux_lowering_s* const lowering,
+	const uint64_t begin,
+	const uint64_t end);
+
+/**
+ * @brief Check if any other cached slot shares the register of the slot.
+ * 
+ * @param lowering   lowering state
+ * @param slot_index index of the slot in the map (from the deepest one)
+ * 
+ * @return bool_t
+ */
+static bool_t x86_64_linux_cache_is_shared(
+	const x86_64_linux_lowering_s* const lowering,
+	const uint64_t slot_index);
+
+/**
+ * @brief Push all the cached slots onto the hardware stack, so that it holds
+ * the whole stack again.
+ * 
+ * @note It has to be done before anything that reads the hardware stack or
+ * clobbers the cache registers (calls, syscalls, and asm blocks), and at the
+ * jumps into the labels whose cache state is not known to agree on all paths.
+ * 
+ * @param lowering lowering state
+ */
+static void x86_64_linux_cache_spill(
+	x86_64_linux_lowering_s* const lowering);
+
+/**
+ * @brief Push the deepest cached slot onto the hardware stack.
+ * 
+ * @param lowering lowering state
+ */
+static void x86_64_linux_cache_spill_deepest(
+	x86_64_linux_lowering_s* const lowering);
+
+/**
+ * @brief Pop the top stack slots from the hardware stack into the free cache
+ * registers until at least the count of them are cached.
+ * 
+ * @param lowering lowering state
+ * @param count    count of the slots to cache
+ */
+static void x86_64_linux_cache_fill(
+	x86_64_linux_lowering_s* const lowering,
+	const uint64_t count);
+
+/**
+ * @brief Take a free cache register for a new top stack slot, spilling the
+ * deepest cached slots until one of them is free.
+ * 
+ * @param lowering lowering state
+ * 
+ * @return x86_64_register_e
+ */
+static x86_64_register_e x86_64_linux_cache_push(
+	x86_64_linux_lowering_s* const lowering);
+
+/**
+ * @brief Push a copy of the stack slot at the depth as a new top slot, which
+ * shares the register of the copied slot (so no instruction is selected unless
+ * the slots have to be filled or spilled).
+ * 
+ * @param lowering lowering state
+ * @param depth    depth of the slot to copy
+ */
+static void x86_64_linux_cache_copy(
+	x86_64_linux_lowering_s* const lowering,
+	const uint64_t depth);
+
+/**
+ * @brief Give the cached stack slot at the depth a register of its own before
+ * it is written to, so that the slots that share its register keep their value.
+ * 
+ * @param lowering  lowering state
+ * @param depth     depth of the slot
+ * @param is_copied whether the new register has to get the value of the slot
+ * 
+ * @return x86_64_register_e
+ */
+static x86_64_register_e x86_64_linux_cache_own(
+	x86_64_linux_lowering_s* const lowering,
+	const uint64_t depth,
+	const bool_t is_copied);
+
+/**
+ * @brief Give every cached stack slot a register of its own, spilling the
+ * deepest slots if there are not enough registers for all of them.
+ * 
+ * @note Only moves and pushes are selected, so the flags are kept.
+ * 
+ * @param lowering lowering state
+ */
+static void x86_64_linux_cache_unshare(
+	x86_64_linux_lowering_s* const lowering);
+
+/**
+ * @brief Spill or fill the cache until exactly the count of the top stack slots
+ * are cached, each in a register of its own.
+ * 
+ * @param lowering lowering state
+ * @param count    count of the slots to cache
+ */
+static void x86_64_linux_cache_resize(
+	x86_64_linux_lowering_s* const lowering,
+	const uint64_t count);
+
+/**
+ * @brief Move the cached slots into the registers of the target cache, and
+ * spill or fill the ones that it caches fewer or more of.
+ * 
+ * @note It is done at the jumps into the labels that are entered with the target
+ * cache on the other paths. The stack has to be as deep as it was at the target
+ * cache, and none of the target's slots may share a register.
+ * 
+ * @param lowering lowering state
+ * @param target   target cache
+ */
+static void x86_64_linux_cache_normalize(
+	x86_64_linux_lowering_s* const lowering,
+	const mirac_compiler_cache_s* const target);
+
+/**
+ * @brief Apply the binary instruction to the second and the top cached slots,
+ * which leaves the result in the second one's register as the new top slot.
+ * 
+ * @param lowering lowering state
+ * @param mnemonic mnemonic of the instruction
+ */
+static void x86_64_linux_cache_binary(
+	x86_64_linux_lowering_s* const lowering,
+	const x86_64_mnemonic_e mnemonic);
+
+/**
+ * @brief Lower the expr block with its operands and results in the cache
+ * registers.
+ * 
+ * @param lowering   lowering state
+ * @param expr_block expr block to lower
+ * 
+ * @return bool_t (false if the expr block has to be lowered against the
+ * hardware stack)
+ */
+static bool_t x86_64_linux_lower_ast_block_expr_cached(
+	x86_64_linux_lowering_s* const lowering,
+	const mirac_ast_block_expr_s* const expr_block);
+
+/**
+ * @brief Test and drop the top stack slot for the jump of an if or a loop
+ * block.
+ * 
+ * @param lowering lowering state
+ */
+static void x86_64_linux_lower_cond_test(
+	x86_64_linux_lowering_s* const lowering);
+
+/**
+ * @brief Get how many stack slots the expr block reads and how many it leaves
+ * in their place.
+ * 
+ * @param token_type token type of the expr block
+ * @param inputs     count of the slots it reads
+ * @param outputs    count of the slots it leaves
+ * 
+ * @return bool_t (false if the effect is not known)
+ */
+static bool_t x86_64_linux_get_expr_effect(
+	const mirac_token_type_e token_type,
+	int64_t* const inputs,
+	int64_t* const outputs);
+
+/**
+ * @brief Simulate the depth of the stack through the block, and add its effect
+ * to the effect of the blocks before it.
+ * 
+ * @note Calls and asm blocks have effects that are not known here, and so do
+ * the branches that leave the stack at different depths.
+ * 
+ * @param compiler compiler instance
+ * @param block    block to simulate
+ * @param effect   effect to add to
+ * 
+ * @return bool_t (false if the effect is not known)
+ */
+static bool_t x86_64_linux_simulate_ast_block(
+	const mirac_compiler_s* const compiler,
+	const mirac_ast_block_t block,
+	x86_64_linux_stack_effect_s* const effect);
+
+void x86_64_linux_lower_ast_def_fun(
+	mirac_compiler_s* const compiler,
+	const mirac_ast_def_s* const def,
+	x86_64_instruction_list_s* const instructions)
+{
+	mirac_debug_assert(compiler != mirac_null);
+	mirac_debug_assert(compiler->config != mirac_null);
+	mirac_debug_assert(compiler->unit != mirac_null);
+	mirac_debug_assert(instructions != mirac_null);
+
+	mirac_debug_assert(def != mirac_null);
+	mirac_debug_assert(mirac_ast_def_type_fun == def->type);
+
+	const mirac_ast_def_fun_s* const fun_def = &def->as.fun_def;
+	mirac_debug_assert(fun_def != mirac_null);
+	mirac_debug_assert(mirac_ast_block_type_scope == mirac_ast_unit_get_block_type(compiler->unit, fun_def->body));
+
+	x86_64_linux_lowering_s lowering = (x86_64_linux_lowering_s)
+	{
+		.compiler     = compiler,
+		.instructions = instructions
+	};
+
+	const mirac_string_view_s ret_stack_rsp = mirac_string_view_from_cstring("__ret_stack_rsp");
+
+	// todo(#001): this should be reworked as well, since it is part of #001 todo.
+	if (fun_def->is_entry)
+	{
+		x86_64_linux_lower_comment(&lowering, false, mirac_string_view_from_cstring("entry"));
+		x86_64_instruction_list_push(instructions, x86_64_instruction_from_label(mirac_token_get_ident(&fun_def->identifier), x86_64_label_no_index));
+		x86_64_linux_lower_operation(&lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rax),
+			x86_64_operand_from_symbol(mirac_string_view_from_cstring("__ret_stack_end"), mirac_null));
+		x86_64_linux_lower_operation(&lowering, x86_64_mnemonic_mov, x86_64_operand_from_absolute(x86_64_size_64, ret_stack_rsp),
+			x86_64_linux_qword(x86_64_register_rax));
+	}
+	else
+	{
+		x86_64_linux_lower_comment(&lowering, false, mirac_string_view_from_cstring("fun"));
+		x86_64_instruction_list_push(instructions, x86_64_instruction_from_label(mirac_token_get_ident(&fun_def->identifier), x86_64_label_no_index));
+		x86_64_linux_lower_operation(&lowering, x86_64_mnemonic_mov, x86_64_operand_from_absolute(x86_64_size_64, ret_stack_rsp),
+			x86_64_linux_qword(x86_64_register_rsp));
+		x86_64_linux_lower_operation(&lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rsp),
+			x86_64_linux_qword(x86_64_register_rax));
+	}
+
+	mirac_debug_assert(0 == compiler->cache.count);
+	x86_64_linux_lower_ast_block(&lowering, fun_def->body);
+	x86_64_linux_cache_spill(&lowering);
+
+	if (!fun_def->is_entry)
+	{
+		x86_64_linux_lower_comment(&lowering, true, mirac_string_view_from_cstring("fun-ret"));
+		x86_64_linux_lower_operation(&lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rax),
+			x86_64_linux_qword(x86_64_register_rsp));
+		x86_64_linux_lower_operation(&lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rsp),
+			x86_64_operand_from_absolute(x86_64_size_64, ret_stack_rsp));
+		x86_64_linux_lower_operation(&lowering, x86_64_mnemonic_ret, x86_64_operand_none, x86_64_operand_none);
+	}
+
+	if (compiler->config->optimization >= 1)
+	{
+		(void)x86_64_peephole_optimize(instructions);
+	}
+}
+
+static void x86_64_linux_lower_ast_block_expr(
+	x86_64_linux_lowering_s* const lowering,
+	const mirac_ast_block_t block)
+{
+	mirac_debug_assert(lowering != mirac_null);
+
+	mirac_compiler_s* const compiler = lowering->compiler;
+	mirac_debug_assert(mirac_ast_block_type_expr == mirac_ast_unit_get_block_type(compiler->unit, block));
+
+	const mirac_ast_block_expr_s* const expr_block = &mirac_ast_unit_get_block_payload(compiler->unit, block)->as.expr_block;
+	mirac_debug_assert(expr_block != mirac_null);
+
+	x86_64_linux_lower_comment(lowering, true, mirac_token_type_to_string_view(expr_block->token_type));
+
+	// note: without optimizations nothing is ever cached, and every expr block
+	//       works on the hardware stack.
+	if (compiler->config->optimization >= 1)
+	{
+		if (x86_64_linux_lower_ast_block_expr_cached(lowering, expr_block))
+		{
+			return;
+		}
+
+		x86_64_linux_cache_spill(lowering);
+	}
+
+	switch (expr_block->token_type)
+	{
+		case mirac_token_type_reserved_lnot:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_cmp, x86_64_linux_qword(x86_64_register_rax), x86_64_operand_from_immediate(0));
+			x86_64_linux_lower_condition(lowering, x86_64_mnemonic_setcc, x86_64_condition_equal, x86_64_linux_byte(x86_64_register_rax), x86_64_operand_none);
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+		} break;
+
+		case mirac_token_type_reserved_land:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rbx);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_and, x86_64_linux_qword(x86_64_register_rax), x86_64_linux_qword(x86_64_register_rbx));
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+		} break;
+
+		case mirac_token_type_reserved_lor:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rbx);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_or, x86_64_linux_qword(x86_64_register_rax), x86_64_linux_qword(x86_64_register_rbx));
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+		} break;
+
+		case mirac_token_type_reserved_lxor:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rbx);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_xor, x86_64_linux_qword(x86_64_register_rax), x86_64_linux_qword(x86_64_register_rbx));
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+		} break;
+
+		case mirac_token_type_reserved_bnot:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_not, x86_64_linux_qword(x86_64_register_rax), x86_64_operand_none);
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+		} break;
+
+		case mirac_token_type_reserved_band:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rbx);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_and, x86_64_linux_qword(x86_64_register_rax), x86_64_linux_qword(x86_64_register_rbx));
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+		} break;
+
+		case mirac_token_type_reserved_bor:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rbx);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_or, x86_64_linux_qword(x86_64_register_rax), x86_64_linux_qword(x86_64_register_rbx));
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+		} break;
+
+		case mirac_token_type_reserved_bxor:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rbx);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_xor, x86_64_linux_qword(x86_64_register_rax), x86_64_linux_qword(x86_64_register_rbx));
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+		} break;
+
+		case mirac_token_type_reserved_shl:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rcx);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rbx);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_shl, x86_64_linux_qword(x86_64_register_rbx), x86_64_linux_byte(x86_64_register_rcx));
+			x86_64_linux_lower_push(lowering, x86_64_register_rbx);
+		} break;
+
+		case mirac_token_type_reserved_shr:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rcx);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rbx);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_shr, x86_64_linux_qword(x86_64_register_rbx), x86_64_linux_byte(x86_64_register_rcx));
+			x86_64_linux_lower_push(lowering, x86_64_register_rbx);
+		} break;
+
+		case mirac_token_type_reserved_add:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rbx);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_add, x86_64_linux_qword(x86_64_register_rax), x86_64_linux_qword(x86_64_register_rbx));
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+		} break;
+
+		case mirac_token_type_reserved_inc:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_inc, x86_64_linux_qword(x86_64_register_rax), x86_64_operand_none);
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+		} break;
+
+		case mirac_token_type_reserved_sub:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rbx);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_sub, x86_64_linux_qword(x86_64_register_rax), x86_64_linux_qword(x86_64_register_rbx));
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+		} break;
+
+		case mirac_token_type_reserved_dec:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_dec, x86_64_linux_qword(x86_64_register_rax), x86_64_operand_none);
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+		} break;
+
+		case mirac_token_type_reserved_mul:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rbx);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mul, x86_64_linux_qword(x86_64_register_rbx), x86_64_operand_none);
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+		} break;
+
+		case mirac_token_type_reserved_div:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rcx);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rdx), x86_64_operand_from_immediate(0));
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_div, x86_64_linux_qword(x86_64_register_rcx), x86_64_operand_none);
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+		} break;
+
+		case mirac_token_type_reserved_mod:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rcx);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rdx), x86_64_operand_from_immediate(0));
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_div, x86_64_linux_qword(x86_64_register_rcx), x86_64_operand_none);
+			x86_64_linux_lower_push(lowering, x86_64_register_rdx);
+		} break;
+
+		case mirac_token_type_reserved_divmod:
+		{
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_xor, x86_64_linux_qword(x86_64_register_rdx), x86_64_linux_qword(x86_64_register_rdx));
+			x86_64_linux_lower_pop(lowering, x86_64_register_rbx);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_div, x86_64_linux_qword(x86_64_register_rbx), x86_64_operand_none);
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+			x86_64_linux_lower_push(lowering, x86_64_register_rdx);
+		} break;
+
+		case mirac_token_type_reserved_eq:
+		{
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rcx), x86_64_operand_from_immediate(0));
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rdx), x86_64_operand_from_immediate(1));
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rbx);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_cmp, x86_64_linux_qword(x86_64_register_rax), x86_64_linux_qword(x86_64_register_rbx));
+			x86_64_linux_lower_condition(lowering, x86_64_mnemonic_cmovcc, x86_64_condition_equal, x86_64_linux_qword(x86_64_register_rcx), x86_64_linux_qword(x86_64_register_rdx));
+			x86_64_linux_lower_push(lowering, x86_64_register_rcx);
+		} break;
+
+		case mirac_token_type_reserved_neq:
+		{
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rcx), x86_64_operand_from_immediate(1));
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rdx), x86_64_operand_from_immediate(0));
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rbx);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_cmp, x86_64_linux_qword(x86_64_register_rax), x86_64_linux_qword(x86_64_register_rbx));
+			x86_64_linux_lower_condition(lowering, x86_64_mnemonic_cmovcc, x86_64_condition_equal, x86_64_linux_qword(x86_64_register_rcx), x86_64_linux_qword(x86_64_register_rdx));
+			x86_64_linux_lower_push(lowering, x86_64_register_rcx);
+		} break;
+
+		case mirac_token_type_reserved_gt:
+		{
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rcx), x86_64_operand_from_immediate(0));
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rdx), x86_64_operand_from_immediate(1));
+			x86_64_linux_lower_pop(lowering, x86_64_register_rbx);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_cmp, x86_64_linux_qword(x86_64_register_rax), x86_64_linux_qword(x86_64_register_rbx));
+			x86_64_linux_lower_condition(lowering, x86_64_mnemonic_cmovcc, x86_64_condition_greater, x86_64_linux_qword(x86_64_register_rcx), x86_64_linux_qword(x86_64_register_rdx));
+			x86_64_linux_lower_push(lowering, x86_64_register_rcx);
+		} break;
+
+		case mirac_token_type_reserved_gteq:
+		{
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rcx), x86_64_operand_from_immediate(0));
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rdx), x86_64_operand_from_immediate(1));
+			x86_64_linux_lower_pop(lowering, x86_64_register_rbx);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_cmp, x86_64_linux_qword(x86_64_register_rax), x86_64_linux_qword(x86_64_register_rbx));
+			x86_64_linux_lower_condition(lowering, x86_64_mnemonic_cmovcc, x86_64_condition_greater_equal, x86_64_linux_qword(x86_64_register_rcx), x86_64_linux_qword(x86_64_register_rdx));
+			x86_64_linux_lower_push(lowering, x86_64_register_rcx);
+		} break;
+
+		case mirac_token_type_reserved_ls:
+		{
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rcx), x86_64_operand_from_immediate(0));
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rdx), x86_64_operand_from_immediate(1));
+			x86_64_linux_lower_pop(lowering, x86_64_register_rbx);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_cmp, x86_64_linux_qword(x86_64_register_rax), x86_64_linux_qword(x86_64_register_rbx));
+			x86_64_linux_lower_condition(lowering, x86_64_mnemonic_cmovcc, x86_64_condition_less, x86_64_linux_qword(x86_64_register_rcx), x86_64_linux_qword(x86_64_register_rdx));
+			x86_64_linux_lower_push(lowering, x86_64_register_rcx);
+		} break;
+
+		case mirac_token_type_reserved_lseq:
+		{
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rcx), x86_64_operand_from_immediate(0));
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rdx), x86_64_operand_from_immediate(1));
+			x86_64_linux_lower_pop(lowering, x86_64_register_rbx);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_cmp, x86_64_linux_qword(x86_64_register_rax), x86_64_linux_qword(x86_64_register_rbx));
+			x86_64_linux_lower_condition(lowering, x86_64_mnemonic_cmovcc, x86_64_condition_less_equal, x86_64_linux_qword(x86_64_register_rcx), x86_64_linux_qword(x86_64_register_rdx));
+			x86_64_linux_lower_push(lowering, x86_64_register_rcx);
+		} break;
+
+		case mirac_token_type_reserved_drop:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+		} break;
+
+		case mirac_token_type_reserved_dup:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+		} break;
+
+		case mirac_token_type_reserved_over:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rbx);
+			x86_64_linux_lower_push(lowering, x86_64_register_rbx);
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+			x86_64_linux_lower_push(lowering, x86_64_register_rbx);
+		} break;
+
+		case mirac_token_type_reserved_rot:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rbx);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rcx);
+			x86_64_linux_lower_push(lowering, x86_64_register_rbx);
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+			x86_64_linux_lower_push(lowering, x86_64_register_rcx);
+		} break;
+
+		case mirac_token_type_reserved_swap:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rbx);
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+			x86_64_linux_lower_push(lowering, x86_64_register_rbx);
+		} break;
+
+		case mirac_token_type_reserved_ld08:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_xor, x86_64_linux_qword(x86_64_register_rbx), x86_64_linux_qword(x86_64_register_rbx));
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_byte(x86_64_register_rbx), x86_64_operand_from_memory(x86_64_size_08, x86_64_register_rax));
+			x86_64_linux_lower_push(lowering, x86_64_register_rbx);
+		} break;
+
+		case mirac_token_type_reserved_ld16:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_xor, x86_64_linux_qword(x86_64_register_rbx), x86_64_linux_qword(x86_64_register_rbx));
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_word(x86_64_register_rbx), x86_64_operand_from_memory(x86_64_size_16, x86_64_register_rax));
+			x86_64_linux_lower_push(lowering, x86_64_register_rbx);
+		} break;
+
+		case mirac_token_type_reserved_ld32:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_xor, x86_64_linux_qword(x86_64_register_rbx), x86_64_linux_qword(x86_64_register_rbx));
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_dword(x86_64_register_rbx), x86_64_operand_from_memory(x86_64_size_32, x86_64_register_rax));
+			x86_64_linux_lower_push(lowering, x86_64_register_rbx);
+		} break;
+
+		case mirac_token_type_reserved_ld64:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_xor, x86_64_linux_qword(x86_64_register_rbx), x86_64_linux_qword(x86_64_register_rbx));
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rbx), x86_64_operand_from_memory(x86_64_size_64, x86_64_register_rax));
+			x86_64_linux_lower_push(lowering, x86_64_register_rbx);
+		} break;
+
+		case mirac_token_type_reserved_st08:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rbx);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_operand_from_memory(x86_64_size_08, x86_64_register_rax), x86_64_linux_byte(x86_64_register_rbx));
+		} break;
+
+		case mirac_token_type_reserved_st16:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rbx);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_operand_from_memory(x86_64_size_16, x86_64_register_rax), x86_64_linux_word(x86_64_register_rbx));
+		} break;
+
+		case mirac_token_type_reserved_st32:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rbx);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_operand_from_memory(x86_64_size_32, x86_64_register_rax), x86_64_linux_dword(x86_64_register_rbx));
+		} break;
+
+		case mirac_token_type_reserved_st64:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rbx);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_operand_from_memory(x86_64_size_64, x86_64_register_rax), x86_64_linux_qword(x86_64_register_rbx));
+		} break;
+
+		case mirac_token_type_reserved_sys1:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rdi);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_syscall, x86_64_operand_none, x86_64_operand_none);
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+		} break;
+
+		case mirac_token_type_reserved_sys2:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rdi);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rsi);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_syscall, x86_64_operand_none, x86_64_operand_none);
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+		} break;
+
+		case mirac_token_type_reserved_sys3:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rdi);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rsi);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rdx);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_syscall, x86_64_operand_none, x86_64_operand_none);
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+		} break;
+
+		case mirac_token_type_reserved_sys4:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rdi);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rsi);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rdx);
+			x86_64_linux_lower_pop(lowering, x86_64_register_r10);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_syscall, x86_64_operand_none, x86_64_operand_none);
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+		} break;
+
+		case mirac_token_type_reserved_sys5:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rdi);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rsi);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rdx);
+			x86_64_linux_lower_pop(lowering, x86_64_register_r10);
+			x86_64_linux_lower_pop(lowering, x86_64_register_r8);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_syscall, x86_64_operand_none, x86_64_operand_none);
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+		} break;
+
+		case mirac_token_type_reserved_sys6:
+		{
+			x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rdi);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rsi);
+			x86_64_linux_lower_pop(lowering, x86_64_register_rdx);
+			x86_64_linux_lower_pop(lowering, x86_64_register_r10);
+			x86_64_linux_lower_pop(lowering, x86_64_register_r8);
+			x86_64_linux_lower_pop(lowering, x86_64_register_r9);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_syscall, x86_64_operand_none, x86_64_operand_none);
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+		} break;
+
+		case mirac_token_type_reserved_true:
+		{
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rax), x86_64_operand_from_immediate(1));
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+		} break;
+
+		case mirac_token_type_reserved_false:
+		{
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rax), x86_64_operand_from_immediate(0));
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+		} break;
+
+
+		case mirac_token_type_literal_i08:
+		case mirac_token_type_literal_i16:
+		case mirac_token_type_literal_i32:
+		case mirac_token_type_literal_i64:
+		{
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rax), x86_64_operand_from_immediate(expr_block->as.ival));
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+		} break;
+
+		case mirac_token_type_literal_u08:
+		case mirac_token_type_literal_u16:
+		case mirac_token_type_literal_u32:
+		case mirac_token_type_literal_u64:
+		{
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rax), x86_64_operand_from_immediate((int64_t)expr_block->as.uval));
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+		} break;
+
+		case mirac_token_type_literal_ptr:
+		{
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rax), x86_64_operand_from_immediate((int64_t)expr_block->as.ptr));
+			x86_64_linux_lower_push(lowering, x86_64_register_rax);
+		} break;
+
+		default:
+		{
+			const mirac_token_s token = mirac_ast_unit_get_block_token(compiler->unit, block);
+			mirac_logger_debug("encountered an invalid token '" mirac_sv_fmt "' while lowering expr block.",
+				mirac_sv_arg(mirac_token_to_string_view(&token)));
+			(void)token; // note: the debug log is compiled out of release builds.
+			mirac_debug_assert(0); // note: should never reach this block.
+		} break;
+	}
+}
+
+static void x86_64_linux_lower_ast_block_ident(
+	x86_64_linux_lowering_s* const lowering,
+	const mirac_ast_block_t block)
+{
+	mirac_debug_assert(lowering != mirac_null);
+
+	mirac_compiler_s* const compiler = lowering->compiler;
+	mirac_debug_assert(mirac_ast_block_type_ident == mirac_ast_unit_get_block_type(compiler->unit, block));
+
+	const mirac_ast_block_ident_s* const ident_block = &mirac_ast_unit_get_block_payload(compiler->unit, block)->as.ident_block;
+	mirac_debug_assert(ident_block != mirac_null);
+	mirac_debug_assert(ident_block->def != mirac_null);
+
+	x86_64_linux_lower_comment(lowering, true, mirac_string_view_from_cstring("ident"));
+	const mirac_token_s identifier = mirac_ast_def_get_identifier_token(ident_block->def);
+	const x86_64_operand_s symbol = x86_64_operand_from_symbol(mirac_token_get_ident(&identifier), ident_block->def);
+
+	if (compiler->config->optimization >= 1)
+	{
+		x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_linux_cache_push(lowering)), symbol);
+	}
+	else
+	{
+		x86_64_linux_lower_operation(lowering, x86_64_mnemonic_push, symbol, x86_64_operand_none);
+	}
+}
+
+static void x86_64_linux_lower_ast_block_call(
+	x86_64_linux_lowering_s* const lowering,
+	const mirac_ast_block_t block)
+{
+	mirac_debug_assert(lowering != mirac_null);
+
+	mirac_compiler_s* const compiler = lowering->compiler;
+	mirac_debug_assert(mirac_ast_block_type_call == mirac_ast_unit_get_block_type(compiler->unit, block));
+
+	const mirac_ast_block_call_s* const call_block = &mirac_ast_unit_get_block_payload(compiler->unit, block)->as.call_block;
+	mirac_debug_assert(call_block != mirac_null);
+	mirac_debug_assert(mirac_ast_block_type_ident == mirac_ast_unit_get_block_type(compiler->unit, call_block->ident));
+
+	const mirac_ast_block_ident_s* const ident_block = &mirac_ast_unit_get_block_payload(compiler->unit, call_block->ident)->as.ident_block;
+	mirac_debug_assert(ident_block != mirac_null);
+	mirac_debug_assert(ident_block->def != mirac_null);
+	mirac_debug_assert(mirac_ast_def_type_fun == ident_block->def->type);
+
+	x86_64_linux_lower_comment(lowering, true, mirac_string_view_from_cstring("call"));
+
+	// todo(#001): this should be reworked as well, since it is part of #001 todo.
+	const x86_64_operand_s ret_stack_rsp = x86_64_operand_from_absolute(x86_64_size_64, mirac_string_view_from_cstring("__ret_stack_rsp"));
+	x86_64_linux_cache_spill(lowering);
+	x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rax), x86_64_linux_qword(x86_64_register_rsp));
+	x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rsp), ret_stack_rsp);
+	x86_64_linux_lower_operation(lowering, x86_64_mnemonic_call,
+		x86_64_operand_from_symbol(mirac_token_get_ident(&ident_block->def->as.fun_def.identifier), ident_block->def), x86_64_operand_none);
+	x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, ret_stack_rsp, x86_64_linux_qword(x86_64_register_rsp));
+	x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rsp), x86_64_linux_qword(x86_64_register_rax));
+}
+
+static void x86_64_linux_lower_ast_block_scope(
+	x86_64_linux_lowering_s* const lowering,
+	const mirac_ast_block_t block)
+{
+	mirac_debug_assert(lowering != mirac_null);
+
+	mirac_compiler_s* const compiler = lowering->compiler;
+	mirac_debug_assert(mirac_ast_block_type_scope == mirac_ast_unit_get_block_type(compiler->unit, block));
+
+	const mirac_ast_block_scope_s* const scope_block = &mirac_ast_unit_get_block_payload(compiler->unit, block)->as.scope_block;
+	mirac_debug_assert(scope_block != mirac_null);
+
+	for (uint64_t block_index = scope_block->blocks.begin; block_index < ((uint64_t)scope_block->blocks.begin + scope_block->blocks.count); ++block_index)
+	{
+		x86_64_linux_lower_ast_block(lowering, compiler->unit->children.data[block_index]);
+	}
+}
+
+static void x86_64_linux_lower_ast_block_if(
+	x86_64_linux_lowering_s* const lowering,
+	const mirac_ast_block_t block)
+{
+	mirac_debug_assert(lowering != mirac_null);
+
+	mirac_compiler_s* const compiler = lowering->compiler;
+	mirac_debug_assert(mirac_ast_block_type_if == mirac_ast_unit_get_block_type(compiler->unit, block));
+
+	const mirac_ast_block_if_s* const if_block = &mirac_ast_unit_get_block_payload(compiler->unit, block)->as.if_block;
+	mirac_debug_assert(if_block != mirac_null);
+	mirac_debug_assert(mirac_ast_block_type_scope == mirac_ast_unit_get_block_type(compiler->unit, if_block->cond));
+	mirac_debug_assert(mirac_ast_block_type_scope == mirac_ast_unit_get_block_type(compiler->unit, if_block->body));
+
+	x86_64_linux_lower_comment(lowering, true, mirac_string_view_from_cstring("if"));
+	x86_64_linux_lower_label(lowering, mirac_string_view_from_cstring("__prior_if_cond_"), if_block->index);
+	x86_64_linux_lower_ast_block(lowering, if_block->cond);
+	x86_64_linux_lower_label(lowering, mirac_string_view_from_cstring("__after_if_cond_"), if_block->index);
+	x86_64_linux_lower_cond_test(lowering);
+
+	// note: the stack is simulated through the branches, and if they are known
+	//       to leave it at the same depth, the cache is kept in registers at the
+	//       labels after them (with every slot in a register of its own, which
+	//       the moves and the pushes do without changing the flags of the test).
+	//       Otherwise it is spilled at the jumps into them.
+	bool_t is_balanced = false;
+
+	if (compiler->config->optimization >= 1)
+	{
+		x86_64_linux_stack_effect_s body_effect = {0};
+		x86_64_linux_stack_effect_s else_effect = {0};
+		is_balanced = x86_64_linux_simulate_ast_block(compiler, if_block->body, &body_effect);
+
+		if (if_block->next != mirac_ast_block_none)
+		{
+			const mirac_ast_block_t else_body = mirac_ast_unit_get_block_payload(compiler->unit, if_block->next)->as.else_block.body;
+			is_balanced = is_balanced && x86_64_linux_simulate_ast_block(compiler, else_body, &else_effect);
+		}
+
+		is_balanced = is_balanced && (body_effect.height == else_effect.height);
+	}
+
+	if (mirac_ast_block_none == if_block->next)
+	{
+		if (is_balanced)
+		{
+			x86_64_linux_cache_unshare(lowering);
+		}
+		else
+		{
+			x86_64_linux_cache_spill(lowering);
+		}
+	}
+
+	const mirac_compiler_cache_s cond_cache = compiler->cache;
+
+	if (if_block->next != mirac_ast_block_none)
+	{
+		mirac_debug_assert(mirac_ast_block_type_else == mirac_ast_unit_get_block_type(compiler->unit, if_block->next));
+		x86_64_linux_lower_jump(lowering, x86_64_mnemonic_jcc, mirac_string_view_from_cstring("__prior_else_body_"),
+			mirac_ast_unit_get_block_payload(compiler->unit, if_block->next)->as.else_block.index);
+	}
+	else
+	{
+		x86_64_linux_lower_jump(lowering, x86_64_mnemonic_jcc, mirac_string_view_from_cstring("__after_if_body_"), if_block->index);
+	}
+
+	x86_64_linux_lower_label(lowering, mirac_string_view_from_cstring("__prior_if_body_"), if_block->index);
+	x86_64_linux_lower_ast_block(lowering, if_block->body);
+
+	if (mirac_ast_block_none == if_block->next)
+	{
+		x86_64_linux_cache_normalize(lowering, &cond_cache);
+	}
+	else if (is_balanced)
+	{
+		x86_64_linux_cache_unshare(lowering);
+	}
+	else
+	{
+		x86_64_linux_cache_spill(lowering);
+	}
+
+	// note: the else block starts with the cache of the jump into it, and ends
+	//       with the one of the jump over it.
+	compiler->else_cache = compiler->cache;
+	compiler->cache = cond_cache;
+
+	if (if_block->next != mirac_ast_block_none)
+	{
+		mirac_debug_assert(mirac_ast_block_type_else == mirac_ast_unit_get_block_type(compiler->unit, if_block->next));
+		x86_64_linux_lower_jump(lowering, x86_64_mnemonic_jmp, mirac_string_view_from_cstring("__after_else_body_"),
+			mirac_ast_unit_get_block_payload(compiler->unit, if_block->next)->as.else_block.index);
+	}
+	else
+	{
+		x86_64_linux_lower_jump(lowering, x86_64_mnemonic_jmp, mirac_string_view_from_cstring("__after_if_body_"), if_block->index);
+	}
+
+	x86_64_linux_lower_label(lowering, mirac_string_view_from_cstring("__after_if_body_"), if_block->index);
+}
+
+static void x86_64_linux_lower_ast_block_else(
+	x86_64_linux_lowering_s* const lowering,
+	const mirac_ast_block_t block)
+{
+	mirac_debug_assert(lowering != mirac_null);
+
+	mirac_compiler_s* const compiler = lowering->compiler;
+	mirac_debug_assert(mirac_ast_block_type_else == mirac_ast_unit_get_block_type(compiler->unit, block));
+
+	const mirac_ast_block_else_s* const else_block = &mirac_ast_unit_get_block_payload(compiler->unit, block)->as.else_block;
+	mirac_debug_assert(else_block != mirac_null);
+	mirac_debug_assert(mirac_ast_block_type_scope == mirac_ast_unit_get_block_type(compiler->unit, else_block->body));
+
+	x86_64_linux_lower_comment(lowering, true, mirac_string_view_from_cstring("else"));
+
+	const mirac_compiler_cache_s exit_cache = compiler->else_cache;
+	x86_64_linux_lower_label(lowering, mirac_string_view_from_cstring("__prior_else_body_"), else_block->index);
+	x86_64_linux_lower_ast_block(lowering, else_block->body);
+	x86_64_linux_cache_normalize(lowering, &exit_cache);
+	x86_64_linux_lower_label(lowering, mirac_string_view_from_cstring("__after_else_body_"), else_block->index);
+}
+
+static void x86_64_linux_lower_ast_block_loop(
+	x86_64_linux_lowering_s* const lowering,
+	const mirac_ast_block_t block)
+{
+	mirac_debug_assert(lowering != mirac_null);
+
+	mirac_compiler_s* const compiler = lowering->compiler;
+	mirac_debug_assert(mirac_ast_block_type_loop == mirac_ast_unit_get_block_type(compiler->unit, block));
+
+	const mirac_ast_block_loop_s* const loop_block = &mirac_ast_unit_get_block_payload(compiler->unit, block)->as.loop_block;
+	mirac_debug_assert(loop_block != mirac_null);
+	mirac_debug_assert(mirac_ast_block_type_scope == mirac_ast_unit_get_block_type(compiler->unit, loop_block->cond));
+	mirac_debug_assert(mirac_ast_block_type_scope == mirac_ast_unit_get_block_type(compiler->unit, loop_block->body));
+
+	x86_64_linux_lower_comment(lowering, true, mirac_string_view_from_cstring("loop"));
+
+	// note: the stack is simulated through the loop, and the slots that it reads
+	//       below its start are kept in registers (along with the ones that are
+	//       already cached) for as long as its own slots leave room for them.
+	//       The body brings the cache back to that state before it jumps to the
+	//       cond, and the loop is left with the cache of the cond's test.
+	uint64_t count = 0;
+	x86_64_linux_stack_effect_s effect = {0};
+
+	if ((compiler->config->optimization >= 1) && x86_64_linux_simulate_ast_block(compiler, block, &effect))
+	{
+		const int64_t registers_count = x86_64_linux_cache_registers_count;
+		const int64_t room = (effect.highest < registers_count) ? registers_count - effect.highest : 0;
+		const int64_t needed = ((int64_t)compiler->cache.count > -effect.lowest) ? (int64_t)compiler->cache.count : -effect.lowest;
+		count = (uint64_t)((needed < room) ? needed : room);
+	}
+
+	x86_64_linux_cache_resize(lowering, count);
+	const mirac_compiler_cache_s entry_cache = compiler->cache;
+	x86_64_linux_lower_label(lowering, mirac_string_view_from_cstring("__prior_loop_cond_"), loop_block->index);
+	x86_64_linux_lower_ast_block(lowering, loop_block->cond);
+	x86_64_linux_lower_label(lowering, mirac_string_view_from_cstring("__after_loop_cond_"), loop_block->index);
+
+	x86_64_linux_lower_cond_test(lowering);
+	x86_64_linux_lower_jump(lowering, x86_64_mnemonic_jcc, mirac_string_view_from_cstring("__after_loop_body_"), loop_block->index);
+	const mirac_compiler_cache_s exit_cache = compiler->cache;
+
+	x86_64_linux_lower_label(lowering, mirac_string_view_from_cstring("__prior_loop_body_"), loop_block->index);
+	x86_64_linux_lower_ast_block(lowering, loop_block->body);
+	x86_64_linux_cache_normalize(lowering, &entry_cache);
+	x86_64_linux_lower_jump(lowering, x86_64_mnemonic_jmp, mirac_string_view_from_cstring("__prior_loop_cond_"), loop_block->index);
+	x86_64_linux_lower_label(lowering, mirac_string_view_from_cstring("__after_loop_body_"), loop_block->index);
+	compiler->cache = exit_cache;
+}
+
+static void x86_64_linux_lower_ast_block_asm(
+	x86_64_linux_lowering_s* const lowering,
+	const mirac_ast_block_t block)
+{
+	mirac_debug_assert(lowering != mirac_null);
+
+	mirac_compiler_s* const compiler = lowering->compiler;
+	mirac_debug_assert(mirac_ast_block_type_asm == mirac_ast_unit_get_block_type(compiler->unit, block));
+
+	const mirac_ast_block_asm_s* const asm_block = &mirac_ast_unit_get_block_payload(compiler->unit, block)->as.asm_block;
+	mirac_debug_assert(asm_block != mirac_null);
+
+	x86_64_linux_lower_comment(lowering, true, mirac_string_view_from_cstring("asm"));
+	x86_64_linux_cache_spill(lowering);
+	x86_64_instruction_list_push(lowering->instructions, x86_64_instruction_from_opaque(
+		mirac_string_view_from_parts(asm_block->inst, asm_block->inst_length), mirac_ast_unit_get_block_position(compiler->unit, block)));
+}
+
+static void x86_64_linux_lower_ast_block(
+	x86_64_linux_lowering_s* const lowering,
+	const mirac_ast_block_t block)
+{
+	mirac_debug_assert(lowering != mirac_null);
+
+	switch (mirac_ast_unit_get_block_type(lowering->compiler->unit, block))
+	{
+		case mirac_ast_block_type_expr:  { x86_64_linux_lower_ast_block_expr(lowering, block);  } break;
+		case mirac_ast_block_type_ident: { x86_64_linux_lower_ast_block_ident(lowering, block); } break;
+		case mirac_ast_block_type_call:  { x86_64_linux_lower_ast_block_call(lowering, block);  } break;
+		case mirac_ast_block_type_as:    {                                                        } break;
+		case mirac_ast_block_type_scope: { x86_64_linux_lower_ast_block_scope(lowering, block); } break;
+		case mirac_ast_block_type_if:    { x86_64_linux_lower_ast_block_if(lowering, block);    } break;
+		case mirac_ast_block_type_else:  { x86_64_linux_lower_ast_block_else(lowering, block);  } break;
+		case mirac_ast_block_type_loop:  { x86_64_linux_lower_ast_block_loop(lowering, block);  } break;
+		case mirac_ast_block_type_asm:   { x86_64_linux_lower_ast_block_asm(lowering, block);   } break;
+
+		default:
+		{
+			mirac_debug_assert(0); // note: should never reach this block.
+		} break;
+	}
+}
+
+static void x86_64_linux_lower_operation(
+	x86_64_linux_lowering_s* const lowering,
+	const x86_64_mnemonic_e mnemonic,
+	const x86_64_operand_s first,
+	const x86_64_operand_s second)
+{
+	mirac_debug_assert(lowering != mirac_null);
+	x86_64_instruction_list_push(lowering->instructions, x86_64_instruction_from_operation(mnemonic, first, second));
+}
+
+static void x86_64_linux_lower_condition(
+	x86_64_linux_lowering_s* const lowering,
+	const x86_64_mnemonic_e mnemonic,
+	const x86_64_condition_e condition,
+	const x86_64_operand_s first,
+	const x86_64_operand_s second)
+{
+	mirac_debug_assert(lowering != mirac_null);
+	x86_64_instruction_list_push(lowering->instructions, x86_64_instruction_from_condition(mnemonic, condition, first, second));
+}
+
+static void x86_64_linux_lower_push(
+	x86_64_linux_lowering_s* const lowering,
+	const x86_64_register_e reg)
+{
+	x86_64_linux_lower_operation(lowering, x86_64_mnemonic_push, x86_64_linux_qword(reg), x86_64_operand_none);
+}
+
+static void x86_64_linux_lower_pop(
+	x86_64_linux_lowering_s* const lowering,
+	const x86_64_register_e reg)
+{
+	x86_64_linux_lower_operation(lowering, x86_64_mnemonic_pop, x86_64_linux_qword(reg), x86_64_operand_none);
+}
+
+static void x86_64_linux_lower_comment(
+	x86_64_linux_lowering_s* const lowering,
+	const bool_t is_indented,
+	const mirac_string_view_s name)
+{
+	mirac_debug_assert(lowering != mirac_null);
+
+	if (lowering->compiler->config->strip)
+	{
+		return;
+	}
+
+	x86_64_instruction_list_push(lowering->instructions, x86_64_instruction_from_comment(name, is_indented));
+}
+
+static void x86_64_linux_lower_label(
+	x86_64_linux_lowering_s* const lowering,
+	const mirac_string_view_s prefix,
+	const uint64_t index)
+{
+	x86_64_instruction_list_push(lowering->instructions, x86_64_instruction_from_label(prefix, index));
+}
+
+static void x86_64_linux_lower_jump(
+	x86_64_linux_lowering_s* const lowering,
+	const x86_64_mnemonic_e mnemonic,
+	const mirac_string_view_s prefix,
+	const uint64_t index)
+{
+	mirac_debug_assert((x86_64_mnemonic_jmp == mnemonic) || (x86_64_mnemonic_jcc == mnemonic));
+
+	const x86_64_operand_s label = x86_64_operand_from_label(prefix, index);
+
+	if (x86_64_mnemonic_jcc == mnemonic)
+	{
+		x86_64_linux_lower_condition(lowering, mnemonic, x86_64_condition_equal, label, x86_64_operand_none);
+	}
+	else
+	{
+		x86_64_linux_lower_operation(lowering, mnemonic, label, x86_64_operand_none);
+	}
+}
+
+static x86_64_register_e x86_64_linux_cache_get(
+	const x86_64_linux_lowering_s* const lowering,
+	const uint64_t depth)
+{
+	mirac_debug_assert(lowering != mirac_null);
+	const mirac_compiler_cache_s* const cache = &lowering->compiler->cache;
+	mirac_debug_assert(depth < cache->count);
+	return g_cache_registers[cache->registers[cache->count - 1 - depth]];
+}
+
+static uint8_t x86_64_linux_cache_find_free(
+	const x86_64_linux_lowering_s* const lowering,
+	const uint64_t begin,
+	const uint64_t end)
+{
+	mirac_debug_assert(lowering != mirac_null);
+	const mirac_compiler_cache_s* const cache = &lowering->compiler->cache;
+	mirac_debug_assert(begin <= end);
+
+	for (uint8_t register_index = 0; register_index < x86_64_linux_cache_registers_count; ++register_index)
+	{
+		bool_t is_taken = false;
+
+		for (uint64_t slot_index = begin; (slot_index < end) && !is_taken; ++slot_index)
+		{
+			is_taken = (register_index == cache->registers[slot_index]);
+		}
+
+		if (!is_taken)
+		{
+			return register_index;
+		}
+	}
+
+	return x86_64_linux_cache_registers_count;
+}
+
+static bool_t x86_64_linux_cache_is_shared(
+	const x86_64_linux_lowering_s* const lowering,
+	const uint64_t slot_index)
+{
+	mirac_debug_assert(lowering != mirac_null);
+	const mirac_compiler_cache_s* const cache = &lowering->compiler->cache;
+	mirac_debug_assert(slot_index < cache->count);
+
+	for (uint64_t other_index = 0; other_index < cache->count; ++other_index)
+	{
+		if ((other_index != slot_index) && (cache->registers[other_index] == cache->registers[slot_index]))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void x86_64_linux_cache_spill(
+	x86_64_linux_lowering_s* const lowering)
+{
+	mirac_debug_assert(lowering != mirac_null);
+	mirac_compiler_cache_s* const cache = &lowering->compiler->cache;
+	mirac_debug_assert(cache->count <= mirac_compiler_max_cached_slots_count);
+
+	for (uint64_t slot_index = 0; slot_index < cache->count; ++slot_index)
+	{
+		x86_64_linux_lower_push(lowering, g_cache_registers[cache->registers[slot_index]]);
+	}
+
+	cache->count = 0;
+}
+
+static void x86_64_linux_cache_spill_deepest(
+	x86_64_linux_lowering_s* const lowering)
+{
+	mirac_debug_assert(lowering != mirac_null);
+	mirac_compiler_cache_s* const cache = &lowering->compiler->cache;
+	mirac_debug_assert(cache->count > 0);
+
+	x86_64_linux_lower_push(lowering, g_cache_registers[cache->registers[0]]);
+
+	for (uint64_t slot_index = 1; slot_index < cache->count; ++slot_index)
+	{
+		cache->registers[slot_index - 1] = cache->registers[slot_index];
+	}
+
+	cache->count -= 1;
+}
+
+static void x86_64_linux_cache_fill(
+	x86_64_linux_lowering_s* const lowering,
+	const uint64_t count)
+{
+	mirac_debug_assert(lowering != mirac_null);
+	mirac_compiler_cache_s* const cache = &lowering->compiler->cache;
+	mirac_debug_assert(count <= x86_64_linux_cache_registers_count);
+
+	if (cache->count >= count)
+	{
+		return;
+	}
+
+	// note: the popped slots are deeper than the cached ones, so the cached ones
+	//       move up in the map (but stay in their registers) to make room for them.
+	//       Fewer slots than the count are cached, so they take fewer registers
+	//       than the count, and there are enough free ones for the popped slots.
+	const uint64_t shift = count - cache->count;
+
+	for (uint64_t slot_index = cache->count; slot_index > 0; --slot_index)
+	{
+		cache->registers[slot_index - 1 + shift] = cache->registers[slot_index - 1];
+	}
+
+	for (uint64_t slot_index = shift; slot_index > 0; --slot_index)
+	{
+		const uint8_t free_register = x86_64_linux_cache_find_free(lowering, slot_index, count);
+		mirac_debug_assert(free_register < x86_64_linux_cache_registers_count);
+		cache->registers[slot_index - 1] = free_register;
+		x86_64_linux_lower_pop(lowering, g_cache_registers[free_register]);
+	}
+
+	cache->count = count;
+}
+
+static x86_64_register_e x86_64_linux_cache_push(
+	x86_64_linux_lowering_s* const lowering)
+{
+	mirac_debug_assert(lowering != mirac_null);
+	mirac_compiler_cache_s* const cache = &lowering->compiler->cache;
+
+	while ((mirac_compiler_max_cached_slots_count == cache->count) ||
+		(x86_64_linux_cache_registers_count == x86_64_linux_cache_find_free(lowering, 0, cache->count)))
+	{
+		x86_64_linux_cache_spill_deepest(lowering);
+	}
+
+	const uint8_t free_register = x86_64_linux_cache_find_free(lowering, 0, cache->count);
+	cache->registers[cache->count++] = free_register;
+	return g_cache_registers[free_register];
+}
+
+static void x86_64_linux_cache_copy(
+	x86_64_linux_lowering_s* const lowering,
+	const uint64_t depth)
+{
+	mirac_debug_assert(lowering != mirac_null);
+	mirac_compiler_cache_s* const cache = &lowering->compiler->cache;
+
+	x86_64_linux_cache_fill(lowering, depth + 1);
+
+	if (mirac_compiler_max_cached_slots_count == cache->count)
+	{
+		x86_64_linux_cache_spill_deepest(lowering);
+	}
+
+	cache->registers[cache->count] = cache->registers[cache->count - 1 - depth];
+	cache->count += 1;
+}
+
+static x86_64_register_e x86_64_linux_cache_own(
+	x86_64_linux_lowering_s* const lowering,
+	const uint64_t depth,
+	const bool_t is_copied)
+{
+	mirac_debug_assert(lowering != mirac_null);
+	mirac_compiler_cache_s* const cache = &lowering->compiler->cache;
+	mirac_debug_assert(depth < cache->count);
+
+	// note: the spilled slots are deeper than the owned one, and a slot that is
+	//       shared while all of the registers are taken is never the deepest one,
+	//       since the slots above it take fewer registers than there are.
+	while (x86_64_linux_cache_is_shared(lowering, cache->count - 1 - depth) &&
+		(x86_64_linux_cache_registers_count == x86_64_linux_cache_find_free(lowering, 0, cache->count)))
+	{
+		mirac_debug_assert(cache->count - 1 - depth > 0);
+		x86_64_linux_cache_spill_deepest(lowering);
+	}
+
+	const uint64_t slot_index = cache->count - 1 - depth;
+
+	if (x86_64_linux_cache_is_shared(lowering, slot_index))
+	{
+		const uint8_t free_register = x86_64_linux_cache_find_free(lowering, 0, cache->count);
+
+		if (is_copied)
+		{
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov,
+				x86_64_linux_qword(g_cache_registers[free_register]), x86_64_linux_qword(g_cache_registers[cache->registers[slot_index]]));
+		}
+
+		cache->registers[slot_index] = free_register;
+	}
+
+	return g_cache_registers[cache->registers[slot_index]];
+}
+
+static void x86_64_linux_cache_unshare(
+	x86_64_linux_lowering_s* const lowering)
+{
+	mirac_debug_assert(lowering != mirac_null);
+	mirac_compiler_cache_s* const cache = &lowering->compiler->cache;
+
+	while (cache->count > x86_64_linux_cache_registers_count)
+	{
+		x86_64_linux_cache_spill_deepest(lowering);
+	}
+
+	for (uint64_t slot_index = 1; slot_index < cache->count; ++slot_index)
+	{
+		bool_t is_shared = false;
+
+		for (uint64_t other_index = 0; (other_index < slot_index) && !is_shared; ++other_index)
+		{
+			is_shared = (cache->registers[other_index] == cache->registers[slot_index]);
+		}
+
+		if (is_shared)
+		{
+			const uint8_t free_register = x86_64_linux_cache_find_free(lowering, 0, cache->count);
+			mirac_debug_assert(free_register < x86_64_linux_cache_registers_count);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov,
+				x86_64_linux_qword(g_cache_registers[free_register]), x86_64_linux_qword(g_cache_registers[cache->registers[slot_index]]));
+			cache->registers[slot_index] = free_register;
+		}
+	}
+}
+
+static void x86_64_linux_cache_resize(
+	x86_64_linux_lowering_s* const lowering,
+	const uint64_t count)
+{
+	mirac_debug_assert(lowering != mirac_null);
+	mirac_compiler_cache_s* const cache = &lowering->compiler->cache;
+	mirac_debug_assert(count <= x86_64_linux_cache_registers_count);
+
+	while (cache->count > count)
+	{
+		x86_64_linux_cache_spill_deepest(lowering);
+	}
+
+	x86_64_linux_cache_fill(lowering, count);
+	x86_64_linux_cache_unshare(lowering);
+}
+
+static void x86_64_linux_cache_normalize(
+	x86_64_linux_lowering_s* const lowering,
+	const mirac_compiler_cache_s* const target)
+{
+	mirac_debug_assert(lowering != mirac_null);
+	mirac_compiler_cache_s* const cache = &lowering->compiler->cache;
+	mirac_debug_assert(target != mirac_null);
+	mirac_debug_assert(target->count <= x86_64_linux_cache_registers_count);
+
+	while (cache->count > target->count)
+	{
+		x86_64_linux_cache_spill_deepest(lowering);
+	}
+
+	// note: the cached slots are the top ones of the target, and they are moved
+	//       into its registers all at once. The target registers are distinct, so
+	//       every move can be done once none of the others read its destination,
+	//       except for the ones in a cycle, whose first destination is saved in
+	//       rax (the scratch index) to break it.
+	const uint64_t shift = target->count - cache->count;
+	const uint8_t scratch_index = x86_64_linux_cache_registers_count;
+	uint8_t sources[x86_64_linux_cache_registers_count] = {0};
+	uint8_t destinations[x86_64_linux_cache_registers_count] = {0};
+	uint64_t moves_count = 0;
+
+	for (uint64_t slot_index = 0; slot_index < cache->count; ++slot_index)
+	{
+		if (cache->registers[slot_index] != target->registers[slot_index + shift])
+		{
+			sources[moves_count] = cache->registers[slot_index];
+			destinations[moves_count] = target->registers[slot_index + shift];
+			moves_count += 1;
+		}
+	}
+
+	while (moves_count > 0)
+	{
+		uint64_t move_index = moves_count;
+
+		for (uint64_t candidate_index = 0; (candidate_index < moves_count) && (moves_count == move_index); ++candidate_index)
+		{
+			bool_t is_read = false;
+
+			for (uint64_t other_index = 0; (other_index < moves_count) && !is_read; ++other_index)
+			{
+				is_read = (sources[other_index] == destinations[candidate_index]);
+			}
+
+			if (!is_read)
+			{
+				move_index = candidate_index;
+			}
+		}
+
+		if (moves_count == move_index)
+		{
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov,
+				x86_64_linux_qword(x86_64_register_rax), x86_64_linux_qword(g_cache_registers[destinations[0]]));
+
+			for (uint64_t other_index = 0; other_index < moves_count; ++other_index)
+			{
+				if (sources[other_index] == destinations[0])
+				{
+					sources[other_index] = scratch_index;
+				}
+			}
+
+			continue;
+		}
+
+		x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(g_cache_registers[destinations[move_index]]),
+			x86_64_linux_qword((scratch_index == sources[move_index]) ? x86_64_register_rax : g_cache_registers[sources[move_index]]));
+
+		moves_count -= 1;
+		sources[move_index] = sources[moves_count];
+		destinations[move_index] = destinations[moves_count];
+	}
+
+	for (uint64_t slot_index = shift; slot_index > 0; --slot_index)
+	{
+		x86_64_linux_lower_pop(lowering, g_cache_registers[target->registers[slot_index - 1]]);
+	}
+
+	*cache = *target;
+}
+
+static void x86_64_linux_cache_binary(
+	x86_64_linux_lowering_s* const lowering,
+	const x86_64_mnemonic_e mnemonic)
+{
+	mirac_debug_assert(lowering != mirac_null);
+	mirac_compiler_cache_s* const cache = &lowering->compiler->cache;
+
+	x86_64_linux_cache_fill(lowering, 2);
+	const x86_64_register_e second = x86_64_linux_cache_own(lowering, 1, true);
+	x86_64_linux_lower_operation(lowering, mnemonic, x86_64_linux_qword(second), x86_64_linux_qword(x86_64_linux_cache_get(lowering, 0)));
+	cache->count -= 1;
+}
+
+static bool_t x86_64_linux_lower_ast_block_expr_cached(
+	x86_64_linux_lowering_s* const lowering,
+	const mirac_ast_block_expr_s* const expr_block)
+{
+	mirac_debug_assert(lowering != mirac_null);
+	mirac_compiler_cache_s* const cache = &lowering->compiler->cache;
+	mirac_debug_assert(expr_block != mirac_null);
+
+	switch (expr_block->token_type)
+	{
+		case mirac_token_type_reserved_lnot:
+		{
+			// note: only the low byte is set, just like in the uncached code.
+			x86_64_linux_cache_fill(lowering, 1);
+			const x86_64_register_e top = x86_64_linux_cache_own(lowering, 0, true);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_cmp, x86_64_linux_qword(top), x86_64_operand_from_immediate(0));
+			x86_64_linux_lower_condition(lowering, x86_64_mnemonic_setcc, x86_64_condition_equal, x86_64_linux_byte(top), x86_64_operand_none);
+		} break;
+
+		case mirac_token_type_reserved_land:
+		case mirac_token_type_reserved_band:
+		{
+			x86_64_linux_cache_binary(lowering, x86_64_mnemonic_and);
+		} break;
+
+		case mirac_token_type_reserved_lor:
+		case mirac_token_type_reserved_bor:
+		{
+			x86_64_linux_cache_binary(lowering, x86_64_mnemonic_or);
+		} break;
+
+		case mirac_token_type_reserved_lxor:
+		case mirac_token_type_reserved_bxor:
+		{
+			x86_64_linux_cache_binary(lowering, x86_64_mnemonic_xor);
+		} break;
+
+		case mirac_token_type_reserved_add:
+		{
+			x86_64_linux_cache_binary(lowering, x86_64_mnemonic_add);
+		} break;
+
+		case mirac_token_type_reserved_sub:
+		{
+			x86_64_linux_cache_binary(lowering, x86_64_mnemonic_sub);
+		} break;
+
+		case mirac_token_type_reserved_mul:
+		{
+			// note: the low half of the product is the same for signed and unsigned
+			//       operands, so imul gives the same result as mul.
+			x86_64_linux_cache_binary(lowering, x86_64_mnemonic_imul);
+		} break;
+
+		case mirac_token_type_reserved_bnot:
+		case mirac_token_type_reserved_inc:
+		case mirac_token_type_reserved_dec:
+		{
+			x86_64_mnemonic_e mnemonic = x86_64_mnemonic_not;
+
+			switch (expr_block->token_type)
+			{
+				case mirac_token_type_reserved_bnot: { mnemonic = x86_64_mnemonic_not; } break;
+				case mirac_token_type_reserved_inc:  { mnemonic = x86_64_mnemonic_inc; } break;
+				case mirac_token_type_reserved_dec:  { mnemonic = x86_64_mnemonic_dec; } break;
+
+				default:
+				{
+					mirac_debug_assert(0); // note: should never reach this block.
+				} break;
+			}
+
+			x86_64_linux_cache_fill(lowering, 1);
+			x86_64_linux_lower_operation(lowering, mnemonic, x86_64_linux_qword(x86_64_linux_cache_own(lowering, 0, true)), x86_64_operand_none);
+		} break;
+
+		case mirac_token_type_reserved_shl:
+		case mirac_token_type_reserved_shr:
+		{
+			x86_64_linux_cache_fill(lowering, 2);
+			const x86_64_register_e second = x86_64_linux_cache_own(lowering, 1, true);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rcx), x86_64_linux_qword(x86_64_linux_cache_get(lowering, 0)));
+			x86_64_linux_lower_operation(lowering, mirac_token_type_reserved_shl == expr_block->token_type ? x86_64_mnemonic_shl : x86_64_mnemonic_shr,
+				x86_64_linux_qword(second), x86_64_linux_byte(x86_64_register_rcx));
+			cache->count -= 1;
+		} break;
+
+		case mirac_token_type_reserved_div:
+		case mirac_token_type_reserved_mod:
+		case mirac_token_type_reserved_divmod:
+		{
+			// note: the operands are read before the results take their slots, so
+			//       the results only need registers of their own.
+			x86_64_linux_cache_fill(lowering, 2);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rax), x86_64_linux_qword(x86_64_linux_cache_get(lowering, 1)));
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_register_rdx), x86_64_operand_from_immediate(0));
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_div, x86_64_linux_qword(x86_64_linux_cache_get(lowering, 0)), x86_64_operand_none);
+
+			if (mirac_token_type_reserved_divmod == expr_block->token_type)
+			{
+				x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_linux_cache_own(lowering, 1, false)), x86_64_linux_qword(x86_64_register_rax));
+				x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_linux_cache_own(lowering, 0, false)), x86_64_linux_qword(x86_64_register_rdx));
+			}
+			else
+			{
+				cache->count -= 1;
+				x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_linux_cache_own(lowering, 0, false)),
+					x86_64_linux_qword(mirac_token_type_reserved_div == expr_block->token_type ? x86_64_register_rax : x86_64_register_rdx));
+			}
+		} break;
+
+		case mirac_token_type_reserved_eq:
+		case mirac_token_type_reserved_neq:
+		case mirac_token_type_reserved_gt:
+		case mirac_token_type_reserved_gteq:
+		case mirac_token_type_reserved_ls:
+		case mirac_token_type_reserved_lseq:
+		{
+			x86_64_condition_e condition = x86_64_condition_equal;
+
+			switch (expr_block->token_type)
+			{
+				case mirac_token_type_reserved_eq:   { condition = x86_64_condition_equal;         } break;
+				case mirac_token_type_reserved_neq:  { condition = x86_64_condition_not_equal;     } break;
+				case mirac_token_type_reserved_gt:   { condition = x86_64_condition_greater;       } break;
+				case mirac_token_type_reserved_gteq: { condition = x86_64_condition_greater_equal; } break;
+				case mirac_token_type_reserved_ls:   { condition = x86_64_condition_less;          } break;
+				case mirac_token_type_reserved_lseq: { condition = x86_64_condition_less_equal;    } break;
+
+				default:
+				{
+					mirac_debug_assert(0); // note: should never reach this block.
+				} break;
+			}
+
+			// note: rax is cleared ahead of the compare, so that setting its low byte
+			//       does not wait for whatever wrote it last.
+			x86_64_linux_cache_fill(lowering, 2);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_xor, x86_64_linux_dword(x86_64_register_rax), x86_64_linux_dword(x86_64_register_rax));
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_cmp, x86_64_linux_qword(x86_64_linux_cache_get(lowering, 1)), x86_64_linux_qword(x86_64_linux_cache_get(lowering, 0)));
+			x86_64_linux_lower_condition(lowering, x86_64_mnemonic_setcc, condition, x86_64_linux_byte(x86_64_register_rax), x86_64_operand_none);
+			cache->count -= 1;
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_linux_cache_own(lowering, 0, false)), x86_64_linux_qword(x86_64_register_rax));
+		} break;
+
+		case mirac_token_type_reserved_drop:
+		{
+			if (cache->count > 0)
+			{
+				cache->count -= 1;
+			}
+			else
+			{
+				x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+			}
+		} break;
+
+		case mirac_token_type_reserved_dup:
+		case mirac_token_type_reserved_over:
+		{
+			x86_64_linux_cache_copy(lowering, mirac_token_type_reserved_dup == expr_block->token_type ? 0 : 1);
+		} break;
+
+		case mirac_token_type_reserved_swap:
+		{
+			x86_64_linux_cache_fill(lowering, 2);
+			const uint8_t top_register = cache->registers[cache->count - 1];
+			cache->registers[cache->count - 1] = cache->registers[cache->count - 2];
+			cache->registers[cache->count - 2] = top_register;
+		} break;
+
+		case mirac_token_type_reserved_rot:
+		{
+			// note: the third slot goes to the top, above the second and the top ones.
+			x86_64_linux_cache_fill(lowering, 3);
+			const uint8_t third_register = cache->registers[cache->count - 3];
+			cache->registers[cache->count - 3] = cache->registers[cache->count - 2];
+			cache->registers[cache->count - 2] = cache->registers[cache->count - 1];
+			cache->registers[cache->count - 1] = third_register;
+		} break;
+
+		case mirac_token_type_reserved_ld08:
+		case mirac_token_type_reserved_ld16:
+		case mirac_token_type_reserved_ld32:
+		case mirac_token_type_reserved_ld64:
+		{
+			// note: the address is read before the loaded value takes its slot.
+			x86_64_linux_cache_fill(lowering, 1);
+			const x86_64_register_e address = x86_64_linux_cache_get(lowering, 0);
+			const x86_64_register_e top = x86_64_linux_cache_own(lowering, 0, false);
+
+			// note: writing the 32 bit part of a register zeroes its upper half.
+			switch (expr_block->token_type)
+			{
+				case mirac_token_type_reserved_ld08: { x86_64_linux_lower_operation(lowering, x86_64_mnemonic_movzx, x86_64_linux_qword(top), x86_64_operand_from_memory(x86_64_size_08, address)); } break;
+				case mirac_token_type_reserved_ld16: { x86_64_linux_lower_operation(lowering, x86_64_mnemonic_movzx, x86_64_linux_qword(top), x86_64_operand_from_memory(x86_64_size_16, address)); } break;
+				case mirac_token_type_reserved_ld32: { x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov,   x86_64_linux_dword(top), x86_64_operand_from_memory(x86_64_size_32, address)); } break;
+				case mirac_token_type_reserved_ld64: { x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov,   x86_64_linux_qword(top), x86_64_operand_from_memory(x86_64_size_64, address)); } break;
+
+				default:
+				{
+					mirac_debug_assert(0); // note: should never reach this block.
+				} break;
+			}
+		} break;
+
+		case mirac_token_type_reserved_st08:
+		case mirac_token_type_reserved_st16:
+		case mirac_token_type_reserved_st32:
+		case mirac_token_type_reserved_st64:
+		{
+			// note: the top slot is the address, and the second one is the value.
+			x86_64_size_e size = x86_64_size_64;
+
+			switch (expr_block->token_type)
+			{
+				case mirac_token_type_reserved_st08: { size = x86_64_size_08; } break;
+				case mirac_token_type_reserved_st16: { size = x86_64_size_16; } break;
+				case mirac_token_type_reserved_st32: { size = x86_64_size_32; } break;
+				case mirac_token_type_reserved_st64: { size = x86_64_size_64; } break;
+
+				default:
+				{
+					mirac_debug_assert(0); // note: should never reach this block.
+				} break;
+			}
+
+			x86_64_linux_cache_fill(lowering, 2);
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_operand_from_memory(size, x86_64_linux_cache_get(lowering, 0)),
+				x86_64_operand_from_register(x86_64_linux_cache_get(lowering, 1), size));
+			cache->count -= 2;
+		} break;
+
+		case mirac_token_type_reserved_true:
+		case mirac_token_type_reserved_false:
+		case mirac_token_type_literal_i08:
+		case mirac_token_type_literal_i16:
+		case mirac_token_type_literal_i32:
+		case mirac_token_type_literal_i64:
+		case mirac_token_type_literal_u08:
+		case mirac_token_type_literal_u16:
+		case mirac_token_type_literal_u32:
+		case mirac_token_type_literal_u64:
+		case mirac_token_type_literal_ptr:
+		{
+			int64_t value = 0;
+
+			switch (expr_block->token_type)
+			{
+				case mirac_token_type_reserved_true:  { value = 1; } break;
+				case mirac_token_type_reserved_false: { value = 0; } break;
+				case mirac_token_type_literal_i08:    { value = expr_block->as.ival; } break;
+				case mirac_token_type_literal_i16:    { value = expr_block->as.ival; } break;
+				case mirac_token_type_literal_i32:    { value = expr_block->as.ival; } break;
+				case mirac_token_type_literal_i64:    { value = expr_block->as.ival; } break;
+				case mirac_token_type_literal_u08:    { value = (int64_t)expr_block->as.uval; } break;
+				case mirac_token_type_literal_u16:    { value = (int64_t)expr_block->as.uval; } break;
+				case mirac_token_type_literal_u32:    { value = (int64_t)expr_block->as.uval; } break;
+				case mirac_token_type_literal_u64:    { value = (int64_t)expr_block->as.uval; } break;
+				case mirac_token_type_literal_ptr:    { value = (int64_t)expr_block->as.ptr; } break;
+
+				default:
+				{
+					mirac_debug_assert(0); // note: should never reach this block.
+				} break;
+			}
+
+			x86_64_linux_lower_operation(lowering, x86_64_mnemonic_mov, x86_64_linux_qword(x86_64_linux_cache_push(lowering)), x86_64_operand_from_immediate(value));
+		} break;
+
+		default:
+		{
+			// note: the syscalls take their operands in the registers of the calling
+			//       convention, so they are lowered against the hardware stack.
+			return false;
+		} break;
+	}
+
+	return true;
+}
+
+static void x86_64_linux_lower_cond_test(
+	x86_64_linux_lowering_s* const lowering)
+{
+	mirac_debug_assert(lowering != mirac_null);
+	mirac_compiler_cache_s* const cache = &lowering->compiler->cache;
+
+	if (cache->count > 0)
+	{
+		const x86_64_register_e top = x86_64_linux_cache_get(lowering, 0);
+		x86_64_linux_lower_operation(lowering, x86_64_mnemonic_test, x86_64_linux_qword(top), x86_64_linux_qword(top));
+		cache->count -= 1;
+	}
+	else
+	{
+		x86_64_linux_lower_pop(lowering, x86_64_register_rax);
+		x86_64_linux_lower_operation(lowering, x86_64_mnemonic_test, x86_64_linux_qword(x86_64_register_rax), x86_64_linux_qword(x86_64_register_rax));
+	}
+}
+
+static bool_t x86_64_linux_get_expr_effect(
+	const mirac_token_type_e token_type,
+	int64_t* const inputs,
+	int64_t* const outputs)
+{
+	mirac_debug_assert(inputs != mirac_null);
+	mirac_debug_assert(outputs != mirac_null);
+
+	switch (token_type)
+	{
+		case mirac_token_type_reserved_lnot:
+		case mirac_token_type_reserved_bnot:
+		case mirac_token_type_reserved_inc:
+		case mirac_token_type_reserved_dec:
+		case mirac_token_type_reserved_ld08:
+		case mirac_token_type_reserved_ld16:
+		case mirac_token_type_reserved_ld32:
+		case mirac_token_type_reserved_ld64:
+		{
+			*inputs = 1; *outputs = 1;
+		} break;
+
+		case mirac_token_type_reserved_land:
+		case mirac_token_type_reserved_lor:
+		case mirac_token_type_reserved_lxor:
+		case mirac_token_type_reserved_band:
+		case mirac_token_type_reserved_bor:
+		case mirac_token_type_reserved_bxor:
+		case mirac_token_type_reserved_shl:
+		case mirac_token_type_reserved_shr:
+		case mirac_token_type_reserved_add:
+		case mirac_token_type_reserved_sub:
+		case mirac_token_type_reserved_mul:
+		case mirac_token_type_reserved_div:
+		case mirac_token_type_reserved_mod:
+		case mirac_token_type_reserved_eq:
+		case mirac_token_type_reserved_neq:
+		case mirac_token_type_reserved_gt:
+		case mirac_token_type_reserved_gteq:
+		case mirac_token_type_reserved_ls:
+		case mirac_token_type_reserved_lseq:
+		{
+			*inputs = 2; *outputs = 1;
+		} break;
+
+		case mirac_token_type_reserved_divmod: { *inputs = 2; *outputs = 2; } break;
+		case mirac_token_type_reserved_drop:   { *inputs = 1; *outputs = 0; } break;
+		case mirac_token_type_reserved_dup:    { *inputs = 1; *outputs = 2; } break;
+		case mirac_token_type_reserved_over:   { *inputs = 2; *outputs = 3; } break;
+		case mirac_token_type_reserved_rot:    { *inputs = 3; *outputs = 3; } break;
+		case mirac_token_type_reserved_swap:   { *inputs = 2; *outputs = 2; } break;
+
+		case mirac_token_type_reserved_st08:
+		case mirac_token_type_reserved_st16:
+		case mirac_token_type_reserved_st32:
+		case mirac_token_type_reserved_st64:
+		{
+			*inputs = 2; *outputs = 0;
+		} break;
+
+		case mirac_token_type_reserved_sys1: { *inputs = 2; *outputs = 1; } break;
+		case mirac_token_type_reserved_sys2: { *inputs = 3; *outputs = 1; } break;
+		case mirac_token_type_reserved_sys3: { *inputs = 4; *outputs = 1; } break;
+		case mirac_token_type_reserved_sys4: { *inputs = 5; *outputs = 1; } break;
+		case mirac_token_type_reserved_sys5: { *inputs = 6; *outputs = 1; } break;
+		case mirac_token_type_reserved_sys6: { *inputs = 7; *outputs = 1; } break;
+
+		case mirac_token_type_reserved_true:
+		case mirac_token_type_reserved_false:
+		case mirac_token_type_literal_i08:
+		case mirac_token_type_literal_i16:
+		case mirac_token_type_literal_i32:
+		case mirac_token_type_literal_i64:
+		case mirac_token_type_literal_u08:
+		case mirac_token_type_literal_u16:
+		case mirac_token_type_literal_u32:
+		case mirac_token_type_literal_u64:
+		case mirac_token_type_literal_ptr:
+		{
+			*inputs = 0; *outputs = 1;
+		} break;
+
+		default:
+		{
+			return false;
+		} break;
+	}
+
+	return true;
+}
+
+static bool_t x86_64_linux_simulate_ast_block(
+	const mirac_compiler_s* const compiler,
+	const mirac_ast_block_t block,
+	x86_64_linux_stack_effect_s* const effect)
+{
+	mirac_debug_assert(compiler != mirac_null);
+	mirac_debug_assert(compiler->unit != mirac_null);
+	mirac_debug_assert(effect != mirac_null);
+
+	const mirac_ast_block_payload_s* const payload = mirac_ast_unit_get_block_payload(compiler->unit, block);
+	int64_t inputs = 0;
+	int64_t outputs = 0;
+
+	switch (mirac_ast_unit_get_block_type(compiler->unit, block))
+	{
+		case mirac_ast_block_type_expr:
+		{
+			if (!x86_64_linux_get_expr_effect(payload->as.expr_block.token_type, &inputs, &outputs))
+			{
+				return false;
+			}
+		} break;
+
+		case mirac_ast_block_type_ident:
+		{
+			outputs = 1;
+		} break;
+
+		case mirac_ast_block_type_as:
+		{
+		} break;
+
+		case mirac_ast_block_type_scope:
+		{
+			const mirac_ast_range_s blocks = payload->as.scope_block.blocks;
+
+			for (uint64_t block_index = blocks.begin; block_index < ((uint64_t)blocks.begin + blocks.count); ++block_index)
+			{
+				if (!x86_64_linux_simulate_ast_block(compiler, compiler->unit->children.data[block_index], effect))
+				{
+					return false;
+				}
+			}
+		} break;
+
+		case mirac_ast_block_type_if:
+		{
+			// note: the else block that follows the if block is simulated along with
+			//       it, since both of the branches have to leave the same depth.
+			const mirac_ast_block_if_s* const if_block = &payload->as.if_block;
+
+			if (!x86_64_linux_simulate_ast_block(compiler, if_block->cond, effect))
+			{
+				return false;
+			}
+
+			effect->lowest = (effect->height - 1 < effect->lowest) ? effect->height - 1 : effect->lowest;
+			effect->height -= 1;
+			x86_64_linux_stack_effect_s else_effect = *effect;
+
+			if (!x86_64_linux_simulate_ast_block(compiler, if_block->body, effect))
+			{
+				return false;
+			}
+
+			if (if_block->next != mirac_ast_block_none)
+			{
+				const mirac_ast_block_t else_body = mirac_ast_unit_get_block_payload(compiler->unit, if_block->next)->as.else_block.body;
+
+				if (!x86_64_linux_simulate_ast_block(compiler, else_body, &else_effect))
+				{
+					return false;
+				}
+			}
+
+			if (effect->height != else_effect.height)
+			{
+				return false;
+			}
+
+			effect->lowest = (else_effect.lowest < effect->lowest) ? else_effect.lowest : effect->lowest;
+			effect->highest = (else_effect.highest > effect->highest) ? else_effect.highest : effect->highest;
+		} break;
+
+		case mirac_ast_block_type_else:
+		{
+		} break;
+
+		case mirac_ast_block_type_loop:
+		{
+			// note: the body has to bring the stack back to the depth of the loop's
+			//       start, and the loop is left after the test of the cond.
+			const mirac_ast_block_loop_s* const loop_block = &payload->as.loop_block;
+			const int64_t height = effect->height;
+
+			if (!x86_64_linux_simulate_ast_block(compiler, loop_block->cond, effect))
+			{
+				return false;
+			}
+
+			effect->lowest = (effect->height - 1 < effect->lowest) ? effect->height - 1 : effect->lowest;
+			effect->height -= 1;
+			const int64_t exit_height = effect->height;
+
+			if (!x86_64_linux_simulate_ast_block(compiler, loop_block->body, effect) || (effect->height != height))
+			{
+				return false;
+			}
+
+			effect->height = exit_height;
+		} break;
+
+		default:
+		{
+			return false;
+		} break;
+	}
+
+	effect->lowest = (effect->height - inputs < effect->lowest) ? effect->height - inputs : effect->lowest;
+	effect->height += outputs - inputs;
+	effect->highest = (effect->height > effect->highest) ? effect->height : effect->highest;
+	return true;
+}
@@ -0,0 +1,36 @@
+/**
+ * @file x86_64_linux_lowering.h
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-04-26
+ */
+
+#ifndef __mirac__source__mirac__archs__x86_64_linux_lowering_h__
+#define __mirac__source__mirac__archs__x86_64_linux_lowering_h__
+
+#include <mirac/compiler.h>
+
+#include "./x86_64_instruction.h"
+
+// todo: write unit tests!
+/**
+ * @brief Select the instructions of the fun def into the instruction list, which
+ * both the nasm and the elf backends then write out in their own way.
+ * 
+ * @note With the optimizations, the top stack slots are kept in registers, and
+ * the instruction list goes through the peephole pass.
+ * 
+ * @param compiler     compiler instance
+ * @param def          fun def to lower
+ * @param instructions instruction list to push to
+ */
+void x86_64_linux_lower_ast_def_fun(
+	mirac_compiler_s* const compiler,
+	const mirac_ast_def_s* const def,
+	x86_64_instruction_list_s* const instructions);
+
+#endif
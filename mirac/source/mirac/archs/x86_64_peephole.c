@@ -0,0 +1,770 @@
+/**
+ * @file x86_64_peephole.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-04-22
+ */
+
+#include "./x86_64_peephole.h"
+
+#include <mirac/debug.h>
+#include <mirac/logger.h>
+
+/**
+ * @brief Effects of a mnemonic on its operands, the flags, and the control
+ * flow.
+ */
+typedef enum
+{
+	effect_reads_first   = 1 << 0,
+	effect_writes_first  = 1 << 1,
+	effect_reads_second  = 1 << 2,
+	effect_writes_flags  = 1 << 3,
+	effect_reads_flags   = 1 << 4,
+	effect_branches      = 1 << 5
+} effect_e;
+
+// note: the instructions that keep some of the flags as they were (inc, dec,
+//       and the shifts, which do not change them when shifting by 0) also read
+//       the flags, so that nothing before them is considered dead.
+static const uint8_t g_effects[x86_64_mnemonics_count] =
+{
+	[x86_64_mnemonic_mov]     = effect_writes_first | effect_reads_second,
+	[x86_64_mnemonic_movzx]   = effect_writes_first | effect_reads_second,
+	[x86_64_mnemonic_push]    = effect_reads_first,
+	[x86_64_mnemonic_pop]     = effect_writes_first,
+	[x86_64_mnemonic_add]     = effect_reads_first | effect_writes_first | effect_reads_second | effect_writes_flags,
+	[x86_64_mnemonic_sub]     = effect_reads_first | effect_writes_first | effect_reads_second | effect_writes_flags,
+	[x86_64_mnemonic_and]     = effect_reads_first | effect_writes_first | effect_reads_second | effect_writes_flags,
+	[x86_64_mnemonic_or]      = effect_reads_first | effect_writes_first | effect_reads_second | effect_writes_flags,
+	[x86_64_mnemonic_xor]     = effect_reads_first | effect_writes_first | effect_reads_second | effect_writes_flags,
+	[x86_64_mnemonic_cmp]     = effect_reads_first | effect_reads_second | effect_writes_flags,
+	[x86_64_mnemonic_test]    = effect_reads_first | effect_reads_second | effect_writes_flags,
+	[x86_64_mnemonic_imul]    = effect_reads_first | effect_writes_first | effect_reads_second | effect_writes_flags,
+	[x86_64_mnemonic_mul]     = effect_reads_first | effect_writes_flags,
+	[x86_64_mnemonic_div]     = effect_reads_first | effect_writes_flags,
+	[x86_64_mnemonic_not]     = effect_reads_first | effect_writes_first,
+	[x86_64_mnemonic_inc]     = effect_reads_first | effect_writes_first | effect_writes_flags | effect_reads_flags,
+	[x86_64_mnemonic_dec]     = effect_reads_first | effect_writes_first | effect_writes_flags | effect_reads_flags,
+	[x86_64_mnemonic_shl]     = effect_reads_first | effect_writes_first | effect_reads_second | effect_writes_flags | effect_reads_flags,
+	[x86_64_mnemonic_shr]     = effect_reads_first | effect_writes_first | effect_reads_second | effect_writes_flags | effect_reads_flags,
+	[x86_64_mnemonic_cmovcc]  = effect_reads_first | effect_writes_first | effect_reads_second | effect_reads_flags,
+	[x86_64_mnemonic_setcc]   = effect_writes_first | effect_reads_flags,
+	[x86_64_mnemonic_jmp]     = effect_branches,
+	[x86_64_mnemonic_jcc]     = effect_branches | effect_reads_flags,
+	[x86_64_mnemonic_call]    = effect_branches,
+	[x86_64_mnemonic_ret]     = effect_branches,
+	[x86_64_mnemonic_syscall] = effect_branches,
+};
+
+/**
+ * @brief Pattern of the peephole pass, which rewrites the instructions if the
+ * ones at the index match it.
+ * 
+ * @param instructions instruction list
+ * @param index        index of an operation in the instruction list
+ * 
+ * @return bool_t (true if it rewrote the instructions)
+ */
+typedef bool_t (*pattern_t)(
+	x86_64_instruction_list_s* const instructions,
+	const uint64_t index);
+
+/**
+ * @brief Get the registers that the operation reads and writes, and whether it
+ * reads or writes the flags.
+ * 
+ * @param instruction   operation
+ * @param reads         registers that it reads (bit per register)
+ * @param writes        registers that it writes (bit per register)
+ * @param reads_flags   whether it reads the flags
+ * @param writes_flags  whether it writes the flags
+ */
+static void get_accesses(
+	const x86_64_instruction_s* const instruction,
+	uint32_t* const reads,
+	uint32_t* const writes,
+	bool_t* const reads_flags,
+	bool_t* const writes_flags);
+
+/**
+ * @brief Check if nothing can be moved across the instruction.
+ * 
+ * @param instruction instruction to check
+ * 
+ * @return bool_t
+ */
+static bool_t is_barrier(
+	const x86_64_instruction_s* const instruction);
+
+/**
+ * @brief Check if the instruction is a comment, a label that is not jumped to,
+ * or a removed instruction.
+ * 
+ * @param instruction instruction to check
+ * 
+ * @return bool_t
+ */
+static bool_t is_transparent(
+	const x86_64_instruction_s* const instruction);
+
+/**
+ * @brief Find the first instruction at or after the index that is not
+ * transparent.
+ * 
+ * @param instructions instruction list
+ * @param index        index to start at
+ * 
+ * @return uint64_t (the count of the instructions if there is none)
+ */
+static uint64_t find_next(
+	const x86_64_instruction_list_s* const instructions,
+	const uint64_t index);
+
+/**
+ * @brief Check if the register (or the flags, if it is x86_64_register_none)
+ * is written before it is read on all the paths from the index.
+ * 
+ * @param instructions instruction list
+ * @param index        index to start at
+ * @param reg          register to check
+ * 
+ * @return bool_t (false if it cannot be told)
+ */
+static bool_t is_dead(
+	const x86_64_instruction_list_s* const instructions,
+	const uint64_t index,
+	const x86_64_register_e reg);
+
+/**
+ * @brief Check if the operand is the 64 bit register (which is not rsp).
+ * 
+ * @param operand operand to check
+ * 
+ * @return bool_t
+ */
+static bool_t is_general_register(
+	const x86_64_operand_s* const operand);
+
+/**
+ * @brief Insert the instruction before the index (the targets of the jumps are
+ * moved along with their labels).
+ * 
+ * @param instructions instruction list
+ * @param index        index to insert at
+ * @param instruction  instruction to insert
+ */
+static void insert_instruction(
+	x86_64_instruction_list_s* const instructions,
+	const uint64_t index,
+	const x86_64_instruction_s instruction);
+
+/**
+ * @brief 'push a' followed by 'pop b' is 'mov b, a' (or nothing at all if a
+ * and b are the same register).
+ */
+static bool_t apply_push_pop(
+	x86_64_instruction_list_s* const instructions,
+	const uint64_t index);
+
+/**
+ * @brief 'mov reg, imm32' followed by 'push reg' is 'push imm32' if the
+ * register is dead after the push.
+ */
+static bool_t apply_mov_push(
+	x86_64_instruction_list_s* const instructions,
+	const uint64_t index);
+
+/**
+ * @brief 'mov a, x' followed by 'mov b, a' is 'mov b, x' if a is dead after
+ * them.
+ */
+static bool_t apply_mov_copy(
+	x86_64_instruction_list_s* const instructions,
+	const uint64_t index);
+
+/**
+ * @brief 'cmovcc a, b' of a and b that hold 0 and 1 is 'setcc' of the low byte
+ * of a, which is zeroed beforehand (or zero extended afterwards if the flags
+ * are live where it is zeroed).
+ */
+static bool_t apply_cmov_setcc(
+	x86_64_instruction_list_s* const instructions,
+	const uint64_t index);
+
+/**
+ * @brief 'mov reg, 0' is 'xor reg32, reg32' if the flags are dead after it.
+ */
+static bool_t apply_mov_zero(
+	x86_64_instruction_list_s* const instructions,
+	const uint64_t index);
+
+/**
+ * @brief 'mov reg, reg' of the same 64 bit register is nothing.
+ */
+static bool_t apply_mov_self(
+	x86_64_instruction_list_s* const instructions,
+	const uint64_t index);
+
+// note: the patterns are tried in this order at every operation, so the ones
+//       that remove instructions go before the ones that only make them cheaper.
+static const pattern_t g_patterns[] =
+{
+	apply_push_pop,
+	apply_mov_push,
+	apply_mov_copy,
+	apply_cmov_setcc,
+	apply_mov_zero,
+	apply_mov_self,
+};
+
+uint64_t x86_64_peephole_optimize(
+	x86_64_instruction_list_s* const instructions)
+{
+	mirac_debug_assert(instructions != mirac_null);
+	x86_64_instruction_list_resolve_labels(instructions);
+
+	uint64_t rewrites_count = 0;
+	bool_t has_rewritten = true;
+
+	while (has_rewritten)
+	{
+		has_rewritten = false;
+
+		for (uint64_t index = 0; index < instructions->count; ++index)
+		{
+			for (uint64_t pattern_index = 0; pattern_index < (sizeof(g_patterns) / sizeof(g_patterns[0])); ++pattern_index)
+			{
+				if (instructions->data[index].type != x86_64_instruction_type_operation)
+				{
+					break;
+				}
+
+				if (g_patterns[pattern_index](instructions, index))
+				{
+					has_rewritten = true;
+					++rewrites_count;
+				}
+			}
+		}
+	}
+
+	return rewrites_count;
+}
+
+static void get_accesses(
+	const x86_64_instruction_s* const instruction,
+	uint32_t* const reads,
+	uint32_t* const writes,
+	bool_t* const reads_flags,
+	bool_t* const writes_flags)
+{
+	mirac_debug_assert(instruction != mirac_null);
+	mirac_debug_assert(x86_64_instruction_type_operation == instruction->type);
+
+	const uint8_t effects = g_effects[instruction->mnemonic];
+	*reads = 0;
+	*writes = 0;
+	*reads_flags = (effects & effect_reads_flags) != 0;
+	*writes_flags = (effects & effect_writes_flags) != 0;
+
+	for (uint8_t operand_index = 0; operand_index < instruction->operands_count; ++operand_index)
+	{
+		const x86_64_operand_s* const operand = &instruction->operands[operand_index];
+
+		if (x86_64_register_none == operand->reg)
+		{
+			continue;
+		}
+
+		const uint32_t bit = (uint32_t)1 << operand->reg;
+
+		if (x86_64_operand_type_memory == operand->type)
+		{
+			*reads |= bit;
+			continue;
+		}
+
+		const bool_t is_read = (0 == operand_index) ? ((effects & effect_reads_first) != 0) : ((effects & effect_reads_second) != 0);
+		const bool_t is_written = (0 == operand_index) && ((effects & effect_writes_first) != 0);
+
+		// note: writing 8 or 16 bits of a register keeps the rest of it.
+		if (is_read || (is_written && (operand->size < x86_64_size_32)))
+		{
+			*reads |= bit;
+		}
+
+		if (is_written)
+		{
+			*writes |= bit;
+		}
+	}
+
+	// note: xor and sub of a register with itself do not depend on its value.
+	if (((x86_64_mnemonic_xor == instruction->mnemonic) || (x86_64_mnemonic_sub == instruction->mnemonic)) &&
+		(x86_64_operand_type_register == instruction->operands[0].type) &&
+		(x86_64_operand_type_register == instruction->operands[1].type) &&
+		(instruction->operands[0].reg == instruction->operands[1].reg) &&
+		(instruction->operands[0].size >= x86_64_size_32))
+	{
+		*reads &= ~((uint32_t)1 << instruction->operands[0].reg);
+	}
+
+	if (x86_64_mnemonic_mul == instruction->mnemonic)
+	{
+		*reads |= (uint32_t)1 << x86_64_register_rax;
+		*writes |= ((uint32_t)1 << x86_64_register_rax) | ((uint32_t)1 << x86_64_register_rdx);
+	}
+
+	if (x86_64_mnemonic_div == instruction->mnemonic)
+	{
+		*reads |= ((uint32_t)1 << x86_64_register_rax) | ((uint32_t)1 << x86_64_register_rdx);
+		*writes |= ((uint32_t)1 << x86_64_register_rax) | ((uint32_t)1 << x86_64_register_rdx);
+	}
+
+	if ((x86_64_mnemonic_push == instruction->mnemonic) || (x86_64_mnemonic_pop == instruction->mnemonic))
+	{
+		*reads |= (uint32_t)1 << x86_64_register_rsp;
+		*writes |= (uint32_t)1 << x86_64_register_rsp;
+	}
+}
+
+static bool_t is_barrier(
+	const x86_64_instruction_s* const instruction)
+{
+	mirac_debug_assert(instruction != mirac_null);
+
+	switch (instruction->type)
+	{
+		case x86_64_instruction_type_operation: { return (g_effects[instruction->mnemonic] & effect_branches) != 0; } break;
+		case x86_64_instruction_type_label:     { return instruction->is_target; } break;
+		case x86_64_instruction_type_opaque:    { return true; } break;
+		default:                                { return false; } break;
+	}
+}
+
+static bool_t is_transparent(
+	const x86_64_instruction_s* const instruction)
+{
+	mirac_debug_assert(instruction != mirac_null);
+
+	return (x86_64_instruction_type_comment == instruction->type) || (x86_64_instruction_type_removed == instruction->type) ||
+		((x86_64_instruction_type_label == instruction->type) && !is_barrier(instruction));
+}
+
+static uint64_t find_next(
+	const x86_64_instruction_list_s* const instructions,
+	const uint64_t index)
+{
+	mirac_debug_assert(instructions != mirac_null);
+	uint64_t next_index = index;
+
+	while ((next_index < instructions->count) && is_transparent(&instructions->data[next_index]))
+	{
+		++next_index;
+	}
+
+	return next_index;
+}
+
+static bool_t is_dead(
+	const x86_64_instruction_list_s* const instructions,
+	const uint64_t index,
+	const x86_64_register_e reg)
+{
+	mirac_debug_assert(instructions != mirac_null);
+	mirac_debug_assert((reg < x86_64_registers_count) || (x86_64_register_none == reg));
+
+	// note: the paths are followed through the jumps to the labels of the code,
+	//       and each label is followed once (a path that comes back to it does
+	//       not read the register on the way). Anything else that branches ends
+	//       the search, as do too many paths or steps.
+	uint64_t paths[16] = { index };
+	uint64_t paths_count = 1;
+	uint64_t visited_labels[16] = {0};
+	uint64_t visited_labels_count = 0;
+	uint64_t steps_count = 0;
+
+	while (paths_count > 0)
+	{
+		bool_t is_path_done = false;
+
+		for (uint64_t next_index = paths[--paths_count]; !is_path_done; ++next_index)
+		{
+			if ((next_index >= instructions->count) || (++steps_count > 1024))
+			{
+				return false;
+			}
+
+			const x86_64_instruction_s* const instruction = &instructions->data[next_index];
+
+			if (instruction->type != x86_64_instruction_type_operation)
+			{
+				if (x86_64_instruction_type_opaque == instruction->type)
+				{
+					return false;
+				}
+
+				continue;
+			}
+
+			uint32_t reads = 0;
+			uint32_t writes = 0;
+			bool_t reads_flags = false;
+			bool_t writes_flags = false;
+			get_accesses(instruction, &reads, &writes, &reads_flags, &writes_flags);
+
+			const bool_t is_read = (x86_64_register_none == reg) ? reads_flags : ((reads & ((uint32_t)1 << reg)) != 0);
+			const bool_t is_written = (x86_64_register_none == reg) ? writes_flags : ((writes & ((uint32_t)1 << reg)) != 0);
+
+			if (is_read)
+			{
+				return false;
+			}
+
+			if (is_written)
+			{
+				is_path_done = true;
+				continue;
+			}
+
+			if ((x86_64_mnemonic_jmp != instruction->mnemonic) && (x86_64_mnemonic_jcc != instruction->mnemonic))
+			{
+				if (is_barrier(instruction))
+				{
+					return false;
+				}
+
+				continue;
+			}
+
+			if (UINT64_MAX == instruction->target)
+			{
+				return false;
+			}
+
+			bool_t is_visited = false;
+
+			for (uint64_t label_index = 0; (label_index < visited_labels_count) && !is_visited; ++label_index)
+			{
+				is_visited = (visited_labels[label_index] == instruction->target);
+			}
+
+			if (!is_visited)
+			{
+				if ((visited_labels_count >= (sizeof(visited_labels) / sizeof(visited_labels[0]))) ||
+					(paths_count >= (sizeof(paths) / sizeof(paths[0]))))
+				{
+					return false;
+				}
+
+				visited_labels[visited_labels_count++] = instruction->target;
+				paths[paths_count++] = instruction->target;
+			}
+
+			// note: only the conditional jumps fall through.
+			is_path_done = (x86_64_mnemonic_jmp == instruction->mnemonic);
+		}
+	}
+
+	return true;
+}
+
+static bool_t is_general_register(
+	const x86_64_operand_s* const operand)
+{
+	mirac_debug_assert(operand != mirac_null);
+
+	return (x86_64_operand_type_register == operand->type) && (x86_64_size_64 == operand->size) &&
+		(operand->reg != x86_64_register_rsp);
+}
+
+static void insert_instruction(
+	x86_64_instruction_list_s* const instructions,
+	const uint64_t index,
+	const x86_64_instruction_s instruction)
+{
+	mirac_debug_assert(instructions != mirac_null);
+	mirac_debug_assert(index <= instructions->count);
+
+	x86_64_instruction_list_push(instructions, instruction);
+
+	for (uint64_t move_index = instructions->count - 1; move_index > index; --move_index)
+	{
+		instructions->data[move_index] = instructions->data[move_index - 1];
+	}
+
+	instructions->data[index] = instruction;
+
+	for (uint64_t jump_index = 0; jump_index < instructions->count; ++jump_index)
+	{
+		if ((instructions->data[jump_index].target != UINT64_MAX) && (instructions->data[jump_index].target >= index))
+		{
+			++instructions->data[jump_index].target;
+		}
+	}
+}
+
+static bool_t apply_push_pop(
+	x86_64_instruction_list_s* const instructions,
+	const uint64_t index)
+{
+	x86_64_instruction_s* const push = &instructions->data[index];
+
+	if ((push->mnemonic != x86_64_mnemonic_push) ||
+		(!is_general_register(&push->operands[0]) &&
+		 (push->operands[0].type != x86_64_operand_type_immediate) &&
+		 (push->operands[0].type != x86_64_operand_type_symbol)))
+	{
+		return false;
+	}
+
+	const uint64_t pop_index = find_next(instructions, index + 1);
+
+	if (pop_index >= instructions->count)
+	{
+		return false;
+	}
+
+	x86_64_instruction_s* const pop = &instructions->data[pop_index];
+
+	if ((pop->type != x86_64_instruction_type_operation) || (pop->mnemonic != x86_64_mnemonic_pop) ||
+		!is_general_register(&pop->operands[0]))
+	{
+		return false;
+	}
+
+	if ((x86_64_operand_type_register == push->operands[0].type) && (push->operands[0].reg == pop->operands[0].reg))
+	{
+		push->type = x86_64_instruction_type_removed;
+	}
+	else
+	{
+		push->mnemonic = x86_64_mnemonic_mov;
+		push->operands[1] = push->operands[0];
+		push->operands[0] = pop->operands[0];
+		push->operands_count = 2;
+	}
+
+	pop->type = x86_64_instruction_type_removed;
+	return true;
+}
+
+static bool_t apply_mov_push(
+	x86_64_instruction_list_s* const instructions,
+	const uint64_t index)
+{
+	x86_64_instruction_s* const mov = &instructions->data[index];
+
+	// note: push sign extends its 32 bit immediate, and so does mov when the
+	//       immediate fits in it.
+	if ((mov->mnemonic != x86_64_mnemonic_mov) || !is_general_register(&mov->operands[0]) ||
+		((mov->operands[1].type != x86_64_operand_type_symbol) &&
+		 ((mov->operands[1].type != x86_64_operand_type_immediate) ||
+		  (mov->operands[1].immediate < INT32_MIN) || (mov->operands[1].immediate > INT32_MAX))))
+	{
+		return false;
+	}
+
+	const uint64_t push_index = find_next(instructions, index + 1);
+
+	if (push_index >= instructions->count)
+	{
+		return false;
+	}
+
+	x86_64_instruction_s* const push = &instructions->data[push_index];
+
+	if ((push->type != x86_64_instruction_type_operation) || (push->mnemonic != x86_64_mnemonic_push) ||
+		(push->operands[0].type != x86_64_operand_type_register) || (push->operands[0].reg != mov->operands[0].reg) ||
+		!is_dead(instructions, push_index + 1, mov->operands[0].reg))
+	{
+		return false;
+	}
+
+	push->operands[0] = mov->operands[1];
+	mov->type = x86_64_instruction_type_removed;
+	return true;
+}
+
+static bool_t apply_mov_copy(
+	x86_64_instruction_list_s* const instructions,
+	const uint64_t index)
+{
+	x86_64_instruction_s* const first = &instructions->data[index];
+
+	if ((first->mnemonic != x86_64_mnemonic_mov) || !is_general_register(&first->operands[0]) ||
+		(!is_general_register(&first->operands[1]) &&
+		 (first->operands[1].type != x86_64_operand_type_immediate) &&
+		 (first->operands[1].type != x86_64_operand_type_symbol)))
+	{
+		return false;
+	}
+
+	const uint64_t second_index = find_next(instructions, index + 1);
+
+	if (second_index >= instructions->count)
+	{
+		return false;
+	}
+
+	x86_64_instruction_s* const second = &instructions->data[second_index];
+
+	if ((second->type != x86_64_instruction_type_operation) || (second->mnemonic != x86_64_mnemonic_mov) ||
+		!is_general_register(&second->operands[0]) || !is_general_register(&second->operands[1]) ||
+		(second->operands[1].reg != first->operands[0].reg) ||
+		!is_dead(instructions, second_index + 1, first->operands[0].reg))
+	{
+		return false;
+	}
+
+	second->operands[1] = first->operands[1];
+	first->type = x86_64_instruction_type_removed;
+	return true;
+}
+
+static bool_t apply_cmov_setcc(
+	x86_64_instruction_list_s* const instructions,
+	const uint64_t index)
+{
+	x86_64_instruction_s* const cmov = &instructions->data[index];
+
+	if ((cmov->mnemonic != x86_64_mnemonic_cmovcc) || !is_general_register(&cmov->operands[0]) ||
+		!is_general_register(&cmov->operands[1]) || (cmov->operands[0].reg == cmov->operands[1].reg))
+	{
+		return false;
+	}
+
+	// note: the closest instructions before the cmov that touch its registers
+	//       have to be the ones that set them to 0 and 1.
+	const x86_64_register_e registers[2] = { cmov->operands[0].reg, cmov->operands[1].reg };
+	uint64_t setters[2] = { instructions->count, instructions->count };
+	int64_t values[2] = { -1, -1 };
+
+	for (uint64_t prior_index = index; (prior_index > 0) && ((setters[0] == instructions->count) || (setters[1] == instructions->count)); --prior_index)
+	{
+		const x86_64_instruction_s* const prior = &instructions->data[prior_index - 1];
+
+		if (is_transparent(prior))
+		{
+			continue;
+		}
+
+		if (is_barrier(prior))
+		{
+			return false;
+		}
+
+		uint32_t reads = 0;
+		uint32_t writes = 0;
+		bool_t reads_flags = false;
+		bool_t writes_flags = false;
+		get_accesses(prior, &reads, &writes, &reads_flags, &writes_flags);
+
+		for (uint8_t register_index = 0; register_index < 2; ++register_index)
+		{
+			const uint32_t bit = (uint32_t)1 << registers[register_index];
+
+			if ((setters[register_index] != instructions->count) || (0 == ((reads | writes) & bit)))
+			{
+				continue;
+			}
+
+			const bool_t is_mov = (x86_64_mnemonic_mov == prior->mnemonic) && (x86_64_operand_type_register == prior->operands[0].type) &&
+				(prior->operands[0].size >= x86_64_size_32) && (x86_64_operand_type_immediate == prior->operands[1].type) &&
+				((0 == prior->operands[1].immediate) || (1 == prior->operands[1].immediate));
+			const bool_t is_xor = (x86_64_mnemonic_xor == prior->mnemonic) && (0 == (reads & bit)) && (writes & bit);
+
+			if (!is_mov && !is_xor)
+			{
+				return false;
+			}
+
+			setters[register_index] = prior_index - 1;
+			values[register_index] = is_mov ? prior->operands[1].immediate : 0;
+		}
+	}
+
+	if ((setters[0] == instructions->count) || (setters[1] == instructions->count) || (values[0] == values[1]))
+	{
+		return false;
+	}
+
+	// note: the values of the cmov are swapped if it moves 0 over 1, and the
+	//       opposite condition keeps the 1.
+	const x86_64_condition_e condition = (0 == values[0]) ? cmov->condition : (x86_64_condition_e)(cmov->condition ^ 1);
+	const x86_64_register_e destination = registers[0];
+
+	// note: the source of the cmov keeps its value if it is still read later.
+	if (is_dead(instructions, index + 1, registers[1]))
+	{
+		instructions->data[setters[1]].type = x86_64_instruction_type_removed;
+	}
+
+	cmov->mnemonic = x86_64_mnemonic_setcc;
+	cmov->condition = condition;
+	cmov->operands[0] = x86_64_operand_from_register(destination, x86_64_size_08);
+	cmov->operands_count = 1;
+
+	x86_64_instruction_s* const setter = &instructions->data[setters[0]];
+
+	if (is_dead(instructions, setters[0] + 1, x86_64_register_none))
+	{
+		setter->mnemonic = x86_64_mnemonic_xor;
+		setter->operands[0] = x86_64_operand_from_register(destination, x86_64_size_32);
+		setter->operands[1] = x86_64_operand_from_register(destination, x86_64_size_32);
+		setter->operands_count = 2;
+	}
+	else
+	{
+		setter->type = x86_64_instruction_type_removed;
+
+		const x86_64_instruction_s movzx = x86_64_instruction_from_operation(x86_64_mnemonic_movzx,
+			x86_64_operand_from_register(destination, x86_64_size_32), x86_64_operand_from_register(destination, x86_64_size_08));
+
+		insert_instruction(instructions, index + 1, movzx);
+	}
+
+	return true;
+}
+
+static bool_t apply_mov_zero(
+	x86_64_instruction_list_s* const instructions,
+	const uint64_t index)
+{
+	x86_64_instruction_s* const mov = &instructions->data[index];
+
+	if ((mov->mnemonic != x86_64_mnemonic_mov) || (mov->operands[0].type != x86_64_operand_type_register) ||
+		(mov->operands[0].size < x86_64_size_32) || (x86_64_register_rsp == mov->operands[0].reg) ||
+		(mov->operands[1].type != x86_64_operand_type_immediate) || (mov->operands[1].immediate != 0) ||
+		!is_dead(instructions, index + 1, x86_64_register_none))
+	{
+		return false;
+	}
+
+	const x86_64_register_e destination = mov->operands[0].reg;
+	mov->mnemonic = x86_64_mnemonic_xor;
+	mov->operands[0] = x86_64_operand_from_register(destination, x86_64_size_32);
+	mov->operands[1] = x86_64_operand_from_register(destination, x86_64_size_32);
+	return true;
+}
+
+static bool_t apply_mov_self(
+	x86_64_instruction_list_s* const instructions,
+	const uint64_t index)
+{
+	x86_64_instruction_s* const mov = &instructions->data[index];
+
+	if ((mov->mnemonic != x86_64_mnemonic_mov) || !is_general_register(&mov->operands[0]) ||
+		!is_general_register(&mov->operands[1]) || (mov->operands[0].reg != mov->operands[1].reg))
+	{
+		return false;
+	}
+
+	mov->type = x86_64_instruction_type_removed;
+	return true;
+}
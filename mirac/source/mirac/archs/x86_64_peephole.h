@@ -0,0 +1,35 @@
+/**
+ * @file x86_64_peephole.h
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-04-22
+ */
+
+#ifndef __mirac__source__mirac__archs__x86_64_peephole_h__
+#define __mirac__source__mirac__archs__x86_64_peephole_h__
+
+#include <mirac/c_common.h>
+
+#include "./x86_64_instruction.h"
+
+// note: the peephole pass works on the instruction list of a single fun, which
+//       the backend selects the instructions into. The opaque instructions of
+//       the asm blocks are kept as they are, and nothing is moved across them.
+
+// todo: write unit tests!
+/**
+ * @brief Apply the patterns of the peephole pass to the instruction list until
+ * none of them applies anymore.
+ * 
+ * @param instructions instruction list to optimize
+ * 
+ * @return uint64_t number of the applied rewrites
+ */
+uint64_t x86_64_peephole_optimize(
+	x86_64_instruction_list_s* const instructions);
+
+#endif
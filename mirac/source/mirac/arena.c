@@ -1,4 +1,3 @@
-
 /**
  * @file arena.c
  * 
@@ -15,46 +14,150 @@
 #include <mirac/debug.h>
 #include <mirac/logger.h>
 
-mirac_node_s* mirac_node_from_size(
-	const uint64_t size)
+static mirac_string_view_s g_sites[mirac_arena_sites_count] =
 {
-	mirac_debug_assert(size > 0);
-	mirac_node_s* const node = (mirac_node_s* const)mirac_c_malloc(sizeof(mirac_node_s));
-	mirac_debug_assert(node != mirac_null);
+	[mirac_arena_site_other]      = mirac_string_view_static("other"),
+	[mirac_arena_site_lexer_text] = mirac_string_view_static("lexer text"),
+	[mirac_arena_site_tokens]     = mirac_string_view_static("tokens"),
+	[mirac_arena_site_ast_blocks] = mirac_string_view_static("ast blocks"),
+	[mirac_arena_site_ast_defs]   = mirac_string_view_static("ast defs"),
+	[mirac_arena_site_lists]      = mirac_string_view_static("lists"),
+	[mirac_arena_site_tables]     = mirac_string_view_static("tables"),
+	[mirac_arena_site_output]     = mirac_string_view_static("output"),
+};
 
-	if (mirac_null == node)
-	{
-		mirac_logger_error("internal failure -- failed to allocate memory node.");
-		mirac_c_exit(-1);
-	}
+/**
+ * @brief Align provided value up to the provided power of two alignment.
+ * 
+ * @param value     value to align
+ * @param alignment alignment to align the value to
+ * 
+ * @return uint64_t
+ */
+static uint64_t align_up(
+	const uint64_t value,
+	const uint64_t alignment);
+
+/**
+ * @brief Compute the capacity of the next regular chunk that can hold the
+ * provided size and advance the arena's geometric growth.
+ * 
+ * @param arena arena instance
+ * @param size  size that has to fit into the chunk
+ * 
+ * @return uint64_t
+ */
+static uint64_t take_next_chunk_capacity(
+	mirac_arena_s* const arena,
+	const uint64_t size);
+
+/**
+ * @brief Resolve the site of an allocation that does not name its site.
+ * 
+ * @param arena arena instance
+ * 
+ * @return mirac_arena_site_e
+ */
+static mirac_arena_site_e get_current_site(
+	const mirac_arena_s* const arena);
+
+/**
+ * @brief Allocate a new chunk for the arena, and account it for the site if the
+ * arena is accounted.
+ * 
+ * @param arena    arena instance
+ * @param capacity capacity of the chunk's data region
+ * @param site     site the chunk is allocated for
+ * 
+ * @return mirac_arena_chunk_s*
+ */
+static mirac_arena_chunk_s* allocate_chunk(
+	mirac_arena_s* const arena,
+	const uint64_t capacity,
+	const mirac_arena_site_e site);
 
-	node->pointer = (void*)mirac_c_malloc(size);
-	mirac_debug_assert(node->pointer != mirac_null);
+/**
+ * @brief Deallocate a chunk of the arena, and remove it from the reserved size
+ * if the arena is accounted.
+ * 
+ * @param arena arena instance
+ * @param chunk chunk to deallocate
+ */
+static void release_chunk(
+	mirac_arena_s* const arena,
+	mirac_arena_chunk_s* const chunk);
+
+/**
+ * @brief Account an allocation for the site if the arena is accounted.
+ * 
+ * @param arena arena instance
+ * @param size  requested size of the allocation
+ * @param site  site of the allocation
+ */
+static void account_allocation(
+	mirac_arena_s* const arena,
+	const uint64_t size,
+	const mirac_arena_site_e site);
+
+/**
+ * @brief Account the chunk memory reserved for the site in the arena's stats (if
+ * any are attached).
+ * 
+ * @param arena arena instance
+ * @param size  size of the reserved memory
+ * @param site  site to account the memory for
+ */
+static void account_reservation(
+	mirac_arena_s* const arena,
+	const uint64_t size,
+	const mirac_arena_site_e site);
 
-	if (mirac_null == node->pointer)
+mirac_string_view_s mirac_arena_site_to_string_view(
+	const mirac_arena_site_e site)
+{
+	mirac_debug_assert((site >= 0) && (site < mirac_arena_sites_count));
+	return g_sites[site];
+}
+
+mirac_arena_chunk_s* mirac_arena_chunk_from_capacity(
+	const uint64_t capacity)
+{
+	mirac_debug_assert(capacity > 0);
+	mirac_arena_chunk_s* const chunk = (mirac_arena_chunk_s* const)mirac_c_malloc(
+		sizeof(mirac_arena_chunk_s) + capacity);
+	mirac_debug_assert(chunk != mirac_null);
+
+	if (mirac_null == chunk)
 	{
-		mirac_logger_error("internal failure -- failed to allocate memory node's pointer.");
+		mirac_logger_error("internal failure -- failed to allocate arena chunk.");
 		mirac_c_exit(-1);
 	}
 
-	node->size = size;
-	node->next = mirac_null;
-	return node;
+	chunk->next = mirac_null;
+	chunk->capacity = capacity;
+	chunk->used = 0;
+	return chunk;
 }
 
-void mirac_node_destroy(
-	mirac_node_s* const node)
+void mirac_arena_chunk_destroy(
+	mirac_arena_chunk_s* const chunk)
 {
-	mirac_debug_assert(node != mirac_null);
-	mirac_debug_assert(node->pointer != mirac_null);
-	mirac_c_free(node->pointer);
-	mirac_c_free(node);
+	mirac_debug_assert(chunk != mirac_null);
+	mirac_c_free(chunk);
 }
 
 mirac_arena_s mirac_arena_from_parts(
 	void)
 {
-	return (mirac_arena_s) {0};
+	return (mirac_arena_s)
+	{
+		.begin               = mirac_null,
+		.end                 = mirac_null,
+		.next_chunk_capacity = mirac_arena_min_chunk_capacity,
+		.is_used             = false,
+		.site                = mirac_arena_site_none,
+		.stats               = mirac_null
+	};
 }
 
 void mirac_arena_destroy(
@@ -67,49 +170,382 @@ void mirac_arena_destroy(
 		return;
 	}
 
-	const mirac_node_s* node_iterator = arena->begin;
-	mirac_debug_assert(node_iterator != mirac_null);
+	mirac_arena_chunk_s* chunk_iterator = arena->begin;
+	mirac_debug_assert(chunk_iterator != mirac_null);
 
-	while (node_iterator)
+	while (chunk_iterator)
 	{
-		const mirac_node_s* const node = node_iterator;
-		mirac_debug_assert(node != mirac_null);
-		node_iterator = node_iterator->next;
-		mirac_node_destroy((mirac_node_s* const)node);
+		mirac_arena_chunk_s* const chunk = chunk_iterator;
+		mirac_debug_assert(chunk != mirac_null);
+		chunk_iterator = chunk_iterator->next;
+		release_chunk(arena, chunk);
 	}
 
-	arena->begin = mirac_null;
-	arena->end = mirac_null;
+	*arena = mirac_arena_from_parts();
+}
+
+void mirac_arena_reset(
+	mirac_arena_s* const arena)
+{
+	mirac_debug_assert(arena != mirac_null);
+
+	if (!arena->is_used)
+	{
+		return;
+	}
+
+	mirac_arena_chunk_s* chunk_iterator = arena->begin;
+	mirac_debug_assert(chunk_iterator != mirac_null);
+
+	while (chunk_iterator)
+	{
+		mirac_arena_chunk_s* const chunk = chunk_iterator;
+		chunk_iterator = chunk_iterator->next;
+
+		if (chunk != arena->end)
+		{
+			release_chunk(arena, chunk);
+		}
+	}
+
+	arena->begin = arena->end;
+	arena->end->next = mirac_null;
+	arena->end->used = 0;
+}
+
+void mirac_arena_set_stats(
+	mirac_arena_s* const arena,
+	mirac_arena_stats_s* const stats)
+{
+	mirac_debug_assert(arena != mirac_null);
+	arena->stats = stats;
+
+	if (mirac_null == stats)
+	{
+		return;
+	}
+
+	for (mirac_arena_chunk_s* chunk = arena->begin; chunk != mirac_null; chunk = chunk->next)
+	{
+		stats->reserved_size += chunk->capacity;
+	}
+
+	if (stats->reserved_size > stats->peak_reserved_size)
+	{
+		stats->peak_reserved_size = stats->reserved_size;
+	}
+}
+
+void mirac_arena_print_stats(
+	const mirac_arena_stats_s* const stats,
+	const mirac_string_view_s name)
+{
+	mirac_debug_assert(stats != mirac_null);
+
+	mirac_arena_site_stats_s total = {0};
+	mirac_logger_info("memory report of '" mirac_sv_fmt "':", mirac_sv_arg(name));
+	mirac_logger_log("    %-12s %14s %14s %12s %8s", "site", "requested", "reserved", "allocations", "chunks");
+
+	for (uint64_t site_index = 0; site_index < mirac_arena_sites_count; ++site_index)
+	{
+		const mirac_arena_site_stats_s* const site = &stats->sites[site_index];
+		mirac_logger_log("    %-12.*s %14lu %14lu %12lu %8lu", mirac_sv_arg(g_sites[site_index]),
+			site->requested_size, site->reserved_size, site->allocations_count, site->chunks_count);
+
+		total.requested_size += site->requested_size;
+		total.reserved_size += site->reserved_size;
+		total.allocations_count += site->allocations_count;
+		total.chunks_count += site->chunks_count;
+	}
+
+	mirac_logger_log("    %-12s %14lu %14lu %12lu %8lu", "total",
+		total.requested_size, total.reserved_size, total.allocations_count, total.chunks_count);
+	mirac_logger_log("    peak reserved: %lu bytes", stats->peak_reserved_size);
+}
+
+mirac_arena_site_e mirac_arena_set_site(
+	mirac_arena_s* const arena,
+	const mirac_arena_site_e site)
+{
+	mirac_debug_assert(arena != mirac_null);
+	mirac_debug_assert((site < mirac_arena_sites_count) || (mirac_arena_site_none == site));
+
+	const mirac_arena_site_e previous_site = arena->site;
+	arena->site = site;
+	return previous_site;
 }
 
 void* mirac_arena_malloc(
 	mirac_arena_s* const arena,
 	const uint64_t size)
+{
+	return mirac_arena_malloc_aligned_as(arena, size, mirac_arena_default_alignment, get_current_site(arena));
+}
+
+void* mirac_arena_malloc_aligned(
+	mirac_arena_s* const arena,
+	const uint64_t size,
+	const uint64_t alignment)
+{
+	return mirac_arena_malloc_aligned_as(arena, size, alignment, get_current_site(arena));
+}
+
+void* mirac_arena_malloc_as(
+	mirac_arena_s* const arena,
+	const uint64_t size,
+	const mirac_arena_site_e site)
+{
+	return mirac_arena_malloc_aligned_as(arena, size, mirac_arena_default_alignment, site);
+}
+
+void* mirac_arena_malloc_aligned_as(
+	mirac_arena_s* const arena,
+	const uint64_t size,
+	const uint64_t alignment,
+	const mirac_arena_site_e site)
 {
 	mirac_debug_assert(arena != mirac_null);
 	mirac_debug_assert(size > 0);
+	mirac_debug_assert((alignment > 0) && (0 == (alignment & (alignment - 1))));
+	mirac_debug_assert(alignment <= mirac_arena_default_alignment);
+	mirac_debug_assert((site >= 0) && (site < mirac_arena_sites_count));
 	arena->is_used = true;
+	account_allocation(arena, size, site);
+
+	if (arena->end != mirac_null)
+	{
+		const uint64_t offset = align_up(arena->end->used, alignment);
+
+		if ((offset <= arena->end->capacity) && (size <= (arena->end->capacity - offset)))
+		{
+			arena->end->used = offset + size;
+			return arena->end->data + offset;
+		}
+	}
+
+	if (size > mirac_arena_max_chunk_capacity)
+	{
+		// note: oversized allocations get a dedicated chunk, which is linked in front
+		//       of the list so that the current chunk keeps serving small allocations.
+		mirac_arena_chunk_s* const chunk = allocate_chunk(arena, size, site);
+		chunk->used = size;
+
+		if (mirac_null == arena->begin)
+		{
+			arena->begin = chunk;
+			arena->end = chunk;
+		}
+		else
+		{
+			chunk->next = arena->begin;
+			arena->begin = chunk;
+		}
+
+		return chunk->data;
+	}
+
+	mirac_arena_chunk_s* const chunk = allocate_chunk(arena,
+		take_next_chunk_capacity(arena, size), site);
+	chunk->used = size;
 
 	if (mirac_null == arena->end)
 	{
 		mirac_debug_assert(mirac_null == arena->begin);
-		arena->end = mirac_node_from_size(size);
-		mirac_debug_assert(arena->end != mirac_null);
-		arena->begin = arena->end;
+		arena->begin = chunk;
 	}
 	else
 	{
-		while (arena->end->next != mirac_null)
+		arena->end->next = chunk;
+	}
+
+	arena->end = chunk;
+	return chunk->data;
+}
+
+void* mirac_arena_realloc(
+	mirac_arena_s* const arena,
+	void* const pointer,
+	const uint64_t old_size,
+	const uint64_t new_size)
+{
+	return mirac_arena_realloc_as(arena, pointer, old_size, new_size, get_current_site(arena));
+}
+
+void* mirac_arena_realloc_as(
+	mirac_arena_s* const arena,
+	void* const pointer,
+	const uint64_t old_size,
+	const uint64_t new_size,
+	const mirac_arena_site_e site)
+{
+	mirac_debug_assert(arena != mirac_null);
+	mirac_debug_assert(new_size > 0);
+
+	if ((mirac_null == pointer) || (old_size <= 0))
+	{
+		return mirac_arena_malloc_as(arena, new_size, site);
+	}
+
+	if (new_size <= old_size)
+	{
+		return pointer;
+	}
+
+	mirac_arena_chunk_s* const chunk = arena->end;
+	mirac_debug_assert(chunk != mirac_null);
+	const uint8_t* const region = (const uint8_t*)pointer;
+
+	if ((region >= chunk->data) && ((region + old_size) == (chunk->data + chunk->used)))
+	{
+		const uint64_t offset = (uint64_t)(region - chunk->data);
+
+		if (new_size <= (chunk->capacity - offset))
+		{
+			account_allocation(arena, new_size - old_size, site);
+			chunk->used = offset + new_size;
+			return pointer;
+		}
+	}
+
+	if ((new_size > mirac_arena_max_chunk_capacity) && (old_size > mirac_arena_max_chunk_capacity))
+	{
+		// note: a region this large is the whole of a dedicated chunk (they are at
+		//       the front of the list), which is grown by the c allocator instead,
+		//       so that the arrays growing past the chunk limit are not copied and
+		//       abandoned at every doubling.
+		mirac_arena_chunk_s* prev_chunk = mirac_null;
+		mirac_arena_chunk_s* dedicated_chunk = arena->begin;
+
+		while ((dedicated_chunk != mirac_null) && (dedicated_chunk->capacity > mirac_arena_max_chunk_capacity) && (dedicated_chunk->data != region))
 		{
-			arena->end = arena->end->next;
+			prev_chunk = dedicated_chunk;
+			dedicated_chunk = dedicated_chunk->next;
 		}
 
-		arena->end->next = mirac_node_from_size(size);
-		mirac_debug_assert(arena->end->next != mirac_null);
-		arena->end = arena->end->next;
+		if ((dedicated_chunk != mirac_null) && (dedicated_chunk->data == region))
+		{
+			mirac_debug_assert(dedicated_chunk->used == old_size);
+			const uint64_t old_capacity = dedicated_chunk->capacity;
+			mirac_arena_chunk_s* const chunk_grown = (mirac_arena_chunk_s*)mirac_c_realloc(
+				dedicated_chunk, sizeof(mirac_arena_chunk_s) + new_size);
+
+			chunk_grown->capacity = new_size;
+			chunk_grown->used = new_size;
+			if (mirac_null == prev_chunk) { arena->begin = chunk_grown; } else { prev_chunk->next = chunk_grown; }
+			if (arena->end == dedicated_chunk) { arena->end = chunk_grown; }
+
+			account_allocation(arena, new_size - old_size, site);
+			account_reservation(arena, new_size - old_capacity, site);
+			return chunk_grown->data;
+		}
+	}
+
+	// note: the old region is abandoned, so the whole new one counts as requested.
+	void* const new_pointer = mirac_arena_malloc_as(arena, new_size, site);
+	mirac_c_memcpy(new_pointer, pointer, old_size);
+	return new_pointer;
+}
+
+static uint64_t align_up(
+	const uint64_t value,
+	const uint64_t alignment)
+{
+	return (value + (alignment - 1)) & ~(alignment - 1);
+}
+
+static uint64_t take_next_chunk_capacity(
+	mirac_arena_s* const arena,
+	const uint64_t size)
+{
+	mirac_debug_assert(arena != mirac_null);
+	mirac_debug_assert(size <= mirac_arena_max_chunk_capacity);
+
+	uint64_t capacity = arena->next_chunk_capacity;
+
+	while (capacity < size)
+	{
+		capacity *= 2;
 	}
 
-	void* const result = arena->end->pointer;
-	mirac_debug_assert(result != mirac_null);
-	return result;
+	arena->next_chunk_capacity = capacity < mirac_arena_max_chunk_capacity ?
+		capacity * 2 : mirac_arena_max_chunk_capacity;
+	return capacity;
+}
+
+static mirac_arena_site_e get_current_site(
+	const mirac_arena_s* const arena)
+{
+	mirac_debug_assert(arena != mirac_null);
+	return mirac_arena_scoped_site(arena, mirac_arena_site_other);
+}
+
+static mirac_arena_chunk_s* allocate_chunk(
+	mirac_arena_s* const arena,
+	const uint64_t capacity,
+	const mirac_arena_site_e site)
+{
+	mirac_debug_assert(arena != mirac_null);
+	mirac_arena_chunk_s* const chunk = mirac_arena_chunk_from_capacity(capacity);
+
+	if (arena->stats != mirac_null)
+	{
+		arena->stats->sites[site].chunks_count += 1;
+	}
+
+	account_reservation(arena, capacity, site);
+	return chunk;
+}
+
+static void release_chunk(
+	mirac_arena_s* const arena,
+	mirac_arena_chunk_s* const chunk)
+{
+	mirac_debug_assert(arena != mirac_null);
+	mirac_debug_assert(chunk != mirac_null);
+
+	// note: the stats may have been cleared while they were attached.
+	if ((arena->stats != mirac_null) && (arena->stats->reserved_size >= chunk->capacity))
+	{
+		arena->stats->reserved_size -= chunk->capacity;
+	}
+
+	mirac_arena_chunk_destroy(chunk);
+}
+
+static void account_allocation(
+	mirac_arena_s* const arena,
+	const uint64_t size,
+	const mirac_arena_site_e site)
+{
+	mirac_debug_assert(arena != mirac_null);
+
+	if (mirac_null == arena->stats)
+	{
+		return;
+	}
+
+	arena->stats->sites[site].requested_size += size;
+	arena->stats->sites[site].allocations_count += 1;
+}
+
+static void account_reservation(
+	mirac_arena_s* const arena,
+	const uint64_t size,
+	const mirac_arena_site_e site)
+{
+	mirac_debug_assert(arena != mirac_null);
+
+	if (mirac_null == arena->stats)
+	{
+		return;
+	}
+
+	mirac_arena_stats_s* const stats = arena->stats;
+	stats->sites[site].reserved_size += size;
+	stats->reserved_size += size;
+
+	if (stats->reserved_size > stats->peak_reserved_size)
+	{
+		stats->peak_reserved_size = stats->reserved_size;
+	}
 }
@@ -19,6 +19,8 @@
 #include <memory.h>
 #include <string.h>
 
+static _Thread_local mirac_c_exit_trap_s* g_exit_trap = mirac_null;
+
 void* mirac_c_malloc(
 	const uint64_t size)
 {
@@ -60,9 +62,21 @@ void mirac_c_free(
 void mirac_c_exit(
 	const int32_t code)
 {
+	if (g_exit_trap != mirac_null)
+	{
+		g_exit_trap->code = code;
+		longjmp(g_exit_trap->buffer, 1);
+	}
+
 	exit(code);
 }
 
+void mirac_c_set_exit_trap(
+	mirac_c_exit_trap_s* const trap)
+{
+	g_exit_trap = trap;
+}
+
 void mirac_c_memset(
 	void* const pointer,
 	const uint8_t value,
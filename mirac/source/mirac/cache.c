@@ -0,0 +1,886 @@
+/**
+ * @file cache.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-03-09
+ */
+
+#include <mirac/cache.h>
+
+#include <mirac/debug.h>
+#include <mirac/logger.h>
+#include <mirac/emitter.h>
+#include <mirac/version.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+/**
+ * @brief Magic number at the start of every cache entry ("mirac$01").
+ */
+#define entry_magic ((uint64_t)0x3130246361726963)
+
+#define hash_prime_1 ((uint64_t)0x9e3779b185ebca87)
+#define hash_prime_2 ((uint64_t)0xc2b2ae3d27d4eb4f)
+#define hash_prime_3 ((uint64_t)0x165667b19e3779f9)
+#define hash_prime_4 ((uint64_t)0x85ebca77c2b2ae63)
+#define hash_prime_5 ((uint64_t)0x27d4eb2f165667c5)
+
+typedef struct
+{
+	char_t* name;
+	uint64_t size;
+	struct timespec time;
+} cache_entry_info_s;
+
+/**
+ * @brief Rotate the value left by the provided number of bits.
+ * 
+ * @param value value to rotate
+ * @param bits  number of bits to rotate by
+ * 
+ * @return uint64_t
+ */
+static uint64_t rotate_left(
+	const uint64_t value,
+	const uint32_t bits);
+
+/**
+ * @brief Mix the input into the accumulator (xxh64 round).
+ * 
+ * @param accumulator accumulator to mix into
+ * @param input       input to mix
+ * 
+ * @return uint64_t
+ */
+static uint64_t hash_round(
+	uint64_t accumulator,
+	const uint64_t input);
+
+/**
+ * @brief Read an unaligned little endian 64 bit value.
+ * 
+ * @param data bytes to read from
+ * 
+ * @return uint64_t
+ */
+static uint64_t read_u64(
+	const uint8_t* const data);
+
+/**
+ * @brief Emit the length prefixed canonical path of the directory, or the path
+ * as it is if it cannot be canonicalized.
+ * 
+ * @param emitter   emitter to emit into
+ * @param directory path of the directory
+ */
+static void emit_canonical_directory(
+	mirac_emitter_s* const emitter,
+	const mirac_string_view_s directory);
+
+/**
+ * @brief Format the path of a file of the key's entry.
+ * 
+ * @param cache  cache instance
+ * @param key    key of the entry
+ * @param suffix suffix of the file name
+ * @param path   buffer of at least PATH_MAX chars
+ * 
+ * @return bool_t
+ */
+static bool_t format_entry_path(
+	const mirac_cache_s* const cache,
+	const mirac_cache_key_s* const key,
+	const char_t* const suffix,
+	char_t* const path);
+
+/**
+ * @brief Take the next bytes of a mapped entry, if there are enough of them.
+ * 
+ * @param entry  mapped entry
+ * @param offset offset of the bytes to take (advanced past them)
+ * @param length number of bytes to take
+ * 
+ * @return const uint8_t*
+ */
+static const uint8_t* take_entry_bytes(
+	const mirac_string_view_s entry,
+	uint64_t* const offset,
+	const uint64_t length);
+
+/**
+ * @brief Check if the file still has the provided size and content hash.
+ * 
+ * @param path path of the file (not null terminated)
+ * @param size expected size of the file
+ * @param hash expected hash of the file
+ * 
+ * @return bool_t
+ */
+static bool_t is_file_unchanged(
+	const mirac_string_view_s path,
+	const uint64_t size,
+	const uint64_t hash);
+
+/**
+ * @brief Write all the bytes into the file descriptor.
+ * 
+ * @param descriptor file descriptor to write into
+ * @param data       bytes to write
+ * @param length     number of bytes to write
+ * 
+ * @return bool_t
+ */
+static bool_t write_all(
+	const int32_t descriptor,
+	const void* const data,
+	const uint64_t length);
+
+/**
+ * @brief Write the entry into the temporary file.
+ * 
+ * @param descriptor       file descriptor of the temporary file
+ * @param preprocessor     preprocessor of the unit
+ * @param output_file_path path of the written output file
+ * 
+ * @return bool_t
+ */
+static bool_t write_entry(
+	const int32_t descriptor,
+	const mirac_preprocessor_s* const preprocessor,
+	const mirac_string_view_s output_file_path);
+
+/**
+ * @brief Create the directory and all of its missing parents.
+ * 
+ * @param directory directory to create
+ * 
+ * @return bool_t
+ */
+static bool_t make_directories(
+	const mirac_string_view_s directory);
+
+/**
+ * @brief Compare cache entries by the time of their last use (oldest first).
+ * 
+ * @param left  left entry
+ * @param right right entry
+ * 
+ * @return int
+ */
+static int compare_entries_by_time(
+	const void* left,
+	const void* right);
+
+/**
+ * @brief Recount the total size of the entries, and remove the least recently
+ * used ones if it exceeds the max size, until it is under three quarters of it.
+ * 
+ * @note Must be called with the cache's mutex locked once the cache is shared
+ * between threads.
+ * 
+ * @param cache cache instance
+ */
+static void evict_entries(
+	mirac_cache_s* const cache);
+
+mirac_cache_s mirac_cache_from_parts(
+	const mirac_string_view_s directory,
+	const uint64_t max_size)
+{
+	mirac_debug_assert(directory.data != mirac_null);
+
+	if ((directory.length <= 0) || !make_directories(directory))
+	{
+		mirac_logger_error("failed to create cache directory '" mirac_sv_fmt "'.", mirac_sv_arg(directory));
+		mirac_c_exit(-1);
+	}
+
+	pthread_mutex_t* const mutex = (pthread_mutex_t*)mirac_c_malloc(sizeof(pthread_mutex_t));
+
+	if (pthread_mutex_init(mutex, mirac_null) != 0)
+	{
+		mirac_logger_error("internal failure -- failed to create cache mutex.");
+		mirac_c_exit(-1);
+	}
+
+	mirac_cache_s cache = (mirac_cache_s)
+	{
+		.directory       = directory,
+		.max_size        = max_size,
+		.size            = 0,
+		.hits_count      = 0,
+		.misses_count    = 0,
+		.stores_count    = 0,
+		.evictions_count = 0,
+		.mutex           = mutex
+	};
+
+	// note: the size limit may have been lowered since the last build.
+	evict_entries(&cache);
+	return cache;
+}
+
+void mirac_cache_destroy(
+	mirac_cache_s* const cache)
+{
+	mirac_debug_assert(cache != mirac_null);
+	mirac_debug_assert(cache->mutex != mirac_null);
+
+	(void)pthread_mutex_destroy(cache->mutex);
+	mirac_c_free(cache->mutex);
+	*cache = (mirac_cache_s) {0};
+}
+
+uint64_t mirac_cache_hash(
+	const void* const data,
+	const uint64_t length,
+	const uint64_t seed)
+{
+	mirac_debug_assert((data != mirac_null) || (length <= 0));
+
+	const uint8_t* bytes = (const uint8_t*)data;
+	const uint8_t* const end = bytes + length;
+	uint64_t hash = 0;
+
+	if (length >= 32)
+	{
+		uint64_t lanes[4] =
+		{
+			seed + hash_prime_1 + hash_prime_2,
+			seed + hash_prime_2,
+			seed,
+			seed - hash_prime_1
+		};
+
+		for (; (end - bytes) >= 32; bytes += 32)
+		{
+			lanes[0] = hash_round(lanes[0], read_u64(bytes +  0));
+			lanes[1] = hash_round(lanes[1], read_u64(bytes +  8));
+			lanes[2] = hash_round(lanes[2], read_u64(bytes + 16));
+			lanes[3] = hash_round(lanes[3], read_u64(bytes + 24));
+		}
+
+		hash = rotate_left(lanes[0], 1) + rotate_left(lanes[1], 7) +
+			rotate_left(lanes[2], 12) + rotate_left(lanes[3], 18);
+
+		for (uint64_t lane_index = 0; lane_index < 4; ++lane_index)
+		{
+			hash ^= hash_round(0, lanes[lane_index]);
+			hash = (hash * hash_prime_1) + hash_prime_4;
+		}
+	}
+	else
+	{
+		hash = seed + hash_prime_5;
+	}
+
+	hash += length;
+
+	for (; (end - bytes) >= 8; bytes += 8)
+	{
+		hash ^= hash_round(0, read_u64(bytes));
+		hash = (rotate_left(hash, 27) * hash_prime_1) + hash_prime_4;
+	}
+
+	if ((end - bytes) >= 4)
+	{
+		const uint64_t word = (uint64_t)bytes[0] | ((uint64_t)bytes[1] << 8) |
+			((uint64_t)bytes[2] << 16) | ((uint64_t)bytes[3] << 24);
+		hash ^= word * hash_prime_1;
+		hash = (rotate_left(hash, 23) * hash_prime_2) + hash_prime_3;
+		bytes += 4;
+	}
+
+	for (; bytes < end; ++bytes)
+	{
+		hash ^= (*bytes) * hash_prime_5;
+		hash = rotate_left(hash, 11) * hash_prime_1;
+	}
+
+	hash ^= hash >> 33;
+	hash *= hash_prime_2;
+	hash ^= hash >> 29;
+	hash *= hash_prime_3;
+	hash ^= hash >> 32;
+	return hash;
+}
+
+mirac_cache_key_s mirac_cache_key_from_parts(
+	mirac_arena_s* const arena,
+	const mirac_config_s* const config,
+	const mirac_string_view_s source_file_path,
+	const mirac_string_view_s source)
+{
+	mirac_debug_assert(arena != mirac_null);
+	mirac_debug_assert(config != mirac_null);
+
+	// note: every variable length field is prefixed with its length, so that
+	//       different configs never serialize into the same bytes.
+	mirac_emitter_s emitter = mirac_emitter_from_parts(arena, mirac_null);
+	mirac_emitter_emit_static(&emitter, "mirac ");
+	mirac_emitter_emit_u64(&emitter, mirac_version_major);
+	mirac_emitter_emit_static(&emitter, ".");
+	mirac_emitter_emit_u64(&emitter, mirac_version_minor);
+	mirac_emitter_emit_static(&emitter, ".");
+	mirac_emitter_emit_u64(&emitter, mirac_version_patch);
+	mirac_emitter_emit_static(&emitter, " arch=");
+	mirac_emitter_emit_u64(&emitter, (uint64_t)config->arch);
+	mirac_emitter_emit_static(&emitter, " format=");
+	mirac_emitter_emit_u64(&emitter, (uint64_t)config->format);
+	mirac_emitter_emit_static(&emitter, " entry=");
+	mirac_emitter_emit_u64(&emitter, config->entry.length);
+	mirac_emitter_emit_static(&emitter, ":");
+	mirac_emitter_emit_string_view(&emitter, config->entry);
+	mirac_emitter_emit_static(&emitter, " unsafe=");
+	mirac_emitter_emit_u64(&emitter, config->unsafe ? 1 : 0);
+	mirac_emitter_emit_static(&emitter, " strip=");
+	mirac_emitter_emit_u64(&emitter, config->strip ? 1 : 0);
+	mirac_emitter_emit_static(&emitter, " optimization=");
+	mirac_emitter_emit_u64(&emitter, config->optimization);
+	mirac_emitter_emit_static(&emitter, " includes=");
+	mirac_emitter_emit_u64(&emitter, config->include_paths_count);
+
+	for (uint64_t path_index = 0; path_index < config->include_paths_count; ++path_index)
+	{
+		mirac_emitter_emit_static(&emitter, " ");
+		emit_canonical_directory(&emitter, config->include_paths[path_index]);
+	}
+
+	// note: the quoted includes are looked up in the directory of the main file
+	//       first, so it decides which files the same source includes.
+	uint64_t directory_length = source_file_path.length;
+	while ((directory_length > 0) && (source_file_path.data[directory_length - 1] != '/')) { --directory_length; }
+
+	mirac_emitter_emit_static(&emitter, " directory=");
+	emit_canonical_directory(&emitter, (0 == directory_length) ? mirac_string_view_from_parts(".", 1) :
+		mirac_string_view_from_parts(source_file_path.data, directory_length));
+
+	const uint64_t config_hash = mirac_cache_hash(emitter.data, emitter.length, 0);
+
+	return (mirac_cache_key_s)
+	{
+		.lanes[0] = mirac_cache_hash(source.data, source.length, config_hash),
+		.lanes[1] = mirac_cache_hash(source.data, source.length, config_hash ^ hash_prime_1)
+	};
+}
+
+bool_t mirac_cache_lookup(
+	mirac_cache_s* const cache,
+	const mirac_cache_key_s* const key,
+	mirac_file_t* const output_file)
+{
+	mirac_debug_assert(cache != mirac_null);
+	mirac_debug_assert(key != mirac_null);
+	mirac_debug_assert(output_file != mirac_null);
+
+	char_t path[PATH_MAX] = {0};
+	bool_t is_hit = false;
+	int32_t descriptor = -1;
+	struct stat status = {0};
+
+	if (format_entry_path(cache, key, "", path) &&
+		((descriptor = (int32_t)open(path, O_RDONLY)) >= 0) &&
+		(0 == fstat(descriptor, &status)) && (status.st_size > 0))
+	{
+		void* const data = mmap(mirac_null, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+		if (data != MAP_FAILED)
+		{
+			const mirac_string_view_s entry = mirac_string_view_from_parts((const char_t*)data, (uint64_t)status.st_size);
+			uint64_t offset = 0;
+			const uint8_t* bytes = take_entry_bytes(entry, &offset, 16);
+			is_hit = (bytes != mirac_null) && (entry_magic == read_u64(bytes));
+			const uint64_t files_count = is_hit ? read_u64(bytes + 8) : 0;
+
+			for (uint64_t file_index = 0; is_hit && (file_index < files_count); ++file_index)
+			{
+				bytes = take_entry_bytes(entry, &offset, 24);
+				const uint64_t path_length = bytes != mirac_null ? read_u64(bytes + 16) : 0;
+				const uint8_t* const file_path = bytes != mirac_null ? take_entry_bytes(entry, &offset, path_length) : mirac_null;
+				is_hit = (file_path != mirac_null) && is_file_unchanged(
+					mirac_string_view_from_parts((const char_t*)file_path, path_length), read_u64(bytes), read_u64(bytes + 8));
+			}
+
+			bytes = is_hit ? take_entry_bytes(entry, &offset, 8) : mirac_null;
+			const uint64_t assembly_length = bytes != mirac_null ? read_u64(bytes) : 0;
+			const uint8_t* const assembly = bytes != mirac_null ? take_entry_bytes(entry, &offset, assembly_length) : mirac_null;
+			is_hit = (assembly != mirac_null) && (offset == entry.length);
+
+			if (is_hit && (assembly_length > 0) && (fwrite(assembly, 1, assembly_length, output_file) != assembly_length))
+			{
+				mirac_logger_error("failed to write the cached assembly into the output file.");
+				mirac_c_exit(-1);
+			}
+
+			(void)munmap(data, (size_t)status.st_size);
+		}
+	}
+
+	if (is_hit)
+	{
+		// note: the modification time of an entry is the time of its last use,
+		//       which is what the eviction orders the entries by.
+		(void)futimens(descriptor, mirac_null);
+	}
+
+	if (descriptor >= 0)
+	{
+		(void)close(descriptor);
+	}
+
+	(void)__atomic_fetch_add(is_hit ? &cache->hits_count : &cache->misses_count, 1, __ATOMIC_RELAXED);
+	return is_hit;
+}
+
+void mirac_cache_store(
+	mirac_cache_s* const cache,
+	const mirac_cache_key_s* const key,
+	const mirac_preprocessor_s* const preprocessor,
+	const mirac_string_view_s output_file_path)
+{
+	mirac_debug_assert(cache != mirac_null);
+	mirac_debug_assert(key != mirac_null);
+	mirac_debug_assert(preprocessor != mirac_null);
+
+	static uint64_t s_temporary_files_count = 0;
+	const uint64_t temporary_file_index = __atomic_fetch_add(&s_temporary_files_count, 1, __ATOMIC_RELAXED);
+
+	char_t suffix[64] = {0};
+	(void)snprintf(suffix, sizeof(suffix), ".tmp.%ld.%lu", (long)getpid(), temporary_file_index);
+
+	char_t temporary_path[PATH_MAX] = {0};
+	char_t path[PATH_MAX] = {0};
+
+	if (!format_entry_path(cache, key, suffix, temporary_path) || !format_entry_path(cache, key, "", path))
+	{
+		mirac_logger_warn("failed to store cache entry -- path is too long.");
+		return;
+	}
+
+	// note: the entry becomes visible only once it is completely written, since
+	//       rename replaces the previous entry (if any) atomically.
+	const int32_t descriptor = (int32_t)open(temporary_path, O_WRONLY | O_CREAT | O_EXCL, 0644);
+	bool_t is_stored = descriptor >= 0;
+	struct stat status = {0};
+	uint64_t replaced_size = 0;
+
+	if (is_stored)
+	{
+		is_stored = write_entry(descriptor, preprocessor, output_file_path) && (0 == fstat(descriptor, &status));
+		is_stored = (0 == close(descriptor)) && is_stored;
+
+		// note: the size of a replaced entry is no longer used, the count stays an
+		//       estimate though, since other processes may share the directory.
+		struct stat replaced_status = {0};
+		if (is_stored && (0 == stat(path, &replaced_status)))
+		{
+			replaced_size = (uint64_t)replaced_status.st_size;
+		}
+
+		is_stored = is_stored && (0 == rename(temporary_path, path));
+
+		if (!is_stored)
+		{
+			(void)unlink(temporary_path);
+		}
+	}
+
+	if (!is_stored)
+	{
+		mirac_logger_warn("failed to store cache entry '%s'.", path);
+		return;
+	}
+
+	(void)pthread_mutex_lock(cache->mutex);
+	++cache->stores_count;
+	cache->size += (uint64_t)status.st_size;
+	cache->size -= (replaced_size < cache->size) ? replaced_size : cache->size;
+
+	if (cache->size > cache->max_size)
+	{
+		evict_entries(cache);
+	}
+
+	(void)pthread_mutex_unlock(cache->mutex);
+}
+
+void mirac_cache_print_statistics(
+	const mirac_cache_s* const cache)
+{
+	mirac_debug_assert(cache != mirac_null);
+	mirac_logger_info("cache: %lu hits, %lu misses, %lu stored, %lu evicted, %lu of %lu bytes used.",
+		cache->hits_count, cache->misses_count, cache->stores_count, cache->evictions_count,
+		cache->size, cache->max_size);
+}
+
+static uint64_t rotate_left(
+	const uint64_t value,
+	const uint32_t bits)
+{
+	return (value << bits) | (value >> (64 - bits));
+}
+
+static uint64_t hash_round(
+	uint64_t accumulator,
+	const uint64_t input)
+{
+	accumulator += input * hash_prime_2;
+	accumulator = rotate_left(accumulator, 31);
+	return accumulator * hash_prime_1;
+}
+
+static uint64_t read_u64(
+	const uint8_t* const data)
+{
+	mirac_debug_assert(data != mirac_null);
+
+	uint64_t value = 0;
+	mirac_c_memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+static void emit_canonical_directory(
+	mirac_emitter_s* const emitter,
+	const mirac_string_view_s directory)
+{
+	mirac_debug_assert(emitter != mirac_null);
+
+	char_t terminated_path[PATH_MAX] = {0};
+	char_t canonical_path[PATH_MAX] = {0};
+	mirac_string_view_s path = directory;
+
+	if (directory.length < sizeof(terminated_path))
+	{
+		mirac_c_memcpy(terminated_path, directory.data, directory.length);
+
+		if (realpath(terminated_path, canonical_path) != mirac_null)
+		{
+			path = mirac_string_view_from_cstring(canonical_path);
+		}
+	}
+
+	mirac_emitter_emit_u64(emitter, path.length);
+	mirac_emitter_emit_static(emitter, ":");
+	mirac_emitter_emit_string_view(emitter, path);
+}
+
+static bool_t format_entry_path(
+	const mirac_cache_s* const cache,
+	const mirac_cache_key_s* const key,
+	const char_t* const suffix,
+	char_t* const path)
+{
+	mirac_debug_assert(cache != mirac_null);
+	mirac_debug_assert(key != mirac_null);
+	mirac_debug_assert(suffix != mirac_null);
+	mirac_debug_assert(path != mirac_null);
+
+	const int32_t length = (int32_t)snprintf(path, PATH_MAX, mirac_sv_fmt "/%016lx%016lx%s",
+		mirac_sv_arg(cache->directory), key->lanes[0], key->lanes[1], suffix);
+	return (length > 0) && (length < PATH_MAX);
+}
+
+static const uint8_t* take_entry_bytes(
+	const mirac_string_view_s entry,
+	uint64_t* const offset,
+	const uint64_t length)
+{
+	mirac_debug_assert(offset != mirac_null);
+	mirac_debug_assert(*offset <= entry.length);
+
+	if (length > (entry.length - *offset))
+	{
+		return mirac_null;
+	}
+
+	const uint8_t* const bytes = (const uint8_t*)entry.data + *offset;
+	*offset += length;
+	return bytes;
+}
+
+static bool_t is_file_unchanged(
+	const mirac_string_view_s path,
+	const uint64_t size,
+	const uint64_t hash)
+{
+	char_t terminated_path[PATH_MAX] = {0};
+
+	if (path.length >= sizeof(terminated_path))
+	{
+		return false;
+	}
+
+	mirac_c_memcpy(terminated_path, path.data, path.length);
+	const int32_t descriptor = (int32_t)open(terminated_path, O_RDONLY);
+
+	if (descriptor < 0)
+	{
+		return false;
+	}
+
+	struct stat status = {0};
+	bool_t is_unchanged = (0 == fstat(descriptor, &status)) && ((uint64_t)status.st_size == size);
+
+	if (is_unchanged && (size > 0))
+	{
+		void* const data = mmap(mirac_null, (size_t)size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+		is_unchanged = (data != MAP_FAILED) && (mirac_cache_hash(data, size, 0) == hash);
+
+		if (data != MAP_FAILED)
+		{
+			(void)munmap(data, (size_t)size);
+		}
+	}
+	else if (is_unchanged)
+	{
+		is_unchanged = (mirac_cache_hash(mirac_null, 0, 0) == hash);
+	}
+
+	(void)close(descriptor);
+	return is_unchanged;
+}
+
+static bool_t write_all(
+	const int32_t descriptor,
+	const void* const data,
+	const uint64_t length)
+{
+	const uint8_t* bytes = (const uint8_t*)data;
+	uint64_t remaining = length;
+
+	while (remaining > 0)
+	{
+		const int64_t written = (int64_t)write(descriptor, bytes, (size_t)remaining);
+
+		if (written < 0)
+		{
+			if (EINTR == errno)
+			{
+				continue;
+			}
+
+			return false;
+		}
+
+		bytes += written;
+		remaining -= (uint64_t)written;
+	}
+
+	return true;
+}
+
+static bool_t write_entry(
+	const int32_t descriptor,
+	const mirac_preprocessor_s* const preprocessor,
+	const mirac_string_view_s output_file_path)
+{
+	mirac_debug_assert(preprocessor != mirac_null);
+
+	char_t terminated_path[PATH_MAX] = {0};
+
+	if (output_file_path.length >= sizeof(terminated_path))
+	{
+		return false;
+	}
+
+	mirac_c_memcpy(terminated_path, output_file_path.data, output_file_path.length);
+	const int32_t output_descriptor = (int32_t)open(terminated_path, O_RDONLY);
+	struct stat status = {0};
+
+	if ((output_descriptor < 0) || (fstat(output_descriptor, &status) != 0))
+	{
+		if (output_descriptor >= 0)
+		{
+			(void)close(output_descriptor);
+		}
+
+		return false;
+	}
+
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_emitter_s header = mirac_emitter_from_parts(&arena, mirac_null);
+
+	const uint64_t header_values[2] = { entry_magic, preprocessor->included_files.count };
+	mirac_emitter_emit(&header, (const char_t*)header_values, sizeof(header_values));
+
+	// note: the hashed bytes are the ones that were actually lexed, not the ones
+	//       on disk now, so a file edited during the build never gets cached.
+	for (uint64_t file_index = 0; file_index < preprocessor->included_files.count; ++file_index)
+	{
+		const mirac_preprocessor_file_s* const file = preprocessor->included_files.data[file_index];
+		const uint64_t file_values[3] =
+		{
+			file->lexer.source.length,
+			mirac_cache_hash(file->lexer.source.data, file->lexer.source.length, 0),
+			file->path.length
+		};
+
+		mirac_emitter_emit(&header, (const char_t*)file_values, sizeof(file_values));
+		mirac_emitter_emit_string_view(&header, file->path);
+	}
+
+	const uint64_t assembly_length = (uint64_t)status.st_size;
+	mirac_emitter_emit(&header, (const char_t*)&assembly_length, sizeof(assembly_length));
+	bool_t is_written = write_all(descriptor, header.data, header.length);
+	mirac_arena_destroy(&arena);
+
+	if (is_written && (assembly_length > 0))
+	{
+		void* const data = mmap(mirac_null, (size_t)assembly_length, PROT_READ, MAP_PRIVATE, output_descriptor, 0);
+		is_written = (data != MAP_FAILED) && write_all(descriptor, data, assembly_length);
+
+		if (data != MAP_FAILED)
+		{
+			(void)munmap(data, (size_t)assembly_length);
+		}
+	}
+
+	(void)close(output_descriptor);
+	return is_written;
+}
+
+static bool_t make_directories(
+	const mirac_string_view_s directory)
+{
+	char_t path[PATH_MAX] = {0};
+
+	if (directory.length >= sizeof(path))
+	{
+		return false;
+	}
+
+	mirac_c_memcpy(path, directory.data, directory.length);
+
+	for (uint64_t index = 1; index <= directory.length; ++index)
+	{
+		if ((index < directory.length) && (path[index] != '/'))
+		{
+			continue;
+		}
+
+		const char_t separator = path[index];
+		path[index] = '\0';
+
+		if ((mkdir(path, 0755) != 0) && (errno != EEXIST))
+		{
+			return false;
+		}
+
+		path[index] = separator;
+	}
+
+	struct stat status = {0};
+	return (0 == stat(path, &status)) && S_ISDIR(status.st_mode);
+}
+
+static int compare_entries_by_time(
+	const void* left,
+	const void* right)
+{
+	const cache_entry_info_s* const left_entry = (const cache_entry_info_s*)left;
+	const cache_entry_info_s* const right_entry = (const cache_entry_info_s*)right;
+
+	if (left_entry->time.tv_sec != right_entry->time.tv_sec)
+	{
+		return left_entry->time.tv_sec < right_entry->time.tv_sec ? -1 : 1;
+	}
+
+	if (left_entry->time.tv_nsec != right_entry->time.tv_nsec)
+	{
+		return left_entry->time.tv_nsec < right_entry->time.tv_nsec ? -1 : 1;
+	}
+
+	return 0;
+}
+
+static void evict_entries(
+	mirac_cache_s* const cache)
+{
+	mirac_debug_assert(cache != mirac_null);
+
+	char_t path[PATH_MAX] = {0};
+	(void)snprintf(path, sizeof(path), mirac_sv_fmt, mirac_sv_arg(cache->directory));
+	DIR* const directory = opendir(path);
+
+	if (mirac_null == directory)
+	{
+		return;
+	}
+
+	// note: the directory is recounted every time, since other builds may share
+	//       it and change its size.
+	mirac_arena_s arena = mirac_arena_from_parts();
+	cache_entry_info_s* entries = mirac_null;
+	uint64_t entries_count = 0;
+	uint64_t entries_capacity = 0;
+	uint64_t size = 0;
+
+	for (struct dirent* entry = readdir(directory); entry != mirac_null; entry = readdir(directory))
+	{
+		struct stat status = {0};
+
+		if (('.' == entry->d_name[0]) ||
+			(fstatat(dirfd(directory), entry->d_name, &status, AT_SYMLINK_NOFOLLOW) != 0) ||
+			!S_ISREG(status.st_mode))
+		{
+			continue;
+		}
+
+		if (entries_count >= entries_capacity)
+		{
+			const uint64_t capacity = entries_capacity > 0 ? entries_capacity * 2 : 64;
+			entries = (cache_entry_info_s*)mirac_arena_realloc(&arena, entries,
+				entries_capacity * sizeof(cache_entry_info_s), capacity * sizeof(cache_entry_info_s));
+			entries_capacity = capacity;
+		}
+
+		const uint64_t name_length = mirac_c_strlen(entry->d_name);
+		char_t* const name = (char_t*)mirac_arena_malloc_aligned(&arena, name_length + 1, 1);
+		mirac_c_memcpy(name, entry->d_name, name_length + 1);
+
+		entries[entries_count++] = (cache_entry_info_s)
+		{
+			.name = name,
+			.size = (uint64_t)status.st_size,
+			.time = status.st_mtim
+		};
+
+		size += (uint64_t)status.st_size;
+	}
+
+	if (size > cache->max_size)
+	{
+		qsort(entries, (size_t)entries_count, sizeof(cache_entry_info_s), compare_entries_by_time);
+		const uint64_t low_water_mark = (cache->max_size / 4) * 3;
+
+		for (uint64_t entry_index = 0; (entry_index < entries_count) && (size > low_water_mark); ++entry_index)
+		{
+			if (0 == unlinkat(dirfd(directory), entries[entry_index].name, 0))
+			{
+				size -= entries[entry_index].size;
+				++cache->evictions_count;
+			}
+			else if (ENOENT == errno)
+			{
+				// note: removed by another build in the meantime.
+				size -= entries[entry_index].size;
+			}
+		}
+	}
+
+	cache->size = size;
+	(void)closedir(directory);
+	mirac_arena_destroy(&arena);
+}
@@ -16,24 +16,35 @@
 #include <mirac/logger.h>
 
 #include "./archs/nasm_x86_64_linux.h"
+#include "./archs/elf_x86_64_linux.h"
 
 mirac_compiler_s mirac_compiler_from_parts(
 	mirac_config_s* const config,
 	mirac_arena_s* const arena,
 	mirac_ast_unit_s* const unit,
-	mirac_file_t* const file)
+	mirac_file_t* const file,
+	mirac_thread_pool_s* const pool,
+	mirac_profiler_unit_s* const profile)
 {
 	mirac_debug_assert(config != mirac_null);
 	mirac_debug_assert(arena != mirac_null);
 	mirac_debug_assert(unit != mirac_null);
 	mirac_debug_assert(file != mirac_null);
 
+	mirac_emitter_s emitter = mirac_emitter_from_parts(arena, file);
+	emitter.profile = profile;
+
 	return (mirac_compiler_s)
 	{
-		.config = config,
-		.arena  = arena,
-		.unit   = unit,
-		.file   = file
+		.config     = config,
+		.arena      = arena,
+		.scratch    = mirac_null,
+		.unit       = unit,
+		.emitter    = emitter,
+		.pool       = pool,
+		.profile    = profile,
+		.cache      = {0},
+		.else_cache = {0}
 	};
 }
 
@@ -44,12 +55,25 @@ void mirac_compiler_compile_ast_unit(
 	mirac_debug_assert(compiler->config != mirac_null);
 	mirac_debug_assert(compiler->arena != mirac_null);
 	mirac_debug_assert(compiler->unit != mirac_null);
-	mirac_debug_assert(compiler->file != mirac_null);
+	mirac_debug_assert(compiler->emitter.file != mirac_null);
+
+	// note: the instruction lists of the funs only live until the fun is written
+	//       or encoded, so they never pile up in the compiler's arena.
+	mirac_arena_s scratch = mirac_arena_from_parts();
+	mirac_arena_set_stats(&scratch, compiler->arena->stats);
+	compiler->scratch = &scratch;
 
 	// todo: make this architecture and format thing more modular!
 	if ((mirac_config_arch_type_x86_64 == compiler->config->arch) && (mirac_config_format_type_nasm == compiler->config->format))
 	{
 		nasm_x86_64_linux_compile_ast_unit(compiler);
+		mirac_emitter_flush(&compiler->emitter);
+	}
+	else if ((mirac_config_arch_type_x86_64 == compiler->config->arch) && ((mirac_config_format_type_elf64 == compiler->config->format) ||
+		(mirac_config_format_type_elf64_exec == compiler->config->format)))
+	{
+		elf_x86_64_linux_compile_ast_unit(compiler);
+		mirac_emitter_flush(&compiler->emitter);
 	}
 	else
 	{  // todo: rework this else!
@@ -57,6 +81,8 @@ void mirac_compiler_compile_ast_unit(
 			mirac_sv_arg(mirac_config_arch_type_to_string_view(compiler->config->arch)),
 			mirac_sv_arg(mirac_config_format_type_to_string_view(compiler->config->format))
 		);
-		return;
 	}
+
+	mirac_arena_destroy(&scratch);
+	compiler->scratch = mirac_null;
 }
@@ -16,6 +16,8 @@
 #include <mirac/debug.h>
 #include <mirac/logger.h>
 #include <mirac/c_common.h>
+#include <mirac/thread_pool.h>
+#include <mirac/cache.h>
 
 #include <getopt.h>
 
@@ -27,6 +29,8 @@ static mirac_string_view_s g_supported_architectures[mirac_config_arch_types_cou
 static mirac_string_view_s g_supported_formats[mirac_config_format_types_count] =
 {
 	[mirac_config_format_type_nasm] = mirac_string_view_static("nasm"),
+	[mirac_config_format_type_elf64] = mirac_string_view_static("elf64"),
+	[mirac_config_format_type_elf64_exec] = mirac_string_view_static("elf64-exec"),
 };
 
 static const char_t* const g_usage_banner =
@@ -36,11 +40,25 @@ static const char_t* const g_usage_banner =
 	"    -h, --help                 print the help message\n"
 	"    -v, --version              print version and exit\n"
 	"    -a, --arch <target>        set the architecture for the output\n"
-	"    -f, --format <value>       set the assembly format for the output\n"
+	"    -f, --format <value>       set the assembly (or object, or executable) format for the output\n"
 	"    -e, --entry <symbol>       set the entry symbol\n"
 	"    -d, --dump_ast             dump generated ast into text file near output file\n"
 	"    -u, --unsafe               disable checker\n"
 	"    -s, --strip                strip unused code in the output\n"
+	"    -O, --optimize <level>     set the optimization level of the output (0 or 1, in all the formats)\n"
+	"    -j, --jobs <count>         compile up to count src+out pairs in parallel\n"
+	"    -I, --include <dir>        add the directory to the include search paths\n"
+	"        --cache-dir <dir>      reuse the outputs of unchanged units from the directory\n"
+	"        --cache-size <size>    bound the cache directory size (bytes, or k/m/g suffixed)\n"
+	"        --serve <socket>       serve compile requests on the unix socket (jobs of them at once)\n"
+	"        --watch                recompile the src+out pairs whenever their inputs change\n"
+	"        --time-report          print the wall and cpu times of the compilation phases\n"
+	"        --trace=<file>         write a chrome trace of the units and their defs into the file\n"
+	"        --mem-report           print the memory of every unit by allocation site\n"
+	"        --prelex               lex the whole unit into a token array before parsing it\n"
+	"\n"
+	"environment:\n"
+	"    MIRAC_SERVER=<socket>      forward the compilation to the server on the socket (if any)\n"
 	"\n"
 	"notice:\n"
 	"    this executable is distributed under the \"mira gplv1\" license.\n";
@@ -80,33 +98,63 @@ mirac_config_s mirac_config_from_cli(
 	typedef struct option option_s;
 	static const option_s options[] =
 	{
-		{ "help",       no_argument,       0, 'h' },
-		{ "version",    no_argument,       0, 'v' },
-		{ "arch",       required_argument, 0, 'a' },
-		{ "format",     required_argument, 0, 'f' },
-		{ "entry",      required_argument, 0, 'e' },
-		{ "dump_ast",   no_argument,       0, 'd' },
-		{ "unsafe",     no_argument,       0, 'u' },
-		{ "strip",      no_argument,       0, 's' },
+		{ "help",        no_argument,       0, 'h' },
+		{ "version",     no_argument,       0, 'v' },
+		{ "arch",        required_argument, 0, 'a' },
+		{ "format",      required_argument, 0, 'f' },
+		{ "entry",       required_argument, 0, 'e' },
+		{ "dump_ast",    no_argument,       0, 'd' },
+		{ "unsafe",      no_argument,       0, 'u' },
+		{ "strip",       no_argument,       0, 's' },
+		{ "optimize",    required_argument, 0, 'O' },
+		{ "jobs",        required_argument, 0, 'j' },
+		{ "include",     required_argument, 0, 'I' },
+		{ "cache-dir",   required_argument, 0, 'C' }, // note: long only option.
+		{ "cache-size",  required_argument, 0, 'Z' }, // note: long only option.
+		{ "serve",       required_argument, 0, 'S' }, // note: long only option.
+		{ "watch",       no_argument,       0, 'W' }, // note: long only option.
+		{ "time-report", no_argument,       0, 'T' }, // note: long only option.
+		{ "trace",       required_argument, 0, 'R' }, // note: long only option.
+		{ "mem-report",  no_argument,       0, 'M' }, // note: long only option.
+		{ "prelex",      no_argument,       0, 'P' }, // note: long only option.
 		{ 0, 0, 0, 0 }
 	};
 
 	mirac_config_s config = (mirac_config_s)
 	{
-		.arch     = mirac_config_arch_type_none,
-		.format   = mirac_config_format_type_none,
-		.entry    = mirac_string_view_from_parts("main", 4),
-		.dump_ast = false,
-		.unsafe   = false,
-		.strip    = false
+		.arch                = mirac_config_arch_type_none,
+		.format              = mirac_config_format_type_none,
+		.entry               = mirac_string_view_from_parts("main", 4),
+		.dump_ast            = false,
+		.unsafe              = false,
+		.strip               = false,
+		.optimization        = 0,
+		.jobs                = 1,
+		.include_paths       = mirac_null,
+		.include_paths_count = 0,
+		.cache_dir           = mirac_string_view_from_parts("", 0),
+		.cache_size          = mirac_cache_default_max_size,
+		.socket_path         = mirac_string_view_from_parts("", 0),
+		.watch               = false,
+		.time_report         = false,
+		.trace_path          = mirac_string_view_from_parts("", 0),
+		.mem_report          = false,
+		.prelex              = false
 	};
 
 	mirac_string_view_s parsed_arch = mirac_string_view_from_parts("", 0);
 	mirac_string_view_s parsed_format = mirac_string_view_from_parts("", 0);
 	mirac_string_view_s parsed_entry = mirac_string_view_from_parts("", 0);
+	mirac_string_view_s parsed_optimization = mirac_string_view_from_parts("", 0);
+	mirac_string_view_s parsed_jobs = mirac_string_view_from_parts("", 0);
+	mirac_string_view_s parsed_cache_size = mirac_string_view_from_parts("", 0);
 	int32_t parsed_option = -1;
 
-	while ((parsed_option = (int32_t)getopt_long(argc, (char_t* const *)argv, "hva:f:e:dus", options, mirac_null)) != -1)
+	// note: the server parses the command line of every request, so getopt has to
+	//       start over each time.
+	optind = 0;
+
+	while ((parsed_option = (int32_t)getopt_long(argc, (char_t* const *)argv, "hva:f:e:dusO:j:I:", options, mirac_null)) != -1)
 	{
 		switch (parsed_option)
 		{
@@ -152,6 +200,64 @@ mirac_config_s mirac_config_from_cli(
 				config.strip = true;
 			} break;
 
+			case 'O':
+			{
+				parsed_optimization = mirac_string_view_from_cstring((const char_t*)optarg);
+			} break;
+
+			case 'j':
+			{
+				parsed_jobs = mirac_string_view_from_cstring((const char_t*)optarg);
+			} break;
+
+			case 'I':
+			{
+				// note: the include paths live as long as the process does.
+				config.include_paths = (mirac_string_view_s*)mirac_c_realloc(config.include_paths,
+					(config.include_paths_count + 1) * sizeof(mirac_string_view_s));
+				config.include_paths[config.include_paths_count++] = mirac_string_view_from_cstring((const char_t*)optarg);
+			} break;
+
+			case 'C':
+			{
+				config.cache_dir = mirac_string_view_from_cstring((const char_t*)optarg);
+			} break;
+
+			case 'Z':
+			{
+				parsed_cache_size = mirac_string_view_from_cstring((const char_t*)optarg);
+			} break;
+
+			case 'S':
+			{
+				config.socket_path = mirac_string_view_from_cstring((const char_t*)optarg);
+			} break;
+
+			case 'W':
+			{
+				config.watch = true;
+			} break;
+
+			case 'T':
+			{
+				config.time_report = true;
+			} break;
+
+			case 'R':
+			{
+				config.trace_path = mirac_string_view_from_cstring((const char_t*)optarg);
+			} break;
+
+			case 'M':
+			{
+				config.mem_report = true;
+			} break;
+
+			case 'P':
+			{
+				config.prelex = true;
+			} break;
+
 			default:
 			{
 				mirac_logger_error("invalid command line option.");
@@ -161,6 +267,18 @@ mirac_config_s mirac_config_from_cli(
 		}
 	}
 
+	const bool_t is_serving = config.socket_path.length > 0;
+
+	if (is_serving && config.watch)
+	{
+		mirac_logger_error("the '--serve' and '--watch' options cannot be combined.");
+		mirac_config_usage();
+		mirac_c_exit(-1);
+	}
+
+	// note: the server compiles with the options of every request, so it does not
+	//       need any of its own.
+	if (!is_serving)
 	{
 		if (parsed_arch.length <= 0)
 		{
@@ -186,6 +304,7 @@ mirac_config_s mirac_config_from_cli(
 		}
 	}
 
+	if (!is_serving)
 	{
 		if (parsed_format.length <= 0)
 		{
@@ -211,7 +330,108 @@ mirac_config_s mirac_config_from_cli(
 		}
 	}
 
-	if (config.entry = parsed_entry, config.entry.length <= 0)
+	if (parsed_optimization.length > 0)
+	{
+		const char_t digit = parsed_optimization.data[0];
+
+		if ((parsed_optimization.length != 1) || (digit < '0') || (digit > ('0' + mirac_config_max_optimization_level)))
+		{
+			mirac_logger_error("invalid optimization level '" mirac_sv_fmt "' was provided (expected a number in range [0, %u]).",
+				mirac_sv_arg(parsed_optimization), mirac_config_max_optimization_level);
+			mirac_config_usage();
+			mirac_c_exit(-1);
+		}
+
+		config.optimization = (uint64_t)(digit - '0');
+	}
+
+	if (parsed_jobs.length > 0)
+	{
+		uint64_t jobs = 0;
+
+		for (uint64_t char_index = 0; char_index < parsed_jobs.length; ++char_index)
+		{
+			const char_t digit = parsed_jobs.data[char_index];
+
+			if ((digit < '0') || (digit > '9') || (jobs > mirac_thread_pool_max_workers_count))
+			{
+				jobs = 0;
+				break;
+			}
+
+			jobs = (jobs * 10) + (uint64_t)(digit - '0');
+		}
+
+		if ((jobs <= 0) || (jobs > mirac_thread_pool_max_workers_count))
+		{
+			mirac_logger_error("invalid jobs count '" mirac_sv_fmt "' was provided (expected a number in range [1, %u]).",
+				mirac_sv_arg(parsed_jobs), mirac_thread_pool_max_workers_count);
+			mirac_config_usage();
+			mirac_c_exit(-1);
+		}
+
+		config.jobs = jobs;
+	}
+
+	if (parsed_cache_size.length > 0)
+	{
+		uint64_t cache_size = 0;
+		uint64_t unit = 1;
+		bool_t is_valid = true;
+
+		for (uint64_t char_index = 0; (char_index < parsed_cache_size.length) && is_valid; ++char_index)
+		{
+			const char_t digit = parsed_cache_size.data[char_index];
+
+			if ((digit >= '0') && (digit <= '9') && (cache_size <= (UINT64_MAX / 10)))
+			{
+				cache_size = (cache_size * 10) + (uint64_t)(digit - '0');
+				continue;
+			}
+
+			const bool_t is_last = (char_index + 1) == parsed_cache_size.length;
+			is_valid = is_last && (char_index > 0);
+
+			switch (digit)
+			{
+				case 'k':
+				case 'K':
+				{
+					unit = (uint64_t)1 << 10;
+				} break;
+
+				case 'm':
+				case 'M':
+				{
+					unit = (uint64_t)1 << 20;
+				} break;
+
+				case 'g':
+				case 'G':
+				{
+					unit = (uint64_t)1 << 30;
+				} break;
+
+				default:
+				{
+					is_valid = false;
+				} break;
+			}
+		}
+
+		if (!is_valid || (cache_size <= 0) || (cache_size > (UINT64_MAX / unit)))
+		{
+			mirac_logger_error("invalid cache size '" mirac_sv_fmt "' was provided.", mirac_sv_arg(parsed_cache_size));
+			mirac_config_usage();
+			mirac_c_exit(-1);
+		}
+
+		config.cache_size = cache_size * unit;
+	}
+
+	config.entry = parsed_entry;
+
+	if (!is_serving && (config.entry.length <= 0))
 	{
 		mirac_logger_error("no entry symbol was provided.");
 		mirac_config_usage();
@@ -0,0 +1,233 @@
+/**
+ * @file emitter.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-01-24
+ */
+
+#include <mirac/emitter.h>
+
+#include <mirac/debug.h>
+#include <mirac/logger.h>
+
+#include <unistd.h>
+#include <errno.h>
+
+static const char_t g_digit_pairs[201] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+/**
+ * @brief Write bytes into the file with as few write calls as possible.
+ * 
+ * @param file   file to write into
+ * @param data   bytes to write
+ * @param length number of bytes to write
+ */
+static void write_into_file(
+	mirac_file_t* const file,
+	const char_t* const data,
+	const uint64_t length);
+
+/**
+ * @brief Grow the buffer of an emitter without a file to fit at least the
+ * provided length.
+ * 
+ * @param emitter emitter instance
+ * @param length  length the buffer has to fit
+ */
+static void grow_buffer(
+	mirac_emitter_s* const emitter,
+	const uint64_t length);
+
+mirac_emitter_s mirac_emitter_from_parts(
+	mirac_arena_s* const arena,
+	mirac_file_t* const file)
+{
+	mirac_debug_assert(arena != mirac_null);
+
+	return (mirac_emitter_s)
+	{
+		.arena    = arena,
+		.file     = file,
+		.data     = mirac_null,
+		.length   = 0,
+		.capacity = 0,
+		.profile  = mirac_null
+	};
+}
+
+void mirac_emitter_emit(
+	mirac_emitter_s* const emitter,
+	const char_t* const data,
+	const uint64_t length)
+{
+	mirac_debug_assert(emitter != mirac_null);
+	mirac_debug_assert(data != mirac_null);
+
+	if ((emitter->length + length) > emitter->capacity)
+	{
+		if (mirac_null == emitter->file)
+		{
+			grow_buffer(emitter, emitter->length + length);
+		}
+		else
+		{
+			mirac_emitter_flush(emitter);
+
+			if (length > mirac_emitter_capacity)
+			{
+				write_into_file(emitter->file, data, length);
+				return;
+			}
+
+			if (mirac_null == emitter->data)
+			{
+				emitter->data = (char_t*)mirac_arena_malloc_as(emitter->arena, mirac_emitter_capacity, mirac_arena_site_output);
+				emitter->capacity = mirac_emitter_capacity;
+			}
+		}
+	}
+
+	mirac_c_memcpy(emitter->data + emitter->length, data, length);
+	emitter->length += length;
+}
+
+void mirac_emitter_emit_string_view(
+	mirac_emitter_s* const emitter,
+	const mirac_string_view_s string_view)
+{
+	mirac_emitter_emit(emitter, string_view.data, string_view.length);
+}
+
+void mirac_emitter_emit_u64(
+	mirac_emitter_s* const emitter,
+	const uint64_t value)
+{
+	// note: digits are produced two at a time from the end of the buffer.
+	char_t digits[20] = {0};
+	uint64_t index = sizeof(digits);
+	uint64_t remaining = value;
+
+	while (remaining >= 100)
+	{
+		const uint64_t pair = (remaining % 100) * 2;
+		remaining /= 100;
+		digits[--index] = g_digit_pairs[pair + 1];
+		digits[--index] = g_digit_pairs[pair];
+	}
+
+	if (remaining >= 10)
+	{
+		digits[--index] = g_digit_pairs[(remaining * 2) + 1];
+		digits[--index] = g_digit_pairs[remaining * 2];
+	}
+	else
+	{
+		digits[--index] = (char_t)('0' + remaining);
+	}
+
+	mirac_emitter_emit(emitter, digits + index, sizeof(digits) - index);
+}
+
+void mirac_emitter_emit_i64(
+	mirac_emitter_s* const emitter,
+	const int64_t value)
+{
+	if (value < 0)
+	{
+		mirac_emitter_emit_static(emitter, "-");
+		mirac_emitter_emit_u64(emitter, (uint64_t)0 - (uint64_t)value);
+		return;
+	}
+
+	mirac_emitter_emit_u64(emitter, (uint64_t)value);
+}
+
+void mirac_emitter_flush(
+	mirac_emitter_s* const emitter)
+{
+	mirac_debug_assert(emitter != mirac_null);
+
+	if ((mirac_null == emitter->file) || (emitter->length <= 0))
+	{
+		return;
+	}
+
+	if (mirac_null == emitter->profile)
+	{
+		write_into_file(emitter->file, emitter->data, emitter->length);
+	}
+	else
+	{
+		const mirac_profiler_phase_e phase = mirac_profiler_unit_switch_phase(emitter->profile, mirac_profiler_phase_write);
+		write_into_file(emitter->file, emitter->data, emitter->length);
+		(void)mirac_profiler_unit_switch_phase(emitter->profile, phase);
+	}
+
+	emitter->length = 0;
+}
+
+static void write_into_file(
+	mirac_file_t* const file,
+	const char_t* const data,
+	const uint64_t length)
+{
+	mirac_debug_assert(file != mirac_null);
+	mirac_debug_assert(data != mirac_null);
+
+	// note: the emitter bypasses stdio, so anything already buffered in the file has
+	//       to be written out first to keep the output in order.
+	(void)fflush(file);
+	const int32_t descriptor = fileno(file);
+	uint64_t written = 0;
+
+	while (written < length)
+	{
+		const ssize_t result = write(descriptor, data + written, length - written);
+
+		if (result < 0)
+		{
+			if (EINTR == errno)
+			{
+				continue;
+			}
+
+			mirac_logger_error("internal failure -- failed to write the output file.");
+			mirac_c_exit(-1);
+		}
+
+		written += (uint64_t)result;
+	}
+}
+
+static void grow_buffer(
+	mirac_emitter_s* const emitter,
+	const uint64_t length)
+{
+	mirac_debug_assert(emitter != mirac_null);
+	mirac_debug_assert(mirac_null == emitter->file);
+
+	uint64_t capacity = emitter->capacity > 0 ? emitter->capacity : mirac_emitter_min_memory_capacity;
+
+	while (capacity < length)
+	{
+		capacity *= 2;
+	}
+
+	emitter->data = (char_t*)mirac_arena_realloc_as(emitter->arena, emitter->data, emitter->capacity, capacity,
+		mirac_arena_site_output);
+	emitter->capacity = capacity;
+}
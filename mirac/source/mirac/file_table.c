@@ -0,0 +1,231 @@
+/**
+ * @file file_table.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-04-06
+ */
+
+#include <mirac/file_table.h>
+
+#include <mirac/debug.h>
+#include <mirac/logger.h>
+
+#include <pthread.h>
+#include <string.h>
+
+#define files_page_capacity 256
+#define files_pages_capacity 256
+
+typedef struct
+{
+	mirac_string_view_s path;
+	mirac_string_view_s source;
+	uint32_t* line_offsets; // note: mirac_null until the first location lookup.
+	uint64_t lines_count;
+	mirac_file_id_t next_free_file;
+} file_entry_s;
+
+// note: the entries are paged, so that they never move and can be read without
+//       the lock (a handle is only ever passed between threads along with the
+//       tokens that carry it, which are handed over under a lock themselves).
+static file_entry_s* g_pages[files_pages_capacity];
+static pthread_mutex_t g_mutex = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t g_files_count = 1; // note: handle 0 is mirac_file_id_none.
+static mirac_file_id_t g_free_file = mirac_file_id_none;
+
+/**
+ * @brief Get the entry of the registered file.
+ * 
+ * @param file handle of the file
+ * 
+ * @return file_entry_s*
+ */
+static file_entry_s* get_entry(
+	const mirac_file_id_t file);
+
+/**
+ * @brief Index the offsets of the lines of the entry's source.
+ * 
+ * @param entry entry to index
+ */
+static void index_lines(
+	file_entry_s* const entry);
+
+mirac_file_id_t mirac_file_table_register(
+	const mirac_string_view_s path,
+	const mirac_string_view_s source)
+{
+	if (source.length > mirac_file_table_max_source_size)
+	{
+		mirac_logger_error("source file '" mirac_sv_fmt "' exceeds the maximum size of %lu bytes.",
+			mirac_sv_arg(path), mirac_file_table_max_source_size);
+		mirac_c_exit(-1);
+	}
+
+	(void)pthread_mutex_lock(&g_mutex);
+	mirac_file_id_t file = g_free_file;
+
+	if (file != mirac_file_id_none)
+	{
+		g_free_file = get_entry(file)->next_free_file;
+	}
+	else if (g_files_count < (files_page_capacity * files_pages_capacity))
+	{
+		file = (mirac_file_id_t)g_files_count++;
+
+		if (mirac_null == g_pages[file / files_page_capacity])
+		{
+			g_pages[file / files_page_capacity] = (file_entry_s*)mirac_c_malloc(files_page_capacity * sizeof(file_entry_s));
+			mirac_c_memset(g_pages[file / files_page_capacity], 0, files_page_capacity * sizeof(file_entry_s));
+		}
+	}
+	else
+	{
+		(void)pthread_mutex_unlock(&g_mutex);
+		mirac_logger_error("internal failure -- exceeded the maximum of %d open source files.",
+			(files_page_capacity * files_pages_capacity) - 1);
+		mirac_c_exit(-1);
+	}
+
+	*get_entry(file) = (file_entry_s)
+	{
+		.path           = path,
+		.source         = source,
+		.line_offsets   = mirac_null,
+		.lines_count    = 0,
+		.next_free_file = mirac_file_id_none
+	};
+
+	(void)pthread_mutex_unlock(&g_mutex);
+	return file;
+}
+
+void mirac_file_table_unregister(
+	const mirac_file_id_t file)
+{
+	mirac_debug_assert(file != mirac_file_id_none);
+
+	(void)pthread_mutex_lock(&g_mutex);
+	file_entry_s* const entry = get_entry(file);
+
+	if (entry->line_offsets != mirac_null)
+	{
+		mirac_c_free(entry->line_offsets);
+	}
+
+	*entry = (file_entry_s) {0};
+	entry->next_free_file = g_free_file;
+	g_free_file = file;
+	(void)pthread_mutex_unlock(&g_mutex);
+}
+
+mirac_string_view_s mirac_file_table_get_path(
+	const mirac_file_id_t file)
+{
+	if (mirac_file_id_none == file)
+	{
+		return mirac_string_view_from_parts("", 0);
+	}
+
+	return get_entry(file)->path;
+}
+
+mirac_string_view_s mirac_file_table_get_source(
+	const mirac_file_id_t file)
+{
+	if (mirac_file_id_none == file)
+	{
+		return mirac_string_view_from_parts("", 0);
+	}
+
+	return get_entry(file)->source;
+}
+
+mirac_location_s mirac_file_table_get_location(
+	const mirac_position_s position)
+{
+	if (mirac_file_id_none == position.file)
+	{
+		return (mirac_location_s) { .file = mirac_string_view_from_parts("", 0), .line = 0, .column = 0 };
+	}
+
+	file_entry_s* const entry = get_entry(position.file);
+	const uint32_t* line_offsets = __atomic_load_n(&entry->line_offsets, __ATOMIC_ACQUIRE);
+
+	if (mirac_null == line_offsets)
+	{
+		(void)pthread_mutex_lock(&g_mutex);
+
+		if (mirac_null == entry->line_offsets)
+		{
+			index_lines(entry);
+		}
+
+		line_offsets = entry->line_offsets;
+		(void)pthread_mutex_unlock(&g_mutex);
+	}
+
+	// note: the number of lines, which begin at or before the offset.
+	uint64_t low = 1;
+	uint64_t high = entry->lines_count;
+
+	while (low < high)
+	{
+		const uint64_t middle = low + (high - low) / 2;
+
+		if (line_offsets[middle] <= position.offset)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	return (mirac_location_s)
+	{
+		.file   = entry->path,
+		.line   = low,
+		.column = (uint64_t)(position.offset - line_offsets[low - 1]) + 1
+	};
+}
+
+static file_entry_s* get_entry(
+	const mirac_file_id_t file)
+{
+	mirac_debug_assert(file != mirac_file_id_none);
+	mirac_debug_assert(g_pages[file / files_page_capacity] != mirac_null);
+	return &g_pages[file / files_page_capacity][file % files_page_capacity];
+}
+
+static void index_lines(
+	file_entry_s* const entry)
+{
+	mirac_debug_assert(entry != mirac_null);
+
+	const char_t* const data = entry->source.data;
+	const uint64_t length = entry->source.length;
+	uint64_t lines_count = 1;
+
+	for (const char_t* line_end = data; (line_end = (const char_t*)memchr(line_end, '\n', length - (uint64_t)(line_end - data))) != mirac_null; ++line_end)
+	{
+		++lines_count;
+	}
+
+	uint32_t* const line_offsets = (uint32_t*)mirac_c_malloc(lines_count * sizeof(uint32_t));
+	uint64_t line_index = 0;
+	line_offsets[line_index++] = 0;
+
+	for (const char_t* line_end = data; (line_end = (const char_t*)memchr(line_end, '\n', length - (uint64_t)(line_end - data))) != mirac_null; ++line_end)
+	{
+		line_offsets[line_index++] = (uint32_t)(line_end - data) + 1;
+	}
+
+	entry->lines_count = lines_count;
+	__atomic_store_n(&entry->line_offsets, line_offsets, __ATOMIC_RELEASE);
+}
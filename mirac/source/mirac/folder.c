@@ -0,0 +1,401 @@
+/**
+ * @file folder.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-04-23
+ */
+
+#include <mirac/folder.h>
+
+#include <mirac/debug.h>
+#include <mirac/logger.h>
+
+mirac_implement_heap_array_type(mirac_folder_value_list, uint64_t);
+
+static bool_t get_constant_value(
+	const mirac_ast_block_expr_s* const expr_block,
+	uint64_t* const value);
+
+static bool_t fold_expr(
+	mirac_folder_s* const folder,
+	const mirac_token_type_e token_type);
+
+static void replace_run(
+	mirac_folder_s* const folder,
+	const uint64_t run_begin,
+	uint64_t* const children_end);
+
+static void fold_block(
+	mirac_folder_s* const folder,
+	const mirac_ast_block_t block);
+
+static void fold_scope(
+	mirac_folder_s* const folder,
+	const mirac_ast_block_t block);
+
+mirac_folder_s mirac_folder_from_parts(
+	mirac_arena_s* const arena,
+	mirac_ast_unit_s* const unit)
+{
+	mirac_debug_assert(arena != mirac_null);
+	mirac_debug_assert(unit != mirac_null);
+
+	return (mirac_folder_s)
+	{
+		.arena       = arena,
+		.unit        = unit,
+		.values      = mirac_folder_value_list_from_parts(arena, 0),
+		.folds_count = 0
+	};
+}
+
+void mirac_folder_destroy(
+	mirac_folder_s* const folder)
+{
+	mirac_debug_assert(folder != mirac_null);
+	*folder = (mirac_folder_s) {0};
+}
+
+void mirac_folder_fold_ast_unit(
+	mirac_folder_s* const folder)
+{
+	mirac_debug_assert(folder != mirac_null);
+	mirac_debug_assert(folder->unit != mirac_null);
+
+	for (uint64_t def_index = 0; def_index < folder->unit->defs.count; ++def_index)
+	{
+		const mirac_ast_def_s* const def = folder->unit->defs.data[def_index];
+		mirac_debug_assert(def != mirac_null);
+
+		if (mirac_ast_def_type_fun == def->type)
+		{
+			fold_scope(folder, def->as.fun_def.body);
+		}
+	}
+}
+
+static bool_t get_constant_value(
+	const mirac_ast_block_expr_s* const expr_block,
+	uint64_t* const value)
+{
+	mirac_debug_assert(expr_block != mirac_null);
+	mirac_debug_assert(value != mirac_null);
+
+	switch (expr_block->token_type)
+	{
+		case mirac_token_type_literal_i08:
+		case mirac_token_type_literal_i16:
+		case mirac_token_type_literal_i32:
+		case mirac_token_type_literal_i64:
+		case mirac_token_type_literal_u08:
+		case mirac_token_type_literal_u16:
+		case mirac_token_type_literal_u32:
+		case mirac_token_type_literal_u64:
+		case mirac_token_type_literal_ptr:
+		{
+			*value = expr_block->as.uval;
+			return true;
+		} break;
+
+		case mirac_token_type_reserved_true:
+		{
+			*value = 1;
+			return true;
+		} break;
+
+		case mirac_token_type_reserved_false:
+		{
+			*value = 0;
+			return true;
+		} break;
+
+		default:
+		{
+			return false;
+		} break;
+	}
+}
+
+static bool_t fold_expr(
+	mirac_folder_s* const folder,
+	const mirac_token_type_e token_type)
+{
+	mirac_debug_assert(folder != mirac_null);
+
+	mirac_folder_value_list_s* const values = &folder->values;
+	uint64_t* const top = (values->count >= 1) ? &values->data[values->count - 1] : mirac_null;
+	uint64_t* const second = (values->count >= 2) ? &values->data[values->count - 2] : mirac_null;
+	uint64_t* const third = (values->count >= 3) ? &values->data[values->count - 3] : mirac_null;
+	uint64_t value = 0;
+
+	switch (token_type)
+	{
+		case mirac_token_type_reserved_lnot:
+		{
+			// note: only the low byte is set, just like in the generated code.
+			if (mirac_null == top) { return false; }
+			*top = (*top & ~(uint64_t)0xff) | ((0 == *top) ? 1 : 0);
+		} break;
+
+		case mirac_token_type_reserved_bnot:
+		{
+			if (mirac_null == top) { return false; }
+			*top = ~*top;
+		} break;
+
+		case mirac_token_type_reserved_inc:
+		{
+			if (mirac_null == top) { return false; }
+			*top += 1;
+		} break;
+
+		case mirac_token_type_reserved_dec:
+		{
+			if (mirac_null == top) { return false; }
+			*top -= 1;
+		} break;
+
+		case mirac_token_type_reserved_drop:
+		{
+			if (mirac_null == top) { return false; }
+			--values->count;
+		} break;
+
+		case mirac_token_type_reserved_dup:
+		{
+			if (mirac_null == top) { return false; }
+			mirac_folder_value_list_push(values, *top);
+		} break;
+
+		case mirac_token_type_reserved_land:
+		case mirac_token_type_reserved_band:
+		case mirac_token_type_reserved_lor:
+		case mirac_token_type_reserved_bor:
+		case mirac_token_type_reserved_lxor:
+		case mirac_token_type_reserved_bxor:
+		case mirac_token_type_reserved_shl:
+		case mirac_token_type_reserved_shr:
+		case mirac_token_type_reserved_add:
+		case mirac_token_type_reserved_sub:
+		case mirac_token_type_reserved_mul:
+		case mirac_token_type_reserved_div:
+		case mirac_token_type_reserved_mod:
+		case mirac_token_type_reserved_eq:
+		case mirac_token_type_reserved_neq:
+		case mirac_token_type_reserved_gt:
+		case mirac_token_type_reserved_gteq:
+		case mirac_token_type_reserved_ls:
+		case mirac_token_type_reserved_lseq:
+		{
+			if (mirac_null == second) { return false; }
+			const uint64_t lhs = *second;
+			const uint64_t rhs = *top;
+
+			switch (token_type)
+			{
+				case mirac_token_type_reserved_land:
+				case mirac_token_type_reserved_band: { value = lhs & rhs; } break;
+				case mirac_token_type_reserved_lor:
+				case mirac_token_type_reserved_bor:  { value = lhs | rhs; } break;
+				case mirac_token_type_reserved_lxor:
+				case mirac_token_type_reserved_bxor: { value = lhs ^ rhs; } break;
+				// note: the shift count is masked to 6 bits, like the cl register is.
+				case mirac_token_type_reserved_shl:  { value = lhs << (rhs & 63); } break;
+				case mirac_token_type_reserved_shr:  { value = lhs >> (rhs & 63); } break;
+				case mirac_token_type_reserved_add:  { value = lhs + rhs; } break;
+				case mirac_token_type_reserved_sub:  { value = lhs - rhs; } break;
+				case mirac_token_type_reserved_mul:  { value = lhs * rhs; } break;
+				case mirac_token_type_reserved_div:  { if (0 == rhs) { return false; } value = lhs / rhs; } break;
+				case mirac_token_type_reserved_mod:  { if (0 == rhs) { return false; } value = lhs % rhs; } break;
+				case mirac_token_type_reserved_eq:   { value = (lhs == rhs) ? 1 : 0; } break;
+				case mirac_token_type_reserved_neq:  { value = (lhs != rhs) ? 1 : 0; } break;
+				case mirac_token_type_reserved_gt:   { value = ((int64_t)lhs >  (int64_t)rhs) ? 1 : 0; } break;
+				case mirac_token_type_reserved_gteq: { value = ((int64_t)lhs >= (int64_t)rhs) ? 1 : 0; } break;
+				case mirac_token_type_reserved_ls:   { value = ((int64_t)lhs <  (int64_t)rhs) ? 1 : 0; } break;
+				case mirac_token_type_reserved_lseq: { value = ((int64_t)lhs <= (int64_t)rhs) ? 1 : 0; } break;
+				default: { mirac_debug_assert(0); } break; // note: should never reach this block.
+			}
+
+			--values->count;
+			*second = value;
+		} break;
+
+		case mirac_token_type_reserved_divmod:
+		{
+			if ((mirac_null == second) || (0 == *top)) { return false; }
+			value = *second;
+			*second = value / *top;
+			*top = value % *top;
+		} break;
+
+		case mirac_token_type_reserved_over:
+		{
+			if (mirac_null == second) { return false; }
+			mirac_folder_value_list_push(values, *second);
+		} break;
+
+		case mirac_token_type_reserved_swap:
+		{
+			if (mirac_null == second) { return false; }
+			value = *top;
+			*top = *second;
+			*second = value;
+		} break;
+
+		case mirac_token_type_reserved_rot:
+		{
+			// note: the third value is moved to the top.
+			if (mirac_null == third) { return false; }
+			value = *third;
+			*third = *second;
+			*second = *top;
+			*top = value;
+		} break;
+
+		default:
+		{
+			return false;
+		} break;
+	}
+
+	return true;
+}
+
+static void replace_run(
+	mirac_folder_s* const folder,
+	const uint64_t run_begin,
+	uint64_t* const children_end)
+{
+	mirac_debug_assert(folder != mirac_null);
+	mirac_debug_assert(children_end != mirac_null);
+	mirac_debug_assert(run_begin <= *children_end);
+
+	mirac_ast_unit_s* const unit = folder->unit;
+	const uint64_t run_length = *children_end - run_begin;
+	const uint64_t values_count = folder->values.count;
+	mirac_debug_assert(values_count <= run_length);
+
+	if (values_count < run_length)
+	{
+		// note: the literals reuse the first blocks of the run, and keep their
+		//       positions for the diagnostics.
+		for (uint64_t value_index = 0; value_index < values_count; ++value_index)
+		{
+			const mirac_ast_block_t block = unit->children.data[run_begin + value_index];
+			mirac_ast_block_expr_s* const expr_block = &unit->block_payloads.data[block].as.expr_block;
+			expr_block->token_type = mirac_token_type_literal_u64;
+			expr_block->as.uval = folder->values.data[value_index];
+		}
+
+		*children_end = run_begin + values_count;
+		++folder->folds_count;
+	}
+
+	folder->values.count = 0;
+}
+
+static void fold_block(
+	mirac_folder_s* const folder,
+	const mirac_ast_block_t block)
+{
+	mirac_debug_assert(folder != mirac_null);
+
+	const mirac_ast_block_payload_s* const payload = mirac_ast_unit_get_block_payload(folder->unit, block);
+	mirac_debug_assert(payload != mirac_null);
+
+	switch (mirac_ast_unit_get_block_type(folder->unit, block))
+	{
+		case mirac_ast_block_type_scope:
+		{
+			fold_scope(folder, block);
+		} break;
+
+		case mirac_ast_block_type_if:
+		{
+			const mirac_ast_block_if_s if_block = payload->as.if_block;
+			fold_scope(folder, if_block.cond);
+			fold_scope(folder, if_block.body);
+		} break;
+
+		case mirac_ast_block_type_else:
+		{
+			fold_scope(folder, payload->as.else_block.body);
+		} break;
+
+		case mirac_ast_block_type_loop:
+		{
+			const mirac_ast_block_loop_s loop_block = payload->as.loop_block;
+			fold_scope(folder, loop_block.cond);
+			fold_scope(folder, loop_block.body);
+		} break;
+
+		default:
+		{
+		} break;
+	}
+}
+
+static void fold_scope(
+	mirac_folder_s* const folder,
+	const mirac_ast_block_t block)
+{
+	mirac_debug_assert(folder != mirac_null);
+	mirac_debug_assert(folder->unit != mirac_null);
+	mirac_debug_assert(mirac_ast_block_type_scope == mirac_ast_unit_get_block_type(folder->unit, block));
+	mirac_debug_assert(0 == folder->values.count);
+
+	mirac_ast_unit_s* const unit = folder->unit;
+	const mirac_ast_range_s blocks = unit->block_payloads.data[block].as.scope_block.blocks;
+
+	// note: the children are compacted in place, so the ones that are kept are
+	//       written at 'children_end', which never gets ahead of the one read.
+	uint64_t children_end = blocks.begin;
+	uint64_t run_begin = blocks.begin;
+	bool_t is_in_run = false;
+
+	for (uint64_t child_index = blocks.begin; child_index < ((uint64_t)blocks.begin + blocks.count); ++child_index)
+	{
+		const mirac_ast_block_t child = unit->children.data[child_index];
+
+		if (mirac_ast_block_type_expr == mirac_ast_unit_get_block_type(unit, child))
+		{
+			const mirac_ast_block_expr_s* const expr_block = &mirac_ast_unit_get_block_payload(unit, child)->as.expr_block;
+			uint64_t value = 0;
+
+			if (get_constant_value(expr_block, &value))
+			{
+				if (!is_in_run) { run_begin = children_end; }
+				is_in_run = true;
+				mirac_folder_value_list_push(&folder->values, value);
+				unit->children.data[children_end++] = child;
+				continue;
+			}
+
+			if (is_in_run && fold_expr(folder, (mirac_token_type_e)expr_block->token_type))
+			{
+				unit->children.data[children_end++] = child;
+				continue;
+			}
+		}
+
+		if (is_in_run)
+		{
+			replace_run(folder, run_begin, &children_end);
+			is_in_run = false;
+		}
+
+		unit->children.data[children_end++] = child;
+		fold_block(folder, child);
+	}
+
+	if (is_in_run)
+	{
+		replace_run(folder, run_begin, &children_end);
+	}
+
+	unit->block_payloads.data[block].as.scope_block.blocks.count = (uint32_t)(children_end - blocks.begin);
+}
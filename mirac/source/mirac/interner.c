@@ -0,0 +1,147 @@
+/**
+ * @file interner.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-01-22
+ */
+
+#include <mirac/interner.h>
+
+#include <mirac/debug.h>
+#include <mirac/logger.h>
+
+mirac_implement_heap_array_type(mirac_interner_entry_list, mirac_interner_entry_s);
+
+/**
+ * @brief Double the capacity of the interner's slot table and reinsert all the
+ * interned handles into it.
+ * 
+ * @param interner interner instance
+ */
+static void grow_slots(
+	mirac_interner_s* const interner);
+
+mirac_interner_s mirac_interner_from_parts(
+	mirac_arena_s* const arena)
+{
+	mirac_debug_assert(arena != mirac_null);
+
+	return (mirac_interner_s)
+	{
+		.arena          = arena,
+		.entries        = mirac_interner_entry_list_from_parts(arena, 0),
+		.slots          = mirac_null,
+		.slots_capacity = 0
+	};
+}
+
+mirac_symbol_t mirac_interner_intern(
+	mirac_interner_s* const interner,
+	const mirac_string_view_s string)
+{
+	mirac_debug_assert(interner != mirac_null);
+	mirac_debug_assert(string.data != mirac_null);
+
+	if (((interner->entries.count + 1) * 2) > interner->slots_capacity)
+	{
+		grow_slots(interner);
+	}
+
+	const uint64_t hash = mirac_string_view_hash(string);
+	const uint64_t mask = interner->slots_capacity - 1;
+	uint64_t slot_index = hash & mask;
+
+	while (interner->slots[slot_index] != mirac_symbol_none)
+	{
+		const mirac_interner_entry_s* const entry =
+			&interner->entries.data[interner->slots[slot_index] - 1];
+
+		if ((entry->hash == hash) && mirac_string_view_equal(entry->string, string))
+		{
+			return interner->slots[slot_index];
+		}
+
+		slot_index = (slot_index + 1) & mask;
+	}
+
+	if (interner->entries.count >= UINT32_MAX)
+	{
+		mirac_logger_error("internal failure -- too many interned strings.");
+		mirac_c_exit(-1);
+	}
+
+	char_t* string_copy = mirac_null;
+
+	if (string.length > 0)
+	{
+		string_copy = (char_t*)mirac_arena_malloc_aligned_as(interner->arena, string.length, 1, mirac_arena_site_lexer_text);
+		mirac_c_memcpy(string_copy, string.data, string.length);
+	}
+
+	const mirac_arena_site_e site = mirac_arena_set_site(interner->arena, mirac_arena_site_tables);
+	mirac_interner_entry_list_push(&interner->entries, (mirac_interner_entry_s)
+	{
+		.string = mirac_string_view_from_parts(string_copy != mirac_null ? string_copy : "", string.length),
+		.hash   = hash
+	});
+	(void)mirac_arena_set_site(interner->arena, site);
+
+	const mirac_symbol_t symbol = (mirac_symbol_t)interner->entries.count;
+	interner->slots[slot_index] = symbol;
+	return symbol;
+}
+
+mirac_string_view_s mirac_interner_get_string(
+	const mirac_interner_s* const interner,
+	const mirac_symbol_t symbol)
+{
+	mirac_debug_assert(interner != mirac_null);
+	mirac_debug_assert(symbol != mirac_symbol_none);
+	mirac_debug_assert(symbol <= interner->entries.count);
+	return interner->entries.data[symbol - 1].string;
+}
+
+uint64_t mirac_interner_get_hash(
+	const mirac_interner_s* const interner,
+	const mirac_symbol_t symbol)
+{
+	mirac_debug_assert(interner != mirac_null);
+	mirac_debug_assert(symbol != mirac_symbol_none);
+	mirac_debug_assert(symbol <= interner->entries.count);
+	return interner->entries.data[symbol - 1].hash;
+}
+
+static void grow_slots(
+	mirac_interner_s* const interner)
+{
+	mirac_debug_assert(interner != mirac_null);
+
+	const uint64_t slots_capacity = interner->slots_capacity > 0 ?
+		interner->slots_capacity * 2 : mirac_interner_min_slots_capacity;
+
+	mirac_symbol_t* const slots = (mirac_symbol_t*)mirac_arena_malloc_as(
+		interner->arena, slots_capacity * sizeof(mirac_symbol_t), mirac_arena_site_tables);
+	mirac_c_memset(slots, 0, slots_capacity * sizeof(mirac_symbol_t));
+
+	const uint64_t mask = slots_capacity - 1;
+
+	for (uint64_t entry_index = 0; entry_index < interner->entries.count; ++entry_index)
+	{
+		uint64_t slot_index = interner->entries.data[entry_index].hash & mask;
+
+		while (slots[slot_index] != mirac_symbol_none)
+		{
+			slot_index = (slot_index + 1) & mask;
+		}
+
+		slots[slot_index] = (mirac_symbol_t)(entry_index + 1);
+	}
+
+	// note: the old table is abandoned until the arena is destroyed.
+	interner->slots = slots;
+	interner->slots_capacity = slots_capacity;
+}
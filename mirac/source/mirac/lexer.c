@@ -15,9 +15,11 @@
 #include <mirac/debug.h>
 #include <mirac/logger.h>
 
-#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <ctype.h>
-#include <errno.h>
+
+mirac_implement_heap_array_type(mirac_token_list, mirac_token_s);
 
 static const mirac_string_view_s g_reserved_token_types_map[mirac_token_type_reserved_count + 1] =
 {
@@ -108,11 +110,9 @@ static const mirac_string_view_s g_reserved_token_types_map[mirac_token_type_res
 #define log_lexer_error_and_exit(_location, _format, ...)                      \
 	do                                                                         \
 	{                                                                          \
-		(void)fprintf(stderr, mirac_sv_fmt ":%lu:%lu: ",                       \
-			mirac_sv_arg((_location).file),                                    \
-			(_location).line,                                                  \
-			(_location).column);                                               \
-		mirac_logger_error(_format, ## __VA_ARGS__);                           \
+		mirac_logger_error(mirac_sv_fmt ":%lu:%lu: " _format,                  \
+			mirac_sv_arg((_location).file), (_location).line,                  \
+			(_location).column, ## __VA_ARGS__);                               \
 		mirac_c_exit(-1);                                                      \
 	} while (0)
 
@@ -126,6 +126,56 @@ static const mirac_string_view_s g_reserved_token_types_map[mirac_token_type_res
 static bool_t is_char_any_quote(
 	const char_t ch);
 
+/**
+ * @brief Memory map the entire file read-only.
+ * 
+ * @note Returns an empty string view if the file can not be mapped (it is not a
+ * regular file, it is empty, or the mapping failed).
+ * 
+ * @param file file to map
+ * 
+ * @return mirac_string_view_s
+ */
+static mirac_string_view_s map_source_file(
+	mirac_file_t* const file);
+
+/**
+ * @brief Read the entire file into a heap allocated buffer.
+ * 
+ * @note Used as a fallback for files, which can not be mapped.
+ * 
+ * @param file file to read
+ * 
+ * @return mirac_string_view_s
+ */
+static mirac_string_view_s read_source_file(
+	mirac_file_t* const file);
+
+/**
+ * @brief Get the position of the pointer into the lexer's source.
+ * 
+ * @param lexer   lexer instance
+ * @param pointer pointer into the lexer's source (or right past its end)
+ * 
+ * @return mirac_position_s
+ */
+static mirac_position_s get_position_of(
+	const mirac_lexer_s* const lexer,
+	const char_t* const pointer);
+
+/**
+ * @brief Split the next line off of the lexer's buffer.
+ * 
+ * @note The end of the buffer terminates the last line, so the source does not
+ * need a trailing new line.
+ * 
+ * @param lexer lexer instance
+ * 
+ * @return mirac_string_view_s
+ */
+static mirac_string_view_s split_next_line(
+	mirac_lexer_s* const lexer);
+
 /**
  * @brief Get the next token as text from the lexer's buffer.
  * 
@@ -136,52 +186,149 @@ static bool_t is_char_any_quote(
 static mirac_string_view_s get_next_token_as_text(
 	mirac_lexer_s* const lexer);
 
+/**
+ * @brief Skip the white space and comment left on the current line of the
+ * directive, and check if nothing else is left on it.
+ * 
+ * @param lexer lexer instance
+ * 
+ * @return bool_t
+ */
+static bool_t is_directive_line_exhausted(
+	mirac_lexer_s* const lexer);
+
+/**
+ * @brief Parse the directive token from the token's text ('#' followed by the
+ * directive's name).
+ * 
+ * @param lexer lexer instance
+ * @param text  text of the token
+ * @param token token to parse
+ * 
+ * @return mirac_token_type_e
+ */
+static mirac_token_type_e parse_directive_token_from_text(
+	mirac_lexer_s* const lexer,
+	const mirac_string_view_s text,
+	mirac_token_s* const token);
+
 /**
  * @brief Parse string literal token from the token's text.
  * 
  * @param lexer lexer instance
+ * @param text  text of the token
  * @param token token to parse
  * 
  * @return mirac_token_type_e
  */
 static mirac_token_type_e parse_string_literal_token_from_text(
 	mirac_lexer_s* const lexer,
+	const mirac_string_view_s text,
 	mirac_token_s* const token);
 
+/**
+ * @brief Parse the entire text as an unsigned integer in the provided base.
+ * 
+ * It follows the rules of c's strtoul: an optional sign (negative values wrap
+ * around), an optional '0x' prefix in base 16, and digits of the base. Unlike
+ * strtoul it does not need the text to be zero terminated.
+ * 
+ * @param text           text to parse
+ * @param base           base of the digits (2 to 16)
+ * @param value          parsed value
+ * @param has_overflowed set if the value does not fit into 64 bits
+ * 
+ * @return bool_t
+ */
+static bool_t parse_unsigned_integer(
+	const mirac_string_view_s text,
+	const uint64_t base,
+	uint64_t* const value,
+	bool_t* const has_overflowed);
+
 /**
  * @brief Parse numeric literal token from the token's text.
  * 
  * @param lexer lexer instance
+ * @param text  text of the token
  * @param token token to parse
  * 
  * @return mirac_token_type_e
  */
 static mirac_token_type_e parse_numeric_literal_token_from_text(
 	mirac_lexer_s* const lexer,
+	const mirac_string_view_s text,
 	mirac_token_s* const token);
 
+/**
+ * @brief Check if the text is equal to the text of the provided reserved token
+ * type.
+ * 
+ * @param text text to check
+ * @param type reserved token type to compare against
+ * 
+ * @return bool_t
+ */
+static bool_t is_reserved_token_text(
+	const mirac_string_view_s text,
+	const mirac_token_type_e type);
+
+/**
+ * @brief Return the provided reserved token type if the text matches it, and
+ * none token type otherwise.
+ * 
+ * @param text text to check
+ * @param type reserved token type to compare against
+ * 
+ * @return mirac_token_type_e
+ */
+static mirac_token_type_e match_reserved_token_type(
+	const mirac_string_view_s text,
+	const mirac_token_type_e type);
+
+/**
+ * @brief Find the reserved token type with the provided text.
+ * 
+ * The candidates are narrowed down by the text's length and first char, so that
+ * at most a handful of comparisons are made regardless of the number of reserved
+ * tokens.
+ * 
+ * @note When adding a reserved token, it has to be added to the switch in this
+ * function along with the g_reserved_token_types_map.
+ * 
+ * @param text text to look up
+ * 
+ * @return mirac_token_type_e
+ */
+static mirac_token_type_e lookup_reserved_token_type(
+	const mirac_string_view_s text);
+
 /**
  * @brief Parse reserved token from the token's text.
  * 
  * @param lexer lexer instance
+ * @param text  text of the token
  * @param token token to parse
  * 
  * @return mirac_token_type_e
  */
 static mirac_token_type_e parse_reserved_token_from_text(
 	mirac_lexer_s* const lexer,
+	const mirac_string_view_s text,
 	mirac_token_s* const token);
 
 /**
  * @brief Parse identifier token from the token's text.
  * 
  * @param lexer lexer instance
+ * @param text  text of the token
  * @param token token to parse
  * 
  * @return mirac_token_type_e
  */
 static mirac_token_type_e parse_identifier_token_from_text(
 	mirac_lexer_s* const lexer,
+	const mirac_string_view_s text,
 	mirac_token_s* const token);
 
 mirac_string_view_s mirac_token_type_to_string_view(
@@ -200,6 +347,16 @@ mirac_string_view_s mirac_token_type_to_string_view(
 		case mirac_token_type_literal_ptr: { return mirac_string_view_from_parts("literal_ptr", 11); } break;
 		case mirac_token_type_literal_str: { return mirac_string_view_from_parts("literal_str", 11); } break;
 		case mirac_token_type_identifier:  { return mirac_string_view_from_parts("identifier", 10);  } break;
+
+		case mirac_token_type_directive_include: { return mirac_string_view_from_parts("#include", 8);      } break;
+		case mirac_token_type_directive_define:  { return mirac_string_view_from_parts("#define", 7);       } break;
+		case mirac_token_type_directive_undef:   { return mirac_string_view_from_parts("#undef", 6);        } break;
+		case mirac_token_type_directive_ifdef:   { return mirac_string_view_from_parts("#ifdef", 6);        } break;
+		case mirac_token_type_directive_ifndef:  { return mirac_string_view_from_parts("#ifndef", 7);       } break;
+		case mirac_token_type_directive_else:    { return mirac_string_view_from_parts("#else", 5);         } break;
+		case mirac_token_type_directive_endif:   { return mirac_string_view_from_parts("#endif", 6);        } break;
+		case mirac_token_type_directive_end:     { return mirac_string_view_from_parts("directive_end", 13); } break;
+
 		case mirac_token_type_eof:         { return mirac_string_view_from_parts("eof", 3);          } break;
 		case mirac_token_type_none:        { return mirac_string_view_from_parts("none", 4);         } break;
 
@@ -213,16 +370,17 @@ mirac_string_view_s mirac_token_type_to_string_view(
 
 mirac_token_s mirac_token_from_parts(
 	const mirac_token_type_e type,
-	const mirac_location_s location,
-	const uint64_t index,
-	const mirac_string_view_s text)
+	const mirac_position_s position,
+	const uint64_t length)
 {
+	mirac_debug_assert(length <= mirac_file_table_max_source_size);
+
 	return (mirac_token_s)
 	{
-		.type     = type,
-		.location = location,
-		.index    = index,
-		.text     = text
+		.type   = (uint8_t)type,
+		.file   = position.file,
+		.offset = position.offset,
+		.length = (uint32_t)length
 	};
 }
 
@@ -231,7 +389,7 @@ mirac_token_s mirac_token_from_type(
 {
 	return (mirac_token_s)
 	{
-		.type = type
+		.type = (uint8_t)type
 	};
 }
 
@@ -248,15 +406,17 @@ mirac_string_view_s mirac_token_to_string_view(
 {
 	mirac_debug_assert(token != mirac_null);
 	#define token_string_buffer_capacity 1024
-	static char_t token_string_buffer[token_string_buffer_capacity + 1];
+	// note: each thread gets its own buffer, so the returned view stays valid
+	//       until the next call on the same thread.
+	static _Thread_local char_t token_string_buffer[token_string_buffer_capacity + 1];
 
 	uint64_t written = (uint64_t)snprintf(
 		token_string_buffer, token_string_buffer_capacity,
-		"Token[type='" mirac_sv_fmt "', location='" mirac_location_fmt "', index='%lu', text='" mirac_sv_fmt "'",
+		"Token[type='" mirac_sv_fmt "', location='" mirac_location_fmt "', offset='%u', text='" mirac_sv_fmt "'",
 		mirac_sv_arg(mirac_token_type_to_string_view(token->type)),
-		mirac_location_arg(token->location),
-		token->index,
-		mirac_sv_arg(token->text)
+		mirac_location_arg(mirac_token_get_location(token)),
+		token->offset,
+		mirac_sv_arg(mirac_token_get_text(token))
 	);
 
 	switch (token->type)
@@ -287,7 +447,7 @@ mirac_string_view_s mirac_token_to_string_view(
 		{
 			written += (uint64_t)snprintf(
 				token_string_buffer + written, token_string_buffer_capacity - written,
-				", value='" mirac_sv_fmt "']", mirac_sv_arg(token->as.str)
+				", value='" mirac_sv_fmt "']", mirac_sv_arg(mirac_token_get_string(token))
 			);
 		} break;
 
@@ -295,7 +455,7 @@ mirac_string_view_s mirac_token_to_string_view(
 		{
 			written += (uint64_t)snprintf(
 				token_string_buffer + written, token_string_buffer_capacity - written,
-				", value='" mirac_sv_fmt "']", mirac_sv_arg(token->as.ident)
+				", value='" mirac_sv_fmt "']", mirac_sv_arg(mirac_token_get_ident(token))
 			);
 		} break;
 
@@ -311,6 +471,61 @@ mirac_string_view_s mirac_token_to_string_view(
 	return mirac_string_view_from_parts(token_string_buffer, written);
 }
 
+mirac_position_s mirac_token_get_position(
+	const mirac_token_s* const token)
+{
+	mirac_debug_assert(token != mirac_null);
+	return (mirac_position_s) { .file = token->file, .offset = token->offset };
+}
+
+mirac_location_s mirac_token_get_location(
+	const mirac_token_s* const token)
+{
+	mirac_debug_assert(token != mirac_null);
+	return mirac_file_table_get_location(mirac_token_get_position(token));
+}
+
+mirac_string_view_s mirac_token_get_text(
+	const mirac_token_s* const token)
+{
+	mirac_debug_assert(token != mirac_null);
+
+	if (token->type <= mirac_token_type_reserved_count)
+	{
+		return g_reserved_token_types_map[token->type];
+	}
+
+	if (mirac_token_type_identifier == token->type)
+	{
+		return mirac_token_get_ident(token);
+	}
+
+	const mirac_string_view_s source = mirac_file_table_get_source(token->file);
+
+	if (((uint64_t)token->offset + token->length) > source.length)
+	{
+		return mirac_string_view_from_parts("", 0);
+	}
+
+	return mirac_string_view_from_parts(source.data + token->offset, token->length);
+}
+
+mirac_string_view_s mirac_token_get_ident(
+	const mirac_token_s* const token)
+{
+	mirac_debug_assert(token != mirac_null);
+	mirac_debug_assert(mirac_token_type_identifier == token->type);
+	return mirac_string_view_from_parts(token->as.ident, token->length);
+}
+
+mirac_string_view_s mirac_token_get_string(
+	const mirac_token_s* const token)
+{
+	mirac_debug_assert(token != mirac_null);
+	mirac_debug_assert(mirac_token_type_literal_str == token->type);
+	return mirac_string_view_from_parts(token->as.str, token->str_length);
+}
+
 bool_t mirac_token_is_unsigned_numeric_literal(
 	const mirac_token_s* const token)
 {
@@ -343,48 +558,61 @@ bool_t mirac_token_is_type_token(
 mirac_lexer_s mirac_lexer_from_parts(
 	mirac_config_s* const config,
 	mirac_arena_s* const arena,
+	mirac_interner_s* const interner,
 	const mirac_string_view_s file_path,
 	mirac_file_t* const file)
 {
 	mirac_debug_assert(config != mirac_null);
 	mirac_debug_assert(arena != mirac_null);
+	mirac_debug_assert(interner != mirac_null);
 	mirac_debug_assert(file != mirac_null);
 
-	(void)fseek(file, 0, SEEK_END);
-	const uint64_t length = (uint64_t)ftell(file) + 1;
-	(void)fseek(file, 0, SEEK_SET);
-
-	char_t* const buffer = (char_t* const)mirac_c_malloc((length + 1) * sizeof(char_t));
-	mirac_debug_assert(buffer != mirac_null);
-
-	const size_t read = fread(buffer, 1, length, file);
-	mirac_debug_assert((length - 1) == read);
-
-	buffer[length - 1] = '\n';
-	buffer[length] = '\0';
+	bool_t is_source_mapped = true;
+	mirac_string_view_s source = map_source_file(file);
 
-	const mirac_location_s location = (const mirac_location_s)
+	if (source.length <= 0)
 	{
-		.file   = file_path,
-		.line   = 1,
-		.column = 1
-	};
+		is_source_mapped = false;
+		source = read_source_file(file);
+	}
 
 	return (mirac_lexer_s)
 	{
 		.config = config,
 		.arena = arena,
-		.locations[0] = location,
-		.locations[1] = location,
+		.interner = interner,
+		.file_path = file_path,
+		.file = mirac_file_table_register(file_path, source),
 		.token = mirac_token_from_type(mirac_token_type_none),
-		.buffer = mirac_string_view_from_parts(buffer, length),
-		.line = (mirac_string_view_s) {0}
+		.source = source,
+		.is_source_mapped = is_source_mapped,
+		.buffer = source,
+		.line = (mirac_string_view_s) {0},
+		.is_at_line_start = false,
+		.is_in_directive = false,
+		.is_directive_name = false
 	};
 }
 
 void mirac_lexer_destroy(
 	mirac_lexer_s* const lexer)
 {
+	mirac_debug_assert(lexer != mirac_null);
+
+	if (lexer->file != mirac_file_id_none)
+	{
+		mirac_file_table_unregister(lexer->file);
+	}
+
+	if (lexer->is_source_mapped)
+	{
+		(void)munmap((void*)lexer->source.data, lexer->source.length);
+	}
+	else
+	{
+		mirac_c_free((void*)lexer->source.data);
+	}
+
 	*lexer = (mirac_lexer_s) {0};
 }
 
@@ -402,44 +630,58 @@ mirac_token_type_e mirac_lexer_lex_next(
 		return token->type;
 	}
 
+	if (lexer->is_in_directive && is_directive_line_exhausted(lexer))
+	{
+		lexer->is_in_directive = false;
+		*token = mirac_token_from_parts(mirac_token_type_directive_end,
+			get_position_of(lexer, lexer->line.data), 0
+		);
+		return token->type;
+	}
+
 	const mirac_string_view_s text = get_next_token_as_text(lexer);
 
 	if (text.length <= 0)
 	{
-		token->type = mirac_token_type_eof;
-		token->location = lexer->locations[0];
+		*token = mirac_token_from_parts(mirac_token_type_eof,
+			get_position_of(lexer, lexer->source.data + lexer->source.length), 0
+		);
 		return token->type;
 	}
 
-	char_t* const text_copy = (char_t* const)mirac_arena_malloc(lexer->arena, text.length);
-	mirac_debug_assert(text_copy != mirac_null);
-	mirac_c_memcpy(text_copy, text.data, text.length);
-
+	// note: the token's text is a view into the lexer's source, so it stays valid
+	//       only until the lexer is destroyed.
 	*token = mirac_token_from_parts(mirac_token_type_none,
-		lexer->locations[0], lexer->tokens_count++, mirac_string_view_from_parts(text_copy, text.length)
+		get_position_of(lexer, text.data), text.length
 	);
 
-	if (parse_reserved_token_from_text(lexer, token) != mirac_token_type_none)
+	if (lexer->is_directive_name)
+	{
+		lexer->is_directive_name = false;
+		return parse_directive_token_from_text(lexer, text, token);
+	}
+
+	if (parse_reserved_token_from_text(lexer, text, token) != mirac_token_type_none)
 	{
 		return token->type;
 	}
 
-	if (parse_string_literal_token_from_text(lexer, token) != mirac_token_type_none)
+	if (parse_string_literal_token_from_text(lexer, text, token) != mirac_token_type_none)
 	{
 		return token->type;
 	}
 
-	if (parse_numeric_literal_token_from_text(lexer, token) != mirac_token_type_none)
+	if (parse_numeric_literal_token_from_text(lexer, text, token) != mirac_token_type_none)
 	{
 		return token->type;
 	}
 
-	if (parse_identifier_token_from_text(lexer, token) != mirac_token_type_none)
+	if (parse_identifier_token_from_text(lexer, text, token) != mirac_token_type_none)
 	{
 		return token->type;
 	}
 
-	log_lexer_error_and_exit(lexer->locations[0], "encountered unknown token '" mirac_sv_fmt "'.", mirac_sv_arg(text));
+	log_lexer_error_and_exit(mirac_token_get_location(token), "encountered unknown token '" mirac_sv_fmt "'.", mirac_sv_arg(text));
 	return mirac_token_type_none; // note: to prevent compiler error '-Werror=return-type'.
 }
 
@@ -471,18 +713,109 @@ static bool_t is_char_any_quote(
 	);
 }
 
+static mirac_string_view_s map_source_file(
+	mirac_file_t* const file)
+{
+	mirac_debug_assert(file != mirac_null);
+
+	typedef struct stat file_stats_s;
+	file_stats_s file_stats = {0};
+	const int32_t descriptor = fileno(file);
+
+	if ((descriptor < 0) || (fstat(descriptor, &file_stats) != 0) ||
+		!S_ISREG(file_stats.st_mode) || (file_stats.st_size <= 0))
+	{
+		return mirac_string_view_from_parts("", 0);
+	}
+
+	const uint64_t length = (uint64_t)file_stats.st_size;
+	void* const mapping = mmap(mirac_null, length, PROT_READ, MAP_PRIVATE | MAP_POPULATE, descriptor, 0);
+
+	if (MAP_FAILED == mapping)
+	{
+		return mirac_string_view_from_parts("", 0);
+	}
+
+	(void)madvise(mapping, length, MADV_SEQUENTIAL);
+	return mirac_string_view_from_parts((const char_t*)mapping, length);
+}
+
+static mirac_string_view_s read_source_file(
+	mirac_file_t* const file)
+{
+	mirac_debug_assert(file != mirac_null);
+
+	uint64_t capacity = 4096;
+	uint64_t length = 0;
+	char_t* buffer = (char_t*)mirac_c_malloc(capacity * sizeof(char_t));
+	mirac_debug_assert(buffer != mirac_null);
+
+	while (true)
+	{
+		if (length >= capacity)
+		{
+			capacity *= 2;
+			buffer = (char_t*)mirac_c_realloc(buffer, capacity * sizeof(char_t));
+			mirac_debug_assert(buffer != mirac_null);
+		}
+
+		const size_t read = fread(buffer + length, 1, capacity - length, file);
+		length += read;
+
+		if (read <= 0)
+		{
+			break;
+		}
+	}
+
+	if (ferror(file))
+	{
+		mirac_logger_error("internal failure -- failed to read the source file.");
+		mirac_c_exit(-1);
+	}
+
+	return mirac_string_view_from_parts(buffer, length);
+}
+
+static mirac_position_s get_position_of(
+	const mirac_lexer_s* const lexer,
+	const char_t* const pointer)
+{
+	mirac_debug_assert(lexer != mirac_null);
+	mirac_debug_assert(pointer != mirac_null);
+
+	// note: views into static strings (empty views returned by the string view
+	//       functions) are positioned at the end of the source.
+	const bool_t is_in_source = (pointer >= lexer->source.data) &&
+		(pointer <= (lexer->source.data + lexer->source.length));
+	const uint64_t offset = is_in_source ? (uint64_t)(pointer - lexer->source.data) : lexer->source.length;
+	return (mirac_position_s) { .file = lexer->file, .offset = (uint32_t)offset };
+}
+
+static mirac_string_view_s split_next_line(
+	mirac_lexer_s* const lexer)
+{
+	mirac_debug_assert(lexer != mirac_null);
+	mirac_debug_assert(lexer->buffer.length > 0);
+
+	const uint64_t length = mirac_string_view_find_char(lexer->buffer, '\n');
+	const uint64_t skip = length < lexer->buffer.length ? length + 1 : length;
+
+	const mirac_string_view_s line = mirac_string_view_from_parts(lexer->buffer.data, length);
+	lexer->buffer = mirac_string_view_from_parts(lexer->buffer.data + skip, lexer->buffer.length - skip);
+	return line;
+}
+
 static mirac_string_view_s get_next_token_as_text(
 	mirac_lexer_s* const lexer)
 {
 	mirac_debug_assert(lexer != mirac_null);
-	lexer->locations[0] = lexer->locations[1];
 
 fetch_line:
 	while ((lexer->line.length <= 0) && (lexer->buffer.length > 0))
 	{
-		lexer->line = mirac_string_view_split_left(&lexer->buffer, '\n');
-		lexer->locations[0].line++;
-		lexer->locations[0].column = 1;
+		lexer->line = split_next_line(lexer);
+		lexer->is_at_line_start = true;
 	}
 
 	if ((lexer->line.length <= 0) && (lexer->buffer.length <= 0))
@@ -492,7 +825,6 @@ fetch_line:
 
 	uint64_t white_space_length = 0;
 	lexer->line = mirac_string_view_trim_left_white_space(lexer->line, &white_space_length);
-	lexer->locations[0].column += white_space_length;
 
 	if ((lexer->line.length <= 0) && (lexer->buffer.length > 0))
 	{
@@ -509,7 +841,22 @@ fetch_line:
 
 	mirac_string_view_s text = {0};
 
-	if ('\"' == lexer->line.data[0])
+	if (lexer->is_at_line_start && ('#' == lexer->line.data[0]))
+	{
+		// note: the directive's name may be separated from the '#' by white space
+		//       (for example '#	define'), both end up in the text.
+		mirac_string_view_s right = mirac_string_view_from_parts(lexer->line.data + 1, lexer->line.length - 1);
+		uint64_t name_offset = 0;
+		right = mirac_string_view_trim_left_white_space(right, &name_offset);
+
+		white_space_length = 0;
+		const mirac_string_view_s name = mirac_string_view_split_left_white_space(&right, &white_space_length);
+		text = mirac_string_view_from_parts(lexer->line.data, 1 + name_offset + name.length);
+		lexer->line = right;
+		lexer->is_in_directive = true;
+		lexer->is_directive_name = true;
+	}
+	else if ('\"' == lexer->line.data[0])
 	{
 		mirac_string_view_s left = {0};
 		mirac_string_view_s right = mirac_string_view_from_parts(lexer->line.data + 1, lexer->line.length - 1);
@@ -537,28 +884,87 @@ search_for_quote_1:
 		text = mirac_string_view_split_left_white_space(&lexer->line, &white_space_length);
 	}
 
-	lexer->locations[1] = lexer->locations[0];
-	lexer->locations[1].column += (text.length + white_space_length);
+	lexer->is_at_line_start = false;
 	return text;
 }
 
+static bool_t is_directive_line_exhausted(
+	mirac_lexer_s* const lexer)
+{
+	mirac_debug_assert(lexer != mirac_null);
+
+	uint64_t white_space_length = 0;
+	lexer->line = mirac_string_view_trim_left_white_space(lexer->line, &white_space_length);
+
+	if (mirac_string_view_equal_range(lexer->line, mirac_string_view_from_parts(";",  1), 1) ||
+		mirac_string_view_equal_range(lexer->line, mirac_string_view_from_parts("//", 2), 2))
+	{
+		lexer->line.length = 0;
+	}
+
+	return lexer->line.length <= 0;
+}
+
+static mirac_token_type_e parse_directive_token_from_text(
+	mirac_lexer_s* const lexer,
+	const mirac_string_view_s text,
+	mirac_token_s* const token)
+{
+	mirac_debug_assert(lexer != mirac_null);
+	mirac_debug_assert(token != mirac_null);
+	mirac_debug_assert(text.length > 0);
+	mirac_debug_assert('#' == text.data[0]);
+
+	static const struct
+	{
+		mirac_string_view_s name;
+		mirac_token_type_e type;
+	} directives[] =
+	{
+		{ mirac_string_view_static("include"), mirac_token_type_directive_include },
+		{ mirac_string_view_static("define"),  mirac_token_type_directive_define  },
+		{ mirac_string_view_static("undef"),   mirac_token_type_directive_undef   },
+		{ mirac_string_view_static("ifdef"),   mirac_token_type_directive_ifdef   },
+		{ mirac_string_view_static("ifndef"),  mirac_token_type_directive_ifndef  },
+		{ mirac_string_view_static("else"),    mirac_token_type_directive_else    },
+		{ mirac_string_view_static("endif"),   mirac_token_type_directive_endif   },
+	};
+
+	mirac_string_view_s name = mirac_string_view_from_parts(text.data + 1, text.length - 1);
+	uint64_t white_space_length = 0;
+	name = mirac_string_view_trim_left_white_space(name, &white_space_length);
+
+	for (uint64_t directive_index = 0; directive_index < (sizeof(directives) / sizeof(directives[0])); ++directive_index)
+	{
+		if (mirac_string_view_equal(name, directives[directive_index].name))
+		{
+			token->type = (uint8_t)directives[directive_index].type;
+			return token->type;
+		}
+	}
+
+	log_lexer_error_and_exit(mirac_token_get_location(token), "encountered unknown directive '" mirac_sv_fmt "'.", mirac_sv_arg(text));
+	return mirac_token_type_none; // note: to prevent compiler error '-Werror=return-type'.
+}
+
 static mirac_token_type_e parse_string_literal_token_from_text(
 	mirac_lexer_s* const lexer,
+	const mirac_string_view_s text,
 	mirac_token_s* const token)
 {
 	mirac_debug_assert(lexer != mirac_null);
 	mirac_debug_assert(lexer->config != mirac_null);
 	mirac_debug_assert(lexer->arena != mirac_null);
 	mirac_debug_assert(token != mirac_null);
-	mirac_debug_assert(token->text.length > 0);
+	mirac_debug_assert(text.length > 0);
 
-	if (token->text.data[0] != '\"') // note: At this point lexer does not perform the length check as it can vary depending on the string literal type.
+	if (text.data[0] != '\"') // note: At this point lexer does not perform the length check as it can vary depending on the string literal type.
 	{
 		return mirac_token_type_none;
 	}
 
 	mirac_string_view_s left = {0};
-	mirac_string_view_s right = mirac_string_view_from_parts(token->text.data + 1, token->text.length - 1);
+	mirac_string_view_s right = mirac_string_view_from_parts(text.data + 1, text.length - 1);
 	mirac_string_view_s result = mirac_string_view_from_parts(right.data, 0);
 
 search_for_quote_2:
@@ -573,7 +979,7 @@ search_for_quote_2:
 
 	if (right.length > 0)
 	{
-		log_lexer_error_and_exit(token->location,
+		log_lexer_error_and_exit(mirac_token_get_location(token),
 			"encountered an invalid suffix '" mirac_sv_fmt "' after the string literal.\n"
 			"note: every token in the language's syntax must be separated by a single white space or a sequence of them.",
 			mirac_sv_arg(right)
@@ -582,13 +988,23 @@ search_for_quote_2:
 
 	if (result.length <= 0)
 	{
-		log_lexer_error_and_exit(token->location,
+		log_lexer_error_and_exit(mirac_token_get_location(token),
 			"encountered an empty string which is not valid.\n"
 			"note: unlike in c-like languages, string literals do not have implicit zero terminator '\\0' at the end."
 		);
 	}
 
-	char_t* const string_literal = (char_t* const)mirac_arena_malloc(lexer->arena, result.length);
+	token->type = mirac_token_type_literal_str;
+
+	if (mirac_string_view_find_char(result, '\\') >= result.length)
+	{
+		// note: without escape sequences the literal is the source text itself.
+		token->as.str = result.data;
+		token->str_length = (uint32_t)result.length;
+		return token->type;
+	}
+
+	char_t* const string_literal = (char_t* const)mirac_arena_malloc_aligned_as(lexer->arena, result.length, 1, mirac_arena_site_lexer_text);
 	mirac_debug_assert(string_literal != mirac_null);
 	uint64_t string_literal_length = 0;
 
@@ -602,7 +1018,7 @@ search_for_quote_2:
 			{
 				if (index >= (result.length - 1))
 				{
-					log_lexer_error_and_exit(token->location,
+					log_lexer_error_and_exit(mirac_token_get_location(token),
 						"encountered an incomplete escape character sequence '%c' in string '" mirac_sv_fmt "'.",
 						curr_char, mirac_sv_arg(result)
 					);
@@ -626,7 +1042,7 @@ search_for_quote_2:
 
 					default:
 					{
-						log_lexer_error_and_exit(token->location,
+						log_lexer_error_and_exit(mirac_token_get_location(token),
 							"encountered an invalid escape character sequence '%c%c' in string '" mirac_sv_fmt "'.",
 							curr_char, next_char, mirac_sv_arg(result)
 						);
@@ -643,66 +1059,125 @@ search_for_quote_2:
 		++string_literal_length;
 	}
 
-	token->type = mirac_token_type_literal_str;
-	token->as.str = mirac_string_view_from_parts(string_literal, string_literal_length);
+	token->as.str = string_literal;
+	token->str_length = (uint32_t)string_literal_length;
 	return token->type;
 }
 
+static bool_t parse_unsigned_integer(
+	const mirac_string_view_s text,
+	const uint64_t base,
+	uint64_t* const value,
+	bool_t* const has_overflowed)
+{
+	mirac_debug_assert(text.data != mirac_null);
+	mirac_debug_assert((base >= 2) && (base <= 16));
+	mirac_debug_assert(value != mirac_null);
+	mirac_debug_assert(has_overflowed != mirac_null);
+
+	*value = 0;
+	*has_overflowed = false;
+
+	if (text.length <= 0)
+	{
+		return true; // note: strtoul accepts an empty string as 0.
+	}
+
+	uint64_t index = 0;
+	const bool_t is_negative = ('-' == text.data[0]);
+
+	if (('-' == text.data[0]) || ('+' == text.data[0]))
+	{
+		++index;
+	}
+
+	if ((16 == base) && ((index + 2) < text.length) && ('0' == text.data[index]) &&
+		(('x' == text.data[index + 1]) || ('X' == text.data[index + 1])) && isxdigit(text.data[index + 2]))
+	{
+		index += 2;
+	}
+
+	const uint64_t digits_index = index;
+
+	for (; index < text.length; ++index)
+	{
+		const char_t curr_char = text.data[index];
+		uint64_t digit = base;
+
+		if ((curr_char >= '0') && (curr_char <= '9')) { digit = (uint64_t)(curr_char - '0');      }
+		if ((curr_char >= 'a') && (curr_char <= 'z')) { digit = (uint64_t)(curr_char - 'a') + 10; }
+		if ((curr_char >= 'A') && (curr_char <= 'Z')) { digit = (uint64_t)(curr_char - 'A') + 10; }
+
+		if (digit >= base)
+		{
+			return false;
+		}
+
+		if (*value > ((UINT64_MAX - digit) / base))
+		{
+			*has_overflowed = true;
+		}
+
+		*value = (*value * base) + digit;
+	}
+
+	if (index <= digits_index)
+	{
+		return false;
+	}
+
+	if (is_negative)
+	{
+		*value = (uint64_t)0 - *value;
+	}
+
+	return true;
+}
+
 static mirac_token_type_e parse_numeric_literal_token_from_text(
 	mirac_lexer_s* const lexer,
+	const mirac_string_view_s text,
 	mirac_token_s* const token)
 {
 	mirac_debug_assert(lexer != mirac_null);
 	mirac_debug_assert(lexer->config != mirac_null);
 	mirac_debug_assert(lexer->arena != mirac_null);
 	mirac_debug_assert(token != mirac_null);
-	mirac_debug_assert(token->text.length > 0);
+	mirac_debug_assert(text.length > 0);
 
-	char_t* endptr = mirac_null;
-	errno = 0;
+	bool_t has_overflowed = false;
+	bool_t is_numeric = false;
 
-	if (mirac_string_view_equal_range(token->text, mirac_string_view_from_parts("0b", 2), 2))
+	if (mirac_string_view_equal_range(text, mirac_string_view_from_parts("0b", 2), 2))
 	{
-		token->as.uval = strtoul(token->text.data + 2, &endptr, 2);
-
-		if (*endptr != '\0')
-		{
-			return mirac_token_type_none;
-		}
+		is_numeric = parse_unsigned_integer(mirac_string_view_from_parts(text.data + 2, text.length - 2),
+			2, &token->as.uval, &has_overflowed);
 	}
-	else if (mirac_string_view_equal_range(token->text, mirac_string_view_from_parts("0o", 2), 2))
+	else if (mirac_string_view_equal_range(text, mirac_string_view_from_parts("0o", 2), 2))
 	{
-		token->as.uval = strtoul(token->text.data + 2, &endptr, 8);
-
-		if (*endptr != '\0')
-		{
-			return mirac_token_type_none;
-		}
+		is_numeric = parse_unsigned_integer(mirac_string_view_from_parts(text.data + 2, text.length - 2),
+			8, &token->as.uval, &has_overflowed);
 	}
-	else if (mirac_string_view_equal_range(token->text, mirac_string_view_from_parts("0x", 2), 2))
+	else if (mirac_string_view_equal_range(text, mirac_string_view_from_parts("0x", 2), 2))
 	{
-		token->as.uval = strtoul(token->text.data + 2, &endptr, 16);
-
-		if (*endptr != '\0')
-		{
-			return mirac_token_type_none;
-		}
+		is_numeric = parse_unsigned_integer(mirac_string_view_from_parts(text.data + 2, text.length - 2),
+			16, &token->as.uval, &has_overflowed);
 	}
 	else
 	{
-		token->as.uval = strtoul(token->text.data, &endptr, 10);
+		is_numeric = parse_unsigned_integer(text, 10, &token->as.uval, &has_overflowed);
+	}
 
-		if (*endptr != '\0')
-		{
-			return mirac_token_type_none;
-		}
+	if (!is_numeric)
+	{
+		return mirac_token_type_none;
 	}
 
-	if (errno != 0)
+	if (has_overflowed)
 	{
-		log_lexer_error_and_exit(token->location,
+		log_lexer_error_and_exit(mirac_token_get_location(token),
 			"encountered a numeric literal overflow at '" mirac_sv_fmt "' value.",
-			mirac_sv_arg(token->text)
+			mirac_sv_arg(text)
 		);
 	}
 
@@ -710,56 +1185,219 @@ static mirac_token_type_e parse_numeric_literal_token_from_text(
 	return token->type;
 }
 
+static bool_t is_reserved_token_text(
+	const mirac_string_view_s text,
+	const mirac_token_type_e type)
+{
+	mirac_debug_assert(type <= mirac_token_type_reserved_count);
+	return mirac_string_view_equal(text, g_reserved_token_types_map[type]);
+}
+
+static mirac_token_type_e match_reserved_token_type(
+	const mirac_string_view_s text,
+	const mirac_token_type_e type)
+{
+	return is_reserved_token_text(text, type) ? type : mirac_token_type_none;
+}
+
+static mirac_token_type_e lookup_reserved_token_type(
+	const mirac_string_view_s text)
+{
+	mirac_debug_assert(text.data != mirac_null);
+
+	switch (text.length)
+	{
+		case 1:
+		{
+			switch (text.data[0])
+			{
+				case '!': { return mirac_token_type_reserved_lnot; } break;
+				case '~': { return mirac_token_type_reserved_bnot; } break;
+				case '&': { return mirac_token_type_reserved_band; } break;
+				case '|': { return mirac_token_type_reserved_bor; } break;
+				case '^': { return mirac_token_type_reserved_bxor; } break;
+				case '+': { return mirac_token_type_reserved_add; } break;
+				case '-': { return mirac_token_type_reserved_sub; } break;
+				case '*': { return mirac_token_type_reserved_mul; } break;
+				case '/': { return mirac_token_type_reserved_div; } break;
+				case '%': { return mirac_token_type_reserved_mod; } break;
+				case '>': { return mirac_token_type_reserved_gt; } break;
+				case '<': { return mirac_token_type_reserved_ls; } break;
+				case '(': { return mirac_token_type_reserved_left_parenthesis; } break;
+				case ')': { return mirac_token_type_reserved_right_parenthesis; } break;
+				case '[': { return mirac_token_type_reserved_left_bracket; } break;
+				case ']': { return mirac_token_type_reserved_right_bracket; } break;
+				case '{': { return mirac_token_type_reserved_left_brace; } break;
+				case '}': { return mirac_token_type_reserved_right_brace; } break;
+				default: { } break;
+			}
+		} break;
+
+		case 2:
+		{
+			switch (text.data[0])
+			{
+				case '&': { return match_reserved_token_type(text, mirac_token_type_reserved_land); } break;
+				case '|': { return match_reserved_token_type(text, mirac_token_type_reserved_lor); } break;
+				case '^': { return match_reserved_token_type(text, mirac_token_type_reserved_lxor); } break;
+				case '<':
+				{
+					if (is_reserved_token_text(text, mirac_token_type_reserved_shl)) { return mirac_token_type_reserved_shl; }
+					if (is_reserved_token_text(text, mirac_token_type_reserved_lseq)) { return mirac_token_type_reserved_lseq; }
+				} break;
+				case '>':
+				{
+					if (is_reserved_token_text(text, mirac_token_type_reserved_shr)) { return mirac_token_type_reserved_shr; }
+					if (is_reserved_token_text(text, mirac_token_type_reserved_gteq)) { return mirac_token_type_reserved_gteq; }
+				} break;
+				case '+': { return match_reserved_token_type(text, mirac_token_type_reserved_inc); } break;
+				case '-': { return match_reserved_token_type(text, mirac_token_type_reserved_dec); } break;
+				case '/': { return match_reserved_token_type(text, mirac_token_type_reserved_divmod); } break;
+				case '=': { return match_reserved_token_type(text, mirac_token_type_reserved_eq); } break;
+				case '!': { return match_reserved_token_type(text, mirac_token_type_reserved_neq); } break;
+				case 'i': { return match_reserved_token_type(text, mirac_token_type_reserved_if); } break;
+				case 'a': { return match_reserved_token_type(text, mirac_token_type_reserved_as); } break;
+				default: { } break;
+			}
+		} break;
+
+		case 3:
+		{
+			switch (text.data[0])
+			{
+				case 'd': { return match_reserved_token_type(text, mirac_token_type_reserved_dup); } break;
+				case 'r':
+				{
+					if (is_reserved_token_text(text, mirac_token_type_reserved_rot)) { return mirac_token_type_reserved_rot; }
+					if (is_reserved_token_text(text, mirac_token_type_reserved_req)) { return mirac_token_type_reserved_req; }
+					if (is_reserved_token_text(text, mirac_token_type_reserved_ret)) { return mirac_token_type_reserved_ret; }
+				} break;
+				case 'i':
+				{
+					if (is_reserved_token_text(text, mirac_token_type_reserved_i08)) { return mirac_token_type_reserved_i08; }
+					if (is_reserved_token_text(text, mirac_token_type_reserved_i16)) { return mirac_token_type_reserved_i16; }
+					if (is_reserved_token_text(text, mirac_token_type_reserved_i32)) { return mirac_token_type_reserved_i32; }
+					if (is_reserved_token_text(text, mirac_token_type_reserved_i64)) { return mirac_token_type_reserved_i64; }
+				} break;
+				case 'u':
+				{
+					if (is_reserved_token_text(text, mirac_token_type_reserved_u08)) { return mirac_token_type_reserved_u08; }
+					if (is_reserved_token_text(text, mirac_token_type_reserved_u16)) { return mirac_token_type_reserved_u16; }
+					if (is_reserved_token_text(text, mirac_token_type_reserved_u32)) { return mirac_token_type_reserved_u32; }
+					if (is_reserved_token_text(text, mirac_token_type_reserved_u64)) { return mirac_token_type_reserved_u64; }
+				} break;
+				case 'p': { return match_reserved_token_type(text, mirac_token_type_reserved_ptr); } break;
+				case 's':
+				{
+					if (is_reserved_token_text(text, mirac_token_type_reserved_sec)) { return mirac_token_type_reserved_sec; }
+					if (is_reserved_token_text(text, mirac_token_type_reserved_str)) { return mirac_token_type_reserved_str; }
+				} break;
+				case 'm': { return match_reserved_token_type(text, mirac_token_type_reserved_mem); } break;
+				case 'f': { return match_reserved_token_type(text, mirac_token_type_reserved_fun); } break;
+				case 'a': { return match_reserved_token_type(text, mirac_token_type_reserved_asm); } break;
+				default: { } break;
+			}
+		} break;
+
+		case 4:
+		{
+			switch (text.data[0])
+			{
+				case 'd': { return match_reserved_token_type(text, mirac_token_type_reserved_drop); } break;
+				case 'o': { return match_reserved_token_type(text, mirac_token_type_reserved_over); } break;
+				case 's':
+				{
+					if (is_reserved_token_text(text, mirac_token_type_reserved_swap)) { return mirac_token_type_reserved_swap; }
+					if (is_reserved_token_text(text, mirac_token_type_reserved_st08)) { return mirac_token_type_reserved_st08; }
+					if (is_reserved_token_text(text, mirac_token_type_reserved_st16)) { return mirac_token_type_reserved_st16; }
+					if (is_reserved_token_text(text, mirac_token_type_reserved_st32)) { return mirac_token_type_reserved_st32; }
+					if (is_reserved_token_text(text, mirac_token_type_reserved_st64)) { return mirac_token_type_reserved_st64; }
+					if (is_reserved_token_text(text, mirac_token_type_reserved_sys1)) { return mirac_token_type_reserved_sys1; }
+					if (is_reserved_token_text(text, mirac_token_type_reserved_sys2)) { return mirac_token_type_reserved_sys2; }
+					if (is_reserved_token_text(text, mirac_token_type_reserved_sys3)) { return mirac_token_type_reserved_sys3; }
+					if (is_reserved_token_text(text, mirac_token_type_reserved_sys4)) { return mirac_token_type_reserved_sys4; }
+					if (is_reserved_token_text(text, mirac_token_type_reserved_sys5)) { return mirac_token_type_reserved_sys5; }
+					if (is_reserved_token_text(text, mirac_token_type_reserved_sys6)) { return mirac_token_type_reserved_sys6; }
+				} break;
+				case 'l':
+				{
+					if (is_reserved_token_text(text, mirac_token_type_reserved_ld08)) { return mirac_token_type_reserved_ld08; }
+					if (is_reserved_token_text(text, mirac_token_type_reserved_ld16)) { return mirac_token_type_reserved_ld16; }
+					if (is_reserved_token_text(text, mirac_token_type_reserved_ld32)) { return mirac_token_type_reserved_ld32; }
+					if (is_reserved_token_text(text, mirac_token_type_reserved_ld64)) { return mirac_token_type_reserved_ld64; }
+					if (is_reserved_token_text(text, mirac_token_type_reserved_loop)) { return mirac_token_type_reserved_loop; }
+				} break;
+				case 't': { return match_reserved_token_type(text, mirac_token_type_reserved_true); } break;
+				case 'e': { return match_reserved_token_type(text, mirac_token_type_reserved_else); } break;
+				case 'c': { return match_reserved_token_type(text, mirac_token_type_reserved_call); } break;
+				default: { } break;
+			}
+		} break;
+
+		case 5:
+		{
+			switch (text.data[0])
+			{
+				case 'f': { return match_reserved_token_type(text, mirac_token_type_reserved_false); } break;
+				default: { } break;
+			}
+		} break;
+
+		default: { } break;
+	}
+
+	return mirac_token_type_none;
+}
+
 static mirac_token_type_e parse_reserved_token_from_text(
 	mirac_lexer_s* const lexer,
+	const mirac_string_view_s text,
 	mirac_token_s* const token)
 {
 	mirac_debug_assert(lexer != mirac_null);
 	mirac_debug_assert(lexer->config != mirac_null);
 	mirac_debug_assert(lexer->arena != mirac_null);
 	mirac_debug_assert(token != mirac_null);
-	mirac_debug_assert(token->text.length > 0);
+	mirac_debug_assert(text.length > 0);
 
-	for (uint64_t reserved_token_index = 0; reserved_token_index < (mirac_token_type_reserved_count + 1); ++reserved_token_index)
+	const mirac_token_type_e type = lookup_reserved_token_type(text);
+
+	if (type != mirac_token_type_none)
 	{
-		if (mirac_string_view_equal(token->text, g_reserved_token_types_map[reserved_token_index]))
-		{
-			token->type = reserved_token_index;
-			return token->type;
-		}
+		token->type = (uint8_t)type;
 	}
 
-	return mirac_token_type_none;
+	return type;
 }
 
 static mirac_token_type_e parse_identifier_token_from_text(
 	mirac_lexer_s* const lexer,
+	const mirac_string_view_s text,
 	mirac_token_s* const token)
 {
 	mirac_debug_assert(lexer != mirac_null);
 	mirac_debug_assert(lexer->config != mirac_null);
-	mirac_debug_assert(lexer->arena != mirac_null);
+	mirac_debug_assert(lexer->interner != mirac_null);
 	mirac_debug_assert(token != mirac_null);
-	mirac_debug_assert(token->text.length > 0);
+	mirac_debug_assert(text.length > 0);
 
-	if (isdigit(token->text.data[0]) || is_char_any_quote(token->text.data[0]))
+	if (isdigit(text.data[0]) || is_char_any_quote(text.data[0]))
 	{
 		return mirac_token_type_none;
 	}
 
-	for (uint64_t index = 1; index < token->text.length; ++index)
+	for (uint64_t index = 1; index < text.length; ++index)
 	{
-		if (is_char_any_quote(token->text.data[index]))
+		if (is_char_any_quote(text.data[index]))
 		{
 			return mirac_token_type_none;
 		}
 	}
 
-	char_t* const ident_string = (char_t* const)mirac_arena_malloc(lexer->arena, token->text.length);
-	mirac_debug_assert(ident_string != mirac_null);
-	mirac_c_memcpy(ident_string, token->text.data, token->text.length);
-
+	// note: identifiers are interned, so each distinct name is stored only once
+	//       and can be compared by its symbol.
 	token->type = mirac_token_type_identifier;
-	token->as.ident = mirac_string_view_from_parts(ident_string, token->text.length);
+	token->symbol = mirac_interner_intern(lexer->interner, text);
+	token->as.ident = mirac_interner_get_string(lexer->interner, token->symbol).data;
 	return token->type;
 }
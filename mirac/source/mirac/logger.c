@@ -28,12 +28,85 @@
 #define tag_warn  "warn"
 #define tag_error "error"
 
+#define log_buffer_capacity 1024
+
+typedef struct
+{
+	mirac_file_t* stream;
+	uint64_t length;
+} capture_entry_header_s;
+
+static _Thread_local mirac_logger_capture_s* g_capture = mirac_null;
+
+/**
+ * @brief Format the log and write it into the stream (or the capture of the
+ * calling thread, if it is set) with a single write.
+ * 
+ * @param stream stream to write the log into
+ * @param tag    tag of the log (or mirac_null for a tagless log)
+ * @param format format of the log
+ * @param args   arguments of the log
+ */
 static void log_with_tag(
 	mirac_file_t* const stream,
 	const char_t* const tag,
 	const char_t* const format,
 	va_list args);
 
+/**
+ * @brief Append bytes to the capture, growing it if needed.
+ * 
+ * @param capture capture to append to
+ * @param data    bytes to append
+ * @param length  number of bytes to append
+ */
+static void append_to_capture(
+	mirac_logger_capture_s* const capture,
+	const void* const data,
+	const uint64_t length);
+
+mirac_logger_capture_s mirac_logger_capture_from_parts(
+	void)
+{
+	return (mirac_logger_capture_s)
+	{
+		.data     = mirac_null,
+		.length   = 0,
+		.capacity = 0
+	};
+}
+
+void mirac_logger_capture_destroy(
+	mirac_logger_capture_s* const capture)
+{
+	mirac_debug_assert(capture != mirac_null);
+	mirac_c_free(capture->data);
+	*capture = mirac_logger_capture_from_parts();
+}
+
+void mirac_logger_set_capture(
+	mirac_logger_capture_s* const capture)
+{
+	g_capture = capture;
+}
+
+void mirac_logger_capture_print(
+	const mirac_logger_capture_s* const capture)
+{
+	mirac_debug_assert(capture != mirac_null);
+	uint64_t offset = 0;
+
+	while (offset < capture->length)
+	{
+		capture_entry_header_s header = {0};
+		mirac_c_memcpy(&header, capture->data + offset, sizeof(header));
+		offset += sizeof(header);
+
+		(void)fwrite(capture->data + offset, 1, header.length, header.stream);
+		offset += header.length;
+	}
+}
+
 void mirac_logger_log(
 	const char_t* const format,
 	...)
@@ -95,11 +168,74 @@ static void log_with_tag(
 	mirac_debug_assert(stream != mirac_null);
 	mirac_debug_assert(format != mirac_null);
 
+	char_t buffer[log_buffer_capacity] = {0};
+	char_t* message = buffer;
+	uint64_t length = 0;
+
 	if (tag != mirac_null)
 	{
-		(void)fprintf(stream, "%s: ", tag);
+		length = (uint64_t)snprintf(buffer, sizeof(buffer), "%s: ", tag);
+	}
+
+	va_list args_copy; va_copy(args_copy, args);
+	const uint64_t body_length = (uint64_t)vsnprintf(buffer + length, sizeof(buffer) - length, format, args);
+
+	// note: one more byte for the new line and one more for the null terminator.
+	if ((length + body_length + 2) > sizeof(buffer))
+	{
+		message = (char_t*)mirac_c_malloc(length + body_length + 2);
+
+		// note: untagged messages (like the usage) have no prefix to copy.
+		if (length > 0)
+		{
+			mirac_c_memcpy(message, buffer, length);
+		}
+
+		(void)vsnprintf(message + length, body_length + 1, format, args_copy);
+	}
+
+	va_end(args_copy);
+	length += body_length;
+	message[length++] = '\n';
+
+	if (g_capture != mirac_null)
+	{
+		const capture_entry_header_s header = { .stream = stream, .length = length };
+		append_to_capture(g_capture, &header, sizeof(header));
+		append_to_capture(g_capture, message, length);
+	}
+	else
+	{
+		(void)fwrite(message, 1, length, stream);
+	}
+
+	if (message != buffer)
+	{
+		mirac_c_free(message);
+	}
+}
+
+static void append_to_capture(
+	mirac_logger_capture_s* const capture,
+	const void* const data,
+	const uint64_t length)
+{
+	mirac_debug_assert(capture != mirac_null);
+	mirac_debug_assert(data != mirac_null);
+
+	if ((capture->length + length) > capture->capacity)
+	{
+		uint64_t capacity = capture->capacity > 0 ? capture->capacity : log_buffer_capacity;
+
+		while ((capture->length + length) > capacity)
+		{
+			capacity *= 2;
+		}
+
+		capture->data = (char_t*)mirac_c_realloc(capture->data, capacity);
+		capture->capacity = capacity;
 	}
 
-	(void)vfprintf(stream, format, args);
-	(void)fprintf(stream, "\n");
+	mirac_c_memcpy(capture->data + capture->length, data, length);
+	capture->length += length;
 }
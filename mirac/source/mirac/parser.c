@@ -15,9 +15,12 @@
 #include <mirac/debug.h>
 #include <mirac/logger.h>
 
-mirac_implement_linked_list_type(mirac_token_list, mirac_token_s);
-mirac_implement_linked_list_type(mirac_ast_block_list, mirac_ast_block_s*);
-mirac_implement_linked_list_type(mirac_ast_def_list, mirac_ast_def_s*);
+mirac_implement_heap_array_type(mirac_ast_block_list, mirac_ast_block_t);
+mirac_implement_heap_array_type(mirac_ast_def_list, mirac_ast_def_s*);
+mirac_implement_symbol_table_type(mirac_ast_def_table, mirac_ast_def_s*);
+mirac_implement_heap_array_type(mirac_ast_block_type_list, uint8_t);
+mirac_implement_heap_array_type(mirac_ast_block_position_list, mirac_position_s);
+mirac_implement_heap_array_type(mirac_ast_block_payload_list, mirac_ast_block_payload_s);
 
 #define log_parser_error_and_exit(_location, _format, ...)                     \
 	do                                                                         \
@@ -28,6 +31,83 @@ mirac_implement_linked_list_type(mirac_ast_def_list, mirac_ast_def_s*);
 		mirac_c_exit(-1);                                                      \
 	} while (0)
 
+/**
+ * @brief Preprocess all the tokens of the unit into the parser's token array
+ * (timed as the lex phase, if the unit is profiled).
+ * 
+ * @param parser parser instance
+ */
+static void prelex_tokens(
+	mirac_parser_s* const parser);
+
+/**
+ * @brief Fetch the next token from the pre-lexed tokens, or else from the
+ * preprocessor (timed as the lex phase, if the unit is profiled).
+ * 
+ * @param parser parser instance
+ * @param token  token to fetch into
+ * 
+ * @return mirac_token_type_e
+ */
+static mirac_token_type_e lex_next(
+	mirac_parser_s* const parser,
+	mirac_token_s* const token);
+
+/**
+ * @brief Give back the last fetched token, so that it is fetched again next.
+ * 
+ * @param parser parser instance
+ * @param token  token to give back
+ */
+static void unlex(
+	mirac_parser_s* const parser,
+	mirac_token_s* const token);
+
+/**
+ * @brief Get the token at the offset from the next one without fetching it.
+ * 
+ * @note Any offset can be peeked at, when the tokens are pre-lexed, but only the
+ * next token (offset 0) otherwise.
+ * 
+ * @param parser parser instance
+ * @param offset offset from the next token
+ * 
+ * @return mirac_token_s
+ */
+static mirac_token_s peek_token(
+	mirac_parser_s* const parser,
+	const uint64_t offset);
+
+/**
+ * @brief Find the def of the identifier (timed as the resolve phase, if the
+ * unit is profiled).
+ * 
+ * @param parser parser instance
+ * @param symbol symbol of the identifier
+ * @param def    def to find into
+ * 
+ * @return bool_t
+ */
+static bool_t resolve_def(
+	mirac_parser_s* const parser,
+	const mirac_symbol_t symbol,
+	mirac_ast_def_s** const def);
+
+/**
+ * @brief Define the identifier (timed as the resolve phase, if the unit is
+ * profiled).
+ * 
+ * @param parser parser instance
+ * @param symbol symbol of the identifier
+ * @param def    def of the identifier
+ * 
+ * @return bool_t false if the identifier is already defined
+ */
+static bool_t define_def(
+	mirac_parser_s* const parser,
+	const mirac_symbol_t symbol,
+	mirac_ast_def_s* const def);
+
 // todo: write unit tests!
 // todo: document!
 static mirac_ast_block_expr_s create_ast_block_expr(
@@ -73,10 +153,41 @@ static mirac_ast_block_loop_s create_ast_block_loop(
 static mirac_ast_block_asm_s create_ast_block_asm(
 	mirac_arena_s* const arena);
 
-// todo: write unit tests!
-// todo: document!
-static mirac_ast_block_s* create_ast_block(
-	mirac_arena_s* const arena);
+/**
+ * @brief Add a block to the parser's unit.
+ * 
+ * @param parser   parser instance
+ * @param position position of the block's first token
+ * 
+ * @return mirac_ast_block_t
+ */
+static mirac_ast_block_t create_ast_block(
+	mirac_parser_s* const parser,
+	const mirac_position_s position);
+
+/**
+ * @brief Get the type of the block of the parser's unit.
+ * 
+ * @param parser parser instance
+ * @param block  handle of the block
+ * 
+ * @return mirac_ast_block_type_e
+ */
+static mirac_ast_block_type_e get_block_type(
+	const mirac_parser_s* const parser,
+	const mirac_ast_block_t block);
+
+/**
+ * @brief Get the location of the block of the parser's unit.
+ * 
+ * @param parser parser instance
+ * @param block  handle of the block
+ * 
+ * @return mirac_location_s
+ */
+static mirac_location_s get_block_location(
+	const mirac_parser_s* const parser,
+	const mirac_ast_block_t block);
 
 // todo: write unit tests!
 // todo: document!
@@ -150,7 +261,7 @@ static mirac_ast_block_asm_s parse_ast_block_asm(
 
 // todo: write unit tests!
 // todo: document!
-static mirac_ast_block_s* parse_ast_block(
+static mirac_ast_block_t parse_ast_block(
 	mirac_parser_s* const parser);
 
 // todo: write unit tests!
@@ -177,76 +288,87 @@ static mirac_ast_def_s* parse_ast_def(
 // todo: document!
 static void print_ast_block_expr(
 	mirac_file_t* const file,
-	const mirac_ast_block_s* const block,
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block,
 	const uint64_t indent);
 
 // todo: write unit tests!
 // todo: document!
 static void print_ast_block_ident(
 	mirac_file_t* const file,
-	const mirac_ast_block_s* const block,
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block,
 	const uint64_t indent);
 
 // todo: write unit tests!
 // todo: document!
 static void print_ast_block_call(
 	mirac_file_t* const file,
-	const mirac_ast_block_s* const block,
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block,
 	const uint64_t indent);
 
 // todo: write unit tests!
 // todo: document!
 static void print_ast_block_as(
 	mirac_file_t* const file,
-	const mirac_ast_block_s* const block,
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block,
 	const uint64_t indent);
 
 // todo: write unit tests!
 // todo: document!
 static void print_ast_block_scope(
 	mirac_file_t* const file,
-	const mirac_ast_block_s* const block,
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block,
 	const uint64_t indent);
 
 // todo: write unit tests!
 // todo: document!
 static void print_ast_block_if(
 	mirac_file_t* const file,
-	const mirac_ast_block_s* const block,
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block,
 	const uint64_t indent);
 
 // todo: write unit tests!
 // todo: document!
 static void print_ast_block_else(
 	mirac_file_t* const file,
-	const mirac_ast_block_s* const block,
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block,
 	const uint64_t indent);
 
 // todo: write unit tests!
 // todo: document!
 static void print_ast_block_loop(
 	mirac_file_t* const file,
-	const mirac_ast_block_s* const block,
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block,
 	const uint64_t indent);
 
 // todo: write unit tests!
 // todo: document!
 static void print_ast_block_asm(
 	mirac_file_t* const file,
-	const mirac_ast_block_s* const block,
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block,
 	const uint64_t indent);
 
 // todo: write unit tests!
 // todo: document!
 static void print_ast_block(
 	mirac_file_t* const file,
-	const mirac_ast_block_s* const block,
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block,
 	const uint64_t indent);
 
 // todo: write unit tests!
 // todo: document!
 static void print_ast_def_fun(
 	mirac_file_t* const file,
+	const mirac_ast_unit_s* const unit,
 	const mirac_ast_def_s* const def,
 	const uint64_t indent);
 
@@ -254,6 +376,7 @@ static void print_ast_def_fun(
 // todo: document!
 static void print_ast_def_mem(
 	mirac_file_t* const file,
+	const mirac_ast_unit_s* const unit,
 	const mirac_ast_def_s* const def,
 	const uint64_t indent);
 
@@ -261,6 +384,7 @@ static void print_ast_def_mem(
 // todo: document!
 static void print_ast_def_str(
 	mirac_file_t* const file,
+	const mirac_ast_unit_s* const unit,
 	const mirac_ast_def_s* const def,
 	const uint64_t indent);
 
@@ -268,6 +392,7 @@ static void print_ast_def_str(
 // todo: document!
 static void print_ast_def(
 	mirac_file_t* const file,
+	const mirac_ast_unit_s* const unit,
 	const mirac_ast_def_s* const def,
 	const uint64_t indent);
 
@@ -359,10 +484,88 @@ mirac_ast_unit_s mirac_ast_unit_from_parts(
 
 	return (mirac_ast_unit_s)
 	{
-		.defs = mirac_ast_def_list_from_parts(arena)
+		.defs            = mirac_ast_def_list_from_parts(arena, 0),
+		.block_types     = mirac_ast_block_type_list_from_parts(arena, 0),
+		.block_positions = mirac_ast_block_position_list_from_parts(arena, 0),
+		.block_payloads  = mirac_ast_block_payload_list_from_parts(arena, 0),
+		.children        = mirac_ast_block_list_from_parts(arena, 0),
+		.type_tokens     = mirac_token_list_from_parts(arena, 0)
 	};
 }
 
+mirac_ast_block_type_e mirac_ast_unit_get_block_type(
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block)
+{
+	mirac_debug_assert(unit != mirac_null);
+	mirac_debug_assert(block < unit->block_types.count);
+	return (mirac_ast_block_type_e)unit->block_types.data[block];
+}
+
+mirac_position_s mirac_ast_unit_get_block_position(
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block)
+{
+	mirac_debug_assert(unit != mirac_null);
+	mirac_debug_assert(block < unit->block_positions.count);
+	return unit->block_positions.data[block];
+}
+
+const mirac_ast_block_payload_s* mirac_ast_unit_get_block_payload(
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block)
+{
+	mirac_debug_assert(unit != mirac_null);
+	mirac_debug_assert(block < unit->block_payloads.count);
+	return &unit->block_payloads.data[block];
+}
+
+mirac_token_s mirac_ast_unit_get_block_token(
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block)
+{
+	mirac_debug_assert(unit != mirac_null);
+
+	const mirac_position_s position = mirac_ast_unit_get_block_position(unit, block);
+	const mirac_ast_block_payload_s* const payload = mirac_ast_unit_get_block_payload(unit, block);
+
+	switch (mirac_ast_unit_get_block_type(unit, block))
+	{
+		case mirac_ast_block_type_expr:
+		{
+			const mirac_ast_block_expr_s* const expr_block = &payload->as.expr_block;
+			mirac_token_s token = mirac_token_from_parts(expr_block->token_type, position, expr_block->length);
+			token.as.uval = expr_block->as.uval;
+			return token;
+		} break;
+
+		case mirac_ast_block_type_ident:
+		{
+			// note: the identifier is spelled (and interned) like its def's one.
+			const mirac_token_s identifier = mirac_ast_def_get_identifier_token(payload->as.ident_block.def);
+			mirac_token_s token = mirac_token_from_parts(mirac_token_type_identifier, position, identifier.length);
+			token.symbol = identifier.symbol;
+			token.as.ident = identifier.as.ident;
+			return token;
+		} break;
+
+		case mirac_ast_block_type_asm:
+		{
+			const mirac_ast_block_asm_s* const asm_block = &payload->as.asm_block;
+			mirac_token_s token = mirac_token_from_parts(mirac_token_type_literal_str, position, asm_block->length);
+			token.str_length = asm_block->inst_length;
+			token.as.str = asm_block->inst;
+			return token;
+		} break;
+
+		default:
+		{
+			mirac_debug_assert(0); // note: should never reach this block.
+			return mirac_token_from_type(mirac_token_type_none);
+		} break;
+	}
+}
+
 void mirac_ast_unit_print(
 	mirac_file_t* const file,
 	const mirac_ast_unit_s* const unit,
@@ -376,9 +579,9 @@ void mirac_ast_unit_print(
 
 	for (uint64_t indent_index = 0; indent_index < (indent + 1); ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "defs:\n");
-	for (const mirac_ast_def_list_node_s* defs_iterator = unit->defs.begin; defs_iterator != mirac_null; defs_iterator = defs_iterator->next)
+	for (uint64_t def_index = 0; def_index < unit->defs.count; ++def_index)
 	{
-		print_ast_def(file, defs_iterator->data, indent + 2);
+		print_ast_def(file, unit, unit->defs.data[def_index], indent + 2);
 	}
 
 	for (uint64_t indent_index = 0; indent_index < indent; ++indent_index) (void)fprintf(file, "\t");
@@ -388,18 +591,27 @@ void mirac_ast_unit_print(
 mirac_parser_s mirac_parser_from_parts(
 	mirac_config_s* const config,
 	mirac_arena_s* const arena,
-	mirac_lexer_s* const lexer)
+	mirac_preprocessor_s* const preprocessor,
+	mirac_profiler_unit_s* const profile)
 {
 	mirac_debug_assert(config != mirac_null);
 	mirac_debug_assert(arena != mirac_null);
-	mirac_debug_assert(lexer != mirac_null);
+	mirac_debug_assert(preprocessor != mirac_null);
+	mirac_debug_assert(preprocessor->interner != mirac_null);
 
 	return (mirac_parser_s)
 	{
-		.config = config,
-		.arena  = arena,
-		.lexer  = lexer,
-		.unit   = mirac_ast_unit_from_parts(arena)
+		.config           = config,
+		.arena            = arena,
+		.preprocessor     = preprocessor,
+		.unit             = mirac_ast_unit_from_parts(arena),
+		.def_table        = mirac_ast_def_table_from_parts(arena, preprocessor->interner),
+		.pending_children = mirac_ast_block_list_from_parts(arena, 0),
+		.tokens           = mirac_token_list_from_parts(arena, 0),
+		.token_index      = 0,
+		.is_prelexed      = false,
+		.entry_symbol     = mirac_interner_intern(preprocessor->interner, config->entry),
+		.profile          = profile
 	};
 }
 
@@ -416,7 +628,12 @@ mirac_ast_unit_s mirac_parser_parse_ast_unit(
 	mirac_debug_assert(parser != mirac_null);
 	mirac_debug_assert(parser->config != mirac_null);
 	mirac_debug_assert(parser->arena != mirac_null);
-	mirac_debug_assert(parser->lexer != mirac_null);
+	mirac_debug_assert(parser->preprocessor != mirac_null);
+
+	if (parser->config->prelex)
+	{
+		prelex_tokens(parser);
+	}
 
 	mirac_ast_def_s* def = mirac_null;
 	while ((def = parse_ast_def(parser)) != mirac_null)
@@ -427,19 +644,12 @@ mirac_ast_unit_s mirac_parser_parse_ast_unit(
 		}
 
 		const mirac_token_s current_def_identifier_token = mirac_ast_def_get_identifier_token(def);
-		for (const mirac_ast_def_list_node_s* defs_iterator = parser->unit.defs.begin; defs_iterator != mirac_null; defs_iterator = defs_iterator->next)
+		if (!define_def(parser, current_def_identifier_token.symbol, def))
 		{
-			mirac_debug_assert(defs_iterator != mirac_null);
-			mirac_debug_assert(defs_iterator->data != mirac_null);
-
-			const mirac_token_s existing_def_identifier_token = mirac_ast_def_get_identifier_token(defs_iterator->data);
-			if (mirac_string_view_equal(current_def_identifier_token.as.ident, existing_def_identifier_token.as.ident))
-			{
-				log_parser_error_and_exit(current_def_identifier_token.location,
-					"encountered a redefinition of '" mirac_sv_fmt "' identifier.",
-					mirac_sv_arg(current_def_identifier_token.as.ident)
-				);
-			}
+			log_parser_error_and_exit(mirac_token_get_location(&current_def_identifier_token),
+				"encountered a redefinition of '" mirac_sv_fmt "' identifier.",
+				mirac_sv_arg(mirac_token_get_ident(&current_def_identifier_token))
+			);
 		}
 
 		mirac_ast_def_list_push(&parser->unit.defs, def);
@@ -448,6 +658,139 @@ mirac_ast_unit_s mirac_parser_parse_ast_unit(
 	return parser->unit;
 }
 
+static void prelex_tokens(
+	mirac_parser_s* const parser)
+{
+	mirac_debug_assert(parser != mirac_null);
+	mirac_debug_assert(parser->preprocessor != mirac_null);
+
+	const mirac_profiler_phase_e phase = parser->profile != mirac_null ?
+		mirac_profiler_unit_switch_phase(parser->profile, mirac_profiler_phase_lex) : mirac_profiler_phase_none;
+	const mirac_arena_site_e site = mirac_arena_set_site(parser->arena, mirac_arena_site_tokens);
+	mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
+
+	// note: the last token is the eof (or none) token, which is fetched over and
+	//       over once the parser reaches it.
+	do
+	{
+		(void)mirac_preprocessor_lex_next(parser->preprocessor, &token);
+		mirac_token_list_push(&parser->tokens, token);
+	} while (!mirac_lexer_should_stop_lexing(token.type));
+
+	(void)mirac_arena_set_site(parser->arena, site);
+	parser->is_prelexed = true;
+
+	if (parser->profile != mirac_null)
+	{
+		(void)mirac_profiler_unit_switch_phase(parser->profile, phase);
+	}
+}
+
+static mirac_token_type_e lex_next(
+	mirac_parser_s* const parser,
+	mirac_token_s* const token)
+{
+	mirac_debug_assert(parser != mirac_null);
+	mirac_debug_assert(parser->preprocessor != mirac_null);
+
+	if (parser->is_prelexed)
+	{
+		mirac_debug_assert(parser->tokens.count > 0);
+		*token = parser->tokens.data[parser->token_index];
+		parser->token_index += (parser->token_index + 1) < parser->tokens.count;
+		return token->type;
+	}
+
+	if (mirac_null == parser->profile)
+	{
+		return mirac_preprocessor_lex_next(parser->preprocessor, token);
+	}
+
+	const mirac_profiler_phase_e phase = mirac_profiler_unit_switch_phase(parser->profile, mirac_profiler_phase_lex);
+	const mirac_token_type_e type = mirac_preprocessor_lex_next(parser->preprocessor, token);
+	(void)mirac_profiler_unit_switch_phase(parser->profile, phase);
+	return type;
+}
+
+static void unlex(
+	mirac_parser_s* const parser,
+	mirac_token_s* const token)
+{
+	mirac_debug_assert(parser != mirac_null);
+	mirac_debug_assert(token != mirac_null);
+
+	if (parser->is_prelexed)
+	{
+		// note: the eof token is not stepped over, so it must not be stepped back.
+		if (!mirac_lexer_should_stop_lexing(token->type))
+		{
+			mirac_debug_assert(parser->token_index > 0);
+			--parser->token_index;
+		}
+
+		return;
+	}
+
+	mirac_preprocessor_unlex(parser->preprocessor, token);
+}
+
+static mirac_token_s peek_token(
+	mirac_parser_s* const parser,
+	const uint64_t offset)
+{
+	mirac_debug_assert(parser != mirac_null);
+
+	if (parser->is_prelexed)
+	{
+		const uint64_t index = parser->token_index + offset;
+		return parser->tokens.data[index < parser->tokens.count ? index : (parser->tokens.count - 1)];
+	}
+
+	mirac_debug_assert(0 == offset);
+	mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
+	(void)lex_next(parser, &token);
+	unlex(parser, &token);
+	return token;
+}
+
+static bool_t resolve_def(
+	mirac_parser_s* const parser,
+	const mirac_symbol_t symbol,
+	mirac_ast_def_s** const def)
+{
+	mirac_debug_assert(parser != mirac_null);
+	mirac_debug_assert(def != mirac_null);
+
+	if (mirac_null == parser->profile)
+	{
+		return mirac_ast_def_table_find(&parser->def_table, symbol, def);
+	}
+
+	const mirac_profiler_phase_e phase = mirac_profiler_unit_switch_phase(parser->profile, mirac_profiler_phase_resolve);
+	const bool_t is_found = mirac_ast_def_table_find(&parser->def_table, symbol, def);
+	(void)mirac_profiler_unit_switch_phase(parser->profile, phase);
+	return is_found;
+}
+
+static bool_t define_def(
+	mirac_parser_s* const parser,
+	const mirac_symbol_t symbol,
+	mirac_ast_def_s* const def)
+{
+	mirac_debug_assert(parser != mirac_null);
+	mirac_debug_assert(def != mirac_null);
+
+	if (mirac_null == parser->profile)
+	{
+		return mirac_ast_def_table_insert(&parser->def_table, symbol, def);
+	}
+
+	const mirac_profiler_phase_e phase = mirac_profiler_unit_switch_phase(parser->profile, mirac_profiler_phase_resolve);
+	const bool_t is_defined = mirac_ast_def_table_insert(&parser->def_table, symbol, def);
+	(void)mirac_profiler_unit_switch_phase(parser->profile, phase);
+	return is_defined;
+}
+
 static mirac_ast_block_expr_s create_ast_block_expr(
 	mirac_arena_s* const arena)
 {
@@ -473,29 +816,25 @@ static mirac_ast_block_as_s create_ast_block_as(
 	mirac_arena_s* const arena)
 {
 	mirac_debug_assert(arena != mirac_null);
-
-	return (mirac_ast_block_as_s)
-	{
-		.type_tokens = mirac_token_list_from_parts(arena),
-	};
+	return (mirac_ast_block_as_s) {0};
 }
 
 static mirac_ast_block_scope_s create_ast_block_scope(
 	mirac_arena_s* const arena)
 {
 	mirac_debug_assert(arena != mirac_null);
-
-	return (mirac_ast_block_scope_s)
-	{
-		.blocks = mirac_ast_block_list_from_parts(arena),
-	};
+	return (mirac_ast_block_scope_s) {0};
 }
 
 static mirac_ast_block_if_s create_ast_block_if(
 	mirac_arena_s* const arena)
 {
 	mirac_debug_assert(arena != mirac_null);
-	return (mirac_ast_block_if_s) {0};
+
+	return (mirac_ast_block_if_s)
+	{
+		.next = mirac_ast_block_none
+	};
 }
 
 static mirac_ast_block_else_s create_ast_block_else(
@@ -519,13 +858,43 @@ static mirac_ast_block_asm_s create_ast_block_asm(
 	return (mirac_ast_block_asm_s) {0};
 }
 
-static mirac_ast_block_s* create_ast_block(
-	mirac_arena_s* const arena)
+static mirac_ast_block_t create_ast_block(
+	mirac_parser_s* const parser,
+	const mirac_position_s position)
 {
-	mirac_debug_assert(arena != mirac_null);
-	mirac_ast_block_s* const block = mirac_arena_malloc(arena, sizeof(mirac_ast_block_s));
-	*block = (mirac_ast_block_s) {0};
-	return block;
+	mirac_debug_assert(parser != mirac_null);
+	mirac_debug_assert(parser->arena != mirac_null);
+
+	const uint64_t block = parser->unit.block_types.count;
+
+	if (block >= mirac_ast_block_none)
+	{
+		mirac_logger_error("internal failure -- exceeded the maximum of %u blocks in a unit.", mirac_ast_block_none);
+		mirac_c_exit(-1);
+	}
+
+	const mirac_arena_site_e site = mirac_arena_set_site(parser->arena, mirac_arena_site_ast_blocks);
+	mirac_ast_block_type_list_push(&parser->unit.block_types, (uint8_t)mirac_ast_block_type_none);
+	mirac_ast_block_position_list_push(&parser->unit.block_positions, position);
+	mirac_ast_block_payload_list_push(&parser->unit.block_payloads, (mirac_ast_block_payload_s) {0});
+	(void)mirac_arena_set_site(parser->arena, site);
+	return (mirac_ast_block_t)block;
+}
+
+static mirac_ast_block_type_e get_block_type(
+	const mirac_parser_s* const parser,
+	const mirac_ast_block_t block)
+{
+	mirac_debug_assert(parser != mirac_null);
+	return mirac_ast_unit_get_block_type(&parser->unit, block);
+}
+
+static mirac_location_s get_block_location(
+	const mirac_parser_s* const parser,
+	const mirac_ast_block_t block)
+{
+	mirac_debug_assert(parser != mirac_null);
+	return mirac_file_table_get_location(mirac_ast_unit_get_block_position(&parser->unit, block));
 }
 
 static mirac_ast_def_fun_s create_ast_def_fun(
@@ -535,8 +904,8 @@ static mirac_ast_def_fun_s create_ast_def_fun(
 
 	return (mirac_ast_def_fun_s)
 	{
-		.req_tokens = mirac_token_list_from_parts(arena),
-		.ret_tokens = mirac_token_list_from_parts(arena),
+		.req_tokens = mirac_token_list_from_parts(arena, 0),
+		.ret_tokens = mirac_token_list_from_parts(arena, 0),
 	};
 }
 
@@ -558,7 +927,7 @@ static mirac_ast_def_s* create_ast_def(
 	mirac_arena_s* const arena)
 {
 	mirac_debug_assert(arena != mirac_null);
-	mirac_ast_def_s* const def = mirac_arena_malloc(arena, sizeof(mirac_ast_def_s));
+	mirac_ast_def_s* const def = mirac_arena_malloc_as(arena, sizeof(mirac_ast_def_s), mirac_arena_site_ast_defs);
 	*def = (mirac_ast_def_s) {0};
 	return def;
 }
@@ -605,21 +974,23 @@ static mirac_ast_block_expr_s parse_ast_block_expr(
 	mirac_debug_assert(parser != mirac_null);
 	mirac_debug_assert(parser->config != mirac_null);
 	mirac_debug_assert(parser->arena != mirac_null);
-	mirac_debug_assert(parser->lexer != mirac_null);
+	mirac_debug_assert(parser->preprocessor != mirac_null);
 
 	mirac_ast_block_expr_s expr_block = create_ast_block_expr(parser->arena);
 	mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
-	(void)mirac_lexer_lex_next(parser->lexer, &token);
+	(void)lex_next(parser, &token);
 
 	if (!is_token_valid_expr_block_token_by_type(token.type))
 	{
-		log_parser_error_and_exit(token.location,
+		log_parser_error_and_exit(mirac_token_get_location(&token),
 			"encountered an invalid 'expr' block token '" mirac_sv_fmt "'.",
-			mirac_sv_arg(token.text)
+			mirac_sv_arg(mirac_token_get_text(&token))
 		);
 	}
 
-	expr_block.token = token;
+	expr_block.token_type = token.type;
+	expr_block.length = token.length;
+	expr_block.as.uval = token.as.uval;
 	return expr_block;
 }
 
@@ -629,35 +1000,24 @@ static mirac_ast_block_ident_s parse_ast_block_ident(
 	mirac_debug_assert(parser != mirac_null);
 	mirac_debug_assert(parser->config != mirac_null);
 	mirac_debug_assert(parser->arena != mirac_null);
-	mirac_debug_assert(parser->lexer != mirac_null);
+	mirac_debug_assert(parser->preprocessor != mirac_null);
 
 	mirac_ast_block_ident_s ident_block = create_ast_block_ident(parser->arena);
 	mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
 
-	(void)mirac_lexer_lex_next(parser->lexer, &token);
+	(void)lex_next(parser, &token);
 	mirac_debug_assert(mirac_token_type_identifier == token.type);
 
-	for (const mirac_ast_def_list_node_s* defs_iterator = parser->unit.defs.begin; defs_iterator != mirac_null; defs_iterator = defs_iterator->next)
+	if (!resolve_def(parser, token.symbol, &ident_block.def))
 	{
-		mirac_debug_assert(defs_iterator != mirac_null);
-		mirac_debug_assert(defs_iterator->data != mirac_null);
-
-		const mirac_token_s existing_def_identifier_token = mirac_ast_def_get_identifier_token(defs_iterator->data);
-		if (mirac_string_view_equal(token.as.ident, existing_def_identifier_token.as.ident))
-		{
-			ident_block.def = defs_iterator->data;
-			ident_block.def->is_used = true;
-			goto found_matching_identifier;
-		}
+		log_parser_error_and_exit(mirac_token_get_location(&token),
+			"encountered an undefined identifier '" mirac_sv_fmt "' token.",
+			mirac_sv_arg(mirac_token_get_ident(&token))
+		);
 	}
 
-	log_parser_error_and_exit(token.location,
-		"encountered an undefined identifier '" mirac_sv_fmt "' token.",
-		mirac_sv_arg(token.as.ident)
-	);
-
-found_matching_identifier:
-	ident_block.token = token;
+	mirac_debug_assert(ident_block.def != mirac_null);
+	ident_block.def->is_used = true;
 	return ident_block;
 }
 
@@ -667,30 +1027,29 @@ static mirac_ast_block_call_s parse_ast_block_call(
 	mirac_debug_assert(parser != mirac_null);
 	mirac_debug_assert(parser->config != mirac_null);
 	mirac_debug_assert(parser->arena != mirac_null);
-	mirac_debug_assert(parser->lexer != mirac_null);
+	mirac_debug_assert(parser->preprocessor != mirac_null);
 
 	mirac_ast_block_call_s call_block = create_ast_block_call(parser->arena);
 	mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
-	mirac_ast_block_s* block = mirac_null;
+	mirac_ast_block_t block = mirac_ast_block_none;
 
-	(void)mirac_lexer_lex_next(parser->lexer, &token);
+	(void)lex_next(parser, &token);
 	mirac_debug_assert(mirac_token_type_reserved_call == token.type);
 
-	if ((block = parse_ast_block(parser))->type != mirac_ast_block_type_ident)
+	if (get_block_type(parser, block = parse_ast_block(parser)) != mirac_ast_block_type_ident)
 	{
-		mirac_debug_assert(block != mirac_null);
-		log_parser_error_and_exit(block->location,
+		log_parser_error_and_exit(get_block_location(parser, block),
 			"expected 'ident' block after 'call' block, but found '" mirac_sv_fmt "' block.",
-			mirac_sv_arg(mirac_ast_block_type_to_string_view(block->type))
+			mirac_sv_arg(mirac_ast_block_type_to_string_view(get_block_type(parser, block)))
 		);
 	}
 
-	const mirac_ast_block_ident_s* const ident_block = &block->as.ident_block;
+	const mirac_ast_block_ident_s* const ident_block = &mirac_ast_unit_get_block_payload(&parser->unit, block)->as.ident_block;
 	mirac_debug_assert(ident_block != mirac_null);
 
 	if (ident_block->def->type != mirac_ast_def_type_fun)
 	{
-		log_parser_error_and_exit(block->location,
+		log_parser_error_and_exit(get_block_location(parser, block),
 			"expected 'fun' def identifier after 'call' block, but found '" mirac_sv_fmt "' def identifier.",
 			mirac_sv_arg(mirac_ast_def_type_to_string_view(ident_block->def->type))
 		);
@@ -706,28 +1065,30 @@ static mirac_ast_block_as_s parse_ast_block_as(
 	mirac_debug_assert(parser != mirac_null);
 	mirac_debug_assert(parser->config != mirac_null);
 	mirac_debug_assert(parser->arena != mirac_null);
-	mirac_debug_assert(parser->lexer != mirac_null);
+	mirac_debug_assert(parser->preprocessor != mirac_null);
 
 	mirac_ast_block_as_s as_block = create_ast_block_as(parser->arena);
 	mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
 
-	(void)mirac_lexer_lex_next(parser->lexer, &token);
+	(void)lex_next(parser, &token);
 	mirac_debug_assert(mirac_token_type_reserved_as == token.type);
+	as_block.type_tokens.begin = (uint32_t)parser->unit.type_tokens.count;
 
-	while (!mirac_lexer_should_stop_lexing(mirac_lexer_lex_next(parser->lexer, &token)))
+	while (!mirac_lexer_should_stop_lexing(lex_next(parser, &token)))
 	{
 		if (!mirac_token_is_type_token(&token))
 		{
-			mirac_lexer_unlex(parser->lexer, &token);
+			unlex(parser, &token);
 			break;
 		}
 
-		mirac_token_list_push(&as_block.type_tokens, token);
+		mirac_token_list_push(&parser->unit.type_tokens, token);
+		++as_block.type_tokens.count;
 	}
 
 	if (as_block.type_tokens.count <= 0)
 	{
-		log_parser_error_and_exit(token.location,
+		log_parser_error_and_exit(mirac_token_get_location(&token),
 			"no type specifiers were provided after 'as' token."
 		);
 	}
@@ -741,13 +1102,13 @@ static mirac_ast_block_scope_s parse_ast_block_scope(
 	mirac_debug_assert(parser != mirac_null);
 	mirac_debug_assert(parser->config != mirac_null);
 	mirac_debug_assert(parser->arena != mirac_null);
-	mirac_debug_assert(parser->lexer != mirac_null);
+	mirac_debug_assert(parser->preprocessor != mirac_null);
 
 	mirac_ast_block_scope_s scope_block = create_ast_block_scope(parser->arena);
 	mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
-	mirac_ast_block_s* block = mirac_null;
+	mirac_ast_block_t block = mirac_ast_block_none;
 
-	(void)mirac_lexer_lex_next(parser->lexer, &token);
+	(void)lex_next(parser, &token);
 	mirac_debug_assert((mirac_token_type_reserved_left_parenthesis == token.type) ||
 					   (mirac_token_type_reserved_left_bracket     == token.type) ||
 					   (mirac_token_type_reserved_left_brace       == token.type));
@@ -782,72 +1143,85 @@ static mirac_ast_block_scope_s parse_ast_block_scope(
 
 	mirac_debug_assert(scope_end_token_type != mirac_token_type_none);
 
+	// note: the children are gathered on the parser's stack of pending ones (the
+	//       nested scopes push and pop theirs above them), and then moved to the
+	//       unit, so that they form a single span of its children.
+	const uint64_t pending_begin = parser->pending_children.count;
+
 	while (1)
 	{
-		(void)mirac_lexer_lex_next(parser->lexer, &token);
-		if (scope_end_token_type == token.type) { break; }
-		mirac_lexer_unlex(parser->lexer, &token);
+		if (scope_end_token_type == peek_token(parser, 0).type)
+		{
+			(void)lex_next(parser, &token);
+			break;
+		}
 
 		block = parse_ast_block(parser);
-		mirac_debug_assert(block != mirac_null);
 
-		if ((mirac_ast_block_type_eou  == block->type) ||
-			(mirac_ast_block_type_none == block->type))
+		if ((mirac_ast_block_type_eou  == get_block_type(parser, block)) ||
+			(mirac_ast_block_type_none == get_block_type(parser, block)))
 		{
-			log_parser_error_and_exit(block->location,
+			log_parser_error_and_exit(get_block_location(parser, block),
 				"expected scope closing '" mirac_sv_fmt "' token, but found '" mirac_sv_fmt "' block.",
 				mirac_sv_arg(mirac_token_type_to_string_view(scope_end_token_type)),
-				mirac_sv_arg(mirac_ast_block_type_to_string_view(block->type))
+				mirac_sv_arg(mirac_ast_block_type_to_string_view(get_block_type(parser, block)))
 			);
 		}
 
-		mirac_ast_block_list_push(&scope_block.blocks, block);
+		mirac_ast_block_list_push(&parser->pending_children, block);
 	}
 
-	mirac_ast_block_s* block_ref = mirac_null;
-	mirac_ast_block_s* prev_block_ref = mirac_null;
+	mirac_ast_block_t block_ref = mirac_ast_block_none;
+	mirac_ast_block_t prev_block_ref = mirac_ast_block_none;
 
-	for (mirac_ast_block_list_node_s* blocks_iterator = scope_block.blocks.begin; blocks_iterator != mirac_null; blocks_iterator = blocks_iterator->next)
+	for (uint64_t block_index = pending_begin; block_index < parser->pending_children.count; ++block_index)
 	{
-		mirac_debug_assert(blocks_iterator != mirac_null);
-		mirac_debug_assert(blocks_iterator->data != mirac_null);
-
 		prev_block_ref = block_ref;
-		block_ref = blocks_iterator->data;
-		mirac_debug_assert(block_ref != mirac_null);
+		block_ref = parser->pending_children.data[block_index];
 
-		if (mirac_ast_block_type_else == block_ref->type)
+		if (mirac_ast_block_type_else == get_block_type(parser, block_ref))
 		{
-			if (mirac_null == prev_block_ref)
+			if (mirac_ast_block_none == prev_block_ref)
 			{
-				log_parser_error_and_exit(block_ref->location,
+				log_parser_error_and_exit(get_block_location(parser, block_ref),
 					"missing 'if' block prior to '" mirac_sv_fmt "' block.",
-					mirac_sv_arg(mirac_ast_block_type_to_string_view(block_ref->type))
+					mirac_sv_arg(mirac_ast_block_type_to_string_view(get_block_type(parser, block_ref)))
 				);
 			}
 			else
 			{
-				if (prev_block_ref->type != mirac_ast_block_type_if)
+				if (get_block_type(parser, prev_block_ref) != mirac_ast_block_type_if)
 				{
-					log_parser_error_and_exit(block_ref->location,
+					log_parser_error_and_exit(get_block_location(parser, block_ref),
 						"expected 'if' block prior to '" mirac_sv_fmt "' block, but found '" mirac_sv_fmt"' block.",
-						mirac_sv_arg(mirac_ast_block_type_to_string_view(block_ref->type)),
-						mirac_sv_arg(mirac_ast_block_type_to_string_view(prev_block_ref->type))
+						mirac_sv_arg(mirac_ast_block_type_to_string_view(get_block_type(parser, block_ref))),
+						mirac_sv_arg(mirac_ast_block_type_to_string_view(get_block_type(parser, prev_block_ref)))
 					);
 				}
 			}
 		}
 
-		if ((prev_block_ref != mirac_null) && (block_ref != mirac_null))
+		if (prev_block_ref != mirac_ast_block_none)
 		{
-			if ((mirac_ast_block_type_if == prev_block_ref->type) &&
-				(mirac_ast_block_type_else == block_ref->type))
+			if ((mirac_ast_block_type_if == get_block_type(parser, prev_block_ref)) &&
+				(mirac_ast_block_type_else == get_block_type(parser, block_ref)))
 			{
-				prev_block_ref->as.if_block.next = block_ref;
+				parser->unit.block_payloads.data[prev_block_ref].as.if_block.next = block_ref;
 			}
 		}
 	}
 
+	const mirac_arena_site_e site = mirac_arena_set_site(parser->arena, mirac_arena_site_ast_blocks);
+	scope_block.blocks.begin = (uint32_t)parser->unit.children.count;
+	scope_block.blocks.count = (uint32_t)(parser->pending_children.count - pending_begin);
+
+	for (uint64_t block_index = pending_begin; block_index < parser->pending_children.count; ++block_index)
+	{
+		mirac_ast_block_list_push(&parser->unit.children, parser->pending_children.data[block_index]);
+	}
+
+	(void)mirac_arena_set_site(parser->arena, site);
+	parser->pending_children.count = pending_begin;
 	return scope_block;
 }
 
@@ -857,38 +1231,36 @@ static mirac_ast_block_if_s parse_ast_block_if(
 	mirac_debug_assert(parser != mirac_null);
 	mirac_debug_assert(parser->config != mirac_null);
 	mirac_debug_assert(parser->arena != mirac_null);
-	mirac_debug_assert(parser->lexer != mirac_null);
+	mirac_debug_assert(parser->preprocessor != mirac_null);
 
 	mirac_ast_block_if_s if_block = create_ast_block_if(parser->arena);
 	mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
-	mirac_ast_block_s* block = mirac_null;
+	mirac_ast_block_t block = mirac_ast_block_none;
 
-	(void)mirac_lexer_lex_next(parser->lexer, &token);
+	(void)lex_next(parser, &token);
 	mirac_debug_assert(mirac_token_type_reserved_if == token.type);
 
-	if ((block = parse_ast_block(parser))->type != mirac_ast_block_type_scope)
+	if (get_block_type(parser, block = parse_ast_block(parser)) != mirac_ast_block_type_scope)
 	{
-		mirac_debug_assert(block != mirac_null);
-		log_parser_error_and_exit(block->location,
+		log_parser_error_and_exit(get_block_location(parser, block),
 			"expected 'scope' block as 'if' block's condition, but found '" mirac_sv_fmt "' block.",
-			mirac_sv_arg(mirac_ast_block_type_to_string_view(block->type))
+			mirac_sv_arg(mirac_ast_block_type_to_string_view(get_block_type(parser, block)))
 		);
 	}
 
 	if_block.cond = block;
 
-	if ((block = parse_ast_block(parser))->type != mirac_ast_block_type_scope)
+	if (get_block_type(parser, block = parse_ast_block(parser)) != mirac_ast_block_type_scope)
 	{
-		mirac_debug_assert(block != mirac_null);
-		log_parser_error_and_exit(block->location,
+		log_parser_error_and_exit(get_block_location(parser, block),
 			"expected 'scope' block as 'if' block's body, but found '" mirac_sv_fmt "' block.",
-			mirac_sv_arg(mirac_ast_block_type_to_string_view(block->type))
+			mirac_sv_arg(mirac_ast_block_type_to_string_view(get_block_type(parser, block)))
 		);
 	}
 
 	if_block.body = block;
 
-	if_block.index = parser->stats.if_count++;
+	if_block.index = (uint32_t)parser->stats.if_count++;
 	return if_block;
 }
 
@@ -898,27 +1270,26 @@ static mirac_ast_block_else_s parse_ast_block_else(
 	mirac_debug_assert(parser != mirac_null);
 	mirac_debug_assert(parser->config != mirac_null);
 	mirac_debug_assert(parser->arena != mirac_null);
-	mirac_debug_assert(parser->lexer != mirac_null);
+	mirac_debug_assert(parser->preprocessor != mirac_null);
 
 	mirac_ast_block_else_s else_block = create_ast_block_else(parser->arena);
 	mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
-	mirac_ast_block_s* block = mirac_null;
+	mirac_ast_block_t block = mirac_ast_block_none;
 
-	(void)mirac_lexer_lex_next(parser->lexer, &token);
+	(void)lex_next(parser, &token);
 	mirac_debug_assert(mirac_token_type_reserved_else == token.type);
 
-	if ((block = parse_ast_block(parser))->type != mirac_ast_block_type_scope)
+	if (get_block_type(parser, block = parse_ast_block(parser)) != mirac_ast_block_type_scope)
 	{
-		mirac_debug_assert(block != mirac_null);
-		log_parser_error_and_exit(block->location,
+		log_parser_error_and_exit(get_block_location(parser, block),
 			"expected 'scope' block as 'else' block's body, but found '" mirac_sv_fmt "' block.",
-			mirac_sv_arg(mirac_ast_block_type_to_string_view(block->type))
+			mirac_sv_arg(mirac_ast_block_type_to_string_view(get_block_type(parser, block)))
 		);
 	}
 
 	else_block.body = block;
 
-	else_block.index = parser->stats.else_count++;
+	else_block.index = (uint32_t)parser->stats.else_count++;
 	return else_block;
 }
 
@@ -928,38 +1299,36 @@ static mirac_ast_block_loop_s parse_ast_block_loop(
 	mirac_debug_assert(parser != mirac_null);
 	mirac_debug_assert(parser->config != mirac_null);
 	mirac_debug_assert(parser->arena != mirac_null);
-	mirac_debug_assert(parser->lexer != mirac_null);
+	mirac_debug_assert(parser->preprocessor != mirac_null);
 
 	mirac_ast_block_loop_s loop_block = create_ast_block_loop(parser->arena);
 	mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
-	mirac_ast_block_s* block = mirac_null;
+	mirac_ast_block_t block = mirac_ast_block_none;
 
-	(void)mirac_lexer_lex_next(parser->lexer, &token);
+	(void)lex_next(parser, &token);
 	mirac_debug_assert(mirac_token_type_reserved_loop == token.type);
 
-	if ((block = parse_ast_block(parser))->type != mirac_ast_block_type_scope)
+	if (get_block_type(parser, block = parse_ast_block(parser)) != mirac_ast_block_type_scope)
 	{
-		mirac_debug_assert(block != mirac_null);
-		log_parser_error_and_exit(block->location,
+		log_parser_error_and_exit(get_block_location(parser, block),
 			"expected 'scope' block as 'loop' block's condition, but found '" mirac_sv_fmt "' block.",
-			mirac_sv_arg(mirac_ast_block_type_to_string_view(block->type))
+			mirac_sv_arg(mirac_ast_block_type_to_string_view(get_block_type(parser, block)))
 		);
 	}
 
 	loop_block.cond = block;
 
-	if ((block = parse_ast_block(parser))->type != mirac_ast_block_type_scope)
+	if (get_block_type(parser, block = parse_ast_block(parser)) != mirac_ast_block_type_scope)
 	{
-		mirac_debug_assert(block != mirac_null);
-		log_parser_error_and_exit(block->location,
+		log_parser_error_and_exit(get_block_location(parser, block),
 			"expected 'scope' block as 'loop' block's body, but found '" mirac_sv_fmt "' block.",
-			mirac_sv_arg(mirac_ast_block_type_to_string_view(block->type))
+			mirac_sv_arg(mirac_ast_block_type_to_string_view(get_block_type(parser, block)))
 		);
 	}
 
 	loop_block.body = block;
 
-	loop_block.index = parser->stats.loop_count++;
+	loop_block.index = (uint32_t)parser->stats.loop_count++;
 	return loop_block;
 }
 
@@ -969,115 +1338,121 @@ static mirac_ast_block_asm_s parse_ast_block_asm(
 	mirac_debug_assert(parser != mirac_null);
 	mirac_debug_assert(parser->config != mirac_null);
 	mirac_debug_assert(parser->arena != mirac_null);
-	mirac_debug_assert(parser->lexer != mirac_null);
+	mirac_debug_assert(parser->preprocessor != mirac_null);
 
 	mirac_ast_block_asm_s asm_block = create_ast_block_asm(parser->arena);
 	mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
-	mirac_ast_block_s* block = mirac_null;
 
-	(void)mirac_lexer_lex_next(parser->lexer, &token);
+	(void)lex_next(parser, &token);
 	mirac_debug_assert(mirac_token_type_reserved_asm == token.type);
 
-	if (mirac_lexer_lex_next(parser->lexer, &token) != mirac_token_type_literal_str)
+	if (lex_next(parser, &token) != mirac_token_type_literal_str)
 	{
-		log_parser_error_and_exit(block->location,
+		log_parser_error_and_exit(mirac_token_get_location(&token),
 			"expected asm instruction as a string literal after 'asm' token, but found '" mirac_sv_fmt "' token.",
 			mirac_sv_arg(mirac_token_type_to_string_view(token.type))
 		);
 	}
 
-	asm_block.inst = token;
+	asm_block.inst = token.as.str;
+	asm_block.inst_length = token.str_length;
+	asm_block.length = token.length;
 	return asm_block;
 }
 
-static mirac_ast_block_s* parse_ast_block(
+static mirac_ast_block_t parse_ast_block(
 	mirac_parser_s* const parser)
 {
 	mirac_debug_assert(parser != mirac_null);
 	mirac_debug_assert(parser->config != mirac_null);
 	mirac_debug_assert(parser->arena != mirac_null);
-	mirac_debug_assert(parser->lexer != mirac_null);
+	mirac_debug_assert(parser->preprocessor != mirac_null);
 
-	mirac_ast_block_s* const block = create_ast_block(parser->arena);
 	mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
+	(void)lex_next(parser, &token);
 
-	(void)mirac_lexer_lex_next(parser->lexer, &token);
-	block->location = token.location;
+	// note: the block is added before its children, and its payload is only set
+	//       once they are parsed (adding them may move the unit's arrays).
+	const mirac_ast_block_t block = create_ast_block(parser, mirac_token_get_position(&token));
+	mirac_ast_block_type_e type = mirac_ast_block_type_none;
+	mirac_ast_block_payload_s payload = {0};
 
 	if (!mirac_lexer_should_stop_lexing(token.type))
 	{
-		mirac_lexer_unlex(parser->lexer, &token);
+		unlex(parser, &token);
 	}
 
 	switch (token.type)
 	{
 		case mirac_token_type_identifier:
 		{
-			block->type = mirac_ast_block_type_ident;
-			block->as.ident_block = parse_ast_block_ident(parser);
+			type = mirac_ast_block_type_ident;
+			payload.as.ident_block = parse_ast_block_ident(parser);
 		} break;
 
 		case mirac_token_type_reserved_call:
 		{
-			block->type = mirac_ast_block_type_call;
-			block->as.call_block = parse_ast_block_call(parser);
+			type = mirac_ast_block_type_call;
+			payload.as.call_block = parse_ast_block_call(parser);
 		} break;
 
 		case mirac_token_type_reserved_as:
 		{
-			block->type = mirac_ast_block_type_as;
-			block->as.as_block = parse_ast_block_as(parser);
+			type = mirac_ast_block_type_as;
+			payload.as.as_block = parse_ast_block_as(parser);
 		} break;
 
 		case mirac_token_type_reserved_left_parenthesis:
 		case mirac_token_type_reserved_left_bracket:
 		case mirac_token_type_reserved_left_brace:
 		{
-			block->type = mirac_ast_block_type_scope;
-			block->as.scope_block = parse_ast_block_scope(parser);
+			type = mirac_ast_block_type_scope;
+			payload.as.scope_block = parse_ast_block_scope(parser);
 		} break;
 
 		case mirac_token_type_reserved_if:
 		{
-			block->type = mirac_ast_block_type_if;
-			block->as.if_block = parse_ast_block_if(parser);
+			type = mirac_ast_block_type_if;
+			payload.as.if_block = parse_ast_block_if(parser);
 		} break;
 
 		case mirac_token_type_reserved_else:
 		{
-			block->type = mirac_ast_block_type_else;
-			block->as.else_block = parse_ast_block_else(parser);
+			type = mirac_ast_block_type_else;
+			payload.as.else_block = parse_ast_block_else(parser);
 		} break;
 
 		case mirac_token_type_reserved_loop:
 		{
-			block->type = mirac_ast_block_type_loop;
-			block->as.loop_block = parse_ast_block_loop(parser);
+			type = mirac_ast_block_type_loop;
+			payload.as.loop_block = parse_ast_block_loop(parser);
 		} break;
 
 		case mirac_token_type_reserved_asm:
 		{
-			block->type = mirac_ast_block_type_asm;
-			block->as.asm_block = parse_ast_block_asm(parser);
+			type = mirac_ast_block_type_asm;
+			payload.as.asm_block = parse_ast_block_asm(parser);
 		} break;
 
 		case mirac_token_type_eof:
 		{
-			block->type = mirac_ast_block_type_eou;
+			type = mirac_ast_block_type_eou;
 		} break;
 
 		case mirac_token_type_none:
 		{
-			block->type = mirac_ast_block_type_none;
+			type = mirac_ast_block_type_none;
 		} break;
 
 		default:
 		{
-			block->type = mirac_ast_block_type_expr;
-			block->as.expr_block = parse_ast_block_expr(parser);
+			type = mirac_ast_block_type_expr;
+			payload.as.expr_block = parse_ast_block_expr(parser);
 		} break;
 	}
 
+	parser->unit.block_types.data[block] = (uint8_t)type;
+	parser->unit.block_payloads.data[block] = payload;
 	return block;
 }
 
@@ -1087,27 +1462,27 @@ static mirac_ast_def_fun_s parse_ast_def_fun(
 	mirac_debug_assert(parser != mirac_null);
 	mirac_debug_assert(parser->config != mirac_null);
 	mirac_debug_assert(parser->arena != mirac_null);
-	mirac_debug_assert(parser->lexer != mirac_null);
+	mirac_debug_assert(parser->preprocessor != mirac_null);
 
 	mirac_ast_def_fun_s fun_def = create_ast_def_fun(parser->arena);
 	mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
 
-	if (mirac_lexer_lex_next(parser->lexer, &token) != mirac_token_type_identifier)
+	if (lex_next(parser, &token) != mirac_token_type_identifier)
 	{
-		log_parser_error_and_exit(token.location,
+		log_parser_error_and_exit(mirac_token_get_location(&token),
 			"expected identifier token after 'fun' token, but found '" mirac_sv_fmt "' token.",
-			mirac_sv_arg(token.text)
+			mirac_sv_arg(mirac_token_get_text(&token))
 		);
 	}
 
 	fun_def.identifier = token;
-	fun_def.is_entry = mirac_string_view_equal(fun_def.identifier.as.ident, parser->config->entry);
+	fun_def.is_entry = (fun_def.identifier.symbol == parser->entry_symbol);
 
-	(void)mirac_lexer_lex_next(parser->lexer, &token);
+	(void)lex_next(parser, &token);
 
 	if (mirac_token_type_reserved_req == token.type)
 	{
-		while (!mirac_lexer_should_stop_lexing(mirac_lexer_lex_next(parser->lexer, &token)))
+		while (!mirac_lexer_should_stop_lexing(lex_next(parser, &token)))
 		{
 			if (!mirac_token_is_type_token(&token))
 			{
@@ -1119,7 +1494,7 @@ static mirac_ast_def_fun_s parse_ast_def_fun(
 
 		if (fun_def.req_tokens.count <= 0)
 		{
-			log_parser_error_and_exit(token.location,
+			log_parser_error_and_exit(mirac_token_get_location(&token),
 				"no type specifiers were provided after 'req' token."
 			);
 		}
@@ -1127,7 +1502,7 @@ static mirac_ast_def_fun_s parse_ast_def_fun(
 
 	if (mirac_token_type_reserved_ret == token.type)
 	{
-		while (!mirac_lexer_should_stop_lexing(mirac_lexer_lex_next(parser->lexer, &token)))
+		while (!mirac_lexer_should_stop_lexing(lex_next(parser, &token)))
 		{
 			if (!mirac_token_is_type_token(&token))
 			{
@@ -1139,21 +1514,20 @@ static mirac_ast_def_fun_s parse_ast_def_fun(
 
 		if (fun_def.ret_tokens.count <= 0)
 		{
-			log_parser_error_and_exit(token.location,
+			log_parser_error_and_exit(mirac_token_get_location(&token),
 				"no type specifiers were provided after 'ret' token."
 			);
 		}
 	}
 
-	mirac_lexer_unlex(parser->lexer, &token);
-	mirac_ast_block_s* block = mirac_null;
+	unlex(parser, &token);
+	mirac_ast_block_t block = mirac_ast_block_none;
 
-	if ((block = parse_ast_block(parser))->type != mirac_ast_block_type_scope)
+	if (get_block_type(parser, block = parse_ast_block(parser)) != mirac_ast_block_type_scope)
 	{
-		mirac_debug_assert(block != mirac_null);
-		log_parser_error_and_exit(block->location,
+		log_parser_error_and_exit(get_block_location(parser, block),
 			"expected 'scope' block as 'fun' block's body, but found '" mirac_sv_fmt "' block.",
-			mirac_sv_arg(mirac_ast_block_type_to_string_view(block->type))
+			mirac_sv_arg(mirac_ast_block_type_to_string_view(get_block_type(parser, block)))
 		);
 	}
 
@@ -1168,35 +1542,35 @@ static mirac_ast_def_mem_s parse_ast_def_mem(
 	mirac_debug_assert(parser != mirac_null);
 	mirac_debug_assert(parser->config != mirac_null);
 	mirac_debug_assert(parser->arena != mirac_null);
-	mirac_debug_assert(parser->lexer != mirac_null);
+	mirac_debug_assert(parser->preprocessor != mirac_null);
 
 	mirac_ast_def_mem_s mem_def = create_ast_def_mem(parser->arena);
 	mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
 
-	if (mirac_lexer_lex_next(parser->lexer, &token) != mirac_token_type_identifier)
+	if (lex_next(parser, &token) != mirac_token_type_identifier)
 	{
-		log_parser_error_and_exit(token.location,
+		log_parser_error_and_exit(mirac_token_get_location(&token),
 			"expected identifier token after 'mem' token, but found '" mirac_sv_fmt "' token.",
-			mirac_sv_arg(token.text)
+			mirac_sv_arg(mirac_token_get_text(&token))
 		);
 	}
 
 	mem_def.identifier = token;
-	(void)mirac_lexer_lex_next(parser->lexer, &token);
+	(void)lex_next(parser, &token);
 
 	if (!mirac_token_is_unsigned_numeric_literal(&token))
 	{
-		log_parser_error_and_exit(token.location,
+		log_parser_error_and_exit(mirac_token_get_location(&token),
 			"expected capacity token after 'mem' identifier token to be unsigned integer literal token, but found '" mirac_sv_fmt "' token.",
-			mirac_sv_arg(token.text)
+			mirac_sv_arg(mirac_token_get_text(&token))
 		);
 	}
 
 	if (token.as.uval <= 0)
 	{
-		log_parser_error_and_exit(token.location,
+		log_parser_error_and_exit(mirac_token_get_location(&token),
 			"provided capacity token '" mirac_sv_fmt "' must be a positive integer value.",
-			mirac_sv_arg(token.text)
+			mirac_sv_arg(mirac_token_get_text(&token))
 		);
 	}
 
@@ -1211,26 +1585,26 @@ static mirac_ast_def_str_s parse_ast_def_str(
 	mirac_debug_assert(parser != mirac_null);
 	mirac_debug_assert(parser->config != mirac_null);
 	mirac_debug_assert(parser->arena != mirac_null);
-	mirac_debug_assert(parser->lexer != mirac_null);
+	mirac_debug_assert(parser->preprocessor != mirac_null);
 
 	mirac_ast_def_str_s str_def = create_ast_def_str(parser->arena);
 	mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
 
-	if (mirac_lexer_lex_next(parser->lexer, &token) != mirac_token_type_identifier)
+	if (lex_next(parser, &token) != mirac_token_type_identifier)
 	{
-		log_parser_error_and_exit(token.location,
+		log_parser_error_and_exit(mirac_token_get_location(&token),
 			"expected identifier token after 'str' token, but found '" mirac_sv_fmt "' token.",
-			mirac_sv_arg(token.text)
+			mirac_sv_arg(mirac_token_get_text(&token))
 		);
 	}
 
 	str_def.identifier = token;
 
-	if (mirac_lexer_lex_next(parser->lexer, &token) != mirac_token_type_literal_str)
+	if (lex_next(parser, &token) != mirac_token_type_literal_str)
 	{
-		log_parser_error_and_exit(token.location,
+		log_parser_error_and_exit(mirac_token_get_location(&token),
 			"expected 'str literal' token after 'str' identifier token, but found '" mirac_sv_fmt "' token.",
-			mirac_sv_arg(token.text)
+			mirac_sv_arg(mirac_token_get_text(&token))
 		);
 	}
 
@@ -1245,40 +1619,40 @@ static mirac_ast_def_s* parse_ast_def(
 	mirac_debug_assert(parser != mirac_null);
 	mirac_debug_assert(parser->config != mirac_null);
 	mirac_debug_assert(parser->arena != mirac_null);
-	mirac_debug_assert(parser->lexer != mirac_null);
+	mirac_debug_assert(parser->preprocessor != mirac_null);
 
 	mirac_ast_def_s* const def = create_ast_def(parser->arena);
 	mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
 
-	(void)mirac_lexer_lex_next(parser->lexer, &token);
+	(void)lex_next(parser, &token);
 	if (mirac_lexer_should_stop_lexing(token.type))
 	{ goto parse_def_by_token; }
 
 	if (token.type != mirac_token_type_reserved_sec)
 	{
-		log_parser_error_and_exit(token.location,
+		log_parser_error_and_exit(mirac_token_get_location(&token),
 			"expected 'sec' token, but found '" mirac_sv_fmt "' token.",
-			mirac_sv_arg(token.text)
+			mirac_sv_arg(mirac_token_get_text(&token))
 		);
 	}
 
-	def->location = token.location;
+	def->position = mirac_token_get_position(&token);
 
-	(void)mirac_lexer_lex_next(parser->lexer, &token);
+	(void)lex_next(parser, &token);
 	if (mirac_lexer_should_stop_lexing(token.type))
 	{ goto parse_def_by_token; }
 
 	if (token.type != mirac_token_type_identifier)
 	{
-		log_parser_error_and_exit(token.location,
+		log_parser_error_and_exit(mirac_token_get_location(&token),
 			"expected 'identifier' token after 'sec' token, but found '" mirac_sv_fmt "' token.",
-			mirac_sv_arg(token.text)
+			mirac_sv_arg(mirac_token_get_text(&token))
 		);
 	}
 
 	def->section = token;
 
-	(void)mirac_lexer_lex_next(parser->lexer, &token);
+	(void)lex_next(parser, &token);
 
 parse_def_by_token:
 	switch (token.type)
@@ -1311,9 +1685,9 @@ parse_def_by_token:
 
 		default:
 		{
-			log_parser_error_and_exit(token.location,
+			log_parser_error_and_exit(mirac_token_get_location(&token),
 				"expected 'fun', 'mem', or 'str' token after 'sec' definition, but found '" mirac_sv_fmt "' token",
-				mirac_sv_arg(token.text)
+				mirac_sv_arg(mirac_token_get_text(&token))
 			);
 		} break;
 	}
@@ -1325,15 +1699,15 @@ parse_def_by_token:
 
 static void print_ast_block_expr(
 	mirac_file_t* const file,
-	const mirac_ast_block_s* const block,
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block,
 	const uint64_t indent)
 {
 	mirac_debug_assert(file != mirac_null);
-	mirac_debug_assert(block != mirac_null);
-	mirac_debug_assert(mirac_ast_block_type_expr == block->type);
+	mirac_debug_assert(unit != mirac_null);
+	mirac_debug_assert(mirac_ast_block_type_expr == mirac_ast_unit_get_block_type(unit, block));
 
-	const mirac_ast_block_expr_s* const expr_block = &block->as.expr_block;
-	mirac_debug_assert(expr_block != mirac_null);
+	const mirac_token_s token = mirac_ast_unit_get_block_token(unit, block);
 
 	for (uint64_t indent_index = 0; indent_index < indent; ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "ExprBlock[\n");
@@ -1341,7 +1715,7 @@ static void print_ast_block_expr(
 	for (uint64_t indent_index = 0; indent_index < (indent + 1); ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "token:\n");
 	for (uint64_t indent_index = 0; indent_index < (indent + 2); ++indent_index) (void)fprintf(file, "\t");
-	(void)fprintf(file, mirac_sv_fmt "\n", mirac_sv_arg(mirac_token_to_string_view(&expr_block->token)));
+	(void)fprintf(file, mirac_sv_fmt "\n", mirac_sv_arg(mirac_token_to_string_view(&token)));
 
 	for (uint64_t indent_index = 0; indent_index < indent; ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "]\n");
@@ -1349,16 +1723,18 @@ static void print_ast_block_expr(
 
 static void print_ast_block_ident(
 	mirac_file_t* const file,
-	const mirac_ast_block_s* const block,
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block,
 	const uint64_t indent)
 {
 	mirac_debug_assert(file != mirac_null);
-	mirac_debug_assert(block != mirac_null);
-	mirac_debug_assert(mirac_ast_block_type_ident == block->type);
+	mirac_debug_assert(unit != mirac_null);
+	mirac_debug_assert(mirac_ast_block_type_ident == mirac_ast_unit_get_block_type(unit, block));
 
-	const mirac_ast_block_ident_s* const ident_block = &block->as.ident_block;
+	const mirac_ast_block_ident_s* const ident_block = &mirac_ast_unit_get_block_payload(unit, block)->as.ident_block;
 	mirac_debug_assert(ident_block != mirac_null);
 	mirac_debug_assert(ident_block->def != mirac_null);
+	const mirac_token_s token = mirac_ast_unit_get_block_token(unit, block);
 
 	for (uint64_t indent_index = 0; indent_index < indent; ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "IdentBlock[\n");
@@ -1366,12 +1742,13 @@ static void print_ast_block_ident(
 	for (uint64_t indent_index = 0; indent_index < (indent + 1); ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "token:\n");
 	for (uint64_t indent_index = 0; indent_index < (indent + 2); ++indent_index) (void)fprintf(file, "\t");
-	(void)fprintf(file, mirac_sv_fmt "\n", mirac_sv_arg(mirac_token_to_string_view(&ident_block->token)));
+	(void)fprintf(file, mirac_sv_fmt "\n", mirac_sv_arg(mirac_token_to_string_view(&token)));
 
 	for (uint64_t indent_index = 0; indent_index < (indent + 1); ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "def:\n");
+	const mirac_token_s identifier = mirac_ast_def_get_identifier_token(ident_block->def);
 	for (uint64_t indent_index = 0; indent_index < (indent + 2); ++indent_index) (void)fprintf(file, "\t");
-	(void)fprintf(file, mirac_sv_fmt "\n", mirac_sv_arg(mirac_ast_def_get_identifier_token(ident_block->def).text));
+	(void)fprintf(file, mirac_sv_fmt "\n", mirac_sv_arg(mirac_token_get_text(&identifier)));
 
 	for (uint64_t indent_index = 0; indent_index < indent; ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "]\n");
@@ -1379,25 +1756,22 @@ static void print_ast_block_ident(
 
 static void print_ast_block_call(
 	mirac_file_t* const file,
-	const mirac_ast_block_s* const block,
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block,
 	const uint64_t indent)
 {
 	mirac_debug_assert(file != mirac_null);
-	mirac_debug_assert(block != mirac_null);
-	mirac_debug_assert(mirac_ast_block_type_call == block->type);
+	mirac_debug_assert(unit != mirac_null);
+	mirac_debug_assert(mirac_ast_block_type_call == mirac_ast_unit_get_block_type(unit, block));
 
-	const mirac_ast_block_call_s* const call_block = &block->as.call_block;
+	const mirac_ast_block_call_s* const call_block = &mirac_ast_unit_get_block_payload(unit, block)->as.call_block;
 	mirac_debug_assert(call_block != mirac_null);
-	mirac_debug_assert(mirac_ast_block_type_ident == call_block->ident->type);
-
-	const mirac_ast_block_s* const ident_block = call_block->ident;
-	mirac_debug_assert(ident_block != mirac_null);
-	mirac_debug_assert(mirac_ast_block_type_ident == ident_block->type);
+	mirac_debug_assert(mirac_ast_block_type_ident == mirac_ast_unit_get_block_type(unit, call_block->ident));
 
 	for (uint64_t indent_index = 0; indent_index < indent; ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "CallBlock[\n");
 
-	print_ast_block_ident(file, ident_block, indent + 1);
+	print_ast_block_ident(file, unit, call_block->ident, indent + 1);
 
 	for (uint64_t indent_index = 0; indent_index < indent; ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "]\n");
@@ -1405,14 +1779,15 @@ static void print_ast_block_call(
 
 static void print_ast_block_as(
 	mirac_file_t* const file,
-	const mirac_ast_block_s* const block,
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block,
 	const uint64_t indent)
 {
 	mirac_debug_assert(file != mirac_null);
-	mirac_debug_assert(block != mirac_null);
-	mirac_debug_assert(mirac_ast_block_type_as == block->type);
+	mirac_debug_assert(unit != mirac_null);
+	mirac_debug_assert(mirac_ast_block_type_as == mirac_ast_unit_get_block_type(unit, block));
 
-	const mirac_ast_block_as_s* const as_block = &block->as.as_block;
+	const mirac_ast_block_as_s* const as_block = &mirac_ast_unit_get_block_payload(unit, block)->as.as_block;
 	mirac_debug_assert(as_block != mirac_null);
 
 	for (uint64_t indent_index = 0; indent_index < indent; ++indent_index) (void)fprintf(file, "\t");
@@ -1420,10 +1795,10 @@ static void print_ast_block_as(
 
 	for (uint64_t indent_index = 0; indent_index < (indent + 1); ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "types:\n");
-	for (mirac_token_list_node_s* types_iterator = as_block->type_tokens.begin; types_iterator != mirac_null; types_iterator = types_iterator->next)
+	for (uint64_t type_index = as_block->type_tokens.begin; type_index < ((uint64_t)as_block->type_tokens.begin + as_block->type_tokens.count); ++type_index)
 	{
 		for (uint64_t indent_index = 0; indent_index < (indent + 2); ++indent_index) (void)fprintf(file, "\t");
-		(void)fprintf(file, mirac_sv_fmt "\n", mirac_sv_arg(mirac_token_to_string_view(&types_iterator->data)));
+		(void)fprintf(file, mirac_sv_fmt "\n", mirac_sv_arg(mirac_token_to_string_view(&unit->type_tokens.data[type_index])));
 	}
 
 	for (uint64_t indent_index = 0; indent_index < indent; ++indent_index) (void)fprintf(file, "\t");
@@ -1432,14 +1807,15 @@ static void print_ast_block_as(
 
 static void print_ast_block_scope(
 	mirac_file_t* const file,
-	const mirac_ast_block_s* const block,
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block,
 	const uint64_t indent)
 {
 	mirac_debug_assert(file != mirac_null);
-	mirac_debug_assert(block != mirac_null);
-	mirac_debug_assert(mirac_ast_block_type_scope == block->type);
+	mirac_debug_assert(unit != mirac_null);
+	mirac_debug_assert(mirac_ast_block_type_scope == mirac_ast_unit_get_block_type(unit, block));
 
-	const mirac_ast_block_scope_s* const scope_block = &block->as.scope_block;
+	const mirac_ast_block_scope_s* const scope_block = &mirac_ast_unit_get_block_payload(unit, block)->as.scope_block;
 	mirac_debug_assert(scope_block != mirac_null);
 
 	for (uint64_t indent_index = 0; indent_index < indent; ++indent_index) (void)fprintf(file, "\t");
@@ -1452,11 +1828,9 @@ static void print_ast_block_scope(
 
 	for (uint64_t indent_index = 0; indent_index < (indent + 1); ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "blocks:\n");
-	for (mirac_ast_block_list_node_s* blocks_iterator = scope_block->blocks.begin; blocks_iterator != mirac_null; blocks_iterator = blocks_iterator->next)
+	for (uint64_t block_index = scope_block->blocks.begin; block_index < ((uint64_t)scope_block->blocks.begin + scope_block->blocks.count); ++block_index)
 	{
-		mirac_debug_assert(blocks_iterator != mirac_null);
-		mirac_debug_assert(blocks_iterator->data != mirac_null);
-		print_ast_block(file, blocks_iterator->data, indent + 2);
+		print_ast_block(file, unit, unit->children.data[block_index], indent + 2);
 	}
 
 	for (uint64_t indent_index = 0; indent_index < indent; ++indent_index) (void)fprintf(file, "\t");
@@ -1465,30 +1839,29 @@ static void print_ast_block_scope(
 
 static void print_ast_block_if(
 	mirac_file_t* const file,
-	const mirac_ast_block_s* const block,
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block,
 	const uint64_t indent)
 {
 	mirac_debug_assert(file != mirac_null);
-	mirac_debug_assert(block != mirac_null);
-	mirac_debug_assert(mirac_ast_block_type_if == block->type);
+	mirac_debug_assert(unit != mirac_null);
+	mirac_debug_assert(mirac_ast_block_type_if == mirac_ast_unit_get_block_type(unit, block));
 
-	const mirac_ast_block_if_s* const if_block = &block->as.if_block;
+	const mirac_ast_block_if_s* const if_block = &mirac_ast_unit_get_block_payload(unit, block)->as.if_block;
 	mirac_debug_assert(if_block != mirac_null);
-	mirac_debug_assert(if_block->cond != mirac_null);
-	mirac_debug_assert(if_block->body != mirac_null);
-	mirac_debug_assert(mirac_ast_block_type_scope == if_block->cond->type);
-	mirac_debug_assert(mirac_ast_block_type_scope == if_block->body->type);
+	mirac_debug_assert(mirac_ast_block_type_scope == mirac_ast_unit_get_block_type(unit, if_block->cond));
+	mirac_debug_assert(mirac_ast_block_type_scope == mirac_ast_unit_get_block_type(unit, if_block->body));
 
 	for (uint64_t indent_index = 0; indent_index < indent; ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "IfBlock[\n");
 
 	for (uint64_t indent_index = 0; indent_index < (indent + 1); ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "cond:\n");
-	print_ast_block(file, if_block->cond, indent + 2);
+	print_ast_block(file, unit, if_block->cond, indent + 2);
 
 	for (uint64_t indent_index = 0; indent_index < (indent + 1); ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "body:\n");
-	print_ast_block(file, if_block->body, indent + 2);
+	print_ast_block(file, unit, if_block->body, indent + 2);
 
 	for (uint64_t indent_index = 0; indent_index < indent; ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "]\n");
@@ -1496,24 +1869,24 @@ static void print_ast_block_if(
 
 static void print_ast_block_else(
 	mirac_file_t* const file,
-	const mirac_ast_block_s* const block,
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block,
 	const uint64_t indent)
 {
 	mirac_debug_assert(file != mirac_null);
-	mirac_debug_assert(block != mirac_null);
-	mirac_debug_assert(mirac_ast_block_type_else == block->type);
+	mirac_debug_assert(unit != mirac_null);
+	mirac_debug_assert(mirac_ast_block_type_else == mirac_ast_unit_get_block_type(unit, block));
 
-	const mirac_ast_block_else_s* const else_block = &block->as.else_block;
+	const mirac_ast_block_else_s* const else_block = &mirac_ast_unit_get_block_payload(unit, block)->as.else_block;
 	mirac_debug_assert(else_block != mirac_null);
-	mirac_debug_assert(else_block->body != mirac_null);
-	mirac_debug_assert(mirac_ast_block_type_scope == else_block->body->type);
+	mirac_debug_assert(mirac_ast_block_type_scope == mirac_ast_unit_get_block_type(unit, else_block->body));
 
 	for (uint64_t indent_index = 0; indent_index < indent; ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "ElseBlock[\n");
 
 	for (uint64_t indent_index = 0; indent_index < (indent + 1); ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "body:\n");
-	print_ast_block(file, else_block->body, indent + 2);
+	print_ast_block(file, unit, else_block->body, indent + 2);
 
 	for (uint64_t indent_index = 0; indent_index < indent; ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "]\n");
@@ -1521,30 +1894,29 @@ static void print_ast_block_else(
 
 static void print_ast_block_loop(
 	mirac_file_t* const file,
-	const mirac_ast_block_s* const block,
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block,
 	const uint64_t indent)
 {
 	mirac_debug_assert(file != mirac_null);
-	mirac_debug_assert(block != mirac_null);
-	mirac_debug_assert(mirac_ast_block_type_loop == block->type);
+	mirac_debug_assert(unit != mirac_null);
+	mirac_debug_assert(mirac_ast_block_type_loop == mirac_ast_unit_get_block_type(unit, block));
 
-	const mirac_ast_block_loop_s* const loop_block = &block->as.loop_block;
+	const mirac_ast_block_loop_s* const loop_block = &mirac_ast_unit_get_block_payload(unit, block)->as.loop_block;
 	mirac_debug_assert(loop_block != mirac_null);
-	mirac_debug_assert(loop_block->cond != mirac_null);
-	mirac_debug_assert(loop_block->body != mirac_null);
-	mirac_debug_assert(mirac_ast_block_type_scope == loop_block->cond->type);
-	mirac_debug_assert(mirac_ast_block_type_scope == loop_block->body->type);
+	mirac_debug_assert(mirac_ast_block_type_scope == mirac_ast_unit_get_block_type(unit, loop_block->cond));
+	mirac_debug_assert(mirac_ast_block_type_scope == mirac_ast_unit_get_block_type(unit, loop_block->body));
 
 	for (uint64_t indent_index = 0; indent_index < indent; ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "LoopBlock[\n");
 
 	for (uint64_t indent_index = 0; indent_index < (indent + 1); ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "cond:\n");
-	print_ast_block(file, loop_block->cond, indent + 2);
+	print_ast_block(file, unit, loop_block->cond, indent + 2);
 
 	for (uint64_t indent_index = 0; indent_index < (indent + 1); ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "body:\n");
-	print_ast_block(file, loop_block->body, indent + 2);
+	print_ast_block(file, unit, loop_block->body, indent + 2);
 
 	for (uint64_t indent_index = 0; indent_index < indent; ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "]\n");
@@ -1552,16 +1924,15 @@ static void print_ast_block_loop(
 
 static void print_ast_block_asm(
 	mirac_file_t* const file,
-	const mirac_ast_block_s* const block,
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block,
 	const uint64_t indent)
 {
 	mirac_debug_assert(file != mirac_null);
-	mirac_debug_assert(block != mirac_null);
-	mirac_debug_assert(mirac_ast_block_type_asm == block->type);
+	mirac_debug_assert(unit != mirac_null);
+	mirac_debug_assert(mirac_ast_block_type_asm == mirac_ast_unit_get_block_type(unit, block));
 
-	const mirac_ast_block_asm_s* const asm_block = &block->as.asm_block;
-	mirac_debug_assert(asm_block != mirac_null);
-	mirac_debug_assert(mirac_token_type_literal_str == asm_block->inst.type);
+	const mirac_token_s token = mirac_ast_unit_get_block_token(unit, block);
 
 	for (uint64_t indent_index = 0; indent_index < indent; ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "AsmBlock[\n");
@@ -1569,43 +1940,44 @@ static void print_ast_block_asm(
 	for (uint64_t indent_index = 0; indent_index < (indent + 1); ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "token:\n");
 	for (uint64_t indent_index = 0; indent_index < (indent + 2); ++indent_index) (void)fprintf(file, "\t");
-	(void)fprintf(file, mirac_sv_fmt "\n", mirac_sv_arg(mirac_token_to_string_view(&asm_block->inst)));
+	(void)fprintf(file, mirac_sv_fmt "\n", mirac_sv_arg(mirac_token_to_string_view(&token)));
 
 	(void)fprintf(file, "]\n");
 }
 
 static void print_ast_block(
 	mirac_file_t* const file,
-	const mirac_ast_block_s* const block,
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block,
 	const uint64_t indent)
 {
 	mirac_debug_assert(file != mirac_null);
-	mirac_debug_assert(block != mirac_null);
+	mirac_debug_assert(unit != mirac_null);
 
 	for (uint64_t indent_index = 0; indent_index < indent; ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "Block[\n");
 
 	for (uint64_t indent_index = 0; indent_index < (indent + 1); ++indent_index) (void)fprintf(file, "\t");
-	(void)fprintf(file, "type: '" mirac_sv_fmt "'\n", mirac_sv_arg(mirac_ast_block_type_to_string_view(block->type)));
+	(void)fprintf(file, "type: '" mirac_sv_fmt "'\n", mirac_sv_arg(mirac_ast_block_type_to_string_view(mirac_ast_unit_get_block_type(unit, block))));
 
 	for (uint64_t indent_index = 0; indent_index < (indent + 1); ++indent_index) (void)fprintf(file, "\t");
-	(void)fprintf(file, "location: '" mirac_location_fmt "'\n", mirac_location_arg(block->location));
+	(void)fprintf(file, "location: '" mirac_location_fmt "'\n", mirac_location_arg(mirac_file_table_get_location(mirac_ast_unit_get_block_position(unit, block))));
 
-	switch (block->type)
+	switch (mirac_ast_unit_get_block_type(unit, block))
 	{
-		case mirac_ast_block_type_expr:  { print_ast_block_expr(file, block, indent + 1);  } break;
-		case mirac_ast_block_type_ident: { print_ast_block_ident(file, block, indent + 1); } break;
-		case mirac_ast_block_type_call:  { print_ast_block_call(file, block, indent + 1);  } break;
-		case mirac_ast_block_type_as:    { print_ast_block_as(file, block, indent + 1);    } break;
-		case mirac_ast_block_type_scope: { print_ast_block_scope(file, block, indent + 1); } break;
-		case mirac_ast_block_type_if:    { print_ast_block_if(file, block, indent + 1);    } break;
-		case mirac_ast_block_type_else:  { print_ast_block_else(file, block, indent + 1);  } break;
-		case mirac_ast_block_type_loop:  { print_ast_block_loop(file, block, indent + 1);  } break;
-		case mirac_ast_block_type_asm:   { print_ast_block_asm(file, block, indent + 1);   } break;
+		case mirac_ast_block_type_expr:  { print_ast_block_expr(file, unit, block, indent + 1);  } break;
+		case mirac_ast_block_type_ident: { print_ast_block_ident(file, unit, block, indent + 1); } break;
+		case mirac_ast_block_type_call:  { print_ast_block_call(file, unit, block, indent + 1);  } break;
+		case mirac_ast_block_type_as:    { print_ast_block_as(file, unit, block, indent + 1);    } break;
+		case mirac_ast_block_type_scope: { print_ast_block_scope(file, unit, block, indent + 1); } break;
+		case mirac_ast_block_type_if:    { print_ast_block_if(file, unit, block, indent + 1);    } break;
+		case mirac_ast_block_type_else:  { print_ast_block_else(file, unit, block, indent + 1);  } break;
+		case mirac_ast_block_type_loop:  { print_ast_block_loop(file, unit, block, indent + 1);  } break;
+		case mirac_ast_block_type_asm:   { print_ast_block_asm(file, unit, block, indent + 1);   } break;
 
 		default:
 		{
-			mirac_logger_debug("encountered an unknown 'mirac_ast_block_type_e' type with raw value of '%u'.", block->type);
+			mirac_logger_debug("encountered an unknown 'mirac_ast_block_type_e' type with raw value of '%u'.", mirac_ast_unit_get_block_type(unit, block));
 			mirac_debug_assert(0); // note: should never reach this block.
 		} break;
 	}
@@ -1616,17 +1988,18 @@ static void print_ast_block(
 
 static void print_ast_def_fun(
 	mirac_file_t* const file,
+	const mirac_ast_unit_s* const unit,
 	const mirac_ast_def_s* const def,
 	const uint64_t indent)
 {
 	mirac_debug_assert(file != mirac_null);
+	mirac_debug_assert(unit != mirac_null);
 	mirac_debug_assert(def != mirac_null);
 	mirac_debug_assert(mirac_ast_def_type_fun == def->type);
 
 	const mirac_ast_def_fun_s* const fun_def = &def->as.fun_def;
 	mirac_debug_assert(fun_def != mirac_null);
-	mirac_debug_assert(fun_def->body != mirac_null);
-	mirac_debug_assert(mirac_ast_block_type_scope == fun_def->body->type);
+	mirac_debug_assert(mirac_ast_block_type_scope == mirac_ast_unit_get_block_type(unit, fun_def->body));
 
 	for (uint64_t indent_index = 0; indent_index < indent; ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "FunDef[\n");
@@ -1638,23 +2011,23 @@ static void print_ast_def_fun(
 
 	for (uint64_t indent_index = 0; indent_index < (indent + 1); ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "req_tokens:\n");
-	for (const mirac_token_list_node_s* reqs_iterator = fun_def->req_tokens.begin; reqs_iterator != mirac_null; reqs_iterator = reqs_iterator->next)
+	for (uint64_t req_index = 0; req_index < fun_def->req_tokens.count; ++req_index)
 	{
 		for (uint64_t indent_index = 0; indent_index < (indent + 2); ++indent_index) (void)fprintf(file, "\t");
-		(void)fprintf(file, mirac_sv_fmt "\n", mirac_sv_arg(mirac_token_to_string_view(&reqs_iterator->data)));
+		(void)fprintf(file, mirac_sv_fmt "\n", mirac_sv_arg(mirac_token_to_string_view(&fun_def->req_tokens.data[req_index])));
 	}
 	
 	for (uint64_t indent_index = 0; indent_index < (indent + 1); ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "ret_tokens:\n");
-	for (const mirac_token_list_node_s* rets_iterator = fun_def->ret_tokens.begin; rets_iterator != mirac_null; rets_iterator = rets_iterator->next)
+	for (uint64_t ret_index = 0; ret_index < fun_def->ret_tokens.count; ++ret_index)
 	{
 		for (uint64_t indent_index = 0; indent_index < (indent + 2); ++indent_index) (void)fprintf(file, "\t");
-		(void)fprintf(file, mirac_sv_fmt "\n", mirac_sv_arg(mirac_token_to_string_view(&rets_iterator->data)));
+		(void)fprintf(file, mirac_sv_fmt "\n", mirac_sv_arg(mirac_token_to_string_view(&fun_def->ret_tokens.data[ret_index])));
 	}
 
 	for (uint64_t indent_index = 0; indent_index < (indent + 1); ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "body:\n");
-	print_ast_block(file, fun_def->body, indent + 2);
+	print_ast_block(file, unit, fun_def->body, indent + 2);
 
 	for (uint64_t indent_index = 0; indent_index < (indent + 1); ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "is_entry: %s\n", fun_def->is_entry ? "yes" : "no");
@@ -1665,10 +2038,12 @@ static void print_ast_def_fun(
 
 static void print_ast_def_mem(
 	mirac_file_t* const file,
+	const mirac_ast_unit_s* const unit,
 	const mirac_ast_def_s* const def,
 	const uint64_t indent)
 {
 	mirac_debug_assert(file != mirac_null);
+	mirac_debug_assert(unit != mirac_null);
 	mirac_debug_assert(def != mirac_null);
 	mirac_debug_assert(mirac_ast_def_type_mem == def->type);
 
@@ -1694,10 +2069,12 @@ static void print_ast_def_mem(
 
 static void print_ast_def_str(
 	mirac_file_t* const file,
+	const mirac_ast_unit_s* const unit,
 	const mirac_ast_def_s* const def,
 	const uint64_t indent)
 {
 	mirac_debug_assert(file != mirac_null);
+	mirac_debug_assert(unit != mirac_null);
 	mirac_debug_assert(def != mirac_null);
 	mirac_debug_assert(mirac_ast_def_type_str == def->type);
 
@@ -1723,17 +2100,19 @@ static void print_ast_def_str(
 
 static void print_ast_def(
 	mirac_file_t* const file,
+	const mirac_ast_unit_s* const unit,
 	const mirac_ast_def_s* const def,
 	const uint64_t indent)
 {
 	mirac_debug_assert(file != mirac_null);
+	mirac_debug_assert(unit != mirac_null);
 	mirac_debug_assert(def != mirac_null);
 
 	for (uint64_t indent_index = 0; indent_index < indent; ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "Def[\n");
 
 	for (uint64_t indent_index = 0; indent_index < (indent + 1); ++indent_index) (void)fprintf(file, "\t");
-	(void)fprintf(file, "location: '" mirac_location_fmt "'\n", mirac_location_arg(def->location));
+	(void)fprintf(file, "location: '" mirac_location_fmt "'\n", mirac_location_arg(mirac_file_table_get_location(def->position)));
 
 	for (uint64_t indent_index = 0; indent_index < (indent + 1); ++indent_index) (void)fprintf(file, "\t");
 	(void)fprintf(file, "section:\n");
@@ -1748,9 +2127,9 @@ static void print_ast_def(
 
 	switch (def->type)
 	{
-		case mirac_ast_def_type_fun: { print_ast_def_fun(file, def, indent + 1); } break;
-		case mirac_ast_def_type_mem: { print_ast_def_mem(file, def, indent + 1); } break;
-		case mirac_ast_def_type_str: { print_ast_def_str(file, def, indent + 1); } break;
+		case mirac_ast_def_type_fun: { print_ast_def_fun(file, unit, def, indent + 1); } break;
+		case mirac_ast_def_type_mem: { print_ast_def_mem(file, unit, def, indent + 1); } break;
+		case mirac_ast_def_type_str: { print_ast_def_str(file, unit, def, indent + 1); } break;
 
 		default:
 		{
@@ -0,0 +1,1047 @@
+/**
+ * @file preprocessor.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-03-02
+ */
+
+#include <mirac/preprocessor.h>
+
+#include <mirac/debug.h>
+#include <mirac/logger.h>
+
+#include <sys/stat.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+mirac_implement_symbol_table_type(mirac_preprocessor_file_table, mirac_preprocessor_file_s*);
+mirac_implement_heap_array_type(mirac_preprocessor_file_list, const mirac_preprocessor_file_s*);
+mirac_implement_symbol_table_type(mirac_preprocessor_macro_table, mirac_preprocessor_macro_s*);
+mirac_implement_heap_array_type(mirac_preprocessor_frame_list, mirac_preprocessor_frame_s);
+mirac_implement_heap_array_type(mirac_preprocessor_condition_list, mirac_preprocessor_condition_s);
+
+#define log_preprocessor_error_and_exit(_location, _format, ...)               \
+	do                                                                         \
+	{                                                                          \
+		mirac_logger_error(mirac_sv_fmt ":%lu:%lu: " _format,                  \
+			mirac_sv_arg((_location).file), (_location).line,                  \
+			(_location).column, ## __VA_ARGS__);                               \
+		mirac_c_exit(-1);                                                      \
+	} while (0)
+
+/**
+ * @brief Get the directory part of the path ("." if the path has none).
+ * 
+ * @param path path to get the directory of
+ * 
+ * @return mirac_string_view_s
+ */
+static mirac_string_view_s get_directory_of_path(
+	const mirac_string_view_s path);
+
+/**
+ * @brief Detect the include guard of the file's tokens.
+ * 
+ * The file is guarded when it starts with '#ifndef X' and '#define X', and the
+ * '#endif' matching the '#ifndef' is its last directive with nothing after it.
+ * Including such a file while X is defined produces no tokens, so it can be
+ * skipped without being replayed.
+ * 
+ * @param tokens tokens of the file
+ * 
+ * @return mirac_string_view_s
+ */
+static mirac_string_view_s detect_include_guard(
+	const mirac_token_list_s* const tokens);
+
+/**
+ * @brief Get the cached file of the provided canonical path, lexing it first if it
+ * is not cached yet.
+ * 
+ * @param cache    cache instance
+ * @param config   config instance
+ * @param path     canonical path of the file
+ * @param location location of the include directive
+ * @param stats    stats to account the lexing of the file into (may be mirac_null)
+ * 
+ * @return const mirac_preprocessor_file_s*
+ */
+static const mirac_preprocessor_file_s* load_file(
+	mirac_preprocessor_cache_s* const cache,
+	mirac_config_s* const config,
+	const char_t* const path,
+	const mirac_location_s location,
+	mirac_arena_stats_s* const stats);
+
+/**
+ * @brief Canonicalize the path of the name relative to the directory, if it
+ * refers to a regular file.
+ * 
+ * @param directory     directory to look in
+ * @param name          name of the file
+ * @param resolved_path buffer of at least PATH_MAX chars for the canonical path
+ * 
+ * @return bool_t
+ */
+static bool_t try_resolve_path(
+	const mirac_string_view_s directory,
+	const mirac_string_view_s name,
+	char_t* const resolved_path);
+
+/**
+ * @brief Resolve the path of the included file.
+ * 
+ * Quoted names are looked up in the directory of the including file first, and
+ * then in the include paths. Angled names are looked up in the include paths only.
+ * 
+ * @param preprocessor  preprocessor instance
+ * @param is_quoted     whether the name was quoted
+ * @param name          name of the included file
+ * @param resolved_path buffer of at least PATH_MAX chars for the canonical path
+ * 
+ * @return bool_t
+ */
+static bool_t resolve_include_path(
+	const mirac_preprocessor_s* const preprocessor,
+	const bool_t is_quoted,
+	const mirac_string_view_s name,
+	char_t* const resolved_path);
+
+/**
+ * @brief Fetch next token of the top frame, popping the exhausted frames.
+ * 
+ * @param preprocessor preprocessor instance
+ * @param token        token to be fetched
+ * 
+ * @return bool_t
+ */
+static bool_t fetch_raw_token(
+	mirac_preprocessor_s* const preprocessor,
+	mirac_token_s* const token);
+
+/**
+ * @brief Check if the tokens are currently emitted (not excluded by a condition).
+ * 
+ * @param preprocessor preprocessor instance
+ * 
+ * @return bool_t
+ */
+static bool_t is_active(
+	const mirac_preprocessor_s* const preprocessor);
+
+/**
+ * @brief Find the macro of the provided symbol.
+ * 
+ * @param preprocessor preprocessor instance
+ * @param symbol       symbol of the macro's name
+ * 
+ * @return mirac_preprocessor_macro_s*
+ */
+static mirac_preprocessor_macro_s* find_macro(
+	const mirac_preprocessor_s* const preprocessor,
+	const mirac_symbol_t symbol);
+
+/**
+ * @brief Check if the macro of the provided symbol is defined.
+ * 
+ * @param preprocessor preprocessor instance
+ * @param symbol       symbol of the macro's name
+ * 
+ * @return bool_t
+ */
+static bool_t is_macro_defined(
+	const mirac_preprocessor_s* const preprocessor,
+	const mirac_symbol_t symbol);
+
+/**
+ * @brief Fetch the macro name operand of the directive.
+ * 
+ * @param preprocessor preprocessor instance
+ * @param directive    directive token
+ * 
+ * @return mirac_token_s
+ */
+static mirac_token_s fetch_macro_name(
+	mirac_preprocessor_s* const preprocessor,
+	const mirac_token_s* const directive);
+
+/**
+ * @brief Fetch the end of the directive's line, failing on any leftover token.
+ * 
+ * @param preprocessor preprocessor instance
+ * @param directive    directive token
+ */
+static void expect_directive_end(
+	mirac_preprocessor_s* const preprocessor,
+	const mirac_token_s* const directive);
+
+/**
+ * @brief Skip the rest of the directive's line.
+ * 
+ * @param preprocessor preprocessor instance
+ */
+static void skip_directive_line(
+	mirac_preprocessor_s* const preprocessor);
+
+/**
+ * @brief Handle the '#include' directive.
+ * 
+ * @param preprocessor preprocessor instance
+ * @param directive    directive token
+ */
+static void handle_include_directive(
+	mirac_preprocessor_s* const preprocessor,
+	const mirac_token_s* const directive);
+
+/**
+ * @brief Handle the '#define' directive.
+ * 
+ * @param preprocessor preprocessor instance
+ * @param directive    directive token
+ */
+static void handle_define_directive(
+	mirac_preprocessor_s* const preprocessor,
+	const mirac_token_s* const directive);
+
+/**
+ * @brief Handle any directive.
+ * 
+ * @param preprocessor preprocessor instance
+ * @param directive    directive token
+ */
+static void handle_directive(
+	mirac_preprocessor_s* const preprocessor,
+	const mirac_token_s* const directive);
+
+bool_t mirac_preprocessor_file_stamp_from_path(
+	const char_t* const path,
+	mirac_preprocessor_file_stamp_s* const stamp)
+{
+	mirac_debug_assert(path != mirac_null);
+	mirac_debug_assert(stamp != mirac_null);
+
+	struct stat status = {0};
+
+	if (stat(path, &status) != 0)
+	{
+		return false;
+	}
+
+	*stamp = (mirac_preprocessor_file_stamp_s)
+	{
+		.size              = (uint64_t)status.st_size,
+		.modification_time = ((uint64_t)status.st_mtim.tv_sec * 1000000000) + (uint64_t)status.st_mtim.tv_nsec
+	};
+
+	return true;
+}
+
+bool_t mirac_preprocessor_file_stamp_equal(
+	const mirac_preprocessor_file_stamp_s left,
+	const mirac_preprocessor_file_stamp_s right)
+{
+	return (left.size == right.size) && (left.modification_time == right.modification_time);
+}
+
+mirac_preprocessor_cache_s mirac_preprocessor_cache_from_parts(
+	mirac_arena_s* const arena)
+{
+	mirac_debug_assert(arena != mirac_null);
+
+	mirac_interner_s* const interner = (mirac_interner_s*)mirac_arena_malloc(arena, sizeof(mirac_interner_s));
+	*interner = mirac_interner_from_parts(arena);
+
+	pthread_mutex_t* const mutex = (pthread_mutex_t*)mirac_arena_malloc(arena, sizeof(pthread_mutex_t));
+
+	if (pthread_mutex_init(mutex, mirac_null) != 0)
+	{
+		mirac_logger_error("internal failure -- failed to create preprocessor cache mutex.");
+		mirac_c_exit(-1);
+	}
+
+	return (mirac_preprocessor_cache_s)
+	{
+		.arena              = arena,
+		.interner           = interner,
+		.files              = mirac_preprocessor_file_table_from_parts(arena, interner),
+		.mutex              = mutex,
+		.lexed_files_count  = 0,
+		.reused_files_count = 0
+	};
+}
+
+void mirac_preprocessor_cache_destroy(
+	mirac_preprocessor_cache_s* const cache)
+{
+	mirac_debug_assert(cache != mirac_null);
+	mirac_debug_assert(cache->mutex != mirac_null);
+
+	for (uint64_t slot_index = 0; slot_index < cache->files.capacity; ++slot_index)
+	{
+		if (cache->files.slots[slot_index].symbol != mirac_symbol_none)
+		{
+			mirac_preprocessor_file_s* const file = cache->files.slots[slot_index].value;
+			mirac_lexer_destroy(&file->lexer);
+			mirac_arena_destroy(&file->arena);
+		}
+	}
+
+	(void)pthread_mutex_destroy(cache->mutex);
+	*cache = (mirac_preprocessor_cache_s) {0};
+}
+
+void mirac_preprocessor_cache_preload(
+	mirac_preprocessor_cache_s* const cache,
+	mirac_config_s* const config,
+	const char_t* const path)
+{
+	mirac_debug_assert(cache != mirac_null);
+	mirac_debug_assert(config != mirac_null);
+	mirac_debug_assert(path != mirac_null);
+
+	const mirac_location_s location = (mirac_location_s)
+	{
+		.file   = mirac_string_view_from_cstring(path),
+		.line   = 0,
+		.column = 0
+	};
+
+	(void)load_file(cache, config, path, location, mirac_null);
+}
+
+uint64_t mirac_preprocessor_cache_drop_changed_files(
+	mirac_preprocessor_cache_s* const cache)
+{
+	mirac_debug_assert(cache != mirac_null);
+
+	// note: open addressing tables do not support removal, so the unchanged files
+	//       are moved into a new table instead.
+	mirac_preprocessor_file_table_s files = mirac_preprocessor_file_table_from_parts(cache->arena, cache->interner);
+	uint64_t dropped_files_count = 0;
+
+	for (uint64_t slot_index = 0; slot_index < cache->files.capacity; ++slot_index)
+	{
+		const mirac_symbol_t symbol = cache->files.slots[slot_index].symbol;
+
+		if (mirac_symbol_none == symbol)
+		{
+			continue;
+		}
+
+		mirac_preprocessor_file_s* const file = cache->files.slots[slot_index].value;
+		mirac_preprocessor_file_stamp_s stamp = {0};
+
+		if (mirac_preprocessor_file_stamp_from_path(file->path.data, &stamp) &&
+			mirac_preprocessor_file_stamp_equal(stamp, file->stamp))
+		{
+			(void)mirac_preprocessor_file_table_insert(&files, symbol, file);
+			continue;
+		}
+
+		mirac_lexer_destroy(&file->lexer);
+		mirac_arena_destroy(&file->arena);
+		++dropped_files_count;
+	}
+
+	cache->files = files;
+	return dropped_files_count;
+}
+
+mirac_preprocessor_s mirac_preprocessor_from_parts(
+	mirac_config_s* const config,
+	mirac_arena_s* const arena,
+	mirac_preprocessor_cache_s* const cache,
+	mirac_lexer_s* const lexer)
+{
+	mirac_debug_assert(config != mirac_null);
+	mirac_debug_assert(arena != mirac_null);
+	mirac_debug_assert(cache != mirac_null);
+	mirac_debug_assert(lexer != mirac_null);
+	mirac_debug_assert(lexer->interner != mirac_null);
+
+	mirac_preprocessor_s preprocessor = (mirac_preprocessor_s)
+	{
+		.config         = config,
+		.arena          = arena,
+		.interner       = lexer->interner,
+		.cache          = cache,
+		.directory      = get_directory_of_path(lexer->file_path),
+		.macros         = mirac_preprocessor_macro_table_from_parts(arena, lexer->interner),
+		.frames         = mirac_preprocessor_frame_list_from_parts(arena, 0),
+		.conditions     = mirac_preprocessor_condition_list_from_parts(arena, 0),
+		.included_files = mirac_preprocessor_file_list_from_parts(arena, 0),
+		.token          = mirac_token_from_type(mirac_token_type_none),
+		.eof_token      = mirac_token_from_type(mirac_token_type_eof)
+	};
+
+	mirac_preprocessor_frame_list_push(&preprocessor.frames, (mirac_preprocessor_frame_s)
+	{
+		.lexer = lexer
+	});
+
+	return preprocessor;
+}
+
+mirac_token_type_e mirac_preprocessor_lex_next(
+	mirac_preprocessor_s* const preprocessor,
+	mirac_token_s* const token)
+{
+	mirac_debug_assert(preprocessor != mirac_null);
+	mirac_debug_assert(token != mirac_null);
+
+	if (preprocessor->token.type != mirac_token_type_none)
+	{
+		*token = preprocessor->token;
+		preprocessor->token = mirac_token_from_type(mirac_token_type_none);
+		return token->type;
+	}
+
+	while (fetch_raw_token(preprocessor, token))
+	{
+		if ((token->type >= mirac_token_type_directive_include) &&
+			(token->type <= mirac_token_type_directive_endif))
+		{
+			handle_directive(preprocessor, token);
+			continue;
+		}
+
+		if (!is_active(preprocessor))
+		{
+			continue;
+		}
+
+		if (mirac_token_type_identifier == token->type)
+		{
+			mirac_preprocessor_macro_s* const macro = find_macro(preprocessor, token->symbol);
+
+			// note: a macro is not expanded inside its own expansion, so the name
+			//       is kept as is (which is what cpp does as well).
+			if ((macro != mirac_null) && macro->is_defined && !macro->is_expanding)
+			{
+				macro->is_expanding = true;
+				mirac_preprocessor_frame_list_push(&preprocessor->frames, (mirac_preprocessor_frame_s)
+				{
+					.macro        = macro,
+					.tokens       = macro->tokens.data,
+					.tokens_count = macro->tokens.count,
+					.index        = 0,
+					.invocation   = *token
+				});
+				continue;
+			}
+		}
+
+		return token->type;
+	}
+
+	*token = preprocessor->eof_token;
+	return token->type;
+}
+
+void mirac_preprocessor_unlex(
+	mirac_preprocessor_s* const preprocessor,
+	mirac_token_s* const token)
+{
+	mirac_debug_assert(preprocessor != mirac_null);
+	mirac_debug_assert(token != mirac_null);
+	preprocessor->token = *token;
+}
+
+static mirac_string_view_s get_directory_of_path(
+	const mirac_string_view_s path)
+{
+	uint64_t length = path.length;
+
+	while ((length > 0) && (path.data[length - 1] != '/'))
+	{
+		--length;
+	}
+
+	if (length <= 0)
+	{
+		return mirac_string_view_from_parts(".", 1);
+	}
+
+	// note: the slash is kept only for the root directory.
+	return mirac_string_view_from_parts(path.data, length > 1 ? length - 1 : length);
+}
+
+static mirac_string_view_s detect_include_guard(
+	const mirac_token_list_s* const tokens)
+{
+	mirac_debug_assert(tokens != mirac_null);
+
+	const mirac_string_view_s no_guard = mirac_string_view_from_parts("", 0);
+	const mirac_token_s* const data = tokens->data;
+	const uint64_t count = tokens->count;
+
+	if ((count < 7) ||
+		(data[0].type != mirac_token_type_directive_ifndef) ||
+		(data[1].type != mirac_token_type_identifier) ||
+		(data[2].type != mirac_token_type_directive_end) ||
+		(data[3].type != mirac_token_type_directive_define) ||
+		(data[4].type != mirac_token_type_identifier) ||
+		!mirac_string_view_equal(mirac_token_get_ident(&data[1]), mirac_token_get_ident(&data[4])) ||
+		(data[count - 2].type != mirac_token_type_directive_endif) ||
+		(data[count - 1].type != mirac_token_type_directive_end))
+	{
+		return no_guard;
+	}
+
+	uint64_t depth = 0;
+
+	for (uint64_t index = 0; index < count; ++index)
+	{
+		switch (data[index].type)
+		{
+			case mirac_token_type_directive_ifdef:
+			case mirac_token_type_directive_ifndef:
+			{
+				++depth;
+			} break;
+
+			case mirac_token_type_directive_else:
+			{
+				// note: the else branch of the guard itself is replayed when the
+				//       guard is defined.
+				if (depth <= 1)
+				{
+					return no_guard;
+				}
+			} break;
+
+			case mirac_token_type_directive_endif:
+			{
+				// note: unbalanced files are reported when replayed, so they are
+				//       simply not treated as guarded here.
+				if ((depth <= 0) || ((--depth <= 0) && (index != (count - 2))))
+				{
+					return no_guard;
+				}
+			} break;
+
+			default:
+			{
+			} break;
+		}
+	}
+
+	return depth <= 0 ? mirac_token_get_ident(&data[1]) : no_guard;
+}
+
+static const mirac_preprocessor_file_s* load_file(
+	mirac_preprocessor_cache_s* const cache,
+	mirac_config_s* const config,
+	const char_t* const path,
+	const mirac_location_s location,
+	mirac_arena_stats_s* const stats)
+{
+	mirac_debug_assert(cache != mirac_null);
+	mirac_debug_assert(config != mirac_null);
+	mirac_debug_assert(path != mirac_null);
+
+	mirac_preprocessor_file_s* file = mirac_null;
+
+	(void)pthread_mutex_lock(cache->mutex);
+	const mirac_symbol_t symbol = mirac_interner_intern(cache->interner, mirac_string_view_from_cstring(path));
+	const bool_t is_cached = mirac_preprocessor_file_table_find(&cache->files, symbol, &file);
+	cache->reused_files_count += is_cached ? 1 : 0;
+	(void)pthread_mutex_unlock(cache->mutex);
+
+	if (is_cached)
+	{
+		return file;
+	}
+
+	// note: the file is lexed outside of the lock, so a lexing error (which may
+	//       unwind the thread through an exit trap) never leaves it locked.
+	mirac_file_t* const source_file = fopen(path, "rt");
+
+	if (mirac_null == source_file)
+	{
+		log_preprocessor_error_and_exit(location, "failed to open included file '%s'.", path);
+	}
+
+	mirac_preprocessor_file_s loaded = {0};
+	loaded.arena = mirac_arena_from_parts();
+	mirac_arena_set_stats(&loaded.arena, stats);
+
+	const mirac_string_view_s path_view = mirac_string_view_from_cstring(path);
+	char_t* const path_copy = (char_t*)mirac_arena_malloc_aligned(&loaded.arena, path_view.length + 1, 1);
+	mirac_c_memcpy(path_copy, path_view.data, path_view.length);
+	path_copy[path_view.length] = '\0';
+	loaded.path = mirac_string_view_from_parts(path_copy, path_view.length);
+	loaded.directory = get_directory_of_path(loaded.path);
+
+	// note: the stamp is taken before lexing, so a file modified while being lexed
+	//       is considered changed afterwards.
+	(void)mirac_preprocessor_file_stamp_from_path(path, &loaded.stamp);
+
+	// note: the interner is dropped after lexing, while the identifiers it
+	//       interned stay in the file's arena.
+	mirac_interner_s interner = mirac_interner_from_parts(&loaded.arena);
+	loaded.lexer = mirac_lexer_from_parts(config, &loaded.arena, &interner, loaded.path, source_file);
+	loaded.tokens = mirac_token_list_from_parts(&loaded.arena, 0);
+
+	mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
+	(void)mirac_arena_set_site(&loaded.arena, mirac_arena_site_tokens);
+
+	while (!mirac_lexer_should_stop_lexing(mirac_lexer_lex_next(&loaded.lexer, &token)))
+	{
+		mirac_token_list_push(&loaded.tokens, token);
+	}
+
+	// note: the file outlives the unit that lexed it, so it stops being accounted.
+	(void)mirac_arena_set_site(&loaded.arena, mirac_arena_site_none);
+	mirac_arena_set_stats(&loaded.arena, mirac_null);
+	(void)fclose(source_file);
+	loaded.guard = detect_include_guard(&loaded.tokens);
+
+	(void)pthread_mutex_lock(cache->mutex);
+
+	if (!mirac_preprocessor_file_table_find(&cache->files, symbol, &file))
+	{
+		file = (mirac_preprocessor_file_s*)mirac_arena_malloc(cache->arena, sizeof(mirac_preprocessor_file_s));
+		*file = loaded;
+		file->tokens.arena = &file->arena;
+		file->lexer.arena = &file->arena;
+		file->lexer.interner = mirac_null;
+		(void)mirac_preprocessor_file_table_insert(&cache->files, symbol, file);
+		++cache->lexed_files_count;
+	}
+	else
+	{
+		// note: another thread has cached the same file in the meantime.
+		++cache->reused_files_count;
+		mirac_lexer_destroy(&loaded.lexer);
+		mirac_arena_destroy(&loaded.arena);
+	}
+
+	(void)pthread_mutex_unlock(cache->mutex);
+	return file;
+}
+
+static bool_t try_resolve_path(
+	const mirac_string_view_s directory,
+	const mirac_string_view_s name,
+	char_t* const resolved_path)
+{
+	mirac_debug_assert(resolved_path != mirac_null);
+
+	char_t candidate_path[PATH_MAX] = {0};
+	const int32_t length = (directory.length > 0) ?
+		(int32_t)snprintf(candidate_path, sizeof(candidate_path), mirac_sv_fmt "/" mirac_sv_fmt, mirac_sv_arg(directory), mirac_sv_arg(name)) :
+		(int32_t)snprintf(candidate_path, sizeof(candidate_path), mirac_sv_fmt, mirac_sv_arg(name));
+
+	if ((length < 0) || ((uint64_t)length >= sizeof(candidate_path)))
+	{
+		return false;
+	}
+
+	if (mirac_null == realpath(candidate_path, resolved_path))
+	{
+		return false;
+	}
+
+	struct stat status = {0};
+	return (0 == stat(resolved_path, &status)) && S_ISREG(status.st_mode);
+}
+
+static bool_t resolve_include_path(
+	const mirac_preprocessor_s* const preprocessor,
+	const bool_t is_quoted,
+	const mirac_string_view_s name,
+	char_t* const resolved_path)
+{
+	mirac_debug_assert(preprocessor != mirac_null);
+	mirac_debug_assert(preprocessor->config != mirac_null);
+	mirac_debug_assert(preprocessor->frames.count > 0);
+	mirac_debug_assert(resolved_path != mirac_null);
+
+	if ((name.length > 0) && ('/' == name.data[0]))
+	{
+		return try_resolve_path(mirac_string_view_from_parts("", 0), name, resolved_path);
+	}
+
+	if (is_quoted)
+	{
+		const mirac_preprocessor_frame_s* const frame = &preprocessor->frames.data[preprocessor->frames.count - 1];
+		const mirac_string_view_s directory = frame->file != mirac_null ? frame->file->directory : preprocessor->directory;
+
+		if (try_resolve_path(directory, name, resolved_path))
+		{
+			return true;
+		}
+	}
+
+	for (uint64_t path_index = 0; path_index < preprocessor->config->include_paths_count; ++path_index)
+	{
+		if (try_resolve_path(preprocessor->config->include_paths[path_index], name, resolved_path))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static bool_t fetch_raw_token(
+	mirac_preprocessor_s* const preprocessor,
+	mirac_token_s* const token)
+{
+	mirac_debug_assert(preprocessor != mirac_null);
+	mirac_debug_assert(token != mirac_null);
+
+	while (preprocessor->frames.count > 0)
+	{
+		mirac_preprocessor_frame_s* const frame = &preprocessor->frames.data[preprocessor->frames.count - 1];
+
+		if (frame->lexer != mirac_null)
+		{
+			if (!mirac_lexer_should_stop_lexing(mirac_lexer_lex_next(frame->lexer, token)))
+			{
+				return true;
+			}
+
+			preprocessor->eof_token = *token;
+		}
+		else if (frame->index < frame->tokens_count)
+		{
+			*token = frame->tokens[frame->index++];
+
+			if (frame->macro != mirac_null)
+			{
+				// note: the expanded tokens are located at the invocation, so the
+				//       literals among them are spelled as the macro's name.
+				token->file = frame->invocation.file;
+				token->offset = frame->invocation.offset;
+
+				if ((token->type > mirac_token_type_reserved_count) && (token->type != mirac_token_type_identifier))
+				{
+					token->length = frame->invocation.length;
+				}
+			}
+			else if (mirac_token_type_identifier == token->type)
+			{
+				token->symbol = mirac_interner_intern(preprocessor->interner, mirac_token_get_ident(token));
+				token->as.ident = mirac_interner_get_string(preprocessor->interner, token->symbol).data;
+			}
+
+			return true;
+		}
+
+		if (frame->macro != mirac_null)
+		{
+			frame->macro->is_expanding = false;
+		}
+		else if (preprocessor->conditions.count > frame->conditions_count)
+		{
+			const mirac_preprocessor_condition_s* const condition = &preprocessor->conditions.data[preprocessor->conditions.count - 1];
+			log_preprocessor_error_and_exit(mirac_file_table_get_location(condition->position), "encountered unterminated conditional directive.");
+		}
+
+		mirac_preprocessor_frame_s popped_frame = {0};
+		(void)mirac_preprocessor_frame_list_pop(&preprocessor->frames, &popped_frame);
+	}
+
+	return false;
+}
+
+static bool_t is_active(
+	const mirac_preprocessor_s* const preprocessor)
+{
+	mirac_debug_assert(preprocessor != mirac_null);
+	return (preprocessor->conditions.count <= 0) ||
+		preprocessor->conditions.data[preprocessor->conditions.count - 1].is_active;
+}
+
+static mirac_preprocessor_macro_s* find_macro(
+	const mirac_preprocessor_s* const preprocessor,
+	const mirac_symbol_t symbol)
+{
+	mirac_debug_assert(preprocessor != mirac_null);
+
+	mirac_preprocessor_macro_s* macro = mirac_null;
+	return mirac_preprocessor_macro_table_find(&preprocessor->macros, symbol, &macro) ? macro : mirac_null;
+}
+
+static bool_t is_macro_defined(
+	const mirac_preprocessor_s* const preprocessor,
+	const mirac_symbol_t symbol)
+{
+	mirac_debug_assert(preprocessor != mirac_null);
+
+	const mirac_preprocessor_macro_s* const macro = find_macro(preprocessor, symbol);
+	return (macro != mirac_null) && macro->is_defined;
+}
+
+static mirac_token_s fetch_macro_name(
+	mirac_preprocessor_s* const preprocessor,
+	const mirac_token_s* const directive)
+{
+	mirac_debug_assert(preprocessor != mirac_null);
+	mirac_debug_assert(directive != mirac_null);
+
+	mirac_token_s name = mirac_token_from_type(mirac_token_type_none);
+	(void)fetch_raw_token(preprocessor, &name);
+
+	if (name.type != mirac_token_type_identifier)
+	{
+		log_preprocessor_error_and_exit(mirac_token_get_location(directive), "expected macro name after '" mirac_sv_fmt "'.", mirac_sv_arg(mirac_token_get_text(directive)));
+	}
+
+	return name;
+}
+
+static void expect_directive_end(
+	mirac_preprocessor_s* const preprocessor,
+	const mirac_token_s* const directive)
+{
+	mirac_debug_assert(preprocessor != mirac_null);
+	mirac_debug_assert(directive != mirac_null);
+
+	mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
+	(void)fetch_raw_token(preprocessor, &token);
+
+	if (token.type != mirac_token_type_directive_end)
+	{
+		log_preprocessor_error_and_exit(mirac_token_get_location(&token), "encountered unexpected token '" mirac_sv_fmt "' after '" mirac_sv_fmt "'.",
+			mirac_sv_arg(mirac_token_get_text(&token)), mirac_sv_arg(mirac_token_get_text(directive)));
+	}
+}
+
+static void skip_directive_line(
+	mirac_preprocessor_s* const preprocessor)
+{
+	mirac_debug_assert(preprocessor != mirac_null);
+
+	mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
+
+	while (fetch_raw_token(preprocessor, &token) && (token.type != mirac_token_type_directive_end))
+	{
+	}
+}
+
+static void handle_include_directive(
+	mirac_preprocessor_s* const preprocessor,
+	const mirac_token_s* const directive)
+{
+	mirac_debug_assert(preprocessor != mirac_null);
+	mirac_debug_assert(preprocessor->cache != mirac_null);
+	mirac_debug_assert(directive != mirac_null);
+
+	mirac_token_s path_token = mirac_token_from_type(mirac_token_type_none);
+	(void)fetch_raw_token(preprocessor, &path_token);
+
+	mirac_string_view_s name = mirac_string_view_from_parts("", 0);
+	bool_t is_quoted = false;
+
+	if (mirac_token_type_literal_str == path_token.type)
+	{
+		name = mirac_token_get_string(&path_token);
+		is_quoted = true;
+	}
+	else if ((mirac_token_type_identifier == path_token.type) && (path_token.length > 2) &&
+		('<' == path_token.as.ident[0]) && ('>' == path_token.as.ident[path_token.length - 1]))
+	{
+		name = mirac_string_view_from_parts(path_token.as.ident + 1, path_token.length - 2);
+	}
+	else
+	{
+		log_preprocessor_error_and_exit(mirac_token_get_location(directive), "expected file path after '" mirac_sv_fmt "'.", mirac_sv_arg(mirac_token_get_text(directive)));
+	}
+
+	expect_directive_end(preprocessor, directive);
+
+	char_t path[PATH_MAX] = {0};
+
+	if (!resolve_include_path(preprocessor, is_quoted, name, path))
+	{
+		log_preprocessor_error_and_exit(mirac_token_get_location(&path_token), "could not find included file '" mirac_sv_fmt "'.", mirac_sv_arg(name));
+	}
+
+	const mirac_preprocessor_file_s* const file = load_file(preprocessor->cache, preprocessor->config, path,
+		mirac_token_get_location(&path_token), preprocessor->arena->stats);
+	bool_t is_recorded = false;
+
+	for (uint64_t file_index = 0; (file_index < preprocessor->included_files.count) && !is_recorded; ++file_index)
+	{
+		is_recorded = (file == preprocessor->included_files.data[file_index]);
+	}
+
+	if (!is_recorded)
+	{
+		mirac_preprocessor_file_list_push(&preprocessor->included_files, file);
+	}
+
+	if ((file->guard.length > 0) && is_macro_defined(preprocessor, mirac_interner_intern(preprocessor->interner, file->guard)))
+	{
+		return;
+	}
+
+	// note: directives are only ever fetched from file frames, and a macro frame
+	//       is exhausted before the file below it is continued, so every frame
+	//       here is a file frame.
+	if (preprocessor->frames.count >= mirac_preprocessor_max_include_depth)
+	{
+		log_preprocessor_error_and_exit(mirac_token_get_location(&path_token), "exceeded maximum include depth of %d.", mirac_preprocessor_max_include_depth);
+	}
+
+	mirac_preprocessor_frame_list_push(&preprocessor->frames, (mirac_preprocessor_frame_s)
+	{
+		.file             = file,
+		.tokens           = file->tokens.data,
+		.tokens_count     = file->tokens.count,
+		.index            = 0,
+		.conditions_count = preprocessor->conditions.count
+	});
+}
+
+static void handle_define_directive(
+	mirac_preprocessor_s* const preprocessor,
+	const mirac_token_s* const directive)
+{
+	mirac_debug_assert(preprocessor != mirac_null);
+	mirac_debug_assert(directive != mirac_null);
+
+	const mirac_token_s name = fetch_macro_name(preprocessor, directive);
+	mirac_preprocessor_macro_s* macro = find_macro(preprocessor, name.symbol);
+
+	if (mirac_null == macro)
+	{
+		macro = (mirac_preprocessor_macro_s*)mirac_arena_malloc(preprocessor->arena, sizeof(mirac_preprocessor_macro_s));
+		*macro = (mirac_preprocessor_macro_s) {0};
+		(void)mirac_preprocessor_macro_table_insert(&preprocessor->macros, name.symbol, macro);
+	}
+
+	// note: redefining a macro silently replaces its tokens.
+	macro->tokens = mirac_token_list_from_parts(preprocessor->arena, 0);
+	macro->is_defined = true;
+
+	mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
+
+	while (fetch_raw_token(preprocessor, &token) && (token.type != mirac_token_type_directive_end))
+	{
+		const mirac_arena_site_e site = mirac_arena_set_site(preprocessor->arena, mirac_arena_site_tokens);
+		mirac_token_list_push(&macro->tokens, token);
+		(void)mirac_arena_set_site(preprocessor->arena, site);
+	}
+}
+
+static void handle_directive(
+	mirac_preprocessor_s* const preprocessor,
+	const mirac_token_s* const directive)
+{
+	mirac_debug_assert(preprocessor != mirac_null);
+	mirac_debug_assert(preprocessor->frames.count > 0);
+	mirac_debug_assert(directive != mirac_null);
+
+	const uint64_t conditions_base = preprocessor->frames.data[preprocessor->frames.count - 1].conditions_count;
+
+	switch (directive->type)
+	{
+		case mirac_token_type_directive_include:
+		{
+			if (!is_active(preprocessor))
+			{
+				skip_directive_line(preprocessor);
+				break;
+			}
+
+			handle_include_directive(preprocessor, directive);
+		} break;
+
+		case mirac_token_type_directive_define:
+		{
+			if (!is_active(preprocessor))
+			{
+				skip_directive_line(preprocessor);
+				break;
+			}
+
+			handle_define_directive(preprocessor, directive);
+		} break;
+
+		case mirac_token_type_directive_undef:
+		{
+			if (!is_active(preprocessor))
+			{
+				skip_directive_line(preprocessor);
+				break;
+			}
+
+			const mirac_token_s name = fetch_macro_name(preprocessor, directive);
+			expect_directive_end(preprocessor, directive);
+			mirac_preprocessor_macro_s* const macro = find_macro(preprocessor, name.symbol);
+
+			if (macro != mirac_null)
+			{
+				macro->is_defined = false;
+			}
+		} break;
+
+		case mirac_token_type_directive_ifdef:
+		case mirac_token_type_directive_ifndef:
+		{
+			const mirac_token_s name = fetch_macro_name(preprocessor, directive);
+			expect_directive_end(preprocessor, directive);
+
+			const bool_t is_parent_active = is_active(preprocessor);
+			const bool_t is_taken = is_macro_defined(preprocessor, name.symbol) ==
+				(mirac_token_type_directive_ifdef == directive->type);
+
+			mirac_preprocessor_condition_list_push(&preprocessor->conditions, (mirac_preprocessor_condition_s)
+			{
+				.position         = mirac_token_get_position(directive),
+				.is_parent_active = is_parent_active,
+				.is_active        = is_parent_active && is_taken,
+				.is_taken         = is_taken,
+				.has_else         = false
+			});
+		} break;
+
+		case mirac_token_type_directive_else:
+		{
+			expect_directive_end(preprocessor, directive);
+
+			if (preprocessor->conditions.count <= conditions_base)
+			{
+				log_preprocessor_error_and_exit(mirac_token_get_location(directive), "encountered '#else' without matching '#ifdef' or '#ifndef'.");
+			}
+
+			mirac_preprocessor_condition_s* const condition = &preprocessor->conditions.data[preprocessor->conditions.count - 1];
+
+			if (condition->has_else)
+			{
+				log_preprocessor_error_and_exit(mirac_token_get_location(directive), "encountered duplicate '#else' of the same conditional directive.");
+			}
+
+			condition->has_else = true;
+			condition->is_active = condition->is_parent_active && !condition->is_taken;
+			condition->is_taken = true;
+		} break;
+
+		case mirac_token_type_directive_endif:
+		{
+			expect_directive_end(preprocessor, directive);
+
+			if (preprocessor->conditions.count <= conditions_base)
+			{
+				log_preprocessor_error_and_exit(mirac_token_get_location(directive), "encountered '#endif' without matching '#ifdef' or '#ifndef'.");
+			}
+
+			mirac_preprocessor_condition_s popped_condition = {0};
+			(void)mirac_preprocessor_condition_list_pop(&preprocessor->conditions, &popped_condition);
+		} break;
+
+		default:
+		{
+			mirac_debug_assert(0); // note: should never reach this block.
+		} break;
+	}
+}
@@ -0,0 +1,451 @@
+/**
+ * @file profiler.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-03-23
+ */
+
+#include <mirac/profiler.h>
+
+#include <mirac/debug.h>
+#include <mirac/logger.h>
+
+#include <unistd.h>
+
+mirac_implement_heap_array_type(mirac_profiler_span_list, mirac_profiler_span_s);
+
+static mirac_string_view_s g_phases[mirac_profiler_phases_count] =
+{
+	[mirac_profiler_phase_lex]     = mirac_string_view_static("lex"),
+	[mirac_profiler_phase_parse]   = mirac_string_view_static("parse"),
+	[mirac_profiler_phase_resolve] = mirac_string_view_static("resolve"),
+	[mirac_profiler_phase_codegen] = mirac_string_view_static("codegen"),
+	[mirac_profiler_phase_write]   = mirac_string_view_static("write"),
+};
+
+static uint64_t g_threads_count = 0;
+static _Thread_local uint64_t g_thread_id = 0;
+
+/**
+ * @brief Read the clock (in nanoseconds).
+ * 
+ * @param clock clock to read
+ * 
+ * @return uint64_t
+ */
+static uint64_t read_clock(
+	const clockid_t clock);
+
+/**
+ * @brief Get the id of the calling thread in the trace (assigned on first use,
+ * starting from 1).
+ * 
+ * @return uint64_t
+ */
+static uint64_t get_thread_id(
+	void);
+
+/**
+ * @brief Check if the phase is one of the interleaved lex, parse, and resolve
+ * phases.
+ * 
+ * @param phase phase to check
+ * 
+ * @return bool_t
+ */
+static bool_t is_front_phase(
+	const mirac_profiler_phase_e phase);
+
+/**
+ * @brief Split the cpu time spent in the interleaved phases since the unit
+ * entered them by their wall times.
+ * 
+ * @param unit     unit timeline
+ * @param cpu_time cpu time to split
+ */
+static void split_front_phases_cpu_time(
+	mirac_profiler_unit_s* const unit,
+	const uint64_t cpu_time);
+
+/**
+ * @brief Write the string into the file as a json string.
+ * 
+ * @param file   file to write into
+ * @param string string to write
+ */
+static void write_json_string(
+	mirac_file_t* const file,
+	const mirac_string_view_s string);
+
+/**
+ * @brief Convert nanoseconds into milliseconds.
+ * 
+ * @param time time in nanoseconds
+ * 
+ * @return double
+ */
+static double to_milliseconds(
+	const uint64_t time);
+
+mirac_string_view_s mirac_profiler_phase_to_string_view(
+	const mirac_profiler_phase_e phase)
+{
+	mirac_debug_assert((phase >= 0) && (phase < mirac_profiler_phases_count));
+	return g_phases[phase];
+}
+
+mirac_profiler_s mirac_profiler_from_parts(
+	mirac_arena_s* const arena,
+	const bool_t is_tracing,
+	const bool_t are_units_parallel)
+{
+	mirac_debug_assert(arena != mirac_null);
+
+	pthread_mutex_t* const mutex = (pthread_mutex_t*)mirac_arena_malloc(arena, sizeof(pthread_mutex_t));
+
+	if (pthread_mutex_init(mutex, mirac_null) != 0)
+	{
+		mirac_logger_error("internal failure -- failed to create profiler mutex.");
+		mirac_c_exit(-1);
+	}
+
+	return (mirac_profiler_s)
+	{
+		.arena          = arena,
+		.cpu_clock      = are_units_parallel ? CLOCK_THREAD_CPUTIME_ID : CLOCK_PROCESS_CPUTIME_ID,
+		.mutex          = mutex,
+		.is_tracing     = is_tracing,
+		.spans          = mirac_profiler_span_list_from_parts(arena, 0),
+		.begin_time     = mirac_profiler_now(),
+		.begin_cpu_time = read_clock(CLOCK_PROCESS_CPUTIME_ID),
+		.wall_times     = {0},
+		.cpu_times      = {0},
+		.units_count    = 0
+	};
+}
+
+void mirac_profiler_destroy(
+	mirac_profiler_s* const profiler)
+{
+	mirac_debug_assert(profiler != mirac_null);
+	mirac_debug_assert(profiler->mutex != mirac_null);
+	(void)pthread_mutex_destroy(profiler->mutex);
+	*profiler = (mirac_profiler_s) {0};
+}
+
+uint64_t mirac_profiler_now(
+	void)
+{
+	return read_clock(CLOCK_MONOTONIC);
+}
+
+void mirac_profiler_record_span(
+	mirac_profiler_s* const profiler,
+	const char_t* const category,
+	const mirac_string_view_s name,
+	const uint64_t begin_time)
+{
+	mirac_debug_assert(profiler != mirac_null);
+	mirac_debug_assert(category != mirac_null);
+
+	if (!profiler->is_tracing)
+	{
+		return;
+	}
+
+	const uint64_t end_time = mirac_profiler_now();
+	const uint64_t thread_id = get_thread_id();
+
+	(void)pthread_mutex_lock(profiler->mutex);
+
+	char_t* const name_data = (char_t*)mirac_arena_malloc(profiler->arena, name.length + 1);
+	mirac_c_memcpy(name_data, name.data, name.length);
+	name_data[name.length] = '\0';
+
+	mirac_profiler_span_list_push(&profiler->spans, (mirac_profiler_span_s)
+	{
+		.name       = mirac_string_view_from_parts(name_data, name.length),
+		.category   = category,
+		.begin_time = begin_time,
+		.end_time   = end_time,
+		.thread_id  = thread_id
+	});
+
+	(void)pthread_mutex_unlock(profiler->mutex);
+}
+
+void mirac_profiler_print_report(
+	mirac_profiler_s* const profiler)
+{
+	mirac_debug_assert(profiler != mirac_null);
+
+	const uint64_t run_wall_time = mirac_profiler_now() - profiler->begin_time;
+	const uint64_t run_cpu_time = read_clock(CLOCK_PROCESS_CPUTIME_ID) - profiler->begin_cpu_time;
+	uint64_t total_wall_time = 0;
+	uint64_t total_cpu_time = 0;
+
+	mirac_logger_info("time report of %lu unit(s):", profiler->units_count);
+	mirac_logger_log("    %-10s %12s %12s", "phase", "wall (ms)", "cpu (ms)");
+
+	for (uint64_t phase_index = 0; phase_index < mirac_profiler_phases_count; ++phase_index)
+	{
+		mirac_logger_log("    %-10.*s %12.3f %12.3f",
+			mirac_sv_arg(g_phases[phase_index]),
+			to_milliseconds(profiler->wall_times[phase_index]),
+			to_milliseconds(profiler->cpu_times[phase_index]));
+		total_wall_time += profiler->wall_times[phase_index];
+		total_cpu_time += profiler->cpu_times[phase_index];
+	}
+
+	// note: the total sums up the units, which overlap if they are compiled in
+	//       parallel, while the run is the whole compilation as it was observed.
+	mirac_logger_log("    %-10s %12.3f %12.3f", "total", to_milliseconds(total_wall_time), to_milliseconds(total_cpu_time));
+	mirac_logger_log("    %-10s %12.3f %12.3f", "run", to_milliseconds(run_wall_time), to_milliseconds(run_cpu_time));
+}
+
+bool_t mirac_profiler_write_trace(
+	mirac_profiler_s* const profiler,
+	const mirac_string_view_s path)
+{
+	mirac_debug_assert(profiler != mirac_null);
+
+	mirac_file_t* const file = fopen(path.data, "wt");
+
+	if (mirac_null == file)
+	{
+		mirac_logger_error("unable to open " mirac_sv_fmt " for writing -- failed to open.", mirac_sv_arg(path));
+		return false;
+	}
+
+	const long process_id = (long)getpid();
+	(void)fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	(void)fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%ld,\"tid\":0,\"args\":{\"name\":\"mirac\"}}", process_id);
+
+	for (uint64_t span_index = 0; span_index < profiler->spans.count; ++span_index)
+	{
+		const mirac_profiler_span_s* const span = &profiler->spans.data[span_index];
+		const uint64_t begin_time = span->begin_time - profiler->begin_time;
+		const uint64_t duration = span->end_time - span->begin_time;
+
+		// note: the timestamps are in microseconds, with nanoseconds as fraction.
+		(void)fprintf(file, ",\n{\"name\":");
+		write_json_string(file, span->name);
+		(void)fprintf(file, ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%lu.%03lu,\"dur\":%lu.%03lu,\"pid\":%ld,\"tid\":%lu}",
+			span->category, begin_time / 1000, begin_time % 1000, duration / 1000, duration % 1000,
+			process_id, span->thread_id);
+	}
+
+	(void)fprintf(file, "\n]}\n");
+	const bool_t has_failed = (ferror(file) != 0);
+
+	if ((fclose(file) != 0) || has_failed)
+	{
+		mirac_logger_error("unable to write " mirac_sv_fmt " -- failed to write.", mirac_sv_arg(path));
+		return false;
+	}
+
+	return true;
+}
+
+mirac_profiler_unit_s mirac_profiler_unit_begin(
+	mirac_profiler_s* const profiler,
+	const mirac_string_view_s name)
+{
+	mirac_debug_assert(profiler != mirac_null);
+
+	const uint64_t begin_time = mirac_profiler_now();
+
+	return (mirac_profiler_unit_s)
+	{
+		.profiler           = profiler,
+		.name               = name,
+		.phase              = mirac_profiler_phase_lex,
+		.begin_time         = begin_time,
+		.phase_time         = begin_time,
+		.cpu_time           = read_clock(profiler->cpu_clock),
+		.segment_wall_times = {0},
+		.wall_times         = {0},
+		.cpu_times          = {0}
+	};
+}
+
+mirac_profiler_phase_e mirac_profiler_unit_switch_phase(
+	mirac_profiler_unit_s* const unit,
+	const mirac_profiler_phase_e phase)
+{
+	mirac_debug_assert(unit != mirac_null);
+	mirac_debug_assert(unit->profiler != mirac_null);
+
+	const mirac_profiler_phase_e previous_phase = unit->phase;
+
+	if (phase == previous_phase)
+	{
+		return previous_phase;
+	}
+
+	const uint64_t time = mirac_profiler_now();
+
+	if (previous_phase != mirac_profiler_phase_none)
+	{
+		unit->wall_times[previous_phase] += time - unit->phase_time;
+	}
+
+	unit->phase = phase;
+	unit->phase_time = time;
+
+	// note: the cpu clocks are a lot slower to read than the monotonic one, so
+	//       they are not read in between the interleaved phases, which switch
+	//       a couple of times per token.
+	if (is_front_phase(previous_phase) && is_front_phase(phase))
+	{
+		return previous_phase;
+	}
+
+	const uint64_t cpu_time = read_clock(unit->profiler->cpu_clock);
+
+	if (is_front_phase(previous_phase))
+	{
+		split_front_phases_cpu_time(unit, cpu_time - unit->cpu_time);
+	}
+	else if (previous_phase != mirac_profiler_phase_none)
+	{
+		unit->cpu_times[previous_phase] += cpu_time - unit->cpu_time;
+	}
+
+	if (is_front_phase(phase))
+	{
+		mirac_c_memcpy(unit->segment_wall_times, unit->wall_times, sizeof(unit->wall_times));
+	}
+
+	unit->cpu_time = cpu_time;
+	return previous_phase;
+}
+
+void mirac_profiler_unit_end(
+	mirac_profiler_unit_s* const unit)
+{
+	mirac_debug_assert(unit != mirac_null);
+	mirac_debug_assert(unit->profiler != mirac_null);
+
+	(void)mirac_profiler_unit_switch_phase(unit, mirac_profiler_phase_none);
+	mirac_profiler_s* const profiler = unit->profiler;
+	mirac_profiler_record_span(profiler, "unit", unit->name, unit->begin_time);
+
+	(void)pthread_mutex_lock(profiler->mutex);
+
+	for (uint64_t phase_index = 0; phase_index < mirac_profiler_phases_count; ++phase_index)
+	{
+		profiler->wall_times[phase_index] += unit->wall_times[phase_index];
+		profiler->cpu_times[phase_index] += unit->cpu_times[phase_index];
+	}
+
+	++profiler->units_count;
+	(void)pthread_mutex_unlock(profiler->mutex);
+}
+
+static uint64_t read_clock(
+	const clockid_t clock)
+{
+	struct timespec time = {0};
+	(void)clock_gettime(clock, &time);
+	return ((uint64_t)time.tv_sec * 1000000000) + (uint64_t)time.tv_nsec;
+}
+
+static uint64_t get_thread_id(
+	void)
+{
+	if (0 == g_thread_id)
+	{
+		g_thread_id = __atomic_add_fetch(&g_threads_count, 1, __ATOMIC_RELAXED);
+	}
+
+	return g_thread_id;
+}
+
+static bool_t is_front_phase(
+	const mirac_profiler_phase_e phase)
+{
+	return (mirac_profiler_phase_lex == phase) ||
+		(mirac_profiler_phase_parse == phase) ||
+		(mirac_profiler_phase_resolve == phase);
+}
+
+static void split_front_phases_cpu_time(
+	mirac_profiler_unit_s* const unit,
+	const uint64_t cpu_time)
+{
+	mirac_debug_assert(unit != mirac_null);
+
+	const mirac_profiler_phase_e phases[] =
+	{
+		mirac_profiler_phase_lex,
+		mirac_profiler_phase_parse,
+		mirac_profiler_phase_resolve
+	};
+
+	const uint64_t phases_count = sizeof(phases) / sizeof(phases[0]);
+	uint64_t segment_wall_time = 0;
+
+	for (uint64_t phase_index = 0; phase_index < phases_count; ++phase_index)
+	{
+		segment_wall_time += unit->wall_times[phases[phase_index]] - unit->segment_wall_times[phases[phase_index]];
+	}
+
+	if (segment_wall_time <= 0)
+	{
+		return;
+	}
+
+	uint64_t remaining_cpu_time = cpu_time;
+
+	for (uint64_t phase_index = 0; phase_index < phases_count; ++phase_index)
+	{
+		const mirac_profiler_phase_e phase = phases[phase_index];
+		const uint64_t wall_time = unit->wall_times[phase] - unit->segment_wall_times[phase];
+
+		// note: the last phase takes whatever is left after the rounding.
+		const uint64_t share = ((phase_index + 1) == phases_count) ? remaining_cpu_time :
+			(uint64_t)((double)cpu_time * ((double)wall_time / (double)segment_wall_time));
+
+		unit->cpu_times[phase] += share;
+		remaining_cpu_time -= share;
+	}
+}
+
+static void write_json_string(
+	mirac_file_t* const file,
+	const mirac_string_view_s string)
+{
+	mirac_debug_assert(file != mirac_null);
+	(void)fputc('"', file);
+
+	for (uint64_t char_index = 0; char_index < string.length; ++char_index)
+	{
+		const char_t character = string.data[char_index];
+
+		if (('"' == character) || ('\\' == character))
+		{
+			(void)fprintf(file, "\\%c", character);
+		}
+		else if ((uint8_t)character < 0x20)
+		{
+			(void)fprintf(file, "\\u%04x", (uint32_t)(uint8_t)character);
+		}
+		else
+		{
+			(void)fputc(character, file);
+		}
+	}
+
+	(void)fputc('"', file);
+}
+
+static double to_milliseconds(
+	const uint64_t time)
+{
+	return (double)time / 1000000.0;
+}
@@ -0,0 +1,1232 @@
+/**
+ * @file server.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-03-16
+ */
+
+#include <mirac/server.h>
+
+#include <mirac/debug.h>
+#include <mirac/logger.h>
+#include <mirac/emitter.h>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/un.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+
+mirac_implement_symbol_table_type(mirac_server_unit_table, mirac_server_unit_s*);
+
+/**
+ * @brief Magic number at the start of every request ("mirac$rq").
+ */
+#define request_magic ((uint64_t)0x7172246361726963)
+
+/**
+ * @brief Upper limits of a request, which protect the server from malformed
+ * requests.
+ */
+#define request_max_arguments_count ((uint64_t)65536)
+#define request_max_argument_length ((uint64_t)65536)
+
+typedef struct
+{
+	uint64_t magic;
+	uint64_t directory_length;
+	uint64_t arguments_count;
+} request_header_s;
+
+typedef struct
+{
+	uint64_t key_lanes[2];
+	uint64_t output_size;
+	uint64_t output_modification_time;
+	uint64_t output_path_length;
+	uint64_t inputs_count;
+} report_unit_header_s;
+
+typedef struct
+{
+	uint64_t size;
+	uint64_t modification_time;
+	uint64_t path_length;
+} report_input_header_s;
+
+/**
+ * @brief Running request of the server.
+ * 
+ * The report holds the records of the units compiled by the request, which are
+ * read from the request's process while it runs.
+ */
+typedef struct
+{
+	pid_t pid;
+	int32_t report_descriptor;
+	int32_t client_descriptor; // note: -1 for the requests of the watch.
+	uint8_t* report;
+	uint64_t report_length;
+	uint64_t report_capacity;
+} request_s;
+
+static volatile sig_atomic_t g_is_stopping = 0;
+
+/**
+ * @brief Request the server to stop (signal handler of SIGINT and SIGTERM).
+ * 
+ * @param signal_number number of the received signal
+ */
+static void handle_stop_signal(
+	int signal_number);
+
+/**
+ * @brief Install the stop signal handlers and ignore SIGPIPE, so that a client
+ * which disconnects early does not kill the server.
+ */
+static void install_signal_handlers(
+	void);
+
+/**
+ * @brief Make the path absolute by prefixing it with the working directory (if
+ * it is relative).
+ * 
+ * @param path          path to make absolute
+ * @param absolute_path buffer of at least PATH_MAX chars for the absolute path
+ * 
+ * @return bool_t
+ */
+static bool_t make_absolute_path(
+	const mirac_string_view_s path,
+	char_t* const absolute_path);
+
+/**
+ * @brief Read exactly the provided number of bytes from the descriptor.
+ * 
+ * @param descriptor descriptor to read from
+ * @param data       buffer to read into
+ * @param length     number of bytes to read
+ * 
+ * @return bool_t
+ */
+static bool_t read_all(
+	const int32_t descriptor,
+	void* const data,
+	const uint64_t length);
+
+/**
+ * @brief Write all the bytes into the descriptor, retrying partial writes.
+ * 
+ * @param descriptor descriptor to write into
+ * @param data       bytes to write
+ * @param length     number of bytes to write
+ * 
+ * @return bool_t
+ */
+static bool_t write_all(
+	const int32_t descriptor,
+	const void* const data,
+	const uint64_t length);
+
+/**
+ * @brief Compile the command line in the process of a request (never returns).
+ * 
+ * @param server             server instance
+ * @param directory          working directory of the request (or mirac_null)
+ * @param argc               command line arguments count
+ * @param argv               command line arguments pointer
+ * @param output_descriptors stdout and stderr of the request (or -1s)
+ * @param report_descriptor  descriptor to report the compiled units into
+ */
+static void run_request_process(
+	mirac_server_s* const server,
+	const char_t* const directory,
+	const int32_t argc,
+	const char_t** const argv,
+	const int32_t output_descriptors[2],
+	const int32_t report_descriptor);
+
+/**
+ * @brief Start the request in a new process.
+ * 
+ * @param server             server instance
+ * @param directory          working directory of the request (or mirac_null)
+ * @param argc               command line arguments count
+ * @param argv               command line arguments pointer
+ * @param output_descriptors stdout and stderr of the request (or -1s)
+ * @param request            request to start
+ * 
+ * @return bool_t
+ */
+static bool_t start_request(
+	mirac_server_s* const server,
+	const char_t* const directory,
+	const int32_t argc,
+	const char_t** const argv,
+	const int32_t output_descriptors[2],
+	request_s* const request);
+
+/**
+ * @brief Read the available part of the request's report.
+ * 
+ * @param request request to read the report of
+ * 
+ * @return bool_t (false once the whole report was read)
+ */
+static bool_t read_request_report(
+	request_s* const request);
+
+/**
+ * @brief Wait for the request's process to end, take over the records of the
+ * units it compiled, and release the request.
+ * 
+ * @param server  server instance
+ * @param request request to finish
+ * 
+ * @return int32_t
+ */
+static int32_t finish_request(
+	mirac_server_s* const server,
+	request_s* const request);
+
+/**
+ * @brief Update the unit records from the report and lex the included files of
+ * the units into the preprocessor cache.
+ * 
+ * @param server server instance
+ * @param report report of a request
+ * @param length length of the report
+ */
+static void take_over_report(
+	mirac_server_s* const server,
+	const uint8_t* const report,
+	const uint64_t length);
+
+/**
+ * @brief Lex the included files of the first units of the report into the
+ * preprocessor cache.
+ * 
+ * @param server      server instance
+ * @param report      report of a request
+ * @param units_count number of the (valid) units at the start of the report
+ */
+static void preload_included_files(
+	mirac_server_s* const server,
+	const uint8_t* const report,
+	const uint64_t units_count);
+
+/**
+ * @brief Receive the request of the client and start it.
+ * 
+ * @param server            server instance
+ * @param client_descriptor socket of the client
+ * @param request           request to start
+ * 
+ * @return bool_t
+ */
+static bool_t receive_request(
+	mirac_server_s* const server,
+	const int32_t client_descriptor,
+	request_s* const request);
+
+/**
+ * @brief Check if any src+out file changed since it was stamped, or any included
+ * file changed since it was last lexed.
+ * 
+ * @param server             server instance
+ * @param source_files       src+out file paths
+ * @param source_files_count number of src+out file paths
+ * @param stamps             stamps of the src+out files
+ * 
+ * @return bool_t
+ */
+static bool_t has_any_pair_changed(
+	mirac_server_s* const server,
+	const char_t** const source_files,
+	const uint64_t source_files_count,
+	const mirac_preprocessor_file_stamp_s* const stamps);
+
+mirac_server_s mirac_server_from_parts(
+	mirac_config_s* const config,
+	mirac_arena_s* const arena,
+	mirac_preprocessor_cache_s* const preprocessor_cache,
+	const mirac_server_compile_t compile)
+{
+	mirac_debug_assert(config != mirac_null);
+	mirac_debug_assert(arena != mirac_null);
+	mirac_debug_assert(preprocessor_cache != mirac_null);
+	mirac_debug_assert(compile != mirac_null);
+
+	mirac_interner_s* const interner = (mirac_interner_s*)mirac_arena_malloc(arena, sizeof(mirac_interner_s));
+	*interner = mirac_interner_from_parts(arena);
+
+	pthread_mutex_t* const mutex = (pthread_mutex_t*)mirac_arena_malloc(arena, sizeof(pthread_mutex_t));
+
+	if (pthread_mutex_init(mutex, mirac_null) != 0)
+	{
+		mirac_logger_error("internal failure -- failed to create server mutex.");
+		mirac_c_exit(-1);
+	}
+
+	return (mirac_server_s)
+	{
+		.config               = config,
+		.arena                = arena,
+		.interner             = interner,
+		.preprocessor_cache   = preprocessor_cache,
+		.compile              = compile,
+		.units                = mirac_server_unit_table_from_parts(arena, interner),
+		.mutex                = mutex,
+		.report_descriptor    = -1,
+		.requests_count       = 0,
+		.compiled_units_count = 0
+	};
+}
+
+void mirac_server_destroy(
+	mirac_server_s* const server)
+{
+	mirac_debug_assert(server != mirac_null);
+	mirac_debug_assert(server->mutex != mirac_null);
+	(void)pthread_mutex_destroy(server->mutex);
+	*server = (mirac_server_s) {0};
+}
+
+int32_t mirac_server_serve(
+	mirac_server_s* const server,
+	const mirac_string_view_s socket_path)
+{
+	mirac_debug_assert(server != mirac_null);
+	mirac_debug_assert(server->config != mirac_null);
+
+	struct sockaddr_un address = {0};
+	address.sun_family = AF_UNIX;
+
+	if (socket_path.length >= sizeof(address.sun_path))
+	{
+		mirac_logger_error("unable to serve on " mirac_sv_fmt " -- path is too long.", mirac_sv_arg(socket_path));
+		return -1;
+	}
+
+	mirac_c_memcpy(address.sun_path, socket_path.data, socket_path.length);
+	const int32_t listen_descriptor = (int32_t)socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+	if (listen_descriptor < 0)
+	{
+		mirac_logger_error("unable to serve on " mirac_sv_fmt " -- failed to create socket.", mirac_sv_arg(socket_path));
+		return -1;
+	}
+
+	// note: a socket file left behind by a server that did not exit cleanly is
+	//       replaced, while a socket with a live server behind it is not.
+	int32_t probe_result = -1;
+	const int32_t probe_descriptor = (int32_t)socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+	if (probe_descriptor >= 0)
+	{
+		probe_result = (int32_t)connect(probe_descriptor, (const struct sockaddr*)&address, sizeof(address));
+		(void)close(probe_descriptor);
+	}
+
+	if (0 == probe_result)
+	{
+		mirac_logger_error("unable to serve on " mirac_sv_fmt " -- another server is listening on it.", mirac_sv_arg(socket_path));
+		(void)close(listen_descriptor);
+		return -1;
+	}
+
+	(void)unlink(address.sun_path);
+
+	// note: requests run with the permissions of the server, so only the user of
+	//       the server may connect to it.
+	const mode_t previous_mask = umask(0177);
+	const bool_t is_bound = 0 == bind(listen_descriptor, (const struct sockaddr*)&address, sizeof(address));
+	(void)umask(previous_mask);
+
+	if (!is_bound || (listen(listen_descriptor, SOMAXCONN) != 0))
+	{
+		mirac_logger_error("unable to serve on " mirac_sv_fmt " -- failed to bind or listen.", mirac_sv_arg(socket_path));
+		(void)close(listen_descriptor);
+		return -1;
+	}
+
+	install_signal_handlers();
+	mirac_logger_info("serving compile requests on " mirac_sv_fmt ".", mirac_sv_arg(socket_path));
+
+	const uint64_t max_requests_count = server->config->jobs;
+	request_s* const requests = (request_s*)mirac_c_malloc(max_requests_count * sizeof(request_s));
+	struct pollfd* const polled = (struct pollfd*)mirac_c_malloc((max_requests_count + 1) * sizeof(struct pollfd));
+	uint64_t requests_count = 0;
+
+	// note: once stopping, no new requests are accepted, but the running ones are
+	//       still finished and replied to.
+	while (!g_is_stopping || (requests_count > 0))
+	{
+		const bool_t is_accepting = !g_is_stopping && (requests_count < max_requests_count);
+		polled[0] = (struct pollfd) { .fd = is_accepting ? listen_descriptor : -1, .events = POLLIN, .revents = 0 };
+
+		for (uint64_t request_index = 0; request_index < requests_count; ++request_index)
+		{
+			polled[request_index + 1] = (struct pollfd)
+			{
+				.fd      = requests[request_index].report_descriptor,
+				.events  = POLLIN,
+				.revents = 0
+			};
+		}
+
+		if (poll(polled, (nfds_t)(requests_count + 1), -1) < 0)
+		{
+			if (EINTR == errno)
+			{
+				continue;
+			}
+
+			mirac_logger_error("internal failure -- failed to poll the server's sockets.");
+			break;
+		}
+
+		// note: finished requests are replaced by the last one, so the requests are
+		//       visited from the last one down.
+		for (uint64_t request_index = requests_count; request_index > 0; --request_index)
+		{
+			request_s* const request = &requests[request_index - 1];
+
+			if ((0 == polled[request_index].revents) || read_request_report(request))
+			{
+				continue;
+			}
+
+			const int32_t client_descriptor = request->client_descriptor;
+			const int32_t exit_code = finish_request(server, request);
+			(void)send(client_descriptor, &exit_code, sizeof(exit_code), MSG_NOSIGNAL);
+			(void)close(client_descriptor);
+			*request = requests[--requests_count];
+		}
+
+		if (polled[0].revents & POLLIN)
+		{
+			const int32_t client_descriptor = (int32_t)accept(listen_descriptor, mirac_null, mirac_null);
+
+			if ((client_descriptor >= 0) && receive_request(server, client_descriptor, &requests[requests_count]))
+			{
+				++requests_count;
+			}
+			else if (client_descriptor >= 0)
+			{
+				const int32_t exit_code = -1;
+				(void)send(client_descriptor, &exit_code, sizeof(exit_code), MSG_NOSIGNAL);
+				(void)close(client_descriptor);
+			}
+		}
+	}
+
+	(void)close(listen_descriptor);
+	(void)unlink(address.sun_path);
+	mirac_c_free(requests);
+	mirac_c_free(polled);
+
+	mirac_logger_info("served %lu requests, %lu units compiled.", server->requests_count, server->compiled_units_count);
+	return 0;
+}
+
+int32_t mirac_server_watch(
+	mirac_server_s* const server,
+	const int32_t argc,
+	const char_t** const argv,
+	const char_t** const source_files,
+	const uint64_t source_files_count)
+{
+	mirac_debug_assert(server != mirac_null);
+	mirac_debug_assert(argv != mirac_null);
+	mirac_debug_assert(source_files != mirac_null);
+	mirac_debug_assert((source_files_count > 0) && (0 == (source_files_count % 2)));
+
+	install_signal_handlers();
+
+	const uint64_t pairs_count = source_files_count / 2;
+	mirac_preprocessor_file_stamp_s* const stamps = (mirac_preprocessor_file_stamp_s*)mirac_c_malloc(
+		source_files_count * sizeof(mirac_preprocessor_file_stamp_s));
+	const int32_t output_descriptors[2] = { -1, -1 };
+	int32_t exit_code = 0;
+
+	while (!g_is_stopping)
+	{
+		// note: the sources are stamped before they are compiled, so a source that
+		//       is modified during the compilation triggers another one.
+		for (uint64_t pair_index = 0; pair_index < pairs_count; ++pair_index)
+		{
+			stamps[pair_index * 2] = (mirac_preprocessor_file_stamp_s) {0};
+			(void)mirac_preprocessor_file_stamp_from_path(source_files[pair_index * 2], &stamps[pair_index * 2]);
+		}
+
+		request_s request = {0};
+
+		if (!start_request(server, mirac_null, argc, argv, output_descriptors, &request))
+		{
+			exit_code = -1;
+			break;
+		}
+
+		while (read_request_report(&request));
+		exit_code = finish_request(server, &request);
+
+		// note: the outputs are stamped after they are compiled, since a failed
+		//       compilation leaves its output truncated.
+		for (uint64_t pair_index = 0; pair_index < pairs_count; ++pair_index)
+		{
+			stamps[(pair_index * 2) + 1] = (mirac_preprocessor_file_stamp_s) {0};
+			(void)mirac_preprocessor_file_stamp_from_path(source_files[(pair_index * 2) + 1], &stamps[(pair_index * 2) + 1]);
+		}
+
+		mirac_logger_info("compilation finished with exit code %d, watching %lu src+out pairs for changes.",
+			exit_code, pairs_count);
+		const struct timespec interval = { .tv_sec = 0, .tv_nsec = mirac_server_watch_interval * 1000000 };
+
+		while (!g_is_stopping && !has_any_pair_changed(server, source_files, source_files_count, stamps))
+		{
+			(void)nanosleep(&interval, mirac_null);
+		}
+	}
+
+	mirac_c_free(stamps);
+	return exit_code;
+}
+
+bool_t mirac_server_forward(
+	const mirac_string_view_s socket_path,
+	const int32_t argc,
+	const char_t** const argv,
+	int32_t* const exit_code)
+{
+	mirac_debug_assert(argc > 0);
+	mirac_debug_assert(argv != mirac_null);
+	mirac_debug_assert(exit_code != mirac_null);
+
+	struct sockaddr_un address = {0};
+	address.sun_family = AF_UNIX;
+	char_t directory[PATH_MAX] = {0};
+
+	if ((socket_path.length >= sizeof(address.sun_path)) || (mirac_null == getcwd(directory, sizeof(directory))))
+	{
+		return false;
+	}
+
+	mirac_c_memcpy(address.sun_path, socket_path.data, socket_path.length);
+	const int32_t descriptor = (int32_t)socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+	if ((descriptor < 0) || (connect(descriptor, (const struct sockaddr*)&address, sizeof(address)) != 0))
+	{
+		if (descriptor >= 0)
+		{
+			(void)close(descriptor);
+		}
+
+		return false;
+	}
+
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_emitter_s message = mirac_emitter_from_parts(&arena, mirac_null);
+
+	const request_header_s header = (request_header_s)
+	{
+		.magic            = request_magic,
+		.directory_length = mirac_c_strlen(directory),
+		.arguments_count  = (uint64_t)argc
+	};
+
+	mirac_emitter_emit(&message, directory, header.directory_length);
+
+	for (int32_t argument_index = 0; argument_index < argc; ++argument_index)
+	{
+		const uint64_t argument_length = mirac_c_strlen(argv[argument_index]);
+		mirac_emitter_emit(&message, (const char_t*)&argument_length, sizeof(argument_length));
+		mirac_emitter_emit(&message, argv[argument_index], argument_length);
+	}
+
+	// note: the server's request writes straight into this process's stdout and
+	//       stderr, which are passed along with the header.
+	const int32_t output_descriptors[2] = { STDOUT_FILENO, STDERR_FILENO };
+	char_t control[CMSG_SPACE(sizeof(output_descriptors))] = {0};
+	struct iovec header_vector = { .iov_base = (void*)&header, .iov_len = sizeof(header) };
+	struct msghdr header_message = {0};
+	header_message.msg_iov = &header_vector;
+	header_message.msg_iovlen = 1;
+	header_message.msg_control = control;
+	header_message.msg_controllen = sizeof(control);
+
+	struct cmsghdr* const control_header = CMSG_FIRSTHDR(&header_message);
+	control_header->cmsg_level = SOL_SOCKET;
+	control_header->cmsg_type = SCM_RIGHTS;
+	control_header->cmsg_len = CMSG_LEN(sizeof(output_descriptors));
+	mirac_c_memcpy(CMSG_DATA(control_header), output_descriptors, sizeof(output_descriptors));
+
+	(void)fflush(stdout);
+	(void)fflush(stderr);
+
+	// note: if the request could not be sent, the server never started it, so the
+	//       caller can safely compile by itself.
+	if ((sendmsg(descriptor, &header_message, MSG_NOSIGNAL) != (ssize_t)sizeof(header)) ||
+		!write_all(descriptor, message.data, message.length))
+	{
+		mirac_arena_destroy(&arena);
+		(void)close(descriptor);
+		return false;
+	}
+
+	mirac_arena_destroy(&arena);
+
+	if (!read_all(descriptor, exit_code, sizeof(*exit_code)))
+	{
+		mirac_logger_error("lost connection to the compile server on " mirac_sv_fmt ".", mirac_sv_arg(socket_path));
+		*exit_code = -1;
+	}
+
+	(void)close(descriptor);
+	return true;
+}
+
+bool_t mirac_server_is_unit_up_to_date(
+	mirac_server_s* const server,
+	const mirac_cache_key_s* const key,
+	const mirac_string_view_s output_file_path)
+{
+	mirac_debug_assert(server != mirac_null);
+	mirac_debug_assert(key != mirac_null);
+
+	char_t path[PATH_MAX] = {0};
+
+	if (!make_absolute_path(output_file_path, path))
+	{
+		return false;
+	}
+
+	// note: the jobs of a request may check their units in parallel, while the
+	//       interner is not thread safe.
+	(void)pthread_mutex_lock(server->mutex);
+	const mirac_symbol_t symbol = mirac_interner_intern(server->interner, mirac_string_view_from_cstring(path));
+	mirac_server_unit_s* unit = mirac_null;
+	mirac_preprocessor_file_stamp_s stamp = {0};
+
+	bool_t is_up_to_date = mirac_server_unit_table_find(&server->units, symbol, &unit) &&
+		(unit->key.lanes[0] == key->lanes[0]) && (unit->key.lanes[1] == key->lanes[1]) &&
+		mirac_preprocessor_file_stamp_from_path(path, &stamp) &&
+		mirac_preprocessor_file_stamp_equal(stamp, unit->output_stamp);
+
+	for (uint64_t input_index = 0; is_up_to_date && (input_index < unit->inputs_count); ++input_index)
+	{
+		const mirac_string_view_s input_path = mirac_interner_get_string(server->interner, unit->inputs[input_index].path);
+		mirac_c_memcpy(path, input_path.data, input_path.length);
+		path[input_path.length] = '\0';
+
+		is_up_to_date = mirac_preprocessor_file_stamp_from_path(path, &stamp) &&
+			mirac_preprocessor_file_stamp_equal(stamp, unit->inputs[input_index].stamp);
+	}
+
+	(void)pthread_mutex_unlock(server->mutex);
+	return is_up_to_date;
+}
+
+void mirac_server_record_unit(
+	mirac_server_s* const server,
+	const mirac_cache_key_s* const key,
+	const mirac_string_view_s output_file_path,
+	const mirac_preprocessor_s* const preprocessor)
+{
+	mirac_debug_assert(server != mirac_null);
+	mirac_debug_assert(server->report_descriptor >= 0);
+	mirac_debug_assert(key != mirac_null);
+	mirac_debug_assert(preprocessor != mirac_null);
+
+	char_t path[PATH_MAX] = {0};
+	mirac_preprocessor_file_stamp_s output_stamp = {0};
+
+	if (!make_absolute_path(output_file_path, path) || !mirac_preprocessor_file_stamp_from_path(path, &output_stamp))
+	{
+		return;
+	}
+
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_emitter_s record = mirac_emitter_from_parts(&arena, mirac_null);
+
+	const report_unit_header_s unit_header = (report_unit_header_s)
+	{
+		.key_lanes                = { key->lanes[0], key->lanes[1] },
+		.output_size              = output_stamp.size,
+		.output_modification_time = output_stamp.modification_time,
+		.output_path_length       = mirac_c_strlen(path),
+		.inputs_count             = preprocessor->included_files.count
+	};
+
+	mirac_emitter_emit(&record, (const char_t*)&unit_header, sizeof(unit_header));
+	mirac_emitter_emit(&record, path, unit_header.output_path_length);
+
+	for (uint64_t file_index = 0; file_index < preprocessor->included_files.count; ++file_index)
+	{
+		const mirac_preprocessor_file_s* const file = preprocessor->included_files.data[file_index];
+		const report_input_header_s input_header = (report_input_header_s)
+		{
+			.size              = file->stamp.size,
+			.modification_time = file->stamp.modification_time,
+			.path_length       = file->path.length
+		};
+
+		mirac_emitter_emit(&record, (const char_t*)&input_header, sizeof(input_header));
+		mirac_emitter_emit_string_view(&record, file->path);
+	}
+
+	// note: a record is written as a whole, so the records of parallel jobs never
+	//       interleave.
+	(void)pthread_mutex_lock(server->mutex);
+	(void)write_all(server->report_descriptor, record.data, record.length);
+	(void)pthread_mutex_unlock(server->mutex);
+	mirac_arena_destroy(&arena);
+}
+
+static void handle_stop_signal(
+	int signal_number)
+{
+	(void)signal_number;
+	g_is_stopping = 1;
+}
+
+static void install_signal_handlers(
+	void)
+{
+	// note: the handlers are installed without SA_RESTART, so that a blocking poll
+	//       or sleep returns as soon as the server is asked to stop.
+	struct sigaction action = {0};
+	action.sa_handler = handle_stop_signal;
+	(void)sigemptyset(&action.sa_mask);
+	(void)sigaction(SIGINT, &action, mirac_null);
+	(void)sigaction(SIGTERM, &action, mirac_null);
+	(void)signal(SIGPIPE, SIG_IGN);
+}
+
+static bool_t make_absolute_path(
+	const mirac_string_view_s path,
+	char_t* const absolute_path)
+{
+	mirac_debug_assert(absolute_path != mirac_null);
+	uint64_t length = 0;
+
+	if ((path.length <= 0) || (path.data[0] != '/'))
+	{
+		if (mirac_null == getcwd(absolute_path, PATH_MAX))
+		{
+			return false;
+		}
+
+		length = mirac_c_strlen(absolute_path);
+		absolute_path[length++] = '/';
+	}
+
+	if ((length + path.length) >= PATH_MAX)
+	{
+		return false;
+	}
+
+	if (path.length > 0)
+	{
+		mirac_c_memcpy(absolute_path + length, path.data, path.length);
+	}
+
+	absolute_path[length + path.length] = '\0';
+	return true;
+}
+
+static bool_t read_all(
+	const int32_t descriptor,
+	void* const data,
+	const uint64_t length)
+{
+	uint8_t* bytes = (uint8_t*)data;
+	uint64_t remaining = length;
+
+	while (remaining > 0)
+	{
+		const int64_t received = (int64_t)read(descriptor, bytes, (size_t)remaining);
+
+		if (received <= 0)
+		{
+			if ((received < 0) && (EINTR == errno))
+			{
+				continue;
+			}
+
+			return false;
+		}
+
+		bytes += received;
+		remaining -= (uint64_t)received;
+	}
+
+	return true;
+}
+
+static bool_t write_all(
+	const int32_t descriptor,
+	const void* const data,
+	const uint64_t length)
+{
+	const uint8_t* bytes = (const uint8_t*)data;
+	uint64_t remaining = length;
+
+	while (remaining > 0)
+	{
+		const int64_t written = (int64_t)write(descriptor, bytes, (size_t)remaining);
+
+		if (written < 0)
+		{
+			if (EINTR == errno)
+			{
+				continue;
+			}
+
+			return false;
+		}
+
+		bytes += written;
+		remaining -= (uint64_t)written;
+	}
+
+	return true;
+}
+
+static void run_request_process(
+	mirac_server_s* const server,
+	const char_t* const directory,
+	const int32_t argc,
+	const char_t** const argv,
+	const int32_t output_descriptors[2],
+	const int32_t report_descriptor)
+{
+	mirac_debug_assert(server != mirac_null);
+	mirac_debug_assert(server->compile != mirac_null);
+	mirac_debug_assert(argv != mirac_null);
+
+	(void)signal(SIGINT, SIG_DFL);
+	(void)signal(SIGTERM, SIG_DFL);
+	(void)signal(SIGPIPE, SIG_DFL);
+
+	if (output_descriptors[0] >= 0)
+	{
+		(void)dup2(output_descriptors[0], STDOUT_FILENO);
+		(void)dup2(output_descriptors[1], STDERR_FILENO);
+		(void)close(output_descriptors[0]);
+		(void)close(output_descriptors[1]);
+	}
+
+	if ((directory != mirac_null) && (chdir(directory) != 0))
+	{
+		mirac_logger_error("unable to compile in '%s' -- failed to change the directory.", directory);
+		mirac_c_exit(-1);
+	}
+
+	server->report_descriptor = report_descriptor;
+
+	uint64_t options_index = 0;
+	mirac_config_s config = mirac_config_from_cli(argc, argv, &options_index);
+	const int32_t exit_code = server->compile(server, &config, argv + options_index, (uint64_t)argc - options_index);
+
+	(void)fflush(stdout);
+	(void)fflush(stderr);
+	mirac_c_exit(exit_code);
+}
+
+static bool_t start_request(
+	mirac_server_s* const server,
+	const char_t* const directory,
+	const int32_t argc,
+	const char_t** const argv,
+	const int32_t output_descriptors[2],
+	request_s* const request)
+{
+	mirac_debug_assert(server != mirac_null);
+	mirac_debug_assert(request != mirac_null);
+
+	// note: the requests must not reuse the tokens of files that changed since
+	//       they were lexed.
+	(void)mirac_preprocessor_cache_drop_changed_files(server->preprocessor_cache);
+
+	int32_t report_descriptors[2] = { -1, -1 };
+
+	if (pipe(report_descriptors) != 0)
+	{
+		mirac_logger_error("internal failure -- failed to create the report pipe of a request.");
+		return false;
+	}
+
+	(void)fflush(stdout);
+	(void)fflush(stderr);
+	const pid_t pid = fork();
+
+	if (0 == pid)
+	{
+		(void)close(report_descriptors[0]);
+		run_request_process(server, directory, argc, argv, output_descriptors, report_descriptors[1]);
+	}
+
+	(void)close(report_descriptors[1]);
+
+	if (pid < 0)
+	{
+		mirac_logger_error("internal failure -- failed to fork the process of a request.");
+		(void)close(report_descriptors[0]);
+		return false;
+	}
+
+	(void)fcntl(report_descriptors[0], F_SETFD, FD_CLOEXEC);
+	++server->requests_count;
+
+	*request = (request_s)
+	{
+		.pid               = pid,
+		.report_descriptor = report_descriptors[0],
+		.client_descriptor = -1,
+		.report            = mirac_null,
+		.report_length     = 0,
+		.report_capacity   = 0
+	};
+
+	return true;
+}
+
+static bool_t read_request_report(
+	request_s* const request)
+{
+	mirac_debug_assert(request != mirac_null);
+
+	if ((request->report_capacity - request->report_length) < 4096)
+	{
+		request->report_capacity = (request->report_capacity * 2) + 4096;
+		request->report = (uint8_t*)mirac_c_realloc(request->report, request->report_capacity);
+	}
+
+	const int64_t received = (int64_t)read(request->report_descriptor, request->report + request->report_length,
+		(size_t)(request->report_capacity - request->report_length));
+
+	if (received < 0)
+	{
+		return EINTR == errno;
+	}
+
+	request->report_length += (uint64_t)received;
+	return received > 0;
+}
+
+static int32_t finish_request(
+	mirac_server_s* const server,
+	request_s* const request)
+{
+	mirac_debug_assert(server != mirac_null);
+	mirac_debug_assert(request != mirac_null);
+
+	(void)close(request->report_descriptor);
+	int32_t status = 0;
+
+	while ((waitpid(request->pid, &status, 0) < 0) && (EINTR == errno));
+	int32_t exit_code = -1;
+
+	if (WIFEXITED(status))
+	{
+		exit_code = (int32_t)WEXITSTATUS(status);
+	}
+	else if (WIFSIGNALED(status))
+	{
+		mirac_logger_warn("request was terminated by signal %d.", (int32_t)WTERMSIG(status));
+	}
+
+	// note: the units compiled before a failure are still taken over.
+	take_over_report(server, request->report, request->report_length);
+	mirac_c_free(request->report);
+	*request = (request_s) {0};
+	return exit_code;
+}
+
+static void take_over_report(
+	mirac_server_s* const server,
+	const uint8_t* const report,
+	const uint64_t length)
+{
+	mirac_debug_assert(server != mirac_null);
+
+	uint64_t offset = 0;
+	uint64_t units_count = 0;
+
+	while ((length - offset) >= sizeof(report_unit_header_s))
+	{
+		report_unit_header_s unit_header = {0};
+		mirac_c_memcpy(&unit_header, report + offset, sizeof(unit_header));
+		offset += sizeof(unit_header);
+
+		if ((unit_header.output_path_length <= 0) || (unit_header.output_path_length >= PATH_MAX) ||
+			(unit_header.output_path_length > (length - offset)))
+		{
+			break;
+		}
+
+		const mirac_string_view_s output_path = mirac_string_view_from_parts((const char_t*)report + offset, unit_header.output_path_length);
+		offset += unit_header.output_path_length;
+
+		mirac_server_input_s* const inputs = (mirac_server_input_s*)mirac_arena_malloc(server->arena,
+			(unit_header.inputs_count > 0 ? unit_header.inputs_count : 1) * sizeof(mirac_server_input_s));
+		bool_t is_valid = unit_header.inputs_count <= (length - offset);
+
+		for (uint64_t input_index = 0; is_valid && (input_index < unit_header.inputs_count); ++input_index)
+		{
+			report_input_header_s input_header = {0};
+			is_valid = (length - offset) >= sizeof(input_header);
+
+			if (is_valid)
+			{
+				mirac_c_memcpy(&input_header, report + offset, sizeof(input_header));
+				offset += sizeof(input_header);
+				is_valid = (input_header.path_length > 0) && (input_header.path_length < PATH_MAX) &&
+					(input_header.path_length <= (length - offset));
+			}
+
+			if (is_valid)
+			{
+				const mirac_string_view_s input_path = mirac_string_view_from_parts((const char_t*)report + offset, input_header.path_length);
+				offset += input_header.path_length;
+
+				inputs[input_index] = (mirac_server_input_s)
+				{
+					.path  = mirac_interner_intern(server->interner, input_path),
+					.stamp = (mirac_preprocessor_file_stamp_s)
+					{
+						.size              = input_header.size,
+						.modification_time = input_header.modification_time
+					}
+				};
+			}
+		}
+
+		if (!is_valid)
+		{
+			break;
+		}
+
+		const mirac_server_unit_s unit = (mirac_server_unit_s)
+		{
+			.key          = (mirac_cache_key_s) { .lanes = { unit_header.key_lanes[0], unit_header.key_lanes[1] } },
+			.output_stamp = (mirac_preprocessor_file_stamp_s)
+			{
+				.size              = unit_header.output_size,
+				.modification_time = unit_header.output_modification_time
+			},
+			.inputs       = inputs,
+			.inputs_count = unit_header.inputs_count
+		};
+
+		const mirac_symbol_t symbol = mirac_interner_intern(server->interner, output_path);
+		mirac_server_unit_s* record = mirac_null;
+
+		if (!mirac_server_unit_table_find(&server->units, symbol, &record))
+		{
+			record = (mirac_server_unit_s*)mirac_arena_malloc(server->arena, sizeof(mirac_server_unit_s));
+			(void)mirac_server_unit_table_insert(&server->units, symbol, record);
+		}
+
+		*record = unit;
+		++units_count;
+	}
+
+	server->compiled_units_count += units_count;
+	preload_included_files(server, report, units_count);
+}
+
+static void preload_included_files(
+	mirac_server_s* const server,
+	const uint8_t* const report,
+	const uint64_t units_count)
+{
+	mirac_debug_assert(server != mirac_null);
+
+	// note: the included files are lexed by the server only now, so the next
+	//       requests find them in the cache. A file that fails to lex is simply
+	//       left out, its errors are reported by the requests including it.
+	mirac_logger_capture_s capture = mirac_logger_capture_from_parts();
+	mirac_c_exit_trap_s trap = {0};
+	mirac_logger_set_capture(&capture);
+
+	if (0 == setjmp(trap.buffer))
+	{
+		mirac_c_set_exit_trap(&trap);
+		uint64_t offset = 0;
+
+		for (uint64_t unit_index = 0; unit_index < units_count; ++unit_index)
+		{
+			report_unit_header_s unit_header = {0};
+			mirac_c_memcpy(&unit_header, report + offset, sizeof(unit_header));
+			offset += sizeof(unit_header) + unit_header.output_path_length;
+
+			for (uint64_t input_index = 0; input_index < unit_header.inputs_count; ++input_index)
+			{
+				report_input_header_s input_header = {0};
+				mirac_c_memcpy(&input_header, report + offset, sizeof(input_header));
+				offset += sizeof(input_header);
+
+				char_t path[PATH_MAX] = {0};
+				mirac_c_memcpy(path, report + offset, input_header.path_length);
+				mirac_preprocessor_cache_preload(server->preprocessor_cache, server->config, path);
+				offset += input_header.path_length;
+			}
+		}
+	}
+
+	mirac_c_set_exit_trap(mirac_null);
+	mirac_logger_set_capture(mirac_null);
+	mirac_logger_capture_destroy(&capture);
+}
+
+static bool_t receive_request(
+	mirac_server_s* const server,
+	const int32_t client_descriptor,
+	request_s* const request)
+{
+	mirac_debug_assert(server != mirac_null);
+	mirac_debug_assert(request != mirac_null);
+
+	request_header_s header = {0};
+	int32_t output_descriptors[2] = { -1, -1 };
+	char_t control[CMSG_SPACE(sizeof(output_descriptors))] = {0};
+	struct iovec header_vector = { .iov_base = (void*)&header, .iov_len = sizeof(header) };
+	struct msghdr header_message = {0};
+	header_message.msg_iov = &header_vector;
+	header_message.msg_iovlen = 1;
+	header_message.msg_control = control;
+	header_message.msg_controllen = sizeof(control);
+
+	ssize_t received = -1;
+	while (((received = recvmsg(client_descriptor, &header_message, MSG_CMSG_CLOEXEC)) < 0) && (EINTR == errno));
+
+	const struct cmsghdr* const control_header = CMSG_FIRSTHDR(&header_message);
+
+	if ((control_header != mirac_null) && (SOL_SOCKET == control_header->cmsg_level) &&
+		(SCM_RIGHTS == control_header->cmsg_type) && (CMSG_LEN(sizeof(output_descriptors)) == control_header->cmsg_len))
+	{
+		mirac_c_memcpy(output_descriptors, CMSG_DATA(control_header), sizeof(output_descriptors));
+	}
+
+	bool_t is_valid = (received == (ssize_t)sizeof(header)) && (request_magic == header.magic) &&
+		(output_descriptors[0] >= 0) && (output_descriptors[1] >= 0) &&
+		(header.directory_length > 0) && (header.directory_length < PATH_MAX) &&
+		(header.arguments_count > 0) && (header.arguments_count <= request_max_arguments_count);
+
+	mirac_arena_s arena = mirac_arena_from_parts();
+	char_t* directory = mirac_null;
+	const char_t** argv = mirac_null;
+
+	if (is_valid)
+	{
+		directory = (char_t*)mirac_arena_malloc_aligned(&arena, header.directory_length + 1, 1);
+		directory[header.directory_length] = '\0';
+		is_valid = read_all(client_descriptor, directory, header.directory_length);
+		argv = (const char_t**)mirac_arena_malloc(&arena, (header.arguments_count + 1) * sizeof(const char_t*));
+		argv[header.arguments_count] = mirac_null;
+	}
+
+	for (uint64_t argument_index = 0; is_valid && (argument_index < header.arguments_count); ++argument_index)
+	{
+		uint64_t argument_length = 0;
+		is_valid = read_all(client_descriptor, &argument_length, sizeof(argument_length)) &&
+			(argument_length <= request_max_argument_length);
+
+		if (is_valid)
+		{
+			char_t* const argument = (char_t*)mirac_arena_malloc_aligned(&arena, argument_length + 1, 1);
+			argument[argument_length] = '\0';
+			is_valid = (0 == argument_length) || read_all(client_descriptor, argument, argument_length);
+			argv[argument_index] = argument;
+		}
+	}
+
+	if (is_valid)
+	{
+		is_valid = start_request(server, directory, (int32_t)header.arguments_count, argv, output_descriptors, request);
+		request->client_descriptor = client_descriptor;
+	}
+	else
+	{
+		mirac_logger_warn("dropped a malformed compile request.");
+	}
+
+	for (uint64_t descriptor_index = 0; descriptor_index < 2; ++descriptor_index)
+	{
+		if (output_descriptors[descriptor_index] >= 0)
+		{
+			(void)close(output_descriptors[descriptor_index]);
+		}
+	}
+
+	mirac_arena_destroy(&arena);
+	return is_valid;
+}
+
+static bool_t has_any_pair_changed(
+	mirac_server_s* const server,
+	const char_t** const source_files,
+	const uint64_t source_files_count,
+	const mirac_preprocessor_file_stamp_s* const stamps)
+{
+	mirac_debug_assert(server != mirac_null);
+	mirac_debug_assert(source_files != mirac_null);
+	mirac_debug_assert(stamps != mirac_null);
+
+	char_t path[PATH_MAX] = {0};
+	mirac_preprocessor_file_stamp_s stamp = {0};
+
+	for (uint64_t file_index = 0; file_index < source_files_count; ++file_index)
+	{
+		stamp = (mirac_preprocessor_file_stamp_s) {0};
+		(void)mirac_preprocessor_file_stamp_from_path(source_files[file_index], &stamp);
+
+		if (!mirac_preprocessor_file_stamp_equal(stamp, stamps[file_index]))
+		{
+			return true;
+		}
+	}
+
+	for (uint64_t pair_index = 0; pair_index < (source_files_count / 2); ++pair_index)
+	{
+		// note: the units that never compiled have no record, so only their src+out
+		//       files are watched.
+		mirac_server_unit_s* unit = mirac_null;
+
+		if (!make_absolute_path(mirac_string_view_from_cstring(source_files[(pair_index * 2) + 1]), path) ||
+			!mirac_server_unit_table_find(&server->units, mirac_interner_intern(server->interner,
+				mirac_string_view_from_cstring(path)), &unit))
+		{
+			continue;
+		}
+
+		for (uint64_t input_index = 0; input_index < unit->inputs_count; ++input_index)
+		{
+			const mirac_string_view_s input_path = mirac_interner_get_string(server->interner, unit->inputs[input_index].path);
+			mirac_c_memcpy(path, input_path.data, input_path.length);
+			path[input_path.length] = '\0';
+
+			if (!mirac_preprocessor_file_stamp_from_path(path, &stamp) ||
+				!mirac_preprocessor_file_stamp_equal(stamp, unit->inputs[input_index].stamp))
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
@@ -17,6 +17,101 @@
 #include <memory.h>
 #include <string.h>
 
+#if defined(__x86_64__)
+#	include <immintrin.h>
+#	define mirac_string_view_has_simd_scanners 1
+#else
+#	define mirac_string_view_has_simd_scanners 0
+#endif
+
+typedef struct
+{
+	uint64_t(*find_char)(const char_t* const, const uint64_t, const char_t);
+	uint64_t(*find_white_space)(const char_t* const, const uint64_t);
+	uint64_t(*find_non_white_space)(const char_t* const, const uint64_t);
+} scanner_s;
+
+/**
+ * @brief Check if a char is a white space (' ', '\t', '\n', or '\r').
+ * 
+ * @param character char to check
+ * 
+ * @return bool_t
+ */
+static bool_t is_white_space(
+	const char_t character);
+
+// todo: document!
+static uint64_t scalar_find_char(
+	const char_t* const data,
+	const uint64_t length,
+	const char_t char_to_find);
+
+// todo: document!
+static uint64_t scalar_find_white_space(
+	const char_t* const data,
+	const uint64_t length);
+
+// todo: document!
+static uint64_t scalar_find_non_white_space(
+	const char_t* const data,
+	const uint64_t length);
+
+#if mirac_string_view_has_simd_scanners
+// todo: document!
+static uint64_t sse2_find_char(
+	const char_t* const data,
+	const uint64_t length,
+	const char_t char_to_find);
+
+// todo: document!
+static uint64_t sse2_find_white_space(
+	const char_t* const data,
+	const uint64_t length);
+
+// todo: document!
+static uint64_t sse2_find_non_white_space(
+	const char_t* const data,
+	const uint64_t length);
+
+// todo: document!
+__attribute__((target("avx2")))
+static uint64_t avx2_find_char(
+	const char_t* const data,
+	const uint64_t length,
+	const char_t char_to_find);
+
+// todo: document!
+__attribute__((target("avx2")))
+static uint64_t avx2_find_white_space(
+	const char_t* const data,
+	const uint64_t length);
+
+// todo: document!
+__attribute__((target("avx2")))
+static uint64_t avx2_find_non_white_space(
+	const char_t* const data,
+	const uint64_t length);
+#endif
+
+/**
+ * @brief Select the best scanner supported by the cpu before main runs.
+ */
+__attribute__((constructor))
+static void select_best_scanner(
+	void);
+
+static const scanner_s g_scanners[mirac_string_view_scanner_count] =
+{
+	[mirac_string_view_scanner_scalar] = { scalar_find_char, scalar_find_white_space, scalar_find_non_white_space },
+#if mirac_string_view_has_simd_scanners
+	[mirac_string_view_scanner_sse2]   = { sse2_find_char,   sse2_find_white_space,   sse2_find_non_white_space   },
+	[mirac_string_view_scanner_avx2]   = { avx2_find_char,   avx2_find_white_space,   avx2_find_non_white_space   },
+#endif
+};
+
+static mirac_string_view_scanner_e g_scanner = mirac_string_view_scanner_scalar;
+
 mirac_string_view_s mirac_string_view_from_parts(
 	const char_t* const data,
 	const uint64_t length)
@@ -69,6 +164,21 @@ bool_t mirac_string_view_equal(
 	return mirac_string_view_equal_range(left, right, left.length);
 }
 
+uint64_t mirac_string_view_hash(
+	const mirac_string_view_s string_view)
+{
+	mirac_debug_assert(string_view.data != mirac_null);
+	uint64_t hash = 0xcbf29ce484222325;
+
+	for (uint64_t index = 0; index < string_view.length; ++index)
+	{
+		hash ^= (uint8_t)string_view.data[index];
+		hash *= 0x00000100000001b3;
+	}
+
+	return hash;
+}
+
 mirac_string_view_s mirac_string_view_trim_left(
 	const mirac_string_view_s string_view,
 	const char_t char_to_trim,
@@ -144,17 +254,7 @@ mirac_string_view_s mirac_string_view_trim_left_white_space(
 		return string_view;
 	}
 
-	uint64_t index = 0;
-
-	while ((index < string_view.length) && (
-			(' '  == string_view.data[index]) ||
-			('\t' == string_view.data[index]) ||
-			('\n' == string_view.data[index]) ||
-			('\r' == string_view.data[index])
-		))
-	{
-		++index;
-	}
+	const uint64_t index = mirac_string_view_find_non_white_space(string_view);
 
 	if (trimmed_length != mirac_null)
 	{
@@ -176,12 +276,7 @@ mirac_string_view_s mirac_string_view_split_left(
 		return *string_view;
 	}
 
-	int64_t index = 0;
-
-	while ((index < (int64_t)string_view->length) && (string_view->data[index] != char_to_split_at))
-	{
-		++index;
-	}
+	const int64_t index = (int64_t)mirac_string_view_find_char(*string_view, char_to_split_at);
 
 	int64_t string_view_length = (int64_t)string_view->length - index - 1;
 
@@ -207,20 +302,286 @@ mirac_string_view_s mirac_string_view_split_left_white_space(
 		return *string_view;
 	}
 
+	const uint64_t index = mirac_string_view_find_white_space(*string_view);
+
+	const mirac_string_view_s left = mirac_string_view_from_parts(string_view->data, index);
+	*string_view = mirac_string_view_from_parts(string_view->data + index, string_view->length - index);
+	*string_view = mirac_string_view_trim_left_white_space(*string_view, white_space_length);
+	return left;
+}
+
+bool_t mirac_string_view_use_scanner(
+	const mirac_string_view_scanner_e scanner)
+{
+	switch (scanner)
+	{
+		case mirac_string_view_scanner_scalar:
+		{
+		} break;
+
+#if mirac_string_view_has_simd_scanners
+		case mirac_string_view_scanner_sse2:
+		{
+			if (!__builtin_cpu_supports("sse2"))
+			{
+				return false;
+			}
+		} break;
+
+		case mirac_string_view_scanner_avx2:
+		{
+			if (!__builtin_cpu_supports("avx2"))
+			{
+				return false;
+			}
+		} break;
+#endif
+
+		default:
+		{
+			return false;
+		} break;
+	}
+
+	g_scanner = scanner;
+	return true;
+}
+
+mirac_string_view_scanner_e mirac_string_view_get_scanner(
+	void)
+{
+	return g_scanner;
+}
+
+uint64_t mirac_string_view_find_char(
+	const mirac_string_view_s string_view,
+	const char_t char_to_find)
+{
+	mirac_debug_assert(string_view.data != mirac_null);
+	return g_scanners[g_scanner].find_char(string_view.data, string_view.length, char_to_find);
+}
+
+uint64_t mirac_string_view_find_white_space(
+	const mirac_string_view_s string_view)
+{
+	mirac_debug_assert(string_view.data != mirac_null);
+	return g_scanners[g_scanner].find_white_space(string_view.data, string_view.length);
+}
+
+uint64_t mirac_string_view_find_non_white_space(
+	const mirac_string_view_s string_view)
+{
+	mirac_debug_assert(string_view.data != mirac_null);
+	return g_scanners[g_scanner].find_non_white_space(string_view.data, string_view.length);
+}
+
+static bool_t is_white_space(
+	const char_t character)
+{
+	return (' ' == character) || ('\t' == character) || ('\n' == character) || ('\r' == character);
+}
+
+static uint64_t scalar_find_char(
+	const char_t* const data,
+	const uint64_t length,
+	const char_t char_to_find)
+{
 	uint64_t index = 0;
 
-	while ((index < string_view->length) && (
-			(string_view->data[index] !=  ' ') &&
-			(string_view->data[index] != '\t') &&
-			(string_view->data[index] != '\n') &&
-			(string_view->data[index] != '\r')
-		))
+	while ((index < length) && (data[index] != char_to_find))
 	{
 		++index;
 	}
 
-	const mirac_string_view_s left = mirac_string_view_from_parts(string_view->data, index);
-	*string_view = mirac_string_view_from_parts(string_view->data + index, string_view->length - index);
-	*string_view = mirac_string_view_trim_left_white_space(*string_view, white_space_length);
-	return left;
+	return index;
+}
+
+static uint64_t scalar_find_white_space(
+	const char_t* const data,
+	const uint64_t length)
+{
+	uint64_t index = 0;
+
+	while ((index < length) && !is_white_space(data[index]))
+	{
+		++index;
+	}
+
+	return index;
+}
+
+static uint64_t scalar_find_non_white_space(
+	const char_t* const data,
+	const uint64_t length)
+{
+	uint64_t index = 0;
+
+	while ((index < length) && is_white_space(data[index]))
+	{
+		++index;
+	}
+
+	return index;
+}
+
+#if mirac_string_view_has_simd_scanners
+// note: the simd scanners only load whole blocks that lie within the string view
+//       (the source may be a memory mapping that ends at a page boundary), and
+//       leave the tail to the scalar scanners.
+
+static uint64_t sse2_find_char(
+	const char_t* const data,
+	const uint64_t length,
+	const char_t char_to_find)
+{
+	const __m128i needle = _mm_set1_epi8(char_to_find);
+	uint64_t index = 0;
+
+	for (; (index + 16) <= length; index += 16)
+	{
+		const __m128i block = _mm_loadu_si128((const __m128i*)(data + index));
+		const uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle));
+
+		if (mask != 0)
+		{
+			return index + (uint64_t)__builtin_ctz(mask);
+		}
+	}
+
+	return index + scalar_find_char(data + index, length - index, char_to_find);
+}
+
+static uint64_t sse2_find_white_space(
+	const char_t* const data,
+	const uint64_t length)
+{
+	uint64_t index = 0;
+
+	for (; (index + 16) <= length; index += 16)
+	{
+		const __m128i block = _mm_loadu_si128((const __m128i*)(data + index));
+		const __m128i spaces = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(' ')),  _mm_cmpeq_epi8(block, _mm_set1_epi8('\t'))),
+			_mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(block, _mm_set1_epi8('\r'))));
+		const uint32_t mask = (uint32_t)_mm_movemask_epi8(spaces);
+
+		if (mask != 0)
+		{
+			return index + (uint64_t)__builtin_ctz(mask);
+		}
+	}
+
+	return index + scalar_find_white_space(data + index, length - index);
+}
+
+static uint64_t sse2_find_non_white_space(
+	const char_t* const data,
+	const uint64_t length)
+{
+	uint64_t index = 0;
+
+	for (; (index + 16) <= length; index += 16)
+	{
+		const __m128i block = _mm_loadu_si128((const __m128i*)(data + index));
+		const __m128i spaces = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(' ')),  _mm_cmpeq_epi8(block, _mm_set1_epi8('\t'))),
+			_mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(block, _mm_set1_epi8('\r'))));
+		const uint32_t mask = ~(uint32_t)_mm_movemask_epi8(spaces) & 0xffff;
+
+		if (mask != 0)
+		{
+			return index + (uint64_t)__builtin_ctz(mask);
+		}
+	}
+
+	return index + scalar_find_non_white_space(data + index, length - index);
+}
+
+__attribute__((target("avx2")))
+static uint64_t avx2_find_char(
+	const char_t* const data,
+	const uint64_t length,
+	const char_t char_to_find)
+{
+	const __m256i needle = _mm256_set1_epi8(char_to_find);
+	uint64_t index = 0;
+
+	for (; (index + 32) <= length; index += 32)
+	{
+		const __m256i block = _mm256_loadu_si256((const __m256i*)(data + index));
+		const uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle));
+
+		if (mask != 0)
+		{
+			return index + (uint64_t)__builtin_ctz(mask);
+		}
+	}
+
+	return index + scalar_find_char(data + index, length - index, char_to_find);
+}
+
+__attribute__((target("avx2")))
+static uint64_t avx2_find_white_space(
+	const char_t* const data,
+	const uint64_t length)
+{
+	uint64_t index = 0;
+
+	for (; (index + 32) <= length; index += 32)
+	{
+		const __m256i block = _mm256_loadu_si256((const __m256i*)(data + index));
+		const __m256i spaces = _mm256_or_si256(
+			_mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(' ')),  _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\t'))),
+			_mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\r'))));
+		const uint32_t mask = (uint32_t)_mm256_movemask_epi8(spaces);
+
+		if (mask != 0)
+		{
+			return index + (uint64_t)__builtin_ctz(mask);
+		}
+	}
+
+	return index + scalar_find_white_space(data + index, length - index);
+}
+
+__attribute__((target("avx2")))
+static uint64_t avx2_find_non_white_space(
+	const char_t* const data,
+	const uint64_t length)
+{
+	uint64_t index = 0;
+
+	for (; (index + 32) <= length; index += 32)
+	{
+		const __m256i block = _mm256_loadu_si256((const __m256i*)(data + index));
+		const __m256i spaces = _mm256_or_si256(
+			_mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(' ')),  _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\t'))),
+			_mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\r'))));
+		const uint32_t mask = ~(uint32_t)_mm256_movemask_epi8(spaces);
+
+		if (mask != 0)
+		{
+			return index + (uint64_t)__builtin_ctz(mask);
+		}
+	}
+
+	return index + scalar_find_non_white_space(data + index, length - index);
+}
+#endif
+
+static void select_best_scanner(
+	void)
+{
+#if mirac_string_view_has_simd_scanners
+	// note: constructors may run before the one initializing the cpu model.
+	__builtin_cpu_init();
+#endif
+
+	for (int32_t scanner = mirac_string_view_scanner_count - 1; scanner >= 0; --scanner)
+	{
+		if (mirac_string_view_use_scanner((mirac_string_view_scanner_e)scanner))
+		{
+			return;
+		}
+	}
 }
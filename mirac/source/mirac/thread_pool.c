@@ -0,0 +1,345 @@
+/**
+ * @file thread_pool.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-01-25
+ */
+
+#include <mirac/thread_pool.h>
+
+#include <mirac/debug.h>
+#include <mirac/logger.h>
+
+/**
+ * @brief Range of jobs owned by a worker, packed into a single word so that it
+ * can be updated with one compare and swap (low half is the first job index,
+ * high half is one past the last job index).
+ */
+typedef struct
+{
+	_Alignas(64) uint64_t range;
+} worker_queue_s;
+
+struct mirac_thread_pool_shared_s
+{
+	pthread_mutex_t mutex;
+	pthread_cond_t run_started;
+	pthread_cond_t run_finished;
+	uint64_t run_generation;
+	uint64_t busy_workers_count;
+	bool_t is_stopping;
+
+	uint64_t workers_count;
+	mirac_thread_pool_job_t job;
+	void* context;
+	worker_queue_s queues[mirac_thread_pool_max_workers_count];
+};
+
+typedef struct
+{
+	mirac_thread_pool_shared_s* shared;
+	uint64_t worker_index;
+} worker_argument_s;
+
+/**
+ * @brief Pack the job range into a single word.
+ * 
+ * @param begin index of the first job in the range
+ * @param end   index one past the last job in the range
+ * 
+ * @return uint64_t
+ */
+static uint64_t pack_range(
+	const uint64_t begin,
+	const uint64_t end);
+
+/**
+ * @brief Take the first job from the worker's own range.
+ * 
+ * @param queue     queue of the worker
+ * @param job_index index of the taken job
+ * 
+ * @return bool_t
+ */
+static bool_t pop_job(
+	worker_queue_s* const queue,
+	uint64_t* const job_index);
+
+/**
+ * @brief Move the upper half of another worker's remaining range into the
+ * worker's own (empty) range.
+ * 
+ * @param shared       shared state of the thread pool
+ * @param worker_index index of the stealing worker
+ * 
+ * @return bool_t
+ */
+static bool_t steal_jobs(
+	mirac_thread_pool_shared_s* const shared,
+	const uint64_t worker_index);
+
+/**
+ * @brief Claim and run jobs of the current run until none are left.
+ * 
+ * @param shared       shared state of the thread pool
+ * @param worker_index index of the calling worker
+ */
+static void run_jobs(
+	mirac_thread_pool_shared_s* const shared,
+	const uint64_t worker_index);
+
+/**
+ * @brief Entry of the worker threads: sleep until a run starts, take part in
+ * it, and report back when done.
+ * 
+ * @param argument worker argument (worker_argument_s*)
+ * 
+ * @return void*
+ */
+static void* worker_main(
+	void* argument);
+
+mirac_thread_pool_s mirac_thread_pool_from_parts(
+	const uint64_t workers_count)
+{
+	mirac_debug_assert(workers_count > 0);
+	mirac_debug_assert(workers_count <= mirac_thread_pool_max_workers_count);
+
+	mirac_thread_pool_shared_s* const shared = (mirac_thread_pool_shared_s*)mirac_c_malloc(
+		sizeof(mirac_thread_pool_shared_s));
+	*shared = (mirac_thread_pool_shared_s) {0};
+	shared->workers_count = workers_count;
+	(void)pthread_mutex_init(&shared->mutex, mirac_null);
+	(void)pthread_cond_init(&shared->run_started, mirac_null);
+	(void)pthread_cond_init(&shared->run_finished, mirac_null);
+
+	mirac_thread_pool_s pool = (mirac_thread_pool_s)
+	{
+		.workers_count = workers_count,
+		.threads       = mirac_null,
+		.shared        = shared
+	};
+
+	if (workers_count <= 1)
+	{
+		return pool;
+	}
+
+	pool.threads = (pthread_t*)mirac_c_malloc((workers_count - 1) * sizeof(pthread_t));
+
+	for (uint64_t worker_index = 1; worker_index < workers_count; ++worker_index)
+	{
+		worker_argument_s* const argument = (worker_argument_s*)mirac_c_malloc(sizeof(worker_argument_s));
+		*argument = (worker_argument_s) { .shared = shared, .worker_index = worker_index };
+
+		if (pthread_create(&pool.threads[worker_index - 1], mirac_null, worker_main, argument) != 0)
+		{
+			mirac_logger_error("internal failure -- failed to start a worker thread.");
+			mirac_c_exit(-1);
+		}
+	}
+
+	return pool;
+}
+
+void mirac_thread_pool_destroy(
+	mirac_thread_pool_s* const pool)
+{
+	mirac_debug_assert(pool != mirac_null);
+	mirac_debug_assert(pool->shared != mirac_null);
+	mirac_thread_pool_shared_s* const shared = pool->shared;
+
+	(void)pthread_mutex_lock(&shared->mutex);
+	shared->is_stopping = true;
+	(void)pthread_cond_broadcast(&shared->run_started);
+	(void)pthread_mutex_unlock(&shared->mutex);
+
+	for (uint64_t worker_index = 1; worker_index < pool->workers_count; ++worker_index)
+	{
+		(void)pthread_join(pool->threads[worker_index - 1], mirac_null);
+	}
+
+	(void)pthread_cond_destroy(&shared->run_finished);
+	(void)pthread_cond_destroy(&shared->run_started);
+	(void)pthread_mutex_destroy(&shared->mutex);
+	mirac_c_free(shared);
+	mirac_c_free(pool->threads);
+	*pool = (mirac_thread_pool_s) {0};
+}
+
+void mirac_thread_pool_run(
+	mirac_thread_pool_s* const pool,
+	const uint64_t jobs_count,
+	const mirac_thread_pool_job_t job,
+	void* const context)
+{
+	mirac_debug_assert(pool != mirac_null);
+	mirac_debug_assert(pool->shared != mirac_null);
+	mirac_debug_assert(job != mirac_null);
+	mirac_debug_assert(jobs_count <= UINT32_MAX);
+	mirac_thread_pool_shared_s* const shared = pool->shared;
+
+	(void)pthread_mutex_lock(&shared->mutex);
+	shared->job = job;
+	shared->context = context;
+
+	for (uint64_t worker_index = 0; worker_index < pool->workers_count; ++worker_index)
+	{
+		const uint64_t begin = (jobs_count * worker_index) / pool->workers_count;
+		const uint64_t end = (jobs_count * (worker_index + 1)) / pool->workers_count;
+		shared->queues[worker_index].range = pack_range(begin, end);
+	}
+
+	shared->busy_workers_count = pool->workers_count - 1;
+	++shared->run_generation;
+	(void)pthread_cond_broadcast(&shared->run_started);
+	(void)pthread_mutex_unlock(&shared->mutex);
+
+	run_jobs(shared, 0);
+
+	(void)pthread_mutex_lock(&shared->mutex);
+
+	while (shared->busy_workers_count > 0)
+	{
+		(void)pthread_cond_wait(&shared->run_finished, &shared->mutex);
+	}
+
+	(void)pthread_mutex_unlock(&shared->mutex);
+}
+
+static uint64_t pack_range(
+	const uint64_t begin,
+	const uint64_t end)
+{
+	mirac_debug_assert(begin <= end);
+	mirac_debug_assert(end <= UINT32_MAX);
+	return begin | (end << 32);
+}
+
+static bool_t pop_job(
+	worker_queue_s* const queue,
+	uint64_t* const job_index)
+{
+	mirac_debug_assert(queue != mirac_null);
+	mirac_debug_assert(job_index != mirac_null);
+	uint64_t range = __atomic_load_n(&queue->range, __ATOMIC_ACQUIRE);
+
+	while (true)
+	{
+		const uint64_t begin = range & UINT32_MAX;
+		const uint64_t end = range >> 32;
+
+		if (begin >= end)
+		{
+			return false;
+		}
+
+		if (__atomic_compare_exchange_n(&queue->range, &range, pack_range(begin + 1, end),
+			false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+		{
+			*job_index = begin;
+			return true;
+		}
+	}
+}
+
+static bool_t steal_jobs(
+	mirac_thread_pool_shared_s* const shared,
+	const uint64_t worker_index)
+{
+	mirac_debug_assert(shared != mirac_null);
+
+	for (uint64_t offset = 1; offset < shared->workers_count; ++offset)
+	{
+		worker_queue_s* const victim = &shared->queues[(worker_index + offset) % shared->workers_count];
+		uint64_t range = __atomic_load_n(&victim->range, __ATOMIC_ACQUIRE);
+
+		while (true)
+		{
+			const uint64_t begin = range & UINT32_MAX;
+			const uint64_t end = range >> 32;
+
+			if (begin >= end)
+			{
+				break;
+			}
+
+			// note: the victim keeps the lower half, which it is about to reach anyway,
+			//       and a single remaining job is taken whole.
+			const uint64_t middle = begin + ((end - begin) / 2);
+
+			if (__atomic_compare_exchange_n(&victim->range, &range, pack_range(begin, middle),
+				false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+			{
+				__atomic_store_n(&shared->queues[worker_index].range, pack_range(middle, end), __ATOMIC_RELEASE);
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+static void run_jobs(
+	mirac_thread_pool_shared_s* const shared,
+	const uint64_t worker_index)
+{
+	mirac_debug_assert(shared != mirac_null);
+	uint64_t job_index = 0;
+
+	do
+	{
+		while (pop_job(&shared->queues[worker_index], &job_index))
+		{
+			shared->job(shared->context, job_index, worker_index);
+		}
+	}
+	while (steal_jobs(shared, worker_index));
+}
+
+static void* worker_main(
+	void* argument)
+{
+	mirac_debug_assert(argument != mirac_null);
+	const worker_argument_s worker = *(const worker_argument_s*)argument;
+	mirac_c_free(argument);
+
+	mirac_thread_pool_shared_s* const shared = worker.shared;
+	uint64_t seen_generation = 0;
+
+	while (true)
+	{
+		(void)pthread_mutex_lock(&shared->mutex);
+
+		while (!shared->is_stopping && (seen_generation == shared->run_generation))
+		{
+			(void)pthread_cond_wait(&shared->run_started, &shared->mutex);
+		}
+
+		if (shared->is_stopping)
+		{
+			(void)pthread_mutex_unlock(&shared->mutex);
+			break;
+		}
+
+		seen_generation = shared->run_generation;
+		(void)pthread_mutex_unlock(&shared->mutex);
+
+		run_jobs(shared, worker.worker_index);
+
+		(void)pthread_mutex_lock(&shared->mutex);
+
+		if (0 == --shared->busy_workers_count)
+		{
+			(void)pthread_cond_signal(&shared->run_finished);
+		}
+
+		(void)pthread_mutex_unlock(&shared->mutex);
+	}
+
+	return mirac_null;
+}
@@ -0,0 +1,235 @@
+/**
+ * @file arena_suite.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-01-20
+ */
+
+#include "utester.h"
+
+#include <mirac/c_common.h>
+#include <mirac/arena.h>
+
+utester_define_test(from_parts)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+
+	utester_assert_true(mirac_null == arena.begin);
+	utester_assert_true(mirac_null == arena.end);
+	utester_assert_false(arena.is_used);
+
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(malloc_bumps_within_chunk)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+
+	uint8_t* const first = (uint8_t*)mirac_arena_malloc(&arena, 3);
+	uint8_t* const second = (uint8_t*)mirac_arena_malloc(&arena, 5);
+
+	utester_assert_true(first != mirac_null);
+	utester_assert_true(second != mirac_null);
+	utester_assert_true(arena.begin == arena.end);
+	utester_assert_true(second > first);
+	utester_assert_true((uint64_t)(second - first) < mirac_arena_min_chunk_capacity);
+
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(malloc_aligned)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+
+	(void)mirac_arena_malloc_aligned(&arena, 1, 1);
+	const uintptr_t default_aligned = (uintptr_t)mirac_arena_malloc(&arena, 1);
+	(void)mirac_arena_malloc_aligned(&arena, 1, 1);
+	const uintptr_t eight_aligned = (uintptr_t)mirac_arena_malloc_aligned(&arena, 8, 8);
+
+	utester_assert_true(0 == (default_aligned % mirac_arena_default_alignment));
+	utester_assert_true(0 == (eight_aligned % 8));
+
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(malloc_grows_chunks)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+
+	(void)mirac_arena_malloc(&arena, mirac_arena_min_chunk_capacity);
+	const mirac_arena_chunk_s* const first_chunk = arena.end;
+	(void)mirac_arena_malloc(&arena, 1);
+
+	utester_assert_true(arena.end != first_chunk);
+	utester_assert_true(arena.begin == first_chunk);
+	utester_assert_true(arena.end->capacity > first_chunk->capacity);
+
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(malloc_oversized)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+
+	(void)mirac_arena_malloc(&arena, 1);
+	const mirac_arena_chunk_s* const current_chunk = arena.end;
+
+	uint8_t* const oversized = (uint8_t*)mirac_arena_malloc(&arena, mirac_arena_max_chunk_capacity * 2);
+	mirac_c_memset(oversized, 0xff, mirac_arena_max_chunk_capacity * 2);
+
+	utester_assert_true(arena.end == current_chunk);
+	utester_assert_true(arena.begin != current_chunk);
+	utester_assert_true(mirac_arena_max_chunk_capacity * 2 == arena.begin->capacity);
+
+	mirac_arena_destroy(&arena);
+	utester_assert_true(mirac_null == arena.begin);
+	utester_assert_true(mirac_null == arena.end);
+}
+
+utester_define_test(reset_keeps_current_chunk)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+
+	(void)mirac_arena_malloc(&arena, mirac_arena_min_chunk_capacity);
+	(void)mirac_arena_malloc(&arena, 1);
+	(void)mirac_arena_malloc(&arena, mirac_arena_max_chunk_capacity * 2);
+	const mirac_arena_chunk_s* const current_chunk = arena.end;
+
+	mirac_arena_reset(&arena);
+	utester_assert_true(arena.begin == current_chunk);
+	utester_assert_true(arena.end == current_chunk);
+	utester_assert_true(mirac_null == current_chunk->next);
+	utester_assert_true(0 == current_chunk->used);
+
+	uint8_t* const region = (uint8_t*)mirac_arena_malloc(&arena, 16);
+	utester_assert_true(region == current_chunk->data);
+
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(stats_account_sites)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_arena_stats_s stats = {0};
+	mirac_arena_set_stats(&arena, &stats);
+
+	(void)mirac_arena_malloc(&arena, 24);
+	(void)mirac_arena_malloc_as(&arena, 8, mirac_arena_site_tokens);
+	(void)mirac_arena_malloc_as(&arena, 16, mirac_arena_site_tokens);
+
+	const mirac_arena_site_stats_s* const other = &stats.sites[mirac_arena_site_other];
+	const mirac_arena_site_stats_s* const tokens = &stats.sites[mirac_arena_site_tokens];
+
+	utester_assert_true(24 == other->requested_size);
+	utester_assert_true(1 == other->allocations_count);
+	utester_assert_true(1 == other->chunks_count);
+	utester_assert_true(mirac_arena_min_chunk_capacity == other->reserved_size);
+	utester_assert_true(24 == tokens->requested_size);
+	utester_assert_true(2 == tokens->allocations_count);
+	utester_assert_true(0 == tokens->chunks_count);
+	utester_assert_true(mirac_arena_min_chunk_capacity == stats.reserved_size);
+
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(stats_scoped_site)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_arena_stats_s stats = {0};
+	mirac_arena_set_stats(&arena, &stats);
+
+	utester_assert_true(mirac_arena_site_lists == mirac_arena_scoped_site(&arena, mirac_arena_site_lists));
+	const mirac_arena_site_e previous_site = mirac_arena_set_site(&arena, mirac_arena_site_tokens);
+	utester_assert_true(mirac_arena_site_none == previous_site);
+	utester_assert_true(mirac_arena_site_tokens == mirac_arena_scoped_site(&arena, mirac_arena_site_lists));
+
+	(void)mirac_arena_malloc(&arena, 32);
+	(void)mirac_arena_set_site(&arena, previous_site);
+	(void)mirac_arena_malloc(&arena, 8);
+
+	utester_assert_true(32 == stats.sites[mirac_arena_site_tokens].requested_size);
+	utester_assert_true(8 == stats.sites[mirac_arena_site_other].requested_size);
+
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(stats_realloc_in_place)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_arena_stats_s stats = {0};
+	mirac_arena_set_stats(&arena, &stats);
+
+	void* const pointer = mirac_arena_malloc_as(&arena, 16, mirac_arena_site_lists);
+	void* const grown = mirac_arena_realloc_as(&arena, pointer, 16, 64, mirac_arena_site_lists);
+
+	utester_assert_true(pointer == grown);
+	utester_assert_true(64 == stats.sites[mirac_arena_site_lists].requested_size);
+
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(realloc_dedicated_chunk)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_arena_stats_s stats = {0};
+	mirac_arena_set_stats(&arena, &stats);
+
+	const uint64_t size = mirac_arena_max_chunk_capacity * 2;
+	uint8_t* const pointer = (uint8_t*)mirac_arena_malloc_as(&arena, size, mirac_arena_site_lists);
+	(void)mirac_arena_malloc(&arena, 1);
+	pointer[0] = 0x2a;
+	pointer[size - 1] = 0x2b;
+
+	// note: the dedicated chunk is grown as a whole, instead of being abandoned.
+	uint8_t* const grown = (uint8_t*)mirac_arena_realloc_as(&arena, pointer, size, size * 2, mirac_arena_site_lists);
+	utester_assert_true((0x2a == grown[0]) && (0x2b == grown[size - 1]));
+	utester_assert_true((size * 2) == stats.sites[mirac_arena_site_lists].requested_size);
+	utester_assert_true((size * 2) == stats.sites[mirac_arena_site_lists].reserved_size);
+	utester_assert_true(1 == stats.sites[mirac_arena_site_lists].chunks_count);
+
+	grown[(size * 2) - 1] = 0x2c;
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(stats_peak_and_detach)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+	(void)mirac_arena_malloc(&arena, 1);
+
+	mirac_arena_stats_s stats = {0};
+	mirac_arena_set_stats(&arena, &stats);
+	utester_assert_true(mirac_arena_min_chunk_capacity == stats.reserved_size);
+
+	(void)mirac_arena_malloc(&arena, mirac_arena_max_chunk_capacity * 2);
+	const uint64_t peak_reserved_size = stats.reserved_size;
+	utester_assert_true(peak_reserved_size == stats.peak_reserved_size);
+	utester_assert_true(1 == stats.sites[mirac_arena_site_other].allocations_count);
+
+	mirac_arena_reset(&arena);
+	utester_assert_true(stats.reserved_size < peak_reserved_size);
+	utester_assert_true(peak_reserved_size == stats.peak_reserved_size);
+
+	mirac_arena_set_stats(&arena, mirac_null);
+	(void)mirac_arena_malloc(&arena, 1);
+	utester_assert_true(1 == stats.sites[mirac_arena_site_other].allocations_count);
+
+	mirac_arena_destroy(&arena);
+}
+
+utester_run_suite(arena_suite,
+	&from_parts,
+	&malloc_bumps_within_chunk,
+	&malloc_aligned,
+	&malloc_grows_chunks,
+	&malloc_oversized,
+	&reset_keeps_current_chunk,
+	&stats_account_sites,
+	&stats_scoped_site,
+	&stats_realloc_in_place,
+	&realloc_dedicated_chunk,
+	&stats_peak_and_detach
+);
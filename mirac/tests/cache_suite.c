@@ -0,0 +1,252 @@
+/**
+ * @file cache_suite.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-03-09
+ */
+
+#include "utester.h"
+
+#include <mirac/arena.h>
+#include <mirac/config.h>
+#include <mirac/interner.h>
+#include <mirac/lexer.h>
+#include <mirac/preprocessor.h>
+#include <mirac/cache.h>
+
+#include <sys/stat.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static void write_file(
+	const char_t* const path,
+	const char_t* const content);
+
+static bool_t are_keys_equal(
+	const mirac_cache_key_s* const left,
+	const mirac_cache_key_s* const right);
+
+static void write_file(
+	const char_t* const path,
+	const char_t* const content)
+{
+	mirac_file_t* const file = fopen(path, "wt");
+	mirac_debug_assert(file != mirac_null);
+	(void)fputs(content, file);
+	(void)fclose(file);
+}
+
+static bool_t are_keys_equal(
+	const mirac_cache_key_s* const left,
+	const mirac_cache_key_s* const right)
+{
+	return (left->lanes[0] == right->lanes[0]) && (left->lanes[1] == right->lanes[1]);
+}
+
+utester_define_test(hash_known_values)
+{
+	utester_assert_true(0xEF46DB3751D8E999 == mirac_cache_hash("", 0, 0));
+	utester_assert_true(0x44BC2CF5AD770999 == mirac_cache_hash("abc", 3, 0));
+	utester_assert_true(mirac_cache_hash("abc", 3, 0) != mirac_cache_hash("abc", 3, 1));
+
+	// note: inputs longer than a stripe are hashed by the four accumulators.
+	const char_t* const text = "0123456789abcdefghijklmnopqrstuvwxyz0123456789";
+	utester_assert_true(mirac_cache_hash(text, 46, 0) == mirac_cache_hash(text, 46, 0));
+	utester_assert_true(mirac_cache_hash(text, 46, 0) != mirac_cache_hash(text, 45, 0));
+}
+
+utester_define_test(key_covers_source_and_config)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+	const mirac_string_view_s source_file_path = mirac_string_view_from_parts("main.mira", 9);
+	const mirac_string_view_s source = mirac_string_view_from_parts("func main in 0 ret end", 22);
+
+	mirac_config_s config = {0};
+	config.entry = mirac_string_view_from_parts("_start", 6);
+	const mirac_cache_key_s key = mirac_cache_key_from_parts(&arena, &config, source_file_path, source);
+
+	mirac_cache_key_s other_key = mirac_cache_key_from_parts(&arena, &config, source_file_path, source);
+	utester_assert_true(are_keys_equal(&key, &other_key));
+
+	other_key = mirac_cache_key_from_parts(&arena, &config, source_file_path, mirac_string_view_from_parts(source.data, 21));
+	utester_assert_true(!are_keys_equal(&key, &other_key));
+
+	// note: the jobs count does not affect the output.
+	config.jobs = 8;
+	other_key = mirac_cache_key_from_parts(&arena, &config, source_file_path, source);
+	utester_assert_true(are_keys_equal(&key, &other_key));
+
+	config.strip = true;
+	other_key = mirac_cache_key_from_parts(&arena, &config, source_file_path, source);
+	utester_assert_true(!are_keys_equal(&key, &other_key));
+	config.strip = false;
+
+	config.entry = mirac_string_view_from_parts("main", 4);
+	other_key = mirac_cache_key_from_parts(&arena, &config, source_file_path, source);
+	utester_assert_true(!are_keys_equal(&key, &other_key));
+	config.entry = mirac_string_view_from_parts("_start", 6);
+
+	mirac_string_view_s include_paths[] = { mirac_string_view_from_parts("std", 3) };
+	config.include_paths = include_paths;
+	config.include_paths_count = 1;
+	other_key = mirac_cache_key_from_parts(&arena, &config, source_file_path, source);
+	utester_assert_true(!are_keys_equal(&key, &other_key));
+
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(store_and_lookup_entries)
+{
+	char_t directory[] = "/tmp/mirac_cache_suite_XXXXXX";
+	utester_assert_true(mkdtemp(directory) != mirac_null);
+
+	char_t main_path[256] = {0};
+	char_t include_path[256] = {0};
+	char_t output_path[256] = {0};
+	char_t cache_path[256] = {0};
+	(void)snprintf(main_path, sizeof(main_path), "%s/main.mira", directory);
+	(void)snprintf(include_path, sizeof(include_path), "%s/size.mira", directory);
+	(void)snprintf(output_path, sizeof(output_path), "%s/main.asm", directory);
+	(void)snprintf(cache_path, sizeof(cache_path), "%s/cache", directory);
+
+	write_file(main_path, "#include \"size.mira\"\nsize\n");
+	write_file(include_path, "#define size 64\n");
+	write_file(output_path, "mov rax, 64\n");
+
+	mirac_config_s config = {0};
+	config.entry = mirac_string_view_from_parts("_start", 6);
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_interner_s interner = mirac_interner_from_parts(&arena);
+	mirac_preprocessor_cache_s preprocessor_cache = mirac_preprocessor_cache_from_parts(&arena);
+	mirac_cache_s cache = mirac_cache_from_parts(mirac_string_view_from_cstring(cache_path), mirac_cache_default_max_size);
+
+	mirac_file_t* const file = fopen(main_path, "rt");
+	utester_assert_true(file != mirac_null);
+
+	mirac_lexer_s lexer = mirac_lexer_from_parts(&config, &arena, &interner,
+		mirac_string_view_from_cstring(main_path), file);
+	mirac_preprocessor_s preprocessor = mirac_preprocessor_from_parts(&config, &arena, &preprocessor_cache, &lexer);
+	mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
+
+	while (mirac_preprocessor_lex_next(&preprocessor, &token) != mirac_token_type_eof);
+	utester_assert_true(1 == preprocessor.included_files.count);
+
+	const mirac_cache_key_s key = mirac_cache_key_from_parts(&arena, &config, lexer.file_path, lexer.source);
+	mirac_file_t* output_file = tmpfile();
+	utester_assert_true(!mirac_cache_lookup(&cache, &key, output_file));
+	(void)fclose(output_file);
+
+	mirac_cache_store(&cache, &key, &preprocessor, mirac_string_view_from_cstring(output_path));
+	utester_assert_true(1 == cache.stores_count);
+
+	output_file = tmpfile();
+	utester_assert_true(mirac_cache_lookup(&cache, &key, output_file));
+	rewind(output_file);
+	char_t assembly[64] = {0};
+	utester_assert_true(12 == fread(assembly, 1, sizeof(assembly), output_file));
+	utester_assert_true(0 == strcmp(assembly, "mov rax, 64\n"));
+	(void)fclose(output_file);
+
+	// note: the key only covers the main file, so changing an included file must
+	//       be detected by the entry itself.
+	write_file(include_path, "#define size 32\n");
+	output_file = tmpfile();
+	utester_assert_true(!mirac_cache_lookup(&cache, &key, output_file));
+	(void)fclose(output_file);
+
+	utester_assert_true(1 == cache.hits_count);
+	utester_assert_true(2 == cache.misses_count);
+
+	mirac_lexer_destroy(&lexer);
+	(void)fclose(file);
+	mirac_cache_destroy(&cache);
+	mirac_preprocessor_cache_destroy(&preprocessor_cache);
+	mirac_arena_destroy(&arena);
+
+	char_t command[512] = {0};
+	(void)snprintf(command, sizeof(command), "rm -rf '%s'", directory);
+	utester_assert_true(0 == system(command));
+}
+
+utester_define_test(key_covers_source_directory)
+{
+	char_t directory[] = "/tmp/mirac_cache_suite_XXXXXX";
+	utester_assert_true(mkdtemp(directory) != mirac_null);
+
+	char_t cache_path[256] = {0};
+	char_t output_path[256] = {0};
+	(void)snprintf(cache_path, sizeof(cache_path), "%s/cache", directory);
+	(void)snprintf(output_path, sizeof(output_path), "%s/main.asm", directory);
+	write_file(output_path, "a\n");
+
+	mirac_config_s config = {0};
+	config.entry = mirac_string_view_from_parts("_start", 6);
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_interner_s interner = mirac_interner_from_parts(&arena);
+	mirac_preprocessor_cache_s preprocessor_cache = mirac_preprocessor_cache_from_parts(&arena);
+	mirac_cache_s cache = mirac_cache_from_parts(mirac_string_view_from_cstring(cache_path), mirac_cache_default_max_size);
+
+	// note: both main files are the same, but their quoted includes resolve to
+	//       different files, so they must not share an entry.
+	static const char_t* const names[2] = { "a", "b" };
+	static const char_t* const values[2] = { "sec .data str value \"A\\0\"\n", "sec .data str value \"B\\0\"\n" };
+	mirac_cache_key_s keys[2] = {0};
+
+	for (uint64_t index = 0; index < 2; ++index)
+	{
+		char_t unit_path[64] = {0};
+		char_t main_path[256] = {0};
+		char_t local_path[256] = {0};
+		(void)snprintf(unit_path, sizeof(unit_path), "%s/%s", directory, names[index]);
+		(void)snprintf(main_path, sizeof(main_path), "%s/main.mira", unit_path);
+		(void)snprintf(local_path, sizeof(local_path), "%s/local.mira", unit_path);
+		utester_assert_true(0 == mkdir(unit_path, 0755));
+
+		write_file(main_path, "#include \"local.mira\"\n");
+		write_file(local_path, values[index]);
+
+		mirac_file_t* const file = fopen(main_path, "rt");
+		utester_assert_true(file != mirac_null);
+
+		mirac_lexer_s lexer = mirac_lexer_from_parts(&config, &arena, &interner,
+			mirac_string_view_from_cstring(main_path), file);
+		mirac_preprocessor_s preprocessor = mirac_preprocessor_from_parts(&config, &arena, &preprocessor_cache, &lexer);
+		mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
+
+		while (mirac_preprocessor_lex_next(&preprocessor, &token) != mirac_token_type_eof);
+		utester_assert_true(1 == preprocessor.included_files.count);
+
+		keys[index] = mirac_cache_key_from_parts(&arena, &config, lexer.file_path, lexer.source);
+		mirac_file_t* const output_file = tmpfile();
+		utester_assert_true(!mirac_cache_lookup(&cache, &keys[index], output_file));
+		(void)fclose(output_file);
+
+		mirac_cache_store(&cache, &keys[index], &preprocessor, mirac_string_view_from_cstring(output_path));
+		mirac_lexer_destroy(&lexer);
+		(void)fclose(file);
+	}
+
+	utester_assert_true(!are_keys_equal(&keys[0], &keys[1]));
+	utester_assert_true(2 == cache.stores_count);
+	utester_assert_true(2 == cache.misses_count);
+
+	mirac_cache_destroy(&cache);
+	mirac_preprocessor_cache_destroy(&preprocessor_cache);
+	mirac_arena_destroy(&arena);
+
+	char_t command[512] = {0};
+	(void)snprintf(command, sizeof(command), "rm -rf '%s'", directory);
+	utester_assert_true(0 == system(command));
+}
+
+utester_run_suite(cache_suite,
+	&hash_known_values,
+	&key_covers_source_and_config,
+	&store_and_lookup_entries,
+	&key_covers_source_directory
+);
@@ -0,0 +1,142 @@
+/**
+ * @file emitter_suite.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-01-24
+ */
+
+#include "utester.h"
+
+#include <mirac/arena.h>
+#include <mirac/emitter.h>
+#include <mirac/string_view.h>
+
+#include <stdio.h>
+
+static bool_t file_equals(
+	mirac_file_t* const file,
+	const char_t* const expected,
+	const uint64_t expected_length);
+
+utester_define_test(emit_integers)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_file_t* const file = tmpfile();
+	utester_assert_true(file != mirac_null);
+	mirac_emitter_s emitter = mirac_emitter_from_parts(&arena, file);
+
+	const uint64_t unsigned_values[] = { 0, 9, 10, 99, 100, 101, 12345, 1000000, UINT64_MAX };
+	for (uint64_t index = 0; index < (sizeof(unsigned_values) / sizeof(unsigned_values[0])); ++index)
+	{
+		mirac_emitter_emit_u64(&emitter, unsigned_values[index]);
+		mirac_emitter_emit_static(&emitter, " ");
+	}
+
+	const int64_t signed_values[] = { -1, -10, 42, INT64_MAX, INT64_MIN };
+	for (uint64_t index = 0; index < (sizeof(signed_values) / sizeof(signed_values[0])); ++index)
+	{
+		mirac_emitter_emit_i64(&emitter, signed_values[index]);
+		mirac_emitter_emit_static(&emitter, " ");
+	}
+
+	mirac_emitter_flush(&emitter);
+
+	static const char_t expected[] =
+		"0 9 10 99 100 101 12345 1000000 18446744073709551615 "
+		"-1 -10 42 9223372036854775807 -9223372036854775808 ";
+	utester_assert_true(file_equals(file, expected, sizeof(expected) - 1));
+
+	(void)fclose(file);
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(emit_across_flushes)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_file_t* const file = tmpfile();
+	utester_assert_true(file != mirac_null);
+	mirac_emitter_s emitter = mirac_emitter_from_parts(&arena, file);
+
+	const uint64_t expected_length = (mirac_emitter_capacity * 3) + 7;
+	char_t* const expected = (char_t*)mirac_arena_malloc(&arena, expected_length);
+
+	for (uint64_t index = 0; index < expected_length; ++index)
+	{
+		expected[index] = (char_t)('a' + (index % 26));
+	}
+
+	// note: small pieces that straddle the buffer's end, followed by a single piece
+	//       larger than the whole buffer.
+	const uint64_t small_length = mirac_emitter_capacity + 3;
+	for (uint64_t index = 0; index < small_length; index += 13)
+	{
+		const uint64_t length = (small_length - index) < 13 ? (small_length - index) : 13;
+		mirac_emitter_emit(&emitter, expected + index, length);
+	}
+
+	mirac_emitter_emit_string_view(&emitter, mirac_string_view_from_parts(
+		expected + small_length, expected_length - small_length));
+	mirac_emitter_flush(&emitter);
+
+	utester_assert_true(0 == emitter.length);
+	utester_assert_true(file_equals(file, expected, expected_length));
+
+	(void)fclose(file);
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(emit_after_buffered_stdio)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_file_t* const file = tmpfile();
+	utester_assert_true(file != mirac_null);
+	mirac_emitter_s emitter = mirac_emitter_from_parts(&arena, file);
+
+	(void)fprintf(file, "header\n");
+	mirac_emitter_emit_static(&emitter, "body\n");
+	mirac_emitter_flush(&emitter);
+
+	static const char_t expected[] = "header\nbody\n";
+	utester_assert_true(file_equals(file, expected, sizeof(expected) - 1));
+
+	(void)fclose(file);
+	mirac_arena_destroy(&arena);
+}
+
+utester_run_suite(emitter_suite,
+	&emit_integers,
+	&emit_across_flushes,
+	&emit_after_buffered_stdio
+);
+
+static bool_t file_equals(
+	mirac_file_t* const file,
+	const char_t* const expected,
+	const uint64_t expected_length)
+{
+	if (fseek(file, 0, SEEK_SET) != 0)
+	{
+		return false;
+	}
+
+	uint64_t offset = 0;
+	char_t chunk[4096] = {0};
+	uint64_t read = 0;
+
+	while ((read = (uint64_t)fread(chunk, 1, sizeof(chunk), file)) > 0)
+	{
+		if (((offset + read) > expected_length) ||
+			(mirac_c_memcmp((const uint8_t*)chunk, (const uint8_t*)(expected + offset), read) != 0))
+		{
+			return false;
+		}
+
+		offset += read;
+	}
+
+	return offset == expected_length;
+}
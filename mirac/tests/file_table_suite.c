@@ -0,0 +1,78 @@
+/**
+ * @file file_table_suite.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-04-06
+ */
+
+#include "utester.h"
+
+#include <mirac/file_table.h>
+
+utester_define_test(locate_positions)
+{
+	const mirac_string_view_s path = mirac_string_view_from_parts("lines.mira", 10);
+	const mirac_string_view_s source = mirac_string_view_from_parts("ab\n\ncde\nf", 9);
+	const mirac_file_id_t file = mirac_file_table_register(path, source);
+	utester_assert_true(file != mirac_file_id_none);
+	utester_assert_true(mirac_string_view_equal(path, mirac_file_table_get_path(file)));
+	utester_assert_true(source.data == mirac_file_table_get_source(file).data);
+
+	const uint32_t offsets[] = { 0, 1, 2, 3, 4, 6, 8, 9 };
+	const uint64_t lines[]   = { 1, 1, 1, 2, 3, 3, 4, 4 };
+	const uint64_t columns[] = { 1, 2, 3, 1, 1, 3, 1, 2 };
+
+	for (uint64_t index = 0; index < (sizeof(offsets) / sizeof(offsets[0])); ++index)
+	{
+		const mirac_location_s location = mirac_file_table_get_location(
+			(mirac_position_s) { .file = file, .offset = offsets[index] });
+		utester_assert_true(mirac_string_view_equal(path, location.file));
+		utester_assert_true(lines[index] == location.line);
+		utester_assert_true(columns[index] == location.column);
+	}
+
+	mirac_file_table_unregister(file);
+}
+
+utester_define_test(locate_without_file)
+{
+	const mirac_location_s location = mirac_file_table_get_location(
+		(mirac_position_s) { .file = mirac_file_id_none, .offset = 7 });
+	utester_assert_true(0 == location.file.length);
+	utester_assert_true(0 == location.line);
+	utester_assert_true(0 == location.column);
+}
+
+utester_define_test(reuse_unregistered_handles)
+{
+	const mirac_string_view_s source = mirac_string_view_from_parts("x\ny", 3);
+	const mirac_file_id_t first = mirac_file_table_register(mirac_string_view_from_parts("a", 1), source);
+	const mirac_file_id_t second = mirac_file_table_register(mirac_string_view_from_parts("b", 1), source);
+	utester_assert_true(first != second);
+
+	// note: index the lines of the first file, so that its reuse has to drop them.
+	utester_assert_true(2 == mirac_file_table_get_location((mirac_position_s) { .file = first, .offset = 2 }).line);
+	mirac_file_table_unregister(first);
+
+	const mirac_string_view_s other = mirac_string_view_from_parts("x", 1);
+	const mirac_file_id_t third = mirac_file_table_register(mirac_string_view_from_parts("c", 1), other);
+	utester_assert_true(first == third);
+	utester_assert_true(mirac_string_view_equal(mirac_string_view_from_parts("c", 1), mirac_file_table_get_path(third)));
+
+	const mirac_location_s location = mirac_file_table_get_location((mirac_position_s) { .file = third, .offset = 1 });
+	utester_assert_true(1 == location.line);
+	utester_assert_true(2 == location.column);
+
+	mirac_file_table_unregister(second);
+	mirac_file_table_unregister(third);
+}
+
+utester_run_suite(file_table_suite,
+	&locate_positions,
+	&locate_without_file,
+	&reuse_unregistered_handles
+);
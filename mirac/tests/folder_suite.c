@@ -0,0 +1,252 @@
+/**
+ * @file folder_suite.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-04-23
+ */
+
+#include "utester.h"
+
+#include <mirac/arena.h>
+#include <mirac/config.h>
+#include <mirac/interner.h>
+#include <mirac/lexer.h>
+#include <mirac/preprocessor.h>
+#include <mirac/parser.h>
+#include <mirac/folder.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// note: the body of the '_start' fun is folded and then written out as text,
+//       with the literals as their values, the scopes in braces, and the other
+//       blocks as their tokens or types.
+
+static void write_scope(
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block,
+	const bool_t has_braces,
+	char_t* const text,
+	uint64_t* const length);
+
+static void write_block(
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block,
+	char_t* const text,
+	uint64_t* const length);
+
+static bool_t folds_to(
+	const char_t* const body,
+	const char_t* const expected);
+
+utester_define_test(fold_arithmetic)
+{
+	utester_assert_true(folds_to("2 3 + 4 *", "20"));
+	utester_assert_true(folds_to("10 3 - 2 << 1 >> 0xff & 7 % ++ --", "0"));
+	utester_assert_true(folds_to("17 5 /%", "3 2"));
+	utester_assert_true(folds_to("0 ~ 1 70 <<", "18446744073709551615 64"));
+}
+
+utester_define_test(fold_logical_and_comparisons)
+{
+	utester_assert_true(folds_to("true false || true true ^^ &&", "0"));
+	utester_assert_true(folds_to("0 ! 256 ! 7 !", "1 256 0"));
+
+	// note: the comparisons are signed.
+	utester_assert_true(folds_to("0 1 - 5 < 5 0 1 - <= 3 3 >= 4 4 !=", "1 0 1 0"));
+}
+
+utester_define_test(fold_stack_operations)
+{
+	utester_assert_true(folds_to("1 2 swap -", "1"));
+	utester_assert_true(folds_to("1 2 3 rot", "2 3 1"));
+	utester_assert_true(folds_to("4 5 over * +", "24"));
+	utester_assert_true(folds_to("8 dup * 9 drop", "64"));
+
+	// note: nothing is left on the stack, so the run is removed.
+	utester_assert_true(folds_to("4 4 + drop", ""));
+}
+
+utester_define_test(keep_unknown_inputs)
+{
+	utester_assert_true(folds_to("buffer 8 + 2 3 * +", "buffer 8 + 6 +"));
+	utester_assert_true(folds_to("buffer 1 2 rot", "buffer 1 2 rot"));
+	utester_assert_true(folds_to("buffer ld64 1 1 + swap", "buffer ld64 2 swap"));
+	utester_assert_true(folds_to("1 2", "1 2"));
+
+	// note: the division by zero is left to happen at runtime.
+	utester_assert_true(folds_to("7 0 / 2 3 +", "7 0 / 5"));
+	utester_assert_true(folds_to("7 0 /%", "7 0 /%"));
+}
+
+utester_define_test(fold_nested_scopes)
+{
+	utester_assert_true(folds_to(
+		"loop [ 1 2 < ] { 4 4 + drop } if ( 2 2 == ) { buffer 1 1 + st08 } else { 3 ( 1 1 + ) }",
+		"loop { 1 } { } if { 1 } { buffer 2 st08 } else { 3 { 2 } }"));
+}
+
+utester_run_suite(folder_suite,
+	&fold_arithmetic,
+	&fold_logical_and_comparisons,
+	&fold_stack_operations,
+	&keep_unknown_inputs,
+	&fold_nested_scopes
+);
+
+static void write_scope(
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block,
+	const bool_t has_braces,
+	char_t* const text,
+	uint64_t* const length)
+{
+	const mirac_ast_range_s blocks = mirac_ast_unit_get_block_payload(unit, block)->as.scope_block.blocks;
+
+	if (has_braces)
+	{
+		*length += (uint64_t)sprintf(text + *length, "{");
+	}
+
+	for (uint64_t child_index = blocks.begin; child_index < ((uint64_t)blocks.begin + blocks.count); ++child_index)
+	{
+		if (*length > 0)
+		{
+			text[(*length)++] = ' ';
+		}
+
+		write_block(unit, unit->children.data[child_index], text, length);
+	}
+
+	if (has_braces)
+	{
+		*length += (uint64_t)sprintf(text + *length, " }");
+	}
+}
+
+static void write_block(
+	const mirac_ast_unit_s* const unit,
+	const mirac_ast_block_t block,
+	char_t* const text,
+	uint64_t* const length)
+{
+	const mirac_ast_block_payload_s* const payload = mirac_ast_unit_get_block_payload(unit, block);
+
+	switch (mirac_ast_unit_get_block_type(unit, block))
+	{
+		case mirac_ast_block_type_expr:
+		{
+			if (mirac_token_type_literal_u64 == payload->as.expr_block.token_type)
+			{
+				*length += (uint64_t)sprintf(text + *length, "%lu", payload->as.expr_block.as.uval);
+			}
+			else
+			{
+				const mirac_string_view_s name = mirac_token_type_to_string_view(payload->as.expr_block.token_type);
+				*length += (uint64_t)sprintf(text + *length, mirac_sv_fmt, mirac_sv_arg(name));
+			}
+		} break;
+
+		case mirac_ast_block_type_ident:
+		{
+			const mirac_token_s token = mirac_ast_unit_get_block_token(unit, block);
+			*length += (uint64_t)sprintf(text + *length, mirac_sv_fmt, mirac_sv_arg(mirac_token_get_ident(&token)));
+		} break;
+
+		case mirac_ast_block_type_scope:
+		{
+			write_scope(unit, block, true, text, length);
+		} break;
+
+		case mirac_ast_block_type_if:
+		{
+			*length += (uint64_t)sprintf(text + *length, "if ");
+			write_scope(unit, payload->as.if_block.cond, true, text, length);
+			*length += (uint64_t)sprintf(text + *length, " ");
+			write_scope(unit, payload->as.if_block.body, true, text, length);
+		} break;
+
+		case mirac_ast_block_type_else:
+		{
+			*length += (uint64_t)sprintf(text + *length, "else ");
+			write_scope(unit, payload->as.else_block.body, true, text, length);
+		} break;
+
+		case mirac_ast_block_type_loop:
+		{
+			*length += (uint64_t)sprintf(text + *length, "loop ");
+			write_scope(unit, payload->as.loop_block.cond, true, text, length);
+			*length += (uint64_t)sprintf(text + *length, " ");
+			write_scope(unit, payload->as.loop_block.body, true, text, length);
+		} break;
+
+		default:
+		{
+			const mirac_string_view_s name = mirac_ast_block_type_to_string_view(mirac_ast_unit_get_block_type(unit, block));
+			*length += (uint64_t)sprintf(text + *length, mirac_sv_fmt, mirac_sv_arg(name));
+		} break;
+	}
+}
+
+static bool_t folds_to(
+	const char_t* const body,
+	const char_t* const expected)
+{
+	char_t directory[] = "/tmp/mirac_folder_suite_XXXXXX";
+	if (mirac_null == mkdtemp(directory)) { return false; }
+
+	char_t main_path[256] = {0};
+	(void)snprintf(main_path, sizeof(main_path), "%s/main.mira", directory);
+
+	mirac_file_t* file = fopen(main_path, "wt");
+	if (mirac_null == file) { return false; }
+	(void)fprintf(file, "sec .bss mem buffer 8\nsec .text fun _start {\n%s\n}\n", body);
+	(void)fclose(file);
+
+	mirac_config_s config = {0};
+	config.entry = mirac_string_view_from_parts("_start", 6);
+	config.unsafe = true;
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_interner_s interner = mirac_interner_from_parts(&arena);
+	mirac_preprocessor_cache_s preprocessor_cache = mirac_preprocessor_cache_from_parts(&arena);
+
+	file = fopen(main_path, "rt");
+	if (mirac_null == file) { return false; }
+
+	mirac_lexer_s lexer = mirac_lexer_from_parts(&config, &arena, &interner,
+		mirac_string_view_from_cstring(main_path), file);
+	mirac_preprocessor_s preprocessor = mirac_preprocessor_from_parts(&config, &arena, &preprocessor_cache, &lexer);
+	mirac_parser_s parser = mirac_parser_from_parts(&config, &arena, &preprocessor, mirac_null);
+	mirac_ast_unit_s unit = mirac_parser_parse_ast_unit(&parser);
+
+	mirac_folder_s folder = mirac_folder_from_parts(&arena, &unit);
+	mirac_folder_fold_ast_unit(&folder);
+
+	static char_t text[4096];
+	uint64_t length = 0;
+	const mirac_ast_def_s* const def = unit.defs.data[unit.defs.count - 1];
+	write_scope(&unit, def->as.fun_def.body, false, text, &length);
+	text[length] = '\0';
+
+	const bool_t is_equal = (0 == strcmp(text, expected));
+	if (!is_equal)
+	{
+		(void)fprintf(stderr, "%s\n", text);
+	}
+
+	mirac_folder_destroy(&folder);
+	mirac_parser_destroy(&parser);
+	mirac_lexer_destroy(&lexer);
+	(void)fclose(file);
+	mirac_preprocessor_cache_destroy(&preprocessor_cache);
+	mirac_arena_destroy(&arena);
+
+	char_t command[512] = {0};
+	(void)snprintf(command, sizeof(command), "rm -rf '%s'", directory);
+	return (0 == system(command)) && is_equal;
+}
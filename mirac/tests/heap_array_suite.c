@@ -0,0 +1,99 @@
+/**
+ * @file heap_array_suite.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-01-21
+ */
+
+#include "utester.h"
+
+#include <mirac/arena.h>
+#include <mirac/heap_array.h>
+
+mirac_define_heap_array_type(int32_array, int32_t);
+mirac_implement_heap_array_type(int32_array, int32_t);
+
+utester_define_test(from_parts)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+	int32_array_s ints_array = int32_array_from_parts(&arena, 0);
+
+	utester_assert_true(mirac_null == ints_array.data);
+	utester_assert_true(0 == ints_array.capacity);
+	utester_assert_true(0 == ints_array.count);
+
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(push_and_pop)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+	int32_array_s ints_array = int32_array_from_parts(&arena, 0);
+
+	for (int32_t value = 0; value < 1000; ++value)
+	{
+		int32_array_push(&ints_array, value);
+	}
+
+	utester_assert_true(1000 == ints_array.count);
+	utester_assert_true(ints_array.capacity >= ints_array.count);
+	utester_assert_true(500 == *int32_array_at(&ints_array, 500));
+
+	int32_t element = 0;
+	utester_assert_true(int32_array_pop(&ints_array, &element));
+	utester_assert_true(999 == element);
+	utester_assert_true(999 == ints_array.count);
+
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(push_grows_in_place)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+	int32_array_s ints_array = int32_array_from_parts(&arena, 0);
+
+	int32_array_push(&ints_array, 0);
+	const int32_t* const data = ints_array.data;
+
+	for (int32_t value = 1; value < 256; ++value)
+	{
+		int32_array_push(&ints_array, value);
+	}
+
+	utester_assert_true(data == ints_array.data);
+	utester_assert_true(255 == ints_array.data[255]);
+
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(push_grows_by_copy)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+	int32_array_s ints_array = int32_array_from_parts(&arena, 0);
+
+	int32_array_push(&ints_array, 0);
+	const int32_t* const data = ints_array.data;
+	(void)mirac_arena_malloc(&arena, 1);
+
+	for (int32_t value = 1; value < 16; ++value)
+	{
+		int32_array_push(&ints_array, value);
+	}
+
+	utester_assert_true(data != ints_array.data);
+	utester_assert_true(0 == ints_array.data[0]);
+	utester_assert_true(15 == ints_array.data[15]);
+
+	mirac_arena_destroy(&arena);
+}
+
+utester_run_suite(heap_array_suite,
+	&from_parts,
+	&push_and_pop,
+	&push_grows_in_place,
+	&push_grows_by_copy
+);
@@ -0,0 +1,89 @@
+/**
+ * @file interner_suite.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-01-22
+ */
+
+#include "utester.h"
+
+#include <mirac/arena.h>
+#include <mirac/interner.h>
+#include <mirac/string_view.h>
+
+utester_define_test(intern_same_string)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_interner_s interner = mirac_interner_from_parts(&arena);
+
+	char_t buffer[] = "hello";
+	const mirac_symbol_t first = mirac_interner_intern(&interner, mirac_string_view_from_parts(buffer, 5));
+	buffer[0] = 'j';
+	const mirac_symbol_t second = mirac_interner_intern(&interner, mirac_string_view_from_parts("hello", 5));
+
+	utester_assert_true(first != mirac_symbol_none);
+	utester_assert_true(first == second);
+	utester_assert_true(1 == interner.entries.count);
+	utester_assert_true(mirac_string_view_equal(
+		mirac_interner_get_string(&interner, first), mirac_string_view_from_parts("hello", 5)));
+
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(intern_different_strings)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_interner_s interner = mirac_interner_from_parts(&arena);
+
+	const mirac_symbol_t hello = mirac_interner_intern(&interner, mirac_string_view_from_parts("hello", 5));
+	const mirac_symbol_t hell = mirac_interner_intern(&interner, mirac_string_view_from_parts("hell", 4));
+	const mirac_symbol_t empty = mirac_interner_intern(&interner, mirac_string_view_from_parts("", 0));
+
+	utester_assert_true(hello != hell);
+	utester_assert_true(hello != empty);
+	utester_assert_true(hell != empty);
+	utester_assert_true(0 == mirac_interner_get_string(&interner, empty).length);
+	utester_assert_true(mirac_string_view_hash(mirac_string_view_from_parts("hell", 4)) ==
+		mirac_interner_get_hash(&interner, hell));
+
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(intern_grows_slots)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_interner_s interner = mirac_interner_from_parts(&arena);
+	mirac_symbol_t symbols[1000] = {0};
+
+	for (uint64_t index = 0; index < 1000; ++index)
+	{
+		char_t string[32] = {0};
+		const int32_t length = snprintf(string, sizeof(string), "ident_%lu", index);
+		symbols[index] = mirac_interner_intern(&interner, mirac_string_view_from_parts(string, (uint64_t)length));
+		utester_assert_true((index + 1) == symbols[index]);
+	}
+
+	utester_assert_true(interner.slots_capacity >= 2000);
+
+	for (uint64_t index = 0; index < 1000; ++index)
+	{
+		char_t string[32] = {0};
+		const int32_t length = snprintf(string, sizeof(string), "ident_%lu", index);
+		const mirac_string_view_s view = mirac_string_view_from_parts(string, (uint64_t)length);
+		utester_assert_true(symbols[index] == mirac_interner_intern(&interner, view));
+		utester_assert_true(mirac_string_view_equal(view, mirac_interner_get_string(&interner, symbols[index])));
+	}
+
+	utester_assert_true(1000 == interner.entries.count);
+	mirac_arena_destroy(&arena);
+}
+
+utester_run_suite(interner_suite,
+	&intern_same_string,
+	&intern_different_strings,
+	&intern_grows_slots
+);
@@ -0,0 +1,194 @@
+/**
+ * @file lexer_suite.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-01-23
+ */
+
+#include "utester.h"
+
+#include <mirac/arena.h>
+#include <mirac/config.h>
+#include <mirac/interner.h>
+#include <mirac/lexer.h>
+
+utester_define_test(token_is_packed)
+{
+	// note: tokens are buffered by the thousand, so their size is kept in check.
+	utester_assert_true(24 == sizeof(mirac_token_s));
+}
+
+utester_define_test(lex_reserved_tokens)
+{
+	mirac_config_s config = {0};
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_interner_s interner = mirac_interner_from_parts(&arena);
+
+	mirac_file_t* const file = tmpfile();
+	utester_assert_true(file != mirac_null);
+
+	for (uint64_t type = 0; type <= mirac_token_type_reserved_count; ++type)
+	{
+		const mirac_string_view_s text = mirac_token_type_to_string_view((mirac_token_type_e)type);
+		(void)fprintf(file, mirac_sv_fmt "\n", mirac_sv_arg(text));
+	}
+
+	(void)fflush(file);
+	mirac_lexer_s lexer = mirac_lexer_from_parts(&config, &arena, &interner,
+		mirac_string_view_from_parts("reserved.mira", 13), file);
+	mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
+	utester_assert_true(lexer.is_source_mapped);
+
+	for (uint64_t type = 0; type <= mirac_token_type_reserved_count; ++type)
+	{
+		utester_assert_true(type == (uint64_t)mirac_lexer_lex_next(&lexer, &token));
+	}
+
+	utester_assert_true(mirac_token_type_eof == mirac_lexer_lex_next(&lexer, &token));
+
+	mirac_lexer_destroy(&lexer);
+	(void)fclose(file);
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(lex_reserved_look_alikes)
+{
+	mirac_config_s config = {0};
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_interner_s interner = mirac_interner_from_parts(&arena);
+
+	mirac_file_t* const file = tmpfile();
+	utester_assert_true(file != mirac_null);
+	(void)fprintf(file, "<<= dupx sys7 ld8 fals drip iff As st6 =\n");
+	(void)fflush(file);
+
+	mirac_lexer_s lexer = mirac_lexer_from_parts(&config, &arena, &interner,
+		mirac_string_view_from_parts("identifiers.mira", 16), file);
+	mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
+
+	for (uint64_t index = 0; index < 10; ++index)
+	{
+		utester_assert_true(mirac_token_type_identifier == mirac_lexer_lex_next(&lexer, &token));
+	}
+
+	utester_assert_true(mirac_token_type_eof == mirac_lexer_lex_next(&lexer, &token));
+
+	mirac_lexer_destroy(&lexer);
+	(void)fclose(file);
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(lex_literals)
+{
+	mirac_config_s config = {0};
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_interner_s interner = mirac_interner_from_parts(&arena);
+
+	mirac_file_t* const file = tmpfile();
+	utester_assert_true(file != mirac_null);
+	(void)fprintf(file, "\"plain\" \"esc\\n\" 42 0x2a 0b101010 0o52 -1\n");
+	(void)fflush(file);
+
+	mirac_lexer_s lexer = mirac_lexer_from_parts(&config, &arena, &interner,
+		mirac_string_view_from_parts("literals.mira", 13), file);
+	mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
+
+	utester_assert_true(mirac_token_type_literal_str == mirac_lexer_lex_next(&lexer, &token));
+	utester_assert_true(mirac_string_view_equal(mirac_token_get_string(&token), mirac_string_view_from_parts("plain", 5)));
+	utester_assert_true((mirac_token_get_text(&token).data + 1) == token.as.str);
+
+	utester_assert_true(mirac_token_type_literal_str == mirac_lexer_lex_next(&lexer, &token));
+	utester_assert_true(mirac_string_view_equal(mirac_token_get_string(&token), mirac_string_view_from_parts("esc\n", 4)));
+
+	for (uint64_t index = 0; index < 4; ++index)
+	{
+		utester_assert_true(mirac_token_type_literal_u64 == mirac_lexer_lex_next(&lexer, &token));
+		utester_assert_true(42 == token.as.uval);
+	}
+
+	utester_assert_true(mirac_token_type_literal_u64 == mirac_lexer_lex_next(&lexer, &token));
+	utester_assert_true(UINT64_MAX == token.as.uval);
+	utester_assert_true(mirac_token_type_eof == mirac_lexer_lex_next(&lexer, &token));
+
+	mirac_lexer_destroy(&lexer);
+	(void)fclose(file);
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(lex_from_pipe)
+{
+	mirac_config_s config = {0};
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_interner_s interner = mirac_interner_from_parts(&arena);
+
+	mirac_file_t* const file = popen("printf 'sec text\\nfun main'", "r");
+	utester_assert_true(file != mirac_null);
+
+	mirac_lexer_s lexer = mirac_lexer_from_parts(&config, &arena, &interner,
+		mirac_string_view_from_parts("pipe.mira", 9), file);
+	mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
+
+	utester_assert_true(!lexer.is_source_mapped);
+	utester_assert_true(mirac_token_type_reserved_sec == mirac_lexer_lex_next(&lexer, &token));
+	utester_assert_true(mirac_token_type_identifier == mirac_lexer_lex_next(&lexer, &token));
+	utester_assert_true(mirac_token_type_reserved_fun == mirac_lexer_lex_next(&lexer, &token));
+	utester_assert_true(mirac_token_type_identifier == mirac_lexer_lex_next(&lexer, &token));
+	utester_assert_true(mirac_string_view_equal(mirac_token_get_ident(&token), mirac_string_view_from_parts("main", 4)));
+	utester_assert_true(mirac_token_type_eof == mirac_lexer_lex_next(&lexer, &token));
+
+	mirac_lexer_destroy(&lexer);
+	(void)pclose(file);
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(lex_directives)
+{
+	mirac_config_s config = {0};
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_interner_s interner = mirac_interner_from_parts(&arena);
+
+	mirac_file_t* const file = tmpfile();
+	utester_assert_true(file != mirac_null);
+	(void)fprintf(file, "#include \"std/io.mira\" ; comment\n\t# define n 42\nn # endif\n#endif");
+	(void)fflush(file);
+
+	mirac_lexer_s lexer = mirac_lexer_from_parts(&config, &arena, &interner,
+		mirac_string_view_from_parts("directives.mira", 15), file);
+	mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
+
+	utester_assert_true(mirac_token_type_directive_include == mirac_lexer_lex_next(&lexer, &token));
+	utester_assert_true(mirac_token_type_literal_str == mirac_lexer_lex_next(&lexer, &token));
+	utester_assert_true(mirac_token_type_directive_end == mirac_lexer_lex_next(&lexer, &token));
+	utester_assert_true(mirac_token_type_directive_define == mirac_lexer_lex_next(&lexer, &token));
+	utester_assert_true(mirac_string_view_equal(mirac_token_get_text(&token), mirac_string_view_from_parts("# define", 8)));
+	utester_assert_true(2 == mirac_token_get_location(&token).line);
+	utester_assert_true(2 == mirac_token_get_location(&token).column);
+	utester_assert_true(mirac_token_type_identifier == mirac_lexer_lex_next(&lexer, &token));
+	utester_assert_true(mirac_token_type_literal_u64 == mirac_lexer_lex_next(&lexer, &token));
+	utester_assert_true(mirac_token_type_directive_end == mirac_lexer_lex_next(&lexer, &token));
+
+	// note: '#' is a directive only at the start of a line.
+	utester_assert_true(mirac_token_type_identifier == mirac_lexer_lex_next(&lexer, &token));
+	utester_assert_true(mirac_token_type_identifier == mirac_lexer_lex_next(&lexer, &token));
+	utester_assert_true(mirac_token_type_identifier == mirac_lexer_lex_next(&lexer, &token));
+	utester_assert_true(mirac_token_type_directive_endif == mirac_lexer_lex_next(&lexer, &token));
+	utester_assert_true(mirac_token_type_directive_end == mirac_lexer_lex_next(&lexer, &token));
+	utester_assert_true(mirac_token_type_eof == mirac_lexer_lex_next(&lexer, &token));
+
+	mirac_lexer_destroy(&lexer);
+	(void)fclose(file);
+	mirac_arena_destroy(&arena);
+}
+
+utester_run_suite(lexer_suite,
+	&token_is_packed,
+	&lex_reserved_tokens,
+	&lex_reserved_look_alikes,
+	&lex_literals,
+	&lex_from_pipe,
+	&lex_directives
+);
@@ -0,0 +1,157 @@
+/**
+ * @file preprocessor_suite.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-03-02
+ */
+
+#include "utester.h"
+
+#include <mirac/arena.h>
+#include <mirac/config.h>
+#include <mirac/interner.h>
+#include <mirac/lexer.h>
+#include <mirac/preprocessor.h>
+
+#include <sys/stat.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+static void write_file(
+	const char_t* const directory,
+	const char_t* const name,
+	const char_t* const content);
+
+static void write_file(
+	const char_t* const directory,
+	const char_t* const name,
+	const char_t* const content)
+{
+	char_t path[256] = {0};
+	(void)snprintf(path, sizeof(path), "%s/%s", directory, name);
+
+	mirac_file_t* const file = fopen(path, "wt");
+	mirac_debug_assert(file != mirac_null);
+	(void)fputs(content, file);
+	(void)fclose(file);
+}
+
+utester_define_test(expand_macros_and_conditions)
+{
+	mirac_config_s config = {0};
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_interner_s interner = mirac_interner_from_parts(&arena);
+	mirac_preprocessor_cache_s cache = mirac_preprocessor_cache_from_parts(&arena);
+
+	mirac_file_t* const file = tmpfile();
+	utester_assert_true(file != mirac_null);
+	(void)fprintf(file,
+		"#define n 42\n"
+		"#define m n n\n"
+		"#ifdef n\n m\n#else\n 7\n#endif\n"
+		"#ifndef n\n 8\n#ifdef n\n 9\n#endif\n#else\n#define r r\n r\n#endif\n"
+		"#undef n\n"
+		"n\n");
+	(void)fflush(file);
+
+	mirac_lexer_s lexer = mirac_lexer_from_parts(&config, &arena, &interner,
+		mirac_string_view_from_parts("main.mira", 9), file);
+	mirac_preprocessor_s preprocessor = mirac_preprocessor_from_parts(&config, &arena, &cache, &lexer);
+	mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
+
+	for (uint64_t index = 0; index < 2; ++index)
+	{
+		utester_assert_true(mirac_token_type_literal_u64 == mirac_preprocessor_lex_next(&preprocessor, &token));
+		utester_assert_true(42 == token.as.uval);
+		utester_assert_true(4 == mirac_token_get_location(&token).line);
+		utester_assert_true(2 == mirac_token_get_location(&token).column);
+		utester_assert_true(mirac_string_view_equal(mirac_token_get_text(&token), mirac_string_view_from_parts("m", 1)));
+	}
+
+	// note: a macro is not expanded within its own expansion.
+	utester_assert_true(mirac_token_type_identifier == mirac_preprocessor_lex_next(&preprocessor, &token));
+	utester_assert_true(mirac_string_view_equal(mirac_token_get_ident(&token), mirac_string_view_from_parts("r", 1)));
+
+	utester_assert_true(mirac_token_type_identifier == mirac_preprocessor_lex_next(&preprocessor, &token));
+	utester_assert_true(mirac_string_view_equal(mirac_token_get_ident(&token), mirac_string_view_from_parts("n", 1)));
+	utester_assert_true(token.symbol == mirac_interner_intern(&interner, mirac_string_view_from_parts("n", 1)));
+	utester_assert_true(mirac_token_type_eof == mirac_preprocessor_lex_next(&preprocessor, &token));
+	utester_assert_true(mirac_token_type_eof == mirac_preprocessor_lex_next(&preprocessor, &token));
+	utester_assert_true(0 == cache.lexed_files_count);
+
+	mirac_lexer_destroy(&lexer);
+	(void)fclose(file);
+	mirac_preprocessor_cache_destroy(&cache);
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(include_files_once)
+{
+	char_t directory[] = "/tmp/mirac_preprocessor_suite_XXXXXX";
+	utester_assert_true(mkdtemp(directory) != mirac_null);
+
+	char_t include_directory[256] = {0};
+	(void)snprintf(include_directory, sizeof(include_directory), "%s/std", directory);
+	utester_assert_true(0 == mkdir(include_directory, 0700));
+
+	write_file(include_directory, "guarded.mira", "#ifndef guarded\n#define guarded\n#include \"plain.mira\"\nsec .bss mem buffer size\n#endif\n");
+	write_file(include_directory, "plain.mira", "#define size 64\n");
+	write_file(directory, "main.mira", "#include <guarded.mira>\n#include \"std/guarded.mira\"\n#include \"std/plain.mira\"\nsize\n");
+
+	mirac_string_view_s include_paths[] = { mirac_string_view_from_cstring(include_directory) };
+	mirac_config_s config = {0};
+	config.include_paths = include_paths;
+	config.include_paths_count = 1;
+
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_preprocessor_cache_s cache = mirac_preprocessor_cache_from_parts(&arena);
+
+	char_t main_path[256] = {0};
+	(void)snprintf(main_path, sizeof(main_path), "%s/main.mira", directory);
+
+	for (uint64_t unit_index = 0; unit_index < 2; ++unit_index)
+	{
+		mirac_interner_s interner = mirac_interner_from_parts(&arena);
+		mirac_file_t* const file = fopen(main_path, "rt");
+		utester_assert_true(file != mirac_null);
+
+		mirac_lexer_s lexer = mirac_lexer_from_parts(&config, &arena, &interner,
+			mirac_string_view_from_cstring(main_path), file);
+		mirac_preprocessor_s preprocessor = mirac_preprocessor_from_parts(&config, &arena, &cache, &lexer);
+		mirac_token_s token = mirac_token_from_type(mirac_token_type_none);
+
+		utester_assert_true(mirac_token_type_reserved_sec == mirac_preprocessor_lex_next(&preprocessor, &token));
+		utester_assert_true(mirac_token_type_identifier == mirac_preprocessor_lex_next(&preprocessor, &token));
+		utester_assert_true(mirac_token_type_reserved_mem == mirac_preprocessor_lex_next(&preprocessor, &token));
+		utester_assert_true(mirac_token_type_identifier == mirac_preprocessor_lex_next(&preprocessor, &token));
+		utester_assert_true(token.symbol == mirac_interner_intern(&interner, mirac_string_view_from_parts("buffer", 6)));
+		utester_assert_true(mirac_token_type_literal_u64 == mirac_preprocessor_lex_next(&preprocessor, &token));
+		utester_assert_true(64 == token.as.uval);
+		utester_assert_true(mirac_token_type_literal_u64 == mirac_preprocessor_lex_next(&preprocessor, &token));
+		utester_assert_true(mirac_token_type_eof == mirac_preprocessor_lex_next(&preprocessor, &token));
+
+		mirac_lexer_destroy(&lexer);
+		(void)fclose(file);
+	}
+
+	// note: both files are lexed by the first include of the first unit only, every
+	//       other include (three per unit) reuses the cached tokens.
+	utester_assert_true(2 == cache.lexed_files_count);
+	utester_assert_true(6 == cache.reused_files_count);
+
+	mirac_preprocessor_cache_destroy(&cache);
+	mirac_arena_destroy(&arena);
+
+	char_t command[512] = {0};
+	(void)snprintf(command, sizeof(command), "rm -rf '%s'", directory);
+	utester_assert_true(0 == system(command));
+}
+
+utester_run_suite(preprocessor_suite,
+	&expand_macros_and_conditions,
+	&include_files_once
+);
@@ -0,0 +1,121 @@
+/**
+ * @file profiler_suite.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-03-23
+ */
+
+#include "utester.h"
+
+#include <mirac/arena.h>
+#include <mirac/profiler.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static void spin(
+	const uint64_t duration);
+
+static void spin(
+	const uint64_t duration)
+{
+	const uint64_t begin_time = mirac_profiler_now();
+	while ((mirac_profiler_now() - begin_time) < duration);
+}
+
+utester_define_test(phases_are_accumulated)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_profiler_s profiler = mirac_profiler_from_parts(&arena, false, false);
+
+	mirac_profiler_unit_s unit = mirac_profiler_unit_begin(&profiler, mirac_string_view_from_parts("a.mira", 6));
+	utester_assert_true(mirac_profiler_phase_lex == unit.phase);
+	spin(2000000);
+
+	utester_assert_true(mirac_profiler_phase_lex == mirac_profiler_unit_switch_phase(&unit, mirac_profiler_phase_parse));
+	spin(2000000);
+
+	// note: the interleaved phases switch back into the phase they interrupted.
+	utester_assert_true(mirac_profiler_phase_parse == mirac_profiler_unit_switch_phase(&unit, mirac_profiler_phase_resolve));
+	spin(1000000);
+	utester_assert_true(mirac_profiler_phase_resolve == mirac_profiler_unit_switch_phase(&unit, mirac_profiler_phase_parse));
+
+	(void)mirac_profiler_unit_switch_phase(&unit, mirac_profiler_phase_none);
+	spin(3000000);
+	(void)mirac_profiler_unit_switch_phase(&unit, mirac_profiler_phase_codegen);
+	spin(2000000);
+	mirac_profiler_unit_end(&unit);
+
+	utester_assert_true(1 == profiler.units_count);
+	utester_assert_true(profiler.wall_times[mirac_profiler_phase_lex] >= 2000000);
+	utester_assert_true(profiler.wall_times[mirac_profiler_phase_parse] >= 2000000);
+	utester_assert_true(profiler.wall_times[mirac_profiler_phase_resolve] >= 1000000);
+	utester_assert_true(profiler.wall_times[mirac_profiler_phase_codegen] >= 2000000);
+	utester_assert_true(0 == profiler.wall_times[mirac_profiler_phase_write]);
+
+	// note: the time spent in no phase is not counted anywhere.
+	uint64_t total_wall_time = 0;
+	for (uint64_t phase_index = 0; phase_index < mirac_profiler_phases_count; ++phase_index)
+	{
+		total_wall_time += profiler.wall_times[phase_index];
+	}
+
+	utester_assert_true(total_wall_time < (mirac_profiler_now() - unit.begin_time - 3000000));
+
+	// note: the busy loops above burn cpu, so all the phases that ran got a share.
+	utester_assert_true(profiler.cpu_times[mirac_profiler_phase_lex] > 0);
+	utester_assert_true(profiler.cpu_times[mirac_profiler_phase_parse] > 0);
+	utester_assert_true(profiler.cpu_times[mirac_profiler_phase_resolve] > 0);
+	utester_assert_true(profiler.cpu_times[mirac_profiler_phase_codegen] > 0);
+	utester_assert_true(0 == profiler.cpu_times[mirac_profiler_phase_write]);
+
+	// note: without tracing, no spans are recorded.
+	utester_assert_true(0 == profiler.spans.count);
+
+	mirac_profiler_destroy(&profiler);
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(trace_is_written)
+{
+	char_t path[] = "/tmp/mirac_profiler_suite_XXXXXX";
+	const int32_t descriptor = mkstemp(path);
+	utester_assert_true(descriptor >= 0);
+
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_profiler_s profiler = mirac_profiler_from_parts(&arena, true, true);
+
+	mirac_profiler_unit_s unit = mirac_profiler_unit_begin(&profiler, mirac_string_view_from_parts("dir/a\"b.mira", 12));
+	(void)mirac_profiler_unit_switch_phase(&unit, mirac_profiler_phase_codegen);
+	mirac_profiler_record_span(&profiler, "codegen", mirac_string_view_from_parts("main", 4), mirac_profiler_now());
+	mirac_profiler_unit_end(&unit);
+	utester_assert_true(2 == profiler.spans.count);
+
+	utester_assert_true(mirac_profiler_write_trace(&profiler, mirac_string_view_from_cstring(path)));
+
+	mirac_file_t* const file = fopen(path, "rt");
+	utester_assert_true(file != mirac_null);
+	char_t trace[1024] = {0};
+	(void)fread(trace, 1, sizeof(trace) - 1, file);
+	(void)fclose(file);
+
+	utester_assert_true(0 == strncmp(trace, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 39));
+	utester_assert_true(strstr(trace, "{\"name\":\"main\",\"cat\":\"codegen\",\"ph\":\"X\"") != mirac_null);
+	utester_assert_true(strstr(trace, "{\"name\":\"dir/a\\\"b.mira\",\"cat\":\"unit\",\"ph\":\"X\"") != mirac_null);
+	utester_assert_true(strstr(trace, "\n]}\n") != mirac_null);
+
+	mirac_profiler_destroy(&profiler);
+	mirac_arena_destroy(&arena);
+	(void)close(descriptor);
+	(void)remove(path);
+}
+
+utester_run_suite(profiler_suite,
+	&phases_are_accumulated,
+	&trace_is_written
+);
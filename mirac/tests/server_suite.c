@@ -0,0 +1,110 @@
+/**
+ * @file server_suite.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-03-16
+ */
+
+#include "utester.h"
+
+#include <mirac/arena.h>
+#include <mirac/config.h>
+#include <mirac/preprocessor.h>
+#include <mirac/server.h>
+
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+static int32_t count_source_files(
+	mirac_server_s* const server,
+	mirac_config_s* const config,
+	const char_t** const source_files,
+	const uint64_t source_files_count);
+
+static int32_t count_source_files(
+	mirac_server_s* const server,
+	mirac_config_s* const config,
+	const char_t** const source_files,
+	const uint64_t source_files_count)
+{
+	(void)server;
+	(void)source_files;
+
+	// note: the request has to run with the options of the client.
+	return config->strip ? (int32_t)source_files_count : -1;
+}
+
+utester_define_test(forward_without_server)
+{
+	const char_t* argv[] = { "mirac", "-a", "x86_64", "-f", "nasm", "-e", "_start", "a.mira", "a.asm" };
+	int32_t exit_code = 7;
+
+	utester_assert_true(!mirac_server_forward(mirac_string_view_from_parts("/tmp/mirac_server_suite_none.sock", 33),
+		(int32_t)(sizeof(argv) / sizeof(argv[0])), argv, &exit_code));
+	utester_assert_true(7 == exit_code);
+}
+
+utester_define_test(serve_requests)
+{
+	const char_t* const socket_path = "/tmp/mirac_server_suite.sock";
+	(void)unlink(socket_path);
+
+	const pid_t pid = fork();
+	utester_assert_true(pid >= 0);
+
+	if (0 == pid)
+	{
+		mirac_config_s config = {0};
+		config.jobs = 2;
+
+		mirac_arena_s arena = mirac_arena_from_parts();
+		mirac_preprocessor_cache_s preprocessor_cache = mirac_preprocessor_cache_from_parts(&arena);
+		mirac_server_s server = mirac_server_from_parts(&config, &arena, &preprocessor_cache, count_source_files);
+		exit(mirac_server_serve(&server, mirac_string_view_from_cstring(socket_path)));
+	}
+
+	struct stat status = {0};
+	const struct timespec interval = { .tv_sec = 0, .tv_nsec = 10000000 };
+
+	for (uint64_t attempt = 0; (attempt < 500) && (stat(socket_path, &status) != 0); ++attempt)
+	{
+		(void)nanosleep(&interval, mirac_null);
+	}
+
+	utester_assert_true(S_ISSOCK(status.st_mode));
+
+	const char_t* argv[] = { "mirac", "-a", "x86_64", "-f", "nasm", "-e", "_start", "-s", "a.mira", "a.asm", "b.mira", "b.asm" };
+	int32_t exit_code = 0;
+
+	for (uint64_t request_index = 0; request_index < 3; ++request_index)
+	{
+		utester_assert_true(mirac_server_forward(mirac_string_view_from_cstring(socket_path),
+			(int32_t)(sizeof(argv) / sizeof(argv[0])), argv, &exit_code));
+		utester_assert_true(4 == exit_code);
+	}
+
+	// note: without the strip option, the request exits with -1 (255).
+	argv[7] = "-u";
+	utester_assert_true(mirac_server_forward(mirac_string_view_from_cstring(socket_path),
+		(int32_t)(sizeof(argv) / sizeof(argv[0])), argv, &exit_code));
+	utester_assert_true(255 == exit_code);
+
+	int32_t server_status = 0;
+	utester_assert_true(0 == kill(pid, SIGTERM));
+	utester_assert_true(pid == waitpid(pid, &server_status, 0));
+	utester_assert_true(WIFEXITED(server_status) && (0 == WEXITSTATUS(server_status)));
+	utester_assert_true(stat(socket_path, &status) != 0);
+}
+
+utester_run_suite(server_suite,
+	&forward_without_server,
+	&serve_requests
+);
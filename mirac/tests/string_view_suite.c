@@ -290,6 +290,64 @@ utester_define_test(split_left_white_space)
 	utester_assert_true(6 == white_space_length);
 }
 
+utester_define_test(scanners_equivalence)
+{
+	// note: texts are made of random runs of white space and other chars, and are
+	//       scanned at many offsets and lengths, so that both the simd block loops
+	//       and the scalar tails are covered.
+	const char_t white_spaces[] = { ' ', '\t', '\n', '\r' };
+	const char_t others[] = { 'a', 'z', '\"', '\\', (char_t)0x80, (char_t)0xff };
+	char_t text[256] = {0};
+	uint64_t seed = 42;
+	uint64_t mismatches[mirac_string_view_scanner_count] = {0};
+
+	for (uint64_t round = 0; round < 32; ++round)
+	{
+		for (uint64_t index = 0; index < sizeof(text);)
+		{
+			seed = (seed * 6364136223846793005) + 1442695040888963407;
+			const bool_t is_white_space_run = ((seed >> 63) != 0);
+			const uint64_t run_length = 1 + ((seed >> 40) % 48);
+
+			for (uint64_t run_index = 0; (run_index < run_length) && (index < sizeof(text)); ++run_index, ++index)
+			{
+				const uint64_t pick = (seed >> (run_index % 32)) + run_index;
+				text[index] = is_white_space_run ? white_spaces[pick % sizeof(white_spaces)] : others[pick % sizeof(others)];
+			}
+		}
+
+		for (uint64_t offset = 0; offset < 40; ++offset)
+		{
+			for (uint64_t length = 0; (offset + length) <= sizeof(text); length += 5)
+			{
+				const mirac_string_view_s view = mirac_string_view_from_parts(text + offset, length);
+				const char_t char_to_find = others[(offset + round) % sizeof(others)];
+
+				(void)mirac_string_view_use_scanner(mirac_string_view_scanner_scalar);
+				const uint64_t expected_char = mirac_string_view_find_char(view, char_to_find);
+				const uint64_t expected_white_space = mirac_string_view_find_white_space(view);
+				const uint64_t expected_non_white_space = mirac_string_view_find_non_white_space(view);
+
+				for (int32_t scanner = 1; scanner < mirac_string_view_scanner_count; ++scanner)
+				{
+					if (!mirac_string_view_use_scanner((mirac_string_view_scanner_e)scanner))
+					{
+						continue;
+					}
+
+					mismatches[scanner] += (expected_char != mirac_string_view_find_char(view, char_to_find));
+					mismatches[scanner] += (expected_white_space != mirac_string_view_find_white_space(view));
+					mismatches[scanner] += (expected_non_white_space != mirac_string_view_find_non_white_space(view));
+				}
+			}
+		}
+	}
+
+	utester_assert_true(mirac_string_view_use_scanner(mirac_string_view_scanner_scalar));
+	utester_assert_true(0 == mismatches[mirac_string_view_scanner_sse2]);
+	utester_assert_true(0 == mismatches[mirac_string_view_scanner_avx2]);
+}
+
 utester_run_suite(string_view_suite,
 	&from_parts,
 	&from_cstring,
@@ -300,5 +358,6 @@ utester_run_suite(string_view_suite,
 	&trim,
 	&trim_left_white_space,
 	&split_left,
-	&split_left_white_space
+	&split_left_white_space,
+	&scanners_equivalence
 );
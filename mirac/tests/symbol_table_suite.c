@@ -0,0 +1,87 @@
+/**
+ * @file symbol_table_suite.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-01-22
+ */
+
+#include "utester.h"
+
+#include <mirac/arena.h>
+#include <mirac/interner.h>
+#include <mirac/symbol_table.h>
+
+mirac_define_symbol_table_type(int32_table, int32_t);
+mirac_implement_symbol_table_type(int32_table, int32_t);
+
+utester_define_test(from_parts)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_interner_s interner = mirac_interner_from_parts(&arena);
+	int32_table_s ints_table = int32_table_from_parts(&arena, &interner);
+
+	const mirac_symbol_t symbol = mirac_interner_intern(&interner, mirac_string_view_from_parts("a", 1));
+	int32_t value = 0;
+
+	utester_assert_true(0 == ints_table.count);
+	utester_assert_true(!int32_table_find(&ints_table, symbol, &value));
+
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(insert_and_find)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_interner_s interner = mirac_interner_from_parts(&arena);
+	int32_table_s ints_table = int32_table_from_parts(&arena, &interner);
+
+	for (int32_t index = 0; index < 1000; ++index)
+	{
+		char_t string[32] = {0};
+		const int32_t length = snprintf(string, sizeof(string), "ident_%d", index);
+		const mirac_symbol_t symbol = mirac_interner_intern(&interner, mirac_string_view_from_parts(string, (uint64_t)length));
+		utester_assert_true(int32_table_insert(&ints_table, symbol, index));
+	}
+
+	utester_assert_true(1000 == ints_table.count);
+
+	for (int32_t index = 0; index < 1000; ++index)
+	{
+		char_t string[32] = {0};
+		const int32_t length = snprintf(string, sizeof(string), "ident_%d", index);
+		const mirac_symbol_t symbol = mirac_interner_intern(&interner, mirac_string_view_from_parts(string, (uint64_t)length));
+		int32_t value = -1;
+		utester_assert_true(int32_table_find(&ints_table, symbol, &value));
+		utester_assert_true(index == value);
+	}
+
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(insert_existing)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_interner_s interner = mirac_interner_from_parts(&arena);
+	int32_table_s ints_table = int32_table_from_parts(&arena, &interner);
+
+	const mirac_symbol_t symbol = mirac_interner_intern(&interner, mirac_string_view_from_parts("a", 1));
+	int32_t value = 0;
+
+	utester_assert_true(int32_table_insert(&ints_table, symbol, 1));
+	utester_assert_true(!int32_table_insert(&ints_table, symbol, 2));
+	utester_assert_true(int32_table_find(&ints_table, symbol, &value));
+	utester_assert_true(1 == value);
+	utester_assert_true(1 == ints_table.count);
+
+	mirac_arena_destroy(&arena);
+}
+
+utester_run_suite(symbol_table_suite,
+	&from_parts,
+	&insert_and_find,
+	&insert_existing
+);
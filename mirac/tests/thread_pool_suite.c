@@ -0,0 +1,88 @@
+/**
+ * @file thread_pool_suite.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-01-25
+ */
+
+#include "utester.h"
+
+#include <mirac/thread_pool.h>
+
+#define jobs_count 1000
+
+typedef struct
+{
+	uint64_t workers_count;
+	uint64_t runs[jobs_count];
+	uint64_t bad_workers_count;
+} counting_context_s;
+
+static void count_job(
+	void* const context,
+	const uint64_t job_index,
+	const uint64_t worker_index);
+
+utester_define_test(run_every_job_once)
+{
+	mirac_thread_pool_s pool = mirac_thread_pool_from_parts(4);
+	static counting_context_s context = {0};
+	context.workers_count = pool.workers_count;
+
+	mirac_thread_pool_run(&pool, jobs_count, count_job, &context);
+	mirac_thread_pool_run(&pool, jobs_count, count_job, &context);
+	mirac_thread_pool_run(&pool, 0, count_job, &context);
+
+	uint64_t wrong_runs_count = 0;
+	for (uint64_t job_index = 0; job_index < jobs_count; ++job_index)
+	{
+		wrong_runs_count += (context.runs[job_index] != 2) ? 1 : 0;
+	}
+
+	utester_assert_true(0 == wrong_runs_count);
+	utester_assert_true(0 == context.bad_workers_count);
+	mirac_thread_pool_destroy(&pool);
+}
+
+utester_define_test(run_on_calling_thread)
+{
+	mirac_thread_pool_s pool = mirac_thread_pool_from_parts(1);
+	static counting_context_s context = {0};
+	context.workers_count = pool.workers_count;
+
+	mirac_thread_pool_run(&pool, jobs_count, count_job, &context);
+
+	uint64_t wrong_runs_count = 0;
+	for (uint64_t job_index = 0; job_index < jobs_count; ++job_index)
+	{
+		wrong_runs_count += (context.runs[job_index] != 1) ? 1 : 0;
+	}
+
+	utester_assert_true(0 == wrong_runs_count);
+	utester_assert_true(0 == context.bad_workers_count);
+	utester_assert_true(mirac_null == pool.threads);
+	mirac_thread_pool_destroy(&pool);
+}
+
+utester_run_suite(thread_pool_suite,
+	&run_every_job_once,
+	&run_on_calling_thread
+);
+
+static void count_job(
+	void* const context,
+	const uint64_t job_index,
+	const uint64_t worker_index)
+{
+	counting_context_s* const counting_context = (counting_context_s*)context;
+	__atomic_fetch_add(&counting_context->runs[job_index], 1, __ATOMIC_RELAXED);
+
+	if (worker_index >= counting_context->workers_count)
+	{
+		__atomic_fetch_add(&counting_context->bad_workers_count, 1, __ATOMIC_RELAXED);
+	}
+}
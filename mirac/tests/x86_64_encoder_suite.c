@@ -0,0 +1,254 @@
+/**
+ * @file x86_64_encoder_suite.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-04-20
+ */
+
+#include "utester.h"
+
+#include <mirac/arena.h>
+#include <mirac/emitter.h>
+#include <mirac/string_view.h>
+
+#include <mirac/archs/x86_64_encoder.h>
+
+// note: the expected bytes are the ones the gnu assembler produces for the same
+//       instructions, except for the immediates and displacements that are always
+//       32 bits wide here (so that they can be relocated), and 'test rax, imm',
+//       which is not given its shorter accumulator form.
+
+static bool_t emitted_equals(
+	const mirac_emitter_s* const emitter,
+	const uint8_t* const expected,
+	const uint64_t expected_length);
+
+utester_define_test(register_from_string_view)
+{
+	utester_assert_true(x86_64_register_rax == x86_64_register_from_string_view(mirac_string_view_from_cstring("rax")));
+	utester_assert_true(x86_64_register_rdi == x86_64_register_from_string_view(mirac_string_view_from_cstring("rdi")));
+	utester_assert_true(x86_64_register_r8 == x86_64_register_from_string_view(mirac_string_view_from_cstring("r8")));
+	utester_assert_true(x86_64_register_r15 == x86_64_register_from_string_view(mirac_string_view_from_cstring("r15")));
+	utester_assert_true(x86_64_register_none == x86_64_register_from_string_view(mirac_string_view_from_cstring("eax")));
+	utester_assert_true(x86_64_register_none == x86_64_register_from_string_view(mirac_string_view_from_cstring("r5")));
+}
+
+utester_define_test(encode_push_and_pop)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_emitter_s emitter = mirac_emitter_from_parts(&arena, mirac_null);
+
+	x86_64_encode_push_register(&emitter, x86_64_register_rax);
+	x86_64_encode_push_register(&emitter, x86_64_register_r12);
+	x86_64_encode_pop_register(&emitter, x86_64_register_rdi);
+	x86_64_encode_pop_register(&emitter, x86_64_register_r15);
+	utester_assert_true(7 == x86_64_encode_push_immediate(&emitter, -2));
+
+	static const uint8_t expected[] =
+	{
+		0x50,                         // push rax
+		0x41, 0x54,                   // push r12
+		0x5f,                         // pop rdi
+		0x41, 0x5f,                   // pop r15
+		0x68, 0xfe, 0xff, 0xff, 0xff  // push -2
+	};
+	utester_assert_true(emitted_equals(&emitter, expected, sizeof(expected)));
+
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(encode_mov)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_emitter_s emitter = mirac_emitter_from_parts(&arena, mirac_null);
+
+	x86_64_encode_mov_register_register(&emitter, x86_64_register_rax, x86_64_register_rsp);
+	x86_64_encode_mov_register_register(&emitter, x86_64_register_r8, x86_64_register_rax);
+	x86_64_encode_mov_register_immediate(&emitter, x86_64_register_rax, 1);
+	x86_64_encode_mov_register_immediate(&emitter, x86_64_register_r9, 1);
+	x86_64_encode_mov_register_immediate(&emitter, x86_64_register_rax, (uint64_t)-1);
+	x86_64_encode_mov_register_immediate(&emitter, x86_64_register_rax, 0x100000000);
+	utester_assert_true(36 == x86_64_encode_mov_register_immediate64(&emitter, x86_64_register_rcx, 0));
+
+	static const uint8_t expected[] =
+	{
+		0x48, 0x89, 0xe0,                                            // mov rax, rsp
+		0x49, 0x89, 0xc0,                                            // mov r8, rax
+		0xb8, 0x01, 0x00, 0x00, 0x00,                                // mov eax, 1
+		0x41, 0xb9, 0x01, 0x00, 0x00, 0x00,                          // mov r9d, 1
+		0x48, 0xc7, 0xc0, 0xff, 0xff, 0xff, 0xff,                    // mov rax, -1
+		0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,  // movabs rax, 0x100000000
+		0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00   // movabs rcx, 0
+	};
+	utester_assert_true(emitted_equals(&emitter, expected, sizeof(expected)));
+
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(encode_load_and_store)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_emitter_s emitter = mirac_emitter_from_parts(&arena, mirac_null);
+
+	x86_64_encode_load(&emitter, x86_64_size_08, x86_64_register_rbx, x86_64_register_rax);
+	x86_64_encode_load(&emitter, x86_64_size_16, x86_64_register_rbx, x86_64_register_rax);
+	x86_64_encode_load(&emitter, x86_64_size_32, x86_64_register_rbx, x86_64_register_rax);
+	x86_64_encode_load(&emitter, x86_64_size_64, x86_64_register_rbx, x86_64_register_rax);
+	x86_64_encode_load(&emitter, x86_64_size_08, x86_64_register_rsi, x86_64_register_r12);
+	x86_64_encode_load(&emitter, x86_64_size_64, x86_64_register_rax, x86_64_register_rbp);
+	x86_64_encode_load(&emitter, x86_64_size_64, x86_64_register_rax, x86_64_register_r13);
+	x86_64_encode_store(&emitter, x86_64_size_08, x86_64_register_rax, x86_64_register_rbx);
+	x86_64_encode_store(&emitter, x86_64_size_08, x86_64_register_rax, x86_64_register_rsi);
+	x86_64_encode_store(&emitter, x86_64_size_16, x86_64_register_rax, x86_64_register_rbx);
+	x86_64_encode_store(&emitter, x86_64_size_64, x86_64_register_rsp, x86_64_register_r9);
+	utester_assert_true(38 == x86_64_encode_load_absolute(&emitter, x86_64_register_rsp, 0));
+	utester_assert_true(46 == x86_64_encode_store_absolute(&emitter, 0x10, x86_64_register_rax));
+	x86_64_encode_load_zero_extended(&emitter, x86_64_size_08, x86_64_register_rbx, x86_64_register_rax);
+	x86_64_encode_load_zero_extended(&emitter, x86_64_size_16, x86_64_register_r12, x86_64_register_r13);
+
+	static const uint8_t expected[] =
+	{
+		0x8a, 0x18,                                      // mov bl, [rax]
+		0x66, 0x8b, 0x18,                                // mov bx, [rax]
+		0x8b, 0x18,                                      // mov ebx, [rax]
+		0x48, 0x8b, 0x18,                                // mov rbx, [rax]
+		0x41, 0x8a, 0x34, 0x24,                          // mov sil, [r12]
+		0x48, 0x8b, 0x45, 0x00,                          // mov rax, [rbp]
+		0x49, 0x8b, 0x45, 0x00,                          // mov rax, [r13]
+		0x88, 0x18,                                      // mov [rax], bl
+		0x40, 0x88, 0x30,                                // mov [rax], sil
+		0x66, 0x89, 0x18,                                // mov [rax], bx
+		0x4c, 0x89, 0x0c, 0x24,                          // mov [rsp], r9
+		0x48, 0x8b, 0x24, 0x25, 0x00, 0x00, 0x00, 0x00,  // mov rsp, [0]
+		0x48, 0x89, 0x04, 0x25, 0x10, 0x00, 0x00, 0x00,  // mov [0x10], rax
+		0x48, 0x0f, 0xb6, 0x18,                          // movzx rbx, byte [rax]
+		0x4d, 0x0f, 0xb7, 0x65, 0x00                     // movzx r12, word [r13]
+	};
+	utester_assert_true(emitted_equals(&emitter, expected, sizeof(expected)));
+
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(encode_arithmetic)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_emitter_s emitter = mirac_emitter_from_parts(&arena, mirac_null);
+
+	x86_64_encode_binary_register_register(&emitter, x86_64_binary_add, x86_64_register_rax, x86_64_register_rbx);
+	x86_64_encode_binary_register_register(&emitter, x86_64_binary_xor, x86_64_register_rdx, x86_64_register_rdx);
+	x86_64_encode_binary_register_register(&emitter, x86_64_binary_test, x86_64_register_rax, x86_64_register_rax);
+	x86_64_encode_binary_register_register(&emitter, x86_64_binary_sub, x86_64_register_r10, x86_64_register_r11);
+	x86_64_encode_binary_register_immediate(&emitter, x86_64_binary_cmp, x86_64_register_rax, 0);
+	x86_64_encode_binary_register_immediate(&emitter, x86_64_binary_add, x86_64_register_r9, 0x1000);
+	x86_64_encode_binary_register_immediate(&emitter, x86_64_binary_test, x86_64_register_rax, 5);
+	x86_64_encode_unary(&emitter, x86_64_unary_not, x86_64_register_rax);
+	x86_64_encode_unary(&emitter, x86_64_unary_shl, x86_64_register_rbx);
+	x86_64_encode_unary(&emitter, x86_64_unary_inc, x86_64_register_rax);
+	x86_64_encode_unary(&emitter, x86_64_unary_div, x86_64_register_rcx);
+	x86_64_encode_unary(&emitter, x86_64_unary_neg, x86_64_register_r8);
+	x86_64_encode_imul_register_register(&emitter, x86_64_register_rax, x86_64_register_rbx);
+	x86_64_encode_imul_register_register(&emitter, x86_64_register_r12, x86_64_register_r8);
+	x86_64_encode_clear_register(&emitter, x86_64_register_rcx);
+	x86_64_encode_clear_register(&emitter, x86_64_register_r9);
+
+	static const uint8_t expected[] =
+	{
+		0x48, 0x01, 0xd8,                          // add rax, rbx
+		0x48, 0x31, 0xd2,                          // xor rdx, rdx
+		0x48, 0x85, 0xc0,                          // test rax, rax
+		0x4d, 0x29, 0xda,                          // sub r10, r11
+		0x48, 0x83, 0xf8, 0x00,                    // cmp rax, 0
+		0x49, 0x81, 0xc1, 0x00, 0x10, 0x00, 0x00,  // add r9, 0x1000
+		0x48, 0xf7, 0xc0, 0x05, 0x00, 0x00, 0x00,  // test rax, 5
+		0x48, 0xf7, 0xd0,                          // not rax
+		0x48, 0xd3, 0xe3,                          // shl rbx, cl
+		0x48, 0xff, 0xc0,                          // inc rax
+		0x48, 0xf7, 0xf1,                          // div rcx
+		0x49, 0xf7, 0xd8,                          // neg r8
+		0x48, 0x0f, 0xaf, 0xc3,                    // imul rax, rbx
+		0x4d, 0x0f, 0xaf, 0xe0,                    // imul r12, r8
+		0x31, 0xc9,                                // xor ecx, ecx
+		0x45, 0x31, 0xc9                           // xor r9d, r9d
+	};
+	utester_assert_true(emitted_equals(&emitter, expected, sizeof(expected)));
+
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(encode_conditions)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_emitter_s emitter = mirac_emitter_from_parts(&arena, mirac_null);
+
+	x86_64_encode_cmov(&emitter, x86_64_condition_equal, x86_64_register_rcx, x86_64_register_rdx);
+	x86_64_encode_cmov(&emitter, x86_64_condition_greater_equal, x86_64_register_r8, x86_64_register_rdx);
+	x86_64_encode_set(&emitter, x86_64_condition_equal, x86_64_register_rax);
+	x86_64_encode_set(&emitter, x86_64_condition_less, x86_64_register_rsi);
+	x86_64_encode_zero_extend_byte(&emitter, x86_64_register_rcx, x86_64_register_rcx);
+	x86_64_encode_zero_extend_byte(&emitter, x86_64_register_rax, x86_64_register_rsi);
+	x86_64_encode_zero_extend_byte(&emitter, x86_64_register_r8, x86_64_register_r9);
+
+	static const uint8_t expected[] =
+	{
+		0x48, 0x0f, 0x44, 0xca,  // cmove rcx, rdx
+		0x4c, 0x0f, 0x4d, 0xc2,  // cmovge r8, rdx
+		0x0f, 0x94, 0xc0,        // sete al
+		0x40, 0x0f, 0x9c, 0xc6,  // setl sil
+		0x0f, 0xb6, 0xc9,        // movzx ecx, cl
+		0x40, 0x0f, 0xb6, 0xc6,  // movzx eax, sil
+		0x45, 0x0f, 0xb6, 0xc1   // movzx r8d, r9b
+	};
+	utester_assert_true(emitted_equals(&emitter, expected, sizeof(expected)));
+
+	mirac_arena_destroy(&arena);
+}
+
+utester_define_test(encode_and_patch_jumps)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+	mirac_emitter_s emitter = mirac_emitter_from_parts(&arena, mirac_null);
+
+	const uint64_t jcc_offset = x86_64_encode_jcc(&emitter, x86_64_condition_equal, 0);
+	const uint64_t call_offset = x86_64_encode_call(&emitter, 0);
+	const uint64_t jmp_offset = x86_64_encode_jmp(&emitter, 0);
+	utester_assert_true(2 == jcc_offset);
+	utester_assert_true(7 == call_offset);
+	utester_assert_true(12 == jmp_offset);
+
+	x86_64_patch_displacement(&emitter, jcc_offset, emitter.length);
+	x86_64_patch_displacement(&emitter, jmp_offset, 0);
+	x86_64_patch_displacement(&emitter, call_offset, call_offset + 4);
+
+	static const uint8_t expected[] =
+	{
+		0x0f, 0x84, 0x0a, 0x00, 0x00, 0x00,  // je +10
+		0xe8, 0x00, 0x00, 0x00, 0x00,        // call +0
+		0xe9, 0xf0, 0xff, 0xff, 0xff         // jmp -16
+	};
+	utester_assert_true(emitted_equals(&emitter, expected, sizeof(expected)));
+
+	mirac_arena_destroy(&arena);
+}
+
+utester_run_suite(x86_64_encoder_suite,
+	&register_from_string_view,
+	&encode_push_and_pop,
+	&encode_mov,
+	&encode_load_and_store,
+	&encode_arithmetic,
+	&encode_conditions,
+	&encode_and_patch_jumps
+);
+
+static bool_t emitted_equals(
+	const mirac_emitter_s* const emitter,
+	const uint8_t* const expected,
+	const uint64_t expected_length)
+{
+	return (emitter->length == expected_length) &&
+		(0 == mirac_c_memcmp((const uint8_t*)emitter->data, expected, expected_length));
+}
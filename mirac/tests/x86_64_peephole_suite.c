@@ -0,0 +1,406 @@
+/**
+ * @file x86_64_peephole_suite.c
+ * 
+ * @copyright This file is part of the "mira" project and is distributed under
+ * "mira gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2024-04-22
+ */
+
+#include "utester.h"
+
+#include <mirac/arena.h>
+#include <mirac/emitter.h>
+#include <mirac/string_view.h>
+
+#include <mirac/archs/x86_64_instruction.h>
+#include <mirac/archs/x86_64_peephole.h>
+
+#include <limits.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+// note: the patterns are tested on the instruction lists that are built here,
+//       and the optimized lists are compared as the nasm code they print as.
+
+// note: the example projects are built into executables with the compiler from
+//       the build directory (in the elf64-exec format, so that neither the
+//       assembler nor the linker is needed) without and with the optimizations,
+//       and have to print the same and exit with the same status (both are run
+//       from the same path, as the cli_args example prints it). The tests fail
+//       if the compiler is not built. The webserver example serves until it is
+//       killed, so it is not run.
+
+#define qword(_reg) x86_64_operand_from_register(x86_64_register_ ## _reg, x86_64_size_64)
+#define dword(_reg) x86_64_operand_from_register(x86_64_register_ ## _reg, x86_64_size_32)
+#define imm(_value) x86_64_operand_from_immediate(_value)
+#define none x86_64_operand_none
+
+#define op(_mnemonic, _first, _second) \
+	x86_64_instruction_from_operation(x86_64_mnemonic_ ## _mnemonic, (_first), (_second))
+
+#define cond(_mnemonic, _condition, _first, _second) \
+	x86_64_instruction_from_condition(x86_64_mnemonic_ ## _mnemonic, x86_64_condition_ ## _condition, (_first), (_second))
+
+#define label(_name) x86_64_instruction_from_label(mirac_string_view_from_cstring(_name), x86_64_label_no_index)
+#define comment(_name) x86_64_instruction_from_comment(mirac_string_view_from_cstring(_name), true)
+#define opaque(_text) x86_64_instruction_from_opaque(mirac_string_view_from_cstring(_text), (mirac_position_s) {0})
+#define symbol(_name) x86_64_operand_from_symbol(mirac_string_view_from_cstring(_name), mirac_null)
+
+#define optimizes_to(_code, _expected) \
+	optimizes_to_code((_code), sizeof(_code) / sizeof((_code)[0]), (_expected))
+
+static bool_t optimizes_to_code(
+	const x86_64_instruction_s* const code,
+	const uint64_t count,
+	const char_t* const expected);
+
+static bool_t runs_the_same(
+	const char_t* const project,
+	const char_t* const arguments,
+	const char_t* const input);
+
+utester_define_test(remove_push_pop_of_same_register)
+{
+	utester_assert_true(optimizes_to(((const x86_64_instruction_s[]) {
+		op(push, qword(rax), none),
+		op(pop, qword(rax), none),
+		op(ret, none, none) }),
+		"\tret\n"));
+}
+
+utester_define_test(rewrite_push_pop_into_mov)
+{
+	utester_assert_true(optimizes_to(((const x86_64_instruction_s[]) {
+		op(push, qword(r9), none),
+		op(pop, qword(rax), none),
+		op(test, qword(rax), qword(rax)) }),
+		"\tmov rax, r9\n"
+		"\ttest rax, rax\n"));
+}
+
+utester_define_test(rewrite_mov_push_into_push_immediate)
+{
+	utester_assert_true(optimizes_to(((const x86_64_instruction_s[]) {
+		op(mov, qword(rax), imm(42)),
+		op(push, qword(rax), none),
+		op(mov, qword(rax), qword(rsp)) }),
+		"\tpush 42\n"
+		"\tmov rax, rsp\n"));
+
+	// note: the register is read afterwards.
+	utester_assert_true(optimizes_to(((const x86_64_instruction_s[]) {
+		op(mov, qword(rax), imm(42)),
+		op(push, qword(rax), none),
+		op(add, qword(rbx), qword(rax)) }),
+		"\tmov rax, 42\n"
+		"\tpush rax\n"
+		"\tadd rbx, rax\n"));
+
+	// note: the immediate does not fit into 32 bits.
+	utester_assert_true(optimizes_to(((const x86_64_instruction_s[]) {
+		op(mov, qword(rax), imm(4294967296)),
+		op(push, qword(rax), none),
+		op(mov, qword(rax), qword(rsp)) }),
+		"\tmov rax, 4294967296\n"
+		"\tpush rax\n"
+		"\tmov rax, rsp\n"));
+}
+
+utester_define_test(rewrite_cmov_into_setcc)
+{
+	utester_assert_true(optimizes_to(((const x86_64_instruction_s[]) {
+		op(mov, qword(rcx), imm(0)),
+		op(mov, qword(rdx), imm(1)),
+		op(pop, qword(rax), none),
+		op(pop, qword(rbx), none),
+		op(cmp, qword(rax), qword(rbx)),
+		cond(cmovcc, equal, qword(rcx), qword(rdx)),
+		op(push, qword(rcx), none),
+		op(xor, dword(rdx), dword(rdx)),
+		op(ret, none, none) }),
+		"\txor ecx, ecx\n"
+		"\tpop rax\n"
+		"\tpop rbx\n"
+		"\tcmp rax, rbx\n"
+		"\tsete cl\n"
+		"\tpush rcx\n"
+		"\txor edx, edx\n"
+		"\tret\n"));
+
+	// note: the register starts at 1, so the condition is inverted.
+	utester_assert_true(optimizes_to(((const x86_64_instruction_s[]) {
+		op(mov, qword(rcx), imm(1)),
+		op(mov, qword(rdx), imm(0)),
+		op(pop, qword(rax), none),
+		op(pop, qword(rbx), none),
+		op(cmp, qword(rax), qword(rbx)),
+		cond(cmovcc, equal, qword(rcx), qword(rdx)),
+		op(push, qword(rcx), none),
+		op(xor, dword(rdx), dword(rdx)),
+		op(ret, none, none) }),
+		"\txor ecx, ecx\n"
+		"\tpop rax\n"
+		"\tpop rbx\n"
+		"\tcmp rax, rbx\n"
+		"\tsetne cl\n"
+		"\tpush rcx\n"
+		"\txor edx, edx\n"
+		"\tret\n"));
+
+	// note: the flags are set before the registers, so the register is zero
+	//       extended after the setcc, and the other register is kept as it is
+	//       not known what happens to it after the ret.
+	utester_assert_true(optimizes_to(((const x86_64_instruction_s[]) {
+		op(cmp, qword(rax), qword(rbx)),
+		op(mov, qword(rcx), imm(0)),
+		op(mov, qword(rdx), imm(1)),
+		cond(cmovcc, less, qword(rcx), qword(rdx)),
+		op(push, qword(rcx), none),
+		op(ret, none, none) }),
+		"\tcmp rax, rbx\n"
+		"\tmov rdx, 1\n"
+		"\tsetl cl\n"
+		"\tmovzx ecx, cl\n"
+		"\tpush rcx\n"
+		"\tret\n"));
+}
+
+utester_define_test(rewrite_mov_zero_into_xor)
+{
+	utester_assert_true(optimizes_to(((const x86_64_instruction_s[]) {
+		op(mov, qword(rdx), imm(0)),
+		op(div, qword(rcx), none) }),
+		"\txor edx, edx\n"
+		"\tdiv rcx\n"));
+
+	// note: the flags are read afterwards.
+	utester_assert_true(optimizes_to(((const x86_64_instruction_s[]) {
+		op(cmp, qword(rax), qword(rbx)),
+		op(mov, qword(rdx), imm(0)),
+		cond(jcc, equal, symbol("__done"), none),
+		label("__done") }),
+		"\tcmp rax, rbx\n"
+		"\tmov rdx, 0\n"
+		"\tjz __done\n"
+		"__done:\n"));
+}
+
+utester_define_test(remove_mov_of_same_register)
+{
+	utester_assert_true(optimizes_to(((const x86_64_instruction_s[]) {
+		op(mov, qword(rax), qword(rax)),
+		op(ret, none, none) }),
+		"\tret\n"));
+}
+
+utester_define_test(keep_barriers)
+{
+	// note: the label is jumped to.
+	utester_assert_true(optimizes_to(((const x86_64_instruction_s[]) {
+		op(push, qword(rax), none),
+		label("__loop"),
+		op(pop, qword(rax), none),
+		op(jmp, symbol("__loop"), none) }),
+		"\tpush rax\n"
+		"__loop:\n"
+		"\tpop rax\n"
+		"\tjmp __loop\n"));
+
+	// note: the label is not jumped to (the first label is the entry of the fun).
+	utester_assert_true(optimizes_to(((const x86_64_instruction_s[]) {
+		label("fun"),
+		op(push, qword(rax), none),
+		label("__after"),
+		op(pop, qword(rbx), none) }),
+		"fun:\n"
+		"\tmov rbx, rax\n"
+		"__after:\n"));
+
+	// note: the instruction of an asm block is not understood by the pass.
+	utester_assert_true(optimizes_to(((const x86_64_instruction_s[]) {
+		op(push, qword(rax), none),
+		opaque("lea rax, [rbx + 8]"),
+		op(pop, qword(rax), none) }),
+		"\tpush rax\n"
+		"\tlea rax, [rbx + 8]\n"
+		"\tpop rax\n"));
+
+	utester_assert_true(optimizes_to(((const x86_64_instruction_s[]) {
+		comment("drop"),
+		op(push, qword(rax), none),
+		comment("swap"),
+		op(pop, qword(rax), none) }),
+		"\t;; --- drop --- \n"
+		"\t;; --- swap --- \n"));
+}
+
+utester_define_test(follow_jumps)
+{
+	utester_assert_true(optimizes_to(((const x86_64_instruction_s[]) {
+		op(mov, qword(rax), imm(5)),
+		op(push, qword(rax), none),
+		op(jmp, symbol("__next"), none),
+		op(mov, qword(rbx), qword(rax)),
+		label("__next"),
+		op(mov, qword(rax), imm(0)),
+		op(ret, none, none) }),
+		"\tpush 5\n"
+		"\tjmp __next\n"
+		"\tmov rbx, rax\n"
+		"__next:\n"
+		"\tmov rax, 0\n"
+		"\tret\n"));
+}
+
+utester_define_test(run_hello_world)
+{
+	utester_assert_true(runs_the_same("hello_world", "", mirac_null));
+}
+
+utester_define_test(run_factorial)
+{
+	utester_assert_true(runs_the_same("factorial", "", mirac_null));
+}
+
+utester_define_test(run_cat)
+{
+	utester_assert_true(runs_the_same("cat", "main.mira", mirac_null));
+}
+
+utester_define_test(run_cli_args)
+{
+	utester_assert_true(runs_the_same("cli_args", "first second third", mirac_null));
+}
+
+utester_define_test(run_figures)
+{
+	utester_assert_true(runs_the_same("figures", "", mirac_null));
+}
+
+utester_define_test(run_tictactoe)
+{
+	utester_assert_true(runs_the_same("tictactoe", "", "1\n4\n2\n5\n3\n"));
+}
+
+utester_run_suite(x86_64_peephole_suite,
+	&remove_push_pop_of_same_register,
+	&rewrite_push_pop_into_mov,
+	&rewrite_mov_push_into_push_immediate,
+	&rewrite_cmov_into_setcc,
+	&rewrite_mov_zero_into_xor,
+	&remove_mov_of_same_register,
+	&keep_barriers,
+	&follow_jumps,
+	&run_hello_world,
+	&run_factorial,
+	&run_cat,
+	&run_cli_args,
+	&run_figures,
+	&run_tictactoe
+);
+
+static bool_t optimizes_to_code(
+	const x86_64_instruction_s* const code,
+	const uint64_t count,
+	const char_t* const expected)
+{
+	mirac_arena_s arena = mirac_arena_from_parts();
+	x86_64_instruction_list_s instructions = x86_64_instruction_list_from_parts(&arena, 0);
+	mirac_emitter_s emitter = mirac_emitter_from_parts(&arena, mirac_null);
+
+	for (uint64_t index = 0; index < count; ++index)
+	{
+		x86_64_instruction_list_push(&instructions, code[index]);
+	}
+
+	(void)x86_64_peephole_optimize(&instructions);
+	x86_64_instruction_list_print(&instructions, &emitter);
+
+	const uint64_t expected_length = (uint64_t)strlen(expected);
+	const bool_t is_equal = (emitter.length == expected_length) &&
+		(0 == mirac_c_memcmp((const uint8_t*)emitter.data, (const uint8_t*)expected, expected_length));
+
+	if (!is_equal)
+	{
+		(void)fprintf(stderr, "%.*s", (int)emitter.length, emitter.data);
+	}
+
+	mirac_arena_destroy(&arena);
+	return is_equal;
+}
+
+static bool_t read_file(
+	const char_t* const path,
+	char_t* const buffer,
+	const uint64_t capacity,
+	uint64_t* const length)
+{
+	FILE* const file = fopen(path, "rb");
+	if (mirac_null == file) { return false; }
+	*length = (uint64_t)fread(buffer, 1, (size_t)capacity, file);
+	(void)fclose(file);
+	return true;
+}
+
+static bool_t runs_the_same(
+	const char_t* const project,
+	const char_t* const arguments,
+	const char_t* const input)
+{
+	char_t directory[] = "/tmp/mirac_x86_64_peephole_suite_XXXXXX";
+	if (mirac_null == mkdtemp(directory)) { return false; }
+
+	char_t compiler[PATH_MAX] = {0};
+	char_t examples[PATH_MAX] = {0};
+	if (mirac_null == realpath("../build/mirac", compiler))
+	{
+		(void)fprintf(stderr, "the compiler is not built (run scripts/build.sh first).\n");
+		return false;
+	}
+
+	if (mirac_null == realpath("../../examples", examples)) { return false; }
+
+	char_t input_path[PATH_MAX] = {0};
+	(void)snprintf(input_path, sizeof(input_path), "%s", "/dev/null");
+
+	if (input != mirac_null)
+	{
+		(void)snprintf(input_path, sizeof(input_path), "%s/input.txt", directory);
+		FILE* const file = fopen(input_path, "wb");
+		if (mirac_null == file) { return false; }
+		(void)fputs(input, file);
+		(void)fclose(file);
+	}
+
+	static char_t outputs[2][1 << 16];
+	uint64_t lengths[2] = {0};
+	bool_t is_built = true;
+
+	for (uint8_t level = 0; level < 2; ++level)
+	{
+		char_t command[8 * PATH_MAX] = {0};
+		(void)snprintf(command, sizeof(command),
+			"mkdir '%s/%u' && cd '%s/projects/%s' && "
+			"'%s' -u -e _start -a x86_64 -f elf64-exec -O%u -I'%s' -I. main.mira '%s/main' > /dev/null && "
+			"{ '%s/main' %s < '%s' > '%s/%u/output.txt'; echo \"exit: $?\" >> '%s/%u/output.txt'; }",
+			directory, level, examples, project,
+			compiler, level, examples, directory,
+			directory, arguments, input_path, directory, level, directory, level);
+		is_built = is_built && (0 == system(command));
+
+		char_t output_path[PATH_MAX] = {0};
+		(void)snprintf(output_path, sizeof(output_path), "%s/%u/output.txt", directory, level);
+		is_built = is_built && read_file(output_path, outputs[level], sizeof(outputs[level]), &lengths[level]);
+	}
+
+	char_t command[512] = {0};
+	(void)snprintf(command, sizeof(command), "rm -rf '%s'", directory);
+	(void)system(command);
+
+	return is_built && (lengths[0] > 0) && (lengths[0] == lengths[1]) &&
+		(0 == mirac_c_memcmp((const uint8_t*)outputs[0], (const uint8_t*)outputs[1], lengths[0]));
+}